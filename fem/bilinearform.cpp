@@ -18,17 +18,49 @@
 namespace mfem
 {
 
+// Build the element-to-DOF (or element-to-VDOF, if @a vdofs is true) table of
+// @a fes with the signs of the DOFs removed.
+static void MakeUnsignedElementToDofTable(const FiniteElementSpace &fes,
+                                          bool vdofs, Table &el_dof)
+{
+   const int ne = fes.GetNE();
+   Array<int> dofs;
+   el_dof.MakeI(ne);
+   for (int i = 0; i < ne; i++)
+   {
+      if (vdofs) { fes.GetElementVDofs(i, dofs); }
+      else { fes.GetElementDofs(i, dofs); }
+      el_dof.AddColumnsInRow(i, dofs.Size());
+   }
+   el_dof.MakeJ();
+   for (int i = 0; i < ne; i++)
+   {
+      if (vdofs) { fes.GetElementVDofs(i, dofs); }
+      else { fes.GetElementDofs(i, dofs); }
+      for (int j = 0; j < dofs.Size(); j++)
+      {
+         el_dof.AddConnection(i, (dofs[j] >= 0) ? dofs[j] : -1-dofs[j]);
+      }
+   }
+   el_dof.ShiftUpI();
+}
+
 void BilinearForm::AllocMat()
 {
    if (static_cond) { return; }
 
-   if (precompute_sparsity == 0 || fes->GetVDim() > 1)
+   // The threaded assembly and the sparsity reuse build the pattern also for
+   // vector and signed (e.g. ND) spaces.
+   const bool symbolic = threaded_assembly || reuse_sparsity;
+   if (!symbolic && (precompute_sparsity == 0 || fes->GetVDim() > 1))
    {
       mat = new SparseMatrix(height);
       return;
    }
 
-   const Table &elem_dof = fes->GetElementToDofTable();
+   Table el_vdof;
+   if (symbolic) { MakeUnsignedElementToDofTable(*fes, true, el_vdof); }
+   const Table &elem_dof = symbolic ? el_vdof : fes->GetElementToDofTable();
    Table dof_dof;
 
    if (fbfi.Size() > 0)
@@ -63,6 +95,93 @@ void BilinearForm::AllocMat()
    dof_dof.LoseData();
 }
 
+const Table &BilinearForm::GetElementColoring()
+{
+   if (element_coloring) { return *element_coloring; }
+
+   // Greedy coloring: each element gets the smallest color that is not used
+   // by the previous elements with a common DOF.
+   Table el_dof, dof_el;
+   MakeUnsignedElementToDofTable(*fes, false, el_dof);
+   Transpose(el_dof, dof_el, fes->GetNDofs());
+
+   const int ne = fes->GetNE();
+   Array<int> color(ne), marker;
+   for (int i = 0; i < ne; i++)
+   {
+      const int *dofs = el_dof.GetRow(i);
+      for (int j = 0; j < el_dof.RowSize(i); j++)
+      {
+         const int *elems = dof_el.GetRow(dofs[j]);
+         for (int k = 0; k < dof_el.RowSize(dofs[j]); k++)
+         {
+            if (elems[k] < i) { marker[color[elems[k]]] = i; }
+         }
+      }
+      int c = 0;
+      while (c < marker.Size() && marker[c] == i) { c++; }
+      if (c == marker.Size()) { marker.Append(-1); }
+      color[i] = c;
+   }
+
+   element_coloring = new Table;
+   Transpose(color, *element_coloring, marker.Size());
+   return *element_coloring;
+}
+
+void BilinearForm::AssembleElementsThreaded()
+{
+   const Table &coloring = GetElementColoring();
+   const int num_colors = coloring.Size();
+   if (!mat->ColumnsAreSorted()) { mat->SortColumnIndices(); }
+   // Make the CSR arrays valid on the host before the parallel region.
+   mat->HostReadI();
+   mat->HostReadJ();
+   mat->HostReadWriteData();
+
+#if defined(MFEM_THREAD_SAFE) && \
+    (defined(MFEM_USE_OPENMP) || defined(MFEM_USE_LEGACY_OPENMP))
+   #pragma omp parallel
+#endif
+   {
+      DenseMatrix elmat, tmp;
+      IsoparametricTransformation eltrans;
+      Array<int> el_vdofs;
+
+      for (int c = 0; c < num_colors; c++)
+      {
+         const int *elems = coloring.GetRow(c);
+         const int num_elems = coloring.RowSize(c);
+#if defined(MFEM_THREAD_SAFE) && \
+    (defined(MFEM_USE_OPENMP) || defined(MFEM_USE_LEGACY_OPENMP))
+         #pragma omp for
+#endif
+         for (int k = 0; k < num_elems; k++)
+         {
+            const int i = elems[k];
+            fes->GetElementVDofs(i, el_vdofs);
+            if (element_matrices)
+            {
+               const int n = el_vdofs.Size();
+               DenseMatrix elmat_i(element_matrices->GetData(i), n, n);
+               mat->AddSubMatrixSorted(el_vdofs, el_vdofs, elmat_i);
+               elmat_i.ClearExternalData();
+               continue;
+            }
+            const FiniteElement &fe = *fes->GetFE(i);
+            fes->GetElementTransformation(i, &eltrans);
+            dbfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
+            for (int j = 1; j < dbfi.Size(); j++)
+            {
+               dbfi[j]->AssembleElementMatrix(fe, eltrans, tmp);
+               elmat += tmp;
+            }
+            mat->AddSubMatrixSorted(el_vdofs, el_vdofs, elmat);
+         }
+      }
+   }
+}
+
 BilinearForm::BilinearForm(FiniteElementSpace * f)
    : Matrix (f->GetVSize())
 {
@@ -74,10 +193,15 @@ BilinearForm::BilinearForm(FiniteElementSpace * f)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = 0;
+   threaded_assembly = false;
+   element_coloring = NULL;
+   reuse_sparsity = false;
+   mat_e_reuse = NULL;
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::LEGACYFULL;
    batch = 1;
+   pa_mixed_precision = false;
    ext = NULL;
 }
 
@@ -92,10 +216,15 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = ps;
+   threaded_assembly = false;
+   element_coloring = NULL;
+   reuse_sparsity = false;
+   mat_e_reuse = NULL;
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::LEGACYFULL;
    batch = 1;
+   pa_mixed_precision = false;
    ext = NULL;
 
    // Copy the pointers to the integrators
@@ -385,21 +514,58 @@ void BilinearForm::Assemble(int skip_zeros)
    Mesh *mesh = fes -> GetMesh();
    DenseMatrix elmat, *elmat_p;
 
+   // Re-assembly with a reused sparsity pattern, see EnableSparsityReuse().
+   const bool reuse = reuse_sparsity && !static_cond && !hybridization;
+   if (reuse)
+   {
+      skip_zeros = 0;
+      if (mat && mat->Height() != fes->GetVSize())
+      {
+         // The matrix was replaced by its conforming version, see
+         // ConformingAssemble(), so the pattern is rebuilt.
+         delete mat;
+         mat = NULL;
+         delete mat_e;
+         mat_e = NULL;
+         height = width = fes->GetVSize();
+      }
+      else if (mat)
+      {
+         *mat = 0.0;
+         if (mat_e)
+         {
+            delete mat_e_reuse;
+            mat_e_reuse = mat_e;
+            mat_e = NULL;
+            *mat_e_reuse = 0.0;
+         }
+      }
+   }
+
    if (mat == NULL)
    {
       AllocMat();
    }
 
+   // The threaded assembly needs a finalized matrix, e.g. the one allocated by
+   // AllocMat(), and does not support hybridization.
+   const bool threaded = threaded_assembly && mat && mat->Finalized() &&
+                         !hybridization;
+
 #ifdef MFEM_USE_LEGACY_OPENMP
    int free_element_matrices = 0;
-   if (!element_matrices)
+   if (!element_matrices && !threaded)
    {
       ComputeElementMatrices();
       free_element_matrices = 1;
    }
 #endif
 
-   if (dbfi.Size())
+   if (dbfi.Size() && threaded)
+   {
+      AssembleElementsThreaded();
+   }
+   else if (dbfi.Size())
    {
       for (int i = 0; i < fes -> GetNE(); i++)
       {
@@ -628,8 +794,9 @@ void BilinearForm::AssembleDiagonal(Vector &diag) const
       const Operator *P = fes->GetProlongationMatrix();
       // For an AMR mesh, a convergent diagonal is assembled with |P^T| d_e,
       // where |P^T| has the entry-wise absolute values of the conforming
-      // prolongation transpose operator.
-      if (P && !fes->Conforming())
+      // prolongation transpose operator. The same holds for the signed
+      // permutations of CopyProlongationAndRestriction().
+      if (P && (!fes->Conforming() || fes->HasCopiedProlongation()))
       {
          Vector local_diag(P->Height());
          ext->AssembleDiagonal(local_diag);
@@ -957,8 +1124,18 @@ void BilinearForm::EliminateVDofs(const Array<int> &vdofs,
 {
    if (mat_e == NULL)
    {
-      mat_e = new SparseMatrix(height);
+      if (mat_e_reuse && mat_e_reuse->Height() == height &&
+          mat_e_reuse_vdofs == vdofs)
+      {
+         mat_e = mat_e_reuse;
+         mat_e_reuse = NULL;
+      }
+      else
+      {
+         mat_e = new SparseMatrix(height);
+      }
    }
+   if (reuse_sparsity) { vdofs.Copy(mat_e_reuse_vdofs); }
 
    for (int i = 0; i < vdofs.Size(); i++)
    {
@@ -1051,6 +1228,8 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
 
    delete mat_e;
    mat_e = NULL;
+   delete mat_e_reuse;
+   mat_e_reuse = NULL;
    FreeElementMatrices();
    delete static_cond;
    static_cond = NULL;
@@ -1059,6 +1238,8 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
    {
       delete mat;
       mat = NULL;
+      delete element_coloring;
+      element_coloring = NULL;
       delete hybridization;
       hybridization = NULL;
       sequence = fes->GetSequence();
@@ -1083,7 +1264,9 @@ BilinearForm::~BilinearForm()
 {
    delete mat_e;
    delete mat;
+   delete mat_e_reuse;
    delete element_matrices;
+   delete element_coloring;
    delete static_cond;
    delete hybridization;
 
@@ -69,6 +69,9 @@ protected:
    AssemblyLevel assembly;
    /// Element batch size used in the form action (1, 8, num_elems, etc.)
    int batch;
+   /** Store the partial assembly data in single precision, see
+       EnablePAMixedPrecision(). */
+   bool pa_mixed_precision;
    /** @brief Extension for supporting Full Assembly (FA), Element Assembly (EA),
        Partial Assembly (PA), or Matrix Free assembly (MF). */
    BilinearFormExtension *ext;
@@ -112,6 +115,31 @@ protected:
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
+   /// Use the two-pass, thread-parallel assembly, see EnableThreadedAssembly().
+   bool threaded_assembly;
+
+   /** Coloring of the elements used by the threaded assembly: row c lists the
+       elements of color c, and elements of the same color have no common
+       DOF. Owned. */
+   Table *element_coloring;
+
+   /// Return the coloring #element_coloring, computing it if necessary.
+   const Table &GetElementColoring();
+
+   /// Keep the sparsity patterns for re-assembly, see EnableSparsityReuse().
+   bool reuse_sparsity;
+
+   /** The eliminated part #mat_e of the previous assembly, with its values
+       set to zero, and the VDOFs that were eliminated last. It replaces a new
+       #mat_e when the same VDOFs are eliminated again. Owned. */
+   SparseMatrix *mat_e_reuse;
+   Array<int> mat_e_reuse_vdofs;
+
+   /** @brief Add the element matrices of the domain integrators to the
+       finalized matrix #mat, processing the elements of each color of
+       GetElementColoring() concurrently. */
+   void AssembleElementsThreaded();
+
    void ConformingAssemble();
 
    // may be used in the construction of derived classes
@@ -121,9 +149,14 @@ protected:
       mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
       static_cond = NULL; hybridization = NULL;
       precompute_sparsity = 0;
+      threaded_assembly = false;
+      element_coloring = NULL;
+      reuse_sparsity = false;
+      mat_e_reuse = NULL;
       diag_policy = DIAG_KEEP;
       assembly = AssemblyLevel::LEGACYFULL;
       batch = 1;
+      pa_mixed_precision = false;
       ext = NULL;
    }
 
@@ -169,6 +202,73 @@ public:
    /// Returns the assembly level
    AssemblyLevel GetAssemblyLevel() const { return assembly; }
 
+   /** @brief Store the quadrature data of the partially assembled domain
+       integrators in single precision, while the action is still computed and
+       accumulated in double precision.
+
+       This halves the memory traffic of the quadrature data in the action, at
+       the cost of a relative accuracy of about 1e-7. It is intended for
+       operators that are only used in preconditioners, e.g. in smoothers or on
+       coarse multigrid levels. Only used with AssemblyLevel::PARTIAL and by
+       the integrators that implement
+       BilinearFormIntegrator::AssemblePAMixedPrecision(); the other
+       integrators keep double precision data. This method should be called
+       before assembly. */
+   void EnablePAMixedPrecision(bool enable = true)
+   { pa_mixed_precision = enable; }
+
+   /// Returns true if EnablePAMixedPrecision() was called with @a enable true.
+   bool PAMixedPrecisionIsEnabled() const { return pa_mixed_precision; }
+
+   /** @brief Assemble the matrix in two passes: a symbolic pass that builds
+       the CSR sparsity pattern from the element-to-DOF table of the space, and
+       a numeric pass that adds the element matrices of the domain integrators
+       directly to the CSR arrays. */
+   /** This avoids the row-linked list stage of SparseMatrix and the call to
+       SparseMatrix::Finalize(). In the numeric pass the elements are colored,
+       such that elements of the same color have no common DOF, and the
+       elements of each color are assembled concurrently when MFEM is built
+       with MFEM_THREAD_SAFE and with MFEM_USE_OPENMP or
+       MFEM_USE_LEGACY_OPENMP. In that case, the integrators and their
+       coefficients must be thread-safe. In other builds, the same colored
+       numeric pass runs serially.
+
+       The sparsity pattern assumes dense element matrices, so the parameter
+       @a skip_zeros of Assemble() has no effect. The boundary and face
+       integrators are assembled serially into the same pattern. The threaded
+       assembly is not used with static condensation or hybridization. This
+       method should be called before assembly. */
+   void EnableThreadedAssembly(bool enable = true)
+   { threaded_assembly = enable; }
+
+   /// Returns true if EnableThreadedAssembly() was called with @a enable true.
+   bool ThreadedAssemblyIsEnabled() const { return threaded_assembly; }
+
+   /** @brief Keep the sparsity pattern of the assembled matrix, so that the
+       following calls to Assemble() only recompute its values in place. */
+   /** The first call to Assemble() builds the CSR pattern of the matrix as in
+       EnableThreadedAssembly(), assuming dense element matrices. Every
+       following call to Assemble() sets the values of the matrix to zero and
+       adds the new element matrices, i.e. it overwrites the matrix instead of
+       adding to it, without rebuilding the pattern. Zero entries are never
+       skipped, so the pattern does not depend on the coefficients.
+
+       The elimination of the essential DOFs in FormSystemMatrix() and
+       FormLinearSystem() is repeated in place, and the pattern of the
+       eliminated part of the matrix is reused when the same DOFs are
+       eliminated. On non-conforming meshes, the matrix is replaced by its
+       conforming version in FormSystemMatrix(), so its pattern is rebuilt in
+       the next call to Assemble(). ParBilinearForm keeps the local matrix
+       after the parallel assembly and re-forms the parallel matrix from it
+       only when the form was re-assembled, so the operators returned by
+       earlier calls to FormSystemMatrix() stay valid until the next call to
+       Assemble(). The pattern reuse is not used with static condensation or
+       hybridization. This method should be called before assembly. */
+   void EnableSparsityReuse(bool enable = true) { reuse_sparsity = enable; }
+
+   /// Returns true if EnableSparsityReuse() was called with @a enable true.
+   bool SparsityReuseIsEnabled() const { return reuse_sparsity; }
+
    /** @brief Enable the use of static condensation. For details see the
        description for class StaticCondensation in fem/staticcond.hpp This method
        should be called before assembly. If the number of unknowns after static
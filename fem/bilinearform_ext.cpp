@@ -36,6 +36,95 @@ const Operator *BilinearFormExtension::GetRestriction() const
    return a->GetRestriction();
 }
 
+// Return true if some of the face integrators act on the face dofs given by a
+// face restriction, see BilinearFormIntegrator::FaceActionUsesElementDofs().
+static bool UsesFaceRestriction(const Array<BilinearFormIntegrator*> &integs)
+{
+   for (int i = 0; i < integs.Size(); ++i)
+   {
+      if (!integs[i]->FaceActionUsesElementDofs()) { return true; }
+   }
+   return false;
+}
+
+// Return true if some of the face integrators act on the element dofs.
+static bool UsesElementFaceDofs(const Array<BilinearFormIntegrator*> &integs)
+{
+   for (int i = 0; i < integs.Size(); ++i)
+   {
+      if (integs[i]->FaceActionUsesElementDofs()) { return true; }
+   }
+   return false;
+}
+
+// Add the PA (or MF) action, or its transpose, of the face integrators acting
+// on the element dofs on the E-vector x to the E-vector y.
+static void AddMultElementFaces(BilinearForm *a, const bool mf,
+                                const bool transpose, const Vector &x,
+                                Vector &y)
+{
+   Array<BilinearFormIntegrator*> *integs[2] = { a->GetFBFI(), a->GetBFBFI() };
+   for (int k = 0; k < 2; ++k)
+   {
+      for (int i = 0; i < integs[k]->Size(); ++i)
+      {
+         BilinearFormIntegrator *integ = (*integs[k])[i];
+         if (!integ->FaceActionUsesElementDofs()) { continue; }
+         if (mf)
+         {
+            if (transpose) { integ->AddMultTransposeMF(x, y); }
+            else { integ->AddMultMF(x, y); }
+         }
+         else
+         {
+            if (transpose) { integ->AddMultTransposePA(x, y); }
+            else { integ->AddMultPA(x, y); }
+         }
+      }
+   }
+}
+
+// Add the PA (or MF) diagonal of the face integrators acting on the element
+// dofs to the E-vector diag.
+static void AddDiagonalElementFaces(BilinearForm *a, const bool mf,
+                                    Vector &diag)
+{
+   Array<BilinearFormIntegrator*> *integs[2] = { a->GetFBFI(), a->GetBFBFI() };
+   for (int k = 0; k < 2; ++k)
+   {
+      for (int i = 0; i < integs[k]->Size(); ++i)
+      {
+         BilinearFormIntegrator *integ = (*integs[k])[i];
+         if (!integ->FaceActionUsesElementDofs()) { continue; }
+         if (mf) { integ->AssembleDiagonalMF(diag); }
+         else { integ->AssembleDiagonalPA(diag); }
+      }
+   }
+}
+
+// Return true if some of the face integrators of the form act on the element
+// dofs.
+static bool UsesElementFaceDofs(BilinearForm *a)
+{
+   return UsesElementFaceDofs(*a->GetFBFI()) ||
+          UsesElementFaceDofs(*a->GetBFBFI());
+}
+
+// Abort if the mesh of @a fes has mixed elements and one of the @a integrators
+// does not support them in partial assembly.
+static void VerifyMixedMeshesPA(const FiniteElementSpace &fes,
+                                const Array<BilinearFormIntegrator*> &integs)
+{
+   const Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNumGeometries(mesh->Dimension()) <= 1) { return; }
+   for (int i = 0; i < integs.Size(); ++i)
+   {
+      MFEM_VERIFY(integs[i]->SupportsMixedMeshesPA(), "Partial assembly on "
+                  "meshes with mixed element types is supported only by "
+                  "MassIntegrator and DiffusionIntegrator.");
+   }
+}
+
 // Data and methods for partially-assembled bilinear forms
 MFBilinearFormExtension::MFBilinearFormExtension(BilinearForm *form)
    : BilinearFormExtension(form),
@@ -55,6 +144,62 @@ void MFBilinearFormExtension::Assemble()
    {
       integrators[i]->AssembleMF(*a->FESpace());
    }
+
+   Array<BilinearFormIntegrator*> &intFaceIntegrators = *a->GetFBFI();
+   Array<BilinearFormIntegrator*> &bdrFaceIntegrators = *a->GetBFBFI();
+   if (intFaceIntegrators.Size() == 0 && bdrFaceIntegrators.Size() == 0)
+   {
+      return;
+   }
+   // With libCEED, the domain integrators act on the L-vectors and the face
+   // integrators use the element and face restrictions below
+   SetupRestrictionOperators();
+   for (int i = 0; i < intFaceIntegrators.Size(); ++i)
+   {
+      intFaceIntegrators[i]->AssembleMFInteriorFaces(*a->FESpace());
+   }
+   for (int i = 0; i < bdrFaceIntegrators.Size(); ++i)
+   {
+      bdrFaceIntegrators[i]->AssembleMFBoundaryFaces(*a->FESpace());
+   }
+}
+
+void MFBilinearFormExtension::SetupRestrictionOperators()
+{
+   const Mesh *mesh = a->FESpace()->GetMesh();
+   const bool mixed = mesh->GetNumGeometries(mesh->Dimension()) > 1;
+   ElementDofOrdering ordering = (UsesTensorBasis(*a->FESpace()) || mixed) ?
+                                 ElementDofOrdering::LEXICOGRAPHIC:
+                                 ElementDofOrdering::NATIVE;
+   elem_restrict = trialFes->GetElementRestriction(ordering);
+   MFEM_VERIFY(elem_restrict, "MF face integrators require an element "
+               "restriction.");
+   localX.SetSize(elem_restrict->Height(), Device::GetDeviceMemoryType());
+   localY.SetSize(elem_restrict->Height(), Device::GetDeviceMemoryType());
+   localY.UseDevice(true); // ensure 'localY = 0.0' is done on device
+
+   if (int_face_restrict_lex == NULL && UsesFaceRestriction(*a->GetFBFI()))
+   {
+      int_face_restrict_lex = trialFes->GetFaceRestriction(
+                                 ElementDofOrdering::LEXICOGRAPHIC,
+                                 FaceType::Interior);
+      const int height = int_face_restrict_lex->Height();
+      faceIntX.SetSize(height, Device::GetMemoryType());
+      faceIntY.SetSize(height, Device::GetMemoryType());
+      faceIntY.UseDevice(true); // ensure 'faceIntY = 0.0' is done on device
+   }
+
+   if (bdr_face_restrict_lex == NULL && UsesFaceRestriction(*a->GetBFBFI()))
+   {
+      bdr_face_restrict_lex = trialFes->GetFaceRestriction(
+                                 ElementDofOrdering::LEXICOGRAPHIC,
+                                 FaceType::Boundary,
+                                 L2FaceValues::DoubleValued);
+      const int height = bdr_face_restrict_lex->Height();
+      faceBdrX.SetSize(height, Device::GetMemoryType());
+      faceBdrY.SetSize(height, Device::GetMemoryType());
+      faceBdrY.UseDevice(true); // ensure 'faceBoundY = 0.0' is done on device
+   }
 }
 
 void MFBilinearFormExtension::AssembleDiagonal(Vector &y) const
@@ -69,6 +214,7 @@ void MFBilinearFormExtension::AssembleDiagonal(Vector &y) const
       {
          integrators[i]->AssembleDiagonalMF(localY);
       }
+      AddDiagonalElementFaces(a, true, localY);
       const ElementRestriction* H1elem_restrict =
          dynamic_cast<const ElementRestriction*>(elem_restrict);
       if (H1elem_restrict)
@@ -83,7 +229,18 @@ void MFBilinearFormExtension::AssembleDiagonal(Vector &y) const
    else
    {
       y.UseDevice(true); // typically this is a large vector, so store on device
-      y = 0.0;
+      if (elem_restrict && UsesElementFaceDofs(a))
+      {
+         // The face integrators are used with the element restriction, which
+         // is not an H1 restriction since they require a DG space
+         localY = 0.0;
+         AddDiagonalElementFaces(a, true, localY);
+         elem_restrict->MultTranspose(localY, y);
+      }
+      else
+      {
+         y = 0.0;
+      }
       for (int i = 0; i < iSz; ++i)
       {
          integrators[i]->AssembleDiagonalMF(y);
@@ -130,7 +287,17 @@ void MFBilinearFormExtension::Mult(const Vector &x, Vector &y) const
    if (DeviceCanUseCeed() || !elem_restrict)
    {
       y.UseDevice(true); // typically this is a large vector, so store on device
-      y = 0.0;
+      if (elem_restrict && UsesElementFaceDofs(a))
+      {
+         elem_restrict->Mult(x, localX);
+         localY = 0.0;
+         AddMultElementFaces(a, true, false, localX, localY);
+         elem_restrict->MultTranspose(localY, y);
+      }
+      else
+      {
+         y = 0.0;
+      }
       for (int i = 0; i < iSz; ++i)
       {
          integrators[i]->AddMultMF(x, y);
@@ -144,6 +311,7 @@ void MFBilinearFormExtension::Mult(const Vector &x, Vector &y) const
       {
          integrators[i]->AddMultMF(localX, localY);
       }
+      AddMultElementFaces(a, true, false, localX, localY);
       elem_restrict->MultTranspose(localY, y);
    }
 
@@ -157,7 +325,10 @@ void MFBilinearFormExtension::Mult(const Vector &x, Vector &y) const
          faceIntY = 0.0;
          for (int i = 0; i < iFISz; ++i)
          {
-            intFaceIntegrators[i]->AddMultMF(faceIntX, faceIntY);
+            if (!intFaceIntegrators[i]->FaceActionUsesElementDofs())
+            {
+               intFaceIntegrators[i]->AddMultMF(faceIntX, faceIntY);
+            }
          }
          int_face_restrict_lex->MultTranspose(faceIntY, y);
       }
@@ -173,7 +344,10 @@ void MFBilinearFormExtension::Mult(const Vector &x, Vector &y) const
          faceBdrY = 0.0;
          for (int i = 0; i < bFISz; ++i)
          {
-            bdrFaceIntegrators[i]->AddMultMF(faceBdrX, faceBdrY);
+            if (!bdrFaceIntegrators[i]->FaceActionUsesElementDofs())
+            {
+               bdrFaceIntegrators[i]->AddMultMF(faceBdrX, faceBdrY);
+            }
          }
          bdr_face_restrict_lex->MultTranspose(faceBdrY, y);
       }
@@ -184,7 +358,7 @@ void MFBilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
    const int iSz = integrators.Size();
-   if (elem_restrict)
+   if (elem_restrict && !DeviceCanUseCeed())
    {
       elem_restrict->Mult(x, localX);
       localY = 0.0;
@@ -192,12 +366,23 @@ void MFBilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
       {
          integrators[i]->AddMultTransposeMF(localX, localY);
       }
+      AddMultElementFaces(a, true, true, localX, localY);
       elem_restrict->MultTranspose(localY, y);
    }
    else
    {
       y.UseDevice(true);
-      y = 0.0;
+      if (elem_restrict && UsesElementFaceDofs(a))
+      {
+         elem_restrict->Mult(x, localX);
+         localY = 0.0;
+         AddMultElementFaces(a, true, true, localX, localY);
+         elem_restrict->MultTranspose(localY, y);
+      }
+      else
+      {
+         y = 0.0;
+      }
       for (int i = 0; i < iSz; ++i)
       {
          integrators[i]->AddMultTransposeMF(x, y);
@@ -214,7 +399,10 @@ void MFBilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
          faceIntY = 0.0;
          for (int i = 0; i < iFISz; ++i)
          {
-            intFaceIntegrators[i]->AddMultTransposeMF(faceIntX, faceIntY);
+            if (!intFaceIntegrators[i]->FaceActionUsesElementDofs())
+            {
+               intFaceIntegrators[i]->AddMultTransposeMF(faceIntX, faceIntY);
+            }
          }
          int_face_restrict_lex->MultTranspose(faceIntY, y);
       }
@@ -230,7 +418,10 @@ void MFBilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
          faceBdrY = 0.0;
          for (int i = 0; i < bFISz; ++i)
          {
-            bdrFaceIntegrators[i]->AddMultTransposeMF(faceBdrX, faceBdrY);
+            if (!bdrFaceIntegrators[i]->FaceActionUsesElementDofs())
+            {
+               bdrFaceIntegrators[i]->AddMultTransposeMF(faceBdrX, faceBdrY);
+            }
          }
          bdr_face_restrict_lex->MultTranspose(faceBdrY, y);
       }
@@ -250,7 +441,11 @@ PABilinearFormExtension::PABilinearFormExtension(BilinearForm *form)
 
 void PABilinearFormExtension::SetupRestrictionOperators(const L2FaceValues m)
 {
-   ElementDofOrdering ordering = UsesTensorBasis(*a->FESpace())?
+   // On meshes with mixed elements, only the tensor element blocks of the
+   // E-vector are reordered lexicographically.
+   const Mesh *mesh = a->FESpace()->GetMesh();
+   const bool mixed = mesh->GetNumGeometries(mesh->Dimension()) > 1;
+   ElementDofOrdering ordering = (UsesTensorBasis(*a->FESpace()) || mixed) ?
                                  ElementDofOrdering::LEXICOGRAPHIC:
                                  ElementDofOrdering::NATIVE;
    elem_restrict = trialFes->GetElementRestriction(ordering);
@@ -263,7 +458,7 @@ void PABilinearFormExtension::SetupRestrictionOperators(const L2FaceValues m)
 
    // Construct face restriction operators only if the bilinear form has
    // interior or boundary face integrators
-   if (int_face_restrict_lex == NULL && a->GetFBFI()->Size() > 0)
+   if (int_face_restrict_lex == NULL && UsesFaceRestriction(*a->GetFBFI()))
    {
       int_face_restrict_lex = trialFes->GetFaceRestriction(
                                  ElementDofOrdering::LEXICOGRAPHIC,
@@ -273,7 +468,7 @@ void PABilinearFormExtension::SetupRestrictionOperators(const L2FaceValues m)
       faceIntY.UseDevice(true); // ensure 'faceIntY = 0.0' is done on device
    }
 
-   if (bdr_face_restrict_lex == NULL && a->GetBFBFI()->Size() > 0)
+   if (bdr_face_restrict_lex == NULL && UsesFaceRestriction(*a->GetBFBFI()))
    {
       bdr_face_restrict_lex = trialFes->GetFaceRestriction(
                                  ElementDofOrdering::LEXICOGRAPHIC,
@@ -287,13 +482,40 @@ void PABilinearFormExtension::SetupRestrictionOperators(const L2FaceValues m)
 
 void PABilinearFormExtension::Assemble()
 {
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   VerifyMixedMeshesPA(*a->FESpace(), integrators);
+   VerifyMixedMeshesPA(*a->FESpace(), *a->GetFBFI());
+   VerifyMixedMeshesPA(*a->FESpace(), *a->GetBFBFI());
+
    SetupRestrictionOperators(L2FaceValues::DoubleValued);
 
-   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
    const int integratorCount = integrators.Size();
    for (int i = 0; i < integratorCount; ++i)
    {
-      integrators[i]->AssemblePA(*a->FESpace());
+      if (a->PAMixedPrecisionIsEnabled())
+      {
+         integrators[i]->AssemblePAMixedPrecision(*a->FESpace());
+      }
+      else
+      {
+         integrators[i]->AssemblePA(*a->FESpace());
+      }
+   }
+
+   // Pair the domain integrators whose actions can be computed together
+   dbfi_fused.SetSize(integratorCount);
+   dbfi_fused = -1;
+   for (int i = 0; i < integratorCount; ++i)
+   {
+      for (int j = 0; j < integratorCount && dbfi_fused[i] == -1; ++j)
+      {
+         if (j != i && dbfi_fused[j] == -1 &&
+             integrators[i]->CanFusePA(*integrators[j]))
+         {
+            dbfi_fused[i] = j;
+            dbfi_fused[j] = -2;
+         }
+      }
    }
 
    MFEM_VERIFY(a->GetBBFI()->Size() == 0,
@@ -312,6 +534,12 @@ void PABilinearFormExtension::Assemble()
    {
       bdrFaceIntegrators[i]->AssemblePABoundaryFaces(*a->FESpace());
    }
+
+   MFEM_VERIFY((!UsesElementFaceDofs(intFaceIntegrators) &&
+                !UsesElementFaceDofs(bdrFaceIntegrators)) ||
+               (elem_restrict && !DeviceCanUseCeed()),
+               "The face integrators acting on the element dofs require an "
+               "element restriction and are not supported with libCEED.");
 }
 
 void PABilinearFormExtension::AssembleDiagonal(Vector &y) const
@@ -326,6 +554,7 @@ void PABilinearFormExtension::AssembleDiagonal(Vector &y) const
       {
          integrators[i]->AssembleDiagonalPA(localY);
       }
+      AddDiagonalElementFaces(a, false, localY);
       const ElementRestriction* H1elem_restrict =
          dynamic_cast<const ElementRestriction*>(elem_restrict);
       if (H1elem_restrict)
@@ -358,6 +587,7 @@ void PABilinearFormExtension::Update()
    elem_restrict = nullptr;
    int_face_restrict_lex = nullptr;
    bdr_face_restrict_lex = nullptr;
+   dbfi_fused.SetSize(0);
 }
 
 void PABilinearFormExtension::FormSystemMatrix(const Array<int> &ess_tdof_list,
@@ -379,28 +609,39 @@ void PABilinearFormExtension::FormLinearSystem(const Array<int> &ess_tdof_list,
    A.Reset(oper); // A will own oper
 }
 
-void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
+void PABilinearFormExtension::AddMultDomainPA(const Vector &x, Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
 
    const int iSz = integrators.Size();
-   if (DeviceCanUseCeed() || !elem_restrict)
+   for (int i = 0; i < iSz; ++i)
    {
-      y.UseDevice(true); // typically this is a large vector, so store on device
-      y = 0.0;
-      for (int i = 0; i < iSz; ++i)
+      const int j = (i < dbfi_fused.Size()) ? dbfi_fused[i] : -1;
+      if (j >= 0)
+      {
+         integrators[i]->AddMultPAFused(*integrators[j], x, y);
+      }
+      else if (j == -1)
       {
          integrators[i]->AddMultPA(x, y);
       }
    }
+}
+
+void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   if (DeviceCanUseCeed() || !elem_restrict)
+   {
+      y.UseDevice(true); // typically this is a large vector, so store on device
+      y = 0.0;
+      AddMultDomainPA(x, y);
+   }
    else
    {
       elem_restrict->Mult(x, localX);
       localY = 0.0;
-      for (int i = 0; i < iSz; ++i)
-      {
-         integrators[i]->AddMultPA(localX, localY);
-      }
+      AddMultDomainPA(localX, localY);
+      AddMultElementFaces(a, false, false, localX, localY);
       elem_restrict->MultTranspose(localY, y);
    }
 
@@ -414,7 +655,10 @@ void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
          faceIntY = 0.0;
          for (int i = 0; i < iFISz; ++i)
          {
-            intFaceIntegrators[i]->AddMultPA(faceIntX, faceIntY);
+            if (!intFaceIntegrators[i]->FaceActionUsesElementDofs())
+            {
+               intFaceIntegrators[i]->AddMultPA(faceIntX, faceIntY);
+            }
          }
          int_face_restrict_lex->MultTranspose(faceIntY, y);
       }
@@ -430,7 +674,10 @@ void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
          faceBdrY = 0.0;
          for (int i = 0; i < bFISz; ++i)
          {
-            bdrFaceIntegrators[i]->AddMultPA(faceBdrX, faceBdrY);
+            if (!bdrFaceIntegrators[i]->FaceActionUsesElementDofs())
+            {
+               bdrFaceIntegrators[i]->AddMultPA(faceBdrX, faceBdrY);
+            }
          }
          bdr_face_restrict_lex->MultTranspose(faceBdrY, y);
       }
@@ -449,6 +696,7 @@ void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
       {
          integrators[i]->AddMultTransposePA(localX, localY);
       }
+      AddMultElementFaces(a, false, true, localX, localY);
       elem_restrict->MultTranspose(localY, y);
    }
    else
@@ -471,7 +719,10 @@ void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
          faceIntY = 0.0;
          for (int i = 0; i < iFISz; ++i)
          {
-            intFaceIntegrators[i]->AddMultTransposePA(faceIntX, faceIntY);
+            if (!intFaceIntegrators[i]->FaceActionUsesElementDofs())
+            {
+               intFaceIntegrators[i]->AddMultTransposePA(faceIntX, faceIntY);
+            }
          }
          int_face_restrict_lex->MultTranspose(faceIntY, y);
       }
@@ -487,7 +738,10 @@ void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
          faceBdrY = 0.0;
          for (int i = 0; i < bFISz; ++i)
          {
-            bdrFaceIntegrators[i]->AddMultTransposePA(faceBdrX, faceBdrY);
+            if (!bdrFaceIntegrators[i]->FaceActionUsesElementDofs())
+            {
+               bdrFaceIntegrators[i]->AddMultTransposePA(faceBdrX, faceBdrY);
+            }
          }
          bdr_face_restrict_lex->MultTranspose(faceBdrY, y);
       }
@@ -992,6 +1246,10 @@ PAMixedBilinearFormExtension::PAMixedBilinearFormExtension(
 
 void PAMixedBilinearFormExtension::Assemble()
 {
+   const Mesh *mesh = trialFes->GetMesh();
+   MFEM_VERIFY(mesh->GetNumGeometries(mesh->Dimension()) <= 1,
+               "Partial assembly of mixed forms does not support meshes with "
+               "mixed element types.");
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
    const int integratorCount = integrators.Size();
    for (int i = 0; i < integratorCount; ++i)
@@ -73,6 +73,11 @@ protected:
    const Operator *elem_restrict; // Not owned
    const Operator *int_face_restrict_lex; // Not owned
    const Operator *bdr_face_restrict_lex; // Not owned
+   /** For each domain integrator, the index of the integrator whose action is
+       fused with its own, see BilinearFormIntegrator::CanFusePA(). The value
+       is -1 for unfused integrators and -2 for the second integrator of a
+       fused pair. */
+   Array<int> dbfi_fused;
 
 public:
    PABilinearFormExtension(BilinearForm*);
@@ -90,6 +95,8 @@ public:
 
 protected:
    void SetupRestrictionOperators(const L2FaceValues m);
+   /// Add the action of the domain integrators on the E-vector @a x to @a y.
+   void AddMultDomainPA(const Vector &x, Vector &y) const;
 };
 
 /// Data and methods for element-assembled bilinear forms
@@ -155,6 +162,10 @@ public:
    void Mult(const Vector &x, Vector &y) const;
    void MultTranspose(const Vector &x, Vector &y) const;
    void Update();
+
+protected:
+   /// Setup the restrictions used by the face integrators.
+   void SetupRestrictionOperators();
 };
 
 /// Class extending the MixedBilinearForm class to support different AssemblyLevels.
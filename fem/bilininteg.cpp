@@ -12,6 +12,7 @@
 // Implementation of Bilinear Form Integrators
 
 #include "fem.hpp"
+#include "../general/forall.hpp"
 #include <cmath>
 #include <algorithm>
 
@@ -20,6 +21,267 @@ using namespace std;
 namespace mfem
 {
 
+// The element of the mesh nodes of element @a e, or the linear element of the
+// vertices if the mesh has no nodes.
+static const FiniteElement *PANodalElement(const Mesh &mesh, const int e)
+{
+   const GridFunction *nodes = mesh.GetNodes();
+   if (nodes) { return nodes->FESpace()->GetFE(e); }
+   const Element::Type type = mesh.GetElement(e)->GetType();
+   return Mesh::GetTransformationFEforElementType(type);
+}
+
+void PAElementNodes(const FiniteElementSpace &fes, Vector &enodes)
+{
+   const Mesh *mesh = fes.GetMesh();
+   const GridFunction *nodes = mesh->GetNodes();
+   if (nodes)
+   {
+      const Operator *R =
+         nodes->FESpace()->GetElementRestriction(ElementDofOrdering::NATIVE);
+      enodes.SetSize(R->Height(), Device::GetMemoryType());
+      R->Mult(*nodes, enodes);
+      return;
+   }
+   // Gather the vertices with the layout of the element restriction, grouped
+   // by geometry, instead of adding nodes to the mesh
+   const int sdim = mesh->SpaceDimension();
+   Array<int> offsets, elements;
+   fes.GetElementGroups(offsets, elements);
+   int size = 0;
+   for (int e = 0; e < mesh->GetNE(); e++)
+   {
+      size += sdim * mesh->GetElement(e)->GetNVertices();
+   }
+   enodes.SetSize(size, Device::GetMemoryType());
+   double *X = enodes.HostWrite();
+   for (int k = 0; k < elements.Size(); k++)
+   {
+      const Element *el = mesh->GetElement(elements[k]);
+      const int nv = el->GetNVertices();
+      const int *v = el->GetVertices();
+      for (int i = 0; i < sdim; i++)
+      {
+         for (int d = 0; d < nv; d++)
+         {
+            X[d + nv*i] = mesh->GetVertex(v[d])[i];
+         }
+      }
+      X += nv * sdim;
+   }
+}
+
+void PAElementJacobians(const FiniteElementSpace &fes, const Vector &enodes,
+                        const int g, const IntegrationRule &ir, Vector &J)
+{
+   const Mesh *mesh = fes.GetMesh();
+   const int dim = mesh->Dimension();
+   const int sdim = mesh->SpaceDimension();
+   Array<int> offsets, elements;
+   fes.GetElementGroups(offsets, elements);
+   // Offset of the group in the E-vector of the nodes
+   int offset = 0;
+   for (int k = 0; k < g; k++)
+   {
+      const int nek = offsets[k+1] - offsets[k];
+      if (nek == 0) { continue; }
+      const FiniteElement &elk = *PANodalElement(*mesh, elements[offsets[k]]);
+      offset += nek * sdim * elk.GetDof();
+   }
+   const int NE = offsets[g+1] - offsets[g];
+   const int NQ = ir.GetNPoints();
+   J.SetSize(NQ*sdim*dim*NE, Device::GetMemoryType());
+   if (NE == 0) { return; }
+   const FiniteElement &el = *PANodalElement(*mesh, elements[offsets[g]]);
+   const DofToQuad &maps = el.GetDofToQuad(ir, DofToQuad::FULL);
+   const int ND = maps.ndof;
+   const int SDIM = sdim, DIM = dim;
+   const auto G = Reshape(maps.G.Read(), NQ, DIM, ND);
+   const auto X = Reshape(enodes.Read() + offset, ND, SDIM, NE);
+   auto d_J = Reshape(J.Write(), NQ, SDIM, DIM, NE);
+   MFEM_FORALL(qe, NQ*NE,
+   {
+      const int q = qe % NQ;
+      const int e = qe / NQ;
+      for (int k = 0; k < DIM; k++)
+      {
+         for (int i = 0; i < SDIM; i++)
+         {
+            double j = 0.0;
+            for (int d = 0; d < ND; d++) { j += G(q,k,d) * X(d,i,e); }
+            d_J(q,i,k,e) = j;
+         }
+      }
+   });
+}
+
+bool PACollapsedBasisSetup(const FiniteElement &el, const IntegrationRule &ir,
+                           PACollapsedBasis &basis)
+{
+   const Array<int> *dof_map = NULL;
+   if (auto tri = dynamic_cast<const H1Pos_TriangleElement*>(&el))
+   {
+      dof_map = &tri->GetDofMap();
+   }
+   else if (auto tet = dynamic_cast<const H1Pos_TetrahedronElement*>(&el))
+   {
+      dof_map = &tet->GetDofMap();
+   }
+   // At orders 1 and 2, the full DofToQuad maps are faster
+   if (!dof_map || el.GetOrder() < 3) { return false; }
+   // The rules of GetCollapsed() are stored with their order
+   if (&ir != &IntRules.GetCollapsed(el.GetGeomType(), ir.GetOrder()))
+   {
+      return false;
+   }
+   const int dim = el.GetDim();
+   const int p = el.GetOrder();
+   const int NQ = ir.GetNPoints();
+   const int Q1D = (int) std::floor(std::pow(NQ, 1.0/dim) + 0.5);
+   if (p + 1 > MAX_D1D || Q1D > MAX_Q1D) { return false; }
+   // Recover the 1D points from the points (a,0,0), (0,b,0) and (0,0,c) of
+   // the collapsed rule, see IntegrationRules::GetCollapsed()
+   Array<double> X(Q1D);
+   const IntegrationPoint &ip0 = ir.IntPoint(0);
+   const double c0 = ip0.z, b0 = ip0.y / (1.0 - c0);
+   for (int q = 0; q < Q1D; q++)
+   {
+      X[q] = ir.IntPoint(q).x / ((1.0 - b0) * (1.0 - c0));
+   }
+   basis.order = p;
+   basis.Q1D = Q1D;
+   basis.ir = &ir;
+   basis.X = X;
+   basis.dof_map = *dof_map;
+   basis.B.SetSize(Q1D*(p+1)*(p+1));
+   basis.G.SetSize(Q1D*(p+1)*(p+1));
+   basis.B = 0.0;
+   basis.G = 0.0;
+   auto B = Reshape(basis.B.HostWrite(), Q1D, p+1, p+1);
+   auto G = Reshape(basis.G.HostWrite(), Q1D, p+1, p+1);
+   Vector u(p+1), d(p+1);
+   for (int q = 0; q < Q1D; q++)
+   {
+      for (int n = 0; n <= p; n++)
+      {
+         Poly_1D::CalcBernstein(n, X[q], u.GetData(), d.GetData());
+         for (int i = 0; i <= n; i++)
+         {
+            B(q,i,n) = u(i);
+            G(q,i,n) = d(i);
+         }
+      }
+   }
+   return true;
+}
+
+void PAEvalCoefficient(Coefficient *Q, const FiniteElementSpace &fes,
+                       const IntegrationRule &ir, Vector &coeff)
+{
+   const int NE = fes.GetNE();
+   const int NQ = ir.GetNPoints();
+   if (Q == nullptr)
+   {
+      coeff.SetSize(1);
+      coeff(0) = 1.0;
+   }
+   else if (ConstantCoefficient* cQ = dynamic_cast<ConstantCoefficient*>(Q))
+   {
+      coeff.SetSize(1);
+      coeff(0) = cQ->constant;
+   }
+   else if (QuadratureFunctionCoefficient* cQ =
+               dynamic_cast<QuadratureFunctionCoefficient*>(Q))
+   {
+      const QuadratureFunction &qFun = cQ->GetQuadFunction();
+      MFEM_VERIFY(qFun.Size() == NQ * NE,
+                  "Incompatible QuadratureFunction dimension \n");
+
+      MFEM_VERIFY(&ir == &qFun.GetSpace()->GetElementIntRule(0),
+                  "IntegrationRule used within integrator and in"
+                  " QuadratureFunction appear to be different");
+      qFun.Read();
+      coeff.MakeRef(const_cast<QuadratureFunction &>(qFun),0);
+   }
+   else
+   {
+      // Use the batched Coefficient::Project() when the QuadratureSpace with
+      // the order of ir uses the same IntegrationRule.
+      Mesh *mesh = fes.GetMesh();
+      if (NE > 0 && mesh->GetNumGeometries(mesh->Dimension()) == 1)
+      {
+         QuadratureSpace qs(mesh, ir.GetOrder());
+         if (&qs.GetElementIntRule(0) == &ir)
+         {
+            QuadratureFunction qf(&qs);
+            Q->Project(qf);
+            coeff.Swap(qf);
+            return;
+         }
+      }
+      coeff.SetSize(NQ * NE);
+      auto C = Reshape(coeff.HostWrite(), NQ, NE);
+      for (int e = 0; e < NE; ++e)
+      {
+         ElementTransformation& T = *fes.GetElementTransformation(e);
+         for (int q = 0; q < NQ; ++q)
+         {
+            C(q,e) = Q->Eval(T, ir.IntPoint(q));
+         }
+      }
+   }
+}
+
+void PAScaleQuadratureData(const int NQ, const int S, const int NE,
+                           const Vector &g, const Vector &c, Vector &d)
+{
+   const bool const_c = c.Size() == 1;
+   const auto G = Reshape(g.Read(), NQ, S, NE);
+   const auto C = const_c ? Reshape(c.Read(), 1,1) : Reshape(c.Read(), NQ,NE);
+   auto D = Reshape(d.Write(), NQ, S, NE);
+   MFEM_FORALL(qe, NQ*NE,
+   {
+      const int q = qe % NQ;
+      const int e = qe / NQ;
+      const double coeff = const_c ? C(0,0) : C(q,e);
+      for (int s = 0; s < S; s++) { D(q,s,e) = coeff * G(q,s,e); }
+   });
+}
+
+void PAExpandAffineQuadratureData(const int NQ, const int S, const int NE,
+                                  const Array<double> &W, const Vector &d_e,
+                                  Vector &d)
+{
+   d.SetSize(NQ*S*NE, Device::GetDeviceMemoryType());
+   const auto w = W.Read();
+   const auto De = Reshape(d_e.Read(), S, NE);
+   auto D = Reshape(d.Write(), NQ, S, NE);
+   MFEM_FORALL(qe, NQ*NE,
+   {
+      const int q = qe % NQ;
+      const int e = qe / NQ;
+      for (int s = 0; s < S; s++) { D(q,s,e) = w[q] * De(s,e); }
+   });
+}
+
+void PAConvertQuadratureData(const Vector &d, Array<float> &d_single)
+{
+   const int N = d.Size();
+   d_single.SetSize(N, Device::GetDeviceMemoryType());
+   const auto D = d.Read();
+   auto F = d_single.Write();
+   MFEM_FORALL(i, N, F[i] = (float) D[i];);
+}
+
+void PAConvertQuadratureData(const Array<float> &d_single, Vector &d)
+{
+   const int N = d_single.Size();
+   d.SetSize(N, Device::GetDeviceMemoryType());
+   const auto F = d_single.Read();
+   auto D = d.Write();
+   MFEM_FORALL(i, N, D[i] = F[i];);
+}
+
 void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace&)
 {
    mfem_error ("BilinearFormIntegrator::AssemblePA(...)\n"
@@ -96,12 +358,33 @@ void BilinearFormIntegrator::AddMultTransposePA(const Vector &, Vector &) const
                "   is not implemented for this class.");
 }
 
+void BilinearFormIntegrator::AddMultPAFused(const BilinearFormIntegrator &,
+                                            const Vector &, Vector &) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultPAFused(...)\n"
+               "   is not implemented for this class.");
+}
+
 void BilinearFormIntegrator::AssembleMF(const FiniteElementSpace &fes)
 {
    mfem_error ("BilinearFormIntegrator::AssembleMF(...)\n"
                "   is not implemented for this class.");
 }
 
+void BilinearFormIntegrator::AssembleMFInteriorFaces(const FiniteElementSpace
+                                                     &fes)
+{
+   mfem_error ("BilinearFormIntegrator::AssembleMFInteriorFaces(...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleMFBoundaryFaces(const FiniteElementSpace
+                                                     &fes)
+{
+   mfem_error ("BilinearFormIntegrator::AssembleMFBoundaryFaces(...)\n"
+               "   is not implemented for this class.");
+}
+
 void BilinearFormIntegrator::AddMultMF(const Vector &, Vector &) const
 {
    mfem_error ("BilinearFormIntegrator::AddMultMF(...)\n"
@@ -887,6 +1170,12 @@ const IntegrationRule &DiffusionIntegrator::GetRule(
 }
 
 
+MassIntegrator::~MassIntegrator()
+{
+   if (pa_affine) { GeometricFactors::Release(geom); }
+   delete ceedDataPtr;
+}
+
 void MassIntegrator::AssembleElementMatrix
 ( const FiniteElement &el, ElementTransformation &Trans,
   DenseMatrix &elmat )
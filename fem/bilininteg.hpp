@@ -27,6 +27,144 @@ constexpr int HCURL_MAX_Q1D = 6;
 constexpr int HDIV_MAX_D1D = 5;
 constexpr int HDIV_MAX_Q1D = 6;
 
+/** @brief Partial assembly data of one group of elements with the same
+    geometry, used by integrators on meshes with mixed elements, see
+    FiniteElementSpace::GetElementGroups(). */
+struct PAElementGroup
+{
+   const DofToQuad *maps; ///< Not owned. TENSOR or FULL maps of the group.
+   int ne;        ///< Number of elements in the group
+   int e_offset;  ///< Offset of the group in the (scalar) E-vectors
+   int pa_offset; ///< Offset of the group in the quadrature data
+};
+
+/** @brief Bernstein basis of an H1Pos_TriangleElement or
+    H1Pos_TetrahedronElement at the 1D points of a collapsed integration rule,
+    see IntegrationRules::GetCollapsed(). */
+/** In the collapsed coordinates (a,b,c), the Bernstein polynomial of order p
+    with the powers (i,j) of (x,y) is B^{p-j}_i(a) B^p_j(b), and the one with
+    the powers (i,j,k) of (x,y,z) is B^{p-j-k}_i(a) B^{p-k}_j(b) B^p_k(c). The
+    PA actions of MassIntegrator and DiffusionIntegrator are then computed by
+    sum factorization, with O(p^{dim+1}) operations per element instead of the
+    O(p^{2 dim}) of the full DofToQuad maps. */
+struct PACollapsedBasis
+{
+   int order = -1; ///< Order p of the basis, negative if not set up
+   int Q1D;        ///< Number of 1D points
+   const IntegrationRule *ir; ///< Not owned. The collapsed rule.
+   /** Values and derivatives B(q,i,n) of the 1D Bernstein polynomials B^n_i,
+       0 <= i <= n <= p, at the 1D points, with layout Q1D x (p+1) x (p+1). */
+   Array<double> B, G;
+   Array<double> X;     ///< The 1D points in (0,1)
+   Array<int> dof_map;  ///< See H1Pos_TriangleElement::GetDofMap()
+};
+
+// Set up @a basis if @a ir is a rule of IntegrationRules::GetCollapsed() and
+// @a el is an H1Pos_TriangleElement or H1Pos_TetrahedronElement of an order
+// for which the sum-factorized kernels are supported and faster, i.e. from 3
+// up to MAX_D1D-1. Returns false, leaving @a basis unchanged, otherwise.
+bool PACollapsedBasisSetup(const FiniteElement &el, const IntegrationRule &ir,
+                           PACollapsedBasis &basis);
+
+// Compute the E-vector @a enodes of the mesh nodes of @a fes, in the NATIVE
+// ordering, used by PAElementJacobians().
+void PAElementNodes(const FiniteElementSpace &fes, Vector &enodes);
+
+// Compute on the device the Jacobians at the points of @a ir in the elements of
+// the group @a g, see FiniteElementSpace::GetElementGroups(), from the E-vector
+// @a enodes of PAElementNodes(). The layout of @a J is NQ x SDIM x DIM x NE, as
+// in GeometricFactors::J, which does not support meshes with mixed elements.
+void PAElementJacobians(const FiniteElementSpace &fes, const Vector &enodes,
+                        const int g, const IntegrationRule &ir, Vector &J);
+
+// Evaluate the scalar coefficient @a Q at the points of @a ir in all elements
+// of @a fes, with the layout NQ x NE. A NULL or constant coefficient gives a
+// Vector of size 1 and a QuadratureFunctionCoefficient is referenced directly.
+void PAEvalCoefficient(Coefficient *Q, const FiniteElementSpace &fes,
+                       const IntegrationRule &ir, Vector &coeff);
+
+// Set the quadrature data @a d, with the layout NQ x S x NE, to the geometric
+// data @a g multiplied by the coefficient values @a c computed by
+// PAEvalCoefficient().
+void PAScaleQuadratureData(const int NQ, const int S, const int NE,
+                           const Vector &g, const Vector &c, Vector &d);
+
+// Expand the quadrature data @a d_e of affine elements, with the layout S x NE,
+// to the data @a d at all quadrature points, with the layout NQ x S x NE, by
+// multiplying it by the quadrature weights @a W.
+void PAExpandAffineQuadratureData(const int NQ, const int S, const int NE,
+                                  const Array<double> &W, const Vector &d_e,
+                                  Vector &d);
+
+// Convert the quadrature data @a d to single precision, and back, see
+// BilinearFormIntegrator::AssemblePAMixedPrecision().
+void PAConvertQuadratureData(const Vector &d, Array<float> &d_single);
+void PAConvertQuadratureData(const Array<float> &d_single, Vector &d);
+
+/** @brief Connectivity and 1D bases of the interior or boundary faces of a
+    tensor-product DG space, used by the PA and MF kernels of the face
+    integrators that act on the element dofs on both sides of the faces. */
+/** The quadrature points of a face are numbered lexicographically in the face
+    of its first element, as in the face restrictions and FaceGeometricFactors.
+    The setup matches the points seen from the second element to this
+    numbering, so the kernels need no orientation logic. */
+struct PADGFaceMaps
+{
+   int dim, nf, ne;
+   int D1D, Q1D; ///< Number of dofs and quadrature points in 1D
+   int NQ;       ///< Number of quadrature points per face, Q1D^(dim-1)
+   Array<int> elem;      ///< (2, NF) Elements of the faces, -1 if none
+   /// (2, NF) Local face in each element, 2*dir + side: the face is normal to
+   /// the reference direction dir, at the coordinate side = 0 or 1
+   Array<int> loc;
+   Array<int> perm;      ///< (NQ, NF) Points of the faces in the 2nd elements
+   Array<int> elem_face; ///< (2*dim, NE) 2*f + s for the local faces, or -1
+   Array<double> B, G;   ///< (Q1D, D1D) 1D basis at the quadrature points
+   Array<double> Bf, Gf; ///< (D1D, 2) 1D basis at the end points 0 and 1
+   Array<double> W;      ///< (NQ) Weights of the face quadrature points
+
+   /// Mesh nodes used by the matrix-free kernels, see SetupNodes()
+   int ND1D;
+   Array<double> NB, NG, NBf, NGf; ///< 1D bases of the mesh nodes
+   Vector nodes; ///< (ND1D^dim, dim, NE) E-vector of the mesh nodes
+
+   PADGFaceMaps() : dim(0), nf(0), ne(0), D1D(0), Q1D(0), NQ(0), ND1D(0) { }
+
+   /// Setup the maps for the faces of @a type, with the face rule @a ir.
+   void Setup(const FiniteElementSpace &fes, FaceType type,
+              const IntegrationRule &ir);
+
+   /// Setup the E-vector and the 1D bases of the mesh nodes.
+   void SetupNodes(const FiniteElementSpace &fes);
+
+   /** @brief Evaluate the coefficient @a Q at the face points, in both
+       elements of the faces, with the layout (NQ, 2, NF) of @a C. */
+   /** If @a Q is NULL or constant, @a C has size 1. */
+   void EvalCoefficient(const FiniteElementSpace &fes, Coefficient *Q,
+                        Vector &C) const;
+
+   /// Same as above for a matrix coefficient, with the layout (dim, dim, NQ,
+   /// 2, NF) of @a C.
+   void EvalCoefficient(const FiniteElementSpace &fes, MatrixCoefficient &MQ,
+                        Vector &C) const;
+
+   /** @brief Add the face contributions @a z, with the layout (D1D^(dim-1), 2,
+       VDIM, 2, NF), to the element E-vector @a y. */
+   /** The two values per face dof are the coefficients of the 1D basis and of
+       its derivative, in the normal direction, at the face. */
+   void AddFaceTerms(const int vdim, const Vector &z, Vector &y) const;
+
+   /** @brief Add the diagonal of the face terms to the element E-vector
+       @a diag, from the data @a d with the layout (dim + 1, NQ, VDIM, 2,
+       NF). */
+   /** The contribution of the face f to the diagonal entry of the basis
+       function phi, in the component c, of the element on the side s is the
+       sum over the face points q of phi (h . grad(phi)) + p phi^2, where the
+       reference vector h and the weight p are d(0:dim-1,q,c,s,f) and
+       d(dim,q,c,s,f). The points are numbered in the face of that element. */
+   void AddFaceDiagonal(const int vdim, const Vector &d, Vector &diag) const;
+};
+
 /// Abstract base class BilinearFormIntegrator
 class BilinearFormIntegrator : public NonlinearFormIntegrator
 {
@@ -61,6 +199,14 @@ public:
 
    virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes);
 
+   /** @brief Partial assembly with the quadrature data stored in single
+       precision, see BilinearForm::EnablePAMixedPrecision(). */
+   /** The action is still computed in double precision. The default
+       implementation calls AssemblePA(), i.e. it keeps double precision data;
+       calling AssemblePA() afterwards also returns to double precision. */
+   virtual void AssemblePAMixedPrecision(const FiniteElementSpace &fes)
+   { AssemblePA(fes); }
+
    /// Assemble diagonal and add it to Vector @a diag.
    virtual void AssembleDiagonalPA(Vector &diag);
 
@@ -85,6 +231,22 @@ public:
        called. */
    virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
 
+   /** @brief Returns true if the partially assembled actions of this integrator
+       and @a other can be computed together with AddMultPAFused(). */
+   /** Both integrators must have been assembled with AssemblePA() on the same
+       space. The default implementation returns false. */
+   virtual bool CanFusePA(const BilinearFormIntegrator &other) const
+   { return false; }
+
+   /// Method for the fused partially assembled action of two integrators.
+   /** Perform the action of the sum of this integrator and @a other on the
+       E-vector @a x and add the result to the E-vector @a y. The interpolation
+       to the quadrature points and the integration back are done only once.
+
+       This method can be called only if CanFusePA(@a other) returns true. */
+   virtual void AddMultPAFused(const BilinearFormIntegrator &other,
+                               const Vector &x, Vector &y) const;
+
    /// Method defining element assembly.
    /** The result of the element assembly is added to the @a emat Vector if
        @a add is true. Otherwise, if @a add is false, we set @a emat. */
@@ -100,6 +262,27 @@ public:
        can be used later in the methods AddMultMF() and AddMultTransposeMF(). */
    virtual void AssembleMF(const FiniteElementSpace &fes);
 
+   virtual void AssembleMFInteriorFaces(const FiniteElementSpace &fes);
+
+   virtual void AssembleMFBoundaryFaces(const FiniteElementSpace &fes);
+
+   /** @brief Returns true if the face actions AddMultPA(), AddMultMF() and
+       their transposes take E-vectors of the element dofs, instead of the
+       E-vectors of the face dofs given by a face restriction. */
+   /** This is the case for the face integrators that need the normal
+       derivatives of the traces, e.g. the interior penalty integrators. Their
+       methods AssembleDiagonalPA() and AssembleDiagonalMF() then add the
+       diagonal of the face terms to the element E-vector. The default
+       implementation returns false. */
+   virtual bool FaceActionUsesElementDofs() const { return false; }
+
+   /** @brief Returns true if AssemblePA(const FiniteElementSpace&) supports
+       meshes with more than one element geometry. */
+   /** The partial assembly extensions abort with an error if an integrator
+       without this support is used on such a mesh. The default implementation
+       returns false. */
+   virtual bool SupportsMixedMeshesPA() const { return false; }
+
    /** Perform the action of integrator on the input @a x and add the result to
        the output @a y. Both @a x and @a y are E-vectors, i.e. they represent
        the element-wise discontinuous version of the FE space.
@@ -1098,11 +1281,18 @@ public:
    { test_fe.CalcPhysDShape(Trans, shape); }
 };
 
+class CurlCurlIntegrator;
+
 /** Class for integrating the bilinear form a(u,v) := (Q Curl u, Curl v) in 3D
     and where Q is a scalar or matrix coefficient u and v are both in
     H(Curl). */
 class MixedCurlCurlIntegrator : public MixedVectorIntegrator
 {
+private:
+   // PA extension, implemented with a CurlCurlIntegrator using the same
+   // coefficient. Requires the same trial and test spaces.
+   CurlCurlIntegrator *pa_curlcurl = nullptr;
+
 public:
    MixedCurlCurlIntegrator() { same_calc_shape = true; }
    MixedCurlCurlIntegrator(Coefficient &q)
@@ -1139,6 +1329,17 @@ public:
                                      ElementTransformation &Trans,
                                      DenseMatrix & shape)
    { test_fe.CalcPhysCurlShape(Trans, shape); }
+
+   using BilinearFormIntegrator::AssemblePA;
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+   virtual void AssemblePA(const FiniteElementSpace &trial_fes,
+                           const FiniteElementSpace &test_fes);
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+   virtual void AssembleDiagonalPA(Vector &diag);
+   virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                           const bool add);
+
+   virtual ~MixedCurlCurlIntegrator();
 };
 
 /** Class for integrating the bilinear form a(u,v) := (V x Curl u, Curl v) in 3D
@@ -1735,11 +1936,17 @@ protected:
    }
 
    using BilinearFormIntegrator::AssemblePA;
+   virtual void AssemblePA(const FiniteElementSpace &fes);
    virtual void AssemblePA(const FiniteElementSpace &trial_fes,
                            const FiniteElementSpace &test_fes);
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   /// Require the same H(curl) trial and test spaces
+   virtual void AssembleDiagonalPA(Vector &diag);
+   virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                           const bool add);
+
 private:
    // PA extension
    Vector pa_data;
@@ -1790,11 +1997,17 @@ protected:
    }
 
    using BilinearFormIntegrator::AssemblePA;
+   virtual void AssemblePA(const FiniteElementSpace &fes);
    virtual void AssemblePA(const FiniteElementSpace &trial_fes,
                            const FiniteElementSpace &test_fes);
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   /// Require the same H(curl) trial and test spaces
+   virtual void AssembleDiagonalPA(Vector &diag);
+   virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                           const bool add);
+
 private:
    // PA extension
    Vector pa_data;
@@ -1893,7 +2106,18 @@ public:
 };
 
 /** Class for integrating the bilinear form a(u,v) := (Q grad u, grad v) where Q
-    can be a scalar or a matrix coefficient. */
+    can be a scalar or a matrix coefficient.
+
+    With partial assembly on tensor elements, specialized kernels are used for
+    the default quadrature rules up to order 10. Orders 11 to MAX_D1D-1 use the
+    slower generic kernels and print a warning; higher orders are rejected.
+    Only the numbers of 1D points of the default rules are specialized; other
+    rules, e.g. set with SetIntRule(), use the generic kernels without a
+    warning.
+
+    On H1Pos_TriangleElement and H1Pos_TetrahedronElement of order 3 or more,
+    the partial assembly is sum-factorized if the rule set with SetIntRule() is
+    one of IntegrationRules::GetCollapsed(). */
 class DiffusionIntegrator: public BilinearFormIntegrator
 {
 protected:
@@ -1913,28 +2137,50 @@ private:
    const FiniteElementSpace *fespace;
    const DofToQuad *maps;         ///< Not owned
    const GeometricFactors *geom;  ///< Not owned
+   /// For non-tensor elements (FULL #maps), the total dofs and quad points.
    int dim, ne, dofs1D, quad1D;
    Vector pa_data;
+   /** True if #pa_data stores one symmetric matrix per element, without the
+       quadrature weights: on affine meshes with a constant coefficient. */
+   bool pa_affine = false;
+   /** Single precision copy of #pa_data, used instead of it after
+       AssemblePAMixedPrecision(). */
+   Array<float> pa_data_single;
+   /// True after AssemblePAMixedPrecision(), kept by UpdateCoefficient().
+   bool pa_mixed_precision = false;
    bool symmetric = true; ///< False if using a nonsymmetric matrix coefficient
+   /// Element groups on meshes with mixed elements, empty otherwise.
+   Array<PAElementGroup> pa_groups;
+   /// Bernstein basis of the sum-factorized simplex kernels, if set up.
+   PACollapsedBasis pa_collapsed;
    // CEED extension
    CeedData* ceedDataPtr;
 
+   void AssemblePAMixed(const FiniteElementSpace &fes);
+   /** Compute #pa_data from the coefficient and the Jacobians cached by the
+       Mesh, with the #maps set up by AssemblePA(). */
+   void SetupPAQuadratureData();
+
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
    DiffusionIntegrator()
-      : Q(NULL), VQ(NULL), MQ(NULL), maps(NULL), geom(NULL), ceedDataPtr(NULL) { }
+      : Q(NULL), VQ(NULL), MQ(NULL), fespace(NULL), maps(NULL),
+        geom(NULL), ceedDataPtr(NULL) { }
 
    /// Construct a diffusion integrator with a scalar coefficient q
    DiffusionIntegrator(Coefficient &q)
-      : Q(&q), VQ(NULL), MQ(NULL), maps(NULL), geom(NULL), ceedDataPtr(NULL) { }
+      : Q(&q), VQ(NULL), MQ(NULL), fespace(NULL), maps(NULL),
+        geom(NULL), ceedDataPtr(NULL) { }
 
    /// Construct a diffusion integrator with a vector coefficient q
    DiffusionIntegrator(VectorCoefficient &q)
-      : Q(NULL), VQ(&q), MQ(NULL), maps(NULL), geom(NULL), ceedDataPtr(NULL) { }
+      : Q(NULL), VQ(&q), MQ(NULL), fespace(NULL), maps(NULL),
+        geom(NULL), ceedDataPtr(NULL) { }
 
    /// Construct a diffusion integrator with a matrix coefficient q
    DiffusionIntegrator(MatrixCoefficient &q)
-      : Q(NULL), VQ(NULL), MQ(&q), maps(NULL), geom(NULL), ceedDataPtr(NULL) { }
+      : Q(NULL), VQ(NULL), MQ(&q), fespace(NULL), maps(NULL),
+        geom(NULL), ceedDataPtr(NULL) { }
 
    virtual ~DiffusionIntegrator()
    {
@@ -1973,6 +2219,11 @@ public:
 
    virtual void AssemblePA(const FiniteElementSpace &fes);
 
+   /** Supported on meshes with a single element type and without libCEED; the
+       data of affine elements, stored once per element, is kept in double
+       precision. */
+   virtual void AssemblePAMixedPrecision(const FiniteElementSpace &fes);
+
    virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
                            const bool add);
 
@@ -1984,13 +2235,41 @@ public:
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   /** @brief Set the scalar coefficient to @a q and update the partially
+       assembled data without setting up the basis again. */
+   /** This can be called only after AssemblePA(). The quadrature data is
+       recomputed from @a q and the Jacobians cached by
+       Mesh::GetGeometricFactors(), which are not evaluated again. */
+   void UpdateCoefficient(Coefficient &q);
+
+   /// Fusion is supported with a MassIntegrator using the same DofToQuad maps.
+   virtual bool CanFusePA(const BilinearFormIntegrator &other) const;
+
+   virtual bool SupportsMixedMeshesPA() const { return true; }
+
+   virtual void AddMultPAFused(const BilinearFormIntegrator &other,
+                               const Vector &x, Vector &y) const;
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe);
 };
 
-/** Class for local mass matrix assembling a(u,v) := (Q u, v) */
+/** Class for local mass matrix assembling a(u,v) := (Q u, v)
+
+    With partial assembly on tensor elements, specialized kernels are used for
+    the default quadrature rules up to order 10. Orders 11 to MAX_D1D-1 use the
+    slower generic kernels and print a warning; higher orders are rejected.
+    Only the numbers of 1D points of the default rules are specialized; other
+    rules, e.g. set with SetIntRule(), use the generic kernels without a
+    warning.
+
+    On H1Pos_TriangleElement and H1Pos_TetrahedronElement of order 3 or more,
+    the partial assembly is sum-factorized if the rule set with SetIntRule() is
+    one of IntegrationRules::GetCollapsed(). */
 class MassIntegrator: public BilinearFormIntegrator
 {
+   friend class DiffusionIntegrator; // for the fused PA action
+
 protected:
 #ifndef MFEM_THREAD_SAFE
    Vector shape, te_shape;
@@ -1999,27 +2278,48 @@ protected:
    // PA extension
    const FiniteElementSpace *fespace;
    Vector pa_data;
+   /** True on affine meshes with a constant coefficient: the action reads the
+       element determinants from the compressed #geom, registered as a user of
+       it, and the weights from #pa_weights; #pa_data is empty. */
+   bool pa_affine = false;
+   /// Quadrature weights multiplied by the constant coefficient if #pa_affine.
+   Array<double> pa_weights;
+   /** Single precision copy of #pa_data, used instead of it after
+       AssemblePAMixedPrecision(). */
+   Array<float> pa_data_single;
+   /// True after AssemblePAMixedPrecision(), kept by UpdateCoefficient().
+   bool pa_mixed_precision = false;
    const DofToQuad *maps;         ///< Not owned
    const GeometricFactors *geom;  ///< Not owned
+   /// For non-tensor elements (FULL #maps), the total dofs and quad points.
    int dim, ne, nq, dofs1D, quad1D;
+   /// Element groups on meshes with mixed elements, empty otherwise.
+   Array<PAElementGroup> pa_groups;
+   /// Bernstein basis of the sum-factorized simplex kernels, if set up.
+   PACollapsedBasis pa_collapsed;
 
    // CEED extension
    CeedData* ceedDataPtr;
 
+   void AssemblePAMixed(const FiniteElementSpace &fes);
+   /** Compute #pa_data, or #pa_weights if #pa_affine, from the coefficient and
+       the Jacobians cached by the Mesh, with the #maps set up by
+       AssemblePA(). */
+   void SetupPAQuadratureData();
+
 public:
    MassIntegrator(const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir), Q(NULL), maps(NULL), geom(NULL),
+      : BilinearFormIntegrator(ir), Q(NULL), fespace(NULL), maps(NULL),
+        geom(NULL),
         ceedDataPtr(NULL) { }
 
    /// Construct a mass integrator with coefficient q
    MassIntegrator(Coefficient &q, const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir), Q(&q), maps(NULL), geom(NULL),
+      : BilinearFormIntegrator(ir), Q(&q), fespace(NULL), maps(NULL),
+        geom(NULL),
         ceedDataPtr(NULL) { }
 
-   virtual ~MassIntegrator()
-   {
-      delete ceedDataPtr;
-   }
+   virtual ~MassIntegrator();
    /** Given a particular Finite Element computes the element mass matrix
        elmat. */
    virtual void AssembleElementMatrix(const FiniteElement &el,
@@ -2036,6 +2336,11 @@ public:
 
    virtual void AssemblePA(const FiniteElementSpace &fes);
 
+   /** Supported on meshes with a single element type and without libCEED; on
+       affine elements, the action keeps reading the shared double precision
+       determinants. */
+   virtual void AssemblePAMixedPrecision(const FiniteElementSpace &fes);
+
    virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
                            const bool add);
 
@@ -2047,6 +2352,16 @@ public:
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   virtual bool SupportsMixedMeshesPA() const { return true; }
+
+   /** @brief Set the coefficient to @a q and update the partially assembled
+       data without setting up the basis again. */
+   /** This can be called only after AssemblePA(), on an integrator without a
+       vector or matrix coefficient. The quadrature data is recomputed from @a
+       q and the Jacobians cached by Mesh::GetGeometricFactors(), which are not
+       evaluated again. */
+   void UpdateCoefficient(Coefficient &q);
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe,
                                          ElementTransformation &Trans);
@@ -2373,6 +2688,8 @@ public:
    virtual void AssemblePA(const FiniteElementSpace &fes);
    virtual void AddMultPA(const Vector &x, Vector &y) const;
    virtual void AssembleDiagonalPA(Vector& diag);
+   virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                           const bool add);
 };
 
 /** Integrator for (curl u, curl v) for FE spaces defined by 'dim' copies of a
@@ -2459,6 +2776,8 @@ public:
                            const FiniteElementSpace &test_fes);
    virtual void AddMultPA(const Vector &x, Vector &y) const;
    virtual void AssembleDiagonalPA(Vector& diag);
+   virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                           const bool add);
 };
 
 /** Integrator for (Q div u, p) where u=(v1,...,vn) and all vi are in the same
@@ -2736,18 +3055,56 @@ protected:
    Vector shape1, shape2, dshape1dn, dshape2dn, nor, nh, ni;
    DenseMatrix jmat, dshape1, dshape2, mq, adjJ;
 
+   // PA and MF extension
+   PADGFaceMaps maps;
+   Vector pa_data;
+   double mf_coeff; ///< Constant coefficient used by the MF action
+   mutable Vector face_z;
+
 public:
    DGDiffusionIntegrator(const double s, const double k)
-      : Q(NULL), MQ(NULL), sigma(s), kappa(k) { }
+      : Q(NULL), MQ(NULL), sigma(s), kappa(k), mf_coeff(1.0) { }
    DGDiffusionIntegrator(Coefficient &q, const double s, const double k)
-      : Q(&q), MQ(NULL), sigma(s), kappa(k) { }
+      : Q(&q), MQ(NULL), sigma(s), kappa(k), mf_coeff(1.0) { }
    DGDiffusionIntegrator(MatrixCoefficient &q, const double s, const double k)
-      : Q(NULL), MQ(&q), sigma(s), kappa(k) { }
+      : Q(NULL), MQ(&q), sigma(s), kappa(k), mf_coeff(1.0) { }
    using BilinearFormIntegrator::AssembleFaceMatrix;
    virtual void AssembleFaceMatrix(const FiniteElement &el1,
                                    const FiniteElement &el2,
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
+
+   using BilinearFormIntegrator::AssemblePA;
+
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes);
+
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   /// Add the diagonal of the face terms to the element E-vector @a diag.
+   virtual void AssembleDiagonalPA(Vector &diag);
+
+   /// The MF action supports only constant scalar coefficients.
+   virtual void AssembleMFInteriorFaces(const FiniteElementSpace &fes);
+
+   virtual void AssembleMFBoundaryFaces(const FiniteElementSpace &fes);
+
+   virtual void AddMultMF(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposeMF(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalMF(Vector &diag);
+
+   /// The face actions need the normal derivatives of both elements.
+   virtual bool FaceActionUsesElementDofs() const { return true; }
+
+private:
+   const IntegrationRule &GetFaceRule(const FiniteElementSpace &fes) const;
+   void SetupPA(const FiniteElementSpace &fes, FaceType type);
+   void SetupMF(const FiniteElementSpace &fes, FaceType type);
 };
 
 /** Integrator for the DG elasticity form, for the formulations see:
@@ -2814,11 +3171,13 @@ class DGElasticityIntegrator : public BilinearFormIntegrator
 {
 public:
    DGElasticityIntegrator(double alpha_, double kappa_)
-      : lambda(NULL), mu(NULL), alpha(alpha_), kappa(kappa_) { }
+      : lambda(NULL), mu(NULL), alpha(alpha_), kappa(kappa_),
+        mf_lambda(1.0), mf_mu(1.0) { }
 
    DGElasticityIntegrator(Coefficient &lambda_, Coefficient &mu_,
                           double alpha_, double kappa_)
-      : lambda(&lambda_), mu(&mu_), alpha(alpha_), kappa(kappa_) { }
+      : lambda(&lambda_), mu(&mu_), alpha(alpha_), kappa(kappa_),
+        mf_lambda(1.0), mf_mu(1.0) { }
 
    using BilinearFormIntegrator::AssembleFaceMatrix;
    virtual void AssembleFaceMatrix(const FiniteElement &el1,
@@ -2826,10 +3185,47 @@ public:
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
 
+   using BilinearFormIntegrator::AssemblePA;
+
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes);
+
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   /// Add the diagonal of the face terms to the element E-vector @a diag.
+   virtual void AssembleDiagonalPA(Vector &diag);
+
+   /// The MF action supports only constant coefficients.
+   virtual void AssembleMFInteriorFaces(const FiniteElementSpace &fes);
+
+   virtual void AssembleMFBoundaryFaces(const FiniteElementSpace &fes);
+
+   virtual void AddMultMF(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposeMF(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalMF(Vector &diag);
+
+   /// The face actions need the normal derivatives of both elements.
+   virtual bool FaceActionUsesElementDofs() const { return true; }
+
 protected:
    Coefficient *lambda, *mu;
    double alpha, kappa;
 
+   // PA and MF extension
+   PADGFaceMaps maps;
+   Vector pa_data;
+   double mf_lambda, mf_mu; ///< Constant coefficients used by the MF action
+   mutable Vector face_z;
+
+   const IntegrationRule &GetFaceRule(const FiniteElementSpace &fes) const;
+   void SetupPA(const FiniteElementSpace &fes, FaceType type);
+   void SetupMF(const FiniteElementSpace &fes, FaceType type);
+
 #ifndef MFEM_THREAD_SAFE
    // values of all scalar basis functions for one component of u (which is a
    // vector) at the integration point in the reference space
@@ -3071,5 +3467,41 @@ void PADiffusionSetup2D(const int Q1D,
                         const Vector &c,
                         Vector &d);
 
+// PA Diffusion Assemble kernel for non-tensor elements (e.g. simplices), with
+// quadrature data D = w det(J) J^{-1} C J^{-T} at the NQ points of each
+// element.
+void PADiffusionSetupSimplex(const int dim,
+                             const int NQ,
+                             const int coeffDim,
+                             const int NE,
+                             const Array<double> &w,
+                             const Vector &j,
+                             const Vector &c,
+                             Vector &d);
+
+// PA Diffusion Apply kernel for non-tensor elements, using the transposed
+// full DofToQuad maps of the trial and test spaces, see DofToQuad::Gt.
+void PADiffusionApplySimplex(const int dim,
+                             const int TR_ND,
+                             const int TE_ND,
+                             const int NQ,
+                             const int NE,
+                             const bool symmetric,
+                             const Array<double> &gt_trial,
+                             const Array<double> &gt_test,
+                             const Vector &d,
+                             const Vector &x,
+                             Vector &y);
+
+// PA Diffusion Diagonal kernel for non-tensor elements
+void PADiffusionDiagonalSimplex(const int dim,
+                                const int ND,
+                                const int NQ,
+                                const int NE,
+                                const bool symmetric,
+                                const Array<double> &gt,
+                                const Vector &d,
+                                Vector &y);
+
 }
 #endif
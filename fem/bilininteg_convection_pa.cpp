@@ -12,6 +12,7 @@
 #include "../general/forall.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
+#include "pa_simd.hpp"
 
 using namespace std;
 
@@ -824,6 +825,176 @@ void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
                      vel, alpha, pa_data);
 }
 
+// PA Convection Apply 2D kernel for Backend::CPU_SIMD
+template<int D1D, int Q1D> static
+void SimdPAConvectionApply2D(const int NE,
+                             const Array<double> &b_,
+                             const Array<double> &g_,
+                             const Vector &op_,
+                             const Vector &x_,
+                             Vector &y_)
+{
+   typedef internal::PASimdTraits::vreal_t vreal_t;
+   constexpr int VS = vreal_t::size;
+   constexpr int ND = D1D*D1D;
+   constexpr int NQ = Q1D*Q1D;
+   const auto b = Reshape(b_.HostRead(), Q1D, D1D);
+   const auto g = Reshape(g_.HostRead(), Q1D, D1D);
+   const double *op = op_.HostRead();
+   const double *x = x_.HostRead();
+   double *y = y_.HostReadWrite();
+   double B[Q1D][D1D], G[Q1D][D1D];
+   for (int dx = 0; dx < D1D; ++dx)
+   {
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         B[qx][dx] = b(qx,dx);
+         G[qx][dx] = g(qx,dx);
+      }
+   }
+   vreal_t X[D1D][D1D], Y[D1D][D1D];
+   vreal_t O[2][Q1D][Q1D], Gu[2][Q1D][Q1D], DGu[Q1D][Q1D];
+   for (int e = 0; e < NE; e += VS)
+   {
+      const int nl = (NE - e < VS) ? NE - e : VS;
+      internal::PASimdLoad(ND, nl, x + e*ND, &X[0][0]);
+      internal::PASimdLoad(2*NQ, nl, op + e*2*NQ, &O[0][0][0]);
+      internal::PASimdGrad2D(B, G, X, Gu);
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            DGu[qy][qx] = (O[0][qy][qx] * Gu[0][qy][qx]) +
+                          (O[1][qy][qx] * Gu[1][qy][qx]);
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx) { Y[dy][dx] = 0.0; }
+      }
+      internal::PASimdEvalT2D(B, DGu, Y);
+      internal::PASimdAddStore(ND, nl, &Y[0][0], y + e*ND);
+   }
+}
+
+// PA Convection Apply 3D kernel for Backend::CPU_SIMD
+template<int D1D, int Q1D> static
+void SimdPAConvectionApply3D(const int NE,
+                             const Array<double> &b_,
+                             const Array<double> &g_,
+                             const Vector &op_,
+                             const Vector &x_,
+                             Vector &y_)
+{
+   typedef internal::PASimdTraits::vreal_t vreal_t;
+   constexpr int VS = vreal_t::size;
+   constexpr int ND = D1D*D1D*D1D;
+   constexpr int NQ = Q1D*Q1D*Q1D;
+   const auto b = Reshape(b_.HostRead(), Q1D, D1D);
+   const auto g = Reshape(g_.HostRead(), Q1D, D1D);
+   const double *op = op_.HostRead();
+   const double *x = x_.HostRead();
+   double *y = y_.HostReadWrite();
+   double B[Q1D][D1D], G[Q1D][D1D];
+   for (int dx = 0; dx < D1D; ++dx)
+   {
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         B[qx][dx] = b(qx,dx);
+         G[qx][dx] = g(qx,dx);
+      }
+   }
+   vreal_t X[D1D][D1D][D1D], Y[D1D][D1D][D1D];
+   vreal_t O[3][Q1D][Q1D][Q1D], Gu[3][Q1D][Q1D][Q1D], DGu[Q1D][Q1D][Q1D];
+   for (int e = 0; e < NE; e += VS)
+   {
+      const int nl = (NE - e < VS) ? NE - e : VS;
+      internal::PASimdLoad(ND, nl, x + e*ND, &X[0][0][0]);
+      internal::PASimdLoad(3*NQ, nl, op + e*3*NQ, &O[0][0][0][0]);
+      internal::PASimdGrad3D(B, G, X, Gu);
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               DGu[qz][qy][qx] = (O[0][qz][qy][qx] * Gu[0][qz][qy][qx]) +
+                                 (O[1][qz][qy][qx] * Gu[1][qz][qy][qx]) +
+                                 (O[2][qz][qy][qx] * Gu[2][qz][qy][qx]);
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx) { Y[dz][dy][dx] = 0.0; }
+         }
+      }
+      internal::PASimdEvalT3D(B, DGu, Y);
+      internal::PASimdAddStore(ND, nl, &Y[0][0][0], y + e*ND);
+   }
+}
+
+// Dispatch the Backend::CPU_SIMD PA Convection Apply kernels. Returns false if
+// no kernel is available for the given sizes.
+static bool SimdPAConvectionApply(const int dim,
+                                  const int D1D,
+                                  const int Q1D,
+                                  const int NE,
+                                  const Array<double> &B,
+                                  const Array<double> &G,
+                                  const Vector &op,
+                                  const Vector &x,
+                                  Vector &y)
+{
+   const int id = (D1D << 4) | Q1D;
+   if (dim == 2)
+   {
+      switch (id)
+      {
+         case 0x22: SimdPAConvectionApply2D<2,2>(NE,B,G,op,x,y); return true;
+         case 0x23: SimdPAConvectionApply2D<2,3>(NE,B,G,op,x,y); return true;
+         case 0x33: SimdPAConvectionApply2D<3,3>(NE,B,G,op,x,y); return true;
+         case 0x34: SimdPAConvectionApply2D<3,4>(NE,B,G,op,x,y); return true;
+         case 0x44: SimdPAConvectionApply2D<4,4>(NE,B,G,op,x,y); return true;
+         case 0x45: SimdPAConvectionApply2D<4,5>(NE,B,G,op,x,y); return true;
+         case 0x55: SimdPAConvectionApply2D<5,5>(NE,B,G,op,x,y); return true;
+         case 0x56: SimdPAConvectionApply2D<5,6>(NE,B,G,op,x,y); return true;
+         case 0x66: SimdPAConvectionApply2D<6,6>(NE,B,G,op,x,y); return true;
+         case 0x67: SimdPAConvectionApply2D<6,7>(NE,B,G,op,x,y); return true;
+         case 0x77: SimdPAConvectionApply2D<7,7>(NE,B,G,op,x,y); return true;
+         case 0x78: SimdPAConvectionApply2D<7,8>(NE,B,G,op,x,y); return true;
+         case 0x88: SimdPAConvectionApply2D<8,8>(NE,B,G,op,x,y); return true;
+         case 0x89: SimdPAConvectionApply2D<8,9>(NE,B,G,op,x,y); return true;
+         case 0x99: SimdPAConvectionApply2D<9,9>(NE,B,G,op,x,y); return true;
+         default:   return false;
+      }
+   }
+   if (dim == 3)
+   {
+      switch (id)
+      {
+         case 0x22: SimdPAConvectionApply3D<2,2>(NE,B,G,op,x,y); return true;
+         case 0x23: SimdPAConvectionApply3D<2,3>(NE,B,G,op,x,y); return true;
+         case 0x33: SimdPAConvectionApply3D<3,3>(NE,B,G,op,x,y); return true;
+         case 0x34: SimdPAConvectionApply3D<3,4>(NE,B,G,op,x,y); return true;
+         case 0x44: SimdPAConvectionApply3D<4,4>(NE,B,G,op,x,y); return true;
+         case 0x45: SimdPAConvectionApply3D<4,5>(NE,B,G,op,x,y); return true;
+         case 0x55: SimdPAConvectionApply3D<5,5>(NE,B,G,op,x,y); return true;
+         case 0x56: SimdPAConvectionApply3D<5,6>(NE,B,G,op,x,y); return true;
+         case 0x66: SimdPAConvectionApply3D<6,6>(NE,B,G,op,x,y); return true;
+         case 0x67: SimdPAConvectionApply3D<6,7>(NE,B,G,op,x,y); return true;
+         case 0x77: SimdPAConvectionApply3D<7,7>(NE,B,G,op,x,y); return true;
+         case 0x78: SimdPAConvectionApply3D<7,8>(NE,B,G,op,x,y); return true;
+         case 0x88: SimdPAConvectionApply3D<8,8>(NE,B,G,op,x,y); return true;
+         case 0x89: SimdPAConvectionApply3D<8,9>(NE,B,G,op,x,y); return true;
+         default:   return false;
+      }
+   }
+   return false;
+}
+
 static void PAConvectionApply(const int dim,
                               const int D1D,
                               const int Q1D,
@@ -836,6 +1007,8 @@ static void PAConvectionApply(const int dim,
                               const Vector &x,
                               Vector &y)
 {
+   if (internal::DeviceCanUsePASimd() &&
+       SimdPAConvectionApply(dim,D1D,Q1D,NE,B,G,op,x,y)) { return; }
    if (dim == 2)
    {
       switch ((D1D << 4 ) | Q1D)
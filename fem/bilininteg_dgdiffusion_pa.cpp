@@ -0,0 +1,483 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
+#include "bilininteg.hpp"
+#include "gridfunc.hpp"
+#include "pa_dgface.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA DG Diffusion Integrator
+
+// The face action is y = alpha A x + beta A^t x + kappa J x, where
+//    A(u,v) = < {(Q grad(u)).n}, [v] >,   J(u,v) = < {h^{-1} Q} [u], [v] >,
+// and (alpha, beta) = (-1, sigma) for the action, (sigma, -1) for its
+// transpose. The quadrature data of each face point is the vector nh = adj(J)
+// Q^t n w / det(J) of the two elements, in reference coordinates, followed by
+// the penalty weight kappa {h^{-1} Q} w.
+
+// Compute the quadrature data of a face point from the Jacobians J1 and J2 of
+// the two elements and the normal nor, scaled by the face determinant. The
+// coefficient values c1 and c2 in the two elements are scalars if nc = 1 and
+// DIM x DIM matrices if nc = DIM*DIM.
+template<int DIM>
+MFEM_HOST_DEVICE inline
+void DGDiffusionQuadData(const double *J1, const double *J2,
+                         const double *nor, const bool interior,
+                         const double w, const int nc,
+                         const double *c1, const double *c2,
+                         const double kappa, double *qd)
+{
+   const double ws = interior ? 0.5*w : w;
+   double wq = 0.0;
+   for (int s = 0; s < 2; ++s)
+   {
+      if (s == 1 && !interior)
+      {
+         for (int r = 0; r < DIM; ++r) { qd[r + DIM] = 0.0; }
+         continue;
+      }
+      const double *J = (s == 0) ? J1 : J2;
+      const double *c = (s == 0) ? c1 : c2;
+      double A[DIM*DIM], ni[DIM];
+      kernels::CalcInverse<DIM>(J, A);
+      const double det = kernels::Det<DIM>(J);
+      // ni = Q^t n w, and adj(J) ni / det(J) = J^{-1} ni
+      for (int k = 0; k < DIM; ++k)
+      {
+         double v = c[0] * nor[k];
+         if (nc > 1)
+         {
+            v = 0.0;
+            for (int i = 0; i < DIM; ++i) { v += c[i + DIM*k] * nor[i]; }
+         }
+         ni[k] = ws * v;
+      }
+      for (int r = 0; r < DIM; ++r)
+      {
+         double nh = 0.0;
+         for (int k = 0; k < DIM; ++k) { nh += A[r + DIM*k] * ni[k]; }
+         qd[r + DIM*s] = nh;
+      }
+      for (int k = 0; k < DIM; ++k) { wq += ni[k] * nor[k] / det; }
+   }
+   qd[2*DIM] = kappa * wq;
+}
+
+// Compute the quadrature data of the faces on the device, with the element
+// Jacobians computed from the mesh nodes. The normals are given by the face
+// geometric factors fgeom, or computed from the Jacobians if fgeom is NULL.
+// The coefficient values have the layout (nc, NQ, 2, NF), or (nc) if the
+// coefficient is constant.
+template<int DIM>
+static void PADGDiffusionSetup(const PADGFaceMaps &maps,
+                               const FaceGeometricFactors *fgeom,
+                               const int nc, const Vector &coeff,
+                               const double kappa, Vector &qdata)
+{
+   const int NF = maps.nf;
+   const int NQ = maps.NQ;
+   const int Q1D = maps.Q1D;
+   const int ND1D = maps.ND1D;
+   const int NND = (DIM == 2) ? ND1D*ND1D : ND1D*ND1D*ND1D;
+   const bool const_c = coeff.Size() == nc;
+   const double *nb = maps.NB.Read();
+   const double *ng = maps.NG.Read();
+   const double *nbf = maps.NBf.Read();
+   const double *ngf = maps.NGf.Read();
+   const double *XN = maps.nodes.Read();
+   const double *W = maps.W.Read();
+   const double *DET = fgeom ? fgeom->detJ.Read() : NULL;
+   const double *NOR = fgeom ? fgeom->normal.Read() : NULL;
+   const double *C = coeff.Read();
+   auto E = Reshape(maps.elem.Read(), 2, NF);
+   auto L = Reshape(maps.loc.Read(), 2, NF);
+   auto P = Reshape(maps.perm.Read(), NQ, NF);
+   auto QD = Reshape(qdata.Write(), 2*DIM + 1, NQ, NF);
+   MFEM_FORALL(f, NF,
+   {
+      constexpr int MQ = (DIM == 2) ? MAX_Q1D : MAX_Q1D*MAX_Q1D;
+      const bool interior = E(1,f) >= 0;
+      double J1[DIM*DIM*MQ], J2[DIM*DIM*MQ];
+      internal::DGFaceJacobians<DIM>(ND1D, Q1D, L(0,f), nb, ng, nbf, ngf,
+                                     XN + DIM*NND*E(0,f), J1);
+      if (interior)
+      {
+         internal::DGFaceJacobians<DIM>(ND1D, Q1D, L(1,f), nb, ng, nbf, ngf,
+                                        XN + DIM*NND*E(1,f), J2);
+      }
+      for (int q = 0; q < NQ; ++q)
+      {
+         double nor[DIM];
+         if (NOR)
+         {
+            for (int k = 0; k < DIM; ++k)
+            {
+               nor[k] = DET[q + NQ*f] * NOR[q + NQ*(k + DIM*f)];
+            }
+         }
+         else
+         {
+            internal::DGFaceNormal<DIM>(J1 + DIM*DIM*q, L(0,f), nor);
+         }
+         const double *c1 = const_c ? C : C + nc*(q + NQ*2*f);
+         const double *c2 = const_c ? C : C + nc*(q + NQ*(2*f + 1));
+         DGDiffusionQuadData<DIM>(J1 + DIM*DIM*q, J2 + DIM*DIM*P(q,f), nor,
+                                  interior, W[q], nc, c1, c2, kappa,
+                                  &QD(0,q,f));
+      }
+   });
+}
+
+static void PADGDiffusionSetup(const PADGFaceMaps &maps,
+                               const FaceGeometricFactors *fgeom,
+                               const int nc, const Vector &coeff,
+                               const double kappa, Vector &qdata)
+{
+   if (maps.dim == 2)
+   {
+      return PADGDiffusionSetup<2>(maps, fgeom, nc, coeff, kappa, qdata);
+   }
+   if (maps.dim == 3)
+   {
+      return PADGDiffusionSetup<3>(maps, fgeom, nc, coeff, kappa, qdata);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// Add the diagonal of the face terms with the quadrature data qdata to the
+// element E-vector diag, see PADGFaceMaps::AddFaceDiagonal(). The diagonal
+// terms of A and A^t have the same value, so the diagonal is the sum of the
+// penalty term and of (alpha + beta) A.
+static void PADGDiffusionDiagonal(const PADGFaceMaps &maps,
+                                  const Vector &qdata, const double ab,
+                                  Vector &diag)
+{
+   const int DIM = maps.dim;
+   const int NF = maps.nf;
+   const int NQ = maps.NQ;
+   auto E = Reshape(maps.elem.Read(), 2, NF);
+   auto P = Reshape(maps.perm.Read(), NQ, NF);
+   auto QD = Reshape(qdata.Read(), 2*DIM + 1, NQ, NF);
+   Vector d((DIM + 1)*NQ*2*NF, Device::GetMemoryType());
+   auto D = Reshape(d.Write(), DIM + 1, NQ, 2, NF);
+   MFEM_FORALL(f, NF,
+   {
+      const bool interior = E(1,f) >= 0;
+      for (int q = 0; q < NQ; ++q)
+      {
+         const int q2 = P(q,f);
+         for (int r = 0; r < DIM; ++r)
+         {
+            D(r,q,0,f) = ab * QD(r,q,f);
+            D(r,q2,1,f) = -ab * QD(r + DIM,q,f);
+         }
+         D(DIM,q,0,f) = QD(2*DIM,q,f);
+         D(DIM,q2,1,f) = interior ? QD(2*DIM,q,f) : 0.0;
+      }
+   });
+   maps.AddFaceDiagonal(1, d, diag);
+}
+
+// Compute the face terms of the action on the element E-vector x, see
+// PADGFaceMaps::AddFaceTerms(). With MF, the quadrature data is computed from
+// the mesh nodes, using the constant coefficient coeff.
+template<int DIM, bool MF, int T_D1D = 0, int T_Q1D = 0>
+static void PADGDiffusionApplyFaces(const PADGFaceMaps &maps,
+                                    const Vector &pa_data,
+                                    const double coeff, const double kappa,
+                                    const double alpha, const double beta,
+                                    const Vector &x, Vector &z)
+{
+   const int D1D = T_D1D ? T_D1D : maps.D1D;
+   const int Q1D = T_Q1D ? T_Q1D : maps.Q1D;
+   MFEM_VERIFY(D1D <= MAX_D1D && Q1D <= MAX_Q1D, "");
+   const int NF = maps.nf;
+   const int NQ = maps.NQ;
+   const int NFD = (DIM == 2) ? D1D : D1D*D1D;
+   const int ND = NFD*D1D;
+   const int ND1D = maps.ND1D;
+   const int NND = (DIM == 2) ? ND1D*ND1D : ND1D*ND1D*ND1D;
+   const double *b = maps.B.Read();
+   const double *g = maps.G.Read();
+   const double *bf = maps.Bf.Read();
+   const double *gf = maps.Gf.Read();
+   const double *nb = MF ? maps.NB.Read() : NULL;
+   const double *ng = MF ? maps.NG.Read() : NULL;
+   const double *nbf = MF ? maps.NBf.Read() : NULL;
+   const double *ngf = MF ? maps.NGf.Read() : NULL;
+   const double *XN = MF ? maps.nodes.Read() : NULL;
+   const double *W = maps.W.Read();
+   const double *QD = MF ? NULL : pa_data.Read();
+   auto E = Reshape(maps.elem.Read(), 2, NF);
+   auto L = Reshape(maps.loc.Read(), 2, NF);
+   auto P = Reshape(maps.perm.Read(), NQ, NF);
+   const double *X = x.Read();
+   auto Z = Reshape(z.Write(), NFD, 2, 2, NF);
+   MFEM_FORALL(f, NF, // can be optimized with Q1D^(DIM-1) threads per face
+   {
+      constexpr int MD1 = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int MQ1 = T_Q1D ? T_Q1D : MAX_Q1D;
+      constexpr int MQ = (DIM == 2) ? MQ1 : MQ1*MQ1;
+      constexpr int NQD = 2*DIM + 1;
+      constexpr int MJ = MF ? DIM*DIM*MQ : 1;
+      const int e1 = E(0,f), e2 = E(1,f);
+      const bool interior = e2 >= 0;
+      double u1[MQ], u2[MQ], du1[DIM*MQ], du2[DIM*MQ];
+      double J1[MJ], J2[MJ];
+      internal::DGFaceEval<DIM,MD1,MQ1>(D1D, Q1D, L(0,f), b, g, bf, gf,
+                                        X + ND*e1, u1, du1);
+      if (interior)
+      {
+         internal::DGFaceEval<DIM,MD1,MQ1>(D1D, Q1D, L(1,f), b, g, bf, gf,
+                                           X + ND*e2, u2, du2);
+      }
+      if (MF)
+      {
+         internal::DGFaceJacobians<DIM>(ND1D, Q1D, L(0,f), nb, ng, nbf, ngf,
+                                        XN + DIM*NND*e1, J1);
+         if (interior)
+         {
+            internal::DGFaceJacobians<DIM>(ND1D, Q1D, L(1,f), nb, ng, nbf, ngf,
+                                           XN + DIM*NND*e2, J2);
+         }
+      }
+      for (int q = 0; q < NQ; ++q)
+      {
+         const int q2 = P(q,f);
+         double lqd[NQD];
+         const double *qd = lqd;
+         if (MF)
+         {
+            double nor[DIM];
+            internal::DGFaceNormal<DIM>(J1 + DIM*DIM*q, L(0,f), nor);
+            DGDiffusionQuadData<DIM>(J1 + DIM*DIM*q, J2 + DIM*DIM*q2, nor,
+                                     interior, W[q], 1, &coeff, &coeff,
+                                     kappa, lqd);
+         }
+         else
+         {
+            qd = QD + NQD*(q + NQ*f);
+         }
+         double dn = 0.0;
+         for (int r = 0; r < DIM; ++r) { dn += du1[r + DIM*q] * qd[r]; }
+         double jump = u1[q];
+         if (interior)
+         {
+            jump -= u2[q2];
+            for (int r = 0; r < DIM; ++r)
+            {
+               dn += du2[r + DIM*q2] * qd[r + DIM];
+            }
+         }
+         // Overwrite the values with the coefficients of the test functions
+         const double c = alpha*dn + qd[2*DIM]*jump;
+         u1[q] = c;
+         for (int r = 0; r < DIM; ++r) { du1[r + DIM*q] = beta*jump*qd[r]; }
+         if (interior)
+         {
+            u2[q2] = -c;
+            for (int r = 0; r < DIM; ++r)
+            {
+               du2[r + DIM*q2] = beta*jump*qd[r + DIM];
+            }
+         }
+      }
+      internal::DGFaceEvalT<DIM,MD1,MQ1>(D1D, Q1D, L(0,f), b, g, u1, du1,
+                                         &Z(0,0,0,f), &Z(0,1,0,f));
+      if (interior)
+      {
+         internal::DGFaceEvalT<DIM,MD1,MQ1>(D1D, Q1D, L(1,f), b, g, u2, du2,
+                                            &Z(0,0,1,f), &Z(0,1,1,f));
+      }
+   });
+}
+
+template<int DIM, bool MF>
+static void PADGDiffusionApply(const PADGFaceMaps &maps, const Vector &pa_data,
+                               const double coeff, const double kappa,
+                               const double alpha, const double beta,
+                               const Vector &x, Vector &z)
+{
+   switch ((maps.D1D << 4 ) | maps.Q1D)
+   {
+      case 0x22: return PADGDiffusionApplyFaces<DIM,MF,2,2>(
+                           maps, pa_data, coeff, kappa, alpha, beta, x, z);
+      case 0x33: return PADGDiffusionApplyFaces<DIM,MF,3,3>(
+                           maps, pa_data, coeff, kappa, alpha, beta, x, z);
+      case 0x44: return PADGDiffusionApplyFaces<DIM,MF,4,4>(
+                           maps, pa_data, coeff, kappa, alpha, beta, x, z);
+      case 0x55: return PADGDiffusionApplyFaces<DIM,MF,5,5>(
+                           maps, pa_data, coeff, kappa, alpha, beta, x, z);
+      case 0x66: return PADGDiffusionApplyFaces<DIM,MF,6,6>(
+                           maps, pa_data, coeff, kappa, alpha, beta, x, z);
+      default: return PADGDiffusionApplyFaces<DIM,MF>(
+                           maps, pa_data, coeff, kappa, alpha, beta, x, z);
+   }
+}
+
+static void PADGDiffusionApply(const PADGFaceMaps &maps, const bool mf,
+                               const Vector &pa_data,
+                               const double coeff, const double kappa,
+                               const double alpha, const double beta,
+                               const Vector &x, Vector &z)
+{
+   if (maps.dim == 2)
+   {
+      if (mf)
+      {
+         return PADGDiffusionApply<2,true>(maps, pa_data, coeff, kappa,
+                                           alpha, beta, x, z);
+      }
+      return PADGDiffusionApply<2,false>(maps, pa_data, coeff, kappa,
+                                         alpha, beta, x, z);
+   }
+   if (maps.dim == 3)
+   {
+      if (mf)
+      {
+         return PADGDiffusionApply<3,true>(maps, pa_data, coeff, kappa,
+                                           alpha, beta, x, z);
+      }
+      return PADGDiffusionApply<3,false>(maps, pa_data, coeff, kappa,
+                                         alpha, beta, x, z);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+const IntegrationRule &DGDiffusionIntegrator::GetFaceRule(
+   const FiniteElementSpace &fes) const
+{
+   if (IntRule) { return *IntRule; }
+   // Same rule as in AssembleFaceMatrix()
+   const Mesh *mesh = fes.GetMesh();
+   return IntRules.Get(mesh->GetFaceBaseGeometry(0),
+                       2*fes.GetFE(0)->GetOrder());
+}
+
+void DGDiffusionIntegrator::SetupPA(const FiniteElementSpace &fes,
+                                    FaceType type)
+{
+   const IntegrationRule &ir = GetFaceRule(fes);
+   maps.Setup(fes, type, ir);
+   const int dim = maps.dim;
+   const int nf = maps.nf;
+   const int NFD = (dim == 2) ? maps.D1D : maps.D1D*maps.D1D;
+   face_z.SetSize(NFD*2*2*nf, Device::GetMemoryType());
+   pa_data.SetSize((2*dim + 1)*maps.NQ*nf, Device::GetMemoryType());
+   if (nf == 0) { return; }
+   const FaceGeometricFactors *fgeom =
+      fes.GetMesh()->GetFaceGeometricFactors(
+         ir, FaceGeometricFactors::DETERMINANTS |
+         FaceGeometricFactors::NORMALS, type);
+   Vector coeff;
+   if (MQ) { maps.EvalCoefficient(fes, *MQ, coeff); }
+   else { maps.EvalCoefficient(fes, Q, coeff); }
+   maps.SetupNodes(fes);
+   PADGDiffusionSetup(maps, fgeom, MQ ? dim*dim : 1, coeff, kappa, pa_data);
+   maps.nodes.Destroy(); // the nodes are only used by the MF kernels
+}
+
+void DGDiffusionIntegrator::AssemblePAInteriorFaces(
+   const FiniteElementSpace &fes)
+{
+   SetupPA(fes, FaceType::Interior);
+}
+
+void DGDiffusionIntegrator::AssemblePABoundaryFaces(
+   const FiniteElementSpace &fes)
+{
+   SetupPA(fes, FaceType::Boundary);
+}
+
+void DGDiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (maps.nf == 0) { return; }
+   PADGDiffusionApply(maps, false, pa_data, 1.0, kappa, -1.0, sigma,
+                      x, face_z);
+   maps.AddFaceTerms(1, face_z, y);
+}
+
+void DGDiffusionIntegrator::AddMultTransposePA(const Vector &x,
+                                               Vector &y) const
+{
+   if (maps.nf == 0) { return; }
+   PADGDiffusionApply(maps, false, pa_data, 1.0, kappa, sigma, -1.0,
+                      x, face_z);
+   maps.AddFaceTerms(1, face_z, y);
+}
+
+void DGDiffusionIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (maps.nf == 0) { return; }
+   PADGDiffusionDiagonal(maps, pa_data, sigma - 1.0, diag);
+}
+
+void DGDiffusionIntegrator::SetupMF(const FiniteElementSpace &fes,
+                                    FaceType type)
+{
+   MFEM_VERIFY(MQ == NULL &&
+               (Q == NULL || dynamic_cast<ConstantCoefficient*>(Q)),
+               "Only constant scalar coefficients are supported with MF.");
+   mf_coeff = Q ? static_cast<ConstantCoefficient*>(Q)->constant : 1.0;
+   maps.Setup(fes, type, GetFaceRule(fes));
+   maps.SetupNodes(fes);
+   const int NFD = (maps.dim == 2) ? maps.D1D : maps.D1D*maps.D1D;
+   face_z.SetSize(NFD*2*2*maps.nf, Device::GetMemoryType());
+   pa_data.Destroy();
+}
+
+void DGDiffusionIntegrator::AssembleMFInteriorFaces(
+   const FiniteElementSpace &fes)
+{
+   SetupMF(fes, FaceType::Interior);
+}
+
+void DGDiffusionIntegrator::AssembleMFBoundaryFaces(
+   const FiniteElementSpace &fes)
+{
+   SetupMF(fes, FaceType::Boundary);
+}
+
+void DGDiffusionIntegrator::AddMultMF(const Vector &x, Vector &y) const
+{
+   if (maps.nf == 0) { return; }
+   PADGDiffusionApply(maps, true, pa_data, mf_coeff, kappa, -1.0, sigma,
+                      x, face_z);
+   maps.AddFaceTerms(1, face_z, y);
+}
+
+void DGDiffusionIntegrator::AddMultTransposeMF(const Vector &x,
+                                               Vector &y) const
+{
+   if (maps.nf == 0) { return; }
+   PADGDiffusionApply(maps, true, pa_data, mf_coeff, kappa, sigma, -1.0,
+                      x, face_z);
+   maps.AddFaceTerms(1, face_z, y);
+}
+
+void DGDiffusionIntegrator::AssembleDiagonalMF(Vector &diag)
+{
+   if (maps.nf == 0) { return; }
+   // The quadrature data is computed on the fly from the mesh nodes
+   const int NQD = 2*maps.dim + 1;
+   Vector coeff(1), qdata(NQD*maps.NQ*maps.nf, Device::GetMemoryType());
+   coeff = mf_coeff;
+   PADGDiffusionSetup(maps, NULL, 1, coeff, kappa, qdata);
+   PADGDiffusionDiagonal(maps, qdata, sigma - 1.0, diag);
+}
+
+} // namespace mfem
@@ -0,0 +1,559 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
+#include "bilininteg.hpp"
+#include "gridfunc.hpp"
+#include "pa_dgface.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA DG Elasticity Integrator
+
+// The face action is y = alpha_a A x + beta_a A^t x + J x, where
+//    A(u,v) = < {sigma(u).n}, [v] >,   J(u,v) = kappa < h^{-1} {lambda+2mu}
+// [u], [v] >, and (alpha_a, beta_a) = (-1, alpha) for the action, (alpha, -1)
+// for its transpose. The quadrature data of each face point is the normal nor,
+// then for each element adj(J) and the weights (lambda, mu) w / det(J), and
+// finally the penalty weight, as in AssembleFaceMatrix().
+template<int DIM> MFEM_HOST_DEVICE inline constexpr int DGElasticityNQD()
+{ return DIM + 2*(DIM*DIM + 2) + 1; }
+
+// Compute the quadrature data of a face point from the Jacobians J1 and J2 of
+// the two elements and the normal nor, scaled by the face determinant, with
+// the coefficient values lambda[s] and mu[s] in the two elements.
+template<int DIM>
+MFEM_HOST_DEVICE inline
+void DGElasticityQuadData(const double *J1, const double *J2,
+                          const double *nor, const bool interior,
+                          const double w, const double *lambda,
+                          const double *mu, const double kappa, double *qd)
+{
+   constexpr int S = DIM*DIM + 2;
+   for (int k = 0; k < DIM; ++k) { qd[k] = nor[k]; }
+   double wLM = 0.0;
+   for (int s = 0; s < 2; ++s)
+   {
+      double *adj = qd + DIM + S*s;
+      if (s == 1 && !interior)
+      {
+         for (int i = 0; i < S; ++i) { adj[i] = 0.0; }
+         continue;
+      }
+      const double *J = (s == 0) ? J1 : J2;
+      const double det = kernels::Det<DIM>(J);
+      kernels::CalcInverse<DIM>(J, adj);
+      for (int i = 0; i < DIM*DIM; ++i) { adj[i] *= det; }
+      const double ws = (interior ? 0.5*w : w) / det;
+      adj[DIM*DIM] = ws * lambda[s];
+      adj[DIM*DIM + 1] = ws * mu[s];
+      wLM += ws * (lambda[s] + 2.0*mu[s]);
+   }
+   double nn = 0.0;
+   for (int k = 0; k < DIM; ++k) { nn += nor[k] * nor[k]; }
+   qd[DIM + 2*S] = kappa * nn * wLM;
+}
+
+// Compute the quadrature data of the faces on the device, with the element
+// Jacobians computed from the mesh nodes. The normals are given by the face
+// geometric factors fgeom, or computed from the Jacobians if fgeom is NULL.
+// The coefficient values have the layout (NQ, 2, NF), or (1) if the
+// coefficient is constant.
+template<int DIM>
+static void PADGElasticitySetup(const PADGFaceMaps &maps,
+                                const FaceGeometricFactors *fgeom,
+                                const Vector &lambda, const Vector &mu,
+                                const double kappa, Vector &qdata)
+{
+   const int NF = maps.nf;
+   const int NQ = maps.NQ;
+   const int Q1D = maps.Q1D;
+   const int ND1D = maps.ND1D;
+   const int NND = (DIM == 2) ? ND1D*ND1D : ND1D*ND1D*ND1D;
+   const bool const_l = lambda.Size() == 1;
+   const bool const_m = mu.Size() == 1;
+   const double *nb = maps.NB.Read();
+   const double *ng = maps.NG.Read();
+   const double *nbf = maps.NBf.Read();
+   const double *ngf = maps.NGf.Read();
+   const double *XN = maps.nodes.Read();
+   const double *W = maps.W.Read();
+   const double *DET = fgeom ? fgeom->detJ.Read() : NULL;
+   const double *NOR = fgeom ? fgeom->normal.Read() : NULL;
+   const double *LC = lambda.Read();
+   const double *MC = mu.Read();
+   auto E = Reshape(maps.elem.Read(), 2, NF);
+   auto L = Reshape(maps.loc.Read(), 2, NF);
+   auto P = Reshape(maps.perm.Read(), NQ, NF);
+   auto QD = Reshape(qdata.Write(), DGElasticityNQD<DIM>(), NQ, NF);
+   MFEM_FORALL(f, NF,
+   {
+      constexpr int MQ = (DIM == 2) ? MAX_Q1D : MAX_Q1D*MAX_Q1D;
+      const bool interior = E(1,f) >= 0;
+      double J1[DIM*DIM*MQ], J2[DIM*DIM*MQ];
+      internal::DGFaceJacobians<DIM>(ND1D, Q1D, L(0,f), nb, ng, nbf, ngf,
+                                     XN + DIM*NND*E(0,f), J1);
+      if (interior)
+      {
+         internal::DGFaceJacobians<DIM>(ND1D, Q1D, L(1,f), nb, ng, nbf, ngf,
+                                        XN + DIM*NND*E(1,f), J2);
+      }
+      for (int q = 0; q < NQ; ++q)
+      {
+         double nor[DIM], l[2], m[2];
+         if (NOR)
+         {
+            for (int k = 0; k < DIM; ++k)
+            {
+               nor[k] = DET[q + NQ*f] * NOR[q + NQ*(k + DIM*f)];
+            }
+         }
+         else
+         {
+            internal::DGFaceNormal<DIM>(J1 + DIM*DIM*q, L(0,f), nor);
+         }
+         for (int s = 0; s < 2; ++s)
+         {
+            l[s] = const_l ? LC[0] : LC[q + NQ*(s + 2*f)];
+            m[s] = const_m ? MC[0] : MC[q + NQ*(s + 2*f)];
+         }
+         DGElasticityQuadData<DIM>(J1 + DIM*DIM*q, J2 + DIM*DIM*P(q,f), nor,
+                                   interior, W[q], l, m, kappa, &QD(0,q,f));
+      }
+   });
+}
+
+static void PADGElasticitySetup(const PADGFaceMaps &maps,
+                                const FaceGeometricFactors *fgeom,
+                                const Vector &lambda, const Vector &mu,
+                                const double kappa, Vector &qdata)
+{
+   if (maps.dim == 2)
+   {
+      return PADGElasticitySetup<2>(maps, fgeom, lambda, mu, kappa, qdata);
+   }
+   if (maps.dim == 3)
+   {
+      return PADGElasticitySetup<3>(maps, fgeom, lambda, mu, kappa, qdata);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// Add the diagonal of the face terms with the quadrature data qdata to the
+// element E-vector diag, see PADGFaceMaps::AddFaceDiagonal(). The diagonal
+// terms of A and A^t have the same value, so the diagonal is the sum of the
+// penalty term and of (alpha_a + beta_a) A. For the component c, the traction
+// of the basis function phi e_c is F_c = sum_r grad(phi)_r h_r with
+//    h_r = sum_k adj(J)_rk (wM nor_k + delta_kc (wL + wM) nor_c).
+template<int DIM>
+static void PADGElasticityDiagonal(const PADGFaceMaps &maps,
+                                   const Vector &qdata, const double ab,
+                                   Vector &diag)
+{
+   constexpr int S = DIM*DIM + 2;
+   const int NF = maps.nf;
+   const int NQ = maps.NQ;
+   auto E = Reshape(maps.elem.Read(), 2, NF);
+   auto P = Reshape(maps.perm.Read(), NQ, NF);
+   auto QD = Reshape(qdata.Read(), DGElasticityNQD<DIM>(), NQ, NF);
+   Vector d((DIM + 1)*NQ*DIM*2*NF, Device::GetMemoryType());
+   auto D = Reshape(d.Write(), DIM + 1, NQ, DIM, 2, NF);
+   MFEM_FORALL(f, NF,
+   {
+      const bool interior = E(1,f) >= 0;
+      for (int q = 0; q < NQ; ++q)
+      {
+         const int qs[2] = { q, P(q,f) };
+         const double *nor = &QD(0,q,f);
+         for (int s = 0; s < 2; ++s)
+         {
+            const double *adj = &QD(DIM + S*s,q,f);
+            const double wL = adj[DIM*DIM], wM = adj[DIM*DIM + 1];
+            const double sign = (s == 0) ? ab : -ab;
+            const bool side = (s == 0) || interior;
+            for (int c = 0; c < DIM; ++c)
+            {
+               for (int r = 0; r < DIM; ++r)
+               {
+                  double h = adj[r + DIM*c] * (wL + wM) * nor[c];
+                  for (int k = 0; k < DIM; ++k)
+                  {
+                     h += adj[r + DIM*k] * wM * nor[k];
+                  }
+                  D(r,qs[s],c,s,f) = sign * h;
+               }
+               D(DIM,qs[s],c,s,f) = side ? QD(DIM + 2*S,q,f) : 0.0;
+            }
+         }
+      }
+   });
+   maps.AddFaceDiagonal(DIM, d, diag);
+}
+
+static void PADGElasticityDiagonal(const PADGFaceMaps &maps,
+                                   const Vector &qdata, const double ab,
+                                   Vector &diag)
+{
+   if (maps.dim == 2)
+   {
+      return PADGElasticityDiagonal<2>(maps, qdata, ab, diag);
+   }
+   if (maps.dim == 3)
+   {
+      return PADGElasticityDiagonal<3>(maps, qdata, ab, diag);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// Compute the face terms of the action on the element E-vector x, see
+// PADGFaceMaps::AddFaceTerms(). With MF, the quadrature data is computed from
+// the mesh nodes, using the constant coefficients lambda and mu.
+template<int DIM, bool MF, int T_D1D = 0, int T_Q1D = 0>
+static void PADGElasticityApplyFaces(const PADGFaceMaps &maps,
+                                     const Vector &pa_data,
+                                     const double lambda, const double mu,
+                                     const double kappa,
+                                     const double alpha, const double beta,
+                                     const Vector &x, Vector &z)
+{
+   const int D1D = T_D1D ? T_D1D : maps.D1D;
+   const int Q1D = T_Q1D ? T_Q1D : maps.Q1D;
+   MFEM_VERIFY(D1D <= MAX_D1D && Q1D <= MAX_Q1D, "");
+   const int NF = maps.nf;
+   const int NQ = maps.NQ;
+   const int NFD = (DIM == 2) ? D1D : D1D*D1D;
+   const int ND = NFD*D1D;
+   const int ND1D = maps.ND1D;
+   const int NND = (DIM == 2) ? ND1D*ND1D : ND1D*ND1D*ND1D;
+   const double *b = maps.B.Read();
+   const double *g = maps.G.Read();
+   const double *bf = maps.Bf.Read();
+   const double *gf = maps.Gf.Read();
+   const double *nb = MF ? maps.NB.Read() : NULL;
+   const double *ng = MF ? maps.NG.Read() : NULL;
+   const double *nbf = MF ? maps.NBf.Read() : NULL;
+   const double *ngf = MF ? maps.NGf.Read() : NULL;
+   const double *XN = MF ? maps.nodes.Read() : NULL;
+   const double *W = maps.W.Read();
+   const double *QD = MF ? NULL : pa_data.Read();
+   auto E = Reshape(maps.elem.Read(), 2, NF);
+   auto L = Reshape(maps.loc.Read(), 2, NF);
+   auto P = Reshape(maps.perm.Read(), NQ, NF);
+   const double *X = x.Read();
+   auto Z = Reshape(z.Write(), NFD, 2, DIM, 2, NF);
+   MFEM_FORALL(f, NF, // can be optimized with Q1D^(DIM-1) threads per face
+   {
+      constexpr int MD1 = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int MQ1 = T_Q1D ? T_Q1D : MAX_Q1D;
+      constexpr int MQ = (DIM == 2) ? MQ1 : MQ1*MQ1;
+      constexpr int NQD = DGElasticityNQD<DIM>();
+      constexpr int S = DIM*DIM + 2;
+      constexpr int MJ = MF ? DIM*DIM*MQ : 1;
+      const int e[2] = { E(0,f), E(1,f) };
+      const int ns = (e[1] >= 0) ? 2 : 1;
+      double u[2][DIM][MQ], du[2][DIM][DIM*MQ];
+      double J[2][MJ];
+      for (int s = 0; s < ns; ++s)
+      {
+         for (int c = 0; c < DIM; ++c)
+         {
+            internal::DGFaceEval<DIM,MD1,MQ1>(D1D, Q1D, L(s,f), b, g, bf, gf,
+                                              X + ND*(c + DIM*e[s]),
+                                              u[s][c], du[s][c]);
+         }
+         if (MF)
+         {
+            internal::DGFaceJacobians<DIM>(ND1D, Q1D, L(s,f), nb, ng, nbf,
+                                           ngf, XN + DIM*NND*e[s], J[s]);
+         }
+      }
+      for (int q = 0; q < NQ; ++q)
+      {
+         const int qs[2] = { q, P(q,f) };
+         double lqd[NQD];
+         const double *qd = lqd;
+         if (MF)
+         {
+            double nor[DIM];
+            const double l[2] = { lambda, lambda }, m[2] = { mu, mu };
+            internal::DGFaceNormal<DIM>(J[0] + DIM*DIM*q, L(0,f), nor);
+            DGElasticityQuadData<DIM>(J[0] + DIM*DIM*q, J[1] + DIM*DIM*qs[1],
+                                      nor, ns == 2, W[q], l, m, kappa, lqd);
+         }
+         else
+         {
+            qd = QD + NQD*(q + NQ*f);
+         }
+         const double *nor = qd;
+         double F[DIM], jump[DIM];
+         for (int i = 0; i < DIM; ++i)
+         {
+            F[i] = 0.0;
+            jump[i] = u[0][i][q] - ((ns == 2) ? u[1][i][qs[1]] : 0.0);
+         }
+         // Traction: F = sum_s (tr(P) wL + (P + P^t) wM) nor, P = G adj(J)
+         for (int s = 0; s < ns; ++s)
+         {
+            const double *adj = qd + DIM + S*s;
+            const double wL = adj[DIM*DIM], wM = adj[DIM*DIM + 1];
+            double Pm[DIM][DIM], trP = 0.0;
+            for (int i = 0; i < DIM; ++i)
+            {
+               for (int k = 0; k < DIM; ++k)
+               {
+                  double p = 0.0;
+                  for (int r = 0; r < DIM; ++r)
+                  {
+                     p += du[s][i][r + DIM*qs[s]] * adj[r + DIM*k];
+                  }
+                  Pm[i][k] = p;
+               }
+               trP += Pm[i][i];
+            }
+            for (int i = 0; i < DIM; ++i)
+            {
+               double t = trP * wL * nor[i];
+               for (int k = 0; k < DIM; ++k)
+               {
+                  t += wM * (Pm[i][k] + Pm[k][i]) * nor[k];
+               }
+               F[i] += t;
+            }
+         }
+         // Overwrite the values with the coefficients of the test functions
+         double nj = 0.0;
+         for (int k = 0; k < DIM; ++k) { nj += nor[k] * jump[k]; }
+         for (int s = 0; s < ns; ++s)
+         {
+            const double *adj = qd + DIM + S*s;
+            const double wL = adj[DIM*DIM], wM = adj[DIM*DIM + 1];
+            const double sign = (s == 0) ? 1.0 : -1.0;
+            for (int i = 0; i < DIM; ++i)
+            {
+               u[s][i][qs[s]] = sign * (alpha*F[i] + qd[DIM + 2*S]*jump[i]);
+               // C = wL (nor.jump) I + wM (jump nor^t + nor jump^t)
+               double C[DIM];
+               for (int k = 0; k < DIM; ++k)
+               {
+                  C[k] = wM * (jump[i]*nor[k] + nor[i]*jump[k]);
+               }
+               C[i] += wL * nj;
+               for (int r = 0; r < DIM; ++r)
+               {
+                  double h = 0.0;
+                  for (int k = 0; k < DIM; ++k) { h += C[k] * adj[r + DIM*k]; }
+                  du[s][i][r + DIM*qs[s]] = beta * h;
+               }
+            }
+         }
+      }
+      for (int s = 0; s < ns; ++s)
+      {
+         for (int c = 0; c < DIM; ++c)
+         {
+            internal::DGFaceEvalT<DIM,MD1,MQ1>(D1D, Q1D, L(s,f), b, g,
+                                               u[s][c], du[s][c],
+                                               &Z(0,0,c,s,f), &Z(0,1,c,s,f));
+         }
+      }
+   });
+}
+
+template<int DIM, bool MF>
+static void PADGElasticityApply(const PADGFaceMaps &maps,
+                                const Vector &pa_data,
+                                const double lambda, const double mu,
+                                const double kappa,
+                                const double alpha, const double beta,
+                                const Vector &x, Vector &z)
+{
+   switch ((maps.D1D << 4 ) | maps.Q1D)
+   {
+      case 0x22: return PADGElasticityApplyFaces<DIM,MF,2,2>(
+                           maps, pa_data, lambda, mu, kappa, alpha, beta, x, z);
+      case 0x33: return PADGElasticityApplyFaces<DIM,MF,3,3>(
+                           maps, pa_data, lambda, mu, kappa, alpha, beta, x, z);
+      case 0x44: return PADGElasticityApplyFaces<DIM,MF,4,4>(
+                           maps, pa_data, lambda, mu, kappa, alpha, beta, x, z);
+      case 0x55: return PADGElasticityApplyFaces<DIM,MF,5,5>(
+                           maps, pa_data, lambda, mu, kappa, alpha, beta, x, z);
+      default: return PADGElasticityApplyFaces<DIM,MF>(
+                           maps, pa_data, lambda, mu, kappa, alpha, beta, x, z);
+   }
+}
+
+static void PADGElasticityApply(const PADGFaceMaps &maps, const bool mf,
+                                const Vector &pa_data,
+                                const double lambda, const double mu,
+                                const double kappa,
+                                const double alpha, const double beta,
+                                const Vector &x, Vector &z)
+{
+   if (maps.dim == 2)
+   {
+      if (mf)
+      {
+         return PADGElasticityApply<2,true>(maps, pa_data, lambda, mu, kappa,
+                                            alpha, beta, x, z);
+      }
+      return PADGElasticityApply<2,false>(maps, pa_data, lambda, mu, kappa,
+                                          alpha, beta, x, z);
+   }
+   if (maps.dim == 3)
+   {
+      if (mf)
+      {
+         return PADGElasticityApply<3,true>(maps, pa_data, lambda, mu, kappa,
+                                            alpha, beta, x, z);
+      }
+      return PADGElasticityApply<3,false>(maps, pa_data, lambda, mu, kappa,
+                                          alpha, beta, x, z);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+const IntegrationRule &DGElasticityIntegrator::GetFaceRule(
+   const FiniteElementSpace &fes) const
+{
+   if (IntRule) { return *IntRule; }
+   // Same rule as in AssembleFaceMatrix()
+   const Mesh *mesh = fes.GetMesh();
+   return IntRules.Get(mesh->GetFaceBaseGeometry(0),
+                       2*fes.GetFE(0)->GetOrder());
+}
+
+void DGElasticityIntegrator::SetupPA(const FiniteElementSpace &fes,
+                                     FaceType type)
+{
+   const IntegrationRule &ir = GetFaceRule(fes);
+   maps.Setup(fes, type, ir);
+   const int dim = maps.dim;
+   MFEM_VERIFY(fes.GetVDim() == dim, "Vector FE space of dimension "
+               << dim << " is required.");
+   const int nf = maps.nf;
+   const int NQD = dim + 2*(dim*dim + 2) + 1;
+   const int NFD = (dim == 2) ? maps.D1D : maps.D1D*maps.D1D;
+   face_z.SetSize(NFD*2*dim*2*nf, Device::GetMemoryType());
+   pa_data.SetSize(NQD*maps.NQ*nf, Device::GetMemoryType());
+   if (nf == 0) { return; }
+   const FaceGeometricFactors *fgeom =
+      fes.GetMesh()->GetFaceGeometricFactors(
+         ir, FaceGeometricFactors::DETERMINANTS |
+         FaceGeometricFactors::NORMALS, type);
+   Vector l_coeff, m_coeff;
+   maps.EvalCoefficient(fes, lambda, l_coeff);
+   maps.EvalCoefficient(fes, mu, m_coeff);
+   maps.SetupNodes(fes);
+   PADGElasticitySetup(maps, fgeom, l_coeff, m_coeff, kappa, pa_data);
+   maps.nodes.Destroy(); // the nodes are only used by the MF kernels
+}
+
+void DGElasticityIntegrator::AssemblePAInteriorFaces(
+   const FiniteElementSpace &fes)
+{
+   SetupPA(fes, FaceType::Interior);
+}
+
+void DGElasticityIntegrator::AssemblePABoundaryFaces(
+   const FiniteElementSpace &fes)
+{
+   SetupPA(fes, FaceType::Boundary);
+}
+
+void DGElasticityIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (maps.nf == 0) { return; }
+   PADGElasticityApply(maps, false, pa_data, 1.0, 1.0, kappa, -1.0, alpha,
+                       x, face_z);
+   maps.AddFaceTerms(maps.dim, face_z, y);
+}
+
+void DGElasticityIntegrator::AddMultTransposePA(const Vector &x,
+                                                Vector &y) const
+{
+   if (maps.nf == 0) { return; }
+   PADGElasticityApply(maps, false, pa_data, 1.0, 1.0, kappa, alpha, -1.0,
+                       x, face_z);
+   maps.AddFaceTerms(maps.dim, face_z, y);
+}
+
+void DGElasticityIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (maps.nf == 0) { return; }
+   PADGElasticityDiagonal(maps, pa_data, alpha - 1.0, diag);
+}
+
+void DGElasticityIntegrator::SetupMF(const FiniteElementSpace &fes,
+                                     FaceType type)
+{
+   ConstantCoefficient *c_lambda = dynamic_cast<ConstantCoefficient*>(lambda);
+   ConstantCoefficient *c_mu = dynamic_cast<ConstantCoefficient*>(mu);
+   MFEM_VERIFY((lambda == NULL || c_lambda) && (mu == NULL || c_mu),
+               "Only constant coefficients are supported with MF.");
+   mf_lambda = c_lambda ? c_lambda->constant : 1.0;
+   mf_mu = c_mu ? c_mu->constant : 1.0;
+   maps.Setup(fes, type, GetFaceRule(fes));
+   maps.SetupNodes(fes);
+   MFEM_VERIFY(fes.GetVDim() == maps.dim, "Vector FE space of dimension "
+               << maps.dim << " is required.");
+   const int NFD = (maps.dim == 2) ? maps.D1D : maps.D1D*maps.D1D;
+   face_z.SetSize(NFD*2*maps.dim*2*maps.nf, Device::GetMemoryType());
+   pa_data.Destroy();
+}
+
+void DGElasticityIntegrator::AssembleMFInteriorFaces(
+   const FiniteElementSpace &fes)
+{
+   SetupMF(fes, FaceType::Interior);
+}
+
+void DGElasticityIntegrator::AssembleMFBoundaryFaces(
+   const FiniteElementSpace &fes)
+{
+   SetupMF(fes, FaceType::Boundary);
+}
+
+void DGElasticityIntegrator::AddMultMF(const Vector &x, Vector &y) const
+{
+   if (maps.nf == 0) { return; }
+   PADGElasticityApply(maps, true, pa_data, mf_lambda, mf_mu, kappa,
+                       -1.0, alpha, x, face_z);
+   maps.AddFaceTerms(maps.dim, face_z, y);
+}
+
+void DGElasticityIntegrator::AddMultTransposeMF(const Vector &x,
+                                                Vector &y) const
+{
+   if (maps.nf == 0) { return; }
+   PADGElasticityApply(maps, true, pa_data, mf_lambda, mf_mu, kappa,
+                       alpha, -1.0, x, face_z);
+   maps.AddFaceTerms(maps.dim, face_z, y);
+}
+
+void DGElasticityIntegrator::AssembleDiagonalMF(Vector &diag)
+{
+   if (maps.nf == 0) { return; }
+   // The quadrature data is computed on the fly from the mesh nodes
+   const int dim = maps.dim;
+   const int NQD = dim + 2*(dim*dim + 2) + 1;
+   Vector l_coeff(1), m_coeff(1);
+   Vector qdata(NQD*maps.NQ*maps.nf, Device::GetMemoryType());
+   l_coeff = mf_lambda;
+   m_coeff = mf_mu;
+   PADGElasticitySetup(maps, NULL, l_coeff, m_coeff, kappa, qdata);
+   PADGElasticityDiagonal(maps, qdata, alpha - 1.0, diag);
+}
+
+} // namespace mfem
@@ -0,0 +1,354 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../general/forall.hpp"
+#include "bilininteg.hpp"
+#include "gridfunc.hpp"
+#include "pa_dgface.hpp"
+#include "restriction.hpp"
+#ifdef MFEM_USE_MPI
+#include "pfespace.hpp"
+#endif
+
+using namespace std;
+
+namespace mfem
+{
+
+// Evaluate the 1D basis of a tensor element at the points of ir1d and at the
+// end points 0 and 1, with the layouts of PADGFaceMaps.
+static void DGFaceBasis1D(const FiniteElement &fe, const IntegrationRule &ir1d,
+                          Array<double> &B, Array<double> &G,
+                          Array<double> &Bf, Array<double> &Gf)
+{
+   const TensorBasisElement *tfe = dynamic_cast<const TensorBasisElement*>(&fe);
+   MFEM_VERIFY(tfe != NULL, "Tensor-product elements are required.");
+   const Poly_1D::Basis &basis1d = tfe->GetBasis1D();
+   const int D1D = fe.GetOrder() + 1;
+   const int Q1D = ir1d.GetNPoints();
+   Vector u(D1D), d(D1D);
+   B.SetSize(Q1D*D1D);
+   G.SetSize(Q1D*D1D);
+   for (int q = 0; q < Q1D; ++q)
+   {
+      basis1d.Eval(ir1d.IntPoint(q).x, u, d);
+      for (int i = 0; i < D1D; ++i)
+      {
+         B[q + Q1D*i] = u(i);
+         G[q + Q1D*i] = d(i);
+      }
+   }
+   Bf.SetSize(2*D1D);
+   Gf.SetSize(2*D1D);
+   for (int side = 0; side < 2; ++side)
+   {
+      basis1d.Eval(side, u, d);
+      for (int i = 0; i < D1D; ++i)
+      {
+         Bf[i + D1D*side] = u(i);
+         Gf[i + D1D*side] = d(i);
+      }
+   }
+}
+
+// Return the local face 2*dir + side, see PADGFaceMaps, of the face face_id of
+// a quadrilateral or a hexahedron, see GetFaceDofs().
+static int DGFaceLocal(const int dim, const int face_id)
+{
+   static const int loc2d[4] = { 2, 1, 3, 0 };
+   static const int loc3d[6] = { 4, 2, 1, 3, 0, 5 };
+   return (dim == 2) ? loc2d[face_id] : loc3d[face_id];
+}
+
+void PADGFaceMaps::Setup(const FiniteElementSpace &fes, FaceType type,
+                         const IntegrationRule &ir)
+{
+   Mesh *mesh = fes.GetMesh();
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   nf = fes.GetNFbyType(type);
+   MFEM_VERIFY(dim == 2 || dim == 3, "Only 2D and 3D meshes are supported.");
+   MFEM_VERIFY(fes.IsDGSpace(), "A DG space is required.");
+#ifdef MFEM_USE_MPI
+   // The shared faces are not part of the face restrictions
+   MFEM_VERIFY(dynamic_cast<const ParFiniteElementSpace*>(&fes) == NULL,
+               "Parallel spaces are not yet supported with DG face partial "
+               "assembly.");
+#endif
+   MFEM_VERIFY(mesh->Conforming(), "Non-conforming meshes not yet supported "
+               "with DG face partial assembly.");
+   MFEM_VERIFY(mesh->GetNumGeometries(dim) == 1 &&
+               (mesh->GetElementBaseGeometry(0) == Geometry::SQUARE ||
+                mesh->GetElementBaseGeometry(0) == Geometry::CUBE),
+               "Only quadrilateral and hexahedral meshes are supported.");
+   D1D = fes.GetFE(0)->GetOrder() + 1;
+   NQ = ir.GetNPoints();
+   Q1D = (dim == 2) ? NQ : (int) std::floor(std::sqrt((double) NQ) + 0.5);
+   MFEM_VERIFY(((dim == 2) ? Q1D : Q1D*Q1D) == NQ,
+               "The face IntegrationRule is not a tensor product.");
+   MFEM_VERIFY(D1D <= MAX_D1D && Q1D <= MAX_Q1D, "Orders higher than "
+               << MAX_D1D-1 << " are not supported!");
+   const IntegrationRule &ir1d = IntRules.Get(Geometry::SEGMENT, 2*Q1D - 1);
+   MFEM_VERIFY(ir1d.GetNPoints() == Q1D, "Unexpected 1D IntegrationRule.");
+   DGFaceBasis1D(*fes.GetFE(0), ir1d, B, G, Bf, Gf);
+   // The face points are numbered lexicographically, as in the face
+   // restrictions and in FaceGeometricFactors
+   W.SetSize(NQ);
+   for (int q = 0; q < NQ; ++q)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      const IntegrationPoint &ipa = ir1d.IntPoint(q % Q1D);
+      const IntegrationPoint &ipb = ir1d.IntPoint(q / Q1D);
+      MFEM_VERIFY(std::abs(ip.x - ipa.x) < 1e-12 &&
+                  (dim == 2 || std::abs(ip.y - ipb.x) < 1e-12),
+                  "The face IntegrationRule is not a tensor product of the 1D "
+                  "Gauss-Legendre rule.");
+      W[q] = (dim == 2) ? ipa.weight : ipa.weight*ipb.weight;
+   }
+
+   elem.SetSize(2*nf);
+   loc.SetSize(2*nf);
+   perm.SetSize(NQ*nf);
+   elem_face.SetSize(2*dim*ne);
+   elem_face = -1;
+   int f_ind = 0;
+   for (int f = 0; f < mesh->GetNumFaces(); ++f)
+   {
+      int e1, e2, inf1, inf2;
+      mesh->GetFaceElements(f, &e1, &e2);
+      mesh->GetFaceInfos(f, &inf1, &inf2);
+      if (!((type==FaceType::Interior && (e2>=0 || (e2<0 && inf2>=0))) ||
+            (type==FaceType::Boundary && e2<0 && inf2<0)))
+      {
+         continue;
+      }
+      MFEM_VERIFY(type == FaceType::Boundary || e2 >= 0,
+                  "Shared faces are not supported yet.");
+      elem[2*f_ind] = e1;
+      elem[2*f_ind+1] = e2;
+      loc[2*f_ind] = DGFaceLocal(dim, inf1/64);
+      loc[2*f_ind+1] = (e2 >= 0) ? DGFaceLocal(dim, inf2/64) : -1;
+      for (int q = 0; q < NQ; ++q)
+      {
+         perm[q + NQ*f_ind] = (e2 >= 0) ?
+                              PermuteFaceL2(dim, inf1/64, inf2/64, inf2%64,
+                                            Q1D, q) : q;
+      }
+      for (int s = 0; s < 2; ++s)
+      {
+         const int e = elem[2*f_ind+s];
+         if (e < 0) { continue; }
+         int &ef = elem_face[loc[2*f_ind+s] + 2*dim*e];
+         MFEM_VERIFY(ef < 0, "Element face visited twice.");
+         ef = 2*f_ind + s;
+      }
+      f_ind++;
+   }
+   MFEM_VERIFY(f_ind == nf, "Incorrect number of faces.");
+}
+
+void PADGFaceMaps::SetupNodes(const FiniteElementSpace &fes)
+{
+   Mesh *mesh = fes.GetMesh();
+   mesh->EnsureNodes();
+   const GridFunction *mesh_nodes = mesh->GetNodes();
+   const FiniteElementSpace *nfes = mesh_nodes->FESpace();
+   MFEM_VERIFY(nfes->GetVDim() == dim, "Surface meshes are not supported.");
+   ND1D = nfes->GetFE(0)->GetOrder() + 1;
+   MFEM_VERIFY(ND1D <= MAX_D1D, "Mesh order is too high.");
+   const IntegrationRule &ir1d = IntRules.Get(Geometry::SEGMENT, 2*Q1D - 1);
+   DGFaceBasis1D(*nfes->GetFE(0), ir1d, NB, NG, NBf, NGf);
+   const Operator *R =
+      nfes->GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+   nodes.SetSize(R->Height(), Device::GetMemoryType());
+   R->Mult(*mesh_nodes, nodes);
+}
+
+// Return in ip the point q, numbered lexicographically, of the local face loc
+// of the reference element.
+static void DGFacePoint(const int dim, const int loc, const int q,
+                        const IntegrationRule &ir1d, IntegrationPoint &ip)
+{
+   int dir, ta, tb;
+   internal::DGFaceDirections(dim, loc, dir, ta, tb);
+   const int Q1D = ir1d.GetNPoints();
+   double x[3];
+   x[dir] = loc % 2;
+   x[ta] = ir1d.IntPoint(q % Q1D).x;
+   if (dim == 3) { x[tb] = ir1d.IntPoint(q / Q1D).x; }
+   ip.Set(x, dim);
+}
+
+void PADGFaceMaps::EvalCoefficient(const FiniteElementSpace &fes,
+                                   Coefficient *Q, Vector &C) const
+{
+   ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+   if (Q == NULL || cQ)
+   {
+      C.SetSize(1, Device::GetMemoryType());
+      C = cQ ? cQ->constant : 1.0;
+      return;
+   }
+   const IntegrationRule &ir1d = IntRules.Get(Geometry::SEGMENT, 2*Q1D - 1);
+   C.SetSize(NQ*2*nf, Device::GetMemoryType());
+   auto c = Reshape(C.HostWrite(), NQ, 2, nf);
+   IntegrationPoint ip;
+   for (int f = 0; f < nf; ++f)
+   {
+      for (int s = 0; s < 2; ++s)
+      {
+         const int e = elem[2*f+s];
+         ElementTransformation *T = (e >= 0) ?
+                                    fes.GetElementTransformation(e) : NULL;
+         for (int q = 0; q < NQ; ++q)
+         {
+            if (!T) { c(q,s,f) = 0.0; continue; }
+            const int qe = (s == 0) ? q : perm[q + NQ*f];
+            DGFacePoint(dim, loc[2*f+s], qe, ir1d, ip);
+            T->SetIntPoint(&ip);
+            c(q,s,f) = Q->Eval(*T, ip);
+         }
+      }
+   }
+}
+
+void PADGFaceMaps::EvalCoefficient(const FiniteElementSpace &fes,
+                                   MatrixCoefficient &MQ, Vector &C) const
+{
+   const IntegrationRule &ir1d = IntRules.Get(Geometry::SEGMENT, 2*Q1D - 1);
+   C.SetSize(dim*dim*NQ*2*nf, Device::GetMemoryType());
+   auto c = Reshape(C.HostWrite(), dim*dim, NQ, 2, nf);
+   IntegrationPoint ip;
+   DenseMatrix M(dim);
+   for (int f = 0; f < nf; ++f)
+   {
+      for (int s = 0; s < 2; ++s)
+      {
+         const int e = elem[2*f+s];
+         ElementTransformation *T = (e >= 0) ?
+                                    fes.GetElementTransformation(e) : NULL;
+         for (int q = 0; q < NQ; ++q)
+         {
+            if (T)
+            {
+               const int qe = (s == 0) ? q : perm[q + NQ*f];
+               DGFacePoint(dim, loc[2*f+s], qe, ir1d, ip);
+               T->SetIntPoint(&ip);
+               MQ.Eval(M, *T, ip);
+            }
+            else { M = 0.0; }
+            for (int i = 0; i < dim*dim; ++i) { c(i,q,s,f) = M.GetData()[i]; }
+         }
+      }
+   }
+}
+
+void PADGFaceMaps::AddFaceTerms(const int vdim, const Vector &z,
+                                Vector &y) const
+{
+   const int DIM = dim;
+   const int d1d = D1D;
+   const int NFD = (DIM == 2) ? d1d : d1d*d1d;
+   const int ND = NFD*d1d;
+   auto EF = Reshape(elem_face.Read(), 2*DIM, ne);
+   auto bf = Reshape(Bf.Read(), d1d, 2);
+   auto gf = Reshape(Gf.Read(), d1d, 2);
+   auto Z = Reshape(z.Read(), NFD, 2, vdim, 2, nf);
+   auto Y = Reshape(y.ReadWrite(), ND, vdim, ne);
+   MFEM_FORALL(e, ne,
+   {
+      const int s[3] = { 1, d1d, d1d*d1d };
+      for (int k = 0; k < 2*DIM; ++k)
+      {
+         const int id = EF(k,e);
+         if (id < 0) { continue; }
+         int dir, ta, tb;
+         internal::DGFaceDirections(DIM, k, dir, ta, tb);
+         const int side = k % 2;
+         for (int c = 0; c < vdim; ++c)
+         {
+            for (int t = 0; t < NFD; ++t)
+            {
+               const double zv = Z(t,0,c,id%2,id/2);
+               const double zn = Z(t,1,c,id%2,id/2);
+               const int a = t % d1d, b = t / d1d;
+               const int o = a*s[ta] + ((DIM == 3) ? b*s[tb] : 0);
+               for (int i = 0; i < d1d; ++i)
+               {
+                  Y(o + i*s[dir],c,e) += bf(i,side)*zv + gf(i,side)*zn;
+               }
+            }
+         }
+      }
+   });
+}
+
+void PADGFaceMaps::AddFaceDiagonal(const int vdim, const Vector &d,
+                                   Vector &diag) const
+{
+   const int DIM = dim;
+   const int d1d = D1D;
+   const int q1d = Q1D;
+   const int nq = NQ;
+   const int NFD = (DIM == 2) ? d1d : d1d*d1d;
+   const int ND = NFD*d1d;
+   auto EF = Reshape(elem_face.Read(), 2*DIM, ne);
+   auto b = Reshape(B.Read(), q1d, d1d);
+   auto g = Reshape(G.Read(), q1d, d1d);
+   auto bf = Reshape(Bf.Read(), d1d, 2);
+   auto gf = Reshape(Gf.Read(), d1d, 2);
+   auto D = Reshape(d.Read(), DIM + 1, nq, vdim, 2, nf);
+   auto Y = Reshape(diag.ReadWrite(), ND, vdim, ne);
+   MFEM_FORALL(e, ne,
+   {
+      const int s[3] = { 1, d1d, d1d*d1d };
+      for (int k = 0; k < 2*DIM; ++k)
+      {
+         const int id = EF(k,e);
+         if (id < 0) { continue; }
+         int dir, ta, tb;
+         internal::DGFaceDirections(DIM, k, dir, ta, tb);
+         const int side = k % 2;
+         for (int c = 0; c < vdim; ++c)
+         {
+            for (int t = 0; t < NFD; ++t)
+            {
+               // Sums over the face points of the products of the tangential
+               // factors of phi and of its gradient
+               const int ia = t % d1d, ib = t / d1d;
+               double s0 = 0.0, s1 = 0.0, s2 = 0.0;
+               for (int q = 0; q < nq; ++q)
+               {
+                  const int qa = q % q1d, qb = q / q1d;
+                  const double ba = b(qa,ia), ga = g(qa,ia);
+                  const double bb = (DIM == 3) ? b(qb,ib) : 1.0;
+                  const double bab = ba*ba*bb*bb;
+                  s0 += D(DIM,q,c,id%2,id/2) * bab;
+                  s1 += D(dir,q,c,id%2,id/2) * bab;
+                  s2 += D(ta,q,c,id%2,id/2) * ba*ga*bb*bb;
+                  if (DIM == 3)
+                  {
+                     s2 += D(tb,q,c,id%2,id/2) * ba*ba*bb*g(qb,ib);
+                  }
+               }
+               const int o = ia*s[ta] + ((DIM == 3) ? ib*s[tb] : 0);
+               for (int i = 0; i < d1d; ++i)
+               {
+                  const double bi = bf(i,side), gi = gf(i,side);
+                  Y(o + i*s[dir],c,e) += bi*bi*(s0 + s2) + bi*gi*s1;
+               }
+            }
+         }
+      }
+   });
+}
+
+} // namespace mfem
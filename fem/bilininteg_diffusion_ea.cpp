@@ -247,7 +247,19 @@ void DiffusionIntegrator::AssembleEA(const FiniteElementSpace &fes,
                                      const bool add)
 {
    AssemblePA(fes);
+   MFEM_VERIFY(maps->mode == DofToQuad::TENSOR,
+               "Element assembly requires tensor product elements");
    const int ne = fes.GetMesh()->GetNE();
+   if (pa_affine)
+   {
+      // The element assembly kernels use the data at all quadrature points
+      const int symmDims = (dim * (dim + 1)) / 2;
+      Vector d;
+      PAExpandAffineQuadratureData(maps->IntRule->GetNPoints(), symmDims, ne,
+                                   maps->IntRule->GetWeights(), pa_data, d);
+      pa_data.Swap(d);
+      pa_affine = false;
+   }
    const Array<double> &B = maps->B;
    const Array<double> &G = maps->G;
    if (dim == 1)
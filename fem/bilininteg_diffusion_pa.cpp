@@ -10,8 +10,10 @@
 // CONTRIBUTING.md for details.
 
 #include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
+#include "pa_simd.hpp"
 #include "libceed/diffusion.hpp"
 
 using namespace std;
@@ -93,8 +95,10 @@ void PADiffusionSetup2D<2>(const int Q1D,
    const bool const_c = c.Size() == 1;
    MFEM_VERIFY(coeffDim < 3 ||
                !const_c, "Constant matrix coefficient not supported");
+   // Compressed GeometricFactors store one Jacobian per element
+   const int J1D = (j.Size() == 2*2*NE) ? 1 : Q1D;
    const auto W = Reshape(w.Read(), Q1D,Q1D);
-   const auto J = Reshape(j.Read(), Q1D,Q1D,2,2,NE);
+   const auto J = Reshape(j.Read(), J1D,J1D,2,2,NE);
    const auto C = const_c ? Reshape(c.Read(), 1,1,1,1) :
                   Reshape(c.Read(), coeffDim,Q1D,Q1D,NE);
    auto D = Reshape(d.Write(), Q1D,Q1D, symmetric ? 3 : 4, NE);
@@ -104,10 +108,11 @@ void PADiffusionSetup2D<2>(const int Q1D,
       {
          MFEM_FOREACH_THREAD(qy,y,Q1D)
          {
-            const double J11 = J(qx,qy,0,0,e);
-            const double J21 = J(qx,qy,1,0,e);
-            const double J12 = J(qx,qy,0,1,e);
-            const double J22 = J(qx,qy,1,1,e);
+            const int jx = (J1D == 1) ? 0 : qx, jy = (J1D == 1) ? 0 : qy;
+            const double J11 = J(jx,jy,0,0,e);
+            const double J21 = J(jx,jy,1,0,e);
+            const double J12 = J(jx,jy,0,1,e);
+            const double J22 = J(jx,jy,1,1,e);
             const double w_detJ = W(qx,qy) / ((J11*J22)-(J21*J12));
             if (coeffDim == 3 || coeffDim == 4) // Matrix coefficient
             {
@@ -160,8 +165,9 @@ void PADiffusionSetup2D<3>(const int Q1D,
    constexpr int DIM = 2;
    constexpr int SDIM = 3;
    const bool const_c = c.Size() == 1;
+   const int J1D = (j.Size() == SDIM*DIM*NE) ? 1 : Q1D;
    const auto W = Reshape(w.Read(), Q1D,Q1D);
-   const auto J = Reshape(j.Read(), Q1D,Q1D,SDIM,DIM,NE);
+   const auto J = Reshape(j.Read(), J1D,J1D,SDIM,DIM,NE);
    const auto C = const_c ? Reshape(c.Read(), 1,1,1) :
                   Reshape(c.Read(), Q1D,Q1D,NE);
    auto D = Reshape(d.Write(), Q1D,Q1D, 3, NE);
@@ -172,12 +178,13 @@ void PADiffusionSetup2D<3>(const int Q1D,
          MFEM_FOREACH_THREAD(qy,y,Q1D)
          {
             const double wq = W(qx,qy);
-            const double J11 = J(qx,qy,0,0,e);
-            const double J21 = J(qx,qy,1,0,e);
-            const double J31 = J(qx,qy,2,0,e);
-            const double J12 = J(qx,qy,0,1,e);
-            const double J22 = J(qx,qy,1,1,e);
-            const double J32 = J(qx,qy,2,1,e);
+            const int jx = (J1D == 1) ? 0 : qx, jy = (J1D == 1) ? 0 : qy;
+            const double J11 = J(jx,jy,0,0,e);
+            const double J21 = J(jx,jy,1,0,e);
+            const double J31 = J(jx,jy,2,0,e);
+            const double J12 = J(jx,jy,0,1,e);
+            const double J22 = J(jx,jy,1,1,e);
+            const double J32 = J(jx,jy,2,1,e);
             const double E = J11*J11 + J21*J21 + J31*J31;
             const double G = J12*J12 + J22*J22 + J32*J32;
             const double F = J11*J12 + J21*J22 + J31*J32;
@@ -205,8 +212,9 @@ void PADiffusionSetup3D(const int Q1D,
    const bool const_c = c.Size() == 1;
    MFEM_VERIFY(coeffDim < 6 ||
                !const_c, "Constant matrix coefficient not supported");
+   const int J1D = (j.Size() == 3*3*NE) ? 1 : Q1D;
    const auto W = Reshape(w.Read(), Q1D,Q1D,Q1D);
-   const auto J = Reshape(j.Read(), Q1D,Q1D,Q1D,3,3,NE);
+   const auto J = Reshape(j.Read(), J1D,J1D,J1D,3,3,NE);
    const auto C = const_c ? Reshape(c.Read(), 1,1,1,1,1) :
                   Reshape(c.Read(), coeffDim,Q1D,Q1D,Q1D,NE);
    auto D = Reshape(d.Write(), Q1D,Q1D,Q1D, symmetric ? 6 : 9, NE);
@@ -218,15 +226,17 @@ void PADiffusionSetup3D(const int Q1D,
          {
             MFEM_FOREACH_THREAD(qz,z,Q1D)
             {
-               const double J11 = J(qx,qy,qz,0,0,e);
-               const double J21 = J(qx,qy,qz,1,0,e);
-               const double J31 = J(qx,qy,qz,2,0,e);
-               const double J12 = J(qx,qy,qz,0,1,e);
-               const double J22 = J(qx,qy,qz,1,1,e);
-               const double J32 = J(qx,qy,qz,2,1,e);
-               const double J13 = J(qx,qy,qz,0,2,e);
-               const double J23 = J(qx,qy,qz,1,2,e);
-               const double J33 = J(qx,qy,qz,2,2,e);
+               const int jx = (J1D == 1) ? 0 : qx, jy = (J1D == 1) ? 0 : qy;
+               const int jz = (J1D == 1) ? 0 : qz;
+               const double J11 = J(jx,jy,jz,0,0,e);
+               const double J21 = J(jx,jy,jz,1,0,e);
+               const double J31 = J(jx,jy,jz,2,0,e);
+               const double J12 = J(jx,jy,jz,0,1,e);
+               const double J22 = J(jx,jy,jz,1,1,e);
+               const double J32 = J(jx,jy,jz,2,1,e);
+               const double J13 = J(jx,jy,jz,0,2,e);
+               const double J23 = J(jx,jy,jz,1,2,e);
+               const double J33 = J(jx,jy,jz,2,2,e);
                const double detJ = J11 * (J22 * J33 - J32 * J23) -
                /* */               J21 * (J12 * J33 - J32 * J13) +
                /* */               J31 * (J12 * J23 - J22 * J13);
@@ -349,12 +359,201 @@ static void PADiffusionSetup(const int dim,
    }
 }
 
+// Index of the entry (i,j), i <= j, of a packed symmetric DIMxDIM matrix
+MFEM_HOST_DEVICE static inline int PASymmIndex(const int DIM,
+                                               const int i, const int j)
+{
+   return i*DIM - (i*(i-1))/2 + (j-i);
+}
+
+// PA Diffusion Assemble kernel for non-tensor elements, e.g. simplices: the
+// quadrature points are not structured and are stored with a single index.
+template<int DIM>
+static void PADiffusionSetupSimplexT(const int NQ,
+                                     const int coeffDim,
+                                     const int NE,
+                                     const Array<double> &w,
+                                     const Vector &j,
+                                     const Vector &c,
+                                     Vector &d)
+{
+   constexpr int SYM = (DIM*(DIM+1))/2;
+   const bool symmetric = (coeffDim != DIM*DIM);
+   const bool matrix_c = (coeffDim >= SYM);
+   const bool const_c = c.Size() == 1;
+   MFEM_VERIFY(!matrix_c || !const_c,
+               "Constant matrix coefficient not supported");
+   // Compressed GeometricFactors store one Jacobian per element
+   const bool const_j = j.Size() == DIM*DIM*NE;
+   const auto W = w.Read();
+   const auto J = Reshape(j.Read(), const_j ? 1 : NQ,DIM,DIM,NE);
+   const auto C = const_c ? Reshape(c.Read(), 1,1,1) :
+                  Reshape(c.Read(), coeffDim,NQ,NE);
+   auto D = Reshape(d.Write(), NQ, symmetric ? SYM : DIM*DIM, NE);
+   MFEM_FORALL(qe, NQ*NE,
+   {
+      const int q = qe % NQ;
+      const int e = qe / NQ;
+      const int jq = const_j ? 0 : q;
+      double Jq[DIM*DIM], iJ[DIM*DIM], M[DIM*DIM];
+      for (int k = 0; k < DIM; k++)
+      {
+         for (int i = 0; i < DIM; i++) { Jq[i+DIM*k] = J(jq,i,k,e); }
+      }
+      kernels::CalcInverse<DIM>(Jq, iJ);
+      const double w_detJ = W[q] * kernels::Det<DIM>(Jq);
+      for (int k = 0; k < DIM; k++)
+      {
+         for (int i = 0; i < DIM; i++)
+         {
+            double m;
+            if (matrix_c)
+            {
+               m = symmetric ? C(PASymmIndex(DIM, i<k?i:k, i<k?k:i), q, e) :
+                   C(k+DIM*i, q, e);
+            }
+            else
+            {
+               m = (i != k) ? 0.0 : const_c ? C(0,0,0) :
+                   C(coeffDim == DIM ? i : 0, q, e);
+            }
+            M[i+DIM*k] = m;
+         }
+      }
+      // D = w det(J) J^{-1} M J^{-T}
+      for (int i = 0; i < DIM; i++)
+      {
+         for (int k = (symmetric ? i : 0); k < DIM; k++)
+         {
+            double r = 0.0;
+            for (int a = 0; a < DIM; a++)
+            {
+               for (int b = 0; b < DIM; b++)
+               {
+                  r += iJ[i+DIM*a] * M[a+DIM*b] * iJ[k+DIM*b];
+               }
+            }
+            D(q, symmetric ? PASymmIndex(DIM,i,k) : k+DIM*i, e) = w_detJ * r;
+         }
+      }
+   });
+}
+
+void PADiffusionSetupSimplex(const int dim,
+                             const int NQ,
+                             const int coeffDim,
+                             const int NE,
+                             const Array<double> &w,
+                             const Vector &j,
+                             const Vector &c,
+                             Vector &d)
+{
+   if (dim == 2) { return PADiffusionSetupSimplexT<2>(NQ,coeffDim,NE,w,j,c,d); }
+   if (dim == 3) { return PADiffusionSetupSimplexT<3>(NQ,coeffDim,NE,w,j,c,d); }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Diffusion Assemble on meshes with mixed elements: each group of elements
+// with the same geometry gets its own DofToQuad maps and quadrature data.
+void DiffusionIntegrator::AssemblePAMixed(const FiniteElementSpace &fes)
+{
+   Mesh *mesh = fes.GetMesh();
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   MFEM_VERIFY(IntRule == NULL, "Custom integration rules are not supported "
+               "on meshes with mixed elements");
+   MFEM_VERIFY(mesh->SpaceDimension() == dim,
+               "Surface meshes with mixed elements are not supported");
+   MFEM_VERIFY(!MQ || MQ->IsSymmetric(), "Non-symmetric matrix coefficients "
+               "are not supported on meshes with mixed elements");
+   MFEM_VERIFY(!dynamic_cast<QuadratureFunctionCoefficient*>(Q),
+               "QuadratureFunctionCoefficient is not supported on meshes with "
+               "mixed elements");
+   MFEM_VERIFY(!MQ || (MQ->GetHeight() == dim && MQ->GetWidth() == dim), "");
+   MFEM_VERIFY(!VQ || VQ->GetVDim() == dim, "");
+   symmetric = true;
+   const int symmDims = (dim * (dim + 1)) / 2;
+   const int coeffDim = MQ ? symmDims : VQ ? dim : 1;
+   Array<int> offsets, elements;
+   fes.GetElementGroups(offsets, elements);
+   const int ng = offsets.Size() - 1;
+   pa_groups.SetSize(ng);
+   int e_offset = 0, pa_offset = 0;
+   for (int g = 0; g < ng; g++)
+   {
+      PAElementGroup &grp = pa_groups[g];
+      grp.ne = offsets[g+1] - offsets[g];
+      grp.e_offset = e_offset;
+      grp.pa_offset = pa_offset;
+      grp.maps = NULL;
+      if (grp.ne == 0) { continue; }
+      const FiniteElement &el = *fes.GetFE(elements[offsets[g]]);
+      const IntegrationRule &ir = GetRule(el, el);
+      const bool tensor = dynamic_cast<const TensorBasisElement*>(&el);
+      grp.maps = &el.GetDofToQuad(ir, tensor ? DofToQuad::TENSOR :
+                                  DofToQuad::FULL);
+      e_offset += grp.ne * el.GetDof();
+      pa_offset += grp.ne * ir.GetNPoints() * symmDims;
+   }
+   pa_data.SetSize(pa_offset, Device::GetDeviceMemoryType());
+   Vector enodes;
+   PAElementNodes(fes, enodes);
+   ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+   const bool const_c = !MQ && !VQ && (Q == NULL || cQ);
+   Vector Cq(coeffDim);
+   for (int g = 0; g < ng; g++)
+   {
+      const PAElementGroup &grp = pa_groups[g];
+      if (grp.ne == 0) { continue; }
+      const IntegrationRule &ir = *grp.maps->IntRule;
+      const int NQ = ir.GetNPoints();
+      const int *g_elements = elements.GetData() + offsets[g];
+      Vector J, coeff, d;
+      PAElementJacobians(fes, enodes, g, ir, J);
+      if (const_c)
+      {
+         coeff.SetSize(1);
+         coeff(0) = cQ ? cQ->constant : 1.0;
+      }
+      else
+      {
+         coeff.SetSize(coeffDim * NQ * grp.ne);
+         auto C = Reshape(coeff.HostWrite(), coeffDim, NQ, grp.ne);
+         for (int e = 0; e < grp.ne; ++e)
+         {
+            ElementTransformation &T =
+               *fes.GetElementTransformation(g_elements[e]);
+            for (int q = 0; q < NQ; ++q)
+            {
+               const IntegrationPoint &ip = ir.IntPoint(q);
+               T.SetIntPoint(&ip);
+               if (MQ) { MQ->EvalSymmetric(Cq, T, ip); }
+               else if (VQ) { VQ->Eval(Cq, T, ip); }
+               else { Cq(0) = Q->Eval(T, ip); }
+               for (int i = 0; i < coeffDim; ++i) { C(i,q,e) = Cq(i); }
+            }
+         }
+      }
+      d.MakeRef(pa_data, grp.pa_offset, NQ * symmDims * grp.ne);
+      PADiffusionSetupSimplex(dim, NQ, coeffDim, grp.ne, ir.GetWeights(),
+                              J, coeff, d);
+   }
+}
+
 void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
 {
    // Assuming the same element type
    fespace = &fes;
+   pa_affine = false;
+   pa_data_single.DeleteAll();
+   pa_mixed_precision = false;
    Mesh *mesh = fes.GetMesh();
    if (mesh->GetNE() == 0) { return; }
+   if (mesh->GetNumGeometries(mesh->Dimension()) > 1)
+   {
+      return AssemblePAMixed(fes);
+   }
+   pa_groups.SetSize(0);
    const FiniteElement &el = *fes.GetFE(0);
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el);
    if (DeviceCanUseCeed())
@@ -364,16 +563,43 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
       InitCeedCoeff(Q, *mesh, *ir, ceedDataPtr);
       return CeedPADiffusionAssemble(fes, *ir, *ceedDataPtr);
    }
-   const int dims = el.GetDim();
-   const int symmDims = (dims * (dims + 1)) / 2; // 1x1: 1, 2x2: 3, 3x3: 6
-   const int nq = ir->GetNPoints();
+   // Bernstein simplices are sum-factorized with a collapsed rule
+   pa_collapsed.order = -1;
+   PACollapsedBasisSetup(el, *ir, pa_collapsed);
    dim = mesh->Dimension();
    ne = fes.GetNE();
-   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
-   const int sdim = mesh->SpaceDimension();
-   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   // Simplices and other non-tensor elements use the full basis
+   const bool tensor = UsesTensorBasis(fes);
+   MFEM_VERIFY(tensor || mesh->SpaceDimension() == dim,
+               "Surface meshes require tensor elements");
+   maps = &el.GetDofToQuad(*ir, tensor ? DofToQuad::TENSOR : DofToQuad::FULL);
    dofs1D = maps->ndof;
    quad1D = maps->nqpt;
+   // The specialized kernels cover the default rules up to order 10
+   if (tensor && dofs1D > 11)
+   {
+      MFEM_VERIFY(dofs1D <= MAX_D1D && quad1D <= MAX_Q1D, "The PA diffusion "
+                  "kernels support orders up to " << MAX_D1D-1);
+      MFEM_WARNING("No specialized PA diffusion kernel for order " << dofs1D-1
+                   << ", using the slower generic kernel.");
+   }
+   SetupPAQuadratureData();
+}
+
+void DiffusionIntegrator::SetupPAQuadratureData()
+{
+   Mesh *mesh = fespace->GetMesh();
+   const IntegrationRule *ir = maps->IntRule;
+   const int dims = maps->FE->GetDim();
+   const int symmDims = (dims * (dims + 1)) / 2; // 1x1: 1, 2x2: 3, 3x3: 6
+   const int nq = ir->GetNPoints();
+   const int sdim = mesh->SpaceDimension();
+   const bool tensor = maps->mode == DofToQuad::TENSOR;
+   // The OCCA setup kernels need the Jacobians at all quadrature points
+   const GeometricFactorsStorage storage =
+      Device::Allows(Backend::OCCA_MASK) ? GeometricFactorsStorage::Full :
+      GeometricFactorsStorage::Compressed;
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS, storage);
    int coeffDim = 1;
    Vector coeff;
    const int MQfullDim = MQ ? MQ->GetHeight() * MQ->GetWidth() : 0;
@@ -447,44 +673,33 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
          }
       }
    }
-   else if (Q == nullptr)
-   {
-      coeff.SetSize(1);
-      coeff(0) = 1.0;
-   }
-   else if (ConstantCoefficient* cQ = dynamic_cast<ConstantCoefficient*>(Q))
+   else
    {
-      coeff.SetSize(1);
-      coeff(0) = cQ->constant;
+      PAEvalCoefficient(Q, *fespace, *ir, coeff);
    }
-   else if (QuadratureFunctionCoefficient* cQ =
-               dynamic_cast<QuadratureFunctionCoefficient*>(Q))
-   {
-      const QuadratureFunction &qFun = cQ->GetQuadFunction();
-      MFEM_VERIFY(qFun.Size() == ne*nq,
-                  "Incompatible QuadratureFunction dimension \n");
-
-      MFEM_VERIFY(ir == &qFun.GetSpace()->GetElementIntRule(0),
-                  "IntegrationRule used within integrator and in"
-                  " QuadratureFunction appear to be different");
-      qFun.Read();
-      coeff.MakeRef(const_cast<QuadratureFunction &>(qFun),0);
-   }
-   else
+   // With affine elements and a constant scalar coefficient, the matrix
+   // coeff * det(J) J^{-1} J^{-T} is stored once per element and the weights
+   // are applied by the action. The elements count as affine when their
+   // Jacobians agree at all quadrature points up to a relative tolerance of
+   // 1e-12, see GeometricFactors::compressed. Vector, matrix and non-constant
+   // coefficients use the full quadrature data.
+   pa_affine = geom->compressed && !MQ && !VQ && coeff.Size() == 1 &&
+               symmetric && sdim == dim;
+   if (pa_affine)
    {
-      coeff.SetSize(nq * ne);
-      auto C = Reshape(coeff.HostWrite(), nq, ne);
-      for (int e = 0; e < ne; ++e)
-      {
-         ElementTransformation& T = *fes.GetElementTransformation(e);
-         for (int q = 0; q < nq; ++q)
-         {
-            C(q,e) = Q->Eval(T, ir->IntPoint(q));
-         }
-      }
+      Array<double> one(1);
+      one = 1.0;
+      pa_data.SetSize(symmDims * ne, Device::GetDeviceMemoryType());
+      return PADiffusionSetupSimplex(dim, 1, 1, ne, one, geom->J, coeff,
+                                     pa_data);
    }
    pa_data.SetSize((symmetric ? symmDims : MQfullDim) * nq * ne,
                    Device::GetDeviceMemoryType());
+   if (!tensor)
+   {
+      return PADiffusionSetupSimplex(dim, nq, coeffDim, ne, ir->GetWeights(),
+                                     geom->J, coeff, pa_data);
+   }
    PADiffusionSetup(dim, sdim, dofs1D, quad1D, coeffDim, ne, ir->GetWeights(),
                     geom->J, coeff, pa_data);
 }
@@ -890,6 +1105,8 @@ static void PADiffusionAssembleDiagonal(const int dim,
          case 0x77: return SmemPADiffusionDiagonal2D<7,7,2>(NE,symm,B,G,D,Y);
          case 0x88: return SmemPADiffusionDiagonal2D<8,8,1>(NE,symm,B,G,D,Y);
          case 0x99: return SmemPADiffusionDiagonal2D<9,9,1>(NE,symm,B,G,D,Y);
+         case 0xAA: return SmemPADiffusionDiagonal2D<10,10,1>(NE,symm,B,G,D,Y);
+         case 0xBB: return SmemPADiffusionDiagonal2D<11,11,1>(NE,symm,B,G,D,Y);
          default: return PADiffusionDiagonal2D(NE,symm,B,G,D,Y,D1D,Q1D);
       }
    }
@@ -905,12 +1122,72 @@ static void PADiffusionAssembleDiagonal(const int dim,
          case 0x78: return SmemPADiffusionDiagonal3D<7,8>(NE,symm,B,G,D,Y);
          case 0x89: return SmemPADiffusionDiagonal3D<8,9>(NE,symm,B,G,D,Y);
          case 0x9A: return SmemPADiffusionDiagonal3D<9,10>(NE,symm,B,G,D,Y);
+         // Larger sizes use the kernel without shared memory, which does not
+         // fit in the shared memory of GPUs.
+         case 0xAB: return PADiffusionDiagonal3D<10,11>(NE,symm,B,G,D,Y);
+         case 0xBC: return PADiffusionDiagonal3D<11,12>(NE,symm,B,G,D,Y);
          default: return PADiffusionDiagonal3D(NE,symm,B,G,D,Y,D1D,Q1D);
       }
    }
    MFEM_ABORT("Unknown kernel.");
 }
 
+// PA Diffusion Diagonal kernel for non-tensor elements, e.g. simplices
+template<int DIM>
+static void PADiffusionDiagonalSimplexT(const int ND,
+                                        const int NQ,
+                                        const int NE,
+                                        const bool symmetric,
+                                        const Array<double> &gt,
+                                        const Vector &d,
+                                        Vector &y)
+{
+   constexpr int SYM = (DIM*(DIM+1))/2;
+   const auto Gt = Reshape(gt.Read(), ND,NQ,DIM);
+   const auto D = Reshape(d.Read(), NQ, symmetric ? SYM : DIM*DIM, NE);
+   auto Y = Reshape(y.ReadWrite(), ND,NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         for (int dof = 0; dof < ND; ++dof)
+         {
+            double r = 0.0;
+            for (int i = 0; i < DIM; i++)
+            {
+               for (int k = 0; k < DIM; k++)
+               {
+                  const int ik = symmetric ?
+                                 PASymmIndex(DIM, i<k?i:k, i<k?k:i) : k+DIM*i;
+                  r += Gt(dof,q,i) * D(q,ik,e) * Gt(dof,q,k);
+               }
+            }
+            Y(dof,e) += r;
+         }
+      }
+   });
+}
+
+void PADiffusionDiagonalSimplex(const int dim,
+                                const int ND,
+                                const int NQ,
+                                const int NE,
+                                const bool symmetric,
+                                const Array<double> &gt,
+                                const Vector &d,
+                                Vector &y)
+{
+   if (dim == 2)
+   {
+      return PADiffusionDiagonalSimplexT<2>(ND,NQ,NE,symmetric,gt,d,y);
+   }
+   if (dim == 3)
+   {
+      return PADiffusionDiagonalSimplexT<3>(ND,NQ,NE,symmetric,gt,d,y);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
 void DiffusionIntegrator::AssembleDiagonalPA(Vector &diag)
 {
    if (DeviceCanUseCeed())
@@ -919,9 +1196,53 @@ void DiffusionIntegrator::AssembleDiagonalPA(Vector &diag)
    }
    else
    {
-      if (pa_data.Size()==0) { AssemblePA(*fespace); }
+      if (pa_data.Size()==0 && pa_data_single.Size()==0)
+      {
+         AssemblePA(*fespace);
+      }
+      for (int g = 0; g < pa_groups.Size(); g++)
+      {
+         const PAElementGroup &grp = pa_groups[g];
+         if (grp.ne == 0) { continue; }
+         const DofToQuad &m = *grp.maps;
+         const int ND = m.FE->GetDof(), NQ = m.IntRule->GetNPoints();
+         const int symmDims = (dim * (dim + 1)) / 2;
+         Vector d, y;
+         d.MakeRef(pa_data, grp.pa_offset, grp.ne * NQ * symmDims);
+         y.MakeRef(diag, grp.e_offset, grp.ne * ND);
+         if (m.mode == DofToQuad::FULL)
+         {
+            PADiffusionDiagonalSimplex(dim, m.ndof, m.nqpt, grp.ne, true,
+                                       m.Gt, d, y);
+         }
+         else
+         {
+            PADiffusionAssembleDiagonal(dim, m.ndof, m.nqpt, grp.ne, true,
+                                        m.B, m.G, d, y);
+         }
+      }
+      if (pa_groups.Size() > 0) { return; }
+      // The diagonal kernels use double precision data at all points
+      Vector d_tmp;
+      if (pa_affine)
+      {
+         const int symmDims = (dim * (dim + 1)) / 2;
+         PAExpandAffineQuadratureData(maps->IntRule->GetNPoints(), symmDims,
+                                      ne, maps->IntRule->GetWeights(), pa_data,
+                                      d_tmp);
+      }
+      else if (pa_data_single.Size() > 0)
+      {
+         PAConvertQuadratureData(pa_data_single, d_tmp);
+      }
+      const Vector &d = (d_tmp.Size() > 0) ? d_tmp : pa_data;
+      if (maps->mode == DofToQuad::FULL)
+      {
+         return PADiffusionDiagonalSimplex(dim, dofs1D, quad1D, ne, symmetric,
+                                           maps->Gt, d, diag);
+      }
       PADiffusionAssembleDiagonal(dim, dofs1D, quad1D, ne, symmetric,
-                                  maps->B, maps->G, pa_data, diag);
+                                  maps->B, maps->G, d, diag);
    }
 }
 
@@ -1026,29 +1347,37 @@ static void OccaPADiffusionApply3D(const int D1D,
 }
 #endif // MFEM_USE_OCCA
 
-// PA Diffusion Apply 2D kernel
-template<int T_D1D = 0, int T_Q1D = 0>
+// PA Diffusion Apply 2D kernel. Without the weights @a w_, the quadrature data
+// @a d_ has one matrix per quadrature point. With @a w_, e.g. on affine
+// elements with a constant coefficient, @a d_ has one symmetric matrix per
+// element, i.e. its stride between the quadrature points is 0, and it is
+// scaled by the weights here.
+template<int T_D1D = 0, int T_Q1D = 0, typename QData = Vector>
 static void PADiffusionApply2D(const int NE,
                                const bool symmetric,
                                const Array<double> &b_,
                                const Array<double> &g_,
                                const Array<double> &bt_,
                                const Array<double> &gt_,
-                               const Vector &d_,
+                               const QData &d_,
                                const Vector &x_,
                                Vector &y_,
                                const int d1d = 0,
-                               const int q1d = 0)
+                               const int q1d = 0,
+                               const Array<double> *w_ = NULL)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
    MFEM_VERIFY(D1D <= MAX_D1D, "");
    MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(symmetric || !w_, "");
+   const int QS = w_ ? 0 : 1;
    auto B = Reshape(b_.Read(), Q1D, D1D);
    auto G = Reshape(g_.Read(), Q1D, D1D);
    auto Bt = Reshape(bt_.Read(), D1D, Q1D);
    auto Gt = Reshape(gt_.Read(), D1D, Q1D);
-   auto D = Reshape(d_.Read(), Q1D*Q1D, symmetric ? 3 : 4, NE);
+   auto W = Reshape(w_ ? w_->Read() : NULL, Q1D, Q1D);
+   auto D = Reshape(d_.Read(), QS ? Q1D*Q1D : 1, symmetric ? 3 : 4, NE);
    auto X = Reshape(x_.Read(), D1D, D1D, NE);
    auto Y = Reshape(y_.ReadWrite(), D1D, D1D, NE);
    MFEM_FORALL(e, NE,
@@ -1101,12 +1430,13 @@ static void PADiffusionApply2D(const int NE,
       {
          for (int qx = 0; qx < Q1D; ++qx)
          {
-            const int q = qx + qy * Q1D;
+            const int q = (qx + qy * Q1D) * QS;
+            const double w = QS ? 1.0 : W(qx,qy);
 
-            const double O11 = D(q,0,e);
-            const double O21 = D(q,1,e);
-            const double O12 = symmetric ? O21 : D(q,2,e);
-            const double O22 = symmetric ? D(q,2,e) : D(q,3,e);
+            const double O11 = w * D(q,0,e);
+            const double O21 = w * D(q,1,e);
+            const double O12 = symmetric ? O21 : w * D(q,2,e);
+            const double O22 = w * (symmetric ? D(q,2,e) : D(q,3,e));
 
             const double gradX = grad[qy][qx][0];
             const double gradY = grad[qy][qx][1];
@@ -1149,12 +1479,13 @@ static void PADiffusionApply2D(const int NE,
 }
 
 // Shared memory PA Diffusion Apply 2D kernel
-template<int T_D1D = 0, int T_Q1D = 0, int T_NBZ = 0>
+template<int T_D1D = 0, int T_Q1D = 0, int T_NBZ = 0,
+         typename QData = Vector>
 static void SmemPADiffusionApply2D(const int NE,
                                    const bool symmetric,
                                    const Array<double> &b_,
                                    const Array<double> &g_,
-                                   const Vector &d_,
+                                   const QData &d_,
                                    const Vector &x_,
                                    Vector &y_,
                                    const int d1d = 0,
@@ -1306,28 +1637,33 @@ static void SmemPADiffusionApply2D(const int NE,
    });
 }
 
-// PA Diffusion Apply 3D kernel
-template<int T_D1D = 0, int T_Q1D = 0>
+// PA Diffusion Apply 3D kernel, see PADiffusionApply2D for the optional
+// weights @a w_.
+template<int T_D1D = 0, int T_Q1D = 0, typename QData = Vector>
 static void PADiffusionApply3D(const int NE,
                                const bool symmetric,
                                const Array<double> &b,
                                const Array<double> &g,
                                const Array<double> &bt,
                                const Array<double> &gt,
-                               const Vector &d_,
+                               const QData &d_,
                                const Vector &x_,
                                Vector &y_,
-                               int d1d = 0, int q1d = 0)
+                               int d1d = 0, int q1d = 0,
+                               const Array<double> *w_ = NULL)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
    MFEM_VERIFY(D1D <= MAX_D1D, "");
    MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(symmetric || !w_, "");
+   const int QS = w_ ? 0 : 1;
    auto B = Reshape(b.Read(), Q1D, D1D);
    auto G = Reshape(g.Read(), Q1D, D1D);
    auto Bt = Reshape(bt.Read(), D1D, Q1D);
    auto Gt = Reshape(gt.Read(), D1D, Q1D);
-   auto D = Reshape(d_.Read(), Q1D*Q1D*Q1D, symmetric ? 6 : 9, NE);
+   auto W = Reshape(w_ ? w_->Read() : NULL, Q1D, Q1D, Q1D);
+   auto D = Reshape(d_.Read(), QS ? Q1D*Q1D*Q1D : 1, symmetric ? 6 : 9, NE);
    auto X = Reshape(x_.Read(), D1D, D1D, D1D, NE);
    auto Y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, NE);
    MFEM_FORALL(e, NE,
@@ -1414,16 +1750,17 @@ static void PADiffusionApply3D(const int NE,
          {
             for (int qx = 0; qx < Q1D; ++qx)
             {
-               const int q = qx + (qy + qz * Q1D) * Q1D;
-               const double O11 = D(q,0,e);
-               const double O12 = D(q,1,e);
-               const double O13 = D(q,2,e);
-               const double O21 = symmetric ? O12 : D(q,3,e);
-               const double O22 = symmetric ? D(q,3,e) : D(q,4,e);
-               const double O23 = symmetric ? D(q,4,e) : D(q,5,e);
-               const double O31 = symmetric ? O13 : D(q,6,e);
-               const double O32 = symmetric ? O23 : D(q,7,e);
-               const double O33 = symmetric ? D(q,5,e) : D(q,8,e);
+               const int q = (qx + (qy + qz * Q1D) * Q1D) * QS;
+               const double w = QS ? 1.0 : W(qx,qy,qz);
+               const double O11 = w * D(q,0,e);
+               const double O12 = w * D(q,1,e);
+               const double O13 = w * D(q,2,e);
+               const double O21 = symmetric ? O12 : w * D(q,3,e);
+               const double O22 = w * (symmetric ? D(q,3,e) : D(q,4,e));
+               const double O23 = w * (symmetric ? D(q,4,e) : D(q,5,e));
+               const double O31 = symmetric ? O13 : w * D(q,6,e);
+               const double O32 = symmetric ? O23 : w * D(q,7,e);
+               const double O33 = w * (symmetric ? D(q,5,e) : D(q,8,e));
                const double gradX = grad[qz][qy][qx][0];
                const double gradY = grad[qz][qy][qx][1];
                const double gradZ = grad[qz][qy][qx][2];
@@ -1526,12 +1863,12 @@ static MFEM_HOST_DEVICE inline double sign(const int q, const int d)
    return (q<=d) ? -1.0 : 1.0;
 }
 
-template<int T_D1D = 0, int T_Q1D = 0>
+template<int T_D1D = 0, int T_Q1D = 0, typename QData = Vector>
 static void SmemPADiffusionApply3D(const int NE,
                                    const bool symmetric,
                                    const Array<double> &b_,
                                    const Array<double> &g_,
-                                   const Vector &d_,
+                                   const QData &d_,
                                    const Vector &x_,
                                    Vector &y_,
                                    const int d1d = 0,
@@ -1820,6 +2157,201 @@ static void SmemPADiffusionApply3D(const int NE,
    });
 }
 
+// PA Diffusion Apply 2D kernel for Backend::CPU_SIMD
+template<int D1D, int Q1D>
+static void SimdPADiffusionApply2D(const int NE,
+                                   const bool symmetric,
+                                   const Array<double> &b_,
+                                   const Array<double> &g_,
+                                   const Vector &d_,
+                                   const Vector &x_,
+                                   Vector &y_)
+{
+   typedef internal::PASimdTraits::vreal_t vreal_t;
+   constexpr int VS = vreal_t::size;
+   constexpr int ND = D1D*D1D;
+   constexpr int NQ = Q1D*Q1D;
+   const int NC = symmetric ? 3 : 4;
+   const auto b = Reshape(b_.HostRead(), Q1D, D1D);
+   const auto g = Reshape(g_.HostRead(), Q1D, D1D);
+   const double *d = d_.HostRead();
+   const double *x = x_.HostRead();
+   double *y = y_.HostReadWrite();
+   double B[Q1D][D1D], G[Q1D][D1D];
+   for (int dx = 0; dx < D1D; ++dx)
+   {
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         B[qx][dx] = b(qx,dx);
+         G[qx][dx] = g(qx,dx);
+      }
+   }
+   vreal_t X[D1D][D1D], Y[D1D][D1D], D[4][Q1D][Q1D], U[2][Q1D][Q1D];
+   for (int e = 0; e < NE; e += VS)
+   {
+      const int nl = (NE - e < VS) ? NE - e : VS;
+      internal::PASimdLoad(ND, nl, x + e*ND, &X[0][0]);
+      internal::PASimdLoad(NC*NQ, nl, d + e*NC*NQ, &D[0][0][0]);
+      internal::PASimdGrad2D(B, G, X, U);
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const vreal_t &O11 = D[0][qy][qx];
+            const vreal_t &O21 = D[1][qy][qx];
+            const vreal_t &O12 = symmetric ? O21 : D[2][qy][qx];
+            const vreal_t &O22 = symmetric ? D[2][qy][qx] : D[3][qy][qx];
+            const vreal_t gradX = U[0][qy][qx];
+            const vreal_t gradY = U[1][qy][qx];
+            U[0][qy][qx] = (O11 * gradX) + (O12 * gradY);
+            U[1][qy][qx] = (O21 * gradX) + (O22 * gradY);
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx) { Y[dy][dx] = 0.0; }
+      }
+      internal::PASimdGradT2D(B, G, U, Y);
+      internal::PASimdAddStore(ND, nl, &Y[0][0], y + e*ND);
+   }
+}
+
+// PA Diffusion Apply 3D kernel for Backend::CPU_SIMD
+template<int D1D, int Q1D>
+static void SimdPADiffusionApply3D(const int NE,
+                                   const bool symmetric,
+                                   const Array<double> &b_,
+                                   const Array<double> &g_,
+                                   const Vector &d_,
+                                   const Vector &x_,
+                                   Vector &y_)
+{
+   typedef internal::PASimdTraits::vreal_t vreal_t;
+   constexpr int VS = vreal_t::size;
+   constexpr int ND = D1D*D1D*D1D;
+   constexpr int NQ = Q1D*Q1D*Q1D;
+   const int NC = symmetric ? 6 : 9;
+   const auto b = Reshape(b_.HostRead(), Q1D, D1D);
+   const auto g = Reshape(g_.HostRead(), Q1D, D1D);
+   const double *d = d_.HostRead();
+   const double *x = x_.HostRead();
+   double *y = y_.HostReadWrite();
+   double B[Q1D][D1D], G[Q1D][D1D];
+   for (int dx = 0; dx < D1D; ++dx)
+   {
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         B[qx][dx] = b(qx,dx);
+         G[qx][dx] = g(qx,dx);
+      }
+   }
+   vreal_t X[D1D][D1D][D1D], Y[D1D][D1D][D1D];
+   vreal_t D[9][Q1D][Q1D][Q1D], U[3][Q1D][Q1D][Q1D];
+   for (int e = 0; e < NE; e += VS)
+   {
+      const int nl = (NE - e < VS) ? NE - e : VS;
+      internal::PASimdLoad(ND, nl, x + e*ND, &X[0][0][0]);
+      internal::PASimdLoad(NC*NQ, nl, d + e*NC*NQ, &D[0][0][0][0]);
+      internal::PASimdGrad3D(B, G, X, U);
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const vreal_t &O11 = D[0][qz][qy][qx];
+               const vreal_t &O12 = D[1][qz][qy][qx];
+               const vreal_t &O13 = D[2][qz][qy][qx];
+               const vreal_t &O21 = symmetric ? O12 : D[3][qz][qy][qx];
+               const vreal_t &O22 =
+                  symmetric ? D[3][qz][qy][qx] : D[4][qz][qy][qx];
+               const vreal_t &O23 =
+                  symmetric ? D[4][qz][qy][qx] : D[5][qz][qy][qx];
+               const vreal_t &O31 = symmetric ? O13 : D[6][qz][qy][qx];
+               const vreal_t &O32 = symmetric ? O23 : D[7][qz][qy][qx];
+               const vreal_t &O33 =
+                  symmetric ? D[5][qz][qy][qx] : D[8][qz][qy][qx];
+               const vreal_t gradX = U[0][qz][qy][qx];
+               const vreal_t gradY = U[1][qz][qy][qx];
+               const vreal_t gradZ = U[2][qz][qy][qx];
+               U[0][qz][qy][qx] = (O11*gradX)+(O12*gradY)+(O13*gradZ);
+               U[1][qz][qy][qx] = (O21*gradX)+(O22*gradY)+(O23*gradZ);
+               U[2][qz][qy][qx] = (O31*gradX)+(O32*gradY)+(O33*gradZ);
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx) { Y[dz][dy][dx] = 0.0; }
+         }
+      }
+      internal::PASimdGradT3D(B, G, U, Y);
+      internal::PASimdAddStore(ND, nl, &Y[0][0][0], y + e*ND);
+   }
+}
+
+// Dispatch the Backend::CPU_SIMD PA Diffusion Apply kernels. Returns false if
+// no kernel is available for the given sizes.
+static bool SimdPADiffusionApply(const int dim,
+                                 const int D1D,
+                                 const int Q1D,
+                                 const int NE,
+                                 const bool symm,
+                                 const Array<double> &B,
+                                 const Array<double> &G,
+                                 const Vector &D,
+                                 const Vector &X,
+                                 Vector &Y)
+{
+   const int ID = (D1D << 4) | Q1D;
+   if (dim == 2)
+   {
+      switch (ID)
+      {
+         case 0x22: SimdPADiffusionApply2D<2,2>(NE,symm,B,G,D,X,Y); return true;
+         case 0x23: SimdPADiffusionApply2D<2,3>(NE,symm,B,G,D,X,Y); return true;
+         case 0x33: SimdPADiffusionApply2D<3,3>(NE,symm,B,G,D,X,Y); return true;
+         case 0x34: SimdPADiffusionApply2D<3,4>(NE,symm,B,G,D,X,Y); return true;
+         case 0x44: SimdPADiffusionApply2D<4,4>(NE,symm,B,G,D,X,Y); return true;
+         case 0x45: SimdPADiffusionApply2D<4,5>(NE,symm,B,G,D,X,Y); return true;
+         case 0x55: SimdPADiffusionApply2D<5,5>(NE,symm,B,G,D,X,Y); return true;
+         case 0x56: SimdPADiffusionApply2D<5,6>(NE,symm,B,G,D,X,Y); return true;
+         case 0x66: SimdPADiffusionApply2D<6,6>(NE,symm,B,G,D,X,Y); return true;
+         case 0x67: SimdPADiffusionApply2D<6,7>(NE,symm,B,G,D,X,Y); return true;
+         case 0x77: SimdPADiffusionApply2D<7,7>(NE,symm,B,G,D,X,Y); return true;
+         case 0x78: SimdPADiffusionApply2D<7,8>(NE,symm,B,G,D,X,Y); return true;
+         case 0x88: SimdPADiffusionApply2D<8,8>(NE,symm,B,G,D,X,Y); return true;
+         case 0x89: SimdPADiffusionApply2D<8,9>(NE,symm,B,G,D,X,Y); return true;
+         case 0x99: SimdPADiffusionApply2D<9,9>(NE,symm,B,G,D,X,Y); return true;
+         default:   return false;
+      }
+   }
+   if (dim == 3)
+   {
+      switch (ID)
+      {
+         case 0x22: SimdPADiffusionApply3D<2,2>(NE,symm,B,G,D,X,Y); return true;
+         case 0x23: SimdPADiffusionApply3D<2,3>(NE,symm,B,G,D,X,Y); return true;
+         case 0x33: SimdPADiffusionApply3D<3,3>(NE,symm,B,G,D,X,Y); return true;
+         case 0x34: SimdPADiffusionApply3D<3,4>(NE,symm,B,G,D,X,Y); return true;
+         case 0x44: SimdPADiffusionApply3D<4,4>(NE,symm,B,G,D,X,Y); return true;
+         case 0x45: SimdPADiffusionApply3D<4,5>(NE,symm,B,G,D,X,Y); return true;
+         case 0x55: SimdPADiffusionApply3D<5,5>(NE,symm,B,G,D,X,Y); return true;
+         case 0x56: SimdPADiffusionApply3D<5,6>(NE,symm,B,G,D,X,Y); return true;
+         case 0x66: SimdPADiffusionApply3D<6,6>(NE,symm,B,G,D,X,Y); return true;
+         case 0x67: SimdPADiffusionApply3D<6,7>(NE,symm,B,G,D,X,Y); return true;
+         case 0x77: SimdPADiffusionApply3D<7,7>(NE,symm,B,G,D,X,Y); return true;
+         case 0x78: SimdPADiffusionApply3D<7,8>(NE,symm,B,G,D,X,Y); return true;
+         case 0x88: SimdPADiffusionApply3D<8,8>(NE,symm,B,G,D,X,Y); return true;
+         case 0x89: SimdPADiffusionApply3D<8,9>(NE,symm,B,G,D,X,Y); return true;
+         default:   return false;
+      }
+   }
+   return false;
+}
+
 static void PADiffusionApply(const int dim,
                              const int D1D,
                              const int Q1D,
@@ -1849,6 +2381,8 @@ static void PADiffusionApply(const int dim,
       MFEM_ABORT("OCCA PADiffusionApply unknown kernel!");
    }
 #endif // MFEM_USE_OCCA
+   if (internal::DeviceCanUsePASimd() &&
+       SimdPADiffusionApply(dim,D1D,Q1D,NE,symm,B,G,D,X,Y)) { return; }
    const int ID = (D1D << 4) | Q1D;
 
    if (dim == 2)
@@ -1863,6 +2397,8 @@ static void PADiffusionApply(const int dim,
          case 0x77: return SmemPADiffusionApply2D<7,7,4>(NE,symm,B,G,D,X,Y);
          case 0x88: return SmemPADiffusionApply2D<8,8,2>(NE,symm,B,G,D,X,Y);
          case 0x99: return SmemPADiffusionApply2D<9,9,2>(NE,symm,B,G,D,X,Y);
+         case 0xAA: return SmemPADiffusionApply2D<10,10,1>(NE,symm,B,G,D,X,Y);
+         case 0xBB: return SmemPADiffusionApply2D<11,11,1>(NE,symm,B,G,D,X,Y);
          default:   return PADiffusionApply2D(NE,symm,B,G,Bt,Gt,D,X,Y,D1D,Q1D);
       }
    }
@@ -1880,25 +2416,1134 @@ static void PADiffusionApply(const int dim,
          case 0x67: return SmemPADiffusionApply3D<6,7>(NE,symm,B,G,D,X,Y);
          case 0x78: return SmemPADiffusionApply3D<7,8>(NE,symm,B,G,D,X,Y);
          case 0x89: return SmemPADiffusionApply3D<8,9>(NE,symm,B,G,D,X,Y);
+         // Larger sizes use the kernel without shared memory, which does not
+         // fit in the shared memory of GPUs.
+         case 0x9A: return PADiffusionApply3D<9,10>(NE,symm,B,G,Bt,Gt,D,X,Y);
+         case 0xAB: return PADiffusionApply3D<10,11>(NE,symm,B,G,Bt,Gt,D,X,Y);
+         case 0xBC: return PADiffusionApply3D<11,12>(NE,symm,B,G,Bt,Gt,D,X,Y);
          default:   return PADiffusionApply3D(NE,symm,B,G,Bt,Gt,D,X,Y,D1D,Q1D);
       }
    }
    MFEM_ABORT("Unknown kernel.");
 }
 
-// PA Diffusion Apply kernel
-void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+// PA Diffusion Apply kernel for non-tensor elements, e.g. simplices. The
+// trial and test spaces may differ, as long as they share the quadrature rule.
+// With the weights @a w, the quadrature data is one symmetric matrix per
+// element, see PADiffusionApply2D.
+template<int DIM, typename QData = Vector>
+static void PADiffusionApplySimplexT(const int TR_ND,
+                                     const int TE_ND,
+                                     const int NQ,
+                                     const int NE,
+                                     const bool symmetric,
+                                     const Array<double> &gt_trial,
+                                     const Array<double> &gt_test,
+                                     const QData &d,
+                                     const Vector &x,
+                                     Vector &y,
+                                     const Array<double> *w = NULL)
 {
-   if (DeviceCanUseCeed())
+   constexpr int SYM = (DIM*(DIM+1))/2;
+   MFEM_VERIFY(symmetric || !w, "");
+   const int QS = w ? 0 : 1;
+   const auto Gtr = Reshape(gt_trial.Read(), TR_ND,NQ,DIM);
+   const auto Gte = Reshape(gt_test.Read(), TE_ND,NQ,DIM);
+   const auto W = w ? w->Read() : NULL;
+   const auto D = Reshape(d.Read(), QS ? NQ : 1, symmetric ? SYM : DIM*DIM,
+                          NE);
+   const auto X = Reshape(x.Read(), TR_ND,NE);
+   auto Y = Reshape(y.ReadWrite(), TE_ND,NE);
+   MFEM_FORALL(e, NE,
    {
-      CeedAddMult(ceedDataPtr, x, y);
+      for (int q = 0; q < NQ; ++q)
+      {
+         double g[DIM], v[DIM];
+         for (int i = 0; i < DIM; i++) { g[i] = 0.0; }
+         for (int dof = 0; dof < TR_ND; ++dof)
+         {
+            const double s = X(dof,e);
+            for (int i = 0; i < DIM; i++) { g[i] += Gtr(dof,q,i) * s; }
+         }
+         const double wq = QS ? 1.0 : W[q];
+         for (int i = 0; i < DIM; i++)
+         {
+            v[i] = 0.0;
+            for (int k = 0; k < DIM; k++)
+            {
+               const int ik = symmetric ?
+                              PASymmIndex(DIM, i<k?i:k, i<k?k:i) : k+DIM*i;
+               v[i] += D(q*QS,ik,e) * g[k];
+            }
+            v[i] *= wq;
+         }
+         for (int dof = 0; dof < TE_ND; ++dof)
+         {
+            double s = 0.0;
+            for (int i = 0; i < DIM; i++) { s += Gte(dof,q,i) * v[i]; }
+            Y(dof,e) += s;
+         }
+      }
+   });
+}
+
+void PADiffusionApplySimplex(const int dim,
+                             const int TR_ND,
+                             const int TE_ND,
+                             const int NQ,
+                             const int NE,
+                             const bool symmetric,
+                             const Array<double> &gt_trial,
+                             const Array<double> &gt_test,
+                             const Vector &d,
+                             const Vector &x,
+                             Vector &y)
+{
+   if (dim == 2)
+   {
+      return PADiffusionApplySimplexT<2>(TR_ND,TE_ND,NQ,NE,symmetric,
+                                         gt_trial,gt_test,d,x,y);
    }
-   else
+   if (dim == 3)
    {
-      PADiffusionApply(dim, dofs1D, quad1D, ne, symmetric,
-                       maps->B, maps->G, maps->Bt, maps->Gt,
-                       pa_data, x, y);
+      return PADiffusionApplySimplexT<3>(TR_ND,TE_ND,NQ,NE,symmetric,
+                                         gt_trial,gt_test,d,x,y);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// Matrix M of the collapsed map of IntegrationRules::GetCollapsed() at the
+// point (a,b,c): the reference gradient is M times the gradient with respect
+// to the collapsed coordinates. M is lower triangular, with column-major
+// layout.
+template<int DIM>
+MFEM_HOST_DEVICE static inline void PACollapsedGradMap(const double a,
+                                                       const double b,
+                                                       const double c,
+                                                       double *M)
+{
+   const double m = 1.0 / ((1.0 - b) * (1.0 - c));
+   for (int i = 0; i < DIM*DIM; i++) { M[i] = 0.0; }
+   M[0] = m;
+   M[1] = a * m;
+   if (DIM == 2) { M[3] = 1.0; }
+   if (DIM == 3)
+   {
+      M[2] = a * m;
+      M[4] = 1.0 / (1.0 - c);
+      M[5] = b / (1.0 - c);
+      M[8] = 1.0;
+   }
+}
+
+// Apply the quadrature data at one point to the gradient @a u with respect to
+// the collapsed coordinates at (a,b,c): v = M^T D M u, see PACollapsedGradMap.
+template<int DIM, typename QData>
+MFEM_HOST_DEVICE static inline void PACollapsedQFunction(const double a,
+                                                         const double b,
+                                                         const double c,
+                                                         const bool symmetric,
+                                                         const double w,
+                                                         const QData &D,
+                                                         const int q,
+                                                         const int e,
+                                                         const double *u,
+                                                         double *v)
+{
+   double M[DIM*DIM], g[DIM], r[DIM];
+   PACollapsedGradMap<DIM>(a, b, c, M);
+   for (int i = 0; i < DIM; i++)
+   {
+      g[i] = 0.0;
+      for (int k = 0; k < DIM; k++) { g[i] += M[i+DIM*k] * u[k]; }
    }
+   for (int i = 0; i < DIM; i++)
+   {
+      r[i] = 0.0;
+      for (int k = 0; k < DIM; k++)
+      {
+         const int ik = symmetric ?
+                        PASymmIndex(DIM, i<k?i:k, i<k?k:i) : k+DIM*i;
+         r[i] += D(q,ik,e) * g[k];
+      }
+      r[i] *= w;
+   }
+   for (int k = 0; k < DIM; k++)
+   {
+      v[k] = 0.0;
+      for (int i = 0; i < DIM; i++) { v[k] += M[i+DIM*k] * r[i]; }
+   }
+}
+
+// PA Diffusion Apply 2D kernel for Bernstein triangles, sum-factorized in the
+// collapsed coordinates, see PACollapsedBasis. With @a affine, the quadrature
+// data @a d has one symmetric matrix per element and the weights @a w are
+// applied here.
+template<typename QData = Vector>
+static void PADiffusionApplyCollapsed2D(const int NE,
+                                        const PACollapsedBasis &basis,
+                                        const bool symmetric,
+                                        const bool affine,
+                                        const Array<double> &w,
+                                        const QData &d,
+                                        const Vector &x,
+                                        Vector &y)
+{
+   const int P = basis.order;
+   const int D1D = P + 1;
+   const int Q1D = basis.Q1D;
+   const int ND = (D1D*(D1D+1))/2;
+   const auto B = Reshape(basis.B.Read(), Q1D,D1D,D1D);
+   const auto G = Reshape(basis.G.Read(), Q1D,D1D,D1D);
+   const auto Xq = basis.X.Read();
+   const auto map = basis.dof_map.Read();
+   const auto W = w.Read();
+   const auto D = Reshape(d.Read(), affine ? 1 : Q1D*Q1D,
+                          symmetric ? 3 : 4, NE);
+   const auto X = Reshape(x.Read(), ND,NE);
+   auto Y = Reshape(y.ReadWrite(), ND,NE);
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int max_D1D = MAX_D1D;
+      constexpr int max_Q1D = MAX_Q1D;
+      double tb[max_D1D][max_Q1D], tg[max_D1D][max_Q1D];
+      double ua[max_Q1D][max_Q1D], ub[max_Q1D][max_Q1D];
+      for (int j = 0, o = 0; j < D1D; o += D1D-j, j++)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            double sb = 0.0, sg = 0.0;
+            for (int i = 0; i < D1D-j; ++i)
+            {
+               const double s = X(map[o+i],e);
+               sb += B(qa,i,P-j) * s;
+               sg += G(qa,i,P-j) * s;
+            }
+            tb[j][qa] = sb;
+            tg[j][qa] = sg;
+         }
+      }
+      for (int qb = 0; qb < Q1D; ++qb)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            const int q = qa + Q1D*qb;
+            double u[2] = { 0.0, 0.0 }, v[2];
+            for (int j = 0; j < D1D; ++j)
+            {
+               u[0] += B(qb,j,P) * tg[j][qa];
+               u[1] += G(qb,j,P) * tb[j][qa];
+            }
+            PACollapsedQFunction<2>(Xq[qa], Xq[qb], 0.0, symmetric,
+                                    affine ? W[q] : 1.0, D, affine ? 0 : q,
+                                    e, u, v);
+            ua[qb][qa] = v[0];
+            ub[qb][qa] = v[1];
+         }
+      }
+      for (int j = 0; j < D1D; ++j)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            double sa = 0.0, sb = 0.0;
+            for (int qb = 0; qb < Q1D; ++qb)
+            {
+               sa += B(qb,j,P) * ua[qb][qa];
+               sb += G(qb,j,P) * ub[qb][qa];
+            }
+            tg[j][qa] = sa;
+            tb[j][qa] = sb;
+         }
+      }
+      for (int j = 0, o = 0; j < D1D; o += D1D-j, j++)
+      {
+         for (int i = 0; i < D1D-j; ++i)
+         {
+            double s = 0.0;
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               s += G(qa,i,P-j) * tg[j][qa] + B(qa,i,P-j) * tb[j][qa];
+            }
+            Y(map[o+i],e) += s;
+         }
+      }
+   });
+}
+
+// PA Diffusion Apply 3D kernel for Bernstein tetrahedra, see
+// PADiffusionApplyCollapsed2D.
+template<typename QData = Vector>
+static void PADiffusionApplyCollapsed3D(const int NE,
+                                        const PACollapsedBasis &basis,
+                                        const bool symmetric,
+                                        const bool affine,
+                                        const Array<double> &w,
+                                        const QData &d,
+                                        const Vector &x,
+                                        Vector &y)
+{
+   const int P = basis.order;
+   const int D1D = P + 1;
+   const int Q1D = basis.Q1D;
+   const int ND = (D1D*(D1D+1)*(D1D+2))/6;
+   const auto B = Reshape(basis.B.Read(), Q1D,D1D,D1D);
+   const auto G = Reshape(basis.G.Read(), Q1D,D1D,D1D);
+   const auto Xq = basis.X.Read();
+   const auto map = basis.dof_map.Read();
+   const auto W = w.Read();
+   const auto D = Reshape(d.Read(), affine ? 1 : Q1D*Q1D*Q1D,
+                          symmetric ? 6 : 9, NE);
+   const auto X = Reshape(x.Read(), ND,NE);
+   auto Y = Reshape(y.ReadWrite(), ND,NE);
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int max_D1D = MAX_D1D;
+      constexpr int max_Q1D = MAX_Q1D;
+      // Contractions with the values (B) and derivatives (G) in a, then b
+      double tb[max_D1D][max_D1D][max_Q1D], tg[max_D1D][max_D1D][max_Q1D];
+      double tgb[max_D1D][max_Q1D][max_Q1D], tbg[max_D1D][max_Q1D][max_Q1D];
+      double tbb[max_D1D][max_Q1D][max_Q1D];
+      double ua[max_Q1D][max_Q1D][max_Q1D], ub[max_Q1D][max_Q1D][max_Q1D];
+      double uc[max_Q1D][max_Q1D][max_Q1D];
+      for (int k = 0, o = 0; k < D1D; k++)
+      {
+         for (int j = 0; j < D1D-k; o += D1D-k-j, j++)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               double sb = 0.0, sg = 0.0;
+               for (int i = 0; i < D1D-k-j; ++i)
+               {
+                  const double s = X(map[o+i],e);
+                  sb += B(qa,i,P-k-j) * s;
+                  sg += G(qa,i,P-k-j) * s;
+               }
+               tb[k][j][qa] = sb;
+               tg[k][j][qa] = sg;
+            }
+         }
+      }
+      for (int k = 0; k < D1D; ++k)
+      {
+         for (int qb = 0; qb < Q1D; ++qb)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               double sgb = 0.0, sbg = 0.0, sbb = 0.0;
+               for (int j = 0; j < D1D-k; ++j)
+               {
+                  sgb += B(qb,j,P-k) * tg[k][j][qa];
+                  sbg += G(qb,j,P-k) * tb[k][j][qa];
+                  sbb += B(qb,j,P-k) * tb[k][j][qa];
+               }
+               tgb[k][qb][qa] = sgb;
+               tbg[k][qb][qa] = sbg;
+               tbb[k][qb][qa] = sbb;
+            }
+         }
+      }
+      for (int qc = 0; qc < Q1D; ++qc)
+      {
+         for (int qb = 0; qb < Q1D; ++qb)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               const int q = qa + Q1D*(qb + Q1D*qc);
+               double u[3] = { 0.0, 0.0, 0.0 }, v[3];
+               for (int k = 0; k < D1D; ++k)
+               {
+                  u[0] += B(qc,k,P) * tgb[k][qb][qa];
+                  u[1] += B(qc,k,P) * tbg[k][qb][qa];
+                  u[2] += G(qc,k,P) * tbb[k][qb][qa];
+               }
+               PACollapsedQFunction<3>(Xq[qa], Xq[qb], Xq[qc], symmetric,
+                                       affine ? W[q] : 1.0, D,
+                                       affine ? 0 : q, e, u, v);
+               ua[qc][qb][qa] = v[0];
+               ub[qc][qb][qa] = v[1];
+               uc[qc][qb][qa] = v[2];
+            }
+         }
+      }
+      for (int k = 0; k < D1D; ++k)
+      {
+         for (int qb = 0; qb < Q1D; ++qb)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               double sa = 0.0, sb = 0.0, sc = 0.0;
+               for (int qc = 0; qc < Q1D; ++qc)
+               {
+                  sa += B(qc,k,P) * ua[qc][qb][qa];
+                  sb += B(qc,k,P) * ub[qc][qb][qa];
+                  sc += G(qc,k,P) * uc[qc][qb][qa];
+               }
+               tgb[k][qb][qa] = sa;
+               tbg[k][qb][qa] = sb;
+               tbb[k][qb][qa] = sc;
+            }
+         }
+      }
+      for (int k = 0; k < D1D; ++k)
+      {
+         for (int j = 0; j < D1D-k; ++j)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               double sg = 0.0, sb = 0.0;
+               for (int qb = 0; qb < Q1D; ++qb)
+               {
+                  sg += B(qb,j,P-k) * tgb[k][qb][qa];
+                  sb += G(qb,j,P-k) * tbg[k][qb][qa] +
+                        B(qb,j,P-k) * tbb[k][qb][qa];
+               }
+               tg[k][j][qa] = sg;
+               tb[k][j][qa] = sb;
+            }
+         }
+      }
+      for (int k = 0, o = 0; k < D1D; k++)
+      {
+         for (int j = 0; j < D1D-k; o += D1D-k-j, j++)
+         {
+            for (int i = 0; i < D1D-k-j; ++i)
+            {
+               double s = 0.0;
+               for (int qa = 0; qa < Q1D; ++qa)
+               {
+                  s += G(qa,i,P-k-j) * tg[k][j][qa] +
+                       B(qa,i,P-k-j) * tb[k][j][qa];
+               }
+               Y(map[o+i],e) += s;
+            }
+         }
+      }
+   });
+}
+
+template<typename QData = Vector>
+static void PADiffusionApplyCollapsed(const int dim,
+                                      const int NE,
+                                      const PACollapsedBasis &basis,
+                                      const bool symmetric,
+                                      const bool affine,
+                                      const QData &d,
+                                      const Vector &x,
+                                      Vector &y)
+{
+   const Array<double> &W = basis.ir->GetWeights();
+   if (dim == 2)
+   {
+      return PADiffusionApplyCollapsed2D(NE, basis, symmetric, affine, W, d,
+                                         x, y);
+   }
+   if (dim == 3)
+   {
+      return PADiffusionApplyCollapsed3D(NE, basis, symmetric, affine, W, d,
+                                         x, y);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Diffusion Apply kernel for affine elements with a constant coefficient:
+// the symmetric matrix D is stored once per element and is scaled by the
+// quadrature weights W.
+static void PADiffusionApplyAffine(const int dim,
+                                   const int D1D,
+                                   const int Q1D,
+                                   const int NE,
+                                   const Array<double> &B,
+                                   const Array<double> &G,
+                                   const Array<double> &Bt,
+                                   const Array<double> &Gt,
+                                   const Array<double> &W,
+                                   const Vector &D,
+                                   const Vector &X,
+                                   Vector &Y)
+{
+   const int ID = (D1D << 4) | Q1D;
+   if (dim == 2)
+   {
+      switch (ID)
+      {
+         case 0x22:
+            return PADiffusionApply2D<2,2>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x33:
+            return PADiffusionApply2D<3,3>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x44:
+            return PADiffusionApply2D<4,4>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x55:
+            return PADiffusionApply2D<5,5>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x66:
+            return PADiffusionApply2D<6,6>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x77:
+            return PADiffusionApply2D<7,7>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x88:
+            return PADiffusionApply2D<8,8>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         default:
+            return PADiffusionApply2D(NE,true,B,G,Bt,Gt,D,X,Y,D1D,Q1D,&W);
+      }
+   }
+   if (dim == 3)
+   {
+      switch (ID)
+      {
+         case 0x23:
+            return PADiffusionApply3D<2,3>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x34:
+            return PADiffusionApply3D<3,4>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x45:
+            return PADiffusionApply3D<4,5>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x56:
+            return PADiffusionApply3D<5,6>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x67:
+            return PADiffusionApply3D<6,7>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x78:
+            return PADiffusionApply3D<7,8>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         case 0x89:
+            return PADiffusionApply3D<8,9>(NE,true,B,G,Bt,Gt,D,X,Y,0,0,&W);
+         default:
+            return PADiffusionApply3D(NE,true,B,G,Bt,Gt,D,X,Y,D1D,Q1D,&W);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Diffusion Apply kernel with single precision quadrature data: the
+// gradients at the quadrature points are still computed and accumulated in
+// double precision.
+static void PADiffusionApplyMixedPrecision(const int dim,
+                                           const int D1D,
+                                           const int Q1D,
+                                           const int NE,
+                                           const bool symm,
+                                           const Array<double> &B,
+                                           const Array<double> &G,
+                                           const Array<double> &Bt,
+                                           const Array<double> &Gt,
+                                           const Array<float> &D,
+                                           const Vector &X,
+                                           Vector &Y)
+{
+   const int ID = (D1D << 4) | Q1D;
+   if (dim == 2)
+   {
+      switch (ID)
+      {
+         case 0x22: return SmemPADiffusionApply2D<2,2,16>(NE,symm,B,G,D,X,Y);
+         case 0x33: return SmemPADiffusionApply2D<3,3,16>(NE,symm,B,G,D,X,Y);
+         case 0x44: return SmemPADiffusionApply2D<4,4,8>(NE,symm,B,G,D,X,Y);
+         case 0x55: return SmemPADiffusionApply2D<5,5,8>(NE,symm,B,G,D,X,Y);
+         case 0x66: return SmemPADiffusionApply2D<6,6,4>(NE,symm,B,G,D,X,Y);
+         case 0x77: return SmemPADiffusionApply2D<7,7,4>(NE,symm,B,G,D,X,Y);
+         case 0x88: return SmemPADiffusionApply2D<8,8,2>(NE,symm,B,G,D,X,Y);
+         default:   return PADiffusionApply2D(NE,symm,B,G,Bt,Gt,D,X,Y,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch (ID)
+      {
+         case 0x23: return SmemPADiffusionApply3D<2,3>(NE,symm,B,G,D,X,Y);
+         case 0x34: return SmemPADiffusionApply3D<3,4>(NE,symm,B,G,D,X,Y);
+         case 0x45: return SmemPADiffusionApply3D<4,5>(NE,symm,B,G,D,X,Y);
+         case 0x56: return SmemPADiffusionApply3D<5,6>(NE,symm,B,G,D,X,Y);
+         case 0x67: return SmemPADiffusionApply3D<6,7>(NE,symm,B,G,D,X,Y);
+         case 0x78: return SmemPADiffusionApply3D<7,8>(NE,symm,B,G,D,X,Y);
+         case 0x89: return SmemPADiffusionApply3D<8,9>(NE,symm,B,G,D,X,Y);
+         default:   return PADiffusionApply3D(NE,symm,B,G,Bt,Gt,D,X,Y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+static void PADiffusionApplyMixedPrecisionSimplex(const int dim,
+                                                  const int ND,
+                                                  const int NQ,
+                                                  const int NE,
+                                                  const bool symmetric,
+                                                  const Array<double> &gt,
+                                                  const Array<float> &d,
+                                                  const Vector &x,
+                                                  Vector &y)
+{
+   if (dim == 2)
+   {
+      return PADiffusionApplySimplexT<2>(ND,ND,NQ,NE,symmetric,gt,gt,d,x,y);
+   }
+   if (dim == 3)
+   {
+      return PADiffusionApplySimplexT<3>(ND,ND,NQ,NE,symmetric,gt,gt,d,x,y);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void DiffusionIntegrator::AssemblePAMixedPrecision(
+   const FiniteElementSpace &fes)
+{
+   AssemblePA(fes);
+   pa_mixed_precision = true;
+   if (fes.GetNE() == 0 || DeviceCanUseCeed() || pa_groups.Size() > 0 ||
+       pa_affine) { return; }
+   PAConvertQuadratureData(pa_data, pa_data_single);
+   pa_data.Destroy();
+}
+
+// PA Diffusion Apply kernel
+void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (DeviceCanUseCeed())
+   {
+      CeedAddMult(ceedDataPtr, x, y);
+   }
+   else if (pa_groups.Size() > 0)
+   {
+      const int symmDims = (dim * (dim + 1)) / 2;
+      for (int g = 0; g < pa_groups.Size(); g++)
+      {
+         const PAElementGroup &grp = pa_groups[g];
+         if (grp.ne == 0) { continue; }
+         const DofToQuad &m = *grp.maps;
+         const int ND = m.FE->GetDof(), NQ = m.IntRule->GetNPoints();
+         Vector d, xg, yg;
+         d.MakeRef(const_cast<Vector&>(pa_data), grp.pa_offset,
+                   grp.ne * NQ * symmDims);
+         xg.MakeRef(const_cast<Vector&>(x), grp.e_offset, grp.ne * ND);
+         yg.MakeRef(y, grp.e_offset, grp.ne * ND);
+         if (m.mode == DofToQuad::FULL)
+         {
+            PADiffusionApplySimplex(dim, m.ndof, m.ndof, m.nqpt, grp.ne, true,
+                                    m.Gt, m.Gt, d, xg, yg);
+         }
+         else
+         {
+            PADiffusionApply(dim, m.ndof, m.nqpt, grp.ne, true,
+                             m.B, m.G, m.Bt, m.Gt, d, xg, yg);
+         }
+      }
+   }
+   else if (pa_collapsed.order >= 0)
+   {
+      if (pa_data_single.Size() > 0)
+      {
+         PADiffusionApplyCollapsed(dim, ne, pa_collapsed, symmetric, false,
+                                   pa_data_single, x, y);
+      }
+      else
+      {
+         PADiffusionApplyCollapsed(dim, ne, pa_collapsed, symmetric,
+                                   pa_affine, pa_data, x, y);
+      }
+   }
+   else if (pa_data_single.Size() > 0)
+   {
+      if (maps->mode == DofToQuad::FULL)
+      {
+         PADiffusionApplyMixedPrecisionSimplex(dim, dofs1D, quad1D, ne,
+                                               symmetric, maps->Gt,
+                                               pa_data_single, x, y);
+      }
+      else
+      {
+         PADiffusionApplyMixedPrecision(dim, dofs1D, quad1D, ne, symmetric,
+                                        maps->B, maps->G, maps->Bt, maps->Gt,
+                                        pa_data_single, x, y);
+      }
+   }
+   else if (pa_affine)
+   {
+      const Array<double> &W = maps->IntRule->GetWeights();
+      if (maps->mode == DofToQuad::FULL)
+      {
+         const Array<double> &Gt = maps->Gt;
+         if (dim == 2)
+         {
+            PADiffusionApplySimplexT<2>(dofs1D, dofs1D, quad1D, ne, true, Gt,
+                                        Gt, pa_data, x, y, &W);
+         }
+         else
+         {
+            PADiffusionApplySimplexT<3>(dofs1D, dofs1D, quad1D, ne, true, Gt,
+                                        Gt, pa_data, x, y, &W);
+         }
+      }
+      else
+      {
+         PADiffusionApplyAffine(dim, dofs1D, quad1D, ne, maps->B, maps->G,
+                                maps->Bt, maps->Gt, W, pa_data, x, y);
+      }
+   }
+   else if (maps->mode == DofToQuad::FULL)
+   {
+      PADiffusionApplySimplex(dim, dofs1D, dofs1D, quad1D, ne, symmetric,
+                              maps->Gt, maps->Gt, pa_data, x, y);
+   }
+   else
+   {
+      PADiffusionApply(dim, dofs1D, quad1D, ne, symmetric,
+                       maps->B, maps->G, maps->Bt, maps->Gt,
+                       pa_data, x, y);
+   }
+}
+
+void DiffusionIntegrator::UpdateCoefficient(Coefficient &q)
+{
+   MFEM_VERIFY(fespace, "AssemblePA() must be called first");
+   MFEM_VERIFY(!VQ && !MQ, "UpdateCoefficient() cannot replace a vector or "
+               "matrix coefficient");
+   Q = &q;
+   if (DeviceCanUseCeed() || pa_groups.Size() > 0 || !maps)
+   {
+      return pa_mixed_precision ? AssemblePAMixedPrecision(*fespace) :
+             AssemblePA(*fespace);
+   }
+   // Only the quadrature data is recomputed, from the cached geometric factors
+   pa_data_single.DeleteAll();
+   SetupPAQuadratureData();
+   if (pa_mixed_precision && !pa_affine)
+   {
+      PAConvertQuadratureData(pa_data, pa_data_single);
+      pa_data.Destroy();
+   }
+}
+
+// PA Mass + Diffusion Apply 2D kernel: the values and the gradients are
+// interpolated together and integrated back together.
+template<int T_D1D = 0, int T_Q1D = 0>
+static void PAMassDiffusionApply2D(const int NE,
+                                   const bool symmetric,
+                                   const Array<double> &b_,
+                                   const Array<double> &g_,
+                                   const Array<double> &bt_,
+                                   const Array<double> &gt_,
+                                   const Vector &m_,
+                                   const Vector &d_,
+                                   const Vector &x_,
+                                   Vector &y_,
+                                   const int d1d = 0,
+                                   const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b_.Read(), Q1D, D1D);
+   auto G = Reshape(g_.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt_.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt_.Read(), D1D, Q1D);
+   auto M = Reshape(m_.Read(), Q1D*Q1D, NE);
+   auto D = Reshape(d_.Read(), Q1D*Q1D, symmetric ? 3 : 4, NE);
+   auto X = Reshape(x_.Read(), D1D, D1D, NE);
+   auto Y = Reshape(y_.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // grad[qy][qx][2] holds the value
+      double grad[max_Q1D][max_Q1D][3];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            grad[qy][qx][0] = 0.0;
+            grad[qy][qx][1] = 0.0;
+            grad[qy][qx][2] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double gradX[max_Q1D][2];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            gradX[qx][0] = 0.0;
+            gradX[qx][1] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = X(dx,dy,e);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] += s * B(qx,dx);
+               gradX[qx][1] += s * G(qx,dx);
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double wy  = B(qy,dy);
+            const double wDy = G(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qy][qx][0] += gradX[qx][1] * wy;
+               grad[qy][qx][1] += gradX[qx][0] * wDy;
+               grad[qy][qx][2] += gradX[qx][0] * wy;
+            }
+         }
+      }
+      // Calculate Dxy, xDy and the mass term in plane
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const int q = qx + qy * Q1D;
+
+            const double O11 = D(q,0,e);
+            const double O21 = D(q,1,e);
+            const double O12 = symmetric ? O21 : D(q,2,e);
+            const double O22 = symmetric ? D(q,2,e) : D(q,3,e);
+
+            const double gradX = grad[qy][qx][0];
+            const double gradY = grad[qy][qx][1];
+
+            grad[qy][qx][0] = (O11 * gradX) + (O12 * gradY);
+            grad[qy][qx][1] = (O21 * gradX) + (O22 * gradY);
+            grad[qy][qx][2] *= M(q,e);
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double gradX[max_D1D][3];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            gradX[dx][0] = 0;
+            gradX[dx][1] = 0;
+            gradX[dx][2] = 0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double gX = grad[qy][qx][0];
+            const double gY = grad[qy][qx][1];
+            const double u = grad[qy][qx][2];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double wx  = Bt(dx,qx);
+               const double wDx = Gt(dx,qx);
+               gradX[dx][0] += gX * wDx;
+               gradX[dx][1] += gY * wx;
+               gradX[dx][2] += u * wx;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double wy  = Bt(dy,qy);
+            const double wDy = Gt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               Y(dx,dy,e) += (((gradX[dx][0] + gradX[dx][2]) * wy) +
+                              (gradX[dx][1] * wDy));
+            }
+         }
+      }
+   });
+}
+
+// PA Mass + Diffusion Apply 3D kernel
+template<int T_D1D = 0, int T_Q1D = 0>
+static void PAMassDiffusionApply3D(const int NE,
+                                   const bool symmetric,
+                                   const Array<double> &b,
+                                   const Array<double> &g,
+                                   const Array<double> &bt,
+                                   const Array<double> &gt,
+                                   const Vector &m_,
+                                   const Vector &d_,
+                                   const Vector &x_,
+                                   Vector &y_,
+                                   int d1d = 0, int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto M = Reshape(m_.Read(), Q1D*Q1D*Q1D, NE);
+   auto D = Reshape(d_.Read(), Q1D*Q1D*Q1D, symmetric ? 6 : 9, NE);
+   auto X = Reshape(x_.Read(), D1D, D1D, D1D, NE);
+   auto Y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // grad[qz][qy][qx][3] holds the value
+      double grad[max_Q1D][max_Q1D][max_Q1D][4];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qz][qy][qx][0] = 0.0;
+               grad[qz][qy][qx][1] = 0.0;
+               grad[qz][qy][qx][2] = 0.0;
+               grad[qz][qy][qx][3] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double gradXY[max_Q1D][max_Q1D][3];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradXY[qy][qx][0] = 0.0;
+               gradXY[qy][qx][1] = 0.0;
+               gradXY[qy][qx][2] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double gradX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = 0.0;
+               gradX[qx][1] = 0.0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = X(dx,dy,dz,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s * B(qx,dx);
+                  gradX[qx][1] += s * G(qx,dx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = B(qy,dy);
+               const double wDy = G(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx  = gradX[qx][0];
+                  const double wDx = gradX[qx][1];
+                  gradXY[qy][qx][0] += wDx * wy;
+                  gradXY[qy][qx][1] += wx  * wDy;
+                  gradXY[qy][qx][2] += wx  * wy;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz  = B(qz,dz);
+            const double wDz = G(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  grad[qz][qy][qx][0] += gradXY[qy][qx][0] * wz;
+                  grad[qz][qy][qx][1] += gradXY[qy][qx][1] * wz;
+                  grad[qz][qy][qx][2] += gradXY[qy][qx][2] * wDz;
+                  grad[qz][qy][qx][3] += gradXY[qy][qx][2] * wz;
+               }
+            }
+         }
+      }
+      // Calculate Dxyz, xDyz, xyDz and the mass term in plane
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const int q = qx + (qy + qz * Q1D) * Q1D;
+               const double O11 = D(q,0,e);
+               const double O12 = D(q,1,e);
+               const double O13 = D(q,2,e);
+               const double O21 = symmetric ? O12 : D(q,3,e);
+               const double O22 = symmetric ? D(q,3,e) : D(q,4,e);
+               const double O23 = symmetric ? D(q,4,e) : D(q,5,e);
+               const double O31 = symmetric ? O13 : D(q,6,e);
+               const double O32 = symmetric ? O23 : D(q,7,e);
+               const double O33 = symmetric ? D(q,5,e) : D(q,8,e);
+               const double gradX = grad[qz][qy][qx][0];
+               const double gradY = grad[qz][qy][qx][1];
+               const double gradZ = grad[qz][qy][qx][2];
+               grad[qz][qy][qx][0] = (O11*gradX)+(O12*gradY)+(O13*gradZ);
+               grad[qz][qy][qx][1] = (O21*gradX)+(O22*gradY)+(O23*gradZ);
+               grad[qz][qy][qx][2] = (O31*gradX)+(O32*gradY)+(O33*gradZ);
+               grad[qz][qy][qx][3] *= M(q,e);
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double gradXY[max_D1D][max_D1D][3];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradXY[dy][dx][0] = 0;
+               gradXY[dy][dx][1] = 0;
+               gradXY[dy][dx][2] = 0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double gradX[max_D1D][4];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] = 0;
+               gradX[dx][1] = 0;
+               gradX[dx][2] = 0;
+               gradX[dx][3] = 0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double gX = grad[qz][qy][qx][0];
+               const double gY = grad[qz][qy][qx][1];
+               const double gZ = grad[qz][qy][qx][2];
+               const double u = grad[qz][qy][qx][3];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  const double wx  = Bt(dx,qx);
+                  const double wDx = Gt(dx,qx);
+                  gradX[dx][0] += gX * wDx;
+                  gradX[dx][1] += gY * wx;
+                  gradX[dx][2] += gZ * wx;
+                  gradX[dx][3] += u * wx;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy  = Bt(dy,qy);
+               const double wDy = Gt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradXY[dy][dx][0] += (gradX[dx][0] + gradX[dx][3]) * wy;
+                  gradXY[dy][dx][1] += gradX[dx][1] * wDy;
+                  gradXY[dy][dx][2] += gradX[dx][2] * wy;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz  = Bt(dz,qz);
+            const double wDz = Gt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  Y(dx,dy,dz,e) +=
+                     ((gradXY[dy][dx][0] * wz) +
+                      (gradXY[dy][dx][1] * wz) +
+                      (gradXY[dy][dx][2] * wDz));
+               }
+            }
+         }
+      }
+   });
+}
+
+static void PAMassDiffusionApply(const int dim,
+                                 const int D1D,
+                                 const int Q1D,
+                                 const int NE,
+                                 const bool symm,
+                                 const Array<double> &B,
+                                 const Array<double> &G,
+                                 const Array<double> &Bt,
+                                 const Array<double> &Gt,
+                                 const Vector &M,
+                                 const Vector &D,
+                                 const Vector &X,
+                                 Vector &Y)
+{
+   const int ID = (D1D << 4) | Q1D;
+
+   if (dim == 2)
+   {
+      switch (ID)
+      {
+         case 0x22:
+            return PAMassDiffusionApply2D<2,2>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x33:
+            return PAMassDiffusionApply2D<3,3>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x44:
+            return PAMassDiffusionApply2D<4,4>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x55:
+            return PAMassDiffusionApply2D<5,5>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x66:
+            return PAMassDiffusionApply2D<6,6>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x77:
+            return PAMassDiffusionApply2D<7,7>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x88:
+            return PAMassDiffusionApply2D<8,8>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x99:
+            return PAMassDiffusionApply2D<9,9>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0xAA:
+            return PAMassDiffusionApply2D<10,10>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0xBB:
+            return PAMassDiffusionApply2D<11,11>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         default:
+            return PAMassDiffusionApply2D(NE,symm,B,G,Bt,Gt,M,D,X,Y,D1D,Q1D);
+      }
+   }
+
+   if (dim == 3)
+   {
+      switch (ID)
+      {
+         case 0x23:
+            return PAMassDiffusionApply3D<2,3>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x34:
+            return PAMassDiffusionApply3D<3,4>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x45:
+            return PAMassDiffusionApply3D<4,5>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x56:
+            return PAMassDiffusionApply3D<5,6>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x67:
+            return PAMassDiffusionApply3D<6,7>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x78:
+            return PAMassDiffusionApply3D<7,8>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x89:
+            return PAMassDiffusionApply3D<8,9>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0x9A:
+            return PAMassDiffusionApply3D<9,10>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0xAB:
+            return PAMassDiffusionApply3D<10,11>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         case 0xBC:
+            return PAMassDiffusionApply3D<11,12>(NE,symm,B,G,Bt,Gt,M,D,X,Y);
+         default:
+            return PAMassDiffusionApply3D(NE,symm,B,G,Bt,Gt,M,D,X,Y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+bool DiffusionIntegrator::CanFusePA(const BilinearFormIntegrator &other) const
+{
+   const MassIntegrator *mass = dynamic_cast<const MassIntegrator*>(&other);
+   if (!mass || DeviceCanUseCeed()) { return false; }
+   // The Backend::CPU_SIMD kernels are applied separately
+   if (internal::DeviceCanUsePASimd()) { return false; }
+   // The fused kernels use double precision data at all quadrature points
+   if (pa_affine || mass->pa_affine) { return false; }
+   if (pa_data_single.Size() > 0 || mass->pa_data_single.Size() > 0)
+   {
+      return false;
+   }
+   // Same tensor DofToQuad maps, i.e. same element and quadrature rule
+   return (maps && maps == mass->maps && maps->mode == DofToQuad::TENSOR &&
+           pa_groups.Size() == 0 && mass->pa_groups.Size() == 0 &&
+           ne == mass->ne && (dim == 2 || dim == 3));
+}
+
+void DiffusionIntegrator::AddMultPAFused(const BilinearFormIntegrator &other,
+                                         const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(CanFusePA(other), "incompatible integrators");
+   const MassIntegrator &mass = static_cast<const MassIntegrator&>(other);
+   PAMassDiffusionApply(dim, dofs1D, quad1D, ne, symmetric,
+                        maps->B, maps->G, maps->Bt, maps->Gt,
+                        mass.pa_data, pa_data, x, y);
 }
 
 } // namespace mfem
@@ -10,6 +10,7 @@
 // CONTRIBUTING.md for details.
 
 #include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
 #include "libceed/mass.hpp"
@@ -2519,6 +2520,225 @@ void CurlCurlIntegrator::AssembleDiagonalPA(Vector& diag)
    }
 }
 
+// Values (curl == false) or curls (curl == true) of the reference basis
+// functions of a tensor product ND (or, with hdiv == true, RT) element at the
+// quadrature points, B(q,c,i), with the points and the dofs in the
+// lexicographic ordering of the PA kernels. In 2D the curl is a scalar.
+void PAHcurlHdivBasis(const int dim,
+                      const int D1D,
+                      const int Q1D,
+                      const bool hdiv,
+                      const bool curl,
+                      const Array<double> &bo,
+                      const Array<double> &bc,
+                      const Array<double> &gc,
+                      Array<double> &basis)
+{
+   MFEM_VERIFY(dim == 2 || dim == 3, "");
+   MFEM_VERIFY(!(hdiv && curl), "");
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   const int DC = (dim == 2) ? D1D*(D1D-1) : D1D*(D1D-1)*(hdiv ? D1D-1 : D1D);
+   const int ND = dim * DC;
+   const int VC = (curl && dim == 2) ? 1 : dim;
+   const auto Bo = Reshape(bo.Read(), Q1D, D1D-1);
+   const auto Bc = Reshape(bc.Read(), Q1D, D1D);
+   const auto Gc = Reshape(curl ? gc.Read() : bc.Read(), Q1D, D1D);
+   basis.SetSize(NQ*VC*ND, Device::GetMemoryType());
+   auto B = Reshape(basis.Write(), NQ, VC, ND);
+   MFEM_FORALL(qi, NQ*ND,
+   {
+      const int q = qi % NQ;
+      const int i = qi / NQ;
+      const int c = i / DC;
+      int l = i % DC;
+      const int qd[3] = { q % Q1D, (q / Q1D) % Q1D, q / (Q1D*Q1D) };
+      // The component c of an ND (RT) basis function is open (closed) in the
+      // direction c and closed (open) in the other directions
+      double b[3] = { 1.0, 1.0, 1.0 }, g[3] = { 0.0, 0.0, 0.0 };
+      for (int d = 0; d < dim; d++)
+      {
+         const bool open = (d == c) != hdiv;
+         const int n = open ? D1D-1 : D1D;
+         const int k = l % n;
+         l /= n;
+         b[d] = open ? Bo(qd[d],k) : Bc(qd[d],k);
+         g[d] = open ? 0.0 : Gc(qd[d],k);
+      }
+      for (int v = 0; v < VC; v++) { B(q,v,i) = 0.0; }
+      if (!curl)
+      {
+         B(q,c,i) = b[0] * b[1] * b[2];
+      }
+      else if (dim == 2)
+      {
+         // curl(phi e_x) = -d_y phi, curl(phi e_y) = d_x phi
+         B(q,0,i) = (c == 0) ? -b[0] * g[1] : g[0] * b[1];
+      }
+      else
+      {
+         // curl(phi e_c) = grad(phi) x e_c
+         const double grad[3] = { g[0] * b[1] * b[2],
+                                  b[0] * g[1] * b[2],
+                                  b[0] * b[1] * g[2]
+                                };
+         B(q,(c+1)%3,i) = grad[(c+2)%3];
+         B(q,(c+2)%3,i) = -grad[(c+1)%3];
+      }
+   });
+}
+
+// Expands the quadrature data of the H(curl) and H(div) PA kernels to the full
+// VDIM x VDIM matrices D(c,d,q,e). The data has ncomp = 1 (scalar), VDIM
+// (diagonal), VDIM*(VDIM+1)/2 (packed symmetric) or VDIM*VDIM entries at each
+// point, stored as op(q,k,e) if qfirst, or op(k,q,e) otherwise. The full
+// matrices are stored row by row if row_major, and column by column otherwise.
+void PAHcurlHdivExpandQuadData(const int VDIM,
+                               const int NQ,
+                               const int NE,
+                               const int ncomp,
+                               const bool qfirst,
+                               const bool row_major,
+                               const Vector &op,
+                               Vector &d)
+{
+   const int SYM = (VDIM*(VDIM+1))/2;
+   MFEM_VERIFY(ncomp == 1 || ncomp == VDIM || ncomp == SYM ||
+               ncomp == VDIM*VDIM, "Unknown quadrature data layout");
+   const auto O = Reshape(op.Read(), qfirst ? NQ : ncomp,
+                          qfirst ? ncomp : NQ, NE);
+   d.SetSize(VDIM*VDIM*NQ*NE, Device::GetMemoryType());
+   d.UseDevice(true);
+   auto D = Reshape(d.Write(), VDIM, VDIM, NQ, NE);
+   MFEM_FORALL(qe, NQ*NE,
+   {
+      const int q = qe % NQ;
+      const int e = qe / NQ;
+      for (int r = 0; r < VDIM; r++)
+      {
+         for (int c = 0; c < VDIM; c++)
+         {
+            int k = -1;
+            if (ncomp == 1) { k = (r == c) ? 0 : -1; }
+            else if (ncomp == VDIM) { k = (r == c) ? r : -1; }
+            else if (ncomp == SYM)
+            {
+               const int i = (r < c) ? r : c, j = (r < c) ? c : r;
+               k = i*VDIM - (i*(i-1))/2 + (j-i);
+            }
+            else { k = row_major ? c + VDIM*r : r + VDIM*c; }
+            D(r,c,q,e) = (k < 0) ? 0.0 : qfirst ? O(q,k,e) : O(k,q,e);
+         }
+      }
+   });
+}
+
+// Element matrices of the quadrature data D(c,d,q,e) computed with the test
+// and trial basis tables Bt(q,c,i) and Br(q,d,j), see PAHcurlHdivBasis():
+// A_ij = sum_q sum_{c,d} Bt(q,c,i) D(c,d,q,e) Br(q,d,j), stored as in the
+// other element assembly kernels, i.e. with the trial index first.
+void PAHcurlHdivAssembleEA(const int ND,
+                           const int NQ,
+                           const int NE,
+                           const int TC,
+                           const int RC,
+                           const Array<double> &test_basis,
+                           const Array<double> &trial_basis,
+                           const Vector &d,
+                           Vector &ea_data,
+                           const bool add)
+{
+   const auto Bt = Reshape(test_basis.Read(), NQ, TC, ND);
+   const auto Br = Reshape(trial_basis.Read(), NQ, RC, ND);
+   const auto D = Reshape(d.Read(), TC, RC, NQ, NE);
+   auto A = Reshape(add ? ea_data.ReadWrite() : ea_data.Write(), ND, ND, NE);
+   MFEM_FORALL(jie, ND*ND*NE,
+   {
+      const int j = jie % ND;
+      const int i = (jie / ND) % ND;
+      const int e = jie / (ND*ND);
+      double val = 0.0;
+      for (int q = 0; q < NQ; q++)
+      {
+         for (int c = 0; c < TC; c++)
+         {
+            const double bt = Bt(q,c,i);
+            if (bt == 0.0) { continue; }
+            for (int r = 0; r < RC; r++)
+            {
+               val += bt * D(c,r,q,e) * Br(q,r,j);
+            }
+         }
+      }
+      if (add) { A(j,i,e) += val; }
+      else { A(j,i,e) = val; }
+   });
+}
+
+void CurlCurlIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                    Vector &ea_data,
+                                    const bool add)
+{
+   AssemblePA(fes);
+   const int VC = (dim == 3) ? 3 : 1;
+   const int NQ = (dim == 3) ? quad1D*quad1D*quad1D : quad1D*quad1D;
+   const int ncomp = (dim == 2) ? 1 : (symmetric ? 6 : 9);
+   Array<double> curl;
+   PAHcurlHdivBasis(dim, dofs1D, quad1D, false, true, mapsO->B, mapsC->B,
+                    mapsC->G, curl);
+   Vector D;
+   PAHcurlHdivExpandQuadData(VC, NQ, ne, ncomp, true, true, pa_data, D);
+   const int ND = curl.Size() / (NQ*VC);
+   PAHcurlHdivAssembleEA(ND, NQ, ne, VC, VC, curl, curl, D, ea_data, add);
+}
+
+MixedCurlCurlIntegrator::~MixedCurlCurlIntegrator()
+{
+   delete pa_curlcurl;
+}
+
+void MixedCurlCurlIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   AssemblePA(fes, fes);
+}
+
+void MixedCurlCurlIntegrator::AssemblePA(const FiniteElementSpace &trial_fes,
+                                         const FiniteElementSpace &test_fes)
+{
+   const FiniteElement *trial_fel = trial_fes.GetFE(0);
+   const FiniteElement *test_fel = test_fes.GetFE(0);
+   MFEM_VERIFY(VerifyFiniteElementTypes(*trial_fel, *test_fel),
+               FiniteElementTypeFailureMessage());
+   MFEM_VERIFY(trial_fel->GetOrder() == test_fel->GetOrder() &&
+               trial_fel->GetDof() == test_fel->GetDof(),
+               "The trial and test spaces must be the same");
+   MFEM_VERIFY(!VQ, "Only diagonal vector coefficients are supported");
+   delete pa_curlcurl;
+   if (MQ) { pa_curlcurl = new CurlCurlIntegrator(*MQ); }
+   else if (DQ) { pa_curlcurl = new CurlCurlIntegrator(*DQ); }
+   else if (Q) { pa_curlcurl = new CurlCurlIntegrator(*Q); }
+   else { pa_curlcurl = new CurlCurlIntegrator; }
+   pa_curlcurl->SetIntRule(IntRule);
+   pa_curlcurl->AssemblePA(trial_fes);
+}
+
+void MixedCurlCurlIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   pa_curlcurl->AddMultPA(x, y);
+}
+
+void MixedCurlCurlIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   pa_curlcurl->AssembleDiagonalPA(diag);
+}
+
+void MixedCurlCurlIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                         Vector &ea_data,
+                                         const bool add)
+{
+   AssemblePA(fes);
+   pa_curlcurl->AssembleEA(fes, ea_data, add);
+}
+
 // Apply to x corresponding to DOF's in H^1 (trial), whose gradients are
 // integrated against H(curl) test functions corresponding to y.
 void PAHcurlH1Apply3D(const int D1D,
@@ -2857,6 +3077,109 @@ void PAHcurlL2Setup(const int NQ,
    });
 }
 
+// PA H(curl) assemble kernel for the mixed curl integrators with a matrix
+// coefficient M, stored row major with 9 entries per point. With u = J^{-T} û
+// and curl(u) = J ĉurl(û) / det(J), the data is W J^{-1} M J for the curl of
+// the trial functions, or W J^T M J^{-T} for the curl of the test functions.
+static void PAHcurlL2SetupMatrix(const int NQ,
+                                 const int NE,
+                                 const bool test_curl,
+                                 const Array<double> &w,
+                                 const Vector &j,
+                                 Vector &coeff,
+                                 Vector &op)
+{
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 3, 3, NE);
+   auto C = Reshape(coeff.Read(), 9, NQ, NE);
+   auto y = Reshape(op.Write(), 9, NQ, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         double Jq[9], iJ[9];
+         for (int k = 0; k < 3; k++)
+         {
+            for (int i = 0; i < 3; i++) { Jq[i+3*k] = J(q,i,k,e); }
+         }
+         kernels::CalcInverse<3>(Jq, iJ);
+         // A = J^{-1} and B = J, or A = J^T and B = J^{-T} (column major)
+         for (int i = 0; i < 3; i++)
+         {
+            for (int k = 0; k < 3; k++)
+            {
+               double r = 0.0;
+               for (int a = 0; a < 3; a++)
+               {
+                  const double Aia = test_curl ? Jq[a+3*i] : iJ[i+3*a];
+                  for (int b = 0; b < 3; b++)
+                  {
+                     const double Bbk = test_curl ? iJ[k+3*b] : Jq[b+3*k];
+                     r += Aia * C(b+3*a,q,e) * Bbk;
+                  }
+               }
+               y(k+3*i,q,e) = W[q] * r;
+            }
+         }
+      }
+   });
+}
+
+// Evaluate the coefficients of the mixed curl integrators at the points of
+// @a ir: 1 value per point for a scalar coefficient, 3 for a diagonal matrix
+// coefficient if @a diag_vector is true, and 9 (row major) otherwise.
+static void PAHcurlL2Coefficient(Coefficient *Q, VectorCoefficient *DQ,
+                                 MatrixCoefficient *MQ, const bool diag_vector,
+                                 Mesh &mesh, const IntegrationRule &ir,
+                                 int &coeffDim, Vector &coeff)
+{
+   const int ne = mesh.GetNE();
+   const int nq = ir.GetNPoints();
+   coeffDim = MQ ? 9 : DQ ? (diag_vector ? 3 : 9) : 1;
+   MFEM_VERIFY(!DQ || DQ->GetVDim() == 3, "");
+   MFEM_VERIFY(!MQ || (MQ->GetHeight() == 3 && MQ->GetWidth() == 3), "");
+   coeff.SetSize(coeffDim * nq * ne);
+   coeff = 1.0;
+   if (!Q && !DQ && !MQ) { return; }
+   auto coeffh = Reshape(coeff.HostWrite(), coeffDim, nq, ne);
+   Vector V(3);
+   DenseMatrix M(3);
+   for (int e = 0; e < ne; ++e)
+   {
+      ElementTransformation *tr = mesh.GetElementTransformation(e);
+      for (int p = 0; p < nq; ++p)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(p);
+         tr->SetIntPoint(&ip);
+         if (MQ)
+         {
+            MQ->Eval(M, *tr, ip);
+            for (int i = 0; i < 3; ++i)
+            {
+               for (int k = 0; k < 3; ++k) { coeffh(k+3*i, p, e) = M(i,k); }
+            }
+         }
+         else if (DQ)
+         {
+            DQ->Eval(V, *tr, ip);
+            for (int i = 0; i < 3; ++i)
+            {
+               if (diag_vector) { coeffh(i, p, e) = V[i]; continue; }
+               for (int k = 0; k < 3; ++k)
+               {
+                  coeffh(k+3*i, p, e) = (i == k) ? V[i] : 0.0;
+               }
+            }
+         }
+         else
+         {
+            coeffh(0, p, e) = Q->Eval(*tr, ip);
+         }
+      }
+   }
+}
+
 void MixedVectorCurlIntegrator::AssemblePA(const FiniteElementSpace &trial_fes,
                                            const FiniteElementSpace &test_fes)
 {
@@ -2901,52 +3224,45 @@ void MixedVectorCurlIntegrator::AssemblePA(const FiniteElementSpace &trial_fes,
    trialType = trial_el->GetDerivType();
 
    const int symmDims = (dims * (dims + 1)) / 2; // 1x1: 1, 2x2: 3, 3x3: 6
-   coeffDim = (DQ ? 3 : 1);
+   const bool hdiv_test = (testType == mfem::FiniteElement::DIV);
+   Vector coeff;
+   PAHcurlL2Coefficient(Q, DQ, MQ, hdiv_test, *mesh, *ir, coeffDim, coeff);
 
-   pa_data.SetSize(symmDims * nq * ne, Device::GetMemoryType());
-
-   Vector coeff(coeffDim * nq * ne);
-   coeff = 1.0;
-   auto coeffh = Reshape(coeff.HostWrite(), coeffDim, nq, ne);
-   if (Q || DQ)
+   if (testType == mfem::FiniteElement::CURL &&
+       trialType == mfem::FiniteElement::CURL && dim == 3)
    {
-      Vector V(coeffDim);
-      if (DQ)
+      pa_data.SetSize(coeffDim * nq * ne, Device::GetMemoryType());
+      if (coeffDim == 9)
       {
-         MFEM_VERIFY(DQ->GetVDim() == coeffDim, "");
+         PAHcurlL2SetupMatrix(nq, ne, false, ir->GetWeights(), geom->J, coeff,
+                              pa_data);
       }
-
-      for (int e=0; e<ne; ++e)
+      else
       {
-         ElementTransformation *tr = mesh->GetElementTransformation(e);
-
-         for (int p=0; p<nq; ++p)
-         {
-            if (DQ)
-            {
-               DQ->Eval(V, *tr, ir->IntPoint(p));
-               for (int i=0; i<coeffDim; ++i)
-               {
-                  coeffh(i, p, e) = V[i];
-               }
-            }
-            else
-            {
-               coeffh(0, p, e) = Q->Eval(*tr, ir->IntPoint(p));
-            }
-         }
+         PAHcurlL2Setup(nq, coeffDim, ne, ir->GetWeights(), coeff, pa_data);
       }
    }
-
-   if (testType == mfem::FiniteElement::CURL &&
-       trialType == mfem::FiniteElement::CURL && dim == 3)
-   {
-      PAHcurlL2Setup(nq, coeffDim, ne, ir->GetWeights(), coeff, pa_data);
-   }
    else if (testType == mfem::FiniteElement::DIV &&
             trialType == mfem::FiniteElement::CURL && dim == 3 &&
             test_fel->GetOrder() == trial_fel->GetOrder())
    {
+      if (MQ)
+      {
+         // The H(div) kernel uses the symmetric part of the quadrature data
+         MFEM_VERIFY(MQ->IsSymmetric(), "Non-symmetric matrix coefficients "
+                     "are not supported with H(div) test functions");
+         Vector msymm(symmDims * nq * ne);
+         const auto C = Reshape(coeff.HostRead(), 9, nq * ne);
+         auto S = Reshape(msymm.HostWrite(), symmDims, nq * ne);
+         for (int p = 0; p < nq * ne; p++)
+         {
+            S(0,p) = C(0,p); S(1,p) = C(1,p); S(2,p) = C(2,p);
+            S(3,p) = C(4,p); S(4,p) = C(5,p); S(5,p) = C(8,p);
+         }
+         coeff.Swap(msymm);
+         coeffDim = symmDims;
+      }
+      pa_data.SetSize(symmDims * nq * ne, Device::GetMemoryType());
       PACurlCurlSetup3D(quad1D, coeffDim, ne, ir->GetWeights(), geom->J, coeff,
                         pa_data);
    }
@@ -3228,6 +3544,20 @@ static void PAHcurlL2Apply3D(const int D1D,
          {
             for (int qx = 0; qx < Q1D; ++qx)
             {
+               if (coeffDim == 9) // Matrix coefficient version
+               {
+                  double c[VDIM];
+                  for (int i = 0; i < VDIM; ++i)
+                  {
+                     c[i] = 0.0;
+                     for (int k = 0; k < VDIM; ++k)
+                     {
+                        c[i] += op(k+VDIM*i,qx,qy,qz,e) * curl[qz][qy][qx][k];
+                     }
+                  }
+                  for (int i = 0; i < VDIM; ++i) { curl[qz][qy][qx][i] = c[i]; }
+                  continue;
+               }
                for (int c = 0; c < VDIM; ++c)
                {
                   curl[qz][qy][qx][c] *= op(coeffDim == 3 ? c : 0, qx,qy,qz,e);
@@ -3324,7 +3654,7 @@ static void SmemPAHcurlL2Apply3D(const int D1D,
    MFEM_FORALL_3D(e, NE, Q1D, Q1D, Q1D,
    {
       constexpr int VDIM = 3;
-      constexpr int maxCoeffDim = 3;
+      constexpr int maxCoeffDim = 9;
 
       MFEM_SHARED double sBo[MAX_D1D][MAX_Q1D];
       MFEM_SHARED double sBc[MAX_D1D][MAX_Q1D];
@@ -3534,13 +3864,30 @@ static void SmemPAHcurlL2Apply3D(const int D1D,
 
                      for (int qx = 0; qx < Q1D; ++qx)
                      {
-                        const double O1 = sop[0][qx][qy];
-                        const double O2 = (coeffDim == 3) ? sop[1][qx][qy] : O1;
-                        const double O3 = (coeffDim == 3) ? sop[2][qx][qy] : O1;
-
-                        const double c1 = O1 * curl[qy][qx][0];
-                        const double c2 = O2 * curl[qy][qx][1];
-                        const double c3 = O3 * curl[qy][qx][2];
+                        double c1, c2, c3;
+                        if (coeffDim == 9) // Matrix coefficient version
+                        {
+                           const double v1 = curl[qy][qx][0];
+                           const double v2 = curl[qy][qx][1];
+                           const double v3 = curl[qy][qx][2];
+                           c1 = sop[0][qx][qy]*v1 +
+                                sop[1][qx][qy]*v2 + sop[2][qx][qy]*v3;
+                           c2 = sop[3][qx][qy]*v1 +
+                                sop[4][qx][qy]*v2 + sop[5][qx][qy]*v3;
+                           c3 = sop[6][qx][qy]*v1 +
+                                sop[7][qx][qy]*v2 + sop[8][qx][qy]*v3;
+                        }
+                        else
+                        {
+                           const double O1 = sop[0][qx][qy];
+                           const double O2 = (coeffDim == 3) ?
+                                               sop[1][qx][qy] : O1;
+                           const double O3 = (coeffDim == 3) ?
+                                               sop[2][qx][qy] : O1;
+                           c1 = O1 * curl[qy][qx][0];
+                           c2 = O2 * curl[qy][qx][1];
+                           c3 = O3 * curl[qy][qx][2];
+                        }
 
                         const double wcx = sBc[dx][qx];
 
@@ -3941,6 +4288,131 @@ static void PAHcurlHdivApply3D(const int D1D,
    }); // end of element loop
 }
 
+// PA H(curl) diagonal kernel for the mixed curl integrators with the same
+// H(curl) trial and test spaces, using the quadrature data of PAHcurlL2Setup or
+// PAHcurlL2SetupMatrix. The diagonal entry of the dof of component c of the
+// reference basis is sum_q u_c (A(c,k1) curl_k1 + A(c,k2) curl_k2), where k1
+// and k2 are the other two components and A is the quadrature data (or its
+// transpose, for the weak curl). It vanishes for scalar coefficients.
+template<int MAX_D1D = HCURL_MAX_D1D, int MAX_Q1D = HCURL_MAX_Q1D>
+static void PAHcurlL2AssembleDiagonal3D(const int D1D,
+                                        const int Q1D,
+                                        const int coeffDim,
+                                        const int NE,
+                                        const bool transpose,
+                                        const Array<double> &bo,
+                                        const Array<double> &bc,
+                                        const Array<double> &gc,
+                                        const Vector &pa_data,
+                                        Vector &diag)
+{
+   constexpr static int VDIM = 3;
+   MFEM_VERIFY(D1D <= MAX_D1D, "Error: D1D > MAX_D1D");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "Error: Q1D > MAX_Q1D");
+   if (coeffDim != 9) { return; }
+
+   auto Bo = Reshape(bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(bc.Read(), Q1D, D1D);
+   auto Gc = Reshape(gc.Read(), Q1D, D1D);
+   auto op = Reshape(pa_data.Read(), 9, Q1D, Q1D, Q1D, NE);
+   auto D = Reshape(diag.ReadWrite(), 3*(D1D-1)*D1D*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      // If c = 0, \hat{\nabla}\times\hat{u} reduces to [0, (u_0)_{x_2}, -(u_0)_{x_1}]
+      // If c = 1, \hat{\nabla}\times\hat{u} reduces to [-(u_1)_{x_2}, 0, (u_1)_{x_0}]
+      // If c = 2, \hat{\nabla}\times\hat{u} reduces to [(u_2)_{x_1}, -(u_2)_{x_0}, 0]
+      // i.e. curl_k1 = (u_c)_{x_k2} and curl_k2 = -(u_c)_{x_k1}.
+
+      int osc = 0;
+
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D - 1 : D1D;
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+         const int k1 = (c + 1) % 3;
+         const int k2 = (c + 2) % 3;
+         const int i1 = transpose ? c + 3*k1 : k1 + 3*c;
+         const int i2 = transpose ? c + 3*k2 : k2 + 3*c;
+
+         double zt[MAX_Q1D][MAX_Q1D][MAX_D1D][2];
+
+         // z contraction
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int dz = 0; dz < D1Dz; ++dz)
+               {
+                  zt[qx][qy][dz][0] = 0.0;
+                  zt[qx][qy][dz][1] = 0.0;
+
+                  for (int qz = 0; qz < Q1D; ++qz)
+                  {
+                     const double wz = (c == 2) ? Bo(qz,dz) : Bc(qz,dz);
+                     const double wDz = Bc(qz,dz) * Gc(qz,dz);
+                     const double w1 = (k2 == 2) ? wDz : wz * wz;
+                     const double w2 = (k1 == 2) ? wDz : wz * wz;
+                     zt[qx][qy][dz][0] += w1 * op(i1,qx,qy,qz,e);
+                     zt[qx][qy][dz][1] += w2 * op(i2,qx,qy,qz,e);
+                  }
+               }
+            }
+         }  // end of z contraction
+
+         double yt[MAX_Q1D][MAX_D1D][MAX_D1D][2];
+
+         // y contraction
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            for (int dz = 0; dz < D1Dz; ++dz)
+            {
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  yt[qx][dy][dz][0] = 0.0;
+                  yt[qx][dy][dz][1] = 0.0;
+
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     const double wy = (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+                     const double wDy = Bc(qy,dy) * Gc(qy,dy);
+                     const double w1 = (k2 == 1) ? wDy : wy * wy;
+                     const double w2 = (k1 == 1) ? wDy : wy * wy;
+                     yt[qx][dy][dz][0] += w1 * zt[qx][qy][dz][0];
+                     yt[qx][dy][dz][1] += w2 * zt[qx][qy][dz][1];
+                  }
+               }
+            }
+         }  // end of y contraction
+
+         // x contraction
+         for (int dz = 0; dz < D1Dz; ++dz)
+         {
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  double d = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     const double wx = (c == 0) ? Bo(qx,dx) : Bc(qx,dx);
+                     const double wDx = Bc(qx,dx) * Gc(qx,dx);
+                     const double w1 = (k2 == 0) ? wDx : wx * wx;
+                     const double w2 = (k1 == 0) ? wDx : wx * wx;
+                     d += w1 * yt[qx][dy][dz][0] - w2 * yt[qx][dy][dz][1];
+                  }
+                  D(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) += d;
+               }
+            }
+         }  // end of x contraction
+
+         osc += D1Dx * D1Dy * D1Dz;
+      }  // loop c
+   }); // end of element loop
+}
+
 void MixedVectorCurlIntegrator::AddMultPA(const Vector &x, Vector &y) const
 {
    if (testType == mfem::FiniteElement::CURL &&
@@ -3983,6 +4455,43 @@ void MixedVectorCurlIntegrator::AddMultPA(const Vector &x, Vector &y) const
    }
 }
 
+void MixedVectorCurlIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   AssemblePA(fes, fes);
+}
+
+void MixedVectorCurlIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   MFEM_VERIFY(testType == mfem::FiniteElement::CURL &&
+               trialType == mfem::FiniteElement::CURL && dim == 3 &&
+               dofs1D == dofs1Dtest,
+               "The trial and test spaces must be the same H(curl) space");
+   PAHcurlL2AssembleDiagonal3D(dofs1D, quad1D, coeffDim, ne, false, mapsO->B,
+                               mapsC->B, mapsC->G, pa_data, diag);
+}
+
+void MixedVectorCurlIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                           Vector &ea_data,
+                                           const bool add)
+{
+   AssemblePA(fes);
+   MFEM_VERIFY(testType == mfem::FiniteElement::CURL &&
+               trialType == mfem::FiniteElement::CURL && dim == 3,
+               "Element assembly requires an H(curl) space in 3D");
+   const int NQ = quad1D*quad1D*quad1D;
+   Array<double> vals, curl;
+   PAHcurlHdivBasis(dim, dofs1D, quad1D, false, false, mapsO->B, mapsC->B,
+                    mapsC->G, vals);
+   PAHcurlHdivBasis(dim, dofs1D, quad1D, false, true, mapsO->B, mapsC->B,
+                    mapsC->G, curl);
+   Vector D;
+   PAHcurlHdivExpandQuadData(3, NQ, ne, coeffDim, false, true, pa_data, D);
+   const int ND = curl.Size() / (NQ*3);
+   // The curl of the trial functions is tested with the values of the test
+   // functions
+   PAHcurlHdivAssembleEA(ND, NQ, ne, 3, 3, vals, curl, D, ea_data, add);
+}
+
 void MixedVectorWeakCurlIntegrator::AssemblePA(const FiniteElementSpace
                                                &trial_fes,
                                                const FiniteElementSpace &test_fes)
@@ -4021,47 +4530,19 @@ void MixedVectorWeakCurlIntegrator::AssemblePA(const FiniteElementSpace
 
    MFEM_VERIFY(dofs1D == mapsO->ndof + 1 && quad1D == mapsO->nqpt, "");
 
-   coeffDim = DQ ? 3 : 1;
+   testType = test_el->GetDerivType();
+   trialType = trial_el->GetDerivType();
 
+   Vector coeff;
+   PAHcurlL2Coefficient(Q, DQ, MQ, false, *mesh, *ir, coeffDim, coeff);
    pa_data.SetSize(coeffDim * nq * ne, Device::GetMemoryType());
 
-   Vector coeff(coeffDim * nq * ne);
-   coeff = 1.0;
-   auto coeffh = Reshape(coeff.HostWrite(), coeffDim, nq, ne);
-   if (Q || DQ)
+   if (trialType == mfem::FiniteElement::CURL && dim == 3 && coeffDim == 9)
    {
-      Vector V(coeffDim);
-      if (DQ)
-      {
-         MFEM_VERIFY(DQ->GetVDim() == coeffDim, "");
-      }
-
-      for (int e=0; e<ne; ++e)
-      {
-         ElementTransformation *tr = mesh->GetElementTransformation(e);
-
-         for (int p=0; p<nq; ++p)
-         {
-            if (DQ)
-            {
-               DQ->Eval(V, *tr, ir->IntPoint(p));
-               for (int i=0; i<coeffDim; ++i)
-               {
-                  coeffh(i, p, e) = V[i];
-               }
-            }
-            else
-            {
-               coeffh(0, p, e) = Q->Eval(*tr, ir->IntPoint(p));
-            }
-         }
-      }
+      PAHcurlL2SetupMatrix(nq, ne, true, ir->GetWeights(), geom->J, coeff,
+                           pa_data);
    }
-
-   testType = test_el->GetDerivType();
-   trialType = trial_el->GetDerivType();
-
-   if (trialType == mfem::FiniteElement::CURL && dim == 3)
+   else if (trialType == mfem::FiniteElement::CURL && dim == 3)
    {
       PAHcurlL2Setup(nq, coeffDim, ne, ir->GetWeights(), coeff, pa_data);
    }
@@ -4191,6 +4672,20 @@ static void PAHcurlL2Apply3DTranspose(const int D1D,
          {
             for (int qx = 0; qx < Q1D; ++qx)
             {
+               if (coeffDim == 9) // Matrix coefficient version
+               {
+                  double m[VDIM];
+                  for (int i = 0; i < VDIM; ++i)
+                  {
+                     m[i] = 0.0;
+                     for (int k = 0; k < VDIM; ++k)
+                     {
+                        m[i] += op(k+VDIM*i,qx,qy,qz,e) * mass[qz][qy][qx][k];
+                     }
+                  }
+                  for (int i = 0; i < VDIM; ++i) { mass[qz][qy][qx][i] = m[i]; }
+                  continue;
+               }
                for (int c=0; c<VDIM; ++c)
                {
                   mass[qz][qy][qx][c] *= op(coeffDim == 3 ? c : 0, qx,qy,qz,e);
@@ -4440,7 +4935,7 @@ static void SmemPAHcurlL2Apply3DTranspose(const int D1D,
    MFEM_FORALL_3D(e, NE, Q1D, Q1D, Q1D,
    {
       constexpr int VDIM = 3;
-      constexpr int maxCoeffDim = 3;
+      constexpr int maxCoeffDim = 9;
 
       MFEM_SHARED double sBo[MAX_D1D][MAX_Q1D];
       MFEM_SHARED double sBc[MAX_D1D][MAX_Q1D];
@@ -4585,13 +5080,30 @@ static void SmemPAHcurlL2Apply3DTranspose(const int D1D,
 
                      for (int qx = 0; qx < Q1D; ++qx)
                      {
-                        const double O1 = sop[0][qx][qy];
-                        const double O2 = (coeffDim == 3) ? sop[1][qx][qy] : O1;
-                        const double O3 = (coeffDim == 3) ? sop[2][qx][qy] : O1;
-
-                        const double c1 = O1 * mass[qy][qx][0];
-                        const double c2 = O2 * mass[qy][qx][1];
-                        const double c3 = O3 * mass[qy][qx][2];
+                        double c1, c2, c3;
+                        if (coeffDim == 9) // Matrix coefficient version
+                        {
+                           const double v1 = mass[qy][qx][0];
+                           const double v2 = mass[qy][qx][1];
+                           const double v3 = mass[qy][qx][2];
+                           c1 = sop[0][qx][qy]*v1 +
+                                sop[1][qx][qy]*v2 + sop[2][qx][qy]*v3;
+                           c2 = sop[3][qx][qy]*v1 +
+                                sop[4][qx][qy]*v2 + sop[5][qx][qy]*v3;
+                           c3 = sop[6][qx][qy]*v1 +
+                                sop[7][qx][qy]*v2 + sop[8][qx][qy]*v3;
+                        }
+                        else
+                        {
+                           const double O1 = sop[0][qx][qy];
+                           const double O2 = (coeffDim == 3) ?
+                                               sop[1][qx][qy] : O1;
+                           const double O3 = (coeffDim == 3) ?
+                                               sop[2][qx][qy] : O1;
+                           c1 = O1 * mass[qy][qx][0];
+                           c2 = O2 * mass[qy][qx][1];
+                           c3 = O3 * mass[qy][qx][2];
+                        }
 
                         const double wcx = sBc[dx][qx];
                         const double wDx = sGc[dx][qx];
@@ -4675,6 +5187,42 @@ void MixedVectorWeakCurlIntegrator::AddMultPA(const Vector &x, Vector &y) const
    }
 }
 
+void MixedVectorWeakCurlIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   AssemblePA(fes, fes);
+}
+
+void MixedVectorWeakCurlIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   MFEM_VERIFY(testType == mfem::FiniteElement::CURL &&
+               trialType == mfem::FiniteElement::CURL && dim == 3,
+               "The trial and test spaces must be the same H(curl) space");
+   PAHcurlL2AssembleDiagonal3D(dofs1D, quad1D, coeffDim, ne, true, mapsO->B,
+                               mapsC->B, mapsC->G, pa_data, diag);
+}
+
+void MixedVectorWeakCurlIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                               Vector &ea_data,
+                                               const bool add)
+{
+   AssemblePA(fes);
+   MFEM_VERIFY(testType == mfem::FiniteElement::CURL &&
+               trialType == mfem::FiniteElement::CURL && dim == 3,
+               "Element assembly requires an H(curl) space in 3D");
+   const int NQ = quad1D*quad1D*quad1D;
+   Array<double> vals, curl;
+   PAHcurlHdivBasis(dim, dofs1D, quad1D, false, false, mapsO->B, mapsC->B,
+                    mapsC->G, vals);
+   PAHcurlHdivBasis(dim, dofs1D, quad1D, false, true, mapsO->B, mapsC->B,
+                    mapsC->G, curl);
+   Vector D;
+   PAHcurlHdivExpandQuadData(3, NQ, ne, coeffDim, false, true, pa_data, D);
+   const int ND = curl.Size() / (NQ*3);
+   // The values of the trial functions are tested with the curl of the test
+   // functions
+   PAHcurlHdivAssembleEA(ND, NQ, ne, 3, 3, curl, vals, D, ea_data, add);
+}
+
 template void SmemPAHcurlMassAssembleDiagonal3D<0,0>(const int D1D,
                                                      const int Q1D,
                                                      const int NE,
@@ -10,6 +10,7 @@
 // CONTRIBUTING.md for details.
 
 #include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
 #include "libceed/mass.hpp"
@@ -97,6 +98,58 @@ void PAHdivSetup3D(const int Q1D,
    });
 }
 
+// PA H(div) Mass Assemble kernel for non-tensor elements, e.g. simplices.
+// Stores the packed symmetric (c/detJ) J^T J at the NQ points of each element.
+template<int DIM>
+static void PAHdivSetupSimplexT(const int NQ,
+                                const int NE,
+                                const Array<double> &w,
+                                const Vector &j,
+                                Vector &_coeff,
+                                Vector &op)
+{
+   constexpr int SYM = (DIM*(DIM+1))/2;
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, DIM, DIM, NE);
+   auto coeff = Reshape(_coeff.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, SYM, NE);
+
+   MFEM_FORALL(qe, NQ*NE,
+   {
+      const int q = qe % NQ;
+      const int e = qe / NQ;
+      double Jq[DIM*DIM];
+      for (int k = 0; k < DIM; k++)
+      {
+         for (int i = 0; i < DIM; i++) { Jq[i+DIM*k] = J(q,i,k,e); }
+      }
+      const double c_detJ = W[q] * coeff(q, e) / kernels::Det<DIM>(Jq);
+      int ik = 0;
+      for (int i = 0; i < DIM; i++)
+      {
+         for (int k = i; k < DIM; k++, ik++)
+         {
+            double r = 0.0;
+            for (int a = 0; a < DIM; a++) { r += Jq[a+DIM*i] * Jq[a+DIM*k]; }
+            y(q,ik,e) = c_detJ * r;
+         }
+      }
+   });
+}
+
+void PAHdivSetupSimplex(const int dim,
+                        const int NQ,
+                        const int NE,
+                        const Array<double> &w,
+                        const Vector &j,
+                        Vector &_coeff,
+                        Vector &op)
+{
+   if (dim == 2) { return PAHdivSetupSimplexT<2>(NQ, NE, w, j, _coeff, op); }
+   if (dim == 3) { return PAHdivSetupSimplexT<3>(NQ, NE, w, j, _coeff, op); }
+   MFEM_ABORT("Unknown kernel.");
+}
+
 void PAHdivMassApply2D(const int D1D,
                        const int Q1D,
                        const int NE,
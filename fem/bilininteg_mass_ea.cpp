@@ -228,7 +228,16 @@ void MassIntegrator::AssembleEA(const FiniteElementSpace &fes,
                                 const bool add)
 {
    AssemblePA(fes);
+   MFEM_VERIFY(maps->mode == DofToQuad::TENSOR,
+               "Element assembly requires tensor product elements");
    const int ne = fes.GetMesh()->GetNE();
+   if (pa_affine)
+   {
+      // The element assembly kernels use the data at all quadrature points
+      PAExpandAffineQuadratureData(nq, 1, ne, pa_weights, geom->detJ, pa_data);
+      GeometricFactors::Release(geom);
+      pa_affine = false;
+   }
    const Array<double> &B = maps->B;
    if (dim == 1)
    {
@@ -10,8 +10,10 @@
 // CONTRIBUTING.md for details.
 
 #include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
 #include "bilininteg.hpp"
 #include "gridfunc.hpp"
+#include "pa_simd.hpp"
 #include "libceed/mass.hpp"
 
 using namespace std;
@@ -21,14 +23,132 @@ namespace mfem
 
 // PA Mass Integrator
 
+// PA Mass Assemble kernel for non-tensor elements, e.g. simplices: the
+// quadrature points are not structured and are stored with a single index.
+template<int DIM>
+static void PAMassSetupSimplex(const int NQ,
+                               const int NE,
+                               const Array<double> &w,
+                               const Vector &j,
+                               const Vector &c,
+                               Vector &d)
+{
+   const bool const_c = c.Size() == 1;
+   // Compressed GeometricFactors store one Jacobian per element
+   const bool const_j = j.Size() == DIM*DIM*NE;
+   const auto W = w.Read();
+   const auto J = Reshape(j.Read(), const_j ? 1 : NQ,DIM,DIM,NE);
+   const auto C = const_c ? Reshape(c.Read(), 1,1) : Reshape(c.Read(), NQ,NE);
+   auto D = Reshape(d.Write(), NQ,NE);
+   MFEM_FORALL(qe, NQ*NE,
+   {
+      const int q = qe % NQ;
+      const int e = qe / NQ;
+      const int jq = const_j ? 0 : q;
+      double Jq[DIM*DIM];
+      for (int k = 0; k < DIM; k++)
+      {
+         for (int i = 0; i < DIM; i++) { Jq[i+DIM*k] = J(jq,i,k,e); }
+      }
+      const double coeff = const_c ? C(0,0) : C(q,e);
+      D(q,e) = W[q] * coeff * kernels::Det<DIM>(Jq);
+   });
+}
+
+// PA Mass Assemble on meshes with mixed elements: each group of elements with
+// the same geometry gets its own DofToQuad maps and quadrature data.
+void MassIntegrator::AssemblePAMixed(const FiniteElementSpace &fes)
+{
+   Mesh *mesh = fes.GetMesh();
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   MFEM_VERIFY(IntRule == NULL, "Custom integration rules are not supported "
+               "on meshes with mixed elements");
+   MFEM_VERIFY(mesh->SpaceDimension() == dim,
+               "Surface meshes with mixed elements are not supported");
+   MFEM_VERIFY(!dynamic_cast<QuadratureFunctionCoefficient*>(Q),
+               "QuadratureFunctionCoefficient is not supported on meshes with "
+               "mixed elements");
+   Array<int> offsets, elements;
+   fes.GetElementGroups(offsets, elements);
+   const int ng = offsets.Size() - 1;
+   pa_groups.SetSize(ng);
+   int e_offset = 0, pa_offset = 0;
+   for (int g = 0; g < ng; g++)
+   {
+      PAElementGroup &grp = pa_groups[g];
+      grp.ne = offsets[g+1] - offsets[g];
+      grp.e_offset = e_offset;
+      grp.pa_offset = pa_offset;
+      grp.maps = NULL;
+      if (grp.ne == 0) { continue; }
+      const int e0 = elements[offsets[g]];
+      const FiniteElement &el = *fes.GetFE(e0);
+      const IntegrationRule &ir =
+         GetRule(el, el, *mesh->GetElementTransformation(e0));
+      const bool tensor = dynamic_cast<const TensorBasisElement*>(&el);
+      grp.maps = &el.GetDofToQuad(ir, tensor ? DofToQuad::TENSOR :
+                                  DofToQuad::FULL);
+      e_offset += grp.ne * el.GetDof();
+      pa_offset += grp.ne * ir.GetNPoints();
+   }
+   pa_data.SetSize(pa_offset, Device::GetDeviceMemoryType());
+   Vector enodes;
+   PAElementNodes(fes, enodes);
+   ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+   for (int g = 0; g < ng; g++)
+   {
+      const PAElementGroup &grp = pa_groups[g];
+      if (grp.ne == 0) { continue; }
+      const IntegrationRule &ir = *grp.maps->IntRule;
+      const int NQ = ir.GetNPoints();
+      const int *g_elements = elements.GetData() + offsets[g];
+      Vector J, coeff, d;
+      PAElementJacobians(fes, enodes, g, ir, J);
+      if (Q == NULL || cQ)
+      {
+         coeff.SetSize(1);
+         coeff(0) = cQ ? cQ->constant : 1.0;
+      }
+      else
+      {
+         coeff.SetSize(NQ * grp.ne);
+         auto C = Reshape(coeff.HostWrite(), NQ, grp.ne);
+         for (int e = 0; e < grp.ne; ++e)
+         {
+            ElementTransformation &T =
+               *fes.GetElementTransformation(g_elements[e]);
+            for (int q = 0; q < NQ; ++q)
+            {
+               T.SetIntPoint(&ir.IntPoint(q));
+               C(q,e) = Q->Eval(T, ir.IntPoint(q));
+            }
+         }
+      }
+      d.MakeRef(pa_data, grp.pa_offset, NQ * grp.ne);
+      const Array<double> &W = ir.GetWeights();
+      if (dim == 2) { PAMassSetupSimplex<2>(NQ, grp.ne, W, J, coeff, d); }
+      if (dim == 3) { PAMassSetupSimplex<3>(NQ, grp.ne, W, J, coeff, d); }
+   }
+}
+
 // PA Mass Assemble kernel
 
 void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
 {
    // Assuming the same element type
    fespace = &fes;
+   if (pa_affine) { GeometricFactors::Release(geom); }
+   pa_affine = false;
+   pa_data_single.DeleteAll();
+   pa_mixed_precision = false;
    Mesh *mesh = fes.GetMesh();
    if (mesh->GetNE() == 0) { return; }
+   if (mesh->GetNumGeometries(mesh->Dimension()) > 1)
+   {
+      return AssemblePAMixed(fes);
+   }
+   pa_groups.SetSize(0);
    const FiniteElement &el = *fes.GetFE(0);
    ElementTransformation *T = mesh->GetElementTransformation(0);
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, *T);
@@ -39,60 +159,78 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
       InitCeedCoeff(Q, *mesh, *ir, ceedDataPtr);
       return CeedPAMassAssemble(fes, *ir, *ceedDataPtr);
    }
+   // Bernstein simplices are sum-factorized with a collapsed rule
+   pa_collapsed.order = -1;
+   PACollapsedBasisSetup(el, *ir, pa_collapsed);
    dim = mesh->Dimension();
    ne = fes.GetMesh()->GetNE();
    nq = ir->GetNPoints();
-   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES |
-                                    GeometricFactors::JACOBIANS);
-   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   // Simplices and other non-tensor elements use the full basis
+   const bool tensor = UsesTensorBasis(fes);
+   MFEM_VERIFY(tensor || mesh->SpaceDimension() == dim,
+               "Surface meshes require tensor elements");
+   maps = &el.GetDofToQuad(*ir, tensor ? DofToQuad::TENSOR : DofToQuad::FULL);
    dofs1D = maps->ndof;
    quad1D = maps->nqpt;
-   pa_data.SetSize(ne*nq, Device::GetDeviceMemoryType());
-   Vector coeff;
-   if (Q == nullptr)
+   // The specialized kernels cover the default rules up to order 10
+   if (tensor && dofs1D > 11)
    {
-      coeff.SetSize(1);
-      coeff(0) = 1.0;
+      MFEM_VERIFY(dofs1D <= MAX_D1D && quad1D <= MAX_Q1D,
+                  "The PA mass kernels support orders up to " << MAX_D1D-1);
+      MFEM_WARNING("No specialized PA mass kernel for order " << dofs1D-1
+                   << ", using the slower generic kernel.");
    }
-   else if (ConstantCoefficient* cQ = dynamic_cast<ConstantCoefficient*>(Q))
+   SetupPAQuadratureData();
+}
+
+void MassIntegrator::SetupPAQuadratureData()
+{
+   if (pa_affine) { GeometricFactors::Release(geom); }
+   pa_affine = false;
+   Mesh *mesh = fespace->GetMesh();
+   const IntegrationRule *ir = maps->IntRule;
+   const bool tensor = maps->mode == DofToQuad::TENSOR;
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS,
+                                    GeometricFactorsStorage::Compressed);
+   const bool const_j = geom->compressed;
+   Vector coeff;
+   PAEvalCoefficient(Q, *fespace, *ir, coeff);
+   if (dim==1) { MFEM_ABORT("Not supported yet... stay tuned!"); }
+   // With affine elements and a constant coefficient, the action reads det(J)
+   // per element from the shared compressed factors and applies the weights
+   // scaled by the coefficient. The elements count as affine when their
+   // Jacobians agree at all quadrature points up to a relative tolerance of
+   // 1e-12, see GeometricFactors::compressed. Other coefficients, even if
+   // constant in space, use the full quadrature data.
+   pa_affine = const_j && coeff.Size() == 1 && mesh->SpaceDimension() == dim;
+   if (pa_affine)
    {
-      coeff.SetSize(1);
-      coeff(0) = cQ->constant;
+      geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS |
+                                       GeometricFactors::DETERMINANTS,
+                                       GeometricFactorsStorage::Compressed);
+      geom->AddUser();
+      const double c = coeff.HostRead()[0];
+      pa_weights = ir->GetWeights();
+      for (int q = 0; q < nq; q++) { pa_weights[q] *= c; }
+      pa_data.Destroy();
+      return;
    }
-   else if (QuadratureFunctionCoefficient* cQ =
-               dynamic_cast<QuadratureFunctionCoefficient*>(Q))
+   pa_data.SetSize(ne*nq, Device::GetDeviceMemoryType());
+   if (!tensor)
    {
-      const QuadratureFunction &qFun = cQ->GetQuadFunction();
-      MFEM_VERIFY(qFun.Size() == nq * ne,
-                  "Incompatible QuadratureFunction dimension \n");
-
-      MFEM_VERIFY(ir == &qFun.GetSpace()->GetElementIntRule(0),
-                  "IntegrationRule used within integrator and in"
-                  " QuadratureFunction appear to be different");
-      qFun.Read();
-      coeff.MakeRef(const_cast<QuadratureFunction &>(qFun),0);
+      const Array<double> &W = ir->GetWeights();
+      if (dim==2) { PAMassSetupSimplex<2>(nq, ne, W, geom->J, coeff, pa_data); }
+      if (dim==3) { PAMassSetupSimplex<3>(nq, ne, W, geom->J, coeff, pa_data); }
+      return;
    }
-   else
-   {
-      coeff.SetSize(nq * ne);
-      auto C = Reshape(coeff.HostWrite(), nq, ne);
-      for (int e = 0; e < ne; ++e)
-      {
-         ElementTransformation& T = *fes.GetElementTransformation(e);
-         for (int q = 0; q < nq; ++q)
-         {
-            C(q,e) = Q->Eval(T, ir->IntPoint(q));
-         }
-      }
-   }
-   if (dim==1) { MFEM_ABORT("Not supported yet... stay tuned!"); }
    if (dim==2)
    {
       const int NE = ne;
       const int Q1D = quad1D;
       const bool const_c = coeff.Size() == 1;
       const auto W = Reshape(ir->GetWeights().Read(), Q1D,Q1D);
-      const auto J = Reshape(geom->J.Read(), Q1D,Q1D,2,2,NE);
+      const int J1D = const_j ? 1 : Q1D;
+      const auto J = Reshape(geom->J.Read(), J1D,J1D,2,2,NE);
       const auto C = const_c ? Reshape(coeff.Read(), 1,1,1) :
                      Reshape(coeff.Read(), Q1D,Q1D,NE);
       auto v = Reshape(pa_data.Write(), Q1D,Q1D, NE);
@@ -102,10 +240,11 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
          {
             MFEM_FOREACH_THREAD(qy,y,Q1D)
             {
-               const double J11 = J(qx,qy,0,0,e);
-               const double J12 = J(qx,qy,1,0,e);
-               const double J21 = J(qx,qy,0,1,e);
-               const double J22 = J(qx,qy,1,1,e);
+               const int jx = const_j ? 0 : qx, jy = const_j ? 0 : qy;
+               const double J11 = J(jx,jy,0,0,e);
+               const double J12 = J(jx,jy,1,0,e);
+               const double J21 = J(jx,jy,0,1,e);
+               const double J22 = J(jx,jy,1,1,e);
                const double detJ = (J11*J22)-(J21*J12);
                const double coeff = const_c ? C(0,0,0) : C(qx,qy,e);
                v(qx,qy,e) =  W(qx,qy) * coeff * detJ;
@@ -119,7 +258,8 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
       const int Q1D = quad1D;
       const bool const_c = coeff.Size() == 1;
       const auto W = Reshape(ir->GetWeights().Read(), Q1D,Q1D,Q1D);
-      const auto J = Reshape(geom->J.Read(), Q1D,Q1D,Q1D,3,3,NE);
+      const int J1D = const_j ? 1 : Q1D;
+      const auto J = Reshape(geom->J.Read(), J1D,J1D,J1D,3,3,NE);
       const auto C = const_c ? Reshape(coeff.Read(), 1,1,1,1) :
                      Reshape(coeff.Read(), Q1D,Q1D,Q1D,NE);
       auto v = Reshape(pa_data.Write(), Q1D,Q1D,Q1D,NE);
@@ -131,15 +271,17 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
             {
                MFEM_FOREACH_THREAD(qz,z,Q1D)
                {
-                  const double J11 = J(qx,qy,qz,0,0,e);
-                  const double J21 = J(qx,qy,qz,1,0,e);
-                  const double J31 = J(qx,qy,qz,2,0,e);
-                  const double J12 = J(qx,qy,qz,0,1,e);
-                  const double J22 = J(qx,qy,qz,1,1,e);
-                  const double J32 = J(qx,qy,qz,2,1,e);
-                  const double J13 = J(qx,qy,qz,0,2,e);
-                  const double J23 = J(qx,qy,qz,1,2,e);
-                  const double J33 = J(qx,qy,qz,2,2,e);
+                  const int jx = const_j ? 0 : qx, jy = const_j ? 0 : qy;
+                  const int jz = const_j ? 0 : qz;
+                  const double J11 = J(jx,jy,jz,0,0,e);
+                  const double J21 = J(jx,jy,jz,1,0,e);
+                  const double J31 = J(jx,jy,jz,2,0,e);
+                  const double J12 = J(jx,jy,jz,0,1,e);
+                  const double J22 = J(jx,jy,jz,1,1,e);
+                  const double J32 = J(jx,jy,jz,2,1,e);
+                  const double J13 = J(jx,jy,jz,0,2,e);
+                  const double J23 = J(jx,jy,jz,1,2,e);
+                  const double J33 = J(jx,jy,jz,2,2,e);
                   const double detJ = J11 * (J22 * J33 - J32 * J23) -
                   /* */               J21 * (J12 * J33 - J32 * J13) +
                   /* */               J31 * (J12 * J23 - J22 * J13);
@@ -437,6 +579,8 @@ static void PAMassAssembleDiagonal(const int dim, const int D1D,
          case 0x77: return SmemPAMassAssembleDiagonal2D<7,7,4>(NE,B,D,Y);
          case 0x88: return SmemPAMassAssembleDiagonal2D<8,8,2>(NE,B,D,Y);
          case 0x99: return SmemPAMassAssembleDiagonal2D<9,9,2>(NE,B,D,Y);
+         case 0xAA: return SmemPAMassAssembleDiagonal2D<10,10,1>(NE,B,D,Y);
+         case 0xBB: return SmemPAMassAssembleDiagonal2D<11,11,1>(NE,B,D,Y);
          default:   return PAMassAssembleDiagonal2D(NE,B,D,Y,D1D,Q1D);
       }
    }
@@ -451,21 +595,87 @@ static void PAMassAssembleDiagonal(const int dim, const int D1D,
          case 0x67: return SmemPAMassAssembleDiagonal3D<6,7>(NE,B,D,Y);
          case 0x78: return SmemPAMassAssembleDiagonal3D<7,8>(NE,B,D,Y);
          case 0x89: return SmemPAMassAssembleDiagonal3D<8,9>(NE,B,D,Y);
+         case 0x9A: return SmemPAMassAssembleDiagonal3D<9,10>(NE,B,D,Y);
+         case 0xAB: return SmemPAMassAssembleDiagonal3D<10,11>(NE,B,D,Y);
+         case 0xBC: return SmemPAMassAssembleDiagonal3D<11,12>(NE,B,D,Y);
          default:   return PAMassAssembleDiagonal3D(NE,B,D,Y,D1D,Q1D);
       }
    }
    MFEM_ABORT("Unknown kernel.");
 }
 
+// PA Mass Diagonal kernel for non-tensor elements, e.g. simplices
+static void PAMassAssembleDiagonalSimplex(const int ND,
+                                          const int NQ,
+                                          const int NE,
+                                          const Array<double> &bt,
+                                          const Vector &d,
+                                          Vector &y)
+{
+   const auto Bt = Reshape(bt.Read(), ND,NQ);
+   const auto D = Reshape(d.Read(), NQ,NE);
+   auto Y = Reshape(y.ReadWrite(), ND,NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double Dq = D(q,e);
+         for (int dof = 0; dof < ND; ++dof)
+         {
+            Y(dof,e) += Bt(dof,q) * Bt(dof,q) * Dq;
+         }
+      }
+   });
+}
+
 void MassIntegrator::AssembleDiagonalPA(Vector &diag)
 {
    if (DeviceCanUseCeed())
    {
       CeedAssembleDiagonal(ceedDataPtr, diag);
    }
+   else if (pa_groups.Size() > 0)
+   {
+      for (int g = 0; g < pa_groups.Size(); g++)
+      {
+         const PAElementGroup &grp = pa_groups[g];
+         if (grp.ne == 0) { continue; }
+         const DofToQuad &m = *grp.maps;
+         const int ND = m.FE->GetDof(), NQ = m.IntRule->GetNPoints();
+         Vector d, y;
+         d.MakeRef(pa_data, grp.pa_offset, grp.ne * NQ);
+         y.MakeRef(diag, grp.e_offset, grp.ne * ND);
+         if (m.mode == DofToQuad::FULL)
+         {
+            PAMassAssembleDiagonalSimplex(m.ndof, m.nqpt, grp.ne, m.Bt, d, y);
+         }
+         else
+         {
+            PAMassAssembleDiagonal(dim, m.ndof, m.nqpt, grp.ne, m.B, d, y);
+         }
+      }
+   }
    else
    {
-      PAMassAssembleDiagonal(dim, dofs1D, quad1D, ne, maps->B, pa_data, diag);
+      // The diagonal kernels use double precision data at all points
+      Vector d_tmp;
+      if (pa_affine)
+      {
+         PAExpandAffineQuadratureData(nq, 1, ne, pa_weights, geom->detJ, d_tmp);
+      }
+      else if (pa_data_single.Size() > 0)
+      {
+         PAConvertQuadratureData(pa_data_single, d_tmp);
+      }
+      const Vector &d = (d_tmp.Size() > 0) ? d_tmp : pa_data;
+      if (maps->mode == DofToQuad::FULL)
+      {
+         PAMassAssembleDiagonalSimplex(dofs1D, quad1D, ne, maps->Bt, d, diag);
+      }
+      else
+      {
+         PAMassAssembleDiagonal(dim, dofs1D, quad1D, ne, maps->B, d, diag);
+      }
    }
 }
 
@@ -562,23 +772,30 @@ static void OccaPAMassApply3D(const int D1D,
 }
 #endif // MFEM_USE_OCCA
 
-template<int T_D1D = 0, int T_Q1D = 0>
+// PA Mass Apply 2D kernel. Without the weights @a w_, the quadrature data
+// @a d_ has one value per quadrature point. With @a w_, e.g. on affine elements
+// with a constant coefficient, @a d_ has one value per element, i.e. its stride
+// between the quadrature points is 0, and it is multiplied by the weights here.
+template<int T_D1D = 0, int T_Q1D = 0, typename QData = Vector>
 static void PAMassApply2D(const int NE,
                           const Array<double> &b_,
                           const Array<double> &bt_,
-                          const Vector &d_,
+                          const QData &d_,
                           const Vector &x_,
                           Vector &y_,
                           const int d1d = 0,
-                          const int q1d = 0)
+                          const int q1d = 0,
+                          const Array<double> *w_ = NULL)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
    MFEM_VERIFY(D1D <= MAX_D1D, "");
    MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int QS = w_ ? 0 : 1;
    auto B = Reshape(b_.Read(), Q1D, D1D);
    auto Bt = Reshape(bt_.Read(), D1D, Q1D);
-   auto D = Reshape(d_.Read(), Q1D, Q1D, NE);
+   auto W = Reshape(w_ ? w_->Read() : NULL, Q1D, Q1D);
+   auto D = Reshape(d_.Read(), QS ? Q1D*Q1D : 1, NE);
    auto X = Reshape(x_.Read(), D1D, D1D, NE);
    auto Y = Reshape(y_.ReadWrite(), D1D, D1D, NE);
    MFEM_FORALL(e, NE,
@@ -624,7 +841,8 @@ static void PAMassApply2D(const int NE,
       {
          for (int qx = 0; qx < Q1D; ++qx)
          {
-            sol_xy[qy][qx] *= D(qx,qy,e);
+            const double w = QS ? 1.0 : W(qx,qy);
+            sol_xy[qy][qx] *= w * D((qx + qy * Q1D) * QS, e);
          }
       }
       for (int qy = 0; qy < Q1D; ++qy)
@@ -654,11 +872,12 @@ static void PAMassApply2D(const int NE,
    });
 }
 
-template<int T_D1D = 0, int T_Q1D = 0, int T_NBZ = 0>
+template<int T_D1D = 0, int T_Q1D = 0, int T_NBZ = 0,
+         typename QData = Vector>
 static void SmemPAMassApply2D(const int NE,
                               const Array<double> &b_,
                               const Array<double> &bt_,
-                              const Vector &d_,
+                              const QData &d_,
                               const Vector &x_,
                               Vector &y_,
                               const int d1d = 0,
@@ -777,23 +996,27 @@ static void SmemPAMassApply2D(const int NE,
    });
 }
 
-template<int T_D1D = 0, int T_Q1D = 0>
+// PA Mass Apply 3D kernel, see PAMassApply2D for the optional weights @a w_.
+template<int T_D1D = 0, int T_Q1D = 0, typename QData = Vector>
 static void PAMassApply3D(const int NE,
                           const Array<double> &b_,
                           const Array<double> &bt_,
-                          const Vector &d_,
+                          const QData &d_,
                           const Vector &x_,
                           Vector &y_,
                           const int d1d = 0,
-                          const int q1d = 0)
+                          const int q1d = 0,
+                          const Array<double> *w_ = NULL)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
    MFEM_VERIFY(D1D <= MAX_D1D, "");
    MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int QS = w_ ? 0 : 1;
    auto B = Reshape(b_.Read(), Q1D, D1D);
    auto Bt = Reshape(bt_.Read(), D1D, Q1D);
-   auto D = Reshape(d_.Read(), Q1D, Q1D, Q1D, NE);
+   auto W = Reshape(w_ ? w_->Read() : NULL, Q1D, Q1D, Q1D);
+   auto D = Reshape(d_.Read(), QS ? Q1D*Q1D*Q1D : 1, NE);
    auto X = Reshape(x_.Read(), D1D, D1D, D1D, NE);
    auto Y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, NE);
    MFEM_FORALL(e, NE,
@@ -865,7 +1088,9 @@ static void PAMassApply3D(const int NE,
          {
             for (int qx = 0; qx < Q1D; ++qx)
             {
-               sol_xyz[qz][qy][qx] *= D(qx,qy,qz,e);
+               const int q = (qx + (qy + qz * Q1D) * Q1D) * QS;
+               const double w = QS ? 1.0 : W(qx,qy,qz);
+               sol_xyz[qz][qy][qx] *= w * D(q,e);
             }
          }
       }
@@ -918,11 +1143,11 @@ static void PAMassApply3D(const int NE,
    });
 }
 
-template<int T_D1D = 0, int T_Q1D = 0>
+template<int T_D1D = 0, int T_Q1D = 0, typename QData = Vector>
 static void SmemPAMassApply3D(const int NE,
                               const Array<double> &b_,
                               const Array<double> &bt_,
-                              const Vector &d_,
+                              const QData &d_,
                               const Vector &x_,
                               Vector &y_,
                               const int d1d = 0,
@@ -1145,6 +1370,156 @@ static void SmemPAMassApply3D(const int NE,
    });
 }
 
+// PA Mass Apply 2D kernel for Backend::CPU_SIMD
+template<int D1D, int Q1D>
+static void SimdPAMassApply2D(const int NE,
+                              const Array<double> &b_,
+                              const Vector &d_,
+                              const Vector &x_,
+                              Vector &y_)
+{
+   typedef internal::PASimdTraits::vreal_t vreal_t;
+   constexpr int VS = vreal_t::size;
+   constexpr int ND = D1D*D1D;
+   constexpr int NQ = Q1D*Q1D;
+   const auto b = Reshape(b_.HostRead(), Q1D, D1D);
+   const double *d = d_.HostRead();
+   const double *x = x_.HostRead();
+   double *y = y_.HostReadWrite();
+   double B[Q1D][D1D];
+   for (int dx = 0; dx < D1D; ++dx)
+   {
+      for (int qx = 0; qx < Q1D; ++qx) { B[qx][dx] = b(qx,dx); }
+   }
+   vreal_t X[D1D][D1D], Y[D1D][D1D], D[Q1D][Q1D], U[Q1D][Q1D];
+   for (int e = 0; e < NE; e += VS)
+   {
+      const int nl = (NE - e < VS) ? NE - e : VS;
+      internal::PASimdLoad(ND, nl, x + e*ND, &X[0][0]);
+      internal::PASimdLoad(NQ, nl, d + e*NQ, &D[0][0]);
+      internal::PASimdEval2D(B, X, U);
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx) { U[qy][qx] *= D[qy][qx]; }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx) { Y[dy][dx] = 0.0; }
+      }
+      internal::PASimdEvalT2D(B, U, Y);
+      internal::PASimdAddStore(ND, nl, &Y[0][0], y + e*ND);
+   }
+}
+
+// PA Mass Apply 3D kernel for Backend::CPU_SIMD
+template<int D1D, int Q1D>
+static void SimdPAMassApply3D(const int NE,
+                              const Array<double> &b_,
+                              const Vector &d_,
+                              const Vector &x_,
+                              Vector &y_)
+{
+   typedef internal::PASimdTraits::vreal_t vreal_t;
+   constexpr int VS = vreal_t::size;
+   constexpr int ND = D1D*D1D*D1D;
+   constexpr int NQ = Q1D*Q1D*Q1D;
+   const auto b = Reshape(b_.HostRead(), Q1D, D1D);
+   const double *d = d_.HostRead();
+   const double *x = x_.HostRead();
+   double *y = y_.HostReadWrite();
+   double B[Q1D][D1D];
+   for (int dx = 0; dx < D1D; ++dx)
+   {
+      for (int qx = 0; qx < Q1D; ++qx) { B[qx][dx] = b(qx,dx); }
+   }
+   vreal_t X[D1D][D1D][D1D], Y[D1D][D1D][D1D];
+   vreal_t D[Q1D][Q1D][Q1D], U[Q1D][Q1D][Q1D];
+   for (int e = 0; e < NE; e += VS)
+   {
+      const int nl = (NE - e < VS) ? NE - e : VS;
+      internal::PASimdLoad(ND, nl, x + e*ND, &X[0][0][0]);
+      internal::PASimdLoad(NQ, nl, d + e*NQ, &D[0][0][0]);
+      internal::PASimdEval3D(B, X, U);
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               U[qz][qy][qx] *= D[qz][qy][qx];
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx) { Y[dz][dy][dx] = 0.0; }
+         }
+      }
+      internal::PASimdEvalT3D(B, U, Y);
+      internal::PASimdAddStore(ND, nl, &Y[0][0][0], y + e*ND);
+   }
+}
+
+// Dispatch the Backend::CPU_SIMD PA Mass Apply kernels. Returns false if no
+// kernel is available for the given sizes.
+static bool SimdPAMassApply(const int dim,
+                            const int D1D,
+                            const int Q1D,
+                            const int NE,
+                            const Array<double> &B,
+                            const Vector &D,
+                            const Vector &X,
+                            Vector &Y)
+{
+   const int id = (D1D << 4) | Q1D;
+   if (dim == 2)
+   {
+      switch (id)
+      {
+         case 0x22: SimdPAMassApply2D<2,2>(NE,B,D,X,Y); return true;
+         case 0x23: SimdPAMassApply2D<2,3>(NE,B,D,X,Y); return true;
+         case 0x33: SimdPAMassApply2D<3,3>(NE,B,D,X,Y); return true;
+         case 0x34: SimdPAMassApply2D<3,4>(NE,B,D,X,Y); return true;
+         case 0x44: SimdPAMassApply2D<4,4>(NE,B,D,X,Y); return true;
+         case 0x45: SimdPAMassApply2D<4,5>(NE,B,D,X,Y); return true;
+         case 0x55: SimdPAMassApply2D<5,5>(NE,B,D,X,Y); return true;
+         case 0x56: SimdPAMassApply2D<5,6>(NE,B,D,X,Y); return true;
+         case 0x66: SimdPAMassApply2D<6,6>(NE,B,D,X,Y); return true;
+         case 0x67: SimdPAMassApply2D<6,7>(NE,B,D,X,Y); return true;
+         case 0x77: SimdPAMassApply2D<7,7>(NE,B,D,X,Y); return true;
+         case 0x78: SimdPAMassApply2D<7,8>(NE,B,D,X,Y); return true;
+         case 0x88: SimdPAMassApply2D<8,8>(NE,B,D,X,Y); return true;
+         case 0x89: SimdPAMassApply2D<8,9>(NE,B,D,X,Y); return true;
+         case 0x99: SimdPAMassApply2D<9,9>(NE,B,D,X,Y); return true;
+         default:   return false;
+      }
+   }
+   if (dim == 3)
+   {
+      switch (id)
+      {
+         case 0x22: SimdPAMassApply3D<2,2>(NE,B,D,X,Y); return true;
+         case 0x23: SimdPAMassApply3D<2,3>(NE,B,D,X,Y); return true;
+         case 0x33: SimdPAMassApply3D<3,3>(NE,B,D,X,Y); return true;
+         case 0x34: SimdPAMassApply3D<3,4>(NE,B,D,X,Y); return true;
+         case 0x44: SimdPAMassApply3D<4,4>(NE,B,D,X,Y); return true;
+         case 0x45: SimdPAMassApply3D<4,5>(NE,B,D,X,Y); return true;
+         case 0x55: SimdPAMassApply3D<5,5>(NE,B,D,X,Y); return true;
+         case 0x56: SimdPAMassApply3D<5,6>(NE,B,D,X,Y); return true;
+         case 0x66: SimdPAMassApply3D<6,6>(NE,B,D,X,Y); return true;
+         case 0x67: SimdPAMassApply3D<6,7>(NE,B,D,X,Y); return true;
+         case 0x77: SimdPAMassApply3D<7,7>(NE,B,D,X,Y); return true;
+         case 0x78: SimdPAMassApply3D<7,8>(NE,B,D,X,Y); return true;
+         case 0x88: SimdPAMassApply3D<8,8>(NE,B,D,X,Y); return true;
+         case 0x89: SimdPAMassApply3D<8,9>(NE,B,D,X,Y); return true;
+         default:   return false;
+      }
+   }
+   return false;
+}
+
 static void PAMassApply(const int dim,
                         const int D1D,
                         const int Q1D,
@@ -1169,6 +1544,8 @@ static void PAMassApply(const int dim,
       MFEM_ABORT("OCCA PA Mass Apply unknown kernel!");
    }
 #endif // MFEM_USE_OCCA
+   if (internal::DeviceCanUsePASimd() &&
+       SimdPAMassApply(dim,D1D,Q1D,NE,B,D,X,Y)) { return; }
    const int id = (D1D << 4) | Q1D;
    if (dim == 2)
    {
@@ -1187,6 +1564,8 @@ static void PAMassApply(const int dim,
          case 0x77: return SmemPAMassApply2D<7,7,4>(NE,B,Bt,D,X,Y);
          case 0x88: return SmemPAMassApply2D<8,8,2>(NE,B,Bt,D,X,Y);
          case 0x99: return SmemPAMassApply2D<9,9,2>(NE,B,Bt,D,X,Y);
+         case 0xAA: return SmemPAMassApply2D<10,10,1>(NE,B,Bt,D,X,Y);
+         case 0xBB: return SmemPAMassApply2D<11,11,1>(NE,B,Bt,D,X,Y);
          default:   return PAMassApply2D(NE,B,Bt,D,X,Y,D1D,Q1D);
       }
    }
@@ -1207,6 +1586,8 @@ static void PAMassApply(const int dim,
          case 0x78: return SmemPAMassApply3D<7,8>(NE,B,Bt,D,X,Y);
          case 0x89: return SmemPAMassApply3D<8,9>(NE,B,Bt,D,X,Y);
          case 0x9A: return SmemPAMassApply3D<9,10>(NE,B,Bt,D,X,Y);
+         case 0xAB: return SmemPAMassApply3D<10,11>(NE,B,Bt,D,X,Y);
+         case 0xBC: return SmemPAMassApply3D<11,12>(NE,B,Bt,D,X,Y);
          default:   return PAMassApply3D(NE,B,Bt,D,X,Y,D1D,Q1D);
       }
    }
@@ -1214,12 +1595,444 @@ static void PAMassApply(const int dim,
    MFEM_ABORT("Unknown kernel.");
 }
 
+// PA Mass Apply kernel for non-tensor elements, e.g. simplices, see
+// PAMassApply2D for the optional weights @a w.
+template<typename QData = Vector>
+static void PAMassApplySimplex(const int ND,
+                               const int NQ,
+                               const int NE,
+                               const Array<double> &bt,
+                               const QData &d,
+                               const Vector &x,
+                               Vector &y,
+                               const Array<double> *w = NULL)
+{
+   const int QS = w ? 0 : 1;
+   const auto Bt = Reshape(bt.Read(), ND,NQ);
+   const auto W = w ? w->Read() : NULL;
+   const auto D = Reshape(d.Read(), QS ? NQ : 1, NE);
+   const auto X = Reshape(x.Read(), ND,NE);
+   auto Y = Reshape(y.ReadWrite(), ND,NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         double u = 0.0;
+         for (int dof = 0; dof < ND; ++dof) { u += Bt(dof,q) * X(dof,e); }
+         u *= (QS ? 1.0 : W[q]) * D(q*QS,e);
+         for (int dof = 0; dof < ND; ++dof) { Y(dof,e) += Bt(dof,q) * u; }
+      }
+   });
+}
+
+// PA Mass Apply 2D kernel for Bernstein triangles, sum-factorized in the
+// collapsed coordinates, see PACollapsedBasis. With @a affine, the quadrature
+// data @a d has one value per element and the weights @a w are applied here.
+template<typename QData = Vector>
+static void PAMassApplyCollapsed2D(const int NE,
+                                   const PACollapsedBasis &basis,
+                                   const bool affine,
+                                   const Array<double> &w,
+                                   const QData &d,
+                                   const Vector &x,
+                                   Vector &y)
+{
+   const int P = basis.order;
+   const int D1D = P + 1;
+   const int Q1D = basis.Q1D;
+   const int ND = (D1D*(D1D+1))/2;
+   const auto B = Reshape(basis.B.Read(), Q1D,D1D,D1D);
+   const auto map = basis.dof_map.Read();
+   const auto W = w.Read();
+   const auto D = Reshape(d.Read(), affine ? 1 : Q1D*Q1D, NE);
+   const auto X = Reshape(x.Read(), ND,NE);
+   auto Y = Reshape(y.ReadWrite(), ND,NE);
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int max_D1D = MAX_D1D;
+      constexpr int max_Q1D = MAX_Q1D;
+      double t[max_D1D][max_Q1D];
+      double u[max_Q1D][max_Q1D];
+      for (int j = 0, o = 0; j < D1D; o += D1D-j, j++)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            double s = 0.0;
+            for (int i = 0; i < D1D-j; ++i)
+            {
+               s += B(qa,i,P-j) * X(map[o+i],e);
+            }
+            t[j][qa] = s;
+         }
+      }
+      for (int qb = 0; qb < Q1D; ++qb)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            const int q = qa + Q1D*qb;
+            double s = 0.0;
+            for (int j = 0; j < D1D; ++j) { s += B(qb,j,P) * t[j][qa]; }
+            u[qb][qa] = s * (affine ? W[q] * D(0,e) : D(q,e));
+         }
+      }
+      for (int j = 0; j < D1D; ++j)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            double s = 0.0;
+            for (int qb = 0; qb < Q1D; ++qb) { s += B(qb,j,P) * u[qb][qa]; }
+            t[j][qa] = s;
+         }
+      }
+      for (int j = 0, o = 0; j < D1D; o += D1D-j, j++)
+      {
+         for (int i = 0; i < D1D-j; ++i)
+         {
+            double s = 0.0;
+            for (int qa = 0; qa < Q1D; ++qa) { s += B(qa,i,P-j) * t[j][qa]; }
+            Y(map[o+i],e) += s;
+         }
+      }
+   });
+}
+
+// PA Mass Apply 3D kernel for Bernstein tetrahedra, see PAMassApplyCollapsed2D.
+template<typename QData = Vector>
+static void PAMassApplyCollapsed3D(const int NE,
+                                   const PACollapsedBasis &basis,
+                                   const bool affine,
+                                   const Array<double> &w,
+                                   const QData &d,
+                                   const Vector &x,
+                                   Vector &y)
+{
+   const int P = basis.order;
+   const int D1D = P + 1;
+   const int Q1D = basis.Q1D;
+   const int ND = (D1D*(D1D+1)*(D1D+2))/6;
+   const auto B = Reshape(basis.B.Read(), Q1D,D1D,D1D);
+   const auto map = basis.dof_map.Read();
+   const auto W = w.Read();
+   const auto D = Reshape(d.Read(), affine ? 1 : Q1D*Q1D*Q1D, NE);
+   const auto X = Reshape(x.Read(), ND,NE);
+   auto Y = Reshape(y.ReadWrite(), ND,NE);
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int max_D1D = MAX_D1D;
+      constexpr int max_Q1D = MAX_Q1D;
+      double t1[max_D1D][max_D1D][max_Q1D];
+      double t2[max_D1D][max_Q1D][max_Q1D];
+      double u[max_Q1D][max_Q1D][max_Q1D];
+      for (int k = 0, o = 0; k < D1D; k++)
+      {
+         for (int j = 0; j < D1D-k; o += D1D-k-j, j++)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               double s = 0.0;
+               for (int i = 0; i < D1D-k-j; ++i)
+               {
+                  s += B(qa,i,P-k-j) * X(map[o+i],e);
+               }
+               t1[k][j][qa] = s;
+            }
+         }
+      }
+      for (int k = 0; k < D1D; ++k)
+      {
+         for (int qb = 0; qb < Q1D; ++qb)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               double s = 0.0;
+               for (int j = 0; j < D1D-k; ++j)
+               {
+                  s += B(qb,j,P-k) * t1[k][j][qa];
+               }
+               t2[k][qb][qa] = s;
+            }
+         }
+      }
+      for (int qc = 0; qc < Q1D; ++qc)
+      {
+         for (int qb = 0; qb < Q1D; ++qb)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               const int q = qa + Q1D*(qb + Q1D*qc);
+               double s = 0.0;
+               for (int k = 0; k < D1D; ++k) { s += B(qc,k,P) * t2[k][qb][qa]; }
+               u[qc][qb][qa] = s * (affine ? W[q] * D(0,e) : D(q,e));
+            }
+         }
+      }
+      for (int k = 0; k < D1D; ++k)
+      {
+         for (int qb = 0; qb < Q1D; ++qb)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               double s = 0.0;
+               for (int qc = 0; qc < Q1D; ++qc)
+               {
+                  s += B(qc,k,P) * u[qc][qb][qa];
+               }
+               t2[k][qb][qa] = s;
+            }
+         }
+      }
+      for (int k = 0; k < D1D; ++k)
+      {
+         for (int j = 0; j < D1D-k; ++j)
+         {
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               double s = 0.0;
+               for (int qb = 0; qb < Q1D; ++qb)
+               {
+                  s += B(qb,j,P-k) * t2[k][qb][qa];
+               }
+               t1[k][j][qa] = s;
+            }
+         }
+      }
+      for (int k = 0, o = 0; k < D1D; k++)
+      {
+         for (int j = 0; j < D1D-k; o += D1D-k-j, j++)
+         {
+            for (int i = 0; i < D1D-k-j; ++i)
+            {
+               double s = 0.0;
+               for (int qa = 0; qa < Q1D; ++qa)
+               {
+                  s += B(qa,i,P-k-j) * t1[k][j][qa];
+               }
+               Y(map[o+i],e) += s;
+            }
+         }
+      }
+   });
+}
+
+// With the weights @a w, e.g. on affine elements, @a d has one value per
+// element, see PAMassApplyCollapsed2D.
+template<typename QData = Vector>
+static void PAMassApplyCollapsed(const int dim,
+                                 const int NE,
+                                 const PACollapsedBasis &basis,
+                                 const QData &d,
+                                 const Vector &x,
+                                 Vector &y,
+                                 const Array<double> *w = NULL)
+{
+   const bool affine = w != NULL;
+   const Array<double> &W = affine ? *w : basis.ir->GetWeights();
+   if (dim == 2)
+   {
+      return PAMassApplyCollapsed2D(NE, basis, affine, W, d, x, y);
+   }
+   if (dim == 3)
+   {
+      return PAMassApplyCollapsed3D(NE, basis, affine, W, d, x, y);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Mass Apply kernel for affine elements with a constant coefficient, where
+// the quadrature data is one value per element, multiplied by the weights W.
+static void PAMassApplyAffine(const int dim,
+                              const int D1D,
+                              const int Q1D,
+                              const int NE,
+                              const Array<double> &B,
+                              const Array<double> &Bt,
+                              const Array<double> &W,
+                              const Vector &D,
+                              const Vector &X,
+                              Vector &Y)
+{
+   const int id = (D1D << 4) | Q1D;
+   if (dim == 2)
+   {
+      switch (id)
+      {
+         case 0x22: return PAMassApply2D<2,2>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x23: return PAMassApply2D<2,3>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x33: return PAMassApply2D<3,3>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x34: return PAMassApply2D<3,4>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x44: return PAMassApply2D<4,4>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x45: return PAMassApply2D<4,5>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x55: return PAMassApply2D<5,5>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x56: return PAMassApply2D<5,6>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x66: return PAMassApply2D<6,6>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x77: return PAMassApply2D<7,7>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x88: return PAMassApply2D<8,8>(NE,B,Bt,D,X,Y,0,0,&W);
+         default:   return PAMassApply2D(NE,B,Bt,D,X,Y,D1D,Q1D,&W);
+      }
+   }
+   if (dim == 3)
+   {
+      switch (id)
+      {
+         case 0x23: return PAMassApply3D<2,3>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x34: return PAMassApply3D<3,4>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x45: return PAMassApply3D<4,5>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x56: return PAMassApply3D<5,6>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x67: return PAMassApply3D<6,7>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x78: return PAMassApply3D<7,8>(NE,B,Bt,D,X,Y,0,0,&W);
+         case 0x89: return PAMassApply3D<8,9>(NE,B,Bt,D,X,Y,0,0,&W);
+         default:   return PAMassApply3D(NE,B,Bt,D,X,Y,D1D,Q1D,&W);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Mass Apply kernel with single precision quadrature data: the values at
+// the quadrature points are still computed and accumulated in double precision.
+static void PAMassApplyMixedPrecision(const int dim,
+                                      const int D1D,
+                                      const int Q1D,
+                                      const int NE,
+                                      const Array<double> &B,
+                                      const Array<double> &Bt,
+                                      const Array<float> &D,
+                                      const Vector &X,
+                                      Vector &Y)
+{
+   const int id = (D1D << 4) | Q1D;
+   if (dim == 2)
+   {
+      switch (id)
+      {
+         case 0x22: return SmemPAMassApply2D<2,2,16>(NE,B,Bt,D,X,Y);
+         case 0x33: return SmemPAMassApply2D<3,3,16>(NE,B,Bt,D,X,Y);
+         case 0x44: return SmemPAMassApply2D<4,4,8>(NE,B,Bt,D,X,Y);
+         case 0x55: return SmemPAMassApply2D<5,5,8>(NE,B,Bt,D,X,Y);
+         case 0x66: return SmemPAMassApply2D<6,6,4>(NE,B,Bt,D,X,Y);
+         case 0x77: return SmemPAMassApply2D<7,7,4>(NE,B,Bt,D,X,Y);
+         case 0x88: return SmemPAMassApply2D<8,8,2>(NE,B,Bt,D,X,Y);
+         default:   return PAMassApply2D(NE,B,Bt,D,X,Y,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch (id)
+      {
+         case 0x23: return SmemPAMassApply3D<2,3>(NE,B,Bt,D,X,Y);
+         case 0x34: return SmemPAMassApply3D<3,4>(NE,B,Bt,D,X,Y);
+         case 0x45: return SmemPAMassApply3D<4,5>(NE,B,Bt,D,X,Y);
+         case 0x56: return SmemPAMassApply3D<5,6>(NE,B,Bt,D,X,Y);
+         case 0x67: return SmemPAMassApply3D<6,7>(NE,B,Bt,D,X,Y);
+         case 0x78: return SmemPAMassApply3D<7,8>(NE,B,Bt,D,X,Y);
+         case 0x89: return SmemPAMassApply3D<8,9>(NE,B,Bt,D,X,Y);
+         default:   return PAMassApply3D(NE,B,Bt,D,X,Y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void MassIntegrator::AssemblePAMixedPrecision(const FiniteElementSpace &fes)
+{
+   AssemblePA(fes);
+   pa_mixed_precision = true;
+   if (fes.GetNE() == 0 || DeviceCanUseCeed() || pa_groups.Size() > 0 ||
+       pa_affine) { return; }
+   PAConvertQuadratureData(pa_data, pa_data_single);
+   pa_data.Destroy();
+}
+
+void MassIntegrator::UpdateCoefficient(Coefficient &q)
+{
+   MFEM_VERIFY(fespace, "AssemblePA() must be called first");
+   Q = &q;
+   if (DeviceCanUseCeed() || pa_groups.Size() > 0 || !maps)
+   {
+      return pa_mixed_precision ? AssemblePAMixedPrecision(*fespace) :
+             AssemblePA(*fespace);
+   }
+   // Only the quadrature data is recomputed, from the cached geometric factors
+   pa_data_single.DeleteAll();
+   SetupPAQuadratureData();
+   if (pa_mixed_precision && !pa_affine)
+   {
+      PAConvertQuadratureData(pa_data, pa_data_single);
+      pa_data.Destroy();
+   }
+}
+
 void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
 {
    if (DeviceCanUseCeed())
    {
       CeedAddMult(ceedDataPtr, x, y);
    }
+   else if (pa_groups.Size() > 0)
+   {
+      for (int g = 0; g < pa_groups.Size(); g++)
+      {
+         const PAElementGroup &grp = pa_groups[g];
+         if (grp.ne == 0) { continue; }
+         const DofToQuad &m = *grp.maps;
+         const int ND = m.FE->GetDof(), NQ = m.IntRule->GetNPoints();
+         Vector d, xg, yg;
+         d.MakeRef(const_cast<Vector&>(pa_data), grp.pa_offset, grp.ne * NQ);
+         xg.MakeRef(const_cast<Vector&>(x), grp.e_offset, grp.ne * ND);
+         yg.MakeRef(y, grp.e_offset, grp.ne * ND);
+         if (m.mode == DofToQuad::FULL)
+         {
+            PAMassApplySimplex(m.ndof, m.nqpt, grp.ne, m.Bt, d, xg, yg);
+         }
+         else
+         {
+            PAMassApply(dim, m.ndof, m.nqpt, grp.ne, m.B, m.Bt, d, xg, yg);
+         }
+      }
+   }
+   else if (pa_collapsed.order >= 0)
+   {
+      if (pa_data_single.Size() > 0)
+      {
+         PAMassApplyCollapsed(dim, ne, pa_collapsed, pa_data_single, x, y);
+      }
+      else if (pa_affine)
+      {
+         PAMassApplyCollapsed(dim, ne, pa_collapsed, geom->detJ, x, y,
+                              &pa_weights);
+      }
+      else
+      {
+         PAMassApplyCollapsed(dim, ne, pa_collapsed, pa_data, x, y);
+      }
+   }
+   else if (pa_data_single.Size() > 0)
+   {
+      if (maps->mode == DofToQuad::FULL)
+      {
+         PAMassApplySimplex(dofs1D, quad1D, ne, maps->Bt, pa_data_single, x, y);
+      }
+      else
+      {
+         PAMassApplyMixedPrecision(dim, dofs1D, quad1D, ne, maps->B, maps->Bt,
+                                   pa_data_single, x, y);
+      }
+   }
+   else if (pa_affine)
+   {
+      if (maps->mode == DofToQuad::FULL)
+      {
+         PAMassApplySimplex(dofs1D, quad1D, ne, maps->Bt, geom->detJ, x, y,
+                            &pa_weights);
+      }
+      else
+      {
+         PAMassApplyAffine(dim, dofs1D, quad1D, ne, maps->B, maps->Bt,
+                           pa_weights, geom->detJ, x, y);
+      }
+   }
+   else if (maps->mode == DofToQuad::FULL)
+   {
+      PAMassApplySimplex(dofs1D, quad1D, ne, maps->Bt, pa_data, x, y);
+   }
    else
    {
       PAMassApply(dim, dofs1D, quad1D, ne, maps->B, maps->Bt, pa_data, x, y);
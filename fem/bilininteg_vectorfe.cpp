@@ -88,6 +88,36 @@ void SmemPAHcurlMassApply3D(const int D1D,
                             const Vector &x,
                             Vector &y);
 
+void PAHcurlHdivBasis(const int dim,
+                      const int D1D,
+                      const int Q1D,
+                      const bool hdiv,
+                      const bool curl,
+                      const Array<double> &bo,
+                      const Array<double> &bc,
+                      const Array<double> &gc,
+                      Array<double> &basis);
+
+void PAHcurlHdivExpandQuadData(const int VDIM,
+                               const int NQ,
+                               const int NE,
+                               const int ncomp,
+                               const bool qfirst,
+                               const bool row_major,
+                               const Vector &op,
+                               Vector &d);
+
+void PAHcurlHdivAssembleEA(const int ND,
+                           const int NQ,
+                           const int NE,
+                           const int TC,
+                           const int RC,
+                           const Array<double> &test_basis,
+                           const Array<double> &trial_basis,
+                           const Vector &d,
+                           Vector &ea_data,
+                           const bool add);
+
 void PAHdivSetup2D(const int Q1D,
                    const int NE,
                    const Array<double> &w,
@@ -102,6 +132,14 @@ void PAHdivSetup3D(const int Q1D,
                    Vector &_coeff,
                    Vector &op);
 
+void PAHdivSetupSimplex(const int dim,
+                        const int NQ,
+                        const int NE,
+                        const Array<double> &w,
+                        const Vector &j,
+                        Vector &_coeff,
+                        Vector &op);
+
 void PAHcurlH1Apply2D(const int D1D,
                       const int Q1D,
                       const int NE,
@@ -719,23 +757,28 @@ void VectorFEMassIntegrator::AssemblePA(const FiniteElementSpace &fes)
 void VectorFEMassIntegrator::AssemblePA(const FiniteElementSpace &trial_fes,
                                         const FiniteElementSpace &test_fes)
 {
-   // Assumes tensor-product elements
+   // Assumes tensor-product elements or, with the full (non-tensor) DofToQuad
+   // maps, simplices
    Mesh *mesh = trial_fes.GetMesh();
 
    const FiniteElement *trial_fel = trial_fes.GetFE(0);
    const VectorTensorFiniteElement *trial_el =
       dynamic_cast<const VectorTensorFiniteElement*>(trial_fel);
-   MFEM_VERIFY(trial_el != NULL, "Only VectorTensorFiniteElement is supported!");
 
    const FiniteElement *test_fel = test_fes.GetFE(0);
    const VectorTensorFiniteElement *test_el =
       dynamic_cast<const VectorTensorFiniteElement*>(test_fel);
-   MFEM_VERIFY(test_el != NULL, "Only VectorTensorFiniteElement is supported!");
+
+   const bool tensor = (trial_el != NULL);
+   MFEM_VERIFY(tensor == (test_el != NULL),
+               "Trial and test elements must be both tensor or non-tensor");
+   MFEM_VERIFY(tensor || trial_fel->GetRangeType() == FiniteElement::VECTOR,
+               "Only vector finite elements are supported!");
 
    const IntegrationRule *ir
-      = IntRule ? IntRule : &MassIntegrator::GetRule(*trial_el, *trial_el,
+      = IntRule ? IntRule : &MassIntegrator::GetRule(*trial_fel, *trial_fel,
                                                      *mesh->GetElementTransformation(0));
-   const int dims = trial_el->GetDim();
+   const int dims = trial_fel->GetDim();
    MFEM_VERIFY(dims == 2 || dims == 3, "");
 
    const int symmDims = (dims * (dims + 1)) / 2; // 1x1: 1, 2x2: 3, 3x3: 6
@@ -747,19 +790,29 @@ void VectorFEMassIntegrator::AssemblePA(const FiniteElementSpace &trial_fes,
    MFEM_VERIFY(ne == test_fes.GetNE(),
                "Different meshes for test and trial spaces");
    geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
-   mapsC = &trial_el->GetDofToQuad(*ir, DofToQuad::TENSOR);
-   mapsO = &trial_el->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   if (tensor)
+   {
+      mapsC = &trial_el->GetDofToQuad(*ir, DofToQuad::TENSOR);
+      mapsO = &trial_el->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+      mapsCtest = &test_el->GetDofToQuad(*ir, DofToQuad::TENSOR);
+      mapsOtest = &test_el->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   }
+   else
+   {
+      // The reference vector shapes are stored in the "closed" maps
+      mapsC = &trial_fel->GetDofToQuad(*ir, DofToQuad::FULL);
+      mapsCtest = &test_fel->GetDofToQuad(*ir, DofToQuad::FULL);
+      mapsO = mapsOtest = NULL;
+   }
    dofs1D = mapsC->ndof;
    quad1D = mapsC->nqpt;
-
-   mapsCtest = &test_el->GetDofToQuad(*ir, DofToQuad::TENSOR);
-   mapsOtest = &test_el->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
    dofs1Dtest = mapsCtest->ndof;
 
-   MFEM_VERIFY(dofs1D == mapsO->ndof + 1 && quad1D == mapsO->nqpt, "");
+   MFEM_VERIFY(!tensor || (dofs1D == mapsO->ndof + 1 &&
+                           quad1D == mapsO->nqpt), "");
 
-   trial_fetype = trial_el->GetDerivType();
-   test_fetype = test_el->GetDerivType();
+   trial_fetype = trial_fel->GetDerivType();
+   test_fetype = test_fel->GetDerivType();
 
    const int MQsymmDim = MQ ? (MQ->GetWidth() * (MQ->GetWidth() + 1)) / 2 : 0;
    const int MQfullDim = MQ ? (MQ->GetHeight() * MQ->GetWidth()) : 0;
@@ -853,7 +906,29 @@ void VectorFEMassIntegrator::AssemblePA(const FiniteElementSpace &trial_fes,
       }
    }
 
-   if (trial_curl && test_curl && dim == 3)
+   if (!tensor)
+   {
+      MFEM_VERIFY(mesh->SpaceDimension() == dim,
+                  "Surface meshes require tensor elements");
+      if (trial_curl && test_curl)
+      {
+         // J^{-T} maps the reference shapes, as for the diffusion gradients
+         PADiffusionSetupSimplex(dim, nq, coeffDim, ne, ir->GetWeights(),
+                                 geom->J, coeff, pa_data);
+      }
+      else if (trial_div && test_div)
+      {
+         MFEM_VERIFY(coeffDim == 1, "Only scalar coefficients are supported "
+                     "for H(div) on non-tensor elements");
+         PAHdivSetupSimplex(dim, nq, ne, ir->GetWeights(), geom->J,
+                            coeff, pa_data);
+      }
+      else
+      {
+         MFEM_ABORT("Mixed H(curl)-H(div) PA requires tensor elements.");
+      }
+   }
+   else if (trial_curl && test_curl && dim == 3)
    {
       PADiffusionSetup3D(quad1D, coeffDim, ne, ir->GetWeights(), geom->J,
                          coeff, pa_data);
@@ -899,6 +974,12 @@ void VectorFEMassIntegrator::AssemblePA(const FiniteElementSpace &trial_fes,
 
 void VectorFEMassIntegrator::AssembleDiagonalPA(Vector& diag)
 {
+   if (mapsC->mode == DofToQuad::FULL)
+   {
+      MFEM_VERIFY(trial_fetype == test_fetype, "Unknown kernel.");
+      return PADiffusionDiagonalSimplex(dim, dofs1D, quad1D, ne, symmetric,
+                                        mapsC->Bt, pa_data, diag);
+   }
    if (dim == 3)
    {
       if (trial_fetype == mfem::FiniteElement::CURL && test_fetype == trial_fetype)
@@ -966,6 +1047,13 @@ void VectorFEMassIntegrator::AddMultPA(const Vector &x, Vector &y) const
    const bool test_curl = (test_fetype == mfem::FiniteElement::CURL);
    const bool test_div = (test_fetype == mfem::FiniteElement::DIV);
 
+   if (mapsC->mode == DofToQuad::FULL)
+   {
+      return PADiffusionApplySimplex(dim, dofs1D, dofs1Dtest, quad1D, ne,
+                                     symmetric,
+                                     mapsC->Bt, mapsCtest->Bt, pa_data, x, y);
+   }
+
    if (dim == 3)
    {
       if (trial_curl && test_curl)
@@ -1050,6 +1138,40 @@ void VectorFEMassIntegrator::AddMultPA(const Vector &x, Vector &y) const
    }
 }
 
+void VectorFEMassIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                        Vector &ea_data,
+                                        const bool add)
+{
+   AssemblePA(fes);
+   const bool tensor = (mapsC->mode == DofToQuad::TENSOR);
+   const bool hdiv = (trial_fetype == mfem::FiniteElement::DIV);
+   MFEM_VERIFY(hdiv || trial_fetype == mfem::FiniteElement::CURL,
+               "Element assembly requires an H(curl) or H(div) space");
+   const int NQ = !tensor ? quad1D :
+                  (dim == 2) ? quad1D*quad1D : quad1D*quad1D*quad1D;
+   const int SYM = (dim*(dim+1))/2;
+   const int ncomp = pa_data.Size() / (NQ*ne);
+   MFEM_VERIFY(ncomp == SYM || (!symmetric && ncomp == dim*dim), "");
+   Array<double> vals;
+   if (tensor)
+   {
+      PAHcurlHdivBasis(dim, dofs1D, quad1D, hdiv, false, mapsO->B, mapsC->B,
+                       mapsC->B, vals);
+   }
+   else
+   {
+      // The full maps store the reference vector shapes as B(q,c,i)
+      vals.MakeRef(mapsC->B);
+   }
+   // The full matrices are stored column by column by the 2D tensor setup
+   // kernel, and row by row otherwise
+   const bool row_major = !tensor || dim == 3;
+   Vector D;
+   PAHcurlHdivExpandQuadData(dim, NQ, ne, ncomp, true, row_major, pa_data, D);
+   const int ND = vals.Size() / (NQ*dim);
+   PAHcurlHdivAssembleEA(ND, NQ, ne, dim, dim, vals, vals, D, ea_data, add);
+}
+
 void MixedVectorGradientIntegrator::AssemblePA(const FiniteElementSpace
                                                &trial_fes,
                                                const FiniteElementSpace &test_fes)
@@ -12,6 +12,7 @@
 // Implementation of Coefficient class
 
 #include "fem.hpp"
+#include "../general/forall.hpp"
 
 #include <cmath>
 #include <limits>
@@ -21,6 +22,46 @@ namespace mfem
 
 using namespace std;
 
+// Return the IntegrationRule used by all elements of the QuadratureSpace of
+// @a qf, or NULL if the elements do not share a single rule, i.e. on meshes
+// with several element geometries. The batched versions of Project() use the
+// point-wise evaluation of the base classes in the latter case.
+static const IntegrationRule *GetUniformIntRule(const QuadratureFunction &qf)
+{
+   const QuadratureSpace &qs = *qf.GetSpace();
+   Mesh *mesh = qs.GetMesh();
+   if (mesh->GetNE() == 0 ||
+       mesh->GetNumGeometries(mesh->Dimension()) != 1) { return NULL; }
+   return &qs.GetElementIntRule(0);
+}
+
+void Coefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   const QuadratureSpace &qs = *qf.GetSpace();
+   Mesh *mesh = qs.GetMesh();
+   double *values = qf.HostWrite();
+   for (int e = 0, i = 0; e < mesh->GetNE(); e++)
+   {
+      const IntegrationRule &ir = qs.GetElementIntRule(e);
+      ElementTransformation &T = *mesh->GetElementTransformation(e);
+      for (int q = 0; q < ir.GetNPoints(); q++, i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         values[i] = Eval(T, ip);
+      }
+   }
+}
+
+void ConstantCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   const double c = constant;
+   auto d_qf = qf.Write();
+   MFEM_FORALL(i, qf.Size(), d_qf[i] = c;);
+}
+
 double PWConstCoefficient::Eval(ElementTransformation & T,
                                 const IntegrationPoint & ip)
 {
@@ -28,6 +69,31 @@ double PWConstCoefficient::Eval(ElementTransformation & T,
    return (constants(att-1));
 }
 
+void PWConstCoefficient::Project(QuadratureFunction &qf)
+{
+   const IntegrationRule *ir = GetUniformIntRule(qf);
+   if (!ir) { return Coefficient::Project(qf); }
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   Mesh *mesh = qf.GetSpace()->GetMesh();
+   const int NE = mesh->GetNE();
+   const int NQ = ir->GetNPoints();
+   Array<int> attr(NE);
+   for (int e = 0; e < NE; e++)
+   {
+      attr[e] = mesh->GetAttribute(e);
+      MFEM_ASSERT(attr[e] >= 1 && attr[e] <= constants.Size(),
+                  "Invalid element attribute " << attr[e]);
+   }
+   auto A = attr.Read();
+   auto C = constants.Read();
+   auto D = Reshape(qf.Write(), NQ, NE);
+   MFEM_FORALL(i, NQ*NE,
+   {
+      const int q = i % NQ, e = i / NQ;
+      D(q,e) = C[A[e]-1];
+   });
+}
+
 double FunctionCoefficient::Eval(ElementTransformation & T,
                                  const IntegrationPoint & ip)
 {
@@ -46,12 +112,67 @@ double FunctionCoefficient::Eval(ElementTransformation & T,
    }
 }
 
+void FunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   const IntegrationRule *ir = GetUniformIntRule(qf);
+   if (!ir) { return Coefficient::Project(qf); }
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   Mesh *mesh = qf.GetSpace()->GetMesh();
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES);
+   const int NE = mesh->GetNE();
+   const int NQ = ir->GetNPoints();
+   const int sdim = mesh->SpaceDimension();
+   // The user function can only be called on the host.
+   auto X = Reshape(geom->X.HostRead(), NQ, sdim, NE);
+   auto D = Reshape(qf.HostWrite(), NQ, NE);
+   double x[3];
+   Vector transip(x, sdim);
+   for (int e = 0; e < NE; e++)
+   {
+      for (int q = 0; q < NQ; q++)
+      {
+         for (int d = 0; d < sdim; d++) { x[d] = X(q,d,e); }
+         D(q,e) = Function ? Function(transip) : TDFunction(transip, GetTime());
+      }
+   }
+}
+
 double GridFunctionCoefficient::Eval (ElementTransformation &T,
                                       const IntegrationPoint &ip)
 {
    return GridF -> GetValue (T, ip, Component);
 }
 
+void GridFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   const int vdim = GridF->FESpace()->GetVDim();
+   if (vdim == 1)
+   {
+      if (!GridF->GetQuadratureValues(*qf.GetSpace(), qf))
+      {
+         Coefficient::Project(qf);
+      }
+      return;
+   }
+   Vector q_val;
+   if (!GridF->GetQuadratureValues(*qf.GetSpace(), q_val))
+   {
+      return Coefficient::Project(qf);
+   }
+   const int NE = qf.GetSpace()->GetMesh()->GetNE();
+   const int NQ = qf.Size()/NE;
+   const int comp = Component - 1;
+   auto V = Reshape(q_val.Read(), NQ, vdim, NE);
+   auto D = Reshape(qf.Write(), NQ, NE);
+   MFEM_FORALL(i, NQ*NE,
+   {
+      const int q = i % NQ, e = i / NQ;
+      D(q,e) = V(q,comp,e);
+   });
+}
+
 double TransformedCoefficient::Eval(ElementTransformation &T,
                                     const IntegrationPoint &ip)
 {
@@ -66,6 +187,33 @@ double TransformedCoefficient::Eval(ElementTransformation &T,
    }
 }
 
+void TransformedCoefficient::Project(QuadratureFunction &qf)
+{
+   // The transformation is a host function, so only the parent coefficients
+   // are evaluated in a batched way.
+   Q1->SetTime(GetTime());
+   Q1->Project(qf);
+   double *d_qf = qf.HostReadWrite();
+   if (Q2)
+   {
+      QuadratureFunction qf2(qf.GetSpace());
+      Q2->SetTime(GetTime());
+      Q2->Project(qf2);
+      const double *d_qf2 = qf2.HostRead();
+      for (int i = 0; i < qf.Size(); i++)
+      {
+         d_qf[i] = (*Transform2)(d_qf[i], d_qf2[i]);
+      }
+   }
+   else
+   {
+      for (int i = 0; i < qf.Size(); i++)
+      {
+         d_qf[i] = (*Transform1)(d_qf[i]);
+      }
+   }
+}
+
 void DeltaCoefficient::SetDeltaCenter(const Vector& vcenter)
 {
    MFEM_VERIFY(vcenter.Size() <= 3,
@@ -101,6 +249,37 @@ void VectorCoefficient::Eval(DenseMatrix &M, ElementTransformation &T,
    }
 }
 
+void VectorCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == vdim, "Invalid QuadratureFunction dimension.");
+   const QuadratureSpace &qs = *qf.GetSpace();
+   Mesh *mesh = qs.GetMesh();
+   DenseMatrix values;
+   qf.HostReadWrite();
+   for (int e = 0; e < mesh->GetNE(); e++)
+   {
+      const IntegrationRule &ir = qs.GetElementIntRule(e);
+      ElementTransformation &T = *mesh->GetElementTransformation(e);
+      qf.GetElementValues(e, values);
+      for (int q = 0; q < ir.GetNPoints(); q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         Vector V(values.GetColumn(q), vdim);
+         T.SetIntPoint(&ip);
+         Eval(V, T, ip);
+      }
+   }
+}
+
+void VectorConstantCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == vdim, "Invalid QuadratureFunction dimension.");
+   const int VDIM = vdim;
+   auto v = vec.Read();
+   auto d_qf = qf.Write();
+   MFEM_FORALL(i, qf.Size(), d_qf[i] = v[i % VDIM];);
+}
+
 void VectorFunctionCoefficient::Eval(Vector &V, ElementTransformation &T,
                                      const IntegrationPoint &ip)
 {
@@ -124,6 +303,50 @@ void VectorFunctionCoefficient::Eval(Vector &V, ElementTransformation &T,
    }
 }
 
+void VectorFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   const IntegrationRule *ir = GetUniformIntRule(qf);
+   if (!ir) { return VectorCoefficient::Project(qf); }
+   MFEM_VERIFY(qf.GetVDim() == vdim, "Invalid QuadratureFunction dimension.");
+   Mesh *mesh = qf.GetSpace()->GetMesh();
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES);
+   const int NE = mesh->GetNE();
+   const int NQ = ir->GetNPoints();
+   const int sdim = mesh->SpaceDimension();
+   Vector q_coeff;
+   if (Q)
+   {
+      QuadratureFunction qf_coeff(qf.GetSpace());
+      Q->SetTime(GetTime());
+      Q->Project(qf_coeff);
+      q_coeff.Swap(qf_coeff);
+   }
+   // The user function can only be called on the host.
+   auto X = Reshape(geom->X.HostRead(), NQ, sdim, NE);
+   auto D = Reshape(qf.HostWrite(), vdim, NQ, NE);
+   const double *C = Q ? q_coeff.HostRead() : NULL;
+   double x[3];
+   Vector transip(x, sdim), V;
+   for (int e = 0; e < NE; e++)
+   {
+      for (int q = 0; q < NQ; q++)
+      {
+         for (int d = 0; d < sdim; d++) { x[d] = X(q,d,e); }
+         V.SetDataAndSize(&D(0,q,e), vdim);
+         if (Function)
+         {
+            Function(transip, V);
+         }
+         else
+         {
+            TDFunction(transip, GetTime(), V);
+         }
+         if (Q) { V *= C[q + NQ*e]; }
+      }
+   }
+}
+
 VectorArrayCoefficient::VectorArrayCoefficient (int dim)
    : VectorCoefficient(dim), Coeff(dim), ownCoeff(dim)
 {
@@ -183,6 +406,34 @@ void VectorGridFunctionCoefficient::Eval(
    GridFunc->GetVectorValues(T, ir, M);
 }
 
+void VectorGridFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == vdim, "Invalid QuadratureFunction dimension.");
+   if (vdim == 1)
+   {
+      if (!GridFunc->GetQuadratureValues(*qf.GetSpace(), qf))
+      {
+         VectorCoefficient::Project(qf);
+      }
+      return;
+   }
+   Vector q_val;
+   if (!GridFunc->GetQuadratureValues(*qf.GetSpace(), q_val))
+   {
+      return VectorCoefficient::Project(qf);
+   }
+   const int VDIM = vdim;
+   const int NE = qf.GetSpace()->GetMesh()->GetNE();
+   const int NQ = qf.Size()/(VDIM*NE);
+   auto V = Reshape(q_val.Read(), NQ, VDIM, NE);
+   auto D = Reshape(qf.Write(), VDIM, NQ, NE);
+   MFEM_FORALL(i, NQ*NE,
+   {
+      const int q = i % NQ, e = i / NQ;
+      for (int c = 0; c < VDIM; c++) { D(c,q,e) = V(q,c,e); }
+   });
+}
+
 GradientGridFunctionCoefficient::GradientGridFunctionCoefficient (
    const GridFunction *gf)
    : VectorCoefficient((gf) ?
@@ -425,6 +676,74 @@ void MatrixRestrictedCoefficient::Eval(DenseMatrix &K, ElementTransformation &T,
    }
 }
 
+void SumCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   b->Project(qf);
+   const double A = aConst, al = alpha, be = beta;
+   auto d_qf = qf.ReadWrite();
+   if (a == NULL)
+   {
+      MFEM_FORALL(i, qf.Size(), d_qf[i] = al*A + be*d_qf[i];);
+      return;
+   }
+   QuadratureFunction qf_a(qf.GetSpace());
+   a->Project(qf_a);
+   auto d_a = qf_a.Read();
+   MFEM_FORALL(i, qf.Size(), d_qf[i] = al*d_a[i] + be*d_qf[i];);
+}
+
+void ProductCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   b->Project(qf);
+   if (a == NULL)
+   {
+      qf *= aConst;
+      return;
+   }
+   QuadratureFunction qf_a(qf.GetSpace());
+   a->Project(qf_a);
+   auto d_a = qf_a.Read();
+   auto d_qf = qf.ReadWrite();
+   MFEM_FORALL(i, qf.Size(), d_qf[i] *= d_a[i];);
+}
+
+void RatioCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   const double A = aConst, B = bConst;
+   if (b == NULL)
+   {
+      MFEM_ASSERT(B != 0.0, "Division by zero in RatioCoefficient");
+      if (a == NULL) { qf = A/B; return; }
+      a->Project(qf);
+      auto d_qf = qf.ReadWrite();
+      MFEM_FORALL(i, qf.Size(), d_qf[i] /= B;);
+      return;
+   }
+   b->Project(qf);
+   auto d_qf = qf.ReadWrite();
+   if (a == NULL)
+   {
+      MFEM_FORALL(i, qf.Size(), d_qf[i] = A / d_qf[i];);
+      return;
+   }
+   QuadratureFunction qf_a(qf.GetSpace());
+   a->Project(qf_a);
+   auto d_a = qf_a.Read();
+   MFEM_FORALL(i, qf.Size(), d_qf[i] = d_a[i] / d_qf[i];);
+}
+
+void PowerCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "Invalid QuadratureFunction dimension.");
+   a->Project(qf);
+   const double P = p;
+   auto d_qf = qf.ReadWrite();
+   MFEM_FORALL(i, qf.Size(), d_qf[i] = pow(d_qf[i], P););
+}
+
 InnerProductCoefficient::InnerProductCoefficient(VectorCoefficient &A,
                                                  VectorCoefficient &B)
    : a(&A), b(&B)
@@ -960,4 +1279,12 @@ double QuadratureFunctionCoefficient::Eval(ElementTransformation &T,
    return temp[0];
 }
 
+void QuadratureFunctionCoefficient::Project(QuadratureFunction &qf)
+{
+   MFEM_VERIFY(qf.GetSpace() == QuadF.GetSpace() && qf.GetVDim() == 1,
+               "Incompatible QuadratureFunction.");
+   if (&qf == &QuadF) { return; }
+   qf = QuadF;
+}
+
 }
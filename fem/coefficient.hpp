@@ -23,6 +23,7 @@ namespace mfem
 {
 
 class Mesh;
+class QuadratureFunction;
 
 #ifdef MFEM_USE_MPI
 class ParMesh;
@@ -70,6 +71,13 @@ public:
       return Eval(T, ip);
    }
 
+   /** @brief Evaluate the coefficient at all quadrature points of the
+       QuadratureFunction @a qf, which must have vector dimension 1. */
+   /** The general implementation provided by the base class calls Eval() for
+       one IntegrationPoint at a time. Derived classes can overload it with a
+       batched evaluation over all elements, possibly running on the device. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~Coefficient() { }
 };
 
@@ -87,6 +95,9 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return (constant); }
+
+   /// Fill @a qf with the constant value.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /** @brief A piecewise constant coefficient with the constants keyed
@@ -123,6 +134,9 @@ public:
    /// Evaluate the coefficient.
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /// Evaluate the coefficient at all quadrature points of @a qf.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /// A general function coefficient
@@ -166,6 +180,10 @@ public:
    /// Evaluate the coefficient at @a ip.
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /** @brief Evaluate the coefficient at all quadrature points of @a qf, using
+       the physical coordinates computed by Mesh::GetGeometricFactors(). */
+   virtual void Project(QuadratureFunction &qf);
 };
 
 class GridFunction;
@@ -193,6 +211,10 @@ public:
    /// Evaluate the coefficient at @a ip.
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /** @brief Evaluate the coefficient at all quadrature points of @a qf, using
+       the QuadratureInterpolator of the GridFunction's FiniteElementSpace. */
+   virtual void Project(QuadratureFunction &qf);
 };
 
 
@@ -219,6 +241,9 @@ public:
 
    /// Evaluate the coefficient at @a ip.
    virtual double Eval(ElementTransformation &T, const IntegrationPoint &ip);
+
+   /// Evaluate the coefficient at all quadrature points of @a qf.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /** @brief Delta function coefficient optionally multiplied by a weight
@@ -381,6 +406,13 @@ public:
    virtual void Eval(DenseMatrix &M, ElementTransformation &T,
                      const IntegrationRule &ir);
 
+   /** @brief Evaluate the vector coefficient at all quadrature points of the
+       QuadratureFunction @a qf, which must have vector dimension GetVDim(). */
+   /** The general implementation provided by the base class calls Eval() for
+       one IntegrationPoint at a time. Derived classes can overload it with a
+       batched evaluation over all elements, possibly running on the device. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~VectorCoefficient() { }
 };
 
@@ -400,6 +432,9 @@ public:
    virtual void Eval(Vector &V, ElementTransformation &T,
                      const IntegrationPoint &ip) { V = vec; }
 
+   /// Fill @a qf with the constant vector.
+   virtual void Project(QuadratureFunction &qf);
+
    /// Return a reference to the constant vector in this class.
    const Vector& GetVec() { return vec; }
 };
@@ -438,6 +473,11 @@ public:
    virtual void Eval(Vector &V, ElementTransformation &T,
                      const IntegrationPoint &ip);
 
+   /** @brief Evaluate the vector coefficient at all quadrature points of
+       @a qf, using the physical coordinates computed by
+       Mesh::GetGeometricFactors(). */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~VectorFunctionCoefficient() { }
 };
 
@@ -512,6 +552,11 @@ public:
    virtual void Eval(DenseMatrix &M, ElementTransformation &T,
                      const IntegrationRule &ir);
 
+   /** @brief Evaluate the vector coefficient at all quadrature points of @a qf,
+       using the QuadratureInterpolator of the GridFunction's
+       FiniteElementSpace. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~VectorGridFunctionCoefficient() { }
 };
 
@@ -938,6 +983,9 @@ public:
       return alpha * ((a == NULL ) ? aConst : a->Eval(T, ip) )
              + beta * b->Eval(T, ip);
    }
+
+   /// Evaluate the coefficient at all quadrature points of @a qf.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /** @brief Scalar coefficient defined as the product of two scalar coefficients
@@ -977,6 +1025,9 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return ((a == NULL ) ? aConst : a->Eval(T, ip) ) * b->Eval(T, ip); }
+
+   /// Evaluate the coefficient at all quadrature points of @a qf.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /** @brief Scalar coefficient defined as the ratio of two scalars where one or
@@ -1031,6 +1082,9 @@ public:
       MFEM_ASSERT(den != 0.0, "Division by zero in RatioCoefficient");
       return ((a == NULL ) ? aConst : a->Eval(T, ip) ) / den;
    }
+
+   /// Evaluate the coefficient at all quadrature points of @a qf.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 /// Scalar coefficient defined as a scalar raised to a power
@@ -1060,6 +1114,9 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return pow(a->Eval(T, ip), p); }
+
+   /// Evaluate the coefficient at all quadrature points of @a qf.
+   virtual void Project(QuadratureFunction &qf);
 };
 
 
@@ -1553,8 +1610,6 @@ public:
 };
 ///@}
 
-class QuadratureFunction;
-
 /** @brief Vector quadrature function coefficient which requires that the
     quadrature rules used for this vector coefficient be the same as those that
     live within the supplied QuadratureFunction. */
@@ -1598,6 +1653,10 @@ public:
 
    virtual double Eval(ElementTransformation &T, const IntegrationPoint &ip);
 
+   /** @brief Copy the values of the internal QuadratureFunction into @a qf,
+       which must be defined on the same QuadratureSpace. */
+   virtual void Project(QuadratureFunction &qf);
+
    virtual ~QuadratureFunctionCoefficient() { }
 };
 
@@ -888,6 +888,67 @@ void VectorFiniteElement::SetDerivMembers()
    }
 }
 
+const DofToQuad &VectorFiniteElement::GetDofToQuad(const IntegrationRule &ir,
+                                                   DofToQuad::Mode mode) const
+{
+   MFEM_VERIFY(mode == DofToQuad::FULL, "invalid mode requested");
+
+   for (int i = 0; i < dof2quad_array.Size(); i++)
+   {
+      const DofToQuad &d2q = *dof2quad_array[i];
+      if (d2q.IntRule == &ir && d2q.mode == mode) { return d2q; }
+   }
+
+   // Number of components of the divergence/curl
+   const int cdim = (deriv_type == DIV) ? 1 :
+                    (deriv_type == CURL) ? ((dim == 3) ? 3 : 1) : 0;
+
+   DofToQuad *d2q = new DofToQuad;
+   const int nqpt = ir.GetNPoints();
+   d2q->FE = this;
+   d2q->IntRule = &ir;
+   d2q->mode = mode;
+   d2q->ndof = dof;
+   d2q->nqpt = nqpt;
+   d2q->B.SetSize(nqpt*dim*dof);
+   d2q->Bt.SetSize(dof*nqpt*dim);
+   d2q->G.SetSize(nqpt*cdim*dof);
+   d2q->Gt.SetSize(dof*nqpt*cdim);
+   DenseMatrix vshape(dof, dim), dshape(dof, cdim);
+   Vector divshape(dof);
+   for (int i = 0; i < nqpt; i++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(i);
+      CalcVShape(ip, vshape);
+      for (int d = 0; d < dim; d++)
+      {
+         for (int j = 0; j < dof; j++)
+         {
+            d2q->B[i+nqpt*(d+dim*j)] = d2q->Bt[j+dof*(i+nqpt*d)] = vshape(j,d);
+         }
+      }
+      if (cdim == 0) { continue; }
+      if (deriv_type == DIV)
+      {
+         CalcDivShape(ip, divshape);
+         dshape.SetCol(0, divshape);
+      }
+      else
+      {
+         CalcCurlShape(ip, dshape);
+      }
+      for (int d = 0; d < cdim; d++)
+      {
+         for (int j = 0; j < dof; j++)
+         {
+            d2q->G[i+nqpt*(d+cdim*j)] = d2q->Gt[j+dof*(i+nqpt*d)] = dshape(j,d);
+         }
+      }
+   }
+   dof2quad_array.Append(d2q);
+   return *d2q;
+}
+
 void VectorFiniteElement::CalcVShape_RT (
    ElementTransformation &Trans, DenseMatrix &shape) const
 {
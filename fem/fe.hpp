@@ -171,7 +171,7 @@ public:
    /// Basis functions evaluated at quadrature points.
    /** The storage layout is column-major with dimensions:
        - #nqpt x #ndof, for scalar elements, or
-       - #nqpt x dim x #ndof, for vector elements, (TODO)
+       - #nqpt x dim x #ndof, for vector elements (only in FULL mode),
 
        where
 
@@ -182,15 +182,16 @@ public:
    /// Transpose of #B.
    /** The storage layout is column-major with dimensions:
        - #ndof x #nqpt, for scalar elements, or
-       - #ndof x #nqpt x dim, for vector elements (TODO). */
+       - #ndof x #nqpt x dim, for vector elements (only in FULL mode). */
    Array<double> Bt;
 
    /** @brief Gradients/divergences/curls of basis functions evaluated at
        quadrature points. */
    /** The storage layout is column-major with dimensions:
        - #nqpt x dim x #ndof, for scalar elements, or
-       - #nqpt x #ndof, for H(div) vector elements (TODO), or
-       - #nqpt x cdim x #ndof, for H(curl) vector elements (TODO),
+       - #nqpt x #ndof, for H(div) vector elements (only in FULL mode), or
+       - #nqpt x cdim x #ndof, for H(curl) vector elements (only in FULL
+         mode),
 
        where
 
@@ -203,8 +204,9 @@ public:
    /// Transpose of #G.
    /** The storage layout is column-major with dimensions:
        - #ndof x #nqpt x dim, for scalar elements, or
-       - #ndof x #nqpt, for H(div) vector elements (TODO), or
-       - #ndof x #nqpt x cdim, for H(curl) vector elements (TODO). */
+       - #ndof x #nqpt, for H(div) vector elements (only in FULL mode), or
+       - #ndof x #nqpt x cdim, for H(curl) vector elements (only in FULL
+         mode). */
    Array<double> Gt;
 };
 
@@ -890,6 +892,12 @@ public:
       FiniteElement(D, G, Do, O, F), Jinv(D)
    { range_type = VECTOR; map_type = M; SetDerivMembers(); }
 #endif
+
+   /** @brief Return a DofToQuad structure with the reference vector shape
+       functions and their divergence/curl, see DofToQuad. Only the FULL mode
+       is supported. */
+   virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
+                                         DofToQuad::Mode mode) const;
 };
 
 /// A 0D point finite element
@@ -2317,6 +2325,13 @@ public:
    static void CalcDShape(const int p, const double x, const double y,
                           double *dshape_1d, double *dshape);
 
+   /** @brief Get the map from the dofs numbered lexicographically by the
+       powers of the barycentric coordinates x, y (the first one running
+       fastest) to the native dofs. */
+   /** This is the ordering in which the basis is a tensor product in the
+       collapsed coordinates of IntegrationRules::GetCollapsed(). */
+   const Array<int> &GetDofMap() const { return dof_map; }
+
    virtual void CalcShape(const IntegrationPoint &ip, Vector &shape) const;
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
@@ -2346,6 +2361,13 @@ public:
    static void CalcDShape(const int p, const double x, const double y,
                           const double z, double *dshape_1d, double *dshape);
 
+   /** @brief Get the map from the dofs numbered lexicographically by the
+       powers of the barycentric coordinates x, y, z (the first one running
+       fastest) to the native dofs. */
+   /** This is the ordering in which the basis is a tensor product in the
+       collapsed coordinates of IntegrationRules::GetCollapsed(). */
+   const Array<int> &GetDofMap() const { return dof_map; }
+
    virtual void CalcShape(const IntegrationPoint &ip, Vector &shape) const;
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
@@ -63,7 +63,7 @@ FiniteElementSpace::FiniteElementSpace()
      fdofs(NULL), bdofs(NULL),
      elem_dof(NULL), bdrElem_dof(NULL), face_dof(NULL),
      NURBSext(NULL), own_ext(false),
-     cP(NULL), cR(NULL), cP_is_set(false),
+     cP(NULL), cR(NULL), cP_is_set(false), cP_is_copied(false),
      Th(Operator::ANY_TYPE),
      sequence(0)
 { }
@@ -873,18 +873,66 @@ void FiniteElementSpace::MakeVDimMatrix(SparseMatrix &mat) const
 
 const SparseMatrix* FiniteElementSpace::GetConformingProlongation() const
 {
-   if (Conforming()) { return NULL; }
+   if (Conforming() && !cP_is_copied) { return NULL; }
    if (!cP_is_set) { BuildConformingInterpolation(); }
    return cP;
 }
 
 const SparseMatrix* FiniteElementSpace::GetConformingRestriction() const
 {
-   if (Conforming()) { return NULL; }
+   if (Conforming() && !cP_is_copied) { return NULL; }
    if (!cP_is_set) { BuildConformingInterpolation(); }
    return cR;
 }
 
+void FiniteElementSpace::CopyProlongationAndRestriction(
+   const FiniteElementSpace &fes, const Array<int> *perm)
+{
+   MFEM_VERIFY(cP == NULL && cR == NULL,
+               "the prolongation and restriction matrices are already set");
+
+   SparseMatrix *perm_mat = NULL, *perm_mat_tr = NULL;
+   if (perm)
+   {
+      const int n = perm->Size();
+      perm_mat = new SparseMatrix(n, fes.GetVSize());
+      for (int i = 0; i < n; i++)
+      {
+         double s;
+         const int j = DecodeDof((*perm)[i], s);
+         perm_mat->Set(i, j, s);
+      }
+      perm_mat->Finalize();
+      perm_mat_tr = Transpose(*perm_mat);
+   }
+
+   const SparseMatrix *fes_P = fes.GetConformingProlongation();
+   const SparseMatrix *fes_R = fes.GetConformingRestriction();
+   if (fes_P)
+   {
+      cP = perm ? Mult(*perm_mat, *fes_P) : new SparseMatrix(*fes_P);
+   }
+   else if (perm)
+   {
+      cP = perm_mat;
+      perm_mat = NULL;
+   }
+   if (fes_R)
+   {
+      cR = perm ? Mult(*fes_R, *perm_mat_tr) : new SparseMatrix(*fes_R);
+   }
+   else if (perm)
+   {
+      cR = perm_mat_tr;
+      perm_mat_tr = NULL;
+   }
+   cP_is_set = true;
+   cP_is_copied = true;
+
+   delete perm_mat;
+   delete perm_mat_tr;
+}
+
 int FiniteElementSpace::GetNConformingDofs() const
 {
    const SparseMatrix* P = GetConformingProlongation();
@@ -894,8 +942,9 @@ int FiniteElementSpace::GetNConformingDofs() const
 const Operator *FiniteElementSpace::GetElementRestriction(
    ElementDofOrdering e_ordering) const
 {
-   // Check if we have a discontinuous space using the FE collection:
-   if (IsDGSpace())
+   // Check if we have a discontinuous space using the FE collection. On meshes
+   // with mixed elements, the general ElementRestriction is used.
+   if (IsDGSpace() && mesh->GetNumGeometries(mesh->Dimension()) <= 1)
    {
       if (L2E_nat.Ptr() == NULL)
       {
@@ -919,6 +968,26 @@ const Operator *FiniteElementSpace::GetElementRestriction(
    return L2E_nat.Ptr();
 }
 
+void FiniteElementSpace::GetElementGroups(Array<int> &offsets,
+                                          Array<int> &elements) const
+{
+   Array<Geometry::Type> geoms;
+   mesh->GetGeometries(mesh->Dimension(), geoms);
+   offsets.SetSize(geoms.Size() + 1);
+   elements.SetSize(mesh->GetNE());
+   int k = 0;
+   for (int g = 0; g < geoms.Size(); g++)
+   {
+      offsets[g] = k;
+      for (int e = 0; e < mesh->GetNE(); e++)
+      {
+         if (mesh->GetElementBaseGeometry(e) == geoms[g]) { elements[k++] = e; }
+      }
+   }
+   offsets[geoms.Size()] = k;
+   MFEM_ASSERT(k == mesh->GetNE(), "invalid element geometries");
+}
+
 const Operator *FiniteElementSpace::GetFaceRestriction(
    ElementDofOrdering e_ordering, FaceType type, L2FaceValues mul) const
 {
@@ -1535,6 +1604,7 @@ void FiniteElementSpace::Constructor(Mesh *mesh, NURBSExtension *NURBSext,
       UpdateNURBS();
       cP = cR = NULL;
       cP_is_set = false;
+      cP_is_copied = false;
    }
    else
    {
@@ -1643,6 +1713,7 @@ void FiniteElementSpace::Construct()
    cP = NULL;
    cR = NULL;
    cP_is_set = false;
+   cP_is_copied = false;
    // 'Th' is initialized/destroyed before this method is called.
 
    nvdofs = mesh->GetNV() * fec->DofForGeometry(Geometry::POINT);
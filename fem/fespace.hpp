@@ -127,6 +127,9 @@ protected:
    /// Conforming restriction matrix such that cR.cP=I.
    mutable SparseMatrix *cR; // owned
    mutable bool cP_is_set;
+   /// Set when cP and cR are copied from another space, see
+   /// CopyProlongationAndRestriction().
+   bool cP_is_copied;
 
    /// Transformation to apply to GridFunctions after space Update().
    OperatorHandle Th;
@@ -334,6 +337,19 @@ public:
    virtual const SparseMatrix *GetRestrictionMatrix() const
    { return GetConformingRestriction(); }
 
+   /** @brief Copy the prolongation and restriction matrices from @a fes,
+       composed with the signed DOF permutation @a perm, if not NULL. */
+   /** Entry i of @a perm is the (signed) DOF of @a fes that corresponds to the
+       DOF i of this space, see DecodeDof(). After the call, the true DOFs of
+       this space are the true DOFs of @a fes. This is used by the low-order
+       refined discretizations, see LORDiscretization. */
+   virtual void CopyProlongationAndRestriction(const FiniteElementSpace &fes,
+                                               const Array<int> *perm);
+
+   /// Return true if the prolongation and restriction matrices were set with
+   /// CopyProlongationAndRestriction().
+   bool HasCopiedProlongation() const { return cP_is_copied; }
+
    /// Return an Operator that converts L-vectors to E-vectors.
    /** An L-vector is a vector of size GetVSize() which is the same size as a
        GridFunction. An E-vector represents the element-wise discontinuous
@@ -341,10 +357,14 @@ public:
 
        The layout of the E-vector is: ND x VDIM x NE, where ND is the number of
        degrees of freedom, VDIM is the vector dimension of the FE space, and NE
-       is the number of the mesh elements.
+       is the number of the mesh elements. On meshes with several element
+       geometries, the E-vector is the concatenation of one such block per
+       element group, see GetElementGroups().
 
        The parameter @a e_ordering describes how the local DOFs in each element
-       should be ordered, see ElementDofOrdering.
+       should be ordered, see ElementDofOrdering. On meshes with several element
+       geometries, LEXICOGRAPHIC ordering is used only for the tensor-product
+       elements, the other elements use the NATIVE ordering.
 
        For discontinuous spaces, the element restriction corresponds to a
        permutation of the degrees of freedom, implemented by the
@@ -353,6 +373,13 @@ public:
        The returned Operator is owned by the FiniteElementSpace. */
    const Operator *GetElementRestriction(ElementDofOrdering e_ordering) const;
 
+   /** @brief Group the mesh elements by geometry type, in the order used by
+       the E-vectors of GetElementRestriction(). */
+   /** Group g consists of the elements @a elements[@a offsets[g]], ...,
+       @a elements[@a offsets[g+1]-1], in increasing order. There is one group
+       for each element geometry of the mesh, which may be empty in parallel. */
+   void GetElementGroups(Array<int> &offsets, Array<int> &elements) const;
+
    /// Return an Operator that converts L-vectors to E-vectors on each face.
    virtual const Operator *GetFaceRestriction(
       ElementDofOrdering e_ordering, FaceType,
@@ -12,8 +12,10 @@
 // Implementation of GridFunction
 
 #include "gridfunc.hpp"
+#include "quadinterpolator.hpp"
 #include "../mesh/nurbs.hpp"
 #include "../general/text.hpp"
+#include "../general/forall.hpp"
 
 #include <limits>
 #include <cstring>
@@ -1020,6 +1022,37 @@ void GridFunction::GetVectorValues(ElementTransformation &T,
    }
 }
 
+bool GridFunction::GetQuadratureValues(const QuadratureSpace &qs,
+                                       Vector &q_val) const
+{
+   Mesh *mesh = fes->GetMesh();
+   const int dim = mesh->Dimension();
+   const int vdim = fes->GetVDim();
+   if (qs.GetMesh() != mesh || mesh->GetNE() == 0 || mesh->NURBSext ||
+       mesh->GetNumGeometries(dim) != 1 || (dim != 2 && dim != 3))
+   {
+      return false;
+   }
+   const FiniteElement *fe = fes->GetFE(0);
+   // These are the cases supported by QuadratureInterpolator::Mult().
+   const int max_nd = (dim == 2) ? 100 : 1000;
+   if (fe->GetRangeType() != FiniteElement::SCALAR ||
+       fe->GetMapType() != FiniteElement::VALUE || fe->GetDof() > max_nd ||
+       !(vdim == 1 || vdim == dim || (vdim == 3 && dim == 2)))
+   {
+      return false;
+   }
+   const Operator *R = fes->GetElementRestriction(ElementDofOrdering::NATIVE);
+   Vector e_vec(R->Height(), Device::GetMemoryType());
+   R->Mult(*this, e_vec);
+   const QuadratureInterpolator *qi = fes->GetQuadratureInterpolator(qs);
+   qi->DisableTensorProducts();
+   qi->SetOutputLayout(QVectorLayout::byNODES);
+   q_val.SetSize(qs.GetSize()*vdim, Device::GetMemoryType());
+   qi->Values(e_vec, q_val);
+   return true;
+}
+
 int GridFunction::GetFaceVectorValues(
    int i, int side, const IntegrationRule &ir,
    DenseMatrix &vals, DenseMatrix &tr) const
@@ -2564,6 +2597,164 @@ void GridFunction::ProjectBdrCoefficientTangent(
 #endif
 }
 
+// Compute in each element the integral of the p-th power of the point-wise
+// error of @a gf, or its maximum for p = infinity, with the kernels of the
+// QuadratureInterpolator and the GeometricFactors of the mesh. The point-wise
+// error is |u_h - exsol| for a scalar @a exsol, and the l_2 norm of the vector
+// error, or its dot product with @a v_weight, for a vector @a vexsol. It is
+// scaled by the optional @a weight. Returns false if the elements have to be
+// processed one by one instead.
+static bool ElementLpErrorIntegrals(const GridFunction &gf, const double p,
+                                    Coefficient *exsol,
+                                    VectorCoefficient *vexsol,
+                                    Coefficient *weight,
+                                    VectorCoefficient *v_weight,
+                                    const IntegrationRule *irs[],
+                                    Vector &elem_err)
+{
+   const FiniteElementSpace *fes = gf.FESpace();
+   Mesh *mesh = fes->GetMesh();
+   const int dim = mesh->Dimension();
+   const int NE = mesh->GetNE();
+   if (NE == 0 || mesh->GetNumGeometries(dim) != 1 ||
+       mesh->SpaceDimension() != dim) { return false; }
+   const FiniteElement *fe = fes->GetFE(0);
+   const IntegrationRule *ir = irs ? irs[fe->GetGeomType()] :
+                               &IntRules.Get(fe->GetGeomType(),
+                                             2*fe->GetOrder() + 3);
+   QuadratureSpace qs(mesh, ir->GetOrder());
+   if (&qs.GetElementIntRule(0) != ir) { return false; }
+   const int vdim = fes->GetVDim();
+   if (vexsol && vexsol->GetVDim() != vdim) { return false; }
+   Vector u;
+   if (!gf.GetQuadratureValues(qs, u)) { return false; }
+
+   const int VD = vexsol ? vdim : 1;
+   QuadratureFunction ex(&qs, VD), w, vw;
+   if (vexsol) { vexsol->Project(ex); }
+   else { exsol->Project(ex); }
+   if (weight)
+   {
+      w.SetSpace(&qs, 1);
+      weight->Project(w);
+   }
+   if (v_weight)
+   {
+      vw.SetSpace(&qs, VD);
+      v_weight->Project(vw);
+   }
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
+
+   const int NQ = ir->GetNPoints();
+   const bool finite = p < infinity();
+   const bool use_w = weight != NULL, use_vw = v_weight != NULL;
+   auto U = Reshape(u.Read(), NQ, vdim, NE);
+   auto EX = Reshape(ex.Read(), VD, NQ, NE);
+   auto W = Reshape(use_w ? w.Read() : NULL, NQ, NE);
+   auto VW = Reshape(use_vw ? vw.Read() : NULL, VD, NQ, NE);
+   auto IW = ir->GetWeights().Read();
+   auto DETJ = Reshape(geom->detJ.Read(), NQ, NE);
+   elem_err.SetSize(NE);
+   auto E = elem_err.Write();
+   MFEM_FORALL(e, NE,
+   {
+      double err_e = 0.0;
+      for (int q = 0; q < NQ; q++)
+      {
+         double err = 0.0;
+         if (VD == 1 && !use_vw)
+         {
+            err = fabs(U(q,0,e) - EX(0,q,e));
+         }
+         else if (!use_vw)
+         {
+            for (int c = 0; c < VD; c++)
+            {
+               const double d = U(q,c,e) - EX(c,q,e);
+               err += d*d;
+            }
+            err = sqrt(err);
+         }
+         else
+         {
+            for (int c = 0; c < VD; c++)
+            {
+               err += (U(q,c,e) - EX(c,q,e))*VW(c,q,e);
+            }
+            err = fabs(err);
+         }
+         if (finite)
+         {
+            err = pow(err, p);
+            if (use_w) { err *= W(q,e); }
+            err_e += IW[q] * DETJ(q,e) * err;
+         }
+         else
+         {
+            if (use_w) { err *= W(q,e); }
+            err_e = fmax(err_e, err);
+         }
+      }
+      E[e] = err_e;
+   });
+   return true;
+}
+
+// Return the p-th root of the sum (p < infinity) or the maximum of the
+// element values computed by ElementLpErrorIntegrals().
+static double LpErrorFromIntegrals(const double p, const Vector &elem_err)
+{
+   const double *E = elem_err.HostRead();
+   double error = 0.0;
+   for (int i = 0; i < elem_err.Size(); i++)
+   {
+      error = (p < infinity()) ? error + E[i] : std::max(error, E[i]);
+   }
+   if (p < infinity())
+   {
+      // negative quadrature weights may cause the error to be negative
+      error = (error < 0.) ? -pow(-error, 1./p) : pow(error, 1./p);
+   }
+   return error;
+}
+
+// Combine the Lp errors in the elements into the Lp error on the whole mesh.
+static double LpErrorFromElementErrors(const double p, const Vector &elem_err)
+{
+   const double *E = elem_err.HostRead();
+   double error = 0.0;
+   for (int i = 0; i < elem_err.Size(); i++)
+   {
+      if (p < infinity())
+      {
+         error += (E[i] < 0.) ? -pow(-E[i], p) : pow(E[i], p);
+      }
+      else
+      {
+         error = std::max(error, E[i]);
+      }
+   }
+   if (p < infinity())
+   {
+      error = (error < 0.) ? -pow(-error, 1./p) : pow(error, 1./p);
+   }
+   return error;
+}
+
+// Replace the element values computed by ElementLpErrorIntegrals() by their
+// p-th roots when p < infinity.
+static void ElementLpErrorsFromIntegrals(const double p, Vector &elem_err)
+{
+   if (p == infinity()) { return; }
+   double *E = elem_err.HostReadWrite();
+   for (int i = 0; i < elem_err.Size(); i++)
+   {
+      // negative quadrature weights may cause the error to be negative
+      E[i] = (E[i] < 0.) ? -pow(-E[i], 1./p) : pow(E[i], 1./p);
+   }
+}
+
 double GridFunction::ComputeL2Error(
    Coefficient *exsol[], const IntegrationRule *irs[]) const
 {
@@ -2621,6 +2812,14 @@ double GridFunction::ComputeL2Error(
    VectorCoefficient &exsol, const IntegrationRule *irs[],
    Array<int> *elems) const
 {
+   Vector elem_err;
+   if (elems == NULL &&
+       ElementLpErrorIntegrals(*this, 2.0, NULL, &exsol, NULL, NULL, irs,
+                               elem_err))
+   {
+      return LpErrorFromIntegrals(2.0, elem_err);
+   }
+
    double error = 0.0;
    const FiniteElement *fe;
    ElementTransformation *T;
@@ -3109,6 +3308,13 @@ double GridFunction::ComputeLpError(const double p, Coefficient &exsol,
                                     Coefficient *weight,
                                     const IntegrationRule *irs[]) const
 {
+   Vector elem_err;
+   if (ElementLpErrorIntegrals(*this, p, &exsol, NULL, weight, NULL, irs,
+                               elem_err))
+   {
+      return LpErrorFromIntegrals(p, elem_err);
+   }
+
    double error = 0.0;
    const FiniteElement *fe;
    ElementTransformation *T;
@@ -3178,6 +3384,13 @@ void GridFunction::ComputeElementLpErrors(const double p, Coefficient &exsol,
    MFEM_ASSERT(error.Size() == fes->GetNE(),
                "Incorrect size for result vector");
 
+   if (ElementLpErrorIntegrals(*this, p, &exsol, NULL, weight, NULL, irs,
+                               error))
+   {
+      ElementLpErrorsFromIntegrals(p, error);
+      return;
+   }
+
    error = 0.0;
    const FiniteElement *fe;
    ElementTransformation *T;
@@ -3236,11 +3449,34 @@ void GridFunction::ComputeElementLpErrors(const double p, Coefficient &exsol,
    }
 }
 
+double GridFunction::ComputeLpError(const double p, Coefficient &exsol,
+                                    Vector &elem_error, Coefficient *weight,
+                                    const IntegrationRule *irs[]) const
+{
+   if (ElementLpErrorIntegrals(*this, p, &exsol, NULL, weight, NULL, irs,
+                               elem_error))
+   {
+      const double error = LpErrorFromIntegrals(p, elem_error);
+      ElementLpErrorsFromIntegrals(p, elem_error);
+      return error;
+   }
+   elem_error.SetSize(fes->GetNE());
+   ComputeElementLpErrors(p, exsol, elem_error, weight, irs);
+   return LpErrorFromElementErrors(p, elem_error);
+}
+
 double GridFunction::ComputeLpError(const double p, VectorCoefficient &exsol,
                                     Coefficient *weight,
                                     VectorCoefficient *v_weight,
                                     const IntegrationRule *irs[]) const
 {
+   Vector elem_err;
+   if (ElementLpErrorIntegrals(*this, p, NULL, &exsol, weight, v_weight, irs,
+                               elem_err))
+   {
+      return LpErrorFromIntegrals(p, elem_err);
+   }
+
    double error = 0.0;
    const FiniteElement *fe;
    ElementTransformation *T;
@@ -3337,6 +3573,13 @@ void GridFunction::ComputeElementLpErrors(const double p,
    MFEM_ASSERT(error.Size() == fes->GetNE(),
                "Incorrect size for result vector");
 
+   if (ElementLpErrorIntegrals(*this, p, NULL, &exsol, weight, v_weight, irs,
+                               error))
+   {
+      ElementLpErrorsFromIntegrals(p, error);
+      return;
+   }
+
    error = 0.0;
    const FiniteElement *fe;
    ElementTransformation *T;
@@ -3420,6 +3663,23 @@ void GridFunction::ComputeElementLpErrors(const double p,
    }
 }
 
+double GridFunction::ComputeLpError(const double p, VectorCoefficient &exsol,
+                                    Vector &elem_error, Coefficient *weight,
+                                    VectorCoefficient *v_weight,
+                                    const IntegrationRule *irs[]) const
+{
+   if (ElementLpErrorIntegrals(*this, p, NULL, &exsol, weight, v_weight, irs,
+                               elem_error))
+   {
+      const double error = LpErrorFromIntegrals(p, elem_error);
+      ElementLpErrorsFromIntegrals(p, elem_error);
+      return error;
+   }
+   elem_error.SetSize(fes->GetNE());
+   ComputeElementLpErrors(p, exsol, elem_error, weight, v_weight, irs);
+   return LpErrorFromElementErrors(p, elem_error);
+}
+
 GridFunction & GridFunction::operator=(double value)
 {
    Vector::operator=(value);
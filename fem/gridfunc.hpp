@@ -246,6 +246,15 @@ public:
                         DenseMatrix &vals, DenseMatrix *tr = NULL) const;
    ///@}
 
+   /** @brief Compute the values of the GridFunction at all quadrature points
+       of the QuadratureSpace @a qs, with the layout (NQ, VDIM, NE). */
+   /** The values are computed for all elements at once by the
+       QuadratureInterpolator of the FiniteElementSpace, on the device when it
+       is enabled. Returns false, without modifying @a q_val, when this is not
+       supported, e.g. for vector finite elements, NURBS spaces or meshes with
+       several element geometries. */
+   bool GetQuadratureValues(const QuadratureSpace &qs, Vector &q_val) const;
+
    /** @name Face Index Get Values Methods
 
        These methods are designed to work with Discontinuous Galerkin basis
@@ -551,6 +560,17 @@ public:
                                        ) const
    { ComputeElementLpErrors(infinity(), exsol, error, NULL, irs); }
 
+   /** @brief Compute the Lp error in each element, stored in @a elem_error,
+       and return the Lp error on the whole mesh. */
+   /** Both results come from a single evaluation of the error at the
+       quadrature points, e.g. to mark elements for refinement while measuring
+       the convergence. The size of @a elem_error is set to the number of
+       elements. */
+   virtual double ComputeLpError(const double p, Coefficient &exsol,
+                                 Vector &elem_error,
+                                 Coefficient *weight = NULL,
+                                 const IntegrationRule *irs[] = NULL) const;
+
    /** When given a vector weight, compute the pointwise (scalar) error as the
        dot product of the vector error with the vector weight. Otherwise, the
        scalar error is the l_2 norm of the vector error. */
@@ -587,6 +607,15 @@ public:
                                        ) const
    { ComputeElementLpErrors(infinity(), exsol, error, NULL, NULL, irs); }
 
+   /** @brief Compute the Lp error in each element, stored in @a elem_error,
+       and return the Lp error on the whole mesh, see ComputeElementLpErrors()
+       for the meaning of @a weight and @a v_weight. */
+   virtual double ComputeLpError(const double p, VectorCoefficient &exsol,
+                                 Vector &elem_error,
+                                 Coefficient *weight = NULL,
+                                 VectorCoefficient *v_weight = NULL,
+                                 const IntegrationRule *irs[] = NULL) const;
+
    virtual void ComputeFlux(BilinearFormIntegrator &blfi,
                             GridFunction &flux,
                             bool wcoef = true, int subdomain = -1);
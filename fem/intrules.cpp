@@ -958,6 +958,45 @@ const IntegrationRule &IntegrationRules::Get(int GeomType, int Order)
    return *(*ir_array)[Order];
 }
 
+const IntegrationRule &IntegrationRules::GetCollapsed(int GeomType, int Order)
+{
+   Array<IntegrationRule *> *ir_array;
+
+   switch (GeomType)
+   {
+      case Geometry::TRIANGLE:
+         ir_array = &CollapsedTriangleIntRules; break;
+      case Geometry::TETRAHEDRON:
+         ir_array = &CollapsedTetrahedronIntRules; break;
+      default:
+         mfem_error("IntegrationRules::GetCollapsed(...) : "
+                    "Unsupported geometry type!");
+         ir_array = NULL;
+   }
+
+   if (Order < 0)
+   {
+      Order = 0;
+   }
+
+   if (!HaveIntRule(*ir_array, Order))
+   {
+#ifdef MFEM_USE_LEGACY_OPENMP
+      #pragma omp critical
+#endif
+      {
+         if (!HaveIntRule(*ir_array, Order))
+         {
+            IntegrationRule *ir = CollapsedIntegrationRule(GeomType, Order);
+            AllocIntRule(*ir_array, Order);
+            (*ir_array)[Order] = ir;
+         }
+      }
+   }
+
+   return *(*ir_array)[Order];
+}
+
 void IntegrationRules::Set(int GeomType, int Order, IntegrationRule &IntRule)
 {
    Array<IntegrationRule *> *ir_array;
@@ -1014,6 +1053,8 @@ IntegrationRules::~IntegrationRules()
    DeleteIntRuleArray(TetrahedronIntRules);
    DeleteIntRuleArray(CubeIntRules);
    DeleteIntRuleArray(PrismIntRules);
+   DeleteIntRuleArray(CollapsedTriangleIntRules);
+   DeleteIntRuleArray(CollapsedTetrahedronIntRules);
 }
 
 
@@ -1687,4 +1728,39 @@ IntegrationRule *IntegrationRules::CubeIntegrationRule(int Order)
    return CubeIntRules[Order];
 }
 
+// Collapsed-coordinate rules for the reference triangle and tetrahedron
+IntegrationRule *IntegrationRules::CollapsedIntegrationRule(int GeomType,
+                                                            int Order)
+{
+   const int dim = Geometry::Dimension[GeomType];
+   // The Jacobian of the collapsed map raises the degree in the last
+   // coordinates by up to dim-1
+   const int n = (Order + dim - 1)/2 + 1;
+   const IntegrationRule &ir1D = Get(Geometry::SEGMENT, 2*n - 1);
+   const int n1D = ir1D.GetNPoints();
+   const int nc = (dim == 3) ? n1D : 1;
+   IntegrationRule *ir = new IntegrationRule(n1D*n1D*nc);
+   for (int k = 0; k < nc; k++)
+   {
+      const double c = (dim == 3) ? ir1D.IntPoint(k).x : 0.0;
+      const double wc = (dim == 3) ? ir1D.IntPoint(k).weight*(1.-c)*(1.-c) : 1.;
+      for (int j = 0; j < n1D; j++)
+      {
+         const double b = ir1D.IntPoint(j).x;
+         const double wb = ir1D.IntPoint(j).weight*(1.-b);
+         for (int i = 0; i < n1D; i++)
+         {
+            const double a = ir1D.IntPoint(i).x;
+            IntegrationPoint &ip = ir->IntPoint(i + n1D*(j + n1D*k));
+            ip.x = a*(1.-b)*(1.-c);
+            ip.y = b*(1.-c);
+            ip.z = c;
+            ip.weight = ir1D.IntPoint(i).weight*wb*wc;
+         }
+      }
+   }
+   ir->SetOrder(Order);
+   return ir;
+}
+
 }
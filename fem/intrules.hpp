@@ -327,6 +327,9 @@ private:
    Array<IntegrationRule *> PrismIntRules;
    Array<IntegrationRule *> CubeIntRules;
 
+   Array<IntegrationRule *> CollapsedTriangleIntRules;
+   Array<IntegrationRule *> CollapsedTetrahedronIntRules;
+
    void AllocIntRule(Array<IntegrationRule *> &ir_array, int Order)
    {
       if (ir_array.Size() <= Order)
@@ -354,6 +357,7 @@ private:
    IntegrationRule *TetrahedronIntegrationRule(int Order);
    IntegrationRule *PrismIntegrationRule(int Order);
    IntegrationRule *CubeIntegrationRule(int Order);
+   IntegrationRule *CollapsedIntegrationRule(int GeomType, int Order);
 
    void DeleteIntRuleArray(Array<IntegrationRule *> &ir_array);
 
@@ -366,6 +370,20 @@ public:
    /// Returns an integration rule for given GeomType and Order.
    const IntegrationRule &Get(int GeomType, int Order);
 
+   /** @brief Returns a collapsed-coordinate integration rule of the given
+       Order for a TRIANGLE or TETRAHEDRON. */
+   /** The rule is the image of a tensor product of 1D rules at the points
+       (a,b) or (a,b,c) under the collapsed map x = a(1-b)(1-c), y = b(1-c),
+       z = c (Duffy transformation), with the point index of a running
+       fastest. Its weights include the Jacobian (1-b) or (1-b)(1-c)^2 of the
+       map. The 1D rules are Get(Geometry::SEGMENT, 2n-1) with n points, where
+       n is the smallest number that integrates exactly the polynomials of
+       degree Order. Bases that are tensor products in the collapsed
+       coordinates, e.g. the Bernstein basis of H1Pos_TriangleElement and
+       H1Pos_TetrahedronElement, can be evaluated at these points by sum
+       factorization. */
+   const IntegrationRule &GetCollapsed(int GeomType, int Order);
+
    void Set(int GeomType, int Order, IntegrationRule &IntRule);
 
    void SetOwnRules(int o) { own_rules = o; }
@@ -17,7 +17,7 @@ namespace mfem
 {
 
 LinearForm::LinearForm(FiniteElementSpace *f, LinearForm *lf)
-   : Vector(f->GetVSize())
+   : Vector(f->GetVSize()), fast_assembly(lf->fast_assembly), ext(NULL)
 {
    // Linear forms are stored on the device
    UseDevice(true);
@@ -31,6 +31,7 @@ LinearForm::LinearForm(FiniteElementSpace *f, LinearForm *lf)
    dlfi_delta = lf->dlfi_delta;
 
    blfi = lf->blfi;
+   blfi_marker = lf->blfi_marker;
 
    flfi = lf->flfi;
    flfi_marker = lf->flfi_marker;
@@ -76,6 +77,34 @@ void LinearForm::AddBdrFaceIntegrator(LinearFormIntegrator *lfi,
    flfi_marker.Append(&bdr_attr_marker);
 }
 
+bool LinearForm::SupportsDevice() const
+{
+   const Mesh &mesh = *fes->GetMesh();
+   const int dim = mesh.Dimension();
+   if (dlfi_delta.Size() > 0 || flfi.Size() > 0) { return false; }
+   if (mesh.NURBSext || !mesh.Conforming()) { return false; }
+   if (mesh.GetNE() == 0) { return false; }
+   if (dim < 2 || dim != mesh.SpaceDimension()) { return false; }
+   if (mesh.GetNumGeometries(dim) != 1) { return false; }
+   const Geometry::Type geom = mesh.GetElementBaseGeometry(0);
+   if (geom != Geometry::SQUARE && geom != Geometry::CUBE) { return false; }
+   for (int k = 0; k < dlfi.Size(); k++)
+   {
+      if (!dlfi[k]->SupportsDevice(*fes)) { return false; }
+   }
+   for (int k = 0; k < blfi.Size(); k++)
+   {
+      if (!blfi[k]->SupportsDevice(*fes)) { return false; }
+   }
+   if (blfi.Size() > 0)
+   {
+      // The extension checks the boundary elements once per mesh
+      return ext ? ext->SupportsBdrIntegrators() :
+             LinearFormExtension::BdrElementsOnBdrFaces(mesh);
+   }
+   return true;
+}
+
 void LinearForm::Assemble()
 {
    Array<int> vdofs;
@@ -84,6 +113,16 @@ void LinearForm::Assemble()
 
    int i;
 
+   if (fast_assembly)
+   {
+      if (ext == NULL) { ext = new LinearFormExtension(this); }
+      if (SupportsDevice())
+      {
+         ext->Assemble();
+         return;
+      }
+   }
+
    Vector::operator=(0.0);
 
    // The above operation is executed on device because of UseDevice().
@@ -202,6 +241,7 @@ void LinearForm::Update(FiniteElementSpace *f, Vector &v, int v_offset)
    NewMemoryAndSize(Memory<double>(v.GetMemory(), v_offset, f->GetVSize()),
                     f->GetVSize(), false);
    ResetDeltaLocations();
+   ResetExtension();
 }
 
 void LinearForm::MakeRef(FiniteElementSpace *f, Vector &v, int v_offset)
@@ -210,6 +250,7 @@ void LinearForm::MakeRef(FiniteElementSpace *f, Vector &v, int v_offset)
    fes = f;
    v.UseDevice(true);
    this->Vector::MakeRef(v, v_offset, fes->GetVSize());
+   ResetExtension();
 }
 
 void LinearForm::AssembleDelta()
@@ -267,6 +308,7 @@ LinearForm & LinearForm::operator=(const Vector &v)
 
 LinearForm::~LinearForm()
 {
+   delete ext;
    if (!extern_lfs)
    {
       int k;
@@ -14,6 +14,7 @@
 
 #include "../config/config.hpp"
 #include "lininteg.hpp"
+#include "linearform_ext.hpp"
 #include "gridfunc.hpp"
 
 namespace mfem
@@ -56,6 +57,16 @@ protected:
    /// Force (re)computation of delta locations.
    void ResetDeltaLocations() { dlfi_delta_elem_id.SetSize(0); }
 
+   /// Whether to use the device assembly when supported, see UseFastAssembly().
+   bool fast_assembly;
+
+   /** @brief Extension for the device assembly, created on the first
+       Assemble() with UseFastAssembly(). */
+   LinearFormExtension *ext;
+
+   /// Delete the extension, e.g. after the space has changed.
+   void ResetExtension() { delete ext; ext = NULL; }
+
 private:
    /// Copy construction is not supported; body is undefined.
    LinearForm(const LinearForm &);
@@ -63,7 +74,8 @@ private:
 public:
    /// Creates linear form associated with FE space @a *f.
    /** The pointer @a f is not owned by the newly constructed object. */
-   LinearForm(FiniteElementSpace *f) : Vector(f->GetVSize())
+   LinearForm(FiniteElementSpace *f) : Vector(f->GetVSize()),
+      fast_assembly(false), ext(NULL)
    { fes = f; extern_lfs = 0; UseDevice(true); }
 
    /** @brief Create a LinearForm on the FiniteElementSpace @a f, using the
@@ -79,14 +91,16 @@ public:
    /** The associated FiniteElementSpace can be set later using one of the
        methods: Update(FiniteElementSpace *) or
        Update(FiniteElementSpace *, Vector &, int). */
-   LinearForm() { fes = NULL; extern_lfs = 0; UseDevice(true); }
+   LinearForm() : fast_assembly(false), ext(NULL)
+   { fes = NULL; extern_lfs = 0; UseDevice(true); }
 
    /// Construct a LinearForm using previously allocated array @a data.
    /** The LinearForm does not assume ownership of @a data which is assumed to
        be of size at least `f->GetVSize()`. Similar to the Vector constructor
        for externally allocated array, the pointer @a data can be NULL. The data
        array can be replaced later using the method SetData(). */
-   LinearForm(FiniteElementSpace *f, double *data) : Vector(data, f->GetVSize())
+   LinearForm(FiniteElementSpace *f, double *data)
+      : Vector(data, f->GetVSize()), fast_assembly(false), ext(NULL)
    { fes = f; extern_lfs = 0; }
 
    /// Copy assignment. Only the data of the base class Vector is copied.
@@ -144,6 +158,11 @@ public:
    /// Access all integrators added with AddBoundaryIntegrator().
    Array<LinearFormIntegrator*> *GetBLFI() { return &blfi; }
 
+   /** @brief Access all boundary markers added with AddBoundaryIntegrator().
+       If no marker was specified when the integrator was added, the
+       corresponding pointer (to Array<int>) will be NULL. */
+   Array<Array<int>*> *GetBLFI_Marker() { return &blfi_marker; }
+
    /// Access all integrators added with AddBdrFaceIntegrator().
    Array<LinearFormIntegrator*> *GetFLFI() { return &flfi; }
 
@@ -155,6 +174,23 @@ public:
    /// Assembles the linear form i.e. sums over all domain/bdr integrators.
    void Assemble();
 
+   /** @brief Enable or disable the device assembly of the linear form in
+       Assemble(). */
+   /** When enabled and SupportsDevice() returns true, Assemble() evaluates the
+       integrators on all elements at once with sum-factorized kernels that run
+       on the device, see LinearFormIntegrator::AssembleDevice(). Otherwise,
+       the element-by-element assembly on the host is used. */
+   void UseFastAssembly(bool use_fa) { fast_assembly = use_fa; }
+
+   /** @brief Return true if the device assembly can be used for the current
+       integrators and space, see UseFastAssembly(). */
+   /** This requires a conforming mesh of quadrilaterals or hexahedra, only
+       domain and boundary integrators that support it, see
+       LinearFormIntegrator::SupportsDevice(), and no delta coefficients. The
+       check of the boundary elements is done once per mesh after the first
+       Assemble() with UseFastAssembly(). */
+   bool SupportsDevice() const;
+
    /// Assembles delta functions of the linear form
    void AssembleDelta();
 
@@ -163,11 +199,15 @@ public:
        updated, e.g. after its associated Mesh object has been refined.
 
        @note This method does not perform assembly. */
-   void Update() { SetSize(fes->GetVSize()); ResetDeltaLocations(); }
+   void Update()
+   { SetSize(fes->GetVSize()); ResetDeltaLocations(); ResetExtension(); }
 
    /// Associate a new FE space, @a *f, with this object and Update() it. */
    void Update(FiniteElementSpace *f)
-   { fes = f; SetSize(f->GetVSize()); ResetDeltaLocations(); }
+   {
+      fes = f; SetSize(f->GetVSize());
+      ResetDeltaLocations(); ResetExtension();
+   }
 
    /** @brief Associate a new FE space, @a *f, with this object and use the data
        of @a v, offset by @a v_offset, to initialize this object's Vector::data.
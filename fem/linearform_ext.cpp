@@ -0,0 +1,119 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+// Implementation of class LinearFormExtension
+
+#include "linearform.hpp"
+#include "../general/forall.hpp"
+
+namespace mfem
+{
+
+bool LinearFormExtension::BdrElementsOnBdrFaces(const Mesh &mesh)
+{
+   for (int i = 0; i < mesh.GetNBE(); i++)
+   {
+      int e1, e2, inf1, inf2;
+      const int f = mesh.GetBdrElementEdgeIndex(i);
+      mesh.GetFaceElements(f, &e1, &e2);
+      mesh.GetFaceInfos(f, &inf1, &inf2);
+      if (e2 >= 0 || inf2 >= 0) { return false; }
+   }
+   return true;
+}
+
+LinearFormExtension::LinearFormExtension(LinearForm *lf) : lf(lf)
+{
+   const FiniteElementSpace &fes = *lf->FESpace();
+   const Mesh &mesh = *fes.GetMesh();
+   bdr_on_bdr_faces = BdrElementsOnBdrFaces(mesh);
+   // The device assembly is not used on these meshes, see SupportsDevice()
+   if (mesh.NURBSext || !mesh.Conforming()) { return; }
+
+   // Boundary attributes in the order of the boundary FaceRestriction
+   Array<int> face_attr(mesh.GetNumFaces());
+   face_attr = 0;
+   for (int i = 0; i < mesh.GetNBE(); i++)
+   {
+      face_attr[mesh.GetBdrElementEdgeIndex(i)] = mesh.GetBdrAttribute(i);
+   }
+   bdr_face_attr.SetSize(fes.GetNFbyType(FaceType::Boundary));
+   int f_ind = 0;
+   for (int f = 0; f < mesh.GetNumFaces(); f++)
+   {
+      int e1, e2, inf1, inf2;
+      mesh.GetFaceElements(f, &e1, &e2);
+      mesh.GetFaceInfos(f, &inf1, &inf2);
+      if (e2 < 0 && inf2 < 0) { bdr_face_attr[f_ind++] = face_attr[f]; }
+   }
+   MFEM_VERIFY(f_ind == bdr_face_attr.Size(), "Unexpected number of faces.");
+}
+
+void LinearFormExtension::Assemble()
+{
+   const FiniteElementSpace &fes = *lf->FESpace();
+   Array<LinearFormIntegrator*> &dlfi = *lf->GetDLFI();
+   Array<LinearFormIntegrator*> &blfi = *lf->GetBLFI();
+   Array<Array<int>*> &blfi_marker = *lf->GetBLFI_Marker();
+
+   const ElementDofOrdering ordering = ElementDofOrdering::LEXICOGRAPHIC;
+   if (dlfi.Size())
+   {
+      const Operator *elem_restrict = fes.GetElementRestriction(ordering);
+      b.SetSize(elem_restrict->Height(), Device::GetMemoryType());
+      b.UseDevice(true);
+      b = 0.0;
+      for (int k = 0; k < dlfi.Size(); k++)
+      {
+         dlfi[k]->AssembleDevice(fes, markers, b);
+      }
+      elem_restrict->MultTranspose(b, *lf);
+   }
+   else
+   {
+      *lf = 0.0;
+   }
+
+   if (blfi.Size())
+   {
+      const Operator *face_restrict =
+         fes.GetFaceRestriction(ordering, FaceType::Boundary,
+                                L2FaceValues::SingleValued);
+      bf.SetSize(face_restrict->Height(), Device::GetMemoryType());
+      bf.UseDevice(true);
+      bf = 0.0;
+      const int NF = bdr_face_attr.Size();
+      markers.SetSize(NF, Device::GetMemoryType());
+      for (int k = 0; k < blfi.Size(); k++)
+      {
+         const bool all = (blfi_marker[k] == NULL);
+         const Array<int> &bdr_marker = all ? bdr_face_attr : *blfi_marker[k];
+         MFEM_VERIFY(all || bdr_marker.Size() ==
+                     fes.GetMesh()->bdr_attributes.Max(),
+                     "invalid boundary marker for boundary integrator #"
+                     << k << ", counting from zero");
+         const auto attr = bdr_face_attr.Read();
+         const auto marker = bdr_marker.Read();
+         auto M = markers.Write();
+         MFEM_FORALL(f, NF,
+         {
+            const int a = attr[f];
+            M[f] = (a == 0) ? 0 : (all ? 1 : (marker[a-1] != 0));
+         });
+         blfi[k]->AssembleDevice(fes, markers, bf);
+      }
+      // H1FaceRestriction::MultTranspose() adds to the L-vector
+      lf->Read();
+      face_restrict->MultTranspose(bf, *lf);
+   }
+}
+
+} // namespace mfem
@@ -0,0 +1,66 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_LINEARFORM_EXT
+#define MFEM_LINEARFORM_EXT
+
+#include "../config/config.hpp"
+#include "../linalg/vector.hpp"
+#include "../general/array.hpp"
+
+namespace mfem
+{
+
+class LinearForm;
+class Mesh;
+
+/// Device assembly of a LinearForm, see LinearForm::UseFastAssembly().
+/** The domain integrators are assembled into the E-vector of the lexicographic
+    ElementRestriction and the boundary integrators into the E-vector of the
+    lexicographic boundary FaceRestriction. Both are then added to the
+    LinearForm with the transpose of the restrictions. */
+class LinearFormExtension
+{
+protected:
+   LinearForm *lf; ///< Not owned
+
+   /// Boundary attribute of each boundary face, 0 if not a boundary element.
+   Array<int> bdr_face_attr;
+
+   /// Cached result of BdrElementsOnBdrFaces() for the mesh of the space.
+   bool bdr_on_bdr_faces;
+
+   /// Boundary face markers of the current boundary integrator.
+   Array<int> markers;
+
+   /// Domain and boundary E-vectors.
+   Vector b, bf;
+
+public:
+   LinearFormExtension(LinearForm *lf);
+
+   /** @brief Return true if all boundary elements of @a mesh are on boundary
+       faces, as required by the device assembly of boundary integrators. */
+   /** Boundary elements on interior faces are not in the boundary
+       FaceRestriction. The check loops over all boundary elements. */
+   static bool BdrElementsOnBdrFaces(const Mesh &mesh);
+
+   /** @brief Return BdrElementsOnBdrFaces() for the mesh of the LinearForm,
+       computed once when the extension was constructed. */
+   bool SupportsBdrIntegrators() const { return bdr_on_bdr_faces; }
+
+   /// Assemble the LinearForm on the device.
+   void Assemble();
+};
+
+} // namespace mfem
+
+#endif // MFEM_LINEARFORM_EXT
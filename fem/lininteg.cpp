@@ -22,6 +22,13 @@ void LinearFormIntegrator::AssembleRHSElementVect(
    mfem_error("LinearFormIntegrator::AssembleRHSElementVect(...)");
 }
 
+void LinearFormIntegrator::AssembleDevice(const FiniteElementSpace&,
+                                          const Array<int>&, Vector&)
+{
+   mfem_error("LinearFormIntegrator::AssembleDevice(...)\n"
+              "   is not implemented for this class.");
+}
+
 
 void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
                                                 ElementTransformation &Tr,
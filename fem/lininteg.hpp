@@ -18,6 +18,8 @@
 namespace mfem
 {
 
+class FiniteElementSpace;
+
 /// Abstract base class LinearFormIntegrator
 class LinearFormIntegrator
 {
@@ -36,6 +38,22 @@ public:
                                        FaceElementTransformations &Tr,
                                        Vector &elvect);
 
+   /** @brief Return true if the integrator can be assembled on the device
+       with AssembleDevice() on the space @a fes. */
+   virtual bool SupportsDevice(const FiniteElementSpace &fes) const
+   { return false; }
+
+   /** @brief Add the device assembly of the integrator to the E-vector @a b,
+       see LinearForm::UseFastAssembly(). */
+   /** For domain integrators, @a b is the E-vector of the lexicographic
+       ElementRestriction of @a fes, with the layout (ND x VDIM x NE). For
+       boundary integrators, @a b is the E-vector of the lexicographic boundary
+       FaceRestriction of @a fes, with the layout (NFD x VDIM x NF), and
+       @a markers gives for each boundary face whether it is integrated (1) or
+       not (0). */
+   virtual void AssembleDevice(const FiniteElementSpace &fes,
+                               const Array<int> &markers, Vector &b);
+
    virtual void SetIntRule(const IntegrationRule *ir) { IntRule = ir; }
    const IntegrationRule* GetIntRule() { return IntRule; }
 
@@ -116,6 +134,11 @@ public:
                                          ElementTransformation &Trans,
                                          Vector &elvect);
 
+   virtual bool SupportsDevice(const FiniteElementSpace &fes) const;
+
+   virtual void AssembleDevice(const FiniteElementSpace &fes,
+                               const Array<int> &markers, Vector &b);
+
    using LinearFormIntegrator::AssembleRHSElementVect;
 };
 
@@ -166,6 +189,11 @@ public:
    virtual void AssembleRHSElementVect(const FiniteElement &el,
                                        FaceElementTransformations &Tr,
                                        Vector &elvect);
+
+   virtual bool SupportsDevice(const FiniteElementSpace &fes) const;
+
+   virtual void AssembleDevice(const FiniteElementSpace &fes,
+                               const Array<int> &markers, Vector &b);
 };
 
 /// Class for boundary integration \f$ L(v) = (g \cdot n, v) \f$
@@ -227,6 +255,11 @@ public:
                                          ElementTransformation &Trans,
                                          Vector &elvect);
 
+   virtual bool SupportsDevice(const FiniteElementSpace &fes) const;
+
+   virtual void AssembleDevice(const FiniteElementSpace &fes,
+                               const Array<int> &markers, Vector &b);
+
    using LinearFormIntegrator::AssembleRHSElementVect;
 };
 
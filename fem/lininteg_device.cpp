@@ -0,0 +1,450 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../general/forall.hpp"
+#include "fem.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// Device assembly of LinearFormIntegrators, see LinearForm::UseFastAssembly()
+
+// Evaluate the vector coefficient @a Q at the points of @a ir in all elements
+// of @a fes, with the layout VDIM x NQ x NE. A constant coefficient gives a
+// Vector of size VDIM and a VectorQuadratureFunctionCoefficient is referenced
+// directly.
+static void LFEvalVectorCoefficient(VectorCoefficient &Q,
+                                    const FiniteElementSpace &fes,
+                                    const IntegrationRule &ir, Vector &coeff)
+{
+   const int NE = fes.GetNE();
+   const int NQ = ir.GetNPoints();
+   const int vdim = Q.GetVDim();
+   if (VectorConstantCoefficient *cQ =
+          dynamic_cast<VectorConstantCoefficient*>(&Q))
+   {
+      coeff = cQ->GetVec();
+      return;
+   }
+   if (VectorQuadratureFunctionCoefficient *qQ =
+          dynamic_cast<VectorQuadratureFunctionCoefficient*>(&Q))
+   {
+      const QuadratureFunction &qFun = qQ->GetQuadFunction();
+      // With a component subset, the values are not contiguous
+      if (qFun.GetVDim() == vdim)
+      {
+         MFEM_VERIFY(qFun.Size() == vdim * NQ * NE,
+                     "Incompatible QuadratureFunction dimension \n");
+         MFEM_VERIFY(&ir == &qFun.GetSpace()->GetElementIntRule(0),
+                     "IntegrationRule used within integrator and in"
+                     " QuadratureFunction appear to be different");
+         qFun.Read();
+         coeff.MakeRef(const_cast<QuadratureFunction &>(qFun), 0);
+         return;
+      }
+   }
+   // Use the batched VectorCoefficient::Project() when the QuadratureSpace with
+   // the order of ir uses the same IntegrationRule.
+   QuadratureSpace qs(fes.GetMesh(), ir.GetOrder());
+   if (NE > 0 && &qs.GetElementIntRule(0) == &ir)
+   {
+      QuadratureFunction qf(&qs, vdim);
+      Q.Project(qf);
+      coeff.Swap(qf);
+      return;
+   }
+   Vector Qvec(vdim);
+   coeff.SetSize(vdim * NQ * NE);
+   auto C = Reshape(coeff.HostWrite(), vdim, NQ, NE);
+   for (int e = 0; e < NE; ++e)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      for (int q = 0; q < NQ; ++q)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         Q.Eval(Qvec, T, ip);
+         for (int c = 0; c < vdim; ++c) { C(c,q,e) = Qvec(c); }
+      }
+   }
+}
+
+// Add the integrals of the shape functions against the coefficient values
+// @a coeff, with the layout VDIM x NQ x NE or VDIM if constant, to the
+// lexicographic E-vector @a b, by sum factorization. The quadrature weights
+// @a w are scaled by the determinants @a detj. The same kernels are used for
+// the boundary faces, with NE the number of faces.
+static void LFAssemble1D(const int NE, const int vdim,
+                         const int D1D, const int Q1D,
+                         const Array<double> &b1d,
+                         const Array<double> &w, const Vector &detj,
+                         const Vector &coeff, Vector &b)
+{
+   const bool const_c = (coeff.Size() == vdim);
+   const auto B = Reshape(b1d.Read(), Q1D, D1D);
+   const auto W = w.Read();
+   const auto J = Reshape(detj.Read(), Q1D, NE);
+   const auto C = const_c ? Reshape(coeff.Read(), vdim, 1, 1) :
+                  Reshape(coeff.Read(), vdim, Q1D, NE);
+   auto Y = Reshape(b.ReadWrite(), D1D, vdim, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int c = 0; c < vdim; ++c)
+      {
+         for (int d = 0; d < D1D; ++d)
+         {
+            double s = 0.0;
+            for (int q = 0; q < Q1D; ++q)
+            {
+               const double f = const_c ? C(c,0,0) : C(c,q,e);
+               s += B(q,d) * W[q] * J(q,e) * f;
+            }
+            Y(d,c,e) += s;
+         }
+      }
+   });
+}
+
+static void LFAssemble2D(const int NE, const int vdim,
+                         const int D1D, const int Q1D,
+                         const Array<double> &b1d,
+                         const Array<double> &w, const Vector &detj,
+                         const Vector &coeff, Vector &b)
+{
+   MFEM_VERIFY(D1D <= MAX_D1D && Q1D <= MAX_Q1D, "");
+   const bool const_c = (coeff.Size() == vdim);
+   const auto B = Reshape(b1d.Read(), Q1D, D1D);
+   const auto W = Reshape(w.Read(), Q1D, Q1D);
+   const auto J = Reshape(detj.Read(), Q1D, Q1D, NE);
+   const auto C = const_c ? Reshape(coeff.Read(), vdim, 1, 1, 1) :
+                  Reshape(coeff.Read(), vdim, Q1D, Q1D, NE);
+   auto Y = Reshape(b.ReadWrite(), D1D, D1D, vdim, NE);
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MD1 = MAX_D1D;
+      constexpr int MQ1 = MAX_Q1D;
+      double F[MQ1][MQ1];
+      double A[MQ1][MD1];
+      for (int c = 0; c < vdim; ++c)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double f = const_c ? C(c,0,0,0) : C(c,qx,qy,e);
+               F[qy][qx] = W(qx,qy) * J(qx,qy,e) * f;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double s = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx) { s += B(qx,dx) * F[qy][qx]; }
+               A[qy][dx] = s;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double s = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy) { s += B(qy,dy) * A[qy][dx]; }
+               Y(dx,dy,c,e) += s;
+            }
+         }
+      }
+   });
+}
+
+static void LFAssemble3D(const int NE, const int vdim,
+                         const int D1D, const int Q1D,
+                         const Array<double> &b1d,
+                         const Array<double> &w, const Vector &detj,
+                         const Vector &coeff, Vector &b)
+{
+   MFEM_VERIFY(D1D <= MAX_D1D && Q1D <= MAX_Q1D, "");
+   const bool const_c = (coeff.Size() == vdim);
+   const auto B = Reshape(b1d.Read(), Q1D, D1D);
+   const auto W = Reshape(w.Read(), Q1D, Q1D, Q1D);
+   const auto J = Reshape(detj.Read(), Q1D, Q1D, Q1D, NE);
+   const auto C = const_c ? Reshape(coeff.Read(), vdim, 1, 1, 1, 1) :
+                  Reshape(coeff.Read(), vdim, Q1D, Q1D, Q1D, NE);
+   auto Y = Reshape(b.ReadWrite(), D1D, D1D, D1D, vdim, NE);
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MD1 = MAX_D1D;
+      constexpr int MQ1 = MAX_Q1D;
+      double A[MQ1][MD1];
+      double Z[MD1][MD1][MD1];
+      for (int c = 0; c < vdim; ++c)
+      {
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx) { Z[dz][dy][dx] = 0.0; }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double s = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     const double f = const_c ? C(c,0,0,0,0) : C(c,qx,qy,qz,e);
+                     s += B(qx,dx) * W(qx,qy,qz) * J(qx,qy,qz,e) * f;
+                  }
+                  A[qy][dx] = s;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double s = 0.0;
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     s += B(qy,dy) * A[qy][dx];
+                  }
+                  for (int dz = 0; dz < D1D; ++dz)
+                  {
+                     Z[dz][dy][dx] += B(qz,dz) * s;
+                  }
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  Y(dx,dy,dz,c,e) += Z[dz][dy][dx];
+               }
+            }
+         }
+      }
+   });
+}
+
+static void LFDomainAssemble(const FiniteElementSpace &fes,
+                             const IntegrationRule &ir, const int vdim,
+                             const Vector &coeff, Vector &b)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int dim = mesh->Dimension();
+   const int NE = fes.GetNE();
+   const FiniteElement &el = *fes.GetFE(0);
+   const DofToQuad &maps = el.GetDofToQuad(ir, DofToQuad::TENSOR);
+   const int D1D = maps.ndof;
+   const int Q1D = maps.nqpt;
+   MFEM_VERIFY(ir.GetNPoints() == ((dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D),
+               "The IntegrationRule is not a tensor product.");
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(ir, GeometricFactors::DETERMINANTS);
+   const Array<double> &W = ir.GetWeights();
+   if (dim == 2)
+   {
+      return LFAssemble2D(NE, vdim, D1D, Q1D, maps.B, W, geom->detJ,
+                          coeff, b);
+   }
+   LFAssemble3D(NE, vdim, D1D, Q1D, maps.B, W, geom->detJ, coeff, b);
+}
+
+bool DomainLFIntegrator::SupportsDevice(const FiniteElementSpace &fes) const
+{
+   return !IsDelta() && fes.GetVDim() == 1 && UsesTensorBasis(fes);
+}
+
+void DomainLFIntegrator::AssembleDevice(const FiniteElementSpace &fes,
+                                        const Array<int> &markers, Vector &b)
+{
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule ? IntRule :
+                               &IntRules.Get(el.GetGeomType(),
+                                             oa * el.GetOrder() + ob);
+   Vector coeff;
+   PAEvalCoefficient(&Q, fes, *ir, coeff);
+   LFDomainAssemble(fes, *ir, 1, coeff, b);
+}
+
+bool VectorDomainLFIntegrator::SupportsDevice(
+   const FiniteElementSpace &fes) const
+{
+   return !IsDelta() && fes.GetVDim() == Q.GetVDim() && UsesTensorBasis(fes);
+}
+
+void VectorDomainLFIntegrator::AssembleDevice(const FiniteElementSpace &fes,
+                                              const Array<int> &markers,
+                                              Vector &b)
+{
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule ? IntRule :
+                               &IntRules.Get(el.GetGeomType(),
+                                             2 * el.GetOrder());
+   Vector coeff;
+   LFEvalVectorCoefficient(Q, fes, *ir, coeff);
+   LFDomainAssemble(fes, *ir, Q.GetVDim(), coeff, b);
+}
+
+// Return the lexicographic index, in the boundary FaceRestriction ordering, of
+// the face point with coordinates @a eip in the reference element. The Q1D
+// points of the 1D rule are the x-coordinates of the first points of @a ir.
+static int LFBdrFacePoint(const int dim, const IntegrationPoint &eip,
+                          const IntegrationRule &ir, const int Q1D)
+{
+   const double tol = 1e-10;
+   const double x[3] = { eip.x, eip.y, eip.z };
+   int normal = -1;
+   for (int d = 0; d < dim && normal < 0; ++d)
+   {
+      if (std::abs(x[d]) < tol || std::abs(x[d] - 1.0) < tol) { normal = d; }
+   }
+   MFEM_VERIFY(normal >= 0, "The point is not on a face of the element.");
+   int q = 0, stride = 1;
+   for (int d = 0; d < dim; ++d)
+   {
+      if (d == normal) { continue; }
+      int i = 0;
+      while (i < Q1D && std::abs(ir.IntPoint(i).x - x[d]) > tol) { ++i; }
+      MFEM_VERIFY(i < Q1D, "The face IntegrationRule is not a tensor product.");
+      q += stride*i;
+      stride *= Q1D;
+   }
+   return q;
+}
+
+// Evaluate the coefficient @a Q at the points of the face rule @a ir on the
+// boundary faces of @a fes, with the layout NQ x NF, in the ordering of the
+// boundary FaceRestriction. A constant coefficient gives a Vector of size 1.
+static void LFEvalBdrCoefficient(Coefficient &Q, const FiniteElementSpace &fes,
+                                 const IntegrationRule &ir, const int Q1D,
+                                 Vector &coeff)
+{
+   if (ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(&Q))
+   {
+      coeff.SetSize(1);
+      coeff(0) = cQ->constant;
+      return;
+   }
+   Mesh *mesh = fes.GetMesh();
+   const int dim = mesh->Dimension();
+   const int NQ = ir.GetNPoints();
+   const int NF = fes.GetNFbyType(FaceType::Boundary);
+   Array<int> face_be(mesh->GetNumFaces());
+   face_be = -1;
+   for (int i = 0; i < mesh->GetNBE(); i++)
+   {
+      face_be[mesh->GetBdrElementEdgeIndex(i)] = i;
+   }
+   coeff.SetSize(NQ * NF);
+   auto C = Reshape(coeff.HostWrite(), NQ, NF);
+   int f_ind = 0;
+   for (int f = 0; f < mesh->GetNumFaces(); ++f)
+   {
+      int e1, e2, inf1, inf2;
+      mesh->GetFaceElements(f, &e1, &e2);
+      mesh->GetFaceInfos(f, &inf1, &inf2);
+      if (e2 >= 0 || inf2 >= 0) { continue; }
+      if (face_be[f] < 0)
+      {
+         for (int q = 0; q < NQ; ++q) { C(q,f_ind) = 0.0; }
+         f_ind++;
+         continue;
+      }
+      FaceElementTransformations &T =
+         *mesh->GetBdrFaceTransformations(face_be[f]);
+      for (int q = 0; q < NQ; ++q)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetAllIntPoints(&ip);
+         const int lq = LFBdrFacePoint(dim, T.GetElement1IntPoint(), ir, Q1D);
+         C(lq,f_ind) = Q.Eval(T, ip);
+      }
+      f_ind++;
+   }
+   MFEM_VERIFY(f_ind == NF, "Unexpected number of faces.");
+}
+
+bool BoundaryLFIntegrator::SupportsDevice(const FiniteElementSpace &fes) const
+{
+   // Requirements of H1FaceRestriction and FaceGeometricFactors
+   if (fes.GetVDim() != 1 || fes.IsDGSpace()) { return false; }
+   const GridFunction *nodes = fes.GetMesh()->GetNodes();
+   const FiniteElementSpace *spaces[2] =
+   { &fes, nodes ? nodes->FESpace() : NULL };
+   for (int i = 0; i < 2; i++)
+   {
+      if (spaces[i] == NULL) { continue; }
+      const TensorBasisElement *tfe =
+         dynamic_cast<const TensorBasisElement*>(spaces[i]->GetFE(0));
+      if (spaces[i]->IsDGSpace() || tfe == NULL ||
+          (tfe->GetBasisType() != BasisType::GaussLobatto &&
+           tfe->GetBasisType() != BasisType::Positive))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+void BoundaryLFIntegrator::AssembleDevice(const FiniteElementSpace &fes,
+                                          const Array<int> &markers,
+                                          Vector &b)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int dim = mesh->Dimension();
+   const int NF = fes.GetNFbyType(FaceType::Boundary);
+   if (NF == 0) { return; }
+   const Geometry::Type face_geom = mesh->GetFaceBaseGeometry(0);
+   const FiniteElement &el = *fes.GetTraceElement(0, face_geom);
+   const int ir_order = oa * el.GetOrder() + ob;
+   const IntegrationRule *ir =
+      IntRule ? IntRule : &IntRules.Get(face_geom, ir_order);
+   const DofToQuad &maps = el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   const int D1D = maps.ndof;
+   const int Q1D = maps.nqpt;
+   const int NQ = ir->GetNPoints();
+   MFEM_VERIFY(NQ == ((dim == 2) ? Q1D : Q1D*Q1D),
+               "The face IntegrationRule is not a tensor product.");
+   const FaceGeometricFactors *geom =
+      mesh->GetFaceGeometricFactors(*ir, FaceGeometricFactors::DETERMINANTS,
+                                    FaceType::Boundary);
+
+   // Restrict the determinants to the marked faces
+   Vector detj(NQ * NF);
+   const auto M = markers.Read();
+   const auto D = Reshape(geom->detJ.Read(), NQ, NF);
+   auto DM = Reshape(detj.Write(), NQ, NF);
+   MFEM_FORALL(qf, NQ*NF,
+   {
+      const int q = qf % NQ;
+      const int f = qf / NQ;
+      DM(q,f) = M[f] ? D(q,f) : 0.0;
+   });
+
+   Vector coeff;
+   LFEvalBdrCoefficient(Q, fes, *ir, Q1D, coeff);
+   const Array<double> &W = ir->GetWeights();
+   if (dim == 2)
+   {
+      return LFAssemble1D(NF, 1, D1D, Q1D, maps.B, W, detj, coeff, b);
+   }
+   LFAssemble2D(NF, 1, D1D, Q1D, maps.B, W, detj, coeff, b);
+}
+
+} // namespace mfem
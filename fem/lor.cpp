@@ -0,0 +1,394 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "lor.hpp"
+#include <algorithm>
+#include <climits>
+#include <map>
+
+namespace mfem
+{
+
+static Geometry::Type GetTensorGeometry(int dim)
+{
+   return (dim == 1) ? Geometry::SEGMENT :
+          (dim == 2) ? Geometry::SQUARE : Geometry::CUBE;
+}
+
+LORBase::LORBase(FiniteElementSpace &fes_ho_, int ref_type_)
+   : fes_ho(fes_ho_), ref_type(ref_type_), mesh(NULL), fec(NULL), fes(NULL),
+     a(NULL)
+{
+   Mesh *mesh_ho = fes_ho.GetMesh();
+   const int dim = mesh_ho->Dimension();
+   MFEM_VERIFY(mesh_ho->Conforming() && !fes_ho.GetNURBSext(),
+               "LOR discretizations require a conforming, non-NURBS mesh");
+   Array<Geometry::Type> geoms;
+   mesh_ho->GetGeometries(dim, geoms);
+   for (int i = 0; i < geoms.Size(); i++)
+   {
+      MFEM_VERIFY(geoms[i] == GetTensorGeometry(dim),
+                  "LOR discretizations require tensor product elements");
+   }
+   MFEM_VERIFY(GetFESpaceType() != INVALID,
+               "the space must be H1, ND, RT or L2");
+}
+
+LORBase::FESpaceType LORBase::GetFESpaceType() const
+{
+   const FiniteElementCollection *fec_ho = fes_ho.FEColl();
+   if (dynamic_cast<const H1_FECollection*>(fec_ho)) { return H1; }
+   else if (dynamic_cast<const ND_FECollection*>(fec_ho)) { return ND; }
+   else if (dynamic_cast<const RT_FECollection*>(fec_ho)) { return RT; }
+   else if (dynamic_cast<const L2_FECollection*>(fec_ho)) { return L2; }
+   return INVALID;
+}
+
+int LORBase::GetRefinementFactor() const
+{
+   const int dim = fes_ho.GetMesh()->Dimension();
+   const Geometry::Type geom = GetTensorGeometry(dim);
+   const FiniteElement *fe = fes_ho.FEColl()->FiniteElementForGeometry(geom);
+   // The L2 elements of order p have p+1 DOFs in each direction, the other
+   // elements have p+1 closed points, i.e. p sub-intervals.
+   return (GetFESpaceType() == L2) ? fe->GetOrder() + 1 : fe->GetOrder();
+}
+
+void LORBase::ConstructFECollection()
+{
+   const int dim = fes_ho.GetMesh()->Dimension();
+   switch (GetFESpaceType())
+   {
+      case H1: fec = new H1_FECollection(1, dim); break;
+      case ND: fec = new ND_FECollection(1, dim); break;
+      case RT: fec = new RT_FECollection(0, dim); break;
+      case L2:
+      {
+         const Geometry::Type geom = GetTensorGeometry(dim);
+         const FiniteElement *fe =
+            fes_ho.FEColl()->FiniteElementForGeometry(geom);
+         fec = new L2_FECollection(0, dim, BasisType::GaussLegendre,
+                                   fe->GetMapType());
+         break;
+      }
+      default: MFEM_ABORT("unsupported space type");
+   }
+}
+
+// Compute the local DOF keys used to match the LOR and the high-order DOFs in
+// one high-order element. A DOF is identified by the direction of its basis
+// function (for vector spaces) and, in each coordinate direction, by the rank
+// of its node coordinate among the "closed" coordinates (the vertices of the
+// LOR elements) or among the "open" coordinates (the interiors of the LOR
+// edges, faces or elements). Both sets are sorted, so the ranks do not depend
+// on the actual basis of the high-order space. The ranks are combined into one
+// integer with the given base, which must be larger than twice the number of
+// nodes.
+static void GetLocalDofKeys(const DenseMatrix &nodes, const Array<int> &dirs,
+                            const Array<bool> &open, const long long base,
+                            std::vector<long long> &keys)
+{
+   const int dim = nodes.Height();
+   const int n = nodes.Width();
+   const double tol = 1e-8;
+   keys.assign(n, 0);
+   for (int d = 0; d < dim; d++)
+   {
+      for (int c = 0; c < 2; c++)
+      {
+         std::vector<double> vals;
+         for (int i = 0; i < n; i++)
+         {
+            if (open[i*dim + d] == bool(c)) { vals.push_back(nodes(d,i)); }
+         }
+         std::sort(vals.begin(), vals.end());
+         std::vector<double> uvals;
+         for (size_t k = 0; k < vals.size(); k++)
+         {
+            if (uvals.empty() || vals[k] - uvals.back() > tol)
+            {
+               uvals.push_back(vals[k]);
+            }
+         }
+         for (int i = 0; i < n; i++)
+         {
+            if (open[i*dim + d] != bool(c)) { continue; }
+            const int rank = std::lower_bound(uvals.begin(), uvals.end(),
+                                              nodes(d,i) - tol) - uvals.begin();
+            keys[i] = keys[i]*base + 2*rank + c;
+         }
+      }
+   }
+   for (int i = 0; i < n; i++) { keys[i] = keys[i]*(dim + 1) + dirs[i] + 1; }
+}
+
+// Return the direction and the sign of the vector basis function 'i' from the
+// rows of 'vshape', which are aligned with the coordinate axes.
+static int GetDofDirection(const DenseMatrix &vshape, int i, int &sign)
+{
+   int dir = 0;
+   for (int d = 1; d < vshape.Width(); d++)
+   {
+      if (std::abs(vshape(i,d)) > std::abs(vshape(i,dir))) { dir = d; }
+   }
+   sign = (vshape(i,dir) > 0.0) ? 1 : -1;
+   return dir;
+}
+
+void LORBase::ConstructDofPermutation() const
+{
+   const FESpaceType type = GetFESpaceType();
+   const int vdim = fes_ho.GetVDim();
+   perm.SetSize(fes_ho.GetVSize());
+   if (type == H1)
+   {
+      // The vertices of the LOR mesh are numbered as the DOFs of the H1 space
+      // of order ref_factor, see Mesh::Mesh(Mesh*, int, int).
+      for (int i = 0; i < perm.Size(); i++) { perm[i] = i; }
+      return;
+   }
+   if (mesh->GetNE() == 0) { return; }
+
+   const int dim = mesh->Dimension();
+   const bool vector = (type == ND || type == RT);
+   const FiniteElement *fe_ho = fes_ho.GetFE(0);
+   const FiniteElement *fe_lor = fes->GetFE(0);
+   const Geometry::Type geom = fe_ho->GetGeomType();
+   const CoarseFineTransformations &cf = mesh->GetRefinementTransforms();
+   const DenseTensor &pmats = cf.point_matrices[geom];
+   const int nref = pmats.SizeK();
+   const int ndof_ho = fe_ho->GetDof();
+   const int ndof_lor = fe_lor->GetDof();
+   MFEM_VERIFY(ndof_ho == nref*ndof_lor || type != L2, "internal error");
+
+   // Nodes, directions and signs of the high-order and LOR local DOFs, in the
+   // reference coordinates of the high-order element.
+   DenseMatrix nodes_ho(dim, ndof_ho), nodes_lor(dim, nref*ndof_lor);
+   Array<int> dirs_ho(ndof_ho), dirs_lor(nref*ndof_lor);
+   Array<int> signs_ho(ndof_ho), signs_lor(nref*ndof_lor);
+   dirs_ho = -1; dirs_lor = -1;
+   signs_ho = 1; signs_lor = 1;
+
+   DenseMatrix vshape(ndof_ho, dim);
+   for (int i = 0; i < ndof_ho; i++)
+   {
+      const IntegrationPoint &ip = fe_ho->GetNodes().IntPoint(i);
+      ip.Get(nodes_ho.GetColumn(i), dim);
+      if (vector)
+      {
+         fe_ho->CalcVShape(ip, vshape);
+         dirs_ho[i] = GetDofDirection(vshape, i, signs_ho[i]);
+      }
+   }
+
+   IsoparametricTransformation T;
+   T.SetIdentityTransformation(geom);
+   vshape.SetSize(ndof_lor, dim);
+   Vector x;
+   for (int j = 0; j < nref; j++)
+   {
+      T.SetPointMat(pmats(j));
+      for (int l = 0; l < ndof_lor; l++)
+      {
+         const int i = j*ndof_lor + l;
+         const IntegrationPoint &ip = fe_lor->GetNodes().IntPoint(l);
+         T.Transform(ip, x);
+         for (int d = 0; d < dim; d++) { nodes_lor(d,i) = x(d); }
+         if (vector)
+         {
+            T.SetIntPoint(&ip);
+            fe_lor->CalcVShape(T, vshape);
+            dirs_lor[i] = GetDofDirection(vshape, l, signs_lor[i]);
+         }
+      }
+   }
+
+   // ND: open along the tangent, RT: open across the normal, L2: interior
+   Array<bool> open_ho(dim*ndof_ho), open_lor(dim*nref*ndof_lor);
+   for (int d = 0; d < dim; d++)
+   {
+      for (int i = 0; i < ndof_ho; i++)
+      {
+         open_ho[i*dim + d] =
+            (type == L2) || ((dirs_ho[i] == d) == (type == ND));
+      }
+      for (int i = 0; i < nref*ndof_lor; i++)
+      {
+         open_lor[i*dim + d] =
+            (type == L2) || ((dirs_lor[i] == d) == (type == ND));
+      }
+   }
+
+   std::vector<long long> keys_ho, keys_lor;
+   const long long base = 2*(ndof_ho + nref*ndof_lor) + 2;
+   GetLocalDofKeys(nodes_ho, dirs_ho, open_ho, base, keys_ho);
+   GetLocalDofKeys(nodes_lor, dirs_lor, open_lor, base, keys_lor);
+   std::map<long long, int> key_to_ho;
+   for (int i = 0; i < ndof_ho; i++) { key_to_ho[keys_ho[i]] = i; }
+   MFEM_VERIFY((int) key_to_ho.size() == ndof_ho, "internal error");
+
+   // Local permutation: LOR DOF l in sub-element j -> high-order local DOF
+   Array<int> loc_perm(nref*ndof_lor), loc_sign(nref*ndof_lor);
+   for (int i = 0; i < nref*ndof_lor; i++)
+   {
+      std::map<long long, int>::const_iterator it = key_to_ho.find(keys_lor[i]);
+      MFEM_VERIFY(it != key_to_ho.end(), "LOR DOF without high-order DOF");
+      loc_perm[i] = it->second;
+      loc_sign[i] = signs_lor[i]*signs_ho[it->second];
+   }
+
+   Array<int> sperm(fes->GetNDofs()), dofs_ho, dofs_lor;
+   sperm = INT_MAX;
+   for (int el = 0; el < mesh->GetNE(); el++)
+   {
+      const Embedding &emb = cf.embeddings[el];
+      fes_ho.GetElementDofs(emb.parent, dofs_ho);
+      fes->GetElementDofs(el, dofs_lor);
+      for (int l = 0; l < ndof_lor; l++)
+      {
+         const int i = emb.matrix*ndof_lor + l;
+         const int d_lor = dofs_lor[l], d_ho = dofs_ho[loc_perm[i]];
+         const int i_lor = (d_lor >= 0) ? d_lor : -1 - d_lor;
+         const int i_ho = (d_ho >= 0) ? d_ho : -1 - d_ho;
+         const int s = loc_sign[i]*((d_lor >= 0) == (d_ho >= 0) ? 1 : -1);
+         sperm[i_lor] = (s > 0) ? i_ho : -1 - i_ho;
+      }
+   }
+   MFEM_VERIFY(sperm.Size() == 0 || sperm.Max() < INT_MAX, "internal error");
+
+   for (int vd = 0; vd < vdim; vd++)
+   {
+      for (int i = 0; i < sperm.Size(); i++)
+      {
+         const int j = (sperm[i] >= 0) ? sperm[i] : -1 - sperm[i];
+         const int vj = fes_ho.DofToVDof(j, vd);
+         perm[fes->DofToVDof(i, vd)] = (sperm[i] >= 0) ? vj : -1 - vj;
+      }
+   }
+}
+
+const Array<int> &LORBase::GetDofPermutation() const
+{
+   if (perm.Size() == 0 && fes_ho.GetVSize() > 0) { ConstructDofPermutation(); }
+   return perm;
+}
+
+void LORBase::SetupProlongationAndRestriction()
+{
+   if (HasSameDofNumbering())
+   {
+      // Same DOFs and same true DOFs as the high-order space
+      MFEM_VERIFY(fes->GetVSize() == fes_ho.GetVSize(), "internal error");
+      return;
+   }
+   fes->CopyProlongationAndRestriction(fes_ho, &GetDofPermutation());
+}
+
+void LORBase::AssembleSystem(BilinearForm &a_ho,
+                             const Array<int> &ess_tdof_list)
+{
+   a->UseExternalIntegrators();
+   Array<BilinearFormIntegrator*> *dbfi = a_ho.GetDBFI();
+   for (int i = 0; i < dbfi->Size(); i++)
+   {
+      a->AddDomainIntegrator((*dbfi)[i]);
+   }
+   Array<BilinearFormIntegrator*> *bbfi = a_ho.GetBBFI();
+   Array<Array<int>*> *bbfi_marker = a_ho.GetBBFI_Marker();
+   for (int i = 0; i < bbfi->Size(); i++)
+   {
+      if ((*bbfi_marker)[i])
+      {
+         a->AddBoundaryIntegrator((*bbfi)[i], *(*bbfi_marker)[i]);
+      }
+      else
+      {
+         a->AddBoundaryIntegrator((*bbfi)[i]);
+      }
+   }
+   Array<BilinearFormIntegrator*> *fbfi = a_ho.GetFBFI();
+   for (int i = 0; i < fbfi->Size(); i++)
+   {
+      a->AddInteriorFaceIntegrator((*fbfi)[i]);
+   }
+   Array<BilinearFormIntegrator*> *bfbfi = a_ho.GetBFBFI();
+   Array<Array<int>*> *bfbfi_marker = a_ho.GetBFBFI_Marker();
+   for (int i = 0; i < bfbfi->Size(); i++)
+   {
+      if ((*bfbfi_marker)[i])
+      {
+         a->AddBdrFaceIntegrator((*bfbfi)[i], *(*bfbfi_marker)[i]);
+      }
+      else
+      {
+         a->AddBdrFaceIntegrator((*bfbfi)[i]);
+      }
+   }
+   a->Assemble();
+   a->FormSystemMatrix(ess_tdof_list, A);
+}
+
+LORBase::~LORBase()
+{
+   delete a;
+   delete fes;
+   delete fec;
+   delete mesh;
+}
+
+LORDiscretization::LORDiscretization(BilinearForm &a_ho,
+                                     const Array<int> &ess_tdof_list,
+                                     int ref_type)
+   : LORBase(*a_ho.FESpace(), ref_type)
+{
+   mesh = new Mesh(fes_ho.GetMesh(), GetRefinementFactor(), ref_type);
+   ConstructFECollection();
+   fes = new FiniteElementSpace(mesh, fec, fes_ho.GetVDim(),
+                                fes_ho.GetOrdering());
+   SetupProlongationAndRestriction();
+   a = new BilinearForm(fes);
+   AssembleSystem(a_ho, ess_tdof_list);
+}
+
+SparseMatrix &LORDiscretization::GetAssembledMatrix() const
+{
+   MFEM_VERIFY(A.Ptr() != NULL, "No LOR system assembled");
+   return *A.As<SparseMatrix>();
+}
+
+#ifdef MFEM_USE_MPI
+
+ParLORDiscretization::ParLORDiscretization(ParBilinearForm &a_ho,
+                                           const Array<int> &ess_tdof_list,
+                                           int ref_type)
+   : LORBase(*a_ho.ParFESpace(), ref_type)
+{
+   ParFiniteElementSpace &pfes_ho = *a_ho.ParFESpace();
+   ParMesh *pmesh = new ParMesh(pfes_ho.GetParMesh(), GetRefinementFactor(),
+                                ref_type);
+   mesh = pmesh;
+   ConstructFECollection();
+   fes = new ParFiniteElementSpace(pmesh, fec, pfes_ho.GetVDim(),
+                                   pfes_ho.GetOrdering());
+   SetupProlongationAndRestriction();
+   a = new ParBilinearForm(static_cast<ParFiniteElementSpace*>(fes));
+   AssembleSystem(a_ho, ess_tdof_list);
+}
+
+HypreParMatrix &ParLORDiscretization::GetAssembledMatrix() const
+{
+   MFEM_VERIFY(A.Ptr() != NULL, "No LOR system assembled");
+   return *A.As<HypreParMatrix>();
+}
+
+#endif
+
+} // namespace mfem
@@ -0,0 +1,271 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_LOR
+#define MFEM_LOR
+
+#include "bilinearform.hpp"
+
+#ifdef MFEM_USE_MPI
+#include "pbilinearform.hpp"
+#endif
+
+namespace mfem
+{
+
+/** @brief Abstract base class for LORDiscretization and ParLORDiscretization,
+    which construct low-order refined (LOR) versions of high-order bilinear
+    forms. */
+/** The LOR mesh is obtained by refining each element of the high-order mesh
+    with the Mesh(Mesh*, int, int) constructor, such that the vertices of the
+    refined elements are the Gauss-Lobatto points of the high-order elements
+    (by default). The LOR space is the lowest order space of the same type
+    (H1, ND, RT or L2) on the LOR mesh, and it has the same number of DOFs as
+    the high-order space.
+
+    The prolongation and restriction matrices of the LOR space are set up such
+    that its true DOFs are the true DOFs of the high-order space, see
+    FiniteElementSpace::CopyProlongationAndRestriction(). The assembled LOR
+    matrix can therefore be used directly as a preconditioner for the
+    high-order operator, e.g. through the LORSolver class.
+
+    The high-order mesh must be conforming, and must consist of segments,
+    quadrilaterals or hexahedra. The integrators of the high-order form are
+    used to assemble the LOR form, so their coefficients must be defined on
+    the physical space, e.g. they cannot be GridFunctionCoefficient%s of the
+    high-order mesh.
+
+    The LOR form shares the integrators of the high-order form without owning
+    them, see BilinearForm::UseExternalIntegrators(). Therefore, the LOR
+    object, and any LORSolver using it, must not outlive the high-order form.
+    */
+class LORBase
+{
+protected:
+   enum FESpaceType { H1, ND, RT, L2, INVALID };
+
+   FiniteElementSpace &fes_ho;
+   int ref_type;
+   Mesh *mesh;
+   FiniteElementCollection *fec;
+   FiniteElementSpace *fes;
+   BilinearForm *a;
+   OperatorHandle A;
+   mutable Array<int> perm;
+
+   LORBase(FiniteElementSpace &fes_ho_, int ref_type_);
+
+   /// Return the type of the high-order space.
+   FESpaceType GetFESpaceType() const;
+
+   /// Return the refinement factor of the high-order elements.
+   int GetRefinementFactor() const;
+
+   /// Construct the LOR finite element collection.
+   void ConstructFECollection();
+
+   /// Construct the signed LOR to high-order DOF permutation #perm.
+   void ConstructDofPermutation() const;
+
+   /// Set the prolongation and restriction matrices of the LOR space.
+   void SetupProlongationAndRestriction();
+
+   /** @brief Add the integrators of @a a_ho to the LOR form #a, assemble it
+       and form the system matrix #A. */
+   void AssembleSystem(BilinearForm &a_ho, const Array<int> &ess_tdof_list);
+
+public:
+   /// Return the assembled LOR operator in the true DOFs of the high-order
+   /// space.
+   const OperatorHandle &GetAssembledSystem() const { return A; }
+
+   /** @brief Return the signed permutation from the LOR DOFs to the DOFs of
+       the high-order space. */
+   /** Entry i is the DOF of the high-order space that corresponds to the LOR
+       DOF i, encoded as -1-dof when the basis functions have opposite signs.
+       For H1 spaces, the permutation is the identity. */
+   const Array<int> &GetDofPermutation() const;
+
+   /// Return true if the LOR space and the high-order space have the same DOF
+   /// numbering, i.e. if GetDofPermutation() is the identity.
+   bool HasSameDofNumbering() const { return GetFESpaceType() == H1; }
+
+   virtual ~LORBase();
+};
+
+/// Create and assemble a low-order refined version of a BilinearForm.
+class LORDiscretization : public LORBase
+{
+public:
+   /** @brief Construct the low-order refined version of @a a_ho using the
+       given list of essential true DOFs of the high-order space. */
+   /** The mesh is refined using the refinement type specified by @a ref_type
+       (see Mesh::Mesh(Mesh*, int, int)). */
+   LORDiscretization(BilinearForm &a_ho, const Array<int> &ess_tdof_list,
+                     int ref_type = BasisType::GaussLobatto);
+
+   /// Return the assembled LOR matrix.
+   SparseMatrix &GetAssembledMatrix() const;
+
+   /// Return the LOR mesh.
+   Mesh &GetMesh() const { return *mesh; }
+
+   /// Return the LOR finite element space.
+   FiniteElementSpace &GetFESpace() const { return *fes; }
+};
+
+#ifdef MFEM_USE_MPI
+
+/// Create and assemble a low-order refined version of a ParBilinearForm.
+class ParLORDiscretization : public LORBase
+{
+public:
+   /** @brief Construct the low-order refined version of @a a_ho using the
+       given list of essential true DOFs of the high-order space. */
+   /** The mesh is refined using the refinement type specified by @a ref_type
+       (see ParMesh::ParMesh(ParMesh*, int, int)). */
+   ParLORDiscretization(ParBilinearForm &a_ho, const Array<int> &ess_tdof_list,
+                        int ref_type = BasisType::GaussLobatto);
+
+   /// Return the assembled LOR matrix.
+   HypreParMatrix &GetAssembledMatrix() const;
+
+   /// Return the LOR mesh.
+   ParMesh &GetParMesh() const { return *static_cast<ParMesh*>(mesh); }
+
+   /// Return the LOR finite element space.
+   ParFiniteElementSpace &GetParFESpace() const
+   { return *static_cast<ParFiniteElementSpace*>(fes); }
+};
+
+#endif
+
+/** @brief Represents a solver of type @a SolverType created using the
+    low-order refined version of the given BilinearForm or ParBilinearForm. */
+/** The solver is set up with the assembled LOR matrix, without copying it.
+    For example, LORSolver<HypreBoomerAMG> gives an AMG preconditioner for a
+    high-order H1 operator. The specializations LORSolver<HypreAMS> and
+    LORSolver<HypreADS> set up the auxiliary space solvers with the ND and RT
+    spaces of the LOR discretization. The high-order form must outlive the
+    solver, see LORBase. */
+template <typename SolverType>
+class LORSolver : public Solver
+{
+protected:
+   LORBase *lor;
+   SolverType solver;
+
+public:
+   /// Create a solver of type @a SolverType using the LOR version of @a a_ho.
+   LORSolver(BilinearForm &a_ho, const Array<int> &ess_tdof_list,
+             int ref_type = BasisType::GaussLobatto)
+   {
+      lor = new LORDiscretization(a_ho, ess_tdof_list, ref_type);
+      SetOperator(*lor->GetAssembledSystem().Ptr());
+   }
+
+#ifdef MFEM_USE_MPI
+   /// Create a solver of type @a SolverType using the LOR version of @a a_ho.
+   LORSolver(ParBilinearForm &a_ho, const Array<int> &ess_tdof_list,
+             int ref_type = BasisType::GaussLobatto)
+   {
+      lor = new ParLORDiscretization(a_ho, ess_tdof_list, ref_type);
+      SetOperator(*lor->GetAssembledSystem().Ptr());
+   }
+#endif
+
+   void SetOperator(const Operator &op)
+   {
+      solver.SetOperator(op);
+      height = op.Height();
+      width = op.Width();
+   }
+
+   void Mult(const Vector &x, Vector &y) const { solver.Mult(x, y); }
+
+   /// Access the underlying solver.
+   SolverType &GetSolver() { return solver; }
+
+   /// Access the LOR discretization object.
+   const LORBase &GetLOR() const { return *lor; }
+
+   ~LORSolver() { delete lor; }
+};
+
+#ifdef MFEM_USE_MPI
+
+/// LOR auxiliary space Maxwell solver for high-order ND spaces.
+template <>
+class LORSolver<HypreAMS> : public Solver
+{
+protected:
+   ParLORDiscretization *lor;
+   HypreAMS *solver;
+
+public:
+   /// Create an AMS solver using the LOR version of the ND form @a a_ho.
+   LORSolver(ParBilinearForm &a_ho, const Array<int> &ess_tdof_list,
+             int ref_type = BasisType::GaussLobatto)
+   {
+      lor = new ParLORDiscretization(a_ho, ess_tdof_list, ref_type);
+      solver = new HypreAMS(lor->GetAssembledMatrix(), &lor->GetParFESpace());
+      height = width = solver->Height();
+   }
+
+   void SetOperator(const Operator &op) { solver->SetOperator(op); }
+
+   void Mult(const Vector &x, Vector &y) const { solver->Mult(x, y); }
+
+   /// Access the underlying solver.
+   HypreAMS &GetSolver() { return *solver; }
+
+   /// Access the LOR discretization object.
+   const LORBase &GetLOR() const { return *lor; }
+
+   ~LORSolver() { delete solver; delete lor; }
+};
+
+/// LOR auxiliary space divergence solver for high-order RT spaces.
+template <>
+class LORSolver<HypreADS> : public Solver
+{
+protected:
+   ParLORDiscretization *lor;
+   HypreADS *solver;
+
+public:
+   /// Create an ADS solver using the LOR version of the RT form @a a_ho.
+   LORSolver(ParBilinearForm &a_ho, const Array<int> &ess_tdof_list,
+             int ref_type = BasisType::GaussLobatto)
+   {
+      lor = new ParLORDiscretization(a_ho, ess_tdof_list, ref_type);
+      solver = new HypreADS(lor->GetAssembledMatrix(), &lor->GetParFESpace());
+      height = width = solver->Height();
+   }
+
+   void SetOperator(const Operator &op) { solver->SetOperator(op); }
+
+   void Mult(const Vector &x, Vector &y) const { solver->Mult(x, y); }
+
+   /// Access the underlying solver.
+   HypreADS &GetSolver() { return *solver; }
+
+   /// Access the LOR discretization object.
+   const LORBase &GetLOR() const { return *lor; }
+
+   ~LORSolver() { delete solver; delete lor; }
+};
+
+#endif
+
+} // namespace mfem
+
+#endif
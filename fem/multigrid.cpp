@@ -10,6 +10,10 @@
 // CONTRIBUTING.md for details.
 
 #include "multigrid.hpp"
+#include "transfer.hpp"
+#ifdef MFEM_USE_MPI
+#include "pbilinearform.hpp"
+#endif
 
 namespace mfem
 {
@@ -113,6 +117,30 @@ Solver* Multigrid::GetSmootherAtLevel(int level)
    return smoothers[level];
 }
 
+void Multigrid::ReplaceOperatorAtLevel(int level, Operator* opr,
+                                       bool ownOperator)
+{
+   MFEM_VERIFY(opr->Height() == operators[level]->Height(),
+               "the new operator has a different size");
+   if (ownedOperators[level] && operators[level] != opr)
+   {
+      delete operators[level];
+   }
+   operators[level] = opr;
+   ownedOperators[level] = ownOperator;
+}
+
+void Multigrid::ReplaceSmootherAtLevel(int level, Solver* smoother,
+                                       bool ownSmoother)
+{
+   if (ownedSmoothers[level] && smoothers[level] != smoother)
+   {
+      delete smoothers[level];
+   }
+   smoothers[level] = smoother;
+   ownedSmoothers[level] = ownSmoother;
+}
+
 void Multigrid::SetCycleType(CycleType cycleType_, int preSmoothingSteps_,
                              int postSmoothingSteps_)
 {
@@ -210,4 +238,288 @@ void Multigrid::RecoverFineFEMSolution(const Vector& X, const Vector& b,
    bfs.Last()->RecoverFEMSolution(X, b, x);
 }
 
+MatrixFreeMultigrid::MatrixFreeMultigrid(
+   const FiniteElementSpaceHierarchy &fespaces_, const Array<int> &ess_bdr,
+   IntegratorAdder add_integrators, int cheb_order)
+   : Multigrid(fespaces_), own_fespaces(NULL), coarse_prec(NULL),
+     estimator(NULL), cheb_order(cheb_order)
+{
+   ConstructLevels(ess_bdr, add_integrators);
+}
+
+MatrixFreeMultigrid::MatrixFreeMultigrid(FiniteElementSpace &fes,
+                                         const Array<int> &orders,
+                                         const Array<int> &ess_bdr,
+                                         IntegratorAdder add_integrators,
+                                         int cheb_order)
+   : Multigrid(*NewPHierarchy(fes, orders)), coarse_prec(NULL),
+     estimator(NULL), cheb_order(cheb_order)
+{
+   own_fespaces = const_cast<FiniteElementSpaceHierarchy*>(&fespaces);
+   ConstructLevels(ess_bdr, add_integrators);
+}
+
+FiniteElementSpaceHierarchy *MatrixFreeMultigrid::NewPHierarchy(
+   FiniteElementSpace &fes, const Array<int> &orders)
+{
+   const H1_FECollection *fec =
+      dynamic_cast<const H1_FECollection*>(fes.FEColl());
+   MFEM_VERIFY(fec != NULL, "p-coarsening requires an H1 space");
+   const int order = fec->FiniteElementForGeometry(Geometry::SEGMENT)
+                     ->GetOrder();
+   const int dim = fes.GetMesh()->Dimension();
+   const int btype = fec->GetBasisType();
+
+   Array<int> coarse_orders;
+   if (orders.Size() == 0)
+   {
+      for (int p = order/2; p >= 1; p /= 2) { coarse_orders.Prepend(p); }
+   }
+   else
+   {
+      orders.Copy(coarse_orders);
+   }
+   MFEM_VERIFY(coarse_orders.Size() > 0 && coarse_orders[0] >= 1,
+               "invalid coarsening schedule");
+   for (int i = 0; i < coarse_orders.Size(); i++)
+   {
+      const int next = (i + 1 < coarse_orders.Size()) ? coarse_orders[i+1] :
+                       order;
+      MFEM_VERIFY(coarse_orders[i] < next, "the orders of the coarsening "
+                  "schedule must be increasing and smaller than the order of "
+                  "the finest space");
+   }
+
+   FiniteElementSpaceHierarchy *hierarchy;
+   const int vdim = fes.GetVDim(), ordering = fes.GetOrdering();
+   FiniteElementCollection *coarse_fec =
+      new H1_FECollection(coarse_orders[0], dim, btype);
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfes = dynamic_cast<ParFiniteElementSpace*>(&fes);
+   if (pfes)
+   {
+      ParMesh *pmesh = pfes->GetParMesh();
+      ParFiniteElementSpaceHierarchy *phierarchy =
+         new ParFiniteElementSpaceHierarchy(
+         pmesh, new ParFiniteElementSpace(pmesh, coarse_fec, vdim, ordering),
+         false, true);
+      for (int i = 1; i < coarse_orders.Size(); i++)
+      {
+         phierarchy->AddOrderRefinedLevel(
+            new H1_FECollection(coarse_orders[i], dim, btype), vdim, ordering);
+      }
+      Operator *P = new TrueTransferOperator(phierarchy->GetFinestFESpace(),
+                                             *pfes);
+      phierarchy->AddLevel(pmesh, pfes, P, false, false, true);
+      hierarchy = phierarchy;
+   }
+   else
+#endif
+   {
+      Mesh *mesh = fes.GetMesh();
+      hierarchy = new FiniteElementSpaceHierarchy(
+         mesh, new FiniteElementSpace(mesh, coarse_fec, vdim, ordering),
+         false, true);
+      for (int i = 1; i < coarse_orders.Size(); i++)
+      {
+         hierarchy->AddOrderRefinedLevel(
+            new H1_FECollection(coarse_orders[i], dim, btype), vdim, ordering);
+      }
+      Operator *P = new TransferOperator(hierarchy->GetFinestFESpace(), fes);
+      hierarchy->AddLevel(mesh, &fes, P, false, false, true);
+   }
+   return hierarchy;
+}
+
+void MatrixFreeMultigrid::ConstructBilinearForm(
+   FiniteElementSpace &fespace, const Array<int> &ess_bdr,
+   IntegratorAdder &add_integrators, bool partial_assembly)
+{
+   BilinearForm *form;
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfespace =
+      dynamic_cast<ParFiniteElementSpace*>(&fespace);
+   if (pfespace)
+   {
+      form = new ParBilinearForm(pfespace);
+   }
+   else
+#endif
+   {
+      form = new BilinearForm(&fespace);
+   }
+   if (partial_assembly)
+   {
+      form->SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   }
+   add_integrators(*form);
+   form->Assemble();
+   bfs.Append(form);
+
+   essentialTrueDofs.Append(new Array<int>());
+   if (ess_bdr.Size())
+   {
+      fespace.GetEssentialTrueDofs(ess_bdr, *essentialTrueDofs.Last());
+   }
+}
+
+void MatrixFreeMultigrid::ConstructCoarseOperatorAndSolver(
+   const Array<int> &ess_bdr, IntegratorAdder &add_integrators)
+{
+   FiniteElementSpace &fespace =
+      const_cast<FiniteElementSpace&>(fespaces.GetFESpaceAtLevel(0));
+   ConstructBilinearForm(fespace, ess_bdr, add_integrators, false);
+   diagonals.Append(NULL);
+
+   Operator *opr;
+   bool own;
+   Solver *solver;
+   FormCoarseOperatorAndSolver(opr, own, solver);
+   AddLevel(opr, solver, own, true);
+}
+
+void MatrixFreeMultigrid::FormCoarseOperatorAndSolver(Operator *&opr,
+                                                      bool &own,
+                                                      Solver *&solver)
+{
+#ifdef MFEM_USE_MPI
+   const FiniteElementSpace &fespace = fespaces.GetFESpaceAtLevel(0);
+   if (dynamic_cast<const ParFiniteElementSpace*>(&fespace))
+   {
+      OperatorPtr A(Operator::Hypre_ParCSR);
+      bfs[0]->FormSystemMatrix(*essentialTrueDofs[0], A);
+      HypreBoomerAMG *amg = new HypreBoomerAMG(*A.As<HypreParMatrix>());
+      amg->SetPrintLevel(0);
+      if (fespace.GetVDim() > 1)
+      {
+         amg->SetSystemsOptions(fespace.GetVDim(),
+                                fespace.GetOrdering() == Ordering::byNODES);
+      }
+      solver = amg;
+      own = A.OwnsOperator();
+      A.SetOperatorOwner(false);
+      opr = A.Ptr();
+      return;
+   }
+#endif
+   OperatorPtr A(Operator::MFEM_SPARSEMAT);
+   bfs[0]->FormSystemMatrix(*essentialTrueDofs[0], A);
+#ifdef MFEM_USE_SUITESPARSE
+   solver = new UMFPackSolver(*A.As<SparseMatrix>());
+#else
+   CGSolver *pcg = new CGSolver();
+   pcg->SetPrintLevel(-1);
+   pcg->SetMaxIter(200);
+   pcg->SetRelTol(1e-4);
+   pcg->SetAbsTol(0.0);
+   pcg->SetOperator(*A.Ptr());
+   delete coarse_prec;
+   coarse_prec = new GSSmoother(*A.As<SparseMatrix>());
+   pcg->SetPreconditioner(*coarse_prec);
+   solver = pcg;
+#endif
+   own = A.OwnsOperator();
+   A.SetOperatorOwner(false);
+   opr = A.Ptr();
+}
+
+void MatrixFreeMultigrid::ConstructOperatorAndSmoother(
+   FiniteElementSpace &fespace, const Array<int> &ess_bdr,
+   IntegratorAdder &add_integrators)
+{
+   ConstructBilinearForm(fespace, ess_bdr, add_integrators, true);
+
+   OperatorPtr opr;
+   opr.SetType(Operator::ANY_TYPE);
+   bfs.Last()->FormSystemMatrix(*essentialTrueDofs.Last(), opr);
+   const bool own = opr.OwnsOperator();
+   opr.SetOperatorOwner(false);
+
+   // The smoother keeps a reference to the diagonal
+   diagonals.Append(new Vector(fespace.GetTrueVSize()));
+   bfs.Last()->AssembleDiagonal(*diagonals.Last());
+
+   AddLevel(opr.Ptr(), NewSmoother(opr.Ptr(), bfs.Size() - 1), own, true);
+}
+
+Solver *MatrixFreeMultigrid::NewSmoother(Operator *opr, int level)
+{
+   return new OperatorChebyshevSmoother(opr, *diagonals[level],
+                                        *essentialTrueDofs[level],
+                                        cheb_order, *estimator);
+}
+
+void MatrixFreeMultigrid::ConstructLevels(const Array<int> &ess_bdr,
+                                          IntegratorAdder &add_integrators)
+{
+#ifdef MFEM_USE_MPI
+   const ParFiniteElementSpace *pfespace =
+      dynamic_cast<const ParFiniteElementSpace*>(&fespaces.GetFinestFESpace());
+   estimator = pfespace ? new SpectralBoundsEstimator(pfespace->GetComm()) :
+               new SpectralBoundsEstimator;
+#else
+   estimator = new SpectralBoundsEstimator;
+#endif
+   ConstructCoarseOperatorAndSolver(ess_bdr, add_integrators);
+   for (int level = 1; level < fespaces.GetNumLevels(); ++level)
+   {
+      FiniteElementSpace &fespace =
+         const_cast<FiniteElementSpace&>(fespaces.GetFESpaceAtLevel(level));
+      ConstructOperatorAndSmoother(fespace, ess_bdr, add_integrators);
+   }
+}
+
+void MatrixFreeMultigrid::Reassemble()
+{
+   // The coarse matrix is formed again, which invalidates the previous one
+   bfs[0]->Update();
+   bfs[0]->Assemble();
+   Operator *opr;
+   bool own;
+   Solver *solver;
+   FormCoarseOperatorAndSolver(opr, own, solver);
+   ReplaceSmootherAtLevel(0, solver, true);
+   ReplaceOperatorAtLevel(0, opr, own);
+
+   // The partially assembled operators keep their address, so the estimator
+   // finds their eigenvalue bounds unless they were invalidated.
+   for (int level = 1; level < NumLevels(); ++level)
+   {
+      bfs[level]->Assemble();
+      bfs[level]->AssembleDiagonal(*diagonals[level]);
+      ReplaceSmootherAtLevel(
+         level, NewSmoother(GetOperatorAtLevel(level), level), true);
+   }
+}
+
+MatrixFreeMultigrid::~MatrixFreeMultigrid()
+{
+   delete coarse_prec;
+   delete estimator;
+   for (int i = 0; i < diagonals.Size(); ++i)
+   {
+      delete diagonals[i];
+   }
+   if (own_fespaces)
+   {
+      // The forms use the spaces of the hierarchy, delete them first.
+      for (int i = 0; i < bfs.Size(); ++i)
+      {
+         delete bfs[i];
+      }
+      bfs.DeleteAll();
+
+      Array<const FiniteElementCollection*> fecs;
+      for (int i = 0; i < own_fespaces->GetFinestLevelIndex(); ++i)
+      {
+         fecs.Append(own_fespaces->GetFESpaceAtLevel(i).FEColl());
+      }
+      delete own_fespaces;
+      for (int i = 0; i < fecs.Size(); ++i)
+      {
+         delete fecs[i];
+      }
+   }
+}
+
 } // namespace mfem
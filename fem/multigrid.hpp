@@ -18,6 +18,8 @@
 #include "../linalg/operator.hpp"
 #include "../linalg/handle.hpp"
 
+#include <functional>
+
 namespace mfem
 {
 
@@ -106,6 +108,15 @@ public:
    /// Recover the solution of a linear system formed with FormFineLinearSystem()
    void RecoverFineFEMSolution(const Vector& X, const Vector& b, Vector& x);
 
+protected:
+   /** @brief Replace the operator at the given level, the previous one is
+       deleted if it is owned. */
+   void ReplaceOperatorAtLevel(int level, Operator* opr, bool ownOperator);
+
+   /** @brief Replace the smoother at the given level, the previous one is
+       deleted if it is owned. */
+   void ReplaceSmootherAtLevel(int level, Solver* smoother, bool ownSmoother);
+
 private:
    /// Application of a smoothing step at particular level
    void SmoothingStep(int level, bool transpose) const;
@@ -114,6 +125,118 @@ private:
    void Cycle(int level) const;
 };
 
+/** @brief Multigrid solver with partially assembled operators and Chebyshev
+    smoothers, built automatically from a FiniteElementSpaceHierarchy and a
+    function adding the integrators of the problem to a BilinearForm. */
+/** On all levels but the coarsest, the operator is partially assembled and
+    smoothed with an OperatorChebyshevSmoother, whose eigenvalue bound is
+    estimated with the SpectralBoundsEstimator of the solver. The coarsest
+    level is fully assembled and solved with HypreBoomerAMG for parallel
+    spaces. For serial spaces, it is
+    solved with UMFPackSolver when MFEM is built with SuiteSparse, and with
+    CGSolver preconditioned by a symmetric GSSmoother otherwise.
+
+    The integrators have to be added separately to the form of each level,
+    since partially assembled integrators store the data of the space they
+    were assembled on. All levels use the essential boundary attributes given
+    to the constructor. */
+class MatrixFreeMultigrid : public Multigrid
+{
+public:
+   /** @brief Type of the function adding the integrators to the form of a
+       level, e.g. a lambda calling BilinearForm::AddDomainIntegrator(). */
+   typedef std::function<void(BilinearForm &)> IntegratorAdder;
+
+protected:
+   /// The space hierarchy if it was constructed by this object, or NULL.
+   FiniteElementSpaceHierarchy *own_fespaces;
+   /// Preconditioner of the serial iterative coarse solver, or NULL.
+   Solver *coarse_prec;
+   /// Diagonals of the operators of the levels, NULL on the coarsest level.
+   Array<Vector*> diagonals;
+   /// Eigenvalue estimates of the smoothers, kept by Reassemble().
+   SpectralBoundsEstimator *estimator;
+   /// Order of the Chebyshev smoothers.
+   int cheb_order;
+
+   /** @brief Construct the p-coarsened hierarchy with the given orders of the
+       coarser levels, and @a fes on the finest level. */
+   static FiniteElementSpaceHierarchy *NewPHierarchy(FiniteElementSpace &fes,
+                                                     const Array<int> &orders);
+
+   /** @brief Create the bilinear form and the essential true DOFs of the
+       finite element space @a fespace, and append them to #bfs and
+       #essentialTrueDofs. */
+   void ConstructBilinearForm(FiniteElementSpace &fespace,
+                              const Array<int> &ess_bdr,
+                              IntegratorAdder &add_integrators,
+                              bool partial_assembly);
+
+   /// Assemble the operator and the solver of the coarsest level.
+   void ConstructCoarseOperatorAndSolver(const Array<int> &ess_bdr,
+                                         IntegratorAdder &add_integrators);
+
+   /** @brief Form the operator of the coarsest level from its assembled form
+       and construct its solver. */
+   void FormCoarseOperatorAndSolver(Operator *&opr, bool &own, Solver *&solver);
+
+   /// Partially assemble the operator and the smoother of a finer level.
+   void ConstructOperatorAndSmoother(FiniteElementSpace &fespace,
+                                     const Array<int> &ess_bdr,
+                                     IntegratorAdder &add_integrators);
+
+   /// Construct the Chebyshev smoother of the operator @a opr of a finer level.
+   Solver *NewSmoother(Operator *opr, int level);
+
+   /// Construct the operators and smoothers of all levels.
+   void ConstructLevels(const Array<int> &ess_bdr,
+                        IntegratorAdder &add_integrators);
+
+public:
+   /** @brief Construct the multigrid solver on the levels of @a fespaces_.
+       The integrators of all levels are added with @a add_integrators. */
+   /** The hierarchy must be kept alive while the solver is in use. Chebyshev
+       smoothers of order @a cheb_order are used on all levels except the
+       coarsest. */
+   MatrixFreeMultigrid(const FiniteElementSpaceHierarchy &fespaces_,
+                       const Array<int> &ess_bdr,
+                       IntegratorAdder add_integrators,
+                       int cheb_order = 2);
+
+   /** @brief Construct a p-multigrid solver for the H1 space @a fes, with the
+       coarsening schedule @a orders. */
+   /** The array @a orders lists the polynomial orders of the coarser levels,
+       from the coarsest to the finest. They must be increasing and smaller
+       than the order of @a fes. If @a orders is empty, the order is halved
+       from one level to the next, down to order 1. The space hierarchy is
+       owned by the solver, @a fes is used on the finest level. */
+   MatrixFreeMultigrid(FiniteElementSpace &fes, const Array<int> &orders,
+                       const Array<int> &ess_bdr,
+                       IntegratorAdder add_integrators,
+                       int cheb_order = 2);
+
+   /// Returns the form at the given level
+   BilinearForm &GetFormAtLevel(int level) { return *bfs[level]; }
+
+   /// Returns the essential true DOFs at the given level
+   const Array<int> &GetEssentialTrueDofsAtLevel(int level) const
+   { return *essentialTrueDofs[level]; }
+
+   /** @brief Re-assemble the forms of all levels, e.g. after a change of the
+       coefficients, and rebuild the smoothers and the coarse solver. */
+   /** The operators of the finer levels are kept. Their eigenvalue estimates
+       are reused unless InvalidateSpectralBounds() was called before. */
+   void Reassemble();
+
+   /// Discard the eigenvalue estimates of all levels, see Reassemble().
+   void InvalidateSpectralBounds() { estimator->Clear(); }
+
+   /// Returns the estimator of the eigenvalue bounds of the smoothers
+   SpectralBoundsEstimator &GetSpectralBoundsEstimator() { return *estimator; }
+
+   virtual ~MatrixFreeMultigrid();
+};
+
 } // namespace mfem
 
 #endif
@@ -71,4 +71,111 @@ void PANonlinearFormExtension::Mult(const Vector &x, Vector &y) const
    }
 }
 
+Operator &PANonlinearFormExtension::GetGradient(const Vector &x) const
+{
+   const Array<NonlinearFormIntegrator*> &integrators = *n->GetDNFI();
+   const int iSz = integrators.Size();
+   if (elem_restrict_lex)
+   {
+      elem_restrict_lex->Mult(x, localX);
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AssembleGradPA(localX, fes);
+      }
+   }
+   else
+   {
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AssembleGradPA(x, fes);
+      }
+   }
+   if (!Grad.Ptr()) { Grad.Reset(new Gradient(*this)); }
+   return *Grad.Ptr();
+}
+
+double PANonlinearFormExtension::GetGridFunctionEnergy(const Vector &x) const
+{
+   const Array<NonlinearFormIntegrator*> &integrators = *n->GetDNFI();
+   const int iSz = integrators.Size();
+   double energy = 0.0;
+   if (elem_restrict_lex)
+   {
+      elem_restrict_lex->Mult(x, localX);
+      for (int i = 0; i < iSz; ++i)
+      {
+         energy += integrators[i]->GetLocalStateEnergyPA(localX);
+      }
+   }
+   else
+   {
+      for (int i = 0; i < iSz; ++i)
+      {
+         energy += integrators[i]->GetLocalStateEnergyPA(x);
+      }
+   }
+   return energy;
+}
+
+PANonlinearFormExtension::Gradient::Gradient(const PANonlinearFormExtension &e)
+   : Operator(e.fes.GetVSize()), ext(e)
+{
+   if (ext.elem_restrict_lex)
+   {
+      const int s = ext.elem_restrict_lex->Height();
+      localX.SetSize(s, Device::GetMemoryType());
+      localY.SetSize(s, Device::GetMemoryType());
+      localY.UseDevice(true); // ensure 'localY = 0.0' is done on device
+   }
+}
+
+void PANonlinearFormExtension::Gradient::Mult(const Vector &x, Vector &y) const
+{
+   const Array<NonlinearFormIntegrator*> &integrators = *ext.n->GetDNFI();
+   const int iSz = integrators.Size();
+   if (ext.elem_restrict_lex)
+   {
+      ext.elem_restrict_lex->Mult(x, localX);
+      localY = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AddMultGradPA(localX, localY);
+      }
+      ext.elem_restrict_lex->MultTranspose(localY, y);
+   }
+   else
+   {
+      y.UseDevice(true);
+      y = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AddMultGradPA(x, y);
+      }
+   }
+}
+
+void PANonlinearFormExtension::Gradient::AssembleDiagonal(Vector &diag) const
+{
+   const Array<NonlinearFormIntegrator*> &integrators = *ext.n->GetDNFI();
+   const int iSz = integrators.Size();
+   if (ext.elem_restrict_lex)
+   {
+      localY = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AssembleGradDiagonalPA(localY);
+      }
+      ext.elem_restrict_lex->MultTranspose(localY, diag);
+   }
+   else
+   {
+      diag.UseDevice(true);
+      diag = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AssembleGradDiagonalPA(diag);
+      }
+   }
+}
+
 }
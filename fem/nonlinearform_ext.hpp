@@ -13,6 +13,7 @@
 #define NONLINEARFORM_EXT_HPP
 
 #include "../config/config.hpp"
+#include "../linalg/handle.hpp"
 #include "fespace.hpp"
 
 namespace mfem
@@ -26,19 +27,59 @@ protected:
 public:
    NonlinearFormExtension(NonlinearForm *form);
    virtual void AssemblePA() = 0;
+
+   /** @brief Return the gradient of the form at the state @a x, given as an
+       L-vector. The returned Operator acts on L-vectors. */
+   virtual Operator &GetGradient(const Vector &x) const = 0;
+
+   /// Compute the local energy of the form at the L-vector @a x.
+   virtual double GetGridFunctionEnergy(const Vector &x) const = 0;
 };
 
 /// Data and methods for partially-assembled nonlinear forms
 class PANonlinearFormExtension : public NonlinearFormExtension
 {
+private:
+   /// Matrix-free action of the gradient of the form, acting on L-vectors.
+   class Gradient : public Operator
+   {
+   protected:
+      const PANonlinearFormExtension &ext;
+      mutable Vector localX, localY;
+
+   public:
+      Gradient(const PANonlinearFormExtension &e);
+
+      virtual void Mult(const Vector &x, Vector &y) const;
+
+      /// Diagonal of the gradient as an L-vector.
+      virtual void AssembleDiagonal(Vector &diag) const;
+
+      virtual const Operator *GetProlongation() const
+      { return ext.fes.GetProlongationMatrix(); }
+
+      virtual const Operator *GetRestriction() const
+      { return ext.fes.GetRestrictionMatrix(); }
+   };
+
 protected:
    const FiniteElementSpace &fes; // Not owned
    mutable Vector localX, localY;
    const Operator *elem_restrict_lex; // Not owned
+   mutable OperatorHandle Grad;
 public:
    PANonlinearFormExtension(NonlinearForm*);
    void AssemblePA();
    void Mult(const Vector &x, Vector &y) const;
+
+   /** @brief Assemble the gradient of all domain integrators at the state
+       @a x, see NonlinearFormIntegrator::AssembleGradPA(), and return the
+       matrix-free gradient operator. */
+   Operator &GetGradient(const Vector &x) const;
+
+   /** @brief Compute the local energy of all domain integrators at the
+       L-vector @a x, see NonlinearFormIntegrator::GetLocalStateEnergyPA(). */
+   double GetGridFunctionEnergy(const Vector &x) const;
 };
 }
 #endif // NONLINEARFORM_EXT_HPP
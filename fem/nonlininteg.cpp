@@ -34,6 +34,32 @@ void NonlinearFormIntegrator::AddMultPA(const Vector &, Vector &) const
                "   is not implemented for this class.");
 }
 
+void NonlinearFormIntegrator::AssembleGradPA(const Vector &,
+                                             const FiniteElementSpace &)
+{
+   mfem_error ("NonlinearFormIntegrator::AssembleGradPA(...)\n"
+               "   is not implemented for this class.");
+}
+
+void NonlinearFormIntegrator::AddMultGradPA(const Vector &, Vector &) const
+{
+   mfem_error ("NonlinearFormIntegrator::AddMultGradPA(...)\n"
+               "   is not implemented for this class.");
+}
+
+void NonlinearFormIntegrator::AssembleGradDiagonalPA(Vector &) const
+{
+   mfem_error ("NonlinearFormIntegrator::AssembleGradDiagonalPA(...)\n"
+               "   is not implemented for this class.");
+}
+
+double NonlinearFormIntegrator::GetLocalStateEnergyPA(const Vector &) const
+{
+   mfem_error ("NonlinearFormIntegrator::GetLocalStateEnergyPA(...)\n"
+               "   is not implemented for this class.");
+   return 0.0;
+}
+
 void NonlinearFormIntegrator::AssembleElementVector(
    const FiniteElement &el, ElementTransformation &Tr,
    const Vector &elfun, Vector &elvect)
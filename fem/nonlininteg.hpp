@@ -88,6 +88,37 @@ public:
        called. */
    virtual void AddMultPA(const Vector &x, Vector &y) const;
 
+   /// Prepare the partially assembled gradient at the state @a x.
+   /** The input @a x is an E-vector, i.e. it represents the element-wise
+       discontinuous version of the FE space @a fes. The result is stored
+       internally so that it can be used later in the method AddMultGradPA().
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AssembleGradPA(const Vector &x, const FiniteElementSpace &fes);
+
+   /// Method for partially assembled gradient action.
+   /** Perform the action of the gradient of the integrator, evaluated at the
+       state given to the last call of AssembleGradPA(), on the input @a x and
+       add the result to the output @a y. Both @a x and @a y are E-vectors.
+
+       This method can be called only after the method AssembleGradPA() has
+       been called. */
+   virtual void AddMultGradPA(const Vector &x, Vector &y) const;
+
+   /// Method for computing the diagonal of the partially assembled gradient.
+   /** Add the diagonal of the gradient, evaluated at the state given to the
+       last call of AssembleGradPA(), to the E-vector @a diag.
+
+       This method can be called only after the method AssembleGradPA() has
+       been called. */
+   virtual void AssembleGradDiagonalPA(Vector &diag) const;
+
+   /// Compute the local energy with partial assembly.
+   /** The input @a x is an E-vector. This method can be called only after the
+       method AssemblePA() has been called. */
+   virtual double GetLocalStateEnergyPA(const Vector &x) const;
+
    virtual ~NonlinearFormIntegrator() { }
 };
 
@@ -202,6 +233,8 @@ public:
     respectively, and g is a reference volumetric scaling. */
 class NeoHookeanModel : public HyperelasticModel
 {
+   friend class HyperelasticNLFIntegrator; // PA needs mu, K and g
+
 protected:
    mutable double mu, K, g;
    Coefficient *c_mu, *c_K, *c_g;
@@ -253,9 +286,29 @@ private:
    //        output - the result of AssembleElementVector() (dof x dim).
    DenseMatrix DSh, DS, Jrt, Jpr, Jpt, P, PMatI, PMatO;
 
+   // PA extension
+   enum class PAModel { NEO_HOOKEAN, INVERSE_HARMONIC };
+   PAModel pa_model;
+   const DofToQuad *maps;            ///< Not owned
+   const FiniteElementSpace *pa_fes; ///< Not owned
+   int dim, ne, nq;
+   // Jrt at each quadrature point: nq x dim x dim x ne.
+   Vector pa_jrt;
+   // Quadrature weight times det(Jtr), mu, K and g: nq x 4 x ne.
+   Vector pa_coeff;
+   // The state Jpt stored by AssembleGradPA(): dim x dim x nq x ne.
+   Vector pa_state;
+   // Reference gradients and their dual: dim x dim x nq x ne.
+   mutable Vector pa_dx, pa_qy;
+
+   const IntegrationRule &GetPARule(const FiniteElement &el) const;
+
+   void PAQuadratureApply(const Vector &x, Vector &y, int mode) const;
+
 public:
    /** @param[in] m  HyperelasticModel that will be integrated. */
-   HyperelasticNLFIntegrator(HyperelasticModel *m) : model(m) { }
+   HyperelasticNLFIntegrator(HyperelasticModel *m)
+      : model(m), maps(NULL), pa_fes(NULL), dim(0), ne(0), nq(0) { }
 
    /** @brief Computes the integral of W(Jacobian(Trt)) over a target zone
        @param[in] el     Type of FiniteElement.
@@ -272,6 +325,25 @@ public:
    virtual void AssembleElementGrad(const FiniteElement &el,
                                     ElementTransformation &Ttr,
                                     const Vector &elfun, DenseMatrix &elmat);
+
+   using NonlinearFormIntegrator::AssemblePA;
+
+   /** @brief Partial assembly for NeoHookeanModel and InverseHarmonicModel on
+       quadrilateral and hexahedral meshes. */
+   /** Only the geometric data (the inverse of the target Jacobian and the
+       quadrature weights) and the model parameters are stored at quadrature
+       points. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   /// Store the deformation gradient at the quadrature points for state @a x.
+   virtual void AssembleGradPA(const Vector &x, const FiniteElementSpace &fes);
+
+   /** @brief Matrix-free action of the gradient: the derivative of the 1st
+       Piola-Kirchhoff stress is evaluated on the fly at each quadrature
+       point, no element matrices are formed. */
+   virtual void AddMultGradPA(const Vector &x, Vector &y) const;
 };
 
 /** Hyperelastic incompressible Neo-Hookean integrator with the PK1 stress
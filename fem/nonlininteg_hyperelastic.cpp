@@ -0,0 +1,601 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
+#include "nonlininteg.hpp"
+#include "quadinterpolator.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA Hyperelastic quadrature point functions. All matrices are DIM x DIM and
+// stored in column-major order.
+namespace hyperelastic
+{
+
+template<int DIM> MFEM_HOST_DEVICE inline
+double Ddot(const double *A, const double *B)
+{
+   double s = 0.0;
+   for (int i = 0; i < DIM*DIM; i++) { s += A[i]*B[i]; }
+   return s;
+}
+
+/// C = A B
+template<int DIM> MFEM_HOST_DEVICE inline
+void MultAB(const double *A, const double *B, double *C)
+{
+   for (int i = 0; i < DIM; i++)
+   {
+      for (int j = 0; j < DIM; j++)
+      {
+         double s = 0.0;
+         for (int k = 0; k < DIM; k++) { s += A[i+DIM*k]*B[k+DIM*j]; }
+         C[i+DIM*j] = s;
+      }
+   }
+}
+
+/// C = A B^t
+template<int DIM> MFEM_HOST_DEVICE inline
+void MultABt(const double *A, const double *B, double *C)
+{
+   for (int i = 0; i < DIM; i++)
+   {
+      for (int j = 0; j < DIM; j++)
+      {
+         double s = 0.0;
+         for (int k = 0; k < DIM; k++) { s += A[i+DIM*k]*B[j+DIM*k]; }
+         C[i+DIM*j] = s;
+      }
+   }
+}
+
+/// C = A^t B
+template<int DIM> MFEM_HOST_DEVICE inline
+void MultAtB(const double *A, const double *B, double *C)
+{
+   for (int i = 0; i < DIM; i++)
+   {
+      for (int j = 0; j < DIM; j++)
+      {
+         double s = 0.0;
+         for (int k = 0; k < DIM; k++) { s += A[k+DIM*i]*B[k+DIM*j]; }
+         C[i+DIM*j] = s;
+      }
+   }
+}
+
+/// M = J^{-t}, returns det(J)
+template<int DIM> MFEM_HOST_DEVICE inline
+double InverseTranspose(const double *J, double *M)
+{
+   double Jinv[DIM*DIM];
+   const double detJ = kernels::Det<DIM>(J);
+   kernels::CalcInverse<DIM>(J, Jinv);
+   for (int i = 0; i < DIM; i++)
+   {
+      for (int j = 0; j < DIM; j++) { M[i+DIM*j] = Jinv[j+DIM*i]; }
+   }
+   return detJ;
+}
+
+/// NeoHookeanModel::EvalP(): P = a J + b det(J) J^{-t}
+template<int DIM> MFEM_HOST_DEVICE inline
+void NeoHookeanP(const double *J, const double mu, const double K,
+                 const double g, double *P)
+{
+   double M[DIM*DIM];
+   const double dJ = InverseTranspose<DIM>(J, M);
+   const double a = mu*pow(dJ, -2.0/DIM);
+   const double b = K*(dJ/g - 1.0)/g - a*Ddot<DIM>(J, J)/(DIM*dJ);
+   for (int i = 0; i < DIM*DIM; i++) { P[i] = a*J[i] + b*dJ*M[i]; }
+}
+
+/// Directional derivative dP of NeoHookeanP() at J in the direction H.
+template<int DIM> MFEM_HOST_DEVICE inline
+void NeoHookeandP(const double *J, const double *H, const double mu,
+                  const double K, const double g, double *dP)
+{
+   double M[DIM*DIM], MHt[DIM*DIM], dM[DIM*DIM];
+   const double dJ = InverseTranspose<DIM>(J, M);
+   const double JJ = Ddot<DIM>(J, J);
+   const double JH = Ddot<DIM>(J, H);
+   const double MH = Ddot<DIM>(M, H); // d(det(J))/det(J)
+   const double a = mu*pow(dJ, -2.0/DIM);
+   const double b = K*(dJ/g - 1.0)/g - a*JJ/(DIM*dJ);
+   const double da = -2.0/DIM*a*MH;
+   const double db = K*dJ*MH/(g*g) - (da*JJ + 2.0*a*JH - a*JJ*MH)/(DIM*dJ);
+   // dM = -M H^t M
+   MultABt<DIM>(M, H, MHt);
+   MultAB<DIM>(MHt, M, dM);
+   for (int i = 0; i < DIM*DIM; i++)
+   {
+      // d(det(J) M) = det(J) (MH M + dM)
+      dP[i] = da*J[i] + a*H[i] + db*dJ*M[i] + b*dJ*(MH*M[i] - dM[i]);
+   }
+}
+
+/// InverseHarmonicModel::EvalP(): P = det(J) (-M M^t M + |M|^2/2 M), M=J^{-t}
+template<int DIM> MFEM_HOST_DEVICE inline
+void InverseHarmonicP(const double *J, double *P)
+{
+   double M[DIM*DIM], MMt[DIM*DIM], MMtM[DIM*DIM];
+   const double dJ = InverseTranspose<DIM>(J, M);
+   const double MM = Ddot<DIM>(M, M);
+   MultABt<DIM>(M, M, MMt);
+   MultAB<DIM>(MMt, M, MMtM);
+   for (int i = 0; i < DIM*DIM; i++)
+   {
+      P[i] = dJ*(0.5*MM*M[i] - MMtM[i]);
+   }
+}
+
+/// Directional derivative dP of InverseHarmonicP() at J in the direction H.
+template<int DIM> MFEM_HOST_DEVICE inline
+void InverseHarmonicdP(const double *J, const double *H, double *dP)
+{
+   double M[DIM*DIM], MMt[DIM*DIM], MtM[DIM*DIM], T[DIM*DIM], dM[DIM*DIM];
+   double A[DIM*DIM], B[DIM*DIM], C[DIM*DIM];
+   const double dJ = InverseTranspose<DIM>(J, M);
+   const double MM = Ddot<DIM>(M, M);
+   const double MH = Ddot<DIM>(M, H); // d(det(J))/det(J)
+   // dM = -M H^t M
+   MultABt<DIM>(M, H, T);
+   MultAB<DIM>(T, M, dM);
+   for (int i = 0; i < DIM*DIM; i++) { dM[i] = -dM[i]; }
+   const double MdM = Ddot<DIM>(M, dM);
+   MultABt<DIM>(M, M, MMt);
+   MultAtB<DIM>(M, M, MtM);
+   // A = dM M^t M, B = M dM^t M, C = M M^t dM
+   MultAB<DIM>(dM, MtM, A);
+   MultABt<DIM>(M, dM, T);
+   MultAB<DIM>(T, M, B);
+   MultAB<DIM>(MMt, dM, C);
+   MultAB<DIM>(MMt, M, T); // T = M M^t M
+   for (int i = 0; i < DIM*DIM; i++)
+   {
+      dP[i] = dJ*MH*(0.5*MM*M[i] - T[i]) +
+              dJ*(MdM*M[i] + 0.5*MM*dM[i] - A[i] - B[i] - C[i]);
+   }
+}
+
+} // namespace hyperelastic
+
+const IntegrationRule &HyperelasticNLFIntegrator::GetPARule(
+   const FiniteElement &el) const
+{
+   if (IntRule) { return *IntRule; }
+   return IntRules.Get(el.GetGeomType(), 2*el.GetOrder() + 3);
+}
+
+void HyperelasticNLFIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   Mesh *mesh = fes.GetMesh();
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   pa_fes = &fes;
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule &ir = GetPARule(el);
+   MFEM_VERIFY(dim == 2 || dim == 3, "PA only supports dim = 2 and 3!");
+   MFEM_VERIFY(fes.GetVDim() == dim, "the vector dimension of the space must"
+               " be equal to the dimension of the mesh!");
+   MFEM_VERIFY(dynamic_cast<const TensorBasisElement*>(&el),
+               "PA only supports tensor-product elements!");
+   nq = ir.GetNPoints();
+   maps = &el.GetDofToQuad(ir, DofToQuad::TENSOR);
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(ir, GeometricFactors::JACOBIANS |
+                                GeometricFactors::DETERMINANTS);
+
+   NeoHookeanModel *nh = dynamic_cast<NeoHookeanModel*>(model);
+   if (nh) { pa_model = PAModel::NEO_HOOKEAN; }
+   else if (dynamic_cast<InverseHarmonicModel*>(model))
+   {
+      pa_model = PAModel::INVERSE_HARMONIC;
+   }
+   else
+   {
+      MFEM_ABORT("PA is only implemented for NeoHookeanModel and"
+                 " InverseHarmonicModel!");
+   }
+
+   // Model parameters, evaluated on the host.
+   const int NE = ne;
+   const int NQ = nq;
+   pa_coeff.SetSize(NQ * 4 * NE, Device::GetMemoryType());
+   auto C = Reshape(pa_coeff.HostWrite(), NQ, 4, NE);
+   for (int e = 0; e < NE; e++)
+   {
+      ElementTransformation *T =
+         nh && nh->have_coeffs ? fes.GetElementTransformation(e) : NULL;
+      for (int q = 0; q < NQ; q++)
+      {
+         double mu = 0.0, K = 0.0, g = 1.0;
+         if (nh && !nh->have_coeffs)
+         {
+            mu = nh->mu; K = nh->K; g = nh->g;
+         }
+         else if (nh)
+         {
+            const IntegrationPoint &ip = ir.IntPoint(q);
+            T->SetIntPoint(&ip);
+            mu = nh->c_mu->Eval(*T, ip);
+            K = nh->c_K->Eval(*T, ip);
+            if (nh->c_g) { g = nh->c_g->Eval(*T, ip); }
+         }
+         C(q,1,e) = mu;
+         C(q,2,e) = K;
+         C(q,3,e) = g;
+      }
+   }
+
+   // Geometric data: quadrature weight times det(Jtr) and Jrt = Jtr^{-1}.
+   pa_jrt.SetSize(NQ * dim * dim * NE, Device::GetMemoryType());
+   const auto W = ir.GetWeights().Read();
+   const auto D = Reshape(geom->detJ.Read(), NQ, NE);
+   auto WC = Reshape(pa_coeff.ReadWrite(), NQ, 4, NE);
+   if (dim == 2)
+   {
+      const auto J = Reshape(geom->J.Read(), NQ, 2, 2, NE);
+      auto Jrt = Reshape(pa_jrt.Write(), NQ, 2, 2, NE);
+      MFEM_FORALL(e, NE,
+      {
+         for (int q = 0; q < NQ; ++q)
+         {
+            const double J11 = J(q,0,0,e);
+            const double J21 = J(q,1,0,e);
+            const double J12 = J(q,0,1,e);
+            const double J22 = J(q,1,1,e);
+            const double id = 1.0 / D(q,e);
+            Jrt(q,0,0,e) =  id * J22;
+            Jrt(q,1,0,e) = -id * J21;
+            Jrt(q,0,1,e) = -id * J12;
+            Jrt(q,1,1,e) =  id * J11;
+            WC(q,0,e) = W[q] * D(q,e);
+         }
+      });
+   }
+   if (dim == 3)
+   {
+      const auto J = Reshape(geom->J.Read(), NQ, 3, 3, NE);
+      auto Jrt = Reshape(pa_jrt.Write(), NQ, 3, 3, NE);
+      MFEM_FORALL(e, NE,
+      {
+         for (int q = 0; q < NQ; ++q)
+         {
+            double Jtr[9], Jinv[9];
+            for (int j = 0; j < 3; j++)
+            {
+               for (int i = 0; i < 3; i++) { Jtr[i+3*j] = J(q,i,j,e); }
+            }
+            kernels::CalcInverse<3>(Jtr, Jinv);
+            for (int j = 0; j < 3; j++)
+            {
+               for (int i = 0; i < 3; i++) { Jrt(q,i,j,e) = Jinv[i+3*j]; }
+            }
+            WC(q,0,e) = W[q] * D(q,e);
+         }
+      });
+   }
+}
+
+// Modes of the PA Hyperelastic quadrature point kernel.
+enum { HYPERELASTIC_P = 0, HYPERELASTIC_dP = 1, HYPERELASTIC_STATE = 2 };
+
+// PA Hyperelastic quadrature point kernel. The input X holds the reference
+// gradients Jpr of an E-vector. Depending on the mode, the output Y is
+// w det(Jtr) P(Jpt) Jrt^t, w det(Jtr) dP(Jpt_state)[Jpr Jrt] Jrt^t or the
+// state Jpt = Jpr Jrt itself.
+template<int DIM>
+static void PAHyperelasticQuadApply(const int NE,
+                                    const int NQ,
+                                    const int model,
+                                    const int mode,
+                                    const Vector &jrt_,
+                                    const Vector &c_,
+                                    const Vector &s_,
+                                    const Vector &x_,
+                                    Vector &y_)
+{
+   constexpr int NH = 0; // PAModel::NEO_HOOKEAN
+   const auto Jrt = Reshape(jrt_.Read(), NQ, DIM, DIM, NE);
+   const auto C = Reshape(c_.Read(), NQ, 4, NE);
+   const auto S = Reshape(mode == HYPERELASTIC_dP ? s_.Read() : nullptr,
+                          DIM, DIM, NQ, NE);
+   const auto X = Reshape(x_.Read(), DIM, DIM, NQ, NE);
+   auto Y = Reshape(y_.Write(), DIM, DIM, NQ, NE);
+   MFEM_FORALL(i, NE*NQ,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      double jrt[DIM*DIM], jpr[DIM*DIM], F[DIM*DIM], P[DIM*DIM];
+      for (int c = 0; c < DIM; c++)
+      {
+         for (int r = 0; r < DIM; r++)
+         {
+            jrt[r+DIM*c] = Jrt(q,r,c,e);
+            jpr[r+DIM*c] = X(r,c,q,e);
+         }
+      }
+      hyperelastic::MultAB<DIM>(jpr, jrt, F);
+      if (mode == HYPERELASTIC_STATE)
+      {
+         for (int c = 0; c < DIM; c++)
+         {
+            for (int r = 0; r < DIM; r++) { Y(r,c,q,e) = F[r+DIM*c]; }
+         }
+      }
+      else
+      {
+         const double w = C(q,0,e);
+         if (mode == HYPERELASTIC_P)
+         {
+            if (model == NH)
+            {
+               hyperelastic::NeoHookeanP<DIM>(F, C(q,1,e), C(q,2,e), C(q,3,e),
+                                              P);
+            }
+            else { hyperelastic::InverseHarmonicP<DIM>(F, P); }
+         }
+         else
+         {
+            double Jpt[DIM*DIM];
+            for (int c = 0; c < DIM; c++)
+            {
+               for (int r = 0; r < DIM; r++) { Jpt[r+DIM*c] = S(r,c,q,e); }
+            }
+            if (model == NH)
+            {
+               hyperelastic::NeoHookeandP<DIM>(Jpt, F, C(q,1,e), C(q,2,e),
+                                               C(q,3,e), P);
+            }
+            else { hyperelastic::InverseHarmonicdP<DIM>(Jpt, F, P); }
+         }
+         // Y = w P Jrt^t
+         hyperelastic::MultABt<DIM>(P, jrt, F);
+         for (int c = 0; c < DIM; c++)
+         {
+            for (int r = 0; r < DIM; r++) { Y(r,c,q,e) = w * F[r+DIM*c]; }
+         }
+      }
+   });
+}
+
+// PA Hyperelastic 2D kernel for the transpose of the reference gradient:
+// y(i,c) += sum_q sum_k dphi_i/dxi_k x(c,k,q)
+template<int T_D1D = 0, int T_Q1D = 0>
+static void PAHyperelasticGradT2D(const int NE,
+                                  const Array<double> &b_,
+                                  const Array<double> &g_,
+                                  const Vector &x_,
+                                  Vector &y_,
+                                  const int d1d = 0,
+                                  const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b_.Read(), Q1D, D1D);
+   auto G = Reshape(g_.Read(), Q1D, D1D);
+   auto x = Reshape(x_.Read(), 2, 2, Q1D, Q1D, NE);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, 2, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      for (int c = 0; c < 2; ++c)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double gradX[max_D1D][2];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] = 0.0;
+               gradX[dx][1] = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[dx][0] += G(qx,dx) * x(c,0,qx,qy,e);
+                  gradX[dx][1] += B(qx,dx) * x(c,1,qx,qy,e);
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double By = B(qy,dy);
+               const double Gy = G(qy,dy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  y(dx,dy,c,e) += By * gradX[dx][0] + Gy * gradX[dx][1];
+               }
+            }
+         }
+      }
+   });
+}
+
+// PA Hyperelastic 3D kernel for the transpose of the reference gradient.
+template<int T_D1D = 0, int T_Q1D = 0>
+static void PAHyperelasticGradT3D(const int NE,
+                                  const Array<double> &b_,
+                                  const Array<double> &g_,
+                                  const Vector &x_,
+                                  Vector &y_,
+                                  const int d1d = 0,
+                                  const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b_.Read(), Q1D, D1D);
+   auto G = Reshape(g_.Read(), Q1D, D1D);
+   auto x = Reshape(x_.Read(), 3, 3, Q1D, Q1D, Q1D, NE);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, 3, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      for (int c = 0; c < 3; ++c)
+      {
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            double gradXY[max_D1D][max_D1D][3];
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradXY[dy][dx][0] = 0.0;
+                  gradXY[dy][dx][1] = 0.0;
+                  gradXY[dy][dx][2] = 0.0;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               double gradX[max_D1D][3];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradX[dx][0] = 0.0;
+                  gradX[dx][1] = 0.0;
+                  gradX[dx][2] = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     gradX[dx][0] += G(qx,dx) * x(c,0,qx,qy,qz,e);
+                     gradX[dx][1] += B(qx,dx) * x(c,1,qx,qy,qz,e);
+                     gradX[dx][2] += B(qx,dx) * x(c,2,qx,qy,qz,e);
+                  }
+               }
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  const double By = B(qy,dy);
+                  const double Gy = G(qy,dy);
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     gradXY[dy][dx][0] += By * gradX[dx][0];
+                     gradXY[dy][dx][1] += Gy * gradX[dx][1];
+                     gradXY[dy][dx][2] += By * gradX[dx][2];
+                  }
+               }
+            }
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               const double Bz = B(qz,dz);
+               const double Gz = G(qz,dz);
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     y(dx,dy,dz,c,e) +=
+                        Bz * (gradXY[dy][dx][0] + gradXY[dy][dx][1]) +
+                        Gz * gradXY[dy][dx][2];
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+// Also used by the PA TMOP_Integrator, see tmop_pa.cpp.
+void PAHyperelasticGradT(const int dim,
+                         const int NE,
+                         const DofToQuad &maps,
+                         const Vector &x,
+                         Vector &y)
+{
+   const int D1D = maps.ndof;
+   const int Q1D = maps.nqpt;
+   const int id = (D1D << 4 ) | Q1D;
+   const Array<double> &B = maps.B;
+   const Array<double> &G = maps.G;
+   if (dim == 2)
+   {
+      switch (id)
+      {
+         case 0x23: return PAHyperelasticGradT2D<2,3>(NE,B,G,x,y);
+         case 0x34: return PAHyperelasticGradT2D<3,4>(NE,B,G,x,y);
+         case 0x45: return PAHyperelasticGradT2D<4,5>(NE,B,G,x,y);
+         case 0x56: return PAHyperelasticGradT2D<5,6>(NE,B,G,x,y);
+         default: return PAHyperelasticGradT2D(NE,B,G,x,y,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch (id)
+      {
+         case 0x23: return PAHyperelasticGradT3D<2,3>(NE,B,G,x,y);
+         case 0x34: return PAHyperelasticGradT3D<3,4>(NE,B,G,x,y);
+         case 0x45: return PAHyperelasticGradT3D<4,5>(NE,B,G,x,y);
+         case 0x56: return PAHyperelasticGradT3D<5,6>(NE,B,G,x,y);
+         default: return PAHyperelasticGradT3D(NE,B,G,x,y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void HyperelasticNLFIntegrator::PAQuadratureApply(const Vector &x, Vector &y,
+                                                  int mode) const
+{
+   MFEM_VERIFY(pa_fes, "AssemblePA() has not been called!");
+   const FiniteElement &el = *pa_fes->GetFE(0);
+   const QuadratureInterpolator *qi =
+      pa_fes->GetQuadratureInterpolator(GetPARule(el));
+   qi->SetOutputLayout(QVectorLayout::byVDIM);
+   const int qsize = dim * dim * nq * ne;
+   pa_dx.SetSize(qsize, Device::GetMemoryType());
+   qi->Derivatives(x, pa_dx);
+   const int m = static_cast<int>(pa_model);
+   if (dim == 2)
+   {
+      PAHyperelasticQuadApply<2>(ne, nq, m, mode, pa_jrt, pa_coeff, pa_state,
+                                 pa_dx, y);
+   }
+   if (dim == 3)
+   {
+      PAHyperelasticQuadApply<3>(ne, nq, m, mode, pa_jrt, pa_coeff, pa_state,
+                                 pa_dx, y);
+   }
+}
+
+void HyperelasticNLFIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   pa_qy.SetSize(dim * dim * nq * ne, Device::GetMemoryType());
+   PAQuadratureApply(x, pa_qy, HYPERELASTIC_P);
+   PAHyperelasticGradT(dim, ne, *maps, pa_qy, y);
+}
+
+void HyperelasticNLFIntegrator::AssembleGradPA(const Vector &x,
+                                               const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(pa_fes == &fes, "AssemblePA() has not been called!");
+   if (ne == 0) { return; }
+   pa_state.SetSize(dim * dim * nq * ne, Device::GetMemoryType());
+   PAQuadratureApply(x, pa_state, HYPERELASTIC_STATE);
+}
+
+void HyperelasticNLFIntegrator::AddMultGradPA(const Vector &x,
+                                              Vector &y) const
+{
+   if (ne == 0) { return; }
+   MFEM_VERIFY(pa_state.Size() > 0, "AssembleGradPA() has not been called!");
+   pa_qy.SetSize(dim * dim * nq * ne, Device::GetMemoryType());
+   PAQuadratureApply(x, pa_qy, HYPERELASTIC_dP);
+   PAHyperelasticGradT(dim, ne, *maps, pa_qy, y);
+}
+
+} // namespace mfem
@@ -0,0 +1,260 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_PA_DGFACE_HPP
+#define MFEM_PA_DGFACE_HPP
+
+#include "../config/config.hpp"
+#include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
+
+// Building blocks for the PA and MF kernels of the DG face integrators that act
+// on the element dofs on both sides of the faces, see PADGFaceMaps. The element
+// dofs are first contracted in the normal direction of the face with the 1D
+// basis and its derivative at the face, then interpolated to the face points by
+// sum factorization in the tangential directions.
+
+namespace mfem
+{
+
+namespace internal
+{
+
+/// Return the normal direction @a dir and the tangential directions @a ta and
+/// @a tb of the local face @a loc of a reference element, see PADGFaceMaps.
+MFEM_HOST_DEVICE inline
+void DGFaceDirections(const int dim, const int loc,
+                      int &dir, int &ta, int &tb)
+{
+   dir = loc / 2;
+   ta = (dir == 0) ? 1 : 0;
+   tb = (dir == 2 || dim == 2) ? 1 : 2;
+}
+
+/** @brief Interpolate the values @a u and the reference gradients @a du of the
+    lexicographic element dofs @a X to the points of the local face @a loc. */
+/** The points are numbered lexicographically in the face and @a du has the
+    layout DIM x NQ. The 1D bases have the layouts of PADGFaceMaps. */
+template<int DIM, int MD, int MQ>
+MFEM_HOST_DEVICE inline
+void DGFaceEval(const int D1D, const int Q1D, const int loc,
+                const double *B, const double *G,
+                const double *Bf, const double *Gf,
+                const double *X, double *u, double *du)
+{
+   int dir, ta, tb;
+   DGFaceDirections(DIM, loc, dir, ta, tb);
+   const int side = loc % 2;
+   const int s[3] = { 1, D1D, D1D*D1D };
+   const double *bf = Bf + D1D*side;
+   const double *gf = Gf + D1D*side;
+   if (DIM == 2)
+   {
+      double fv[MD], fn[MD];
+      for (int t = 0; t < D1D; ++t)
+      {
+         double v = 0.0, n = 0.0;
+         for (int i = 0; i < D1D; ++i)
+         {
+            const double x = X[i*s[dir] + t*s[ta]];
+            v += bf[i] * x;
+            n += gf[i] * x;
+         }
+         fv[t] = v;
+         fn[t] = n;
+      }
+      for (int q = 0; q < Q1D; ++q)
+      {
+         double v = 0.0, dt = 0.0, dn = 0.0;
+         for (int t = 0; t < D1D; ++t)
+         {
+            v += B[q + Q1D*t] * fv[t];
+            dt += G[q + Q1D*t] * fv[t];
+            dn += B[q + Q1D*t] * fn[t];
+         }
+         u[q] = v;
+         du[dir + DIM*q] = dn;
+         du[ta + DIM*q] = dt;
+      }
+   }
+   else
+   {
+      double fv[MD][MD], fn[MD][MD];
+      for (int b = 0; b < D1D; ++b)
+      {
+         for (int a = 0; a < D1D; ++a)
+         {
+            double v = 0.0, n = 0.0;
+            for (int i = 0; i < D1D; ++i)
+            {
+               const double x = X[i*s[dir] + a*s[ta] + b*s[tb]];
+               v += bf[i] * x;
+               n += gf[i] * x;
+            }
+            fv[a][b] = v;
+            fn[a][b] = n;
+         }
+      }
+      double bv[MQ][MD], gv[MQ][MD], bn[MQ][MD];
+      for (int b = 0; b < D1D; ++b)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            double v = 0.0, g = 0.0, n = 0.0;
+            for (int a = 0; a < D1D; ++a)
+            {
+               v += B[qa + Q1D*a] * fv[a][b];
+               g += G[qa + Q1D*a] * fv[a][b];
+               n += B[qa + Q1D*a] * fn[a][b];
+            }
+            bv[qa][b] = v;
+            gv[qa][b] = g;
+            bn[qa][b] = n;
+         }
+      }
+      for (int qb = 0; qb < Q1D; ++qb)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            double v = 0.0, da = 0.0, db = 0.0, dn = 0.0;
+            for (int b = 0; b < D1D; ++b)
+            {
+               const double wb = B[qb + Q1D*b];
+               v += wb * bv[qa][b];
+               da += wb * gv[qa][b];
+               db += G[qb + Q1D*b] * bv[qa][b];
+               dn += wb * bn[qa][b];
+            }
+            const int q = qa + Q1D*qb;
+            u[q] = v;
+            du[dir + DIM*q] = dn;
+            du[ta + DIM*q] = da;
+            du[tb + DIM*q] = db;
+         }
+      }
+   }
+}
+
+/** @brief Transpose of DGFaceEval(): integrate the values @a c against the
+    basis and the values @a h against its reference gradient. */
+/** The result is given by the face dof arrays @a zv and @a zn of size
+    D1D^(DIM-1), which multiply the 1D basis and its derivative in the normal
+    direction at the face, see PADGFaceMaps::AddFaceTerms(). */
+template<int DIM, int MD, int MQ>
+MFEM_HOST_DEVICE inline
+void DGFaceEvalT(const int D1D, const int Q1D, const int loc,
+                 const double *B, const double *G,
+                 const double *c, const double *h,
+                 double *zv, double *zn)
+{
+   int dir, ta, tb;
+   DGFaceDirections(DIM, loc, dir, ta, tb);
+   if (DIM == 2)
+   {
+      for (int t = 0; t < D1D; ++t)
+      {
+         double v = 0.0, n = 0.0;
+         for (int q = 0; q < Q1D; ++q)
+         {
+            v += B[q + Q1D*t] * c[q] + G[q + Q1D*t] * h[ta + DIM*q];
+            n += B[q + Q1D*t] * h[dir + DIM*q];
+         }
+         zv[t] = v;
+         zn[t] = n;
+      }
+   }
+   else
+   {
+      double tv[MQ][MD], tg[MQ][MD], tn[MQ][MD];
+      for (int b = 0; b < D1D; ++b)
+      {
+         for (int qa = 0; qa < Q1D; ++qa)
+         {
+            double v = 0.0, g = 0.0, n = 0.0;
+            for (int qb = 0; qb < Q1D; ++qb)
+            {
+               const int q = qa + Q1D*qb;
+               const double wb = B[qb + Q1D*b];
+               v += wb * c[q] + G[qb + Q1D*b] * h[tb + DIM*q];
+               g += wb * h[ta + DIM*q];
+               n += wb * h[dir + DIM*q];
+            }
+            tv[qa][b] = v;
+            tg[qa][b] = g;
+            tn[qa][b] = n;
+         }
+      }
+      for (int b = 0; b < D1D; ++b)
+      {
+         for (int a = 0; a < D1D; ++a)
+         {
+            double v = 0.0, n = 0.0;
+            for (int qa = 0; qa < Q1D; ++qa)
+            {
+               v += B[qa + Q1D*a] * tv[qa][b] + G[qa + Q1D*a] * tg[qa][b];
+               n += B[qa + Q1D*a] * tn[qa][b];
+            }
+            zv[a + D1D*b] = v;
+            zn[a + D1D*b] = n;
+         }
+      }
+   }
+}
+
+/** @brief Compute the Jacobian matrices @a J, with the layout DIM x DIM x NQ,
+    of the mesh element with node E-vector @a X at the points of the local face
+    @a loc, using the mesh node bases of PADGFaceMaps. */
+template<int DIM>
+MFEM_HOST_DEVICE inline
+void DGFaceJacobians(const int ND1D, const int Q1D, const int loc,
+                     const double *B, const double *G,
+                     const double *Bf, const double *Gf,
+                     const double *X, double *J)
+{
+   constexpr int MQ = (DIM == 2) ? MAX_Q1D : MAX_Q1D*MAX_Q1D;
+   const int NQ = (DIM == 2) ? Q1D : Q1D*Q1D;
+   const int ND = (DIM == 2) ? ND1D*ND1D : ND1D*ND1D*ND1D;
+   double u[MQ], du[DIM*MQ];
+   for (int c = 0; c < DIM; ++c)
+   {
+      DGFaceEval<DIM,MAX_D1D,MAX_Q1D>(ND1D, Q1D, loc, B, G, Bf, Gf,
+                                      X + c*ND, u, du);
+      for (int q = 0; q < NQ; ++q)
+      {
+         for (int r = 0; r < DIM; ++r)
+         {
+            J[c + DIM*(r + DIM*q)] = du[r + DIM*q];
+         }
+      }
+   }
+}
+
+/** @brief Compute the normal @a nor of the local face @a loc, pointing out of
+    the element and scaled by the face determinant, from the element Jacobian
+    @a J at a point of the face. */
+template<int DIM>
+MFEM_HOST_DEVICE inline
+void DGFaceNormal(const double *J, const int loc, double *nor)
+{
+   // The normal is adj(J)^t times the reference normal of the face
+   double A[DIM*DIM];
+   kernels::CalcInverse<DIM>(J, A);
+   const double det = kernels::Det<DIM>(J);
+   const int dir = loc / 2;
+   const double sign = (loc % 2) ? det : -det;
+   for (int k = 0; k < DIM; ++k) { nor[k] = sign * A[dir + DIM*k]; }
+}
+
+} // namespace internal
+
+} // namespace mfem
+
+#endif
@@ -0,0 +1,425 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_PA_SIMD_HPP
+#define MFEM_PA_SIMD_HPP
+
+#include "../config/config.hpp"
+#include "../general/device.hpp"
+#include "../linalg/simd.hpp"
+
+// Building blocks for the partial assembly kernels of Backend::CPU_SIMD. These
+// kernels run on the host and process a batch of elements at a time, one
+// element per lane of an AutoSIMD vector, so that every operation of the sum
+// factorization is a full-width SIMD operation, independently of the number of
+// degrees of freedom and quadrature points in 1D.
+
+namespace mfem
+{
+
+namespace internal
+{
+
+/// SIMD type used by the Backend::CPU_SIMD partial assembly kernels.
+/** When MFEM_USE_SIMD is disabled, or when the native SIMD width is less than
+    4 doubles, the generic AutoSIMD implementation with 4 lanes is used and the
+    vectorization is left to the compiler. */
+struct PASimdTraits
+{
+   static const int align_bytes =
+      (MFEM_SIMD_BYTES >= 32) ? MFEM_SIMD_BYTES : 32;
+   static const int simd_size = align_bytes/sizeof(double);
+   typedef AutoSIMD<double, simd_size, align_bytes> vreal_t;
+};
+
+/// Return true if the PA kernels should use the Backend::CPU_SIMD code path.
+inline bool DeviceCanUsePASimd()
+{
+   return Device::Allows(Backend::CPU_SIMD) &&
+          !Device::Allows(Backend::DEVICE_MASK | Backend::OMP_MASK);
+}
+
+/** @brief Load the @a N entries of the @a nl consecutive elements starting at
+    @a src into the lanes of @a dst. Unused lanes are set to zero. */
+template <typename vreal_t>
+inline void PASimdLoad(const int N, const int nl, const double *src,
+                       vreal_t *dst)
+{
+   for (int l = 0; l < nl; l++)
+   {
+      for (int i = 0; i < N; i++) { dst[i][l] = src[i + l*N]; }
+   }
+   for (int l = nl; l < vreal_t::size; l++)
+   {
+      for (int i = 0; i < N; i++) { dst[i][l] = 0.0; }
+   }
+}
+
+/// Add the first @a nl lanes of @a src to the @a N entries of each element.
+template <typename vreal_t>
+inline void PASimdAddStore(const int N, const int nl, const vreal_t *src,
+                           double *dst)
+{
+   for (int l = 0; l < nl; l++)
+   {
+      for (int i = 0; i < N; i++) { dst[i + l*N] += src[i][l]; }
+   }
+}
+
+/// Interpolate the values X[dy][dx] to the quadrature points U[qy][qx].
+template <int D1D, int Q1D, typename vreal_t>
+inline void PASimdEval2D(const double (&B)[Q1D][D1D],
+                         const vreal_t (&X)[D1D][D1D],
+                         vreal_t (&U)[Q1D][Q1D])
+{
+   vreal_t BX[D1D][Q1D];
+   for (int dy = 0; dy < D1D; ++dy)
+   {
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         BX[dy][qx] = 0.0;
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            BX[dy][qx].fma(B[qx][dx], X[dy][dx]);
+         }
+      }
+   }
+   for (int qy = 0; qy < Q1D; ++qy)
+   {
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         U[qy][qx] = 0.0;
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            U[qy][qx].fma(B[qy][dy], BX[dy][qx]);
+         }
+      }
+   }
+}
+
+/// Add the transposed interpolation of U[qy][qx] to Y[dy][dx].
+template <int D1D, int Q1D, typename vreal_t>
+inline void PASimdEvalT2D(const double (&B)[Q1D][D1D],
+                          const vreal_t (&U)[Q1D][Q1D],
+                          vreal_t (&Y)[D1D][D1D])
+{
+   vreal_t BU[Q1D][D1D];
+   for (int qy = 0; qy < Q1D; ++qy)
+   {
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         BU[qy][dx] = 0.0;
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            BU[qy][dx].fma(B[qx][dx], U[qy][qx]);
+         }
+      }
+   }
+   for (int dy = 0; dy < D1D; ++dy)
+   {
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            Y[dy][dx].fma(B[qy][dy], BU[qy][dx]);
+         }
+      }
+   }
+}
+
+/// Interpolate the reference gradient of X[dy][dx] to U[c][qy][qx].
+template <int D1D, int Q1D, typename vreal_t>
+inline void PASimdGrad2D(const double (&B)[Q1D][D1D],
+                         const double (&G)[Q1D][D1D],
+                         const vreal_t (&X)[D1D][D1D],
+                         vreal_t (&U)[2][Q1D][Q1D])
+{
+   vreal_t BX[D1D][Q1D], GX[D1D][Q1D];
+   for (int dy = 0; dy < D1D; ++dy)
+   {
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         BX[dy][qx] = 0.0;
+         GX[dy][qx] = 0.0;
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            BX[dy][qx].fma(B[qx][dx], X[dy][dx]);
+            GX[dy][qx].fma(G[qx][dx], X[dy][dx]);
+         }
+      }
+   }
+   for (int qy = 0; qy < Q1D; ++qy)
+   {
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         U[0][qy][qx] = 0.0;
+         U[1][qy][qx] = 0.0;
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            U[0][qy][qx].fma(B[qy][dy], GX[dy][qx]);
+            U[1][qy][qx].fma(G[qy][dy], BX[dy][qx]);
+         }
+      }
+   }
+}
+
+/// Add the transposed reference gradient of U[c][qy][qx] to Y[dy][dx].
+template <int D1D, int Q1D, typename vreal_t>
+inline void PASimdGradT2D(const double (&B)[Q1D][D1D],
+                          const double (&G)[Q1D][D1D],
+                          const vreal_t (&U)[2][Q1D][Q1D],
+                          vreal_t (&Y)[D1D][D1D])
+{
+   vreal_t GU[Q1D][D1D], BU[Q1D][D1D];
+   for (int qy = 0; qy < Q1D; ++qy)
+   {
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         GU[qy][dx] = 0.0;
+         BU[qy][dx] = 0.0;
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            GU[qy][dx].fma(G[qx][dx], U[0][qy][qx]);
+            BU[qy][dx].fma(B[qx][dx], U[1][qy][qx]);
+         }
+      }
+   }
+   for (int dy = 0; dy < D1D; ++dy)
+   {
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            Y[dy][dx].fma(B[qy][dy], GU[qy][dx]);
+            Y[dy][dx].fma(G[qy][dy], BU[qy][dx]);
+         }
+      }
+   }
+}
+
+/// Interpolate the values X[dz][dy][dx] to the quadrature points U[qz][qy][qx].
+template <int D1D, int Q1D, typename vreal_t>
+inline void PASimdEval3D(const double (&B)[Q1D][D1D],
+                         const vreal_t (&X)[D1D][D1D][D1D],
+                         vreal_t (&U)[Q1D][Q1D][Q1D])
+{
+   vreal_t BX[D1D][D1D][Q1D], BBX[D1D][Q1D][Q1D];
+   for (int dz = 0; dz < D1D; ++dz)
+   {
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            BX[dz][dy][qx] = 0.0;
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               BX[dz][dy][qx].fma(B[qx][dx], X[dz][dy][dx]);
+            }
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            BBX[dz][qy][qx] = 0.0;
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               BBX[dz][qy][qx].fma(B[qy][dy], BX[dz][dy][qx]);
+            }
+         }
+      }
+   }
+   for (int qz = 0; qz < Q1D; ++qz)
+   {
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            U[qz][qy][qx] = 0.0;
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               U[qz][qy][qx].fma(B[qz][dz], BBX[dz][qy][qx]);
+            }
+         }
+      }
+   }
+}
+
+/// Add the transposed interpolation of U[qz][qy][qx] to Y[dz][dy][dx].
+template <int D1D, int Q1D, typename vreal_t>
+inline void PASimdEvalT3D(const double (&B)[Q1D][D1D],
+                          const vreal_t (&U)[Q1D][Q1D][Q1D],
+                          vreal_t (&Y)[D1D][D1D][D1D])
+{
+   vreal_t BU[Q1D][Q1D][D1D], BBU[Q1D][D1D][D1D];
+   for (int qz = 0; qz < Q1D; ++qz)
+   {
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            BU[qz][qy][dx] = 0.0;
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               BU[qz][qy][dx].fma(B[qx][dx], U[qz][qy][qx]);
+            }
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            BBU[qz][dy][dx] = 0.0;
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               BBU[qz][dy][dx].fma(B[qy][dy], BU[qz][qy][dx]);
+            }
+         }
+      }
+   }
+   for (int dz = 0; dz < D1D; ++dz)
+   {
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               Y[dz][dy][dx].fma(B[qz][dz], BBU[qz][dy][dx]);
+            }
+         }
+      }
+   }
+}
+
+/// Interpolate the reference gradient of X[dz][dy][dx] to U[c][qz][qy][qx].
+template <int D1D, int Q1D, typename vreal_t>
+inline void PASimdGrad3D(const double (&B)[Q1D][D1D],
+                         const double (&G)[Q1D][D1D],
+                         const vreal_t (&X)[D1D][D1D][D1D],
+                         vreal_t (&U)[3][Q1D][Q1D][Q1D])
+{
+   vreal_t BX[D1D][Q1D], GX[D1D][Q1D];
+   vreal_t BBX[D1D][Q1D][Q1D], BGX[D1D][Q1D][Q1D], GBX[D1D][Q1D][Q1D];
+   for (int dz = 0; dz < D1D; ++dz)
+   {
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            BX[dy][qx] = 0.0;
+            GX[dy][qx] = 0.0;
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               BX[dy][qx].fma(B[qx][dx], X[dz][dy][dx]);
+               GX[dy][qx].fma(G[qx][dx], X[dz][dy][dx]);
+            }
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            BBX[dz][qy][qx] = 0.0;
+            BGX[dz][qy][qx] = 0.0;
+            GBX[dz][qy][qx] = 0.0;
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               BBX[dz][qy][qx].fma(B[qy][dy], BX[dy][qx]);
+               BGX[dz][qy][qx].fma(B[qy][dy], GX[dy][qx]);
+               GBX[dz][qy][qx].fma(G[qy][dy], BX[dy][qx]);
+            }
+         }
+      }
+   }
+   for (int qz = 0; qz < Q1D; ++qz)
+   {
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            U[0][qz][qy][qx] = 0.0;
+            U[1][qz][qy][qx] = 0.0;
+            U[2][qz][qy][qx] = 0.0;
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               U[0][qz][qy][qx].fma(B[qz][dz], BGX[dz][qy][qx]);
+               U[1][qz][qy][qx].fma(B[qz][dz], GBX[dz][qy][qx]);
+               U[2][qz][qy][qx].fma(G[qz][dz], BBX[dz][qy][qx]);
+            }
+         }
+      }
+   }
+}
+
+/// Add the transposed reference gradient of U[c][qz][qy][qx] to Y[dz][dy][dx]
+template <int D1D, int Q1D, typename vreal_t>
+inline void PASimdGradT3D(const double (&B)[Q1D][D1D],
+                          const double (&G)[Q1D][D1D],
+                          const vreal_t (&U)[3][Q1D][Q1D][Q1D],
+                          vreal_t (&Y)[D1D][D1D][D1D])
+{
+   vreal_t GU[Q1D][D1D], BU1[Q1D][D1D], BU2[Q1D][D1D];
+   vreal_t BGU[Q1D][D1D][D1D], BBU[Q1D][D1D][D1D];
+   for (int qz = 0; qz < Q1D; ++qz)
+   {
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            GU[qy][dx] = 0.0;
+            BU1[qy][dx] = 0.0;
+            BU2[qy][dx] = 0.0;
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               GU[qy][dx].fma(G[qx][dx], U[0][qz][qy][qx]);
+               BU1[qy][dx].fma(B[qx][dx], U[1][qz][qy][qx]);
+               BU2[qy][dx].fma(B[qx][dx], U[2][qz][qy][qx]);
+            }
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            // BGU: derivatives in x and y, BBU: derivative in z
+            BGU[qz][dy][dx] = 0.0;
+            BBU[qz][dy][dx] = 0.0;
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               BGU[qz][dy][dx].fma(B[qy][dy], GU[qy][dx]);
+               BGU[qz][dy][dx].fma(G[qy][dy], BU1[qy][dx]);
+               BBU[qz][dy][dx].fma(B[qy][dy], BU2[qy][dx]);
+            }
+         }
+      }
+   }
+   for (int dz = 0; dz < D1D; ++dz)
+   {
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               Y[dz][dy][dx].fma(B[qz][dz], BGU[qz][dy][dx]);
+               Y[dz][dy][dx].fma(G[qz][dz], BBU[qz][dy][dx]);
+            }
+         }
+      }
+   }
+}
+
+} // namespace mfem::internal
+
+} // namespace mfem
+
+#endif // MFEM_PA_SIMD_HPP
@@ -245,6 +245,7 @@ void ParBilinearForm::Assemble(int skip_zeros)
    {
       AssembleSharedFaces(skip_zeros);
    }
+   mat_reassembled = true;
 }
 
 void ParBilinearForm
@@ -368,19 +369,31 @@ void ParBilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
    }
    else
    {
-      if (mat)
+      const bool keep_mat = reuse_sparsity && !hybridization;
+      // With a kept local matrix, the parallel matrix is only re-formed after
+      // a new Assemble(), see BilinearForm::EnableSparsityReuse().
+      if (mat && (mat_reassembled || !keep_mat))
       {
          const int remove_zeros = 0;
          Finalize(remove_zeros);
+         if (keep_mat)
+         {
+            p_mat.Clear();
+            p_mat_e.Clear();
+         }
          MFEM_VERIFY(p_mat.Ptr() == NULL && p_mat_e.Ptr() == NULL,
                      "The ParBilinearForm must be updated with Update() before "
                      "re-assembling the ParBilinearForm.");
          ParallelAssemble(p_mat, mat);
-         delete mat;
-         mat = NULL;
+         if (!keep_mat)
+         {
+            delete mat;
+            mat = NULL;
+         }
          delete mat_e;
          mat_e = NULL;
          p_mat_e.EliminateRowsCols(p_mat, ess_tdof_list);
+         mat_reassembled = false;
       }
       if (hybridization)
       {
@@ -440,6 +453,7 @@ void ParBilinearForm::Update(FiniteElementSpace *nfes)
 
    p_mat.Clear();
    p_mat_e.Clear();
+   mat_reassembled = false;
 }
 
 
@@ -37,6 +37,9 @@ protected:
 
    bool keep_nbr_block;
 
+   /// True if #mat was filled by Assemble() since the last parallel assembly.
+   bool mat_reassembled;
+
    // Allocate mat - called when (mat == NULL && fbfi.Size() > 0)
    void pAllocMat();
 
@@ -55,7 +58,7 @@ public:
    ParBilinearForm(ParFiniteElementSpace *pf)
       : BilinearForm(pf), pfes(pf),
         p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR)
-   { keep_nbr_block = false; }
+   { keep_nbr_block = false; mat_reassembled = false; }
 
    /** @brief Create a ParBilinearForm on the ParFiniteElementSpace @a *pf,
        using the same integrators as the ParBilinearForm @a *bf.
@@ -67,7 +70,7 @@ public:
    ParBilinearForm(ParFiniteElementSpace *pf, ParBilinearForm *bf)
       : BilinearForm(pf, bf), pfes(pf),
         p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR)
-   { keep_nbr_block = false; }
+   { keep_nbr_block = false; mat_reassembled = false; }
 
    /** When set to true and the ParBilinearForm has interior face integrators,
        the local SparseMatrix will include the rows (in addition to the columns)
@@ -102,6 +102,7 @@ void ParFiniteElementSpace::ParInit(ParMesh *pm)
    P = NULL;
    Pconf = NULL;
    R = NULL;
+   cP_is_copied = false;
 
    num_face_nbr_dofs = -1;
 
@@ -701,6 +702,44 @@ void ParFiniteElementSpace::Build_Dof_TrueDof_Matrix() const // matrix P
    R = Transpose(Pdiag);
 }
 
+void ParFiniteElementSpace::CopyProlongationAndRestriction(
+   const FiniteElementSpace &fes, const Array<int> *perm)
+{
+   const ParFiniteElementSpace *pfes =
+      dynamic_cast<const ParFiniteElementSpace*>(&fes);
+   MFEM_VERIFY(pfes != NULL, "the space must be a ParFiniteElementSpace");
+   MFEM_VERIFY(P == NULL && R == NULL,
+               "the prolongation and restriction matrices are already set");
+   MFEM_VERIFY(GetVSize() == pfes->GetVSize() &&
+               GetTrueVSize() == pfes->GetTrueVSize(),
+               "incompatible finite element spaces");
+
+   HypreParMatrix *pfes_P = pfes->Dof_TrueDof_Matrix();
+   const SparseMatrix *pfes_R = pfes->GetRestrictionMatrix();
+   if (perm)
+   {
+      const int n = perm->Size();
+      SparseMatrix perm_mat(n, pfes->GetVSize());
+      for (int i = 0; i < n; i++)
+      {
+         double s;
+         const int j = DecodeDof((*perm)[i], s);
+         perm_mat.Set(i, j, s);
+      }
+      perm_mat.Finalize();
+      SparseMatrix *perm_mat_tr = Transpose(perm_mat);
+      P = pfes_P->LeftDiagMult(perm_mat, GetDofOffsets());
+      R = Mult(*pfes_R, *perm_mat_tr);
+      delete perm_mat_tr;
+   }
+   else
+   {
+      P = new HypreParMatrix(*pfes_P);
+      R = new SparseMatrix(*pfes_R);
+   }
+   cP_is_copied = true;
+}
+
 HypreParMatrix *ParFiniteElementSpace::GetPartialConformingInterpolation()
 {
    HypreParMatrix *P_pc;
@@ -894,7 +933,7 @@ HYPRE_Int ParFiniteElementSpace::GetMyTDofOffset() const
 
 const Operator *ParFiniteElementSpace::GetProlongationMatrix() const
 {
-   if (Conforming())
+   if (Conforming() && !cP_is_copied)
    {
       if (Pconf) { return Pconf; }
 
@@ -2835,6 +2874,7 @@ void ParFiniteElementSpace::Destroy()
    delete P; P = NULL;
    delete Pconf; Pconf = NULL;
    delete R; R = NULL;
+   cP_is_copied = false;
 
    delete gcomm; gcomm = NULL;
 
@@ -339,6 +339,13 @@ public:
    virtual const SparseMatrix *GetRestrictionMatrix() const
    { Dof_TrueDof_Matrix(); return R; }
 
+   /** @brief Copy the P and R matrices from the ParFiniteElementSpace @a fes,
+       composed with the signed DOF permutation @a perm, if not NULL. */
+   /** See FiniteElementSpace::CopyProlongationAndRestriction(). The spaces
+       must have the same numbers of local DOFs and local true DOFs. */
+   virtual void CopyProlongationAndRestriction(const FiniteElementSpace &fes,
+                                               const Array<int> *perm);
+
    // Face-neighbor functions
    void ExchangeFaceNbrData();
    int GetFaceNbrVSize() const { return num_face_nbr_dofs; }
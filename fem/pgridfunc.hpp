@@ -394,6 +394,31 @@ public:
                              p, exsol, weight, v_weight, irs), pfes->GetComm());
    }
 
+   /** @brief Compute the Lp error in each local element, stored in
+       @a elem_error, and return the global Lp error. */
+   virtual double ComputeLpError(const double p, Coefficient &exsol,
+                                 Vector &elem_error,
+                                 Coefficient *weight = NULL,
+                                 const IntegrationRule *irs[] = NULL) const
+   {
+      return GlobalLpNorm(p, GridFunction::ComputeLpError(
+                             p, exsol, elem_error, weight, irs),
+                          pfes->GetComm());
+   }
+
+   /** @brief Compute the Lp error in each local element, stored in
+       @a elem_error, and return the global Lp error. */
+   virtual double ComputeLpError(const double p, VectorCoefficient &exsol,
+                                 Vector &elem_error,
+                                 Coefficient *weight = NULL,
+                                 VectorCoefficient *v_weight = NULL,
+                                 const IntegrationRule *irs[] = NULL) const
+   {
+      return GlobalLpNorm(p, GridFunction::ComputeLpError(
+                             p, exsol, elem_error, weight, v_weight, irs),
+                          pfes->GetComm());
+   }
+
    virtual void ComputeFlux(BilinearFormIntegrator &blfi,
                             GridFunction &flux,
                             bool wcoef = true, int subdomain = -1);
@@ -0,0 +1,320 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "pointlocator.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace mfem
+{
+
+PointLocator::PointLocator(Mesh &m, double bb_t, int elems_per_cell_)
+   : mesh(&m), sdim(m.SpaceDimension()), bb_tol(bb_t),
+     elems_per_cell(elems_per_cell_)
+{
+   MFEM_VERIFY(elems_per_cell > 0, "Invalid number of elements per cell.");
+   Update();
+}
+
+void PointLocator::Update()
+{
+   sdim = mesh->SpaceDimension();
+   MFEM_VERIFY(sdim >= 1 && sdim <= 3, "Invalid space dimension.");
+   const int NE = mesh->GetNE();
+   for (int d = 0; d < 3; d++)
+   {
+      box_min[d] = (d < sdim) ? std::numeric_limits<double>::max() : 0.0;
+      box_max[d] = (d < sdim) ? -std::numeric_limits<double>::max() : 0.0;
+      nx[d] = 1;
+      h[d] = 1.0;
+   }
+
+   // Compute the enlarged bounding boxes of the elements from their nodes.
+   elem_box.SetSize(2*sdim, NE);
+   IsoparametricTransformation T;
+   for (int e = 0; e < NE; e++)
+   {
+      mesh->GetElementTransformation(e, &T);
+      const DenseMatrix &pm = T.GetPointMat();
+      double size = 0.0;
+      for (int d = 0; d < sdim; d++)
+      {
+         double xmin = pm(d,0), xmax = pm(d,0);
+         for (int j = 1; j < pm.Width(); j++)
+         {
+            xmin = std::min(xmin, pm(d,j));
+            xmax = std::max(xmax, pm(d,j));
+         }
+         elem_box(2*d,e) = xmin;
+         elem_box(2*d+1,e) = xmax;
+         size = std::max(size, xmax - xmin);
+      }
+      for (int d = 0; d < sdim; d++)
+      {
+         elem_box(2*d,e) -= bb_tol*size;
+         elem_box(2*d+1,e) += bb_tol*size;
+         box_min[d] = std::min(box_min[d], elem_box(2*d,e));
+         box_max[d] = std::max(box_max[d], elem_box(2*d+1,e));
+      }
+   }
+   if (NE == 0)
+   {
+      cell_elements.Clear();
+      return;
+   }
+
+   // Choose cubic cells with about elems_per_cell elements each. Directions in
+   // which the mesh is thinner than a cell get a single layer of cells, and the
+   // cell size is recomputed from the remaining directions.
+   const int target_cells = std::max(1, NE/elems_per_cell);
+   double ext[3];
+   bool active[3];
+   for (int d = 0; d < sdim; d++)
+   {
+      ext[d] = box_max[d] - box_min[d];
+      active[d] = ext[d] > 0.0;
+   }
+   double hc = 1.0;
+   for (int iter = 0; iter < sdim; iter++)
+   {
+      double volume = 1.0;
+      int num_active = 0;
+      for (int d = 0; d < sdim; d++)
+      {
+         if (active[d]) { volume *= ext[d]; num_active++; }
+      }
+      if (num_active == 0) { break; }
+      hc = std::pow(volume/target_cells, 1.0/num_active);
+      bool changed = false;
+      for (int d = 0; d < sdim; d++)
+      {
+         if (active[d] && ext[d] < hc) { active[d] = false; changed = true; }
+      }
+      if (!changed) { break; }
+   }
+   int num_cells = 1;
+   for (int d = 0; d < sdim; d++)
+   {
+      nx[d] = active[d] ? std::max(1, (int) std::floor(ext[d]/hc + 0.5)) : 1;
+      h[d] = (ext[d] > 0.0) ? ext[d]/nx[d] : 1.0;
+      num_cells *= nx[d];
+   }
+
+   // Add each element to the cells overlapped by its box.
+   Array<int> lo(3), hi(3);
+   lo = 0;
+   hi = 0;
+   cell_elements.MakeI(num_cells);
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int e = 0; e < NE; e++)
+      {
+         for (int d = 0; d < sdim; d++)
+         {
+            const int i0 = (int) std::floor((elem_box(2*d,e)-box_min[d])/h[d]);
+            const int i1 =
+               (int) std::floor((elem_box(2*d+1,e)-box_min[d])/h[d]);
+            lo[d] = std::max(0, std::min(i0, nx[d]-1));
+            hi[d] = std::max(0, std::min(i1, nx[d]-1));
+         }
+         for (int k = lo[2]; k <= hi[2]; k++)
+         {
+            for (int j = lo[1]; j <= hi[1]; j++)
+            {
+               for (int i = lo[0]; i <= hi[0]; i++)
+               {
+                  const int c = i + nx[0]*(j + nx[1]*k);
+                  if (pass == 0) { cell_elements.AddAColumnInRow(c); }
+                  else { cell_elements.AddConnection(c, e); }
+               }
+            }
+         }
+      }
+      if (pass == 0) { cell_elements.MakeJ(); }
+   }
+   cell_elements.ShiftUpI();
+}
+
+int PointLocator::FindCell(const double *x) const
+{
+   int c = 0, stride = 1;
+   for (int d = 0; d < sdim; d++)
+   {
+      if (x[d] < box_min[d] || x[d] > box_max[d]) { return -1; }
+      const int i = (int) std::floor((x[d] - box_min[d])/h[d]);
+      c += stride*std::min(i, nx[d]-1);
+      stride *= nx[d];
+   }
+   return c;
+}
+
+int PointLocator::FindPoints(const DenseMatrix &point_mat,
+                             Array<int> &elem_ids,
+                             Array<IntegrationPoint> &ips, bool warn)
+{
+   const int npts = point_mat.Width();
+   elem_ids.SetSize(npts);
+   ips.SetSize(npts);
+   elem_ids = -1;
+   if (npts == 0 || mesh->GetNE() == 0) { return 0; }
+   MFEM_VERIFY(point_mat.Height() == sdim, "Invalid points matrix");
+   if (mesh->GetNodes()) { mesh->GetNodes()->HostRead(); }
+
+   int pts_found = 0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel reduction(+:pts_found)
+#endif
+   {
+      IsoparametricTransformation T;
+      InverseElementTransformation inv(inv_tr);
+      Vector pt;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(dynamic, 64)
+#endif
+      for (int k = 0; k < npts; k++)
+      {
+         const double *x = point_mat.GetColumn(k);
+         const int c = FindCell(x);
+         if (c < 0) { continue; }
+         pt.SetDataAndSize(const_cast<double*>(x), sdim);
+         const int *elems = cell_elements.GetRow(c);
+         for (int j = 0; j < cell_elements.RowSize(c); j++)
+         {
+            const int e = elems[j];
+            bool inside_box = true;
+            for (int d = 0; d < sdim && inside_box; d++)
+            {
+               inside_box = (x[d] >= elem_box(2*d,e) &&
+                             x[d] <= elem_box(2*d+1,e));
+            }
+            if (!inside_box) { continue; }
+            mesh->GetElementTransformation(e, &T);
+            inv.SetTransformation(T);
+            const int res = inv.Transform(pt, ips[k]);
+            if (res == InverseElementTransformation::Inside)
+            {
+               elem_ids[k] = e;
+               pts_found++;
+               break;
+            }
+         }
+      }
+   }
+
+   if (warn && pts_found != npts)
+   {
+      MFEM_WARNING((npts-pts_found) << " points were not found");
+   }
+   return pts_found;
+}
+
+void PointLocator::Interpolate(const GridFunction &gf,
+                               const Array<int> &elem_ids,
+                               const Array<IntegrationPoint> &ips,
+                               DenseMatrix &vals) const
+{
+   MFEM_VERIFY(gf.FESpace()->GetMesh() == mesh,
+               "The GridFunction is not defined on the mesh of the locator.");
+   const int npts = elem_ids.Size();
+   vals.SetSize(gf.VectorDim(), npts);
+   vals = 0.0;
+   gf.HostRead();
+   if (mesh->GetNodes()) { mesh->GetNodes()->HostRead(); }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation T;
+      Vector val;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (int k = 0; k < npts; k++)
+      {
+         if (elem_ids[k] < 0) { continue; }
+         mesh->GetElementTransformation(elem_ids[k], &T);
+         T.SetIntPoint(&ips[k]);
+         vals.GetColumnReference(k, val);
+         gf.GetVectorValue(T, ips[k], val);
+      }
+   }
+}
+
+int PointLocator::Interpolate(const DenseMatrix &point_mat,
+                              const GridFunction &gf, DenseMatrix &vals,
+                              bool warn)
+{
+   Array<int> elem_ids;
+   Array<IntegrationPoint> ips;
+   const int pts_found = FindPoints(point_mat, elem_ids, ips, warn);
+   Interpolate(gf, elem_ids, ips, vals);
+   return pts_found;
+}
+
+#ifdef MFEM_USE_MPI
+ParPointLocator::ParPointLocator(ParMesh &pm, double bb_t, int elems_per_cell_)
+   : PointLocator(pm, bb_t, elems_per_cell_), comm(pm.GetComm()) { }
+
+int ParPointLocator::FindPoints(const DenseMatrix &point_mat,
+                                Array<int> &elem_ids,
+                                Array<IntegrationPoint> &ips, bool warn)
+{
+   const int npts = point_mat.Width();
+   if (npts == 0) { return 0; }
+   PointLocator::FindPoints(point_mat, elem_ids, ips, false);
+
+   // Assign each point to the rank with the smallest index that found it, as
+   // in ParMesh::FindPoints().
+   int rank, nranks;
+   MPI_Comm_rank(comm, &rank);
+   MPI_Comm_size(comm, &nranks);
+   Array<int> my_point_rank(npts), glob_point_rank(npts);
+   for (int k = 0; k < npts; k++)
+   {
+      my_point_rank[k] = (elem_ids[k] == -1) ? nranks : rank;
+   }
+   MPI_Allreduce(my_point_rank.GetData(), glob_point_rank.GetData(), npts,
+                 MPI_INT, MPI_MIN, comm);
+
+   int pts_found = 0;
+   for (int k = 0; k < npts; k++)
+   {
+      if (glob_point_rank[k] == nranks) { elem_ids[k] = -1; }
+      else
+      {
+         pts_found++;
+         if (glob_point_rank[k] != rank) { elem_ids[k] = -2; }
+      }
+   }
+   if (warn && pts_found != npts && rank == 0)
+   {
+      MFEM_WARNING((npts-pts_found) << " points were not found");
+   }
+   return pts_found;
+}
+
+void ParPointLocator::Interpolate(const GridFunction &gf,
+                                  const Array<int> &elem_ids,
+                                  const Array<IntegrationPoint> &ips,
+                                  DenseMatrix &vals) const
+{
+   // Each point is owned by at most one rank, the others contribute zeros.
+   DenseMatrix loc_vals;
+   PointLocator::Interpolate(gf, elem_ids, ips, loc_vals);
+   vals.SetSize(loc_vals.Height(), loc_vals.Width());
+   MPI_Allreduce(loc_vals.Data(), vals.Data(),
+                 loc_vals.Height()*loc_vals.Width(), MPI_DOUBLE, MPI_SUM, comm);
+}
+#endif
+
+} // namespace mfem
@@ -0,0 +1,139 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#ifndef MFEM_POINT_LOCATOR
+#define MFEM_POINT_LOCATOR
+
+#include "../config/config.hpp"
+#include "../general/table.hpp"
+#include "gridfunc.hpp"
+
+#ifdef MFEM_USE_MPI
+#include "../mesh/pmesh.hpp"
+#endif
+
+namespace mfem
+{
+
+/** @brief PointLocator finds the elements and the reference coordinates of
+    arbitrary points in physical space, and evaluates GridFunctions there.
+
+    The bounding boxes of the elements, enlarged by a relative tolerance to
+    account for curved elements, are binned in a uniform Cartesian grid covering
+    the mesh. A point is then only tested, with an InverseElementTransformation,
+    against the few elements whose bounding boxes contain it, instead of the
+    linear search over all elements done by Mesh::FindPoints(). The points are
+    processed in parallel with OpenMP when MFEM_USE_OPENMP is enabled.
+
+    The grid is built by the constructor; Update() must be called after the mesh
+    has been modified or its nodes have moved. */
+class PointLocator
+{
+protected:
+   Mesh *mesh;
+   int sdim;
+   double bb_tol;          ///< Relative enlargement of the element boxes
+   double box_min[3], box_max[3]; ///< Bounding box of the mesh
+   int nx[3];              ///< Number of grid cells in each direction
+   double h[3];            ///< Size of the grid cells in each direction
+   int elems_per_cell;     ///< Target number of elements per grid cell
+   DenseMatrix elem_box;   ///< Element boxes, (min, max) x sdim x NE
+   Table cell_elements;    ///< Elements whose boxes overlap each grid cell
+   InverseElementTransformation inv_tr; ///< Copied by each thread
+
+   /// Return the index of the grid cell containing the point @a x, or -1.
+   int FindCell(const double *x) const;
+
+public:
+   /** @brief Build the spatial index over the elements of @a m.
+
+       @param[in] m               The mesh; it is not owned.
+       @param[in] bb_t            Relative size of the enlargement of the
+                                  element bounding boxes.
+       @param[in] elems_per_cell  Target average number of elements per cell
+                                  of the uniform grid. */
+   PointLocator(Mesh &m, double bb_t = 0.1, int elems_per_cell = 2);
+
+   virtual ~PointLocator() { }
+
+   /// Rebuild the spatial index after the mesh has been changed.
+   void Update();
+
+   /** @brief Return the InverseElementTransformation used to compute the
+       reference coordinates, e.g. to change its solver or tolerance. */
+   InverseElementTransformation &GetInverseTransformation() { return inv_tr; }
+
+   /** @brief Find the elements containing the points given in the columns of
+       @a point_mat, which should have SpaceDimension() rows.
+
+       On return, @a elem_ids[i] is the element containing the i-th point, or
+       -1 if it was not found, and @a ips[i] holds its reference coordinates.
+       When a point is on the boundary of several elements, the one with the
+       smallest index is used. This has the same interface as
+       Mesh::FindPoints(), including the convention for points found by other
+       ranks in ParPointLocator.
+
+       @returns The total number of points that were found. */
+   virtual int FindPoints(const DenseMatrix &point_mat, Array<int> &elem_ids,
+                          Array<IntegrationPoint> &ips, bool warn = true);
+
+   /** @brief Evaluate the GridFunction @a gf, defined on the mesh of the
+       PointLocator, at the points described by @a elem_ids and @a ips, as
+       returned by FindPoints().
+
+       The values are stored in the columns of @a vals, which is resized to
+       gf.VectorDim() x elem_ids.Size(). The values at the points that were not
+       found are set to zero. */
+   virtual void Interpolate(const GridFunction &gf, const Array<int> &elem_ids,
+                            const Array<IntegrationPoint> &ips,
+                            DenseMatrix &vals) const;
+
+   /** @brief Find the points in the columns of @a point_mat and evaluate the
+       GridFunction @a gf there, see FindPoints() and Interpolate(). */
+   int Interpolate(const DenseMatrix &point_mat, const GridFunction &gf,
+                   DenseMatrix &vals, bool warn = true);
+};
+
+#ifdef MFEM_USE_MPI
+/** @brief Parallel version of PointLocator, where each rank indexes its local
+    elements of a ParMesh.
+
+    The points given to FindPoints() and Interpolate() are expected to be the
+    same on all ranks. Each point is assigned to the rank with the smallest
+    index among the ranks that found it, and Interpolate() returns the values at
+    all points on all ranks. */
+class ParPointLocator : public PointLocator
+{
+protected:
+   MPI_Comm comm;
+
+public:
+   ParPointLocator(ParMesh &pm, double bb_t = 0.1, int elems_per_cell = 2);
+
+   /** @brief Find the points on the local elements. On the ranks that do not
+       own the i-th point, @a elem_ids[i] is -2 if it was found by another rank,
+       as in ParMesh::FindPoints(). */
+   virtual int FindPoints(const DenseMatrix &point_mat, Array<int> &elem_ids,
+                          Array<IntegrationPoint> &ips, bool warn = true);
+
+   /** @brief Evaluate the ParGridFunction @a gf at the points found by
+       FindPoints(). The values at all points are returned on all ranks. */
+   virtual void Interpolate(const GridFunction &gf, const Array<int> &elem_ids,
+                            const Array<IntegrationPoint> &ips,
+                            DenseMatrix &vals) const;
+
+   using PointLocator::Interpolate;
+};
+#endif
+
+} // namespace mfem
+
+#endif // MFEM_POINT_LOCATOR
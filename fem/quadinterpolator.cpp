@@ -62,10 +62,12 @@ void QuadratureInterpolator::Eval2D(
    const int nq = maps.nqpt;
    const int ND = T_ND ? T_ND : nd;
    const int NQ = T_NQ ? T_NQ : nq;
-   const int NMAX = NQ > ND ? NQ : ND;
+   // The threads loop over the dofs and the quadrature points, so the block
+   // size is limited to MAX_NQ2D, while NQ itself is not bounded.
+   const int NDQ = NQ > ND ? NQ : ND;
+   const int NMAX = NDQ < MAX_NQ2D ? NDQ : MAX_NQ2D;
    const int VDIM = T_VDIM ? T_VDIM : vdim;
    MFEM_VERIFY(ND <= MAX_ND2D, "");
-   MFEM_VERIFY(NQ <= MAX_NQ2D, "");
    MFEM_VERIFY(VDIM == 2 || !(eval_flags & DETERMINANTS), "");
    auto B = Reshape(maps.B.Read(), NQ, ND);
    auto G = Reshape(maps.G.Read(), NQ, 2, ND);
@@ -153,10 +155,12 @@ void QuadratureInterpolator::Eval3D(
    const int nq = maps.nqpt;
    const int ND = T_ND ? T_ND : nd;
    const int NQ = T_NQ ? T_NQ : nq;
-   const int NMAX = NQ > ND ? NQ : ND;
+   // The threads loop over the dofs and the quadrature points, so the block
+   // size is limited to MAX_NQ3D, while NQ itself is not bounded.
+   const int NDQ = NQ > ND ? NQ : ND;
+   const int NMAX = NDQ < MAX_NQ3D ? NDQ : MAX_NQ3D;
    const int VDIM = T_VDIM ? T_VDIM : vdim;
    MFEM_VERIFY(ND <= MAX_ND3D, "");
-   MFEM_VERIFY(NQ <= MAX_NQ3D, "");
    MFEM_VERIFY(VDIM == 3 || !(eval_flags & DETERMINANTS), "");
    auto B = Reshape(maps.B.Read(), NQ, ND);
    auto G = Reshape(maps.G.Read(), NQ, 3, ND);
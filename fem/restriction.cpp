@@ -24,15 +24,21 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
      vdim(fes.GetVDim()),
      byvdim(fes.GetOrdering() == Ordering::byVDIM),
      ndofs(fes.GetNDofs()),
+     mixed(fes.GetMesh()->GetNumGeometries(fes.GetMesh()->Dimension()) > 1),
      dof(ne > 0 ? fes.GetFE(0)->GetDof() : 0),
-     nedofs(ne*dof),
+     nedofs(mixed ? fes.GetElementToDofTable().Size_of_connections() : ne*dof),
      offsets(ndofs+1),
-     indices(ne*dof),
-     gatherMap(ne*dof)
+     indices(nedofs),
+     gatherMap(nedofs)
 {
-   // Assuming all finite elements are the same.
-   height = vdim*ne*dof;
+   height = vdim*nedofs;
    width = fes.GetVSize();
+   if (mixed)
+   {
+      SetupMixed(e_ordering);
+      return;
+   }
+   // Assuming all finite elements are the same.
    const bool dof_reorder = (e_ordering == ElementDofOrdering::LEXICOGRAPHIC);
    const int *dof_map = NULL;
    if (dof_reorder && ne > 0)
@@ -97,8 +103,126 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
    offsets[0] = 0;
 }
 
+void ElementRestriction::SetupMixed(ElementDofOrdering e_ordering)
+{
+   // The local dofs are numbered group by group, see GetElementGroups()
+   Array<int> group_offsets, group_elements;
+   fes.GetElementGroups(group_offsets, group_elements);
+   e_index.SetSize(nedofs);
+   e_stride.SetSize(nedofs);
+   const Table &e2dTable = fes.GetElementToDofTable();
+   const bool lex = (e_ordering == ElementDofOrdering::LEXICOGRAPHIC);
+   Array<int> e_dofs;
+   for (int i = 0; i <= ndofs; ++i)
+   {
+      offsets[i] = 0;
+   }
+   for (int k = 0; k < e2dTable.Size_of_connections(); ++k)
+   {
+      const int sgid = e2dTable.GetJ()[k];  // signed
+      const int gid = (sgid >= 0) ? sgid : -1 - sgid;
+      ++offsets[gid + 1];
+   }
+   for (int i = 1; i <= ndofs; ++i)
+   {
+      offsets[i] += offsets[i - 1];
+   }
+   int lid = 0;
+   for (int g = 0; g + 1 < group_offsets.Size(); g++)
+   {
+      const int e_begin = group_offsets[g], e_end = group_offsets[g+1];
+      if (e_begin == e_end) { continue; }
+      const int e0 = group_elements[e_begin];
+      const int nd = fes.GetFE(e0)->GetDof();
+      const TensorBasisElement *el =
+         dynamic_cast<const TensorBasisElement*>(fes.GetFE(e0));
+      const int *dof_map = (lex && el) ? el->GetDofMap().GetData() : NULL;
+      MFEM_VERIFY(!dof_map || el->GetDofMap().Size() == nd, "invalid dof map");
+      for (int k = e_begin; k < e_end; k++)
+      {
+         e2dTable.GetRow(group_elements[k], e_dofs);
+         MFEM_ASSERT(e_dofs.Size() == nd, "invalid element group");
+         for (int d = 0; d < nd; ++d, ++lid)
+         {
+            const int sdid = dof_map ? dof_map[d] : 0;  // signed
+            const int did = (!dof_map)?d:(sdid >= 0 ? sdid : -1-sdid);
+            const int sgid = e_dofs[did];  // signed
+            const int gid = (sgid >= 0) ? sgid : -1-sgid;
+            const bool plus =
+               (sgid >= 0 && sdid >= 0) || (sgid < 0 && sdid < 0);
+            gatherMap[lid] = plus ? gid : -1-gid;
+            indices[offsets[gid]++] = plus ? lid : -1-lid;
+            // lid - d is the first local dof of the element
+            e_index[lid] = vdim*(lid - d) + d;
+            e_stride[lid] = nd;
+         }
+      }
+   }
+   MFEM_VERIFY(lid == nedofs, "invalid element groups");
+   for (int i = ndofs; i > 0; --i)
+   {
+      offsets[i] = offsets[i - 1];
+   }
+   offsets[0] = 0;
+}
+
+void ElementRestriction::MixedMult(const Vector& x, Vector& y,
+                                   const bool use_signs) const
+{
+   const int vd = vdim;
+   const bool t = byvdim;
+   auto d_x = Reshape(x.Read(), t?vd:ndofs, t?ndofs:vd);
+   auto d_y = y.Write();
+   auto d_gatherMap = gatherMap.Read();
+   auto d_e_index = e_index.Read();
+   auto d_e_stride = e_stride.Read();
+   MFEM_FORALL(i, nedofs,
+   {
+      const int gid = d_gatherMap[i];
+      const bool plus = !use_signs || gid >= 0;
+      const int j = gid >= 0 ? gid : -1-gid;
+      for (int c = 0; c < vd; ++c)
+      {
+         const double dofValue = d_x(t?c:j, t?j:c);
+         d_y[d_e_index[i] + c*d_e_stride[i]] = plus ? dofValue : -dofValue;
+      }
+   });
+}
+
+void ElementRestriction::MixedMultTranspose(const Vector& x, Vector& y,
+                                            const bool use_signs) const
+{
+   const int vd = vdim;
+   const bool t = byvdim;
+   auto d_offsets = offsets.Read();
+   auto d_indices = indices.Read();
+   auto d_e_index = e_index.Read();
+   auto d_e_stride = e_stride.Read();
+   auto d_x = x.Read();
+   auto d_y = Reshape(y.Write(), t?vd:ndofs, t?ndofs:vd);
+   MFEM_FORALL(i, ndofs,
+   {
+      const int offset = d_offsets[i];
+      const int nextOffset = d_offsets[i + 1];
+      for (int c = 0; c < vd; ++c)
+      {
+         double dofValue = 0;
+         for (int j = offset; j < nextOffset; ++j)
+         {
+            const bool plus = !use_signs || d_indices[j] >= 0;
+            const int idx_j =
+               (d_indices[j] >= 0) ? d_indices[j] : -1 - d_indices[j];
+            const double value = d_x[d_e_index[idx_j] + c*d_e_stride[idx_j]];
+            dofValue += plus ? value : -value;
+         }
+         d_y(t?c:i,t?i:c) = dofValue;
+      }
+   });
+}
+
 void ElementRestriction::Mult(const Vector& x, Vector& y) const
 {
+   if (mixed) { return MixedMult(x, y, true); }
    // Assumes all elements have the same number of dofs
    const int nd = dof;
    const int vd = vdim;
@@ -121,6 +245,7 @@ void ElementRestriction::Mult(const Vector& x, Vector& y) const
 
 void ElementRestriction::MultUnsigned(const Vector& x, Vector& y) const
 {
+   if (mixed) { return MixedMult(x, y, false); }
    // Assumes all elements have the same number of dofs
    const int nd = dof;
    const int vd = vdim;
@@ -142,6 +267,7 @@ void ElementRestriction::MultUnsigned(const Vector& x, Vector& y) const
 
 void ElementRestriction::MultTranspose(const Vector& x, Vector& y) const
 {
+   if (mixed) { return MixedMultTranspose(x, y, true); }
    // Assumes all elements have the same number of dofs
    const int nd = dof;
    const int vd = vdim;
@@ -170,6 +296,7 @@ void ElementRestriction::MultTranspose(const Vector& x, Vector& y) const
 
 void ElementRestriction::MultTransposeUnsigned(const Vector& x, Vector& y) const
 {
+   if (mixed) { return MixedMultTranspose(x, y, false); }
    // Assumes all elements have the same number of dofs
    const int nd = dof;
    const int vd = vdim;
@@ -197,6 +324,7 @@ void ElementRestriction::MultTransposeUnsigned(const Vector& x, Vector& y) const
 
 void ElementRestriction::BooleanMask(Vector& y) const
 {
+   MFEM_VERIFY(!mixed, "Meshes with mixed elements are not supported");
    // Assumes all elements have the same number of dofs
    const int nd = dof;
    const int vd = vdim;
@@ -235,6 +363,7 @@ void ElementRestriction::BooleanMask(Vector& y) const
 void ElementRestriction::FillSparseMatrix(const Vector &mat_ea,
                                           SparseMatrix &mat) const
 {
+   MFEM_VERIFY(!mixed, "Meshes with mixed elements are not supported");
    mat.GetMemoryI().New(mat.Height()+1, mat.GetMemoryI().GetMemoryType());
    const int nnz = FillI(mat);
    mat.GetMemoryJ().New(nnz, mat.GetMemoryJ().GetMemoryType());
@@ -283,6 +412,7 @@ static MFEM_HOST_DEVICE int GetAndIncrementNnzIndex(const int i_L, int* I)
 
 int ElementRestriction::FillI(SparseMatrix &mat) const
 {
+   MFEM_VERIFY(!mixed, "Meshes with mixed elements are not supported");
    static constexpr int Max = MaxNbNbr;
    const int all_dofs = ndofs;
    const int vd = vdim;
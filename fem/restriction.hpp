@@ -41,11 +41,23 @@ protected:
    const int vdim;
    const bool byvdim;
    const int ndofs;
+   /// True on meshes with several element geometries.
+   const bool mixed;
+   /// The number of dofs of the first element (of all elements, if !mixed).
    const int dof;
    const int nedofs;
    Array<int> offsets;
    Array<int> indices;
    Array<int> gatherMap;
+   /** @brief For mixed meshes: the E-vector index of the first vector
+       component of each local dof, and the stride between the vector
+       components, i.e. the number of dofs of the element. */
+   Array<int> e_index, e_stride;
+
+   void SetupMixed(ElementDofOrdering e_ordering);
+   void MixedMult(const Vector &x, Vector &y, const bool use_signs) const;
+   void MixedMultTranspose(const Vector &x, Vector &y,
+                           const bool use_signs) const;
 
 public:
    ElementRestriction(const FiniteElementSpace&, ElementDofOrdering);
@@ -21,12 +21,23 @@ namespace mfem
 
 double TMOP_Metric_001::EvalW(const DenseMatrix &Jpt) const
 {
+   if (Jpt.Height() == 3)
+   {
+      ie3D.SetJacobian(Jpt.GetData());
+      return ie3D.Get_I1();
+   }
    ie.SetJacobian(Jpt.GetData());
    return ie.Get_I1();
 }
 
 void TMOP_Metric_001::EvalP(const DenseMatrix &Jpt, DenseMatrix &P) const
 {
+   if (Jpt.Height() == 3)
+   {
+      ie3D.SetJacobian(Jpt.GetData());
+      P = ie3D.Get_dI1();
+      return;
+   }
    ie.SetJacobian(Jpt.GetData());
    P = ie.Get_dI1();
 }
@@ -36,6 +47,13 @@ void TMOP_Metric_001::AssembleH(const DenseMatrix &Jpt,
                                 const double weight,
                                 DenseMatrix &A) const
 {
+   if (Jpt.Height() == 3)
+   {
+      ie3D.SetJacobian(Jpt.GetData());
+      ie3D.SetDerivativeMatrix(DS.Height(), DS.GetData());
+      ie3D.Assemble_ddI1(weight, A.GetData());
+      return;
+   }
    ie.SetJacobian(Jpt.GetData());
    ie.SetDerivativeMatrix(DS.Height(), DS.GetData());
    ie.Assemble_ddI1(weight, A.GetData());
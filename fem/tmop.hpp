@@ -71,11 +71,12 @@ public:
 };
 
 
-/// Metric without a type, 2D
+/// Metric without a type, 2D and 3D
 class TMOP_Metric_001 : public TMOP_QualityMetric
 {
 protected:
    mutable InvariantsEvaluator2D<double> ie;
+   mutable InvariantsEvaluator3D<double> ie3D;
 
 public:
    // W = |J|^2.
@@ -945,6 +946,29 @@ protected:
    //        output - the result of AssembleElementVector() (dof x dim).
    DenseMatrix DSh, DS, Jrt, Jpr, Jpt, P, PMatI, PMatO;
 
+   // Partial assembly data, see AssemblePA().
+   struct
+   {
+      int dim, ne, nq, metric;
+      const FiniteElementSpace *fes;
+      const IntegrationRule *ir;
+      const DofToQuad *maps;
+      // Jrt at each quadrature point: dim x dim x nq x ne.
+      Vector Jrt;
+      // Quadrature weight times det(Jtr): nq x ne.
+      Vector W;
+      // Limiting: x0 (dim x nq x ne) and 1/d^2 (nq x ne).
+      Vector X0, LD;
+      // The state Jpt stored by AssembleGradPA(): dim x dim x nq x ne.
+      Vector Jpt;
+      // Quadrature point work vectors and the ones vector of size nq x ne.
+      mutable Vector dx, xq, qy, E, O;
+   } PA;
+
+   // Compute the quadrature point data of the PA kernels, see tmop_pa.cpp.
+   void PAQuadratureApply(const Vector &x, Vector &y, int mode) const;
+   void PALimitingApply(const Vector &x, Vector &y, bool grad) const;
+
    void ComputeNormalizationEnergies(const GridFunction &x,
                                      double &metric_energy, double &lim_energy);
 
@@ -1023,7 +1047,7 @@ public:
         zeta_0(NULL), zeta(NULL), coeff_zeta(NULL), adapt_eval(NULL),
         discr_tc(dynamic_cast<DiscreteAdaptTC *>(tc)),
         fdflag(false), dxscale(1.0e3), fd_call_flag(false), exact_action(false)
-   { }
+   { PA.fes = NULL; PA.ne = 0; }
 
    ~TMOP_Integrator();
 
@@ -1100,6 +1124,21 @@ public:
                                     ElementTransformation &T,
                                     const Vector &elfun, DenseMatrix &elmat);
 
+   using NonlinearFormIntegrator::AssemblePA;
+   /** @brief Partial assembly of the integrator on tensor-product elements.
+
+       Supported are the metrics 1, 2, 7, 77 (2D), 1, 302, 303, 321 (3D), the
+       base TargetConstructor types, constant coefficients and, optionally,
+       limiting with TMOP_QuadraticLimiter. The targets and the limiting data
+       are computed here, and need to be recomputed, by calling this method
+       again, when the target nodes or the limiting nodes change. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+   virtual void AssembleGradPA(const Vector &x, const FiniteElementSpace &fes);
+   virtual void AddMultGradPA(const Vector &x, Vector &y) const;
+   virtual void AssembleGradDiagonalPA(Vector &diag) const;
+   virtual double GetLocalStateEnergyPA(const Vector &x) const;
+
    DiscreteAdaptTC *GetDiscreteAdaptTC() const { return discr_tc; }
 
    /** @brief Computes the normalization factors of the metric and limiting
@@ -0,0 +1,982 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "../general/forall.hpp"
+#include "../linalg/kernels.hpp"
+#include "tmop.hpp"
+#include "gridfunc.hpp"
+#include "quadinterpolator.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// Defined in nonlininteg_hyperelastic.cpp
+void PAHyperelasticGradT(const int dim, const int NE, const DofToQuad &maps,
+                         const Vector &x, Vector &y);
+
+// PA TMOP quadrature point functions. All matrices are DIM x DIM and stored in
+// column-major order. The metrics are written in terms of J, M = J^{-t},
+// det(J), I1 = |J|^2 and |M|^2; their derivatives in the direction H use
+// d(det(J)) = det(J) M:H and dM = -M H^t M.
+namespace tmop
+{
+
+template<int DIM> MFEM_HOST_DEVICE inline
+double Ddot(const double *A, const double *B)
+{
+   double s = 0.0;
+   for (int i = 0; i < DIM*DIM; i++) { s += A[i]*B[i]; }
+   return s;
+}
+
+/// M = J^{-t}, returns det(J)
+template<int DIM> MFEM_HOST_DEVICE inline
+double InverseTranspose(const double *J, double *M)
+{
+   double Jinv[DIM*DIM];
+   const double detJ = kernels::Det<DIM>(J);
+   kernels::CalcInverse<DIM>(J, Jinv);
+   for (int i = 0; i < DIM; i++)
+   {
+      for (int j = 0; j < DIM; j++) { M[i+DIM*j] = Jinv[j+DIM*i]; }
+   }
+   return detJ;
+}
+
+/// dM = -M H^t M
+template<int DIM> MFEM_HOST_DEVICE inline
+void dInverseTranspose(const double *M, const double *H, double *dM)
+{
+   double T[DIM*DIM];
+   kernels::MultABt(DIM, DIM, DIM, M, H, T);
+   kernels::Mult(DIM, DIM, DIM, T, M, dM);
+   for (int i = 0; i < DIM*DIM; i++) { dM[i] = -dM[i]; }
+}
+
+/// C = M M^t M
+template<int DIM> MFEM_HOST_DEVICE inline
+void MMtM(const double *M, double *C)
+{
+   double T[DIM*DIM];
+   kernels::MultABt(DIM, DIM, DIM, M, M, T);
+   kernels::Mult(DIM, DIM, DIM, T, M, C);
+}
+
+/// C = d(M M^t M) = dM M^t M + M dM^t M + M M^t dM
+template<int DIM> MFEM_HOST_DEVICE inline
+void dMMtM(const double *M, const double *dM, double *C)
+{
+   double T[DIM*DIM], A[DIM*DIM];
+   kernels::MultABt(DIM, DIM, DIM, dM, M, T);
+   kernels::Mult(DIM, DIM, DIM, T, M, C);
+   kernels::MultABt(DIM, DIM, DIM, M, dM, T);
+   kernels::Mult(DIM, DIM, DIM, T, M, A);
+   for (int i = 0; i < DIM*DIM; i++) { C[i] += A[i]; }
+   kernels::MultABt(DIM, DIM, DIM, M, M, T);
+   kernels::Mult(DIM, DIM, DIM, T, dM, A);
+   for (int i = 0; i < DIM*DIM; i++) { C[i] += A[i]; }
+}
+
+/// Value of the metric W(J).
+template<int DIM> MFEM_HOST_DEVICE inline
+double EvalW(const int metric, const double *J)
+{
+   double M[DIM*DIM];
+   const double dJ = InverseTranspose<DIM>(J, M);
+   const double I1 = Ddot<DIM>(J, J);
+   const double MM = Ddot<DIM>(M, M);
+   switch (metric)
+   {
+      case 1: return I1;
+      case 2: return 0.5*I1/dJ - 1.0;
+      case 7: return I1 + MM - 4.0;
+      case 77: return 0.5*(dJ*dJ + 1.0/(dJ*dJ) - 2.0);
+      case 302: return I1*MM/9.0 - 1.0;
+      case 303: return I1*pow(dJ, -2.0/3.0)/3.0 - 1.0;
+      case 321: return I1 + MM - 6.0;
+   }
+   return 0.0;
+}
+
+/// First derivative of the metric, P = dW/dJ.
+template<int DIM> MFEM_HOST_DEVICE inline
+void EvalP(const int metric, const double *J, double *P)
+{
+   double M[DIM*DIM], C[DIM*DIM];
+   const double dJ = InverseTranspose<DIM>(J, M);
+   const double I1 = Ddot<DIM>(J, J);
+   const double MM = Ddot<DIM>(M, M);
+   if (metric == 7 || metric == 302 || metric == 321) { MMtM<DIM>(M, C); }
+   for (int i = 0; i < DIM*DIM; i++)
+   {
+      switch (metric)
+      {
+         case 1: P[i] = 2.0*J[i]; break;
+         case 2: P[i] = (J[i] - 0.5*I1*M[i])/dJ; break;
+         case 7:
+         case 321: P[i] = 2.0*J[i] - 2.0*C[i]; break;
+         case 77: P[i] = (dJ*dJ - 1.0/(dJ*dJ))*M[i]; break;
+         case 302: P[i] = (2.0*MM*J[i] - 2.0*I1*C[i])/9.0; break;
+         case 303:
+            P[i] = 2.0/3.0*pow(dJ, -2.0/3.0)*(J[i] - I1/3.0*M[i]);
+            break;
+      }
+   }
+}
+
+/// Directional derivative dP of EvalP() at J in the direction H.
+template<int DIM> MFEM_HOST_DEVICE inline
+void EvaldP(const int metric, const double *J, const double *H, double *dP)
+{
+   double M[DIM*DIM], dM[DIM*DIM], C[DIM*DIM], dC[DIM*DIM];
+   const double dJ = InverseTranspose<DIM>(J, M);
+   dInverseTranspose<DIM>(M, H, dM);
+   const double I1 = Ddot<DIM>(J, J);
+   const double MM = Ddot<DIM>(M, M);
+   const double JH = Ddot<DIM>(J, H);
+   const double MH = Ddot<DIM>(M, H); // d(det(J))/det(J)
+   const double MdM = Ddot<DIM>(M, dM);
+   if (metric == 7 || metric == 302 || metric == 321)
+   {
+      MMtM<DIM>(M, C);
+      dMMtM<DIM>(M, dM, dC);
+   }
+   const double d2 = dJ*dJ, id2 = 1.0/d2;
+   const double a303 = 2.0/3.0*pow(dJ, -2.0/3.0);
+   for (int i = 0; i < DIM*DIM; i++)
+   {
+      switch (metric)
+      {
+         case 1: dP[i] = 2.0*H[i]; break;
+         case 2:
+            dP[i] = (H[i] - MH*J[i] - JH*M[i] +
+                     0.5*I1*(MH*M[i] - dM[i]))/dJ;
+            break;
+         case 7:
+         case 321: dP[i] = 2.0*H[i] - 2.0*dC[i]; break;
+         case 77:
+            dP[i] = 2.0*(d2 + id2)*MH*M[i] + (d2 - id2)*dM[i];
+            break;
+         case 302:
+            dP[i] = (4.0*MdM*J[i] + 2.0*MM*H[i] -
+                     4.0*JH*C[i] - 2.0*I1*dC[i])/9.0;
+            break;
+         case 303:
+            dP[i] = -2.0/3.0*a303*MH*(J[i] - I1/3.0*M[i]) +
+                    a303*(H[i] - 2.0/3.0*JH*M[i] - I1/3.0*dM[i]);
+            break;
+      }
+   }
+}
+
+} // namespace tmop
+
+// Value of a ConstantCoefficient; the constant can change after AssemblePA(),
+// e.g. when the limiting term is switched off.
+static double PAConstant(const Coefficient *c, const double def)
+{
+   return c ? static_cast<const ConstantCoefficient*>(c)->constant : def;
+}
+
+void TMOP_Integrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int dim = PA.dim = mesh->Dimension();
+   const int NE = PA.ne = fes.GetNE();
+   PA.fes = &fes;
+   if (NE == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule &ir = EnergyIntegrationRule(el);
+   const int NQ = PA.nq = ir.GetNPoints();
+   PA.ir = &ir;
+   MFEM_VERIFY(dim == 2 || dim == 3, "PA only supports dim = 2 and 3!");
+   MFEM_VERIFY(fes.GetVDim() == dim, "the vector dimension of the space must"
+               " be equal to the dimension of the mesh!");
+   MFEM_VERIFY(dynamic_cast<const TensorBasisElement*>(&el),
+               "PA only supports tensor-product elements!");
+   MFEM_VERIFY(!fdflag && !exact_action && !zeta, "PA does not support"
+               " finite differences, exact action and adaptive limiting!");
+   MFEM_VERIFY(!discr_tc && !dynamic_cast<const AnalyticAdaptTC*>(targetC),
+               "PA only supports the base TargetConstructor!");
+   PA.maps = &el.GetDofToQuad(ir, DofToQuad::TENSOR);
+
+   PA.metric = 0;
+   if (dynamic_cast<TMOP_Metric_001*>(metric)) { PA.metric = 1; }
+   if (dim == 2)
+   {
+      if (dynamic_cast<TMOP_Metric_002*>(metric)) { PA.metric = 2; }
+      if (dynamic_cast<TMOP_Metric_007*>(metric)) { PA.metric = 7; }
+      if (dynamic_cast<TMOP_Metric_077*>(metric)) { PA.metric = 77; }
+   }
+   if (dim == 3)
+   {
+      if (dynamic_cast<TMOP_Metric_302*>(metric)) { PA.metric = 302; }
+      if (dynamic_cast<TMOP_Metric_303*>(metric)) { PA.metric = 303; }
+      if (dynamic_cast<TMOP_Metric_321*>(metric)) { PA.metric = 321; }
+   }
+   MFEM_VERIFY(PA.metric > 0, "PA is not implemented for this metric in "
+               << dim << "D!");
+
+   MFEM_VERIFY(!coeff1 || dynamic_cast<ConstantCoefficient*>(coeff1),
+               "PA only supports a ConstantCoefficient coeff1!");
+
+   // Target data, computed on the host: Jrt = Jtr^{-1} and the quadrature
+   // weight times det(Jtr). The base TargetConstructor does not use elfun.
+   PA.Jrt.SetSize(dim * dim * NQ * NE, Device::GetMemoryType());
+   PA.W.SetSize(NQ * NE, Device::GetMemoryType());
+   auto Jrt = Reshape(PA.Jrt.HostWrite(), dim, dim, NQ, NE);
+   auto W = Reshape(PA.W.HostWrite(), NQ, NE);
+   DenseTensor Jtr(dim, dim, NQ);
+   DenseMatrix Jrt_q(dim);
+   Vector elfun;
+   for (int e = 0; e < NE; e++)
+   {
+      targetC->ComputeElementTargets(e, el, ir, elfun, Jtr);
+      for (int q = 0; q < NQ; q++)
+      {
+         CalcInverse(Jtr(q), Jrt_q);
+         W(q,e) = ir.IntPoint(q).weight * Jtr(q).Det();
+         for (int j = 0; j < dim; j++)
+         {
+            for (int i = 0; i < dim; i++) { Jrt(i,j,q,e) = Jrt_q(i,j); }
+         }
+      }
+   }
+
+   // Limiting data: x0 at the quadrature points and 1/d^2.
+   if (coeff0)
+   {
+      MFEM_VERIFY(dynamic_cast<ConstantCoefficient*>(coeff0),
+                  "PA only supports a ConstantCoefficient coeff0!");
+      MFEM_VERIFY(dynamic_cast<TMOP_QuadraticLimiter*>(lim_func),
+                  "PA only supports the TMOP_QuadraticLimiter!");
+
+      const FiniteElementSpace &n0_fes = *nodes0->FESpace();
+      MFEM_VERIFY(n0_fes.GetVDim() == dim, "invalid limiting nodes!");
+      const ElementDofOrdering ordering = ElementDofOrdering::LEXICOGRAPHIC;
+      const Operator *n0_R = n0_fes.GetElementRestriction(ordering);
+      Vector n0_e(n0_R->Height(), Device::GetMemoryType());
+      n0_R->Mult(*nodes0, n0_e);
+      const QuadratureInterpolator *qi = n0_fes.GetQuadratureInterpolator(ir);
+      qi->SetOutputLayout(QVectorLayout::byVDIM);
+      PA.X0.SetSize(dim * NQ * NE, Device::GetMemoryType());
+      qi->Values(n0_e, PA.X0);
+
+      PA.LD.SetSize(NQ * NE, Device::GetMemoryType());
+      auto LD = Reshape(PA.LD.HostWrite(), NQ, NE);
+      Vector d_vals;
+      for (int e = 0; e < NE; e++)
+      {
+         if (lim_dist) { lim_dist->GetValues(e, ir, d_vals); }
+         for (int q = 0; q < NQ; q++)
+         {
+            const double d = lim_dist ? d_vals(q) : 1.0;
+            LD(q,e) = 1.0 / (d * d);
+         }
+      }
+   }
+
+   PA.O.SetSize(NQ * NE, Device::GetMemoryType());
+   PA.O = 1.0;
+}
+
+// Modes of the PA TMOP quadrature point kernel.
+enum { TMOP_P = 0, TMOP_dP = 1, TMOP_STATE = 2 };
+
+// PA TMOP quadrature point kernel. The input X holds the reference gradients
+// Jpr of an E-vector. Depending on the mode, the output Y is
+// w P(Jpt) Jrt^t, w dP(Jpt_state)[Jpr Jrt] Jrt^t or the state Jpt = Jpr Jrt
+// itself, where w is the quadrature weight times det(Jtr) and the metric
+// normalization.
+template<int DIM>
+static void TMOPQuadApply(const int NE,
+                          const int NQ,
+                          const int metric,
+                          const int mode,
+                          const double mn,
+                          const Vector &jrt_,
+                          const Vector &w_,
+                          const Vector &s_,
+                          const Vector &x_,
+                          Vector &y_)
+{
+   const auto Jrt = Reshape(jrt_.Read(), DIM, DIM, NQ, NE);
+   const auto W = Reshape(w_.Read(), NQ, NE);
+   const auto S = Reshape(mode == TMOP_dP ? s_.Read() : nullptr,
+                          DIM, DIM, NQ, NE);
+   const auto X = Reshape(x_.Read(), DIM, DIM, NQ, NE);
+   auto Y = Reshape(y_.Write(), DIM, DIM, NQ, NE);
+   MFEM_FORALL(i, NE*NQ,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      double jrt[DIM*DIM], jpr[DIM*DIM], F[DIM*DIM], P[DIM*DIM];
+      for (int c = 0; c < DIM; c++)
+      {
+         for (int r = 0; r < DIM; r++)
+         {
+            jrt[r+DIM*c] = Jrt(r,c,q,e);
+            jpr[r+DIM*c] = X(r,c,q,e);
+         }
+      }
+      kernels::Mult(DIM, DIM, DIM, jpr, jrt, F);
+      if (mode == TMOP_STATE)
+      {
+         for (int c = 0; c < DIM; c++)
+         {
+            for (int r = 0; r < DIM; r++) { Y(r,c,q,e) = F[r+DIM*c]; }
+         }
+      }
+      else
+      {
+         if (mode == TMOP_P) { tmop::EvalP<DIM>(metric, F, P); }
+         else
+         {
+            double Jpt[DIM*DIM];
+            for (int c = 0; c < DIM; c++)
+            {
+               for (int r = 0; r < DIM; r++) { Jpt[r+DIM*c] = S(r,c,q,e); }
+            }
+            tmop::EvaldP<DIM>(metric, Jpt, F, P);
+         }
+         // Y = w P Jrt^t
+         kernels::MultABt(DIM, DIM, DIM, P, jrt, F);
+         const double w = mn * W(q,e);
+         for (int c = 0; c < DIM; c++)
+         {
+            for (int r = 0; r < DIM; r++) { Y(r,c,q,e) = w * F[r+DIM*c]; }
+         }
+      }
+   });
+}
+
+// PA TMOP energy kernel: the integrand of the metric and limiting terms at
+// each quadrature point, multiplied by the quadrature weight and det(Jtr).
+template<int DIM>
+static void TMOPEnergy(const int NE,
+                       const int NQ,
+                       const int metric,
+                       const double mn,
+                       const double ln,
+                       const Vector &jrt_,
+                       const Vector &w_,
+                       const Vector &ld_,
+                       const Vector &x0_,
+                       const Vector &x_,
+                       const Vector &xq_,
+                       Vector &energy)
+{
+   const bool lim = ln != 0.0;
+   const auto Jrt = Reshape(jrt_.Read(), DIM, DIM, NQ, NE);
+   const auto W = Reshape(w_.Read(), NQ, NE);
+   const auto LD = Reshape(lim ? ld_.Read() : nullptr, NQ, NE);
+   const auto X0 = Reshape(lim ? x0_.Read() : nullptr, DIM, NQ, NE);
+   const auto X = Reshape(x_.Read(), DIM, DIM, NQ, NE);
+   const auto XQ = Reshape(lim ? xq_.Read() : nullptr, DIM, NQ, NE);
+   auto E = Reshape(energy.Write(), NQ, NE);
+   MFEM_FORALL(i, NE*NQ,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      double jrt[DIM*DIM], jpr[DIM*DIM], Jpt[DIM*DIM];
+      for (int c = 0; c < DIM; c++)
+      {
+         for (int r = 0; r < DIM; r++)
+         {
+            jrt[r+DIM*c] = Jrt(r,c,q,e);
+            jpr[r+DIM*c] = X(r,c,q,e);
+         }
+      }
+      kernels::Mult(DIM, DIM, DIM, jpr, jrt, Jpt);
+      double val = mn * tmop::EvalW<DIM>(metric, Jpt);
+      if (lim)
+      {
+         double dist2 = 0.0;
+         for (int c = 0; c < DIM; c++)
+         {
+            const double dx = XQ(c,q,e) - X0(c,q,e);
+            dist2 += dx * dx;
+         }
+         val += ln * 0.5 * dist2 * LD(q,e);
+      }
+      E(q,e) = W(q,e) * val;
+   });
+}
+
+// PA TMOP limiting kernel: Y = w (x - x0) / d^2, or Y = w x / d^2 for the
+// gradient, where w is the quadrature weight times det(Jtr) and the limiting
+// normalization and coefficient.
+template<int DIM>
+static void TMOPLimitingQuadApply(const int NE,
+                                  const int NQ,
+                                  const bool grad,
+                                  const double ln,
+                                  const Vector &w_,
+                                  const Vector &ld_,
+                                  const Vector &x0_,
+                                  const Vector &x_,
+                                  Vector &y_)
+{
+   const auto W = Reshape(w_.Read(), NQ, NE);
+   const auto LD = Reshape(ld_.Read(), NQ, NE);
+   const auto X0 = Reshape(grad ? nullptr : x0_.Read(), DIM, NQ, NE);
+   const auto X = Reshape(x_.Read(), DIM, NQ, NE);
+   auto Y = Reshape(y_.Write(), DIM, NQ, NE);
+   MFEM_FORALL(i, NE*NQ,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      const double w = ln * W(q,e) * LD(q,e);
+      for (int c = 0; c < DIM; c++)
+      {
+         Y(c,q,e) = w * (grad ? X(c,q,e) : X(c,q,e) - X0(c,q,e));
+      }
+   });
+}
+
+// PA TMOP 2D kernel for the transpose of the interpolation at the quadrature
+// points: y(i,c) += sum_q phi_i x(c,q)
+template<int T_D1D = 0, int T_Q1D = 0>
+static void TMOPValuesT2D(const int NE,
+                          const Array<double> &b_,
+                          const Vector &x_,
+                          Vector &y_,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b_.Read(), Q1D, D1D);
+   auto x = Reshape(x_.Read(), 2, Q1D, Q1D, NE);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, 2, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      for (int c = 0; c < 2; ++c)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double valX[max_D1D];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               valX[dx] = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  valX[dx] += B(qx,dx) * x(c,qx,qy,e);
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double By = B(qy,dy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  y(dx,dy,c,e) += By * valX[dx];
+               }
+            }
+         }
+      }
+   });
+}
+
+// PA TMOP 3D kernel for the transpose of the interpolation.
+template<int T_D1D = 0, int T_Q1D = 0>
+static void TMOPValuesT3D(const int NE,
+                          const Array<double> &b_,
+                          const Vector &x_,
+                          Vector &y_,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b_.Read(), Q1D, D1D);
+   auto x = Reshape(x_.Read(), 3, Q1D, Q1D, Q1D, NE);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, 3, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      for (int c = 0; c < 3; ++c)
+      {
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            double valXY[max_D1D][max_D1D];
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx) { valXY[dy][dx] = 0.0; }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               double valX[max_D1D];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  valX[dx] = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     valX[dx] += B(qx,dx) * x(c,qx,qy,qz,e);
+                  }
+               }
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  const double By = B(qy,dy);
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     valXY[dy][dx] += By * valX[dx];
+                  }
+               }
+            }
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               const double Bz = B(qz,dz);
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     y(dx,dy,dz,c,e) += Bz * valXY[dy][dx];
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+static void TMOPValuesT(const int dim,
+                        const int NE,
+                        const DofToQuad &maps,
+                        const Vector &x,
+                        Vector &y)
+{
+   const int D1D = maps.ndof;
+   const int Q1D = maps.nqpt;
+   const int id = (D1D << 4 ) | Q1D;
+   const Array<double> &B = maps.B;
+   if (dim == 2)
+   {
+      switch (id)
+      {
+         case 0x23: return TMOPValuesT2D<2,3>(NE,B,x,y);
+         case 0x34: return TMOPValuesT2D<3,4>(NE,B,x,y);
+         case 0x45: return TMOPValuesT2D<4,5>(NE,B,x,y);
+         case 0x56: return TMOPValuesT2D<5,6>(NE,B,x,y);
+         default: return TMOPValuesT2D(NE,B,x,y,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch (id)
+      {
+         case 0x23: return TMOPValuesT3D<2,3>(NE,B,x,y);
+         case 0x34: return TMOPValuesT3D<3,4>(NE,B,x,y);
+         case 0x45: return TMOPValuesT3D<4,5>(NE,B,x,y);
+         case 0x56: return TMOPValuesT3D<5,6>(NE,B,x,y);
+         default: return TMOPValuesT3D(NE,B,x,y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA TMOP diagonal quadrature point kernel. For each component c, the
+// diagonal of the gradient w.r.t. the dofs (i,c) of the metric term is
+// sum_q sum_jk Q(j,k,c,q) dphi_i/dxi_j dphi_i/dxi_k, where Q = w Jrt A_c Jrt^t
+// and A_c(m,n) = dP[e_c e_n^t](c,m). The limiting term adds L(q) phi_i^2.
+template<int DIM>
+static void TMOPDiagonalQuadApply(const int NE,
+                                  const int NQ,
+                                  const int metric,
+                                  const double mn,
+                                  const double ln,
+                                  const Vector &jrt_,
+                                  const Vector &w_,
+                                  const Vector &ld_,
+                                  const Vector &s_,
+                                  Vector &q_,
+                                  Vector &l_)
+{
+   const bool lim = ln != 0.0;
+   const auto Jrt = Reshape(jrt_.Read(), DIM, DIM, NQ, NE);
+   const auto W = Reshape(w_.Read(), NQ, NE);
+   const auto LD = Reshape(lim ? ld_.Read() : nullptr, NQ, NE);
+   const auto S = Reshape(s_.Read(), DIM, DIM, NQ, NE);
+   auto Q = Reshape(q_.Write(), DIM, DIM, DIM, NQ, NE);
+   auto L = Reshape(l_.Write(), NQ, NE);
+   MFEM_FORALL(i, NE*NQ,
+   {
+      const int q = i % NQ;
+      const int e = i / NQ;
+      double jrt[DIM*DIM], Jpt[DIM*DIM], H[DIM*DIM], dP[DIM*DIM];
+      for (int c = 0; c < DIM; c++)
+      {
+         for (int r = 0; r < DIM; r++)
+         {
+            jrt[r+DIM*c] = Jrt(r,c,q,e);
+            Jpt[r+DIM*c] = S(r,c,q,e);
+         }
+      }
+      const double w = mn * W(q,e);
+      for (int c = 0; c < DIM; c++)
+      {
+         double A[DIM*DIM], T[DIM*DIM], QC[DIM*DIM];
+         for (int n = 0; n < DIM; n++)
+         {
+            for (int j = 0; j < DIM*DIM; j++) { H[j] = 0.0; }
+            H[c+DIM*n] = 1.0;
+            tmop::EvaldP<DIM>(metric, Jpt, H, dP);
+            for (int m = 0; m < DIM; m++) { A[m+DIM*n] = dP[c+DIM*m]; }
+         }
+         kernels::Mult(DIM, DIM, DIM, jrt, A, T);
+         kernels::MultABt(DIM, DIM, DIM, T, jrt, QC);
+         for (int k = 0; k < DIM; k++)
+         {
+            for (int j = 0; j < DIM; j++) { Q(j,k,c,q,e) = w * QC[j+DIM*k]; }
+         }
+      }
+      L(q,e) = lim ? ln * W(q,e) * LD(q,e) : 0.0;
+   });
+}
+
+// Returns B or G, depending on whether the reference derivative j is taken in
+// the direction dir; j = -1 means no derivative.
+#define TMOP_BG(dir,j,q,d) ((j) == (dir) ? G(q,d) : B(q,d))
+
+// PA TMOP 2D diagonal kernel: contraction of the output of
+// TMOPDiagonalQuadApply() with the squares of the 1D basis functions.
+template<int T_D1D = 0, int T_Q1D = 0>
+static void TMOPDiagonal2D(const int NE,
+                           const Array<double> &b_,
+                           const Array<double> &g_,
+                           const Vector &q_,
+                           const Vector &l_,
+                           Vector &y_,
+                           const int d1d = 0,
+                           const int q1d = 0)
+{
+   constexpr int DIM = 2, NJK = DIM*DIM + 1;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b_.Read(), Q1D, D1D);
+   auto G = Reshape(g_.Read(), Q1D, D1D);
+   auto Q = Reshape(q_.Read(), DIM, DIM, DIM, Q1D, Q1D, NE);
+   auto L = Reshape(l_.Read(), Q1D, Q1D, NE);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, DIM, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      for (int c = 0; c < DIM; ++c)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double valX[NJK][max_D1D];
+            for (int jk = 0; jk < NJK; ++jk)
+            {
+               const int j = jk < DIM*DIM ? jk % DIM : -1;
+               const int k = jk < DIM*DIM ? jk / DIM : -1;
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  valX[jk][dx] = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     const double qv = j < 0 ? L(qx,qy,e) : Q(j,k,c,qx,qy,e);
+                     valX[jk][dx] += qv * TMOP_BG(0,j,qx,dx) *
+                                     TMOP_BG(0,k,qx,dx);
+                  }
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double s = 0.0;
+                  for (int jk = 0; jk < NJK; ++jk)
+                  {
+                     const int j = jk < DIM*DIM ? jk % DIM : -1;
+                     const int k = jk < DIM*DIM ? jk / DIM : -1;
+                     s += valX[jk][dx] * TMOP_BG(1,j,qy,dy) *
+                          TMOP_BG(1,k,qy,dy);
+                  }
+                  y(dx,dy,c,e) += s;
+               }
+            }
+         }
+      }
+   });
+}
+
+// PA TMOP 3D diagonal kernel.
+template<int T_D1D = 0, int T_Q1D = 0>
+static void TMOPDiagonal3D(const int NE,
+                           const Array<double> &b_,
+                           const Array<double> &g_,
+                           const Vector &q_,
+                           const Vector &l_,
+                           Vector &y_,
+                           const int d1d = 0,
+                           const int q1d = 0)
+{
+   constexpr int DIM = 3, NJK = DIM*DIM + 1;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b_.Read(), Q1D, D1D);
+   auto G = Reshape(g_.Read(), Q1D, D1D);
+   auto Q = Reshape(q_.Read(), DIM, DIM, DIM, Q1D, Q1D, Q1D, NE);
+   auto L = Reshape(l_.Read(), Q1D, Q1D, Q1D, NE);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, DIM, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      for (int c = 0; c < DIM; ++c)
+      {
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            double valXY[NJK][max_D1D][max_D1D];
+            for (int jk = 0; jk < NJK; ++jk)
+            {
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx) { valXY[jk][dy][dx] = 0.0; }
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int jk = 0; jk < NJK; ++jk)
+               {
+                  const int j = jk < DIM*DIM ? jk % DIM : -1;
+                  const int k = jk < DIM*DIM ? jk / DIM : -1;
+                  double valX[max_D1D];
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     valX[dx] = 0.0;
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        const double qv = j < 0 ? L(qx,qy,qz,e) :
+                                          Q(j,k,c,qx,qy,qz,e);
+                        valX[dx] += qv * TMOP_BG(0,j,qx,dx) *
+                                    TMOP_BG(0,k,qx,dx);
+                     }
+                  }
+                  for (int dy = 0; dy < D1D; ++dy)
+                  {
+                     const double By = TMOP_BG(1,j,qy,dy) * TMOP_BG(1,k,qy,dy);
+                     for (int dx = 0; dx < D1D; ++dx)
+                     {
+                        valXY[jk][dy][dx] += By * valX[dx];
+                     }
+                  }
+               }
+            }
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     double s = 0.0;
+                     for (int jk = 0; jk < NJK; ++jk)
+                     {
+                        const int j = jk < DIM*DIM ? jk % DIM : -1;
+                        const int k = jk < DIM*DIM ? jk / DIM : -1;
+                        s += valXY[jk][dy][dx] * TMOP_BG(2,j,qz,dz) *
+                             TMOP_BG(2,k,qz,dz);
+                     }
+                     y(dx,dy,dz,c,e) += s;
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+#undef TMOP_BG
+
+static void TMOPDiagonal(const int dim,
+                         const int NE,
+                         const DofToQuad &maps,
+                         const Vector &q,
+                         const Vector &l,
+                         Vector &y)
+{
+   const int D1D = maps.ndof;
+   const int Q1D = maps.nqpt;
+   const int id = (D1D << 4 ) | Q1D;
+   const Array<double> &B = maps.B;
+   const Array<double> &G = maps.G;
+   if (dim == 2)
+   {
+      switch (id)
+      {
+         case 0x23: return TMOPDiagonal2D<2,3>(NE,B,G,q,l,y);
+         case 0x34: return TMOPDiagonal2D<3,4>(NE,B,G,q,l,y);
+         case 0x45: return TMOPDiagonal2D<4,5>(NE,B,G,q,l,y);
+         case 0x56: return TMOPDiagonal2D<5,6>(NE,B,G,q,l,y);
+         default: return TMOPDiagonal2D(NE,B,G,q,l,y,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch (id)
+      {
+         case 0x23: return TMOPDiagonal3D<2,3>(NE,B,G,q,l,y);
+         case 0x34: return TMOPDiagonal3D<3,4>(NE,B,G,q,l,y);
+         case 0x45: return TMOPDiagonal3D<4,5>(NE,B,G,q,l,y);
+         case 0x56: return TMOPDiagonal3D<5,6>(NE,B,G,q,l,y);
+         default: return TMOPDiagonal3D(NE,B,G,q,l,y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void TMOP_Integrator::PAQuadratureApply(const Vector &x, Vector &y,
+                                        int mode) const
+{
+   MFEM_VERIFY(PA.fes, "AssemblePA() has not been called!");
+   const QuadratureInterpolator *qi =
+      PA.fes->GetQuadratureInterpolator(*PA.ir);
+   qi->SetOutputLayout(QVectorLayout::byVDIM);
+   const int dim = PA.dim, NE = PA.ne, NQ = PA.nq;
+   PA.dx.SetSize(dim * dim * NQ * NE, Device::GetMemoryType());
+   qi->Derivatives(x, PA.dx);
+   const double mn = metric_normal * PAConstant(coeff1, 1.0);
+   if (dim == 2)
+   {
+      TMOPQuadApply<2>(NE, NQ, PA.metric, mode, mn, PA.Jrt, PA.W, PA.Jpt,
+                       PA.dx, y);
+   }
+   if (dim == 3)
+   {
+      TMOPQuadApply<3>(NE, NQ, PA.metric, mode, mn, PA.Jrt, PA.W, PA.Jpt,
+                       PA.dx, y);
+   }
+}
+
+void TMOP_Integrator::PALimitingApply(const Vector &x, Vector &y,
+                                      bool grad) const
+{
+   const QuadratureInterpolator *qi =
+      PA.fes->GetQuadratureInterpolator(*PA.ir);
+   qi->SetOutputLayout(QVectorLayout::byVDIM);
+   const int dim = PA.dim, NE = PA.ne, NQ = PA.nq;
+   PA.xq.SetSize(dim * NQ * NE, Device::GetMemoryType());
+   qi->Values(x, PA.xq);
+   PA.qy.SetSize(dim * NQ * NE, Device::GetMemoryType());
+   const double ln = lim_normal * PAConstant(coeff0, 0.0);
+   if (dim == 2)
+   {
+      TMOPLimitingQuadApply<2>(NE, NQ, grad, ln, PA.W, PA.LD, PA.X0, PA.xq,
+                               PA.qy);
+   }
+   if (dim == 3)
+   {
+      TMOPLimitingQuadApply<3>(NE, NQ, grad, ln, PA.W, PA.LD, PA.X0, PA.xq,
+                               PA.qy);
+   }
+   TMOPValuesT(dim, NE, *PA.maps, PA.qy, y);
+}
+
+void TMOP_Integrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (PA.ne == 0) { return; }
+   PA.qy.SetSize(PA.dim * PA.dim * PA.nq * PA.ne, Device::GetMemoryType());
+   PAQuadratureApply(x, PA.qy, TMOP_P);
+   PAHyperelasticGradT(PA.dim, PA.ne, *PA.maps, PA.qy, y);
+   if (coeff0) { PALimitingApply(x, y, false); }
+}
+
+void TMOP_Integrator::AssembleGradPA(const Vector &x,
+                                     const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(PA.fes == &fes, "AssemblePA() has not been called!");
+   if (PA.ne == 0) { return; }
+   PA.Jpt.SetSize(PA.dim * PA.dim * PA.nq * PA.ne, Device::GetMemoryType());
+   PAQuadratureApply(x, PA.Jpt, TMOP_STATE);
+}
+
+void TMOP_Integrator::AddMultGradPA(const Vector &x, Vector &y) const
+{
+   if (PA.ne == 0) { return; }
+   MFEM_VERIFY(PA.Jpt.Size() > 0, "AssembleGradPA() has not been called!");
+   PA.qy.SetSize(PA.dim * PA.dim * PA.nq * PA.ne, Device::GetMemoryType());
+   PAQuadratureApply(x, PA.qy, TMOP_dP);
+   PAHyperelasticGradT(PA.dim, PA.ne, *PA.maps, PA.qy, y);
+   if (coeff0) { PALimitingApply(x, y, true); }
+}
+
+void TMOP_Integrator::AssembleGradDiagonalPA(Vector &diag) const
+{
+   if (PA.ne == 0) { return; }
+   MFEM_VERIFY(PA.Jpt.Size() > 0, "AssembleGradPA() has not been called!");
+   const int dim = PA.dim, NE = PA.ne, NQ = PA.nq;
+   const double mn = metric_normal * PAConstant(coeff1, 1.0);
+   const double ln = lim_normal * PAConstant(coeff0, 0.0);
+   PA.qy.SetSize(dim * dim * dim * NQ * NE, Device::GetMemoryType());
+   PA.E.SetSize(NQ * NE, Device::GetMemoryType());
+   if (dim == 2)
+   {
+      TMOPDiagonalQuadApply<2>(NE, NQ, PA.metric, mn, ln, PA.Jrt, PA.W, PA.LD,
+                               PA.Jpt, PA.qy, PA.E);
+   }
+   if (dim == 3)
+   {
+      TMOPDiagonalQuadApply<3>(NE, NQ, PA.metric, mn, ln, PA.Jrt, PA.W, PA.LD,
+                               PA.Jpt, PA.qy, PA.E);
+   }
+   TMOPDiagonal(dim, NE, *PA.maps, PA.qy, PA.E, diag);
+}
+
+double TMOP_Integrator::GetLocalStateEnergyPA(const Vector &x) const
+{
+   if (PA.ne == 0) { return 0.0; }
+   MFEM_VERIFY(PA.fes, "AssemblePA() has not been called!");
+   const QuadratureInterpolator *qi =
+      PA.fes->GetQuadratureInterpolator(*PA.ir);
+   qi->SetOutputLayout(QVectorLayout::byVDIM);
+   const int dim = PA.dim, NE = PA.ne, NQ = PA.nq;
+   PA.dx.SetSize(dim * dim * NQ * NE, Device::GetMemoryType());
+   qi->Derivatives(x, PA.dx);
+   if (coeff0)
+   {
+      PA.xq.SetSize(dim * NQ * NE, Device::GetMemoryType());
+      qi->Values(x, PA.xq);
+   }
+   const double mn = metric_normal * PAConstant(coeff1, 1.0);
+   const double ln = lim_normal * PAConstant(coeff0, 0.0);
+   PA.E.SetSize(NQ * NE, Device::GetMemoryType());
+   if (dim == 2)
+   {
+      TMOPEnergy<2>(NE, NQ, PA.metric, mn, ln, PA.Jrt, PA.W, PA.LD, PA.X0,
+                    PA.dx, PA.xq, PA.E);
+   }
+   if (dim == 3)
+   {
+      TMOPEnergy<3>(NE, NQ, PA.metric, mn, ln, PA.Jrt, PA.W, PA.LD, PA.X0,
+                    PA.dx, PA.xq, PA.E);
+   }
+   return PA.E * PA.O;
+}
+
+} // namespace mfem
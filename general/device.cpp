@@ -45,7 +45,8 @@ static const Backend::Id backend_list[Backend::NUM_BACKENDS] =
    Backend::CEED_CUDA, Backend::OCCA_CUDA, Backend::RAJA_CUDA, Backend::CUDA,
    Backend::CEED_HIP, Backend::HIP, Backend::DEBUG_DEVICE,
    Backend::OCCA_OMP, Backend::RAJA_OMP, Backend::OMP,
-   Backend::CEED_CPU, Backend::OCCA_CPU, Backend::RAJA_CPU, Backend::CPU
+   Backend::CEED_CPU, Backend::OCCA_CPU, Backend::RAJA_CPU, Backend::CPU_SIMD,
+   Backend::CPU
 };
 
 // Backend names listed by priority, high to low:
@@ -54,7 +55,7 @@ static const char *backend_name[Backend::NUM_BACKENDS] =
    "ceed-cuda", "occa-cuda", "raja-cuda", "cuda",
    "ceed-hip", "hip", "debug",
    "occa-omp", "raja-omp", "omp",
-   "ceed-cpu", "occa-cpu", "raja-cpu", "cpu"
+   "ceed-cpu", "occa-cpu", "raja-cpu", "cpu-simd", "cpu"
 };
 
 } // namespace mfem::internal
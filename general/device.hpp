@@ -69,7 +69,13 @@ struct Backend
           (using separate host/device memory pools and host <-> device
           transfers) without any GPU hardware. As 'DEBUG' is sometimes used
           as a macro, `_DEVICE` has been added to avoid conflicts. */
-      DEBUG_DEVICE = 1 << 13
+      DEBUG_DEVICE = 1 << 13,
+      /** @brief [host] SIMD CPU backend: sequential execution on each MPI rank,
+          with the partial assembly kernels of the mass, diffusion and
+          convection integrators batching elements into the lanes of AutoSIMD
+          vectors. All other kernels use the default CPU backend. The SIMD
+          width is set by MFEM_USE_SIMD and the compiler flags. */
+      CPU_SIMD = 1 << 14
    };
 
    /** @brief Additional useful constants. For example, the *_MASK constants can
@@ -77,10 +83,10 @@ struct Backend
    enum
    {
       /// Number of backends: from (1 << 0) to (1 << (NUM_BACKENDS-1)).
-      NUM_BACKENDS = 14,
+      NUM_BACKENDS = 15,
 
       /// Biwise-OR of all CPU backends
-      CPU_MASK = CPU | RAJA_CPU | OCCA_CPU | CEED_CPU,
+      CPU_MASK = CPU | RAJA_CPU | OCCA_CPU | CEED_CPU | CPU_SIMD,
       /// Biwise-OR of all CUDA backends
       CUDA_MASK = CUDA | RAJA_CUDA | OCCA_CUDA | CEED_CUDA,
       /// Biwise-OR of all HIP backends
@@ -204,13 +210,16 @@ public:
          'ceed-cuda', 'occa-cuda', 'raja-cuda', 'cuda',
          'ceed-hip', 'hip', 'debug',
          'occa-omp', 'raja-omp', 'omp',
-         'ceed-cpu', 'occa-cpu', 'raja-cpu', 'cpu'.
+         'ceed-cpu', 'occa-cpu', 'raja-cpu', 'cpu-simd', 'cpu'.
        * Multiple backends can be configured at the same time.
        * Only one 'occa-*' backend can be configured at a time.
        * The backend 'occa-cuda' enables the 'cuda' backend unless 'raja-cuda'
          is already enabled.
        * The backend 'occa-omp' enables the 'omp' backend (if MFEM was built
          with MFEM_USE_OPENMP=YES) unless 'raja-omp' is already enabled.
+       * The backend 'cpu-simd' replaces some of the 'cpu' partial assembly
+         kernels with versions processing several elements per SIMD
+         instruction; it is ignored when a device or OpenMP backend is used.
        * Only one 'ceed-*' backend can be configured at a time.
        * The backend 'ceed-cpu' delegates to a libCEED CPU backend the setup and
          evaluation of the operator.
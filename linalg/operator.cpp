@@ -357,6 +357,12 @@ RAPOperator::RAPOperator(const Operator &Rt_, const Operator &A_,
    APx.SetSize(A.Height(), mem_type);
 }
 
+void RAPOperator::AssembleDiagonal(Vector &diag) const
+{
+   A.AssembleDiagonal(APx);
+   Rt.MultTranspose(APx, diag);
+}
+
 
 TripleProductOperator::TripleProductOperator(
    const Operator *A, const Operator *B, const Operator *C,
@@ -492,6 +498,32 @@ void ConstrainedOperator::Mult(const Vector &x, Vector &y) const
    }
 }
 
+void ConstrainedOperator::AssembleDiagonal(Vector &diag) const
+{
+   A->AssembleDiagonal(diag);
+
+   const int csz = constraint_list.Size();
+   if (csz == 0) { return; }
+
+   auto idx = constraint_list.Read();
+   // Use read+write access - we are modifying sub-vector of diag
+   auto d_diag = diag.ReadWrite();
+   switch (diag_policy)
+   {
+      case DIAG_ONE:
+         MFEM_FORALL(i, csz, d_diag[idx[i]] = 1.0;);
+         break;
+      case DIAG_ZERO:
+         MFEM_FORALL(i, csz, d_diag[idx[i]] = 0.0;);
+         break;
+      case DIAG_KEEP:
+         break;
+      default:
+         mfem_error("ConstrainedOperator::AssembleDiagonal");
+         break;
+   }
+}
+
 RectangularConstrainedOperator::RectangularConstrainedOperator(
    Operator *A,
    const Array<int> &trial_list,
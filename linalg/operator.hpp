@@ -92,6 +92,13 @@ public:
    virtual void MultTranspose(const Vector &x, Vector &y) const
    { mfem_error("Operator::MultTranspose() is not overloaded!"); }
 
+   /** @brief Computes the diagonal entries into @a diag. Typically, this
+       operation only makes sense for linear Operator%s. In some cases, only an
+       approximation of the diagonal is computed. The default behavior in class
+       Operator is to generate an error. */
+   virtual void AssembleDiagonal(Vector &diag) const
+   { mfem_error("Operator::AssembleDiagonal() is not overloaded!"); }
+
    /** @brief Evaluate the gradient operator at the point @a x. The default
        behavior in class Operator is to generate an error. */
    virtual Operator &GetGradient(const Vector &x) const
@@ -761,6 +768,11 @@ public:
    /// Application of the transpose.
    virtual void MultTranspose(const Vector & x, Vector & y) const
    { Rt.Mult(x, APx); A.MultTranspose(APx, Px); P.MultTranspose(Px, y); }
+
+   /** @brief Approximate diagonal of the RAP Operator, computed as
+       R diag(A). This is exact when P and R^T are the same boolean matrix,
+       e.g. for conforming spaces. */
+   virtual void AssembleDiagonal(Vector &diag) const;
 };
 
 
@@ -846,6 +858,10 @@ public:
        the vectors, and "_i" -- the rest of the entries. */
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /** @brief Diagonal of the constrained operator. The entries corresponding
+       to essential dofs are set according to the DiagonalPolicy. */
+   virtual void AssembleDiagonal(Vector &diag) const;
+
    /// Destructor: destroys the unconstrained Operator, if owned.
    virtual ~ConstrainedOperator() { if (own_A) { delete A; } }
 };
@@ -34,6 +34,7 @@ IterativeSolver::IterativeSolver()
    rel_tol = abs_tol = 0.0;
 #ifdef MFEM_USE_MPI
    dot_prod_type = 0;
+   sums_request = MPI_REQUEST_NULL;
 #endif
 }
 
@@ -48,6 +49,7 @@ IterativeSolver::IterativeSolver(MPI_Comm _comm)
    rel_tol = abs_tol = 0.0;
    dot_prod_type = 1;
    comm = _comm;
+   sums_request = MPI_REQUEST_NULL;
 }
 #endif
 
@@ -67,6 +69,34 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::StartGlobalSums(double *sums, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+#if MPI_VERSION >= 3
+      MPI_Iallreduce(MPI_IN_PLACE, sums, n, MPI_DOUBLE, MPI_SUM, comm,
+                     &sums_request);
+#else
+      MPI_Allreduce(MPI_IN_PLACE, sums, n, MPI_DOUBLE, MPI_SUM, comm);
+#endif
+   }
+#else
+   MFEM_CONTRACT_VAR(sums);
+   MFEM_CONTRACT_VAR(n);
+#endif
+}
+
+void IterativeSolver::FinishGlobalSums() const
+{
+#ifdef MFEM_USE_MPI
+   if (sums_request != MPI_REQUEST_NULL)
+   {
+      MPI_Wait(&sums_request, MPI_STATUS_IGNORE);
+   }
+#endif
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -123,8 +153,9 @@ OperatorJacobiSmoother::OperatorJacobiSmoother(const BilinearForm &a,
    N(height),
    dinv(N),
    damping(dmpng),
-   ess_tdof_list(ess_tdofs),
-   residual(N)
+   ess_tdof_list(&ess_tdofs),
+   residual(N),
+   assemble_diag(false)
 {
    Vector diag(N);
    a.AssembleDiagonal(diag);
@@ -140,12 +171,39 @@ OperatorJacobiSmoother::OperatorJacobiSmoother(const Vector &d,
    N(d.Size()),
    dinv(N),
    damping(dmpng),
-   ess_tdof_list(ess_tdofs),
-   residual(N)
+   ess_tdof_list(&ess_tdofs),
+   residual(N),
+   assemble_diag(false)
 {
    Setup(d);
 }
 
+OperatorJacobiSmoother::OperatorJacobiSmoother(const double dmpng)
+   :
+   Solver(0),
+   N(0),
+   damping(dmpng),
+   ess_tdof_list(NULL),
+   assemble_diag(true)
+{
+   oper = NULL;
+}
+
+void OperatorJacobiSmoother::SetOperator(const Operator &op)
+{
+   oper = &op;
+   if (!assemble_diag) { return; }
+
+   height = width = N = op.Height();
+   MFEM_VERIFY(op.Width() == N, "the Operator must be square!");
+   dinv.SetSize(N);
+   residual.SetSize(N);
+   Vector diag(N);
+   diag.UseDevice(true);
+   op.AssembleDiagonal(diag);
+   Setup(diag);
+}
+
 void OperatorJacobiSmoother::Setup(const Vector &diag)
 {
    residual.UseDevice(true);
@@ -153,8 +211,11 @@ void OperatorJacobiSmoother::Setup(const Vector &diag)
    auto D = diag.Read();
    auto DI = dinv.Write();
    MFEM_FORALL(i, N, DI[i] = delta / D[i]; );
-   auto I = ess_tdof_list.Read();
-   MFEM_FORALL(i, ess_tdof_list.Size(), DI[I[i]] = delta; );
+   if (ess_tdof_list)
+   {
+      auto I = ess_tdof_list->Read();
+      MFEM_FORALL(i, ess_tdof_list->Size(), DI[I[i]] = delta; );
+   }
 }
 
 void OperatorJacobiSmoother::Mult(const Vector &x, Vector &y) const
@@ -231,6 +292,26 @@ OperatorChebyshevSmoother::OperatorChebyshevSmoother(Operator* oper_,
    Setup();
 }
 
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(
+   Operator* oper_, const Vector &d, const Array<int>& ess_tdofs, int order_,
+   SpectralBoundsEstimator &estimator)
+   : Solver(d.Size()),
+     order(order_),
+     N(d.Size()),
+     dinv(N),
+     diag(d),
+     coeffs(order),
+     ess_tdof_list(ess_tdofs),
+     residual(N),
+     oper(oper_)
+{
+   double min_eig_estimate;
+   estimator.Estimate(*oper, diag, ess_tdofs, min_eig_estimate,
+                      max_eig_estimate);
+
+   Setup();
+}
+
 void OperatorChebyshevSmoother::Setup()
 {
    // Invert diagonal
@@ -348,6 +429,147 @@ void OperatorChebyshevSmoother::Mult(const Vector& x, Vector &y) const
    }
 }
 
+SpectralBoundsEstimator::SpectralBoundsEstimator()
+   : max_iter(10)
+{
+#ifdef MFEM_USE_MPI
+   comm = MPI_COMM_NULL;
+#endif
+}
+
+#ifdef MFEM_USE_MPI
+SpectralBoundsEstimator::SpectralBoundsEstimator(MPI_Comm comm_)
+   : max_iter(10), comm(comm_) { }
+#endif
+
+double SpectralBoundsEstimator::Dot(const Vector &x, const Vector &y) const
+{
+#ifdef MFEM_USE_MPI
+   if (comm != MPI_COMM_NULL)
+   {
+      return InnerProduct(comm, x, y);
+   }
+#endif
+   return InnerProduct(x, y);
+}
+
+// Return the k-th smallest eigenvalue of the symmetric tridiagonal matrix
+// with diagonal a and off-diagonal b, using bisection with Sturm sequences.
+static double TridiagonalEigenvalue(const Array<double> &a,
+                                    const Array<double> &b, int k)
+{
+   const int m = a.Size();
+   double lo = a[0], hi = a[0];
+   for (int i = 0; i < m; i++)
+   {
+      const double rad = ((i > 0) ? std::abs(b[i-1]) : 0.0) +
+                         ((i < m-1) ? std::abs(b[i]) : 0.0);
+      lo = std::min(lo, a[i] - rad);
+      hi = std::max(hi, a[i] + rad);
+   }
+   const double tol = 1e-14*std::max(std::abs(lo), std::abs(hi));
+   while (hi - lo > tol)
+   {
+      const double mid = 0.5*(lo + hi);
+      if (mid == lo || mid == hi) { break; }
+      // Number of eigenvalues smaller than mid
+      int count = 0;
+      double p = 1.0;
+      for (int i = 0; i < m; i++)
+      {
+         p = a[i] - mid - ((i > 0) ? b[i-1]*b[i-1]/p : 0.0);
+         if (p == 0.0) { p = 1e-300; }
+         if (p < 0.0) { count++; }
+      }
+      if (count > k) { hi = mid; }
+      else { lo = mid; }
+   }
+   return 0.5*(lo + hi);
+}
+
+void SpectralBoundsEstimator::Estimate(const Operator &A, const Solver &B,
+                                       double &lambda_min, double &lambda_max)
+{
+   const int n = A.Height();
+   r.SetSize(n); z.SetSize(n); d.SetSize(n); q.SetSize(n);
+   r.UseDevice(true); z.UseDevice(true); d.UseDevice(true); q.UseDevice(true);
+
+   // Deterministic pseudo-random right-hand side, generated on the device
+   auto R = r.Write();
+   MFEM_FORALL(i, n,
+   {
+      unsigned int h = 2654435761u*(unsigned int)(i + 1);
+      h ^= h >> 16;
+      h *= 0x45d9f3bu;
+      h ^= h >> 16;
+      R[i] = h/4294967296.0;
+   });
+
+   // Preconditioned CG with zero initial guess. The Lanczos matrix is
+   // tridiagonal with entries given by the CG coefficients alpha and beta.
+   Array<double> diag, offd;
+   B.Mult(r, z);
+   d = z;
+   double nom = Dot(r, z);
+   const double nom0 = nom;
+   double alpha_old = 0.0, beta_old = 0.0;
+   for (int k = 0; k < max_iter && nom > 1e-24*nom0; k++)
+   {
+      A.Mult(d, q);
+      const double den = Dot(d, q);
+      if (den <= 0.0) { break; }
+      const double alpha = nom/den;
+      if (k > 0)
+      {
+         diag.Append(1.0/alpha + beta_old/alpha_old);
+         offd.Append(sqrt(beta_old)/alpha_old);
+      }
+      else
+      {
+         diag.Append(1.0/alpha);
+      }
+      add(r, -alpha, q, r);
+      B.Mult(r, z);
+      const double betanom = Dot(r, z);
+      if (betanom < 0.0) { break; }
+      const double beta = betanom/nom;
+      add(z, beta, d, d);
+      alpha_old = alpha;
+      beta_old = beta;
+      nom = betanom;
+   }
+   MFEM_VERIFY(diag.Size() > 0, "the preconditioned operator is not "
+               "positive definite");
+
+   lambda_min = TridiagonalEigenvalue(diag, offd, 0);
+   lambda_max = TridiagonalEigenvalue(diag, offd, diag.Size() - 1);
+}
+
+void SpectralBoundsEstimator::Estimate(const Operator &A, const Vector &diag,
+                                       const Array<int> &ess_tdof_list,
+                                       double &lambda_min, double &lambda_max)
+{
+   const Key key(&A, &diag);
+   std::map<Key, std::pair<double, double> >::const_iterator it =
+      cache.find(key);
+   if (it != cache.end())
+   {
+      lambda_min = it->second.first;
+      lambda_max = it->second.second;
+      return;
+   }
+   OperatorJacobiSmoother jacobi(diag, ess_tdof_list, 1.0);
+   Estimate(A, jacobi, lambda_min, lambda_max);
+   cache[key] = std::make_pair(lambda_min, lambda_max);
+}
+
+void SpectralBoundsEstimator::Invalidate(const Operator &A)
+{
+   std::map<Key, std::pair<double, double> >::iterator it =
+      cache.lower_bound(Key(&A, NULL));
+   while (it != cache.end() && it->first.first == &A) { cache.erase(it++); }
+}
+
 void SLISolver::UpdateVectors()
 {
    r.SetSize(width);
@@ -744,6 +966,314 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
    pcg.Mult(b, x);
 }
 
+// Print the final report of the CG variants, in the format of CGSolver.
+static void PrintCGSummary(const char *name, int print_level, bool converged,
+                           int final_iter, double nom0, double nom)
+{
+   if (converged)
+   {
+      if (print_level == 2)
+      {
+         mfem::out << "Number of " << name << " iterations: " << final_iter
+                   << '\n';
+      }
+      else if (print_level == 3 && final_iter > 0)
+      {
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << nom << '\n';
+      }
+   }
+   else if (print_level >= 0)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << nom << '\n';
+      }
+      mfem::out << name << ": No convergence!" << '\n';
+   }
+   if (final_iter > 0 && (print_level >= 1 || (print_level >= 0 && !converged)))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (nom/nom0, 0.5/final_iter) << '\n';
+   }
+}
+
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   m.SetSize(width);
+   n.SetSize(width);
+   z.SetSize(width);
+   q.SetSize(width);
+   s.SetSize(width);
+   p.SetSize(width);
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Preconditioned pipelined CG, following Algorithm 3 in P. Ghysels and
+   // W. Vanroose, "Hiding global synchronization latency in the
+   // preconditioned Conjugate Gradient algorithm", Parallel Computing, 2014.
+   // The vectors satisfy u = B r, w = A u, s = A p, q = B s and z = A q.
+   double sums[2], gamma = 0.0, gamma0 = 0.0, gamma_old = 0.0, delta;
+   double alpha = 0.0, beta, den, r0 = 0.0;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (prec)
+   {
+      prec->Mult(r, u); // u = B r
+   }
+   else
+   {
+      u = r;
+   }
+   oper->Mult(u, w);    // w = A u
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      // Start the reduction of (B r, r) and (A u, u), and overlap it with the
+      // computation of m = B w and n = A m.
+      sums[0] = u * r;
+      sums[1] = w * u;
+      StartGlobalSums(sums, 2);
+      if (prec)
+      {
+         prec->Mult(w, m);
+      }
+      else
+      {
+         m = w;
+      }
+      oper->Mult(m, n);
+      FinishGlobalSums();
+      gamma = sums[0];
+      delta = sums[1];
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+      MFEM_ASSERT(IsFinite(delta), "delta = " << delta);
+
+      if (gamma < 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "PipelinedCG: The preconditioner is not positive "
+                      << "definite. (Br, r) = " << gamma << '\n';
+         }
+         final_iter = i;
+         break;
+      }
+      if (i == 0)
+      {
+         gamma0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && i == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << gamma << (print_level == 3 ? " ...\n" : "\n");
+      }
+      Monitor(i, gamma, r, x);
+
+      if (gamma <= r0)
+      {
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      beta = (i == 0) ? 0.0 : gamma/gamma_old;
+      den = (i == 0) ? delta : delta - beta*gamma/alpha; // den = (A p, p)
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "PipelinedCG: The operator is not positive definite."
+                      << " (Ap, p) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = gamma/den;
+
+      if (i == 0)
+      {
+         z = n;
+         q = m;
+         s = w;
+         p = u;
+      }
+      else
+      {
+         add(n, beta, z, z);    //  z = n + beta z
+         add(m, beta, q, q);    //  q = m + beta q
+         add(w, beta, s, s);    //  s = w + beta s
+         add(u, beta, p, p);    //  p = u + beta p
+      }
+      x.Add(alpha, p);
+      r.Add(-alpha, s);
+      u.Add(-alpha, q);
+      w.Add(-alpha, z);
+      gamma_old = gamma;
+   }
+   PrintCGSummary("PipelinedCG", print_level, converged, final_iter, gamma0,
+                  gamma);
+   final_norm = sqrt(gamma);
+
+   Monitor(final_iter, final_norm, r, x, true);
+}
+
+void SingleReductionCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   p.SetSize(width);
+   s.SetSize(width);
+}
+
+void SingleReductionCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Preconditioned CG of A. T. Chronopoulos and C. W. Gear, "s-step iterative
+   // methods for symmetric linear systems", J. Comput. Appl. Math., 1989, with
+   // s = 1. The vectors satisfy u = B r, w = A u and s = A p.
+   double sums[2], gamma = 0.0, gamma0 = 0.0, gamma_old = 0.0, delta;
+   double alpha = 0.0, beta, den, r0 = 0.0;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      if (prec)
+      {
+         prec->Mult(r, u); // u = B r
+      }
+      else
+      {
+         u = r;
+      }
+      oper->Mult(u, w);    // w = A u
+
+      // Reduce (B r, r) and (A u, u) together, and overlap the reduction with
+      // the update of the solution from the previous iteration.
+      sums[0] = u * r;
+      sums[1] = w * u;
+      StartGlobalSums(sums, 2);
+      if (i > 0)
+      {
+         x.Add(alpha, p);
+      }
+      FinishGlobalSums();
+      gamma = sums[0];
+      delta = sums[1];
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+      MFEM_ASSERT(IsFinite(delta), "delta = " << delta);
+
+      if (gamma < 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "SingleReductionCG: The preconditioner is not "
+                      << "positive definite. (Br, r) = " << gamma << '\n';
+         }
+         final_iter = i;
+         break;
+      }
+      if (i == 0)
+      {
+         gamma0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && i == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << gamma << (print_level == 3 ? " ...\n" : "\n");
+      }
+      Monitor(i, gamma, r, x);
+
+      if (gamma <= r0)
+      {
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      beta = (i == 0) ? 0.0 : gamma/gamma_old;
+      den = (i == 0) ? delta : delta - beta*gamma/alpha; // den = (A p, p)
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "SingleReductionCG: The operator is not positive "
+                      << "definite. (Ap, p) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = gamma/den;
+
+      if (i == 0)
+      {
+         p = u;
+         s = w;
+      }
+      else
+      {
+         add(u, beta, p, p);    //  p = u + beta p
+         add(w, beta, s, s);    //  s = w + beta s
+      }
+      r.Add(-alpha, s);
+      gamma_old = gamma;
+   }
+   PrintCGSummary("SingleReductionCG", print_level, converged, final_iter,
+                  gamma0, gamma);
+   final_norm = sqrt(gamma);
+
+   Monitor(final_iter, final_norm, r, x, true);
+}
+
 
 inline void GeneratePlaneRotation(double &dx, double &dy,
                                   double &cs, double &sn)
@@ -982,6 +1512,344 @@ finish:
    }
 }
 
+int SStepGMRESSolver::OrthogonalizeBlock(const Array<Vector *> &v, int nv,
+                                         Array<Vector *> &w, int nw,
+                                         DenseMatrix &C, DenseMatrix &R,
+                                         double tol) const
+{
+   // Fuse the inner products C = v^T w and G = w^T w in a single reduction.
+   Vector sums(nv*nw + nw*nw);
+   DenseMatrix G(sums.GetData() + nv*nw, nw, nw);
+   for (int l = 0; l < nw; l++)
+   {
+      for (int k = 0; k < nv; k++)
+      {
+         sums(k + l*nv) = (*v[k]) * (*w[l]);
+      }
+      for (int k = 0; k <= l; k++)
+      {
+         G(k,l) = (*w[k]) * (*w[l]);
+      }
+   }
+   StartGlobalSums(sums.GetData(), sums.Size());
+   FinishGlobalSums();
+   C.SetSize(nv, nw);
+   for (int l = 0; l < nw; l++)
+   {
+      for (int k = 0; k < nv; k++)
+      {
+         C(k,l) = sums(k + l*nv);
+      }
+   }
+
+   // w = w - v C
+   for (int l = 0; l < nw; l++)
+   {
+      for (int k = 0; k < nv; k++)
+      {
+         w[l]->Add(-C(k,l), *v[k]);
+      }
+   }
+
+   // Cholesky factorization R^T R = G - C^T C of the Gram matrix of the new w,
+   // and w = w R^{-1}.
+   R.SetSize(nw);
+   R = 0.0;
+   for (int l = 0; l < nw; l++)
+   {
+      for (int k = 0; k <= l; k++)
+      {
+         double g = G(k,l);
+         for (int j = 0; j < nv; j++)
+         {
+            g -= C(j,k) * C(j,l);
+         }
+         for (int j = 0; j < k; j++)
+         {
+            g -= R(j,k) * R(j,l);
+         }
+         if (k < l)
+         {
+            R(k,l) = g / R(k,k);
+         }
+         else if (g <= tol * G(l,l))
+         {
+            return l;
+         }
+         else
+         {
+            R(l,l) = sqrt(g);
+         }
+      }
+      for (int k = 0; k < l; k++)
+      {
+         w[l]->Add(-R(k,l), *w[k]);
+      }
+      *w[l] /= R(l,l);
+   }
+   return nw;
+}
+
+void SStepGMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   // The Arnoldi relation M A V_k = V_{k+1} H_k is built s columns at a time.
+   // The block W = [w_1, ..., w_s], with w_1 = M A v_i and w_l = M A w_{l-1},
+   // is factored as W = V C + V_new R, with V = [v_0, ..., v_i], and the new
+   // columns of H follow from M A [v_i, w_1, ..., w_{s-1}] = W.
+   MFEM_VERIFY(s_step > 0, "invalid step size: " << s_step);
+
+   const int n = width;
+
+   DenseMatrix H(m+1, m), HR(m+1, m); // Hessenberg matrix and its rotated form
+   DenseMatrix C, R, C2, R2;
+   Vector g(m+1), cs(m+1), sn(m+1), h(m+1);
+   Vector r(n), t(n);
+   Array<Vector *> v(m+1), w(s_step);
+   v = NULL;
+   w = NULL;
+
+   double resid;
+   int i, j, k, l;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, t);
+   }
+   else
+   {
+      x = 0.0;
+      t = b;
+   }
+   if (prec)
+   {
+      prec->Mult(t, r);    // r = M (b - A x)
+   }
+   else
+   {
+      r = t;
+   }
+   double beta = Norm(r);  // beta = ||r||
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   final_norm = std::max(rel_tol*beta, abs_tol);
+
+   if (beta <= final_norm)
+   {
+      final_norm = beta;
+      final_iter = 0;
+      converged = 1;
+      goto finish;
+   }
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << beta
+                << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   Monitor(0, beta, r, x);
+
+   for (j = 0; j < max_iter; )
+   {
+      if (v[0] == NULL) { v[0] = new Vector(n); }
+      v[0]->Set(1.0/beta, r);
+      g = 0.0; g(0) = beta;
+      H = 0.0;
+
+      for (i = 0; i < m && j < max_iter; )
+      {
+         // Compute the block with the monomial basis.
+         const int nw = std::min(s_step, std::min(m - i, max_iter - j));
+         for (l = 0; l < nw; l++)
+         {
+            if (w[l] == NULL) { w[l] = new Vector(n); }
+            const Vector &wp = (l == 0) ? *v[i] : *w[l-1];
+            if (prec)
+            {
+               oper->Mult(wp, t);
+               prec->Mult(t, *w[l]);  // w[l] = M A w[l-1]
+            }
+            else
+            {
+               oper->Mult(wp, *w[l]);
+            }
+         }
+
+         // Two passes of block Gram-Schmidt and Cholesky QR. The first pass
+         // drops the columns that are numerically dependent on the previous
+         // ones. The first column is always kept after the second pass, with
+         // R2(0,0) = 0 in the case of a lucky breakdown.
+         const int nv = i + 1;
+         int nn = OrthogonalizeBlock(v, nv, w, nw, C, R, 1e-12);
+         if (nn == 0)
+         {
+            R.SetSize(1);
+            R(0,0) = 1.0; // w[0] is only orthogonalized against v
+            nn = 1;
+         }
+         nn = std::max(OrthogonalizeBlock(v, nv, w, nn, C2, R2, 0.0), 1);
+         // Combine the passes: C = C + C2 R and R = R2 R.
+         for (l = 0; l < nn; l++)
+         {
+            for (k = 0; k < nv; k++)
+            {
+               for (int p = 0; p <= l; p++)
+               {
+                  C(k,l) += C2(k,p) * R(p,l);
+               }
+            }
+            for (k = 0; k <= l; k++)
+            {
+               double rkl = 0.0;
+               for (int p = k; p <= l; p++)
+               {
+                  rkl += R2(k,p) * R(p,l);
+               }
+               R(k,l) = rkl;
+            }
+         }
+         for (l = 0; l < nn; l++)
+         {
+            if (v[i+1+l] == NULL) { v[i+1+l] = new Vector(n); }
+            std::swap(v[i+1+l], w[l]);
+         }
+
+         // New columns of H: column i+l is M A v[i+l] = (Y_l - H X_l -
+         // sum_{p<l} H(:,i+p) X(i+p,l)) / X(i+l,l), where Y_l and X_l are
+         // the coefficients of w_{l+1} and w_l (or v_i) in the new basis.
+         for (l = 0; l < nn; l++)
+         {
+            const int col = i + l;
+            for (k = 0; k <= i + nn; k++)
+            {
+               h(k) = (k < nv) ? C(k,l) : R(k-nv,l);
+            }
+            if (l > 0)
+            {
+               for (int p = 0; p < i; p++)
+               {
+                  for (k = 0; k <= p + 1; k++)
+                  {
+                     h(k) -= H(k,p) * C(p,l-1);
+                  }
+               }
+               for (int p = 0; p < l; p++)
+               {
+                  const double xpl = (p == 0) ? C(i,l-1) : R(p-1,l-1);
+                  for (k = 0; k <= i + p + 1; k++)
+                  {
+                     h(k) -= H(k,i+p) * xpl;
+                  }
+               }
+               const double xll = R(l-1,l-1);
+               for (k = 0; k <= col + 1; k++)
+               {
+                  h(k) /= xll;
+               }
+            }
+            for (k = 0; k <= col + 1; k++)
+            {
+               H(k,col) = HR(k,col) = h(k);
+            }
+         }
+
+         // Apply the Givens rotations to the new columns.
+         for (l = 0; l < nn; l++, i++, j++)
+         {
+            for (k = 0; k < i; k++)
+            {
+               ApplyPlaneRotation(HR(k,i), HR(k+1,i), cs(k), sn(k));
+            }
+            GeneratePlaneRotation(HR(i,i), HR(i+1,i), cs(i), sn(i));
+            ApplyPlaneRotation(HR(i,i), HR(i+1,i), cs(i), sn(i));
+            ApplyPlaneRotation(g(i), g(i+1), cs(i), sn(i));
+
+            resid = fabs(g(i+1));
+            MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+
+            if (resid <= final_norm)
+            {
+               Update(x, i, HR, g, v);
+               final_norm = resid;
+               final_iter = j + 1;
+               converged = 1;
+               goto finish;
+            }
+
+            if (print_level == 1)
+            {
+               mfem::out << "   Pass : " << setw(2) << j/m+1
+                         << "   Iteration : " << setw(3) << j+1
+                         << "  ||B r|| = " << resid << '\n';
+            }
+
+            Monitor(j+1, resid, r, x);
+         }
+      }
+
+      if (print_level == 1 && j < max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+
+      Update(x, i-1, HR, g, v);
+
+      oper->Mult(x, r);
+      subtract(b, r, t);
+      if (prec)
+      {
+         prec->Mult(t, r);    // r = M (b - A x)
+      }
+      else
+      {
+         r = t;
+      }
+      beta = Norm(r);         // beta = ||r||
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      if (beta <= final_norm)
+      {
+         final_norm = beta;
+         final_iter = j;
+         converged = 1;
+         goto finish;
+      }
+   }
+
+   final_norm = beta;
+   final_iter = max_iter;
+   converged = 0;
+
+finish:
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "SStepGMRES: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "SStepGMRES: No convergence!\n";
+   }
+
+   Monitor(final_iter, final_norm, r, x, true);
+
+   for (i = 0; i < v.Size(); i++)
+   {
+      delete v[i];
+   }
+   for (i = 0; i < w.Size(); i++)
+   {
+      delete w[i];
+   }
+}
+
 void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 {
    DenseMatrix H(m+1,m);
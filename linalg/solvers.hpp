@@ -25,6 +25,8 @@
 #include <klu.h>
 #endif
 
+#include <map>
+
 namespace mfem
 {
 
@@ -67,6 +69,7 @@ class IterativeSolver : public Solver
 private:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
+   mutable MPI_Request sums_request; // see StartGlobalSums()
 #endif
 
 protected:
@@ -83,6 +86,16 @@ protected:
 
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
+
+   /** @brief Start the global sums of the @a n local values in @a sums, e.g.
+       of several fused local inner products. */
+   /** With MPI-3, a non-blocking reduction is used, so that local work such as
+       an operator action can be overlapped with it. The values in @a sums must
+       not be accessed until FinishGlobalSums() returns. Only one reduction can
+       be in progress at any time. */
+   void StartGlobalSums(double *sums, int n) const;
+   /// Complete the global sums started by StartGlobalSums().
+   void FinishGlobalSums() const;
    void Monitor(int it, double norm, const Vector& r, const Vector& x,
                 bool final=false) const;
 
@@ -143,23 +156,99 @@ public:
    OperatorJacobiSmoother(const Vector &d,
                           const Array<int> &ess_tdof_list,
                           const double damping=1.0);
+
+   /** Setup a Jacobi smoother whose diagonal is obtained by calling
+       op.AssembleDiagonal() in every call to SetOperator(op). This is useful
+       when the operator changes, e.g. as the matrix-free gradient inside a
+       NewtonSolver. The essential dofs are assumed to be handled by @a op,
+       e.g. by a ConstrainedOperator. */
+   OperatorJacobiSmoother(const double damping=1.0);
    ~OperatorJacobiSmoother() {}
 
    void Mult(const Vector &x, Vector &y) const;
    void MultTranspose(const Vector &x, Vector &y) const { Mult(x, y); }
-   void SetOperator(const Operator &op) { oper = &op; }
+   void SetOperator(const Operator &op);
    void Setup(const Vector &diag);
 
 private:
-   const int N;
+   int N;
    Vector dinv;
    const double damping;
-   const Array<int> &ess_tdof_list;
+   const Array<int> *ess_tdof_list; // not owned; may be NULL
    mutable Vector residual;
+   // If true, the diagonal is recomputed in SetOperator().
+   const bool assemble_diag;
 
    const Operator *oper;
 };
 
+/** @brief Estimates the extreme eigenvalues of a preconditioned symmetric
+    positive definite operator B A from the Lanczos coefficients of a few
+    preconditioned conjugate gradient iterations. */
+/** All vector operations are performed in the device memory of the work
+    vectors, only the coefficients of the small tridiagonal Lanczos matrix
+    are processed on the host. Compared to PowerMethod, the estimates converge
+    faster, and a lower bound is obtained as well.
+
+    The estimates for Jacobi preconditioners are cached, keyed by the
+    addresses of the operator A and of its diagonal, so that smoothers built
+    again for the same operator and diagonal, e.g. in every time step, reuse
+    them. The cached estimates are kept when the values of A or of the
+    diagonal change: Invalidate() has to be called when they should be
+    recomputed, and when A or the diagonal is deleted. */
+class SpectralBoundsEstimator
+{
+protected:
+   int max_iter;
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm;
+#endif
+   mutable Vector r, z, d, q;
+   typedef std::pair<const Operator*, const Vector*> Key;
+   std::map<Key, std::pair<double, double> > cache;
+
+   double Dot(const Vector &x, const Vector &y) const;
+
+public:
+   SpectralBoundsEstimator();
+
+#ifdef MFEM_USE_MPI
+   SpectralBoundsEstimator(MPI_Comm comm_);
+#endif
+
+   /// Set the maximum number of CG iterations used for the estimates
+   /// (default 10).
+   void SetMaxIter(int max_iter_) { max_iter = max_iter_; }
+
+   /** @brief Estimate the smallest and the largest eigenvalues of B A. */
+   /** The largest eigenvalue is approximated from below, and the smallest
+       from above. These estimates are not cached. */
+   void Estimate(const Operator &A, const Solver &B,
+                 double &lambda_min, double &lambda_max);
+
+   /** @brief Estimate the smallest and the largest eigenvalues of D^{-1} A,
+       or return the cached estimates for @a A and @a diag. */
+   /** The Jacobi preconditioner D^{-1} is the inverse of @a diag, with ones
+       at the entries in @a ess_tdof_list, see OperatorJacobiSmoother. */
+   void Estimate(const Operator &A, const Vector &diag,
+                 const Array<int> &ess_tdof_list,
+                 double &lambda_min, double &lambda_max);
+
+   /// Return true if estimates for @a A and @a diag are cached.
+   bool IsCached(const Operator &A, const Vector &diag) const
+   { return cache.count(Key(&A, &diag)) > 0; }
+
+   /// Remove the cached estimates for @a A and @a diag.
+   void Invalidate(const Operator &A, const Vector &diag)
+   { cache.erase(Key(&A, &diag)); }
+
+   /// Remove the cached estimates for @a A with any diagonal.
+   void Invalidate(const Operator &A);
+
+   /// Remove all cached estimates.
+   void Clear() { cache.clear(); }
+};
+
 /// Chebyshev accelerated smoothing with given vector, no matrix necessary
 /** Potentially useful with tensorized operators, for example. This is just a
     very basic Chebyshev iteration, if you want tolerances, iteration control,
@@ -195,6 +284,16 @@ public:
                              int order, int power_iterations = 10, double power_tolerance = 1e-8);
 #endif
 
+   /** Application is by *inverse* of the given vector. It is assumed the
+       underlying operator acts as the identity on entries in ess_tdof_list,
+       corresponding to (assembled) DIAG_ONE policy or ConstrainedOperator in
+       the matrix-free setting. The largest eigenvalue of the diagonally
+       preconditioned operator is obtained from @a estimator, which reuses
+       its cached estimate for @a oper_ if available. */
+   OperatorChebyshevSmoother(Operator* oper_, const Vector &d,
+                             const Array<int>& ess_tdof_list,
+                             int order, SpectralBoundsEstimator &estimator);
+
    ~OperatorChebyshevSmoother() {}
 
    void Mult(const Vector&x, Vector &y) const;
@@ -208,6 +307,10 @@ public:
 
    void Setup();
 
+   /// Return the estimate of the largest eigenvalue of the diagonally
+   /// preconditioned operator.
+   double GetMaxEigEstimate() const { return max_eig_estimate; }
+
 private:
    const int order;
    double max_eig_estimate;
@@ -285,6 +388,60 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
          int print_iter = 0, int max_num_iter = 1000,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
+/** @brief Pipelined conjugate gradient method of Ghysels and Vanroose, with a
+    single non-blocking global reduction per iteration. */
+/** The two inner products of each iteration are fused into one reduction,
+    which is overlapped with the application of the preconditioner and the
+    operator. This hides the latency of the reduction at the cost of extra
+    vector updates and memory (nine work vectors instead of three) and of a
+    slightly larger rounding error in the recursively updated residual. The
+    convergence criterion is the same as in CGSolver. */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, z, q, s, p;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/** @brief Conjugate gradient method of Chronopoulos and Gear, with a single
+    global reduction per iteration. */
+/** The two inner products of each iteration are computed together after the
+    application of the preconditioner and the operator, and reduced at once.
+    The update of the solution is overlapped with the reduction. The
+    convergence criterion is the same as in CGSolver. */
+class SingleReductionCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, p, s;
+
+   void UpdateVectors();
+
+public:
+   SingleReductionCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   SingleReductionCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
 
 /// GMRES method
 class GMRESSolver : public IterativeSolver
@@ -305,6 +462,51 @@ public:
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
+/** @brief Communication-avoiding s-step GMRES method. */
+/** Each step computes s vectors of the Krylov basis at once, with s successive
+    applications of the (left preconditioned) operator, and orthogonalizes the
+    block against the previous basis with two passes of block classical
+    Gram-Schmidt and Cholesky QR. Each pass needs a single global reduction,
+    so the method uses two reductions per s iterations, instead of i+2
+    reductions in iteration i of GMRESSolver. The Hessenberg matrix of the
+    Arnoldi relation is recovered from the coefficients of the block
+    orthogonalization, so the residual norms and the solution are those of
+    GMRESSolver, up to rounding errors.
+
+    The block vectors form a monomial basis, whose conditioning deteriorates
+    with s, so s should be small. Columns of the block that are numerically
+    dependent on the previous ones are dropped, and the next step is started
+    from the last accepted basis vector.
+
+    Unlike in PipelinedCGSolver and SingleReductionCGSolver, the reductions of
+    OrthogonalizeBlock() are blocking, i.e. they are not overlapped with any
+    computation. */
+class SStepGMRESSolver : public GMRESSolver
+{
+protected:
+   int s_step; // see SetStepSize()
+
+   /** @brief Orthogonalize the first @a nw vectors in @a w against the @a nv
+       orthonormal vectors in @a v, and against each other. */
+   /** On return, w_orig = v C + w R for the returned number of columns,
+       which are those with a relative Cholesky pivot above @a tol. */
+   int OrthogonalizeBlock(const Array<Vector *> &v, int nv, Array<Vector *> &w,
+                          int nw, DenseMatrix &C, DenseMatrix &R,
+                          double tol) const;
+
+public:
+   SStepGMRESSolver() { s_step = 4; }
+
+#ifdef MFEM_USE_MPI
+   SStepGMRESSolver(MPI_Comm _comm) : GMRESSolver(_comm) { s_step = 4; }
+#endif
+
+   /// Set the number of basis vectors computed in each step, default is 4.
+   void SetStepSize(int s) { s_step = s; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
 /// FGMRES method
 class FGMRESSolver : public IterativeSolver
 {
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <limits>
 #include <cstring>
+#include <functional>
 
 namespace mfem
 {
@@ -277,6 +278,7 @@ void SparseMatrix::SetEmpty()
    ColPtrJ = NULL;
    ColPtrNode = NULL;
    At = NULL;
+   spmv = NULL;
 #ifdef MFEM_USE_MEMALLOC
    NodesMem = NULL;
 #endif
@@ -591,6 +593,349 @@ void SparseMatrix::ToDenseMatrix(DenseMatrix & B) const
    }
 }
 
+/// Storage of a SparseMatrix in the BSR or the SELL-C-sigma format.
+class SparseMatrix::SpMVStorage
+{
+public:
+   SpMVFormat format;
+   /// Block size for BSR, slice height C for SELL.
+   int block_size;
+   /// Number of block rows for BSR, number of slices for SELL.
+   int num_rows;
+   int height, width;
+   /** @brief Offsets of the block rows in #cols for BSR, offsets of the
+       slices in #cols and #vals for SELL. */
+   Memory<int> offsets;
+   /// Block column indices for BSR, column indices for SELL.
+   Memory<int> cols;
+   /// Row of each slot of the slices for SELL, -1 for padding rows.
+   Memory<int> rows;
+   /// Row-major blocks for BSR, interleaved slice entries for SELL.
+   Memory<double> vals;
+
+   SpMVStorage(const SparseMatrix &mat, SpMVFormat format_, int block_size_);
+
+   void AddMult(const Vector &x, Vector &y, const double a) const;
+   void AddMultTranspose(const Vector &x, Vector &y, const double a) const;
+
+   ~SpMVStorage()
+   {
+      offsets.Delete();
+      cols.Delete();
+      rows.Delete();
+      vals.Delete();
+   }
+};
+
+SparseMatrix::SpMVStorage::SpMVStorage(const SparseMatrix &mat,
+                                       SpMVFormat format_, int block_size_)
+   : format(format_), block_size(block_size_), height(mat.Height()),
+     width(mat.Width())
+{
+   offsets.Reset();
+   cols.Reset();
+   rows.Reset();
+   vals.Reset();
+   const int *Ip = mat.HostReadI(), *Jp = mat.HostReadJ();
+   const double *Ap = mat.HostReadData();
+
+   if (format == BSR_FORMAT)
+   {
+      const int b = block_size;
+      num_rows = height/b;
+      const int num_cols = width/b;
+      Array<int> pos(num_cols);
+      pos = -1;
+      offsets.New(num_rows + 1);
+      offsets[0] = 0;
+      for (int bi = 0; bi < num_rows; bi++)
+      {
+         int count = 0;
+         for (int i = bi*b; i < (bi+1)*b; i++)
+         {
+            for (int k = Ip[i]; k < Ip[i+1]; k++)
+            {
+               const int bj = Jp[k]/b;
+               if (pos[bj] != bi) { pos[bj] = bi; count++; }
+            }
+         }
+         offsets[bi+1] = offsets[bi] + count;
+      }
+      const int nblocks = offsets[num_rows];
+      cols.New(nblocks);
+      vals.New(nblocks*b*b);
+      for (int k = 0; k < nblocks*b*b; k++) { vals[k] = 0.0; }
+      pos = -1;
+      for (int bi = 0; bi < num_rows; bi++)
+      {
+         int next = offsets[bi];
+         for (int i = bi*b; i < (bi+1)*b; i++)
+         {
+            for (int k = Ip[i]; k < Ip[i+1]; k++)
+            {
+               const int bj = Jp[k]/b;
+               if (pos[bj] < offsets[bi])
+               {
+                  pos[bj] = next;
+                  cols[next++] = bj;
+               }
+               vals[(pos[bj]*b + i - bi*b)*b + Jp[k] - bj*b] += Ap[k];
+            }
+         }
+      }
+   }
+   else
+   {
+      MFEM_ASSERT(format == SELL_FORMAT, "invalid format");
+      const int C = block_size;
+      const int sigma = 16*C;
+      num_rows = (height + C - 1)/C;
+
+      // Sort the rows by decreasing length in windows of sigma rows
+      rows.New(num_rows*C);
+      for (int i = 0; i < num_rows*C; i++) { rows[i] = (i < height) ? i : -1; }
+      int *perm = HostReadWrite(rows, num_rows*C);
+      for (int w = 0; w < height; w += sigma)
+      {
+         std::stable_sort(perm + w, perm + std::min(w + sigma, height),
+                          [Ip](int i, int j)
+         { return Ip[i+1] - Ip[i] > Ip[j+1] - Ip[j]; });
+      }
+
+      offsets.New(num_rows + 1);
+      offsets[0] = 0;
+      for (int c = 0; c < num_rows; c++)
+      {
+         int len = 0;
+         for (int l = 0; l < C; l++)
+         {
+            const int i = rows[c*C + l];
+            if (i >= 0) { len = std::max(len, Ip[i+1] - Ip[i]); }
+         }
+         offsets[c+1] = offsets[c] + len*C;
+      }
+      const int nnz = offsets[num_rows];
+      cols.New(nnz);
+      vals.New(nnz);
+      for (int c = 0; c < num_rows; c++)
+      {
+         const int len = (offsets[c+1] - offsets[c])/C;
+         for (int l = 0; l < C; l++)
+         {
+            const int i = rows[c*C + l];
+            const int row_len = (i >= 0) ? Ip[i+1] - Ip[i] : 0;
+            for (int k = 0; k < len; k++)
+            {
+               const int e = offsets[c] + k*C + l;
+               if (k < row_len)
+               {
+                  cols[e] = Jp[Ip[i] + k];
+                  vals[e] = Ap[Ip[i] + k];
+               }
+               else
+               {
+                  // Padding: zero entry in a valid column
+                  cols[e] = (row_len > 0) ? Jp[Ip[i] + row_len - 1] : 0;
+                  vals[e] = 0.0;
+               }
+            }
+         }
+      }
+   }
+}
+
+// y += a A x for the BSR format, with compile-time block size B if nonzero.
+template <int B>
+static void BSRAddMult(const int num_rows, const int block_size,
+                       const Memory<int> &offsets, const Memory<int> &cols,
+                       const Memory<double> &vals, const Vector &x, Vector &y,
+                       const double a)
+{
+   const int b = B ? B : block_size;
+   const int nblocks = offsets[num_rows];
+   auto O = Read(offsets, num_rows + 1);
+   auto Jb = Read(cols, nblocks);
+   auto V = Read(vals, nblocks*b*b);
+   auto X = x.Read();
+   auto Y = y.ReadWrite();
+   MFEM_FORALL(bi, num_rows,
+   {
+      const int bs = B ? B : b;
+      constexpr int MAX_B = B ? B : 8;
+      double sum[MAX_B];
+      for (int r = 0; r < bs; r++) { sum[r] = 0.0; }
+      for (int k = O[bi]; k < O[bi+1]; k++)
+      {
+         const double *blk = V + k*bs*bs;
+         const double *xb = X + Jb[k]*bs;
+         for (int r = 0; r < bs; r++)
+         {
+            for (int c = 0; c < bs; c++)
+            {
+               sum[r] += blk[r*bs + c]*xb[c];
+            }
+         }
+      }
+      for (int r = 0; r < bs; r++) { Y[bi*bs + r] += a*sum[r]; }
+   });
+}
+
+// y += a A x for the SELL format with slice height C, one slice per thread.
+template <int C>
+static void SELLAddMult(const int num_rows, const Memory<int> &offsets,
+                        const Memory<int> &cols, const Memory<int> &rows,
+                        const Memory<double> &vals, const Vector &x, Vector &y,
+                        const double a)
+{
+   const int nnz = offsets[num_rows];
+   auto O = Read(offsets, num_rows + 1);
+   auto Jc = Read(cols, nnz);
+   auto P = Read(rows, num_rows*C);
+   auto V = Read(vals, nnz);
+   auto X = x.Read();
+   auto Y = y.ReadWrite();
+   MFEM_FORALL(c, num_rows,
+   {
+      double sum[C];
+      for (int l = 0; l < C; l++) { sum[l] = 0.0; }
+      for (int e = O[c]; e < O[c+1]; e += C)
+      {
+         for (int l = 0; l < C; l++)
+         {
+            sum[l] += V[e + l]*X[Jc[e + l]];
+         }
+      }
+      for (int l = 0; l < C; l++)
+      {
+         const int i = P[c*C + l];
+         if (i >= 0) { Y[i] += a*sum[l]; }
+      }
+   });
+}
+
+void SparseMatrix::SpMVStorage::AddMult(const Vector &x, Vector &y,
+                                        const double a) const
+{
+   if (format == BSR_FORMAT)
+   {
+      switch (block_size)
+      {
+         case 2: BSRAddMult<2>(num_rows, 2, offsets, cols, vals, x, y, a);
+            return;
+         case 3: BSRAddMult<3>(num_rows, 3, offsets, cols, vals, x, y, a);
+            return;
+         case 4: BSRAddMult<4>(num_rows, 4, offsets, cols, vals, x, y, a);
+            return;
+         default:
+            BSRAddMult<0>(num_rows, block_size, offsets, cols, vals, x, y, a);
+            return;
+      }
+   }
+
+   if (block_size == 8)
+   {
+      SELLAddMult<8>(num_rows, offsets, cols, rows, vals, x, y, a);
+      return;
+   }
+
+   // One row per thread on devices, with coalesced accesses in the slices
+   const int C = block_size;
+   const int nnz = offsets[num_rows];
+   auto O = Read(offsets, num_rows + 1);
+   auto Jc = Read(cols, nnz);
+   auto P = Read(rows, num_rows*C);
+   auto V = Read(vals, nnz);
+   auto X = x.Read();
+   auto Y = y.ReadWrite();
+   MFEM_FORALL(s, num_rows*C,
+   {
+      const int i = P[s];
+      if (i < 0) { return; }
+      const int c = s/C, l = s - c*C;
+      double sum = 0.0;
+      for (int e = O[c] + l; e < O[c+1]; e += C)
+      {
+         sum += V[e]*X[Jc[e]];
+      }
+      Y[i] += a*sum;
+   });
+}
+
+// y += a A^t x for the BSR format on the host, with compile-time block size B
+// if nonzero.
+template <int B>
+static void BSRAddMultTranspose(const int num_rows, const int block_size,
+                                const int *O, const int *Jb, const double *V,
+                                const double *X, double *Y, const double a)
+{
+   const int b = B ? B : block_size;
+   for (int bi = 0; bi < num_rows; bi++)
+   {
+      constexpr int MAX_B = B ? B : 8;
+      double xb[MAX_B];
+      for (int r = 0; r < b; r++) { xb[r] = a*X[bi*b + r]; }
+      for (int k = O[bi]; k < O[bi+1]; k++)
+      {
+         const double *blk = V + k*b*b;
+         double *yb = Y + Jb[k]*b;
+         for (int r = 0; r < b; r++)
+         {
+            for (int c = 0; c < b; c++)
+            {
+               yb[c] += blk[r*b + c]*xb[r];
+            }
+         }
+      }
+   }
+}
+
+void SparseMatrix::SpMVStorage::AddMultTranspose(const Vector &x, Vector &y,
+                                                 const double a) const
+{
+   const double *X = x.HostRead();
+   double *Y = y.HostReadWrite();
+   const int *O = HostRead(offsets, num_rows + 1);
+   const int nnz = O[num_rows];
+   const int *Jc = HostRead(cols, nnz);
+   if (format == BSR_FORMAT)
+   {
+      const int b = block_size;
+      const double *V = HostRead(vals, nnz*b*b);
+      switch (b)
+      {
+         case 2: BSRAddMultTranspose<2>(num_rows, 2, O, Jc, V, X, Y, a);
+            return;
+         case 3: BSRAddMultTranspose<3>(num_rows, 3, O, Jc, V, X, Y, a);
+            return;
+         case 4: BSRAddMultTranspose<4>(num_rows, 4, O, Jc, V, X, Y, a);
+            return;
+         default:
+            BSRAddMultTranspose<0>(num_rows, b, O, Jc, V, X, Y, a);
+            return;
+      }
+   }
+
+   const int C = block_size;
+   const int *P = HostRead(rows, num_rows*C);
+   const double *V = HostRead(vals, nnz);
+   Array<double> xs(C);
+   for (int c = 0; c < num_rows; c++)
+   {
+      for (int l = 0; l < C; l++)
+      {
+         const int i = P[c*C + l];
+         xs[l] = (i >= 0) ? a*X[i] : 0.0;
+      }
+      for (int e = O[c]; e < O[c+1]; e += C)
+      {
+         for (int l = 0; l < C; l++)
+         {
+            Y[Jc[e + l]] += V[e + l]*xs[l];
+         }
+      }
+   }
+}
+
 void SparseMatrix::Mult(const Vector &x, Vector &y) const
 {
    if (Finalized()) { y.UseDevice(true); }
@@ -625,6 +970,12 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
       return;
    }
 
+   if (spmv)
+   {
+      spmv->AddMult(x, y, a);
+      return;
+   }
+
 #ifndef MFEM_USE_LEGACY_OPENMP
    const int height = this->height;
    const int nnz = J.Capacity();
@@ -753,6 +1104,12 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
    {
       At->AddMult(x, y, a);
    }
+   else if (spmv)
+   {
+      MFEM_VERIFY(Device::IsDisabled(), "transpose action on device is not "
+                  "enabled; see BuildTranspose() for details.");
+      spmv->AddMultTranspose(x, y, a);
+   }
    else
    {
       MFEM_VERIFY(Device::IsDisabled(), "transpose action on device is not "
@@ -775,6 +1132,10 @@ void SparseMatrix::BuildTranspose() const
    if (At == NULL)
    {
       At = Transpose(*this);
+      if (spmv)
+      {
+         At->BuildSpMVFormat(spmv->format, spmv->block_size);
+      }
    }
 }
 
@@ -784,6 +1145,107 @@ void SparseMatrix::ResetTranspose() const
    At = NULL;
 }
 
+SparseMatrix::SpMVFormat SparseMatrix::SelectSpMVFormat(int &block_size) const
+{
+   MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
+   const int *Ip = HostReadI(), *Jp = HostReadJ();
+   const int nnz = Ip[height];
+   block_size = 1;
+   if (nnz == 0) { return CSR_FORMAT; }
+
+   // Dense blocks: the number of blocks times the block size squared is
+   // close to the number of nonzeros.
+   for (int b = 4; b >= 2; b--)
+   {
+      if (height % b != 0 || width % b != 0) { continue; }
+      Array<int> marker(width/b);
+      marker = -1;
+      long long nblocks = 0;
+      for (int i = 0; i < height; i++)
+      {
+         for (int k = Ip[i]; k < Ip[i+1]; k++)
+         {
+            const int bj = Jp[k]/b;
+            if (marker[bj] != i/b) { marker[bj] = i/b; nblocks++; }
+         }
+      }
+      if (nblocks*b*b <= 1.05*nnz)
+      {
+         block_size = b;
+         return BSR_FORMAT;
+      }
+   }
+
+   // SELL: the rows must be long enough to amortize the slices, and the
+   // padding within sorted windows must be small.
+   const int C = Device::Allows(Backend::DEVICE_MASK) ? 32 : 8;
+   if (nnz < 8*height) { return CSR_FORMAT; }
+   Array<int> len(height);
+   for (int i = 0; i < height; i++) { len[i] = Ip[i+1] - Ip[i]; }
+   long long padded = 0;
+   const int sigma = 16*C;
+   for (int w = 0; w < height; w += sigma)
+   {
+      const int end = std::min(w + sigma, height);
+      std::sort(len.GetData() + w, len.GetData() + end, std::greater<int>());
+      for (int i = w; i < end; i += C) { padded += (long long)len[i]*C; }
+   }
+   if (padded <= 1.1*nnz)
+   {
+      block_size = C;
+      return SELL_FORMAT;
+   }
+   return CSR_FORMAT;
+}
+
+void SparseMatrix::BuildSpMVFormat(SpMVFormat format, int block_size) const
+{
+   MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
+   ResetSpMVFormat();
+
+   if (format == AUTO_FORMAT)
+   {
+      format = SelectSpMVFormat(block_size);
+   }
+   else if (format == BSR_FORMAT && block_size == 0)
+   {
+      MFEM_VERIFY(SelectSpMVFormat(block_size) == BSR_FORMAT,
+                  "the matrix does not consist of dense blocks");
+   }
+   else if (format == SELL_FORMAT)
+   {
+      block_size = Device::Allows(Backend::DEVICE_MASK) ? 32 : 8;
+   }
+   if (format == CSR_FORMAT) { return; }
+
+   if (format == BSR_FORMAT)
+   {
+      MFEM_VERIFY(block_size >= 1 && block_size <= 8 &&
+                  height % block_size == 0 && width % block_size == 0,
+                  "invalid block size " << block_size);
+   }
+   spmv = new SpMVStorage(*this, format, block_size);
+   if (At)
+   {
+      At->BuildSpMVFormat(format, block_size);
+   }
+}
+
+void SparseMatrix::ResetSpMVFormat() const
+{
+   delete spmv;
+   spmv = NULL;
+   if (At)
+   {
+      At->ResetSpMVFormat();
+   }
+}
+
+SparseMatrix::SpMVFormat SparseMatrix::GetSpMVFormat() const
+{
+   return spmv ? spmv->format : CSR_FORMAT;
+}
+
 void SparseMatrix::PartMult(
    const Array<int> &rows, const Vector &x, Vector &y) const
 {
@@ -2605,6 +3067,34 @@ void SparseMatrix::GetSubMatrix(const Array<int> &rows, const Array<int> &cols,
    }
 }
 
+void SparseMatrix::AddSubMatrixSorted(const Array<int> &rows,
+                                      const Array<int> &cols,
+                                      const DenseMatrix &subm)
+{
+   MFEM_ASSERT(Finalized() && isSorted,
+               "the matrix must be finalized, with sorted column indices");
+
+   const int *Ip = I, *Jp = J;
+   double *Ap = A;
+   for (int i = 0; i < rows.Size(); i++)
+   {
+      int gi = rows[i], s = 1;
+      if (gi < 0) { gi = -1-gi; s = -1; }
+      MFEM_ASSERT(gi < height, "invalid row " << gi);
+      const int *row_begin = Jp + Ip[gi], *row_end = Jp + Ip[gi+1];
+      for (int j = 0; j < cols.Size(); j++)
+      {
+         int gj = cols[j], t = s;
+         if (gj < 0) { gj = -1-gj; t = -s; }
+         const int *pos = std::lower_bound(row_begin, row_end, gj);
+         MFEM_VERIFY(pos != row_end && *pos == gj,
+                     "Entry (" << gi << ", " << gj << ") is not allocated.");
+         const double a = subm(i, j);
+         Ap[pos - Jp] += (t < 0) ? -a : a;
+      }
+   }
+}
+
 bool SparseMatrix::RowIsEmpty(const int row) const
 {
    int gi;
@@ -3154,6 +3644,7 @@ void SparseMatrix::Destroy()
    delete NodesMem;
 #endif
    delete At;
+   delete spmv;
 
 #ifdef MFEM_USE_CUDA
    if (initBuffers)
@@ -3891,6 +4382,7 @@ void SparseMatrix::Swap(SparseMatrix &other)
    mfem::Swap(ColPtrJ, other.ColPtrJ);
    mfem::Swap(ColPtrNode, other.ColPtrNode);
    mfem::Swap(At, other.At);
+   mfem::Swap(spmv, other.spmv);
 
 #ifdef MFEM_USE_MEMALLOC
    mfem::Swap(NodesMem, other.NodesMem);
@@ -75,6 +75,11 @@ protected:
    /// Transpose of A. Owned. Used to perform MultTranspose() on devices.
    mutable SparseMatrix *At;
 
+   /// Copy of the matrix in the storage format set by BuildSpMVFormat().
+   class SpMVStorage;
+   /// Owned. Used to perform the matrix-vector products, if not NULL.
+   mutable SpMVStorage *spmv{NULL};
+
 #ifdef MFEM_USE_MEMALLOC
    typedef MemAlloc <RowNode, 1024> RowNodeAlloc;
    RowNodeAlloc * NodesMem;
@@ -106,6 +111,15 @@ protected:
 #endif
 
 public:
+   /// Storage formats used for the matrix-vector products.
+   enum SpMVFormat
+   {
+      CSR_FORMAT,  ///< Compressed sparse row format, the default
+      BSR_FORMAT,  ///< Block CSR format with dense square blocks
+      SELL_FORMAT, ///< Sliced ELLPACK format with sorted rows (SELL-C-sigma)
+      AUTO_FORMAT  ///< Format chosen with SelectSpMVFormat()
+   };
+
    /// Create an empty SparseMatrix.
    SparseMatrix()
    {
@@ -334,6 +348,50 @@ public:
        more details. */
    void ResetTranspose() const;
 
+   /** @brief Build and store internally a copy of this matrix in the given
+       storage @a format, which will be used in the methods Mult(), AddMult(),
+       MultTranspose() and AddMultTranspose(). */
+   /** The BSR format stores dense blocks of size @a block_size, with a single
+       column index per block. It suits vector valued problems with
+       Ordering::byVDIM, with the vector dimension as @a block_size. When
+       @a block_size is 0, the block size is detected with SelectSpMVFormat().
+       Missing entries of the blocks are stored as zeros.
+
+       The SELL format groups the rows in slices of C consecutive rows, after
+       sorting them by length in windows of sigma rows. The rows of a slice
+       are padded to the same length and interleaved, such that the products
+       vectorize across the rows of the slice. C is 8 for host backends and
+       32 for device backends, when the copy is built.
+
+       The CSR format removes the internal copy. With AUTO_FORMAT, the format
+       is chosen with SelectSpMVFormat().
+
+       Warning: any changes in this matrix will invalidate the internal copy.
+       To rebuild it, call ResetSpMVFormat() followed by a call to this method.
+       If the internal copy is already built, it is replaced. The internal
+       transpose, see BuildTranspose(), uses the same format.
+
+       On devices, the transposed products still require the internal
+       transpose. This method can only be used when the sparse matrix is
+       finalized. */
+   void BuildSpMVFormat(SpMVFormat format = AUTO_FORMAT,
+                        int block_size = 0) const;
+
+   /** Reset (destroy) the internal copy of the matrix in the format set by
+       BuildSpMVFormat(). */
+   void ResetSpMVFormat() const;
+
+   /// Return the format used for the matrix-vector products.
+   SpMVFormat GetSpMVFormat() const;
+
+   /** @brief Choose a storage format for the matrix-vector products based on
+       the sparsity pattern. */
+   /** The BSR format is chosen if the matrix consists of dense blocks of size
+       4, 3 or 2, which is then returned in @a block_size. Otherwise, the SELL
+       format is chosen if its padding adds few entries and the rows are long
+       enough to benefit from the vectorization, and the CSR format if not. */
+   SpMVFormat SelectSpMVFormat(int &block_size) const;
+
    void PartMult(const Array<int> &rows, const Vector &x, Vector &y) const;
    void PartAddMult(const Array<int> &rows, const Vector &x, Vector &y,
                     const double a=1.0) const;
@@ -522,6 +580,16 @@ public:
    void AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
                      const DenseMatrix &subm, int skip_zeros = 1);
 
+   /** @brief Add the dense matrix @a subm to the entries (@a rows, @a cols) of
+       a finalized matrix, without changing its sparsity pattern. */
+   /** All entries must be in the sparsity pattern, and the column indices must
+       be sorted in each row, see SortColumnIndices(). Negative indices encode
+       a change of sign, as in AddSubMatrix(). Unlike AddSubMatrix(), this
+       method does not use the "current row" of the matrix, so it can be called
+       concurrently by threads that update disjoint sets of rows. */
+   void AddSubMatrixSorted(const Array<int> &rows, const Array<int> &cols,
+                           const DenseMatrix &subm);
+
    bool RowIsEmpty(const int row) const;
 
    /// Extract all column indices and values from a given row.
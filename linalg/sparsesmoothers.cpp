@@ -15,6 +15,7 @@
 #include "matrix.hpp"
 #include "sparsemat.hpp"
 #include "sparsesmoothers.hpp"
+#include "../general/forall.hpp"
 #include <iostream>
 
 namespace mfem
@@ -51,6 +52,190 @@ void GSSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+// Set dinv to the inverse of the diagonal of the finalized matrix a.
+static void GetInverseDiagonal(const SparseMatrix &a, Vector &dinv)
+{
+   a.GetDiag(dinv);
+   double *d = dinv.HostReadWrite();
+   for (int i = 0; i < dinv.Size(); i++)
+   {
+      MFEM_VERIFY(d[i] != 0.0, "zero diagonal entry in row " << i);
+      d[i] = 1.0/d[i];
+   }
+}
+
+MulticolorGSSmoother::MulticolorGSSmoother(const SparseMatrix &a, int t,
+                                           int it, double w)
+   : SparseSmoother(a)
+{
+   type = t;
+   iterations = it;
+   omega = w;
+   Setup();
+}
+
+void MulticolorGSSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   Setup();
+}
+
+void MulticolorGSSmoother::Setup()
+{
+   MFEM_VERIFY(oper->Finalized(), "the matrix must be finalized");
+   GetInverseDiagonal(*oper, dinv);
+
+   // Greedy coloring: each row gets the smallest color that is not used by the
+   // previous rows coupled to it in the matrix or in its transpose.
+   SparseMatrix *At = Transpose(*oper);
+   const int n = oper->Height();
+   const int *I = oper->HostReadI(), *J = oper->HostReadJ();
+   const int *It = At->HostReadI(), *Jt = At->HostReadJ();
+   Array<int> color(n), marker;
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] < i) { marker[color[J[k]]] = i; }
+      }
+      for (int k = It[i]; k < It[i+1]; k++)
+      {
+         if (Jt[k] < i) { marker[color[Jt[k]]] = i; }
+      }
+      int c = 0;
+      while (c < marker.Size() && marker[c] == i) { c++; }
+      if (c == marker.Size()) { marker.Append(-1); }
+      color[i] = c;
+   }
+   delete At;
+
+   // Sort the rows by color, keeping their order within each color.
+   color_offsets.SetSize(marker.Size() + 1);
+   color_offsets = 0;
+   for (int i = 0; i < n; i++) { color_offsets[color[i]+1]++; }
+   color_offsets.PartialSum();
+   Array<int> pos;
+   color_offsets.Copy(pos);
+   color_rows.SetSize(n);
+   for (int i = 0; i < n; i++) { color_rows[pos[color[i]]++] = i; }
+}
+
+void MulticolorGSSmoother::Sweep(const Vector &x, Vector &y,
+                                 bool forward) const
+{
+   const int num_colors = GetNumColors();
+   const double w = omega;
+   const int *I = oper->ReadI();
+   const int *J = oper->ReadJ();
+   const double *A = oper->ReadData();
+   const int *rows = color_rows.Read();
+   const double *D = dinv.Read();
+   const double *X = x.Read();
+   double *Y = y.ReadWrite();
+
+   for (int k = 0; k < num_colors; k++)
+   {
+      // The rows of one color are not coupled, so they are updated in parallel.
+      const int c = forward ? k : num_colors - 1 - k;
+      const int *R = rows + color_offsets[c];
+      MFEM_FORALL(r, color_offsets[c+1] - color_offsets[c],
+      {
+         const int i = R[r];
+         double sum = X[i];
+         for (int j = I[i]; j < I[i+1]; j++)
+         {
+            sum -= A[j]*Y[J[j]];
+         }
+         Y[i] += w*D[i]*sum;
+      });
+   }
+}
+
+void MulticolorGSSmoother::Apply(const Vector &x, Vector &y,
+                                 bool transpose) const
+{
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   // The transposed smoother applies the sweeps in reverse order and with
+   // swapped directions, i.e. the symmetric smoother is unchanged.
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != (transpose ? 1 : 2)) { Sweep(x, y, true); }
+      if (type != (transpose ? 2 : 1)) { Sweep(x, y, false); }
+   }
+}
+
+BlockGSSmoother::BlockGSSmoother(const SparseMatrix &a, int t, int it,
+                                 double w, int bs)
+   : SparseSmoother(a)
+{
+   type = t;
+   iterations = it;
+   omega = w;
+   block_size = bs;
+   MFEM_VERIFY(oper->Finalized(), "the matrix must be finalized");
+   GetInverseDiagonal(*oper, dinv);
+}
+
+void BlockGSSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(oper->Finalized(), "the matrix must be finalized");
+   GetInverseDiagonal(*oper, dinv);
+}
+
+void BlockGSSmoother::Sweep(const Vector &x, Vector &y, bool forward) const
+{
+   MFEM_VERIFY(block_size > 0, "invalid block size " << block_size);
+   const int n = height;
+   const int bs = block_size;
+   const int num_blocks = (n + bs - 1)/bs;
+   const double w = omega;
+   z = y;
+   const int *I = oper->ReadI();
+   const int *J = oper->ReadJ();
+   const double *A = oper->ReadData();
+   const double *D = dinv.Read();
+   const double *X = x.Read();
+   const double *Z = z.Read();
+   double *Y = y.ReadWrite();
+
+   MFEM_FORALL(b, num_blocks,
+   {
+      const int begin = b*bs;
+      const int end = (begin + bs < n) ? begin + bs : n;
+      for (int k = 0; k < end - begin; k++)
+      {
+         const int i = forward ? begin + k : end - 1 - k;
+         double sum = X[i];
+         for (int j = I[i]; j < I[i+1]; j++)
+         {
+            // Updated values inside the block, old values outside.
+            const int c = J[j];
+            sum -= A[j]*((c >= begin && c < end) ? Y[c] : Z[c]);
+         }
+         Y[i] += w*D[i]*sum;
+      }
+   });
+}
+
+void BlockGSSmoother::Apply(const Vector &x, Vector &y, bool transpose) const
+{
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   // The transposed smoother applies the sweeps in reverse order and with
+   // swapped directions, i.e. the symmetric smoother is unchanged.
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != (transpose ? 1 : 2)) { Sweep(x, y, true); }
+      if (type != (transpose ? 2 : 1)) { Sweep(x, y, false); }
+   }
+}
+
 /// Create the Jacobi smoother.
 DSmoother::DSmoother(const SparseMatrix &a, int t, double s, int it)
    : SparseSmoother(a)
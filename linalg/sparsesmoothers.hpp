@@ -51,6 +51,115 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** @brief Multicolor Gauss-Seidel and SSOR smoother of a sparse matrix. */
+/** The rows of the matrix are colored once, in SetOperator(), such that two
+    rows of the same color are not coupled in the matrix (or its transpose).
+    A sweep processes the colors in sequence, and the rows of each color in
+    parallel with MFEM_FORALL, i.e. with OpenMP threads or on the device. A
+    forward sweep is the Gauss-Seidel sweep of the matrix with its rows
+    reordered by color, and a backward sweep processes the colors in reverse
+    order. With a relaxation parameter @a w different from 1, the symmetric
+    smoother is an SSOR smoother.
+
+    MultTranspose() applies the sweeps of Mult() in reverse order and with
+    swapped directions, which gives the transpose of Mult() for symmetric
+    matrices, so the smoother can be used for both the pre- and the
+    post-smoothing of Multigrid. The matrix must be finalized, with nonzero
+    diagonal entries. */
+class MulticolorGSSmoother : public SparseSmoother
+{
+protected:
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+   double omega;
+
+   /// Rows of the color c are color_rows[color_offsets[c]:color_offsets[c+1]].
+   Array<int> color_offsets, color_rows;
+   /// Inverse of the diagonal of the matrix.
+   Vector dinv;
+
+   /// Compute the coloring of the rows and the inverse diagonal.
+   void Setup();
+
+   /// Apply one forward or backward sweep of the rows of all colors.
+   void Sweep(const Vector &x, Vector &y, bool forward) const;
+
+   /// Apply the sweeps of Mult() or, if @a transpose is true, MultTranspose().
+   void Apply(const Vector &x, Vector &y, bool transpose) const;
+
+public:
+   /// Create MulticolorGSSmoother.
+   MulticolorGSSmoother(int t = 0, int it = 1, double w = 1.0)
+   { type = t; iterations = it; omega = w; }
+
+   /// Create MulticolorGSSmoother.
+   MulticolorGSSmoother(const SparseMatrix &a, int t = 0, int it = 1,
+                        double w = 1.0);
+
+   virtual void SetOperator(const Operator &a);
+
+   /// Return the number of colors of the rows of the matrix.
+   int GetNumColors() const { return color_offsets.Size() - 1; }
+
+   /// Matrix vector multiplication with the multicolor GS smoother.
+   virtual void Mult(const Vector &x, Vector &y) const
+   { Apply(x, y, false); }
+
+   /// Transpose multiplication, with the sweeps reversed.
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { Apply(x, y, true); }
+};
+
+/** @brief Block Gauss-Seidel and SSOR smoother of a sparse matrix, with
+    Jacobi coupling between the blocks. */
+/** The rows are split into contiguous blocks of @a bs rows. The blocks are
+    processed in parallel with MFEM_FORALL, each block with a sequential
+    Gauss-Seidel sweep over its rows. Inside a block, the sweep uses the
+    updated values, while the values of the other blocks are the ones from the
+    beginning of the sweep. This is a deterministic version of the
+    block-asynchronous (hybrid) Gauss-Seidel method, which keeps the cache
+    locality of the sequential sweeps within the blocks. The types, the
+    relaxation parameter and MultTranspose() are as in MulticolorGSSmoother.
+    The matrix must be finalized, with nonzero diagonal entries. */
+class BlockGSSmoother : public SparseSmoother
+{
+protected:
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+   double omega;
+   int block_size;
+
+   /// Inverse of the diagonal of the matrix.
+   Vector dinv;
+   /// Values at the beginning of a sweep.
+   mutable Vector z;
+
+   /// Apply one forward or backward sweep in all blocks.
+   void Sweep(const Vector &x, Vector &y, bool forward) const;
+
+   /// Apply the sweeps of Mult() or, if @a transpose is true, MultTranspose().
+   void Apply(const Vector &x, Vector &y, bool transpose) const;
+
+public:
+   /// Create BlockGSSmoother.
+   BlockGSSmoother(int t = 0, int it = 1, double w = 1.0, int bs = 256)
+   { type = t; iterations = it; omega = w; block_size = bs; }
+
+   /// Create BlockGSSmoother.
+   BlockGSSmoother(const SparseMatrix &a, int t = 0, int it = 1,
+                   double w = 1.0, int bs = 256);
+
+   virtual void SetOperator(const Operator &a);
+
+   /// Matrix vector multiplication with the block GS smoother.
+   virtual void Mult(const Vector &x, Vector &y) const
+   { Apply(x, y, false); }
+
+   /// Transpose multiplication, with the sweeps reversed.
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { Apply(x, y, true); }
+};
+
 /// Data type for scaled Jacobi-type smoother of sparse matrix
 class DSmoother : public SparseSmoother
 {
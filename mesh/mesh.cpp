@@ -19,6 +19,7 @@
 #include "../general/device.hpp"
 #include "../general/tic_toc.hpp"
 #include "../general/gecko.hpp"
+#include "../general/forall.hpp"
 #include "../fem/quadinterpolator.hpp"
 
 #include <iostream>
@@ -774,22 +775,51 @@ void Mesh::GetLocalQuadToWdgTransformation(
    }
 }
 
-const GeometricFactors* Mesh::GetGeometricFactors(const IntegrationRule& ir,
-                                                  const int flags)
+const GeometricFactors* Mesh::GetGeometricFactors(
+   const IntegrationRule& ir, const int flags, GeometricFactorsStorage storage)
 {
+   const int jac_flags = GeometricFactors::JACOBIANS |
+                         GeometricFactors::DETERMINANTS;
+   GeometricFactors *same = NULL, *other = NULL;
    for (int i = 0; i < geom_factors.Size(); i++)
    {
       GeometricFactors *gf = geom_factors[i];
-      if (gf->IntRule == &ir && (gf->computed_factors & flags) == flags)
+      if (gf->IntRule != &ir) { continue; }
+      if (gf->storage == storage) { same = gf; }
+      else { other = gf; }
+   }
+
+   // The compressed storage accepts full factors. Compressed factors are full
+   // as well once the Jacobians were found to be non-constant.
+   GeometricFactors *gf = same;
+   if (!gf && other)
+   {
+      if (storage == GeometricFactorsStorage::Compressed ||
+          ((other->computed_factors & jac_flags) && !other->compressed))
       {
-         return gf;
+         gf = other;
       }
    }
+   if (gf)
+   {
+      // Move to the end of the list of the most recently used factors
+      geom_factors.DeleteFirst(gf);
+      geom_factors.Append(gf);
+      if ((gf->computed_factors & flags) != flags)
+      {
+         gf->Compute(flags);
+         ReduceGeometricFactorsMemory(gf);
+      }
+      return gf;
+   }
 
    this->EnsureNodes();
 
-   GeometricFactors *gf = new GeometricFactors(this, ir, flags);
+   // Full factors are expanded from the compressed ones
+   gf = other ? new GeometricFactors(*other, flags) :
+        new GeometricFactors(this, ir, flags, storage);
    geom_factors.Append(gf);
+   ReduceGeometricFactorsMemory(gf);
    return gf;
 }
 
@@ -803,6 +833,8 @@ const FaceGeometricFactors* Mesh::GetFaceGeometricFactors(
       if (gf->IntRule == &ir && (gf->computed_factors & flags) == flags &&
           gf->type==type)
       {
+         face_geom_factors.DeleteFirst(gf);
+         face_geom_factors.Append(gf);
          return gf;
       }
    }
@@ -811,6 +843,7 @@ const FaceGeometricFactors* Mesh::GetFaceGeometricFactors(
 
    FaceGeometricFactors *gf = new FaceGeometricFactors(this, ir, flags, type);
    face_geom_factors.Append(gf);
+   ReduceGeometricFactorsMemory(gf);
    return gf;
 }
 
@@ -818,7 +851,7 @@ void Mesh::DeleteGeometricFactors()
 {
    for (int i = 0; i < geom_factors.Size(); i++)
    {
-      delete geom_factors[i];
+      geom_factors[i]->Uncache();
    }
    geom_factors.SetSize(0);
    for (int i = 0; i < face_geom_factors.Size(); i++)
@@ -828,6 +861,50 @@ void Mesh::DeleteGeometricFactors()
    face_geom_factors.SetSize(0);
 }
 
+long Mesh::GetGeometricFactorsMemory() const
+{
+   long bytes = 0;
+   for (int i = 0; i < geom_factors.Size(); i++)
+   {
+      bytes += geom_factors[i]->MemoryUsage();
+   }
+   for (int i = 0; i < face_geom_factors.Size(); i++)
+   {
+      bytes += face_geom_factors[i]->MemoryUsage();
+   }
+   return bytes;
+}
+
+void Mesh::SetGeometricFactorsMemoryLimit(long max_bytes)
+{
+   geom_factors_max_bytes = max_bytes;
+   ReduceGeometricFactorsMemory(NULL);
+}
+
+void Mesh::ReduceGeometricFactorsMemory(const void *keep)
+{
+   if (geom_factors_max_bytes < 0) { return; }
+   long bytes = GetGeometricFactorsMemory();
+   // The least recently used factors are at the beginning of the lists
+   for (int i = 0; i < geom_factors.Size() && bytes > geom_factors_max_bytes; )
+   {
+      GeometricFactors *gf = geom_factors[i];
+      if (gf == keep || gf->GetNumUsers() > 0) { i++; continue; }
+      bytes -= gf->MemoryUsage();
+      geom_factors.DeleteFirst(gf);
+      delete gf;
+   }
+   for (int i = 0; i < face_geom_factors.Size() &&
+        bytes > geom_factors_max_bytes; )
+   {
+      FaceGeometricFactors *gf = face_geom_factors[i];
+      if (gf == keep) { i++; continue; }
+      bytes -= gf->MemoryUsage();
+      face_geom_factors.DeleteFirst(gf);
+      delete gf;
+   }
+}
+
 void Mesh::GetLocalFaceTransformation(
    int face_type, int elem_type, IsoparametricTransformation &Transf, int info)
 {
@@ -1089,6 +1166,7 @@ void Mesh::Init()
    NURBSext = NULL;
    ncmesh = NULL;
    last_operation = Mesh::NONE;
+   geom_factors_max_bytes = -1;
 }
 
 void Mesh::InitTables()
@@ -3118,6 +3196,7 @@ Mesh::Mesh(const Mesh &mesh, bool copy_nodes)
    // Create the new Mesh instance without a record of its refinement history
    sequence = 0;
    last_operation = Mesh::NONE;
+   geom_factors_max_bytes = mesh.geom_factors_max_bytes;
 
    // Duplicate the elements
    elements.SetSize(NumOfElements);
@@ -10693,11 +10772,94 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
 
 
 GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
-                                   int flags)
+                                   int flags, GeometricFactorsStorage storage)
+   : storage(storage), compressed(false), num_users(0), cached(true)
 {
    this->mesh = mesh;
    IntRule = &ir;
-   computed_factors = flags;
+   computed_factors = 0;
+   Compute(flags);
+}
+
+// Return true if the Jacobians J, with layout (NQ x S x NE), are the same at
+// all quadrature points of each element.
+static bool ConstantJacobians(const int NQ, const int S, const int NE,
+                              const Vector &J)
+{
+   const auto Jh = Reshape(J.HostRead(), NQ, S, NE);
+   for (int e = 0; e < NE; e++)
+   {
+      double j_max = 0.0;
+      for (int s = 0; s < S; s++) { j_max = std::max(j_max, fabs(Jh(0,s,e))); }
+      for (int s = 0; s < S; s++)
+      {
+         for (int q = 1; q < NQ; q++)
+         {
+            if (fabs(Jh(q,s,e) - Jh(0,s,e)) > 1e-12*j_max) { return false; }
+         }
+      }
+   }
+   return true;
+}
+
+// Keep the values of v, with layout (NQ x S x NE), at the first quadrature
+// point of each element: cv has layout (S x NE).
+static void CompressFactors(const int NQ, const int S, const int NE,
+                            const Vector &v, Vector &cv)
+{
+   const auto V = Reshape(v.Read(), NQ, S*NE);
+   cv.SetSize(S*NE);
+   auto CV = cv.Write();
+   MFEM_FORALL(i, S*NE, CV[i] = V(0,i););
+}
+
+// Copy the values cv, with layout (S x NE), to all the NQ quadrature points
+// of each element: v has layout (NQ x S x NE).
+static void ExpandFactors(const int NQ, const int S, const int NE,
+                          const Vector &cv, Vector &v)
+{
+   const auto CV = cv.Read();
+   v.SetSize(NQ*S*NE);
+   auto V = Reshape(v.Write(), NQ, S*NE);
+   MFEM_FORALL(i, S*NE,
+   {
+      for (int q = 0; q < NQ; q++) { V(q,i) = CV[i]; }
+   });
+}
+
+GeometricFactors::GeometricFactors(const GeometricFactors &cgf, int flags)
+   : mesh(cgf.mesh), IntRule(cgf.IntRule), computed_factors(0),
+     storage(GeometricFactorsStorage::Full), compressed(false), num_users(0),
+     cached(true)
+{
+   const int NQ = IntRule->GetNPoints();
+   const int NE = mesh->GetNE();
+   const int S = mesh->Dimension()*mesh->SpaceDimension();
+   const int NQ_c = cgf.compressed ? 1 : NQ;
+   if (cgf.computed_factors & COORDINATES)
+   {
+      X = cgf.X;
+      computed_factors |= COORDINATES;
+   }
+   if (cgf.computed_factors & JACOBIANS)
+   {
+      if (NQ_c == 1) { ExpandFactors(NQ, S, NE, cgf.J, J); }
+      else { J = cgf.J; }
+      computed_factors |= JACOBIANS;
+   }
+   if (cgf.computed_factors & DETERMINANTS)
+   {
+      if (NQ_c == 1) { ExpandFactors(NQ, 1, NE, cgf.detJ, detJ); }
+      else { detJ = cgf.detJ; }
+      computed_factors |= DETERMINANTS;
+   }
+   Compute(flags);
+}
+
+void GeometricFactors::Compute(int flags)
+{
+   flags &= ~computed_factors;
+   if (flags == 0) { return; }
 
    const GridFunction *nodes = mesh->GetNodes();
    const FiniteElementSpace *fespace = nodes->FESpace();
@@ -10706,30 +10868,40 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
    const int vdim = fespace->GetVDim();
    const int NE   = fespace->GetNE();
    const int ND   = fe->GetDof();
-   const int NQ   = ir.GetNPoints();
+   const int NQ   = IntRule->GetNPoints();
+
+   // With compressed storage, the first computation of the Jacobians or their
+   // determinants checks if the mesh is affine.
+   const int jac_flags = GeometricFactors::JACOBIANS |
+                         GeometricFactors::DETERMINANTS;
+   const bool check_affine = storage == GeometricFactorsStorage::Compressed &&
+                             (flags & jac_flags) &&
+                             !(computed_factors & jac_flags);
 
    // For now, we are not using tensor product evaluation
    const Operator *elem_restr = fespace->GetElementRestriction(
                                    ElementDofOrdering::NATIVE);
 
    unsigned eval_flags = 0;
+   Vector q_der, q_det;
    if (flags & GeometricFactors::COORDINATES)
    {
       X.SetSize(vdim*NQ*NE);
       eval_flags |= QuadratureInterpolator::VALUES;
    }
-   if (flags & GeometricFactors::JACOBIANS)
+   if ((flags & GeometricFactors::JACOBIANS) || check_affine)
    {
-      J.SetSize(dim*vdim*NQ*NE);
+      q_der.SetSize(dim*vdim*NQ*NE);
       eval_flags |= QuadratureInterpolator::DERIVATIVES;
    }
    if (flags & GeometricFactors::DETERMINANTS)
    {
-      detJ.SetSize(NQ*NE);
+      q_det.SetSize(NQ*NE);
       eval_flags |= QuadratureInterpolator::DETERMINANTS;
    }
 
-   const QuadratureInterpolator *qi = fespace->GetQuadratureInterpolator(ir);
+   const QuadratureInterpolator *qi =
+      fespace->GetQuadratureInterpolator(*IntRule);
    // For now, we are not using tensor product evaluation (not implemented)
    qi->DisableTensorProducts();
    qi->SetOutputLayout(QVectorLayout::byNODES);
@@ -10737,12 +10909,46 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
    {
       Vector Enodes(vdim*ND*NE);
       elem_restr->Mult(*nodes, Enodes);
-      qi->Mult(Enodes, eval_flags, X, J, detJ);
+      qi->Mult(Enodes, eval_flags, X, q_der, q_det);
    }
    else
    {
-      qi->Mult(*nodes, eval_flags, X, J, detJ);
+      qi->Mult(*nodes, eval_flags, X, q_der, q_det);
    }
+
+   if (check_affine)
+   {
+      compressed = ConstantJacobians(NQ, dim*vdim, NE, q_der);
+   }
+   if (flags & GeometricFactors::JACOBIANS)
+   {
+      if (compressed) { CompressFactors(NQ, dim*vdim, NE, q_der, J); }
+      else { J.Swap(q_der); }
+   }
+   if (flags & GeometricFactors::DETERMINANTS)
+   {
+      if (compressed) { CompressFactors(NQ, 1, NE, q_det, detJ); }
+      else { detJ.Swap(q_det); }
+   }
+   computed_factors |= flags;
+}
+
+long GeometricFactors::MemoryUsage() const
+{
+   return (X.Size() + J.Size() + detJ.Size()) * (long) sizeof(double);
+}
+
+void GeometricFactors::Release(const GeometricFactors *gf)
+{
+   if (!gf) { return; }
+   MFEM_ASSERT(gf->num_users > 0, "the factors have no users");
+   if (--gf->num_users == 0 && !gf->cached) { delete gf; }
+}
+
+void GeometricFactors::Uncache()
+{
+   if (num_users > 0) { cached = false; }
+   else { delete this; }
 }
 
 FaceGeometricFactors::FaceGeometricFactors(const Mesh *mesh,
@@ -10794,6 +11000,12 @@ FaceGeometricFactors::FaceGeometricFactors(const Mesh *mesh,
    qi->Mult(Fnodes, eval_flags, X, J, detJ, normal);
 }
 
+long FaceGeometricFactors::MemoryUsage() const
+{
+   return (X.Size() + J.Size() + detJ.Size() + normal.Size()) *
+          (long) sizeof(double);
+}
+
 NodeExtrudeCoefficient::NodeExtrudeCoefficient(const int dim, const int _n,
                                                const double _s)
    : VectorCoefficient(dim), n(_n), s(_s), tip(p, dim-1)
@@ -44,6 +44,14 @@ struct Refinement;
 /** An enum type to specify if interior or boundary faces are desired. */
 enum class FaceType : bool {Interior, Boundary};
 
+/** @brief Storage of the Jacobians and their determinants in GeometricFactors,
+    see Mesh::GetGeometricFactors(). */
+enum class GeometricFactorsStorage
+{
+   Full,       ///< Values at all quadrature points of all elements
+   Compressed  ///< One value per element when the mesh is affine
+};
+
 #ifdef MFEM_USE_MPI
 class ParMesh;
 class ParNCMesh;
@@ -205,6 +213,8 @@ public:
    Array<GeometricFactors*> geom_factors; ///< Optional geometric factors.
    Array<FaceGeometricFactors*>
    face_geom_factors; ///< Optional face geometric factors.
+   /// Maximum memory used by the geometric factors, or -1 for no limit.
+   long geom_factors_max_bytes;
 
    /// Used during initialization only.
    Array<Triple<int, int, int> > tmp_vertex_parents;
@@ -224,6 +234,11 @@ protected:
    void DeleteTables() { DestroyTables(); InitTables(); }
    void DestroyPointers(); // Delete data specifically allocated by class Mesh.
    void Destroy();         // Delete all owned data.
+
+   /// Delete the least recently used geometric factors without users, other
+   /// than @a keep, until the memory limit is satisfied.
+   void ReduceGeometricFactorsMemory(const void *keep);
+
    void ResetLazyData();
 
    Element *ReadElementWithoutAttr(std::istream &);
@@ -768,8 +783,26 @@ public:
 
    /** @brief Return the mesh geometric factors corresponding to the given
        integration rule. */
-   const GeometricFactors* GetGeometricFactors(const IntegrationRule& ir,
-                                               const int flags);
+   /** The factors are cached by the Mesh and shared by all the forms and
+       integrators using the same integration rule (compared by address) and
+       the same @a storage. When the cached object for @a ir does not contain
+       all the requested @a flags, the missing factors are computed and added
+       to it, so the returned pointers remain valid.
+
+       With GeometricFactorsStorage::Compressed, the Jacobians and their
+       determinants are stored once per element if all element transformations
+       are affine, see GeometricFactors::compressed. The two storages share
+       the cached data when possible: a compressed request may return factors
+       with the full storage, and full factors are derived from compressed
+       ones without evaluating the Jacobians again.
+
+       The returned pointer remains valid until the Mesh is destroyed or
+       DeleteGeometricFactors() is called, unless a memory limit is set with
+       SetGeometricFactorsMemoryLimit(). Users that keep the pointer beyond
+       that should register with GeometricFactors::AddUser(). */
+   const GeometricFactors* GetGeometricFactors(
+      const IntegrationRule& ir, const int flags,
+      GeometricFactorsStorage storage = GeometricFactorsStorage::Full);
 
    /** @brief Return the mesh geometric factors for the faces corresponding
         to the given integration rule. */
@@ -782,6 +815,19 @@ public:
        for example, after the mesh nodes are modified externally. */
    void DeleteGeometricFactors();
 
+   /** @brief Return the memory used by the GeometricFactors and the
+       FaceGeometricFactors stored by the Mesh, in bytes. */
+   long GetGeometricFactorsMemory() const;
+
+   /** @brief Limit the memory used by the stored GeometricFactors and
+       FaceGeometricFactors to @a max_bytes; a negative value, the default,
+       means no limit. */
+   /** When the limit is exceeded, the least recently used factors are
+       deleted, except the ones being returned and the GeometricFactors with
+       registered users, see GeometricFactors::AddUser(). The limit may
+       therefore remain exceeded. */
+   void SetGeometricFactorsMemoryLimit(long max_bytes);
+
    /// Equals 1 + num_holes - num_loops
    inline int EulerNumber() const
    { return NumOfVertices - NumOfEdges + NumOfFaces - NumOfElements; }
@@ -1409,7 +1455,43 @@ public:
       DETERMINANTS = 1 << 2,
    };
 
-   GeometricFactors(const Mesh *mesh, const IntegrationRule &ir, int flags);
+   /// The requested storage of #J and #detJ.
+   GeometricFactorsStorage storage;
+
+   /** @brief True if #J and #detJ are stored once per element, i.e. with
+       NQ = 1 in their layouts below. */
+   /** This is only the case with GeometricFactorsStorage::Compressed, when the
+       Jacobians of all element transformations are constant. The coordinates
+       #X are always stored at all quadrature points. */
+   bool compressed;
+
+   GeometricFactors(const Mesh *mesh, const IntegrationRule &ir, int flags,
+                    GeometricFactorsStorage storage =
+                       GeometricFactorsStorage::Full);
+
+   /** @brief Construct the factors in @a flags with the full storage, copying
+       or expanding the factors already computed in the compressed @a cgf. */
+   GeometricFactors(const GeometricFactors &cgf, int flags);
+
+   /// Compute the factors in @a flags that have not been computed yet.
+   void Compute(int flags);
+
+   /// Return the memory used by the stored factors, in bytes.
+   long MemoryUsage() const;
+
+   /** @brief Register a user that keeps a pointer to these factors beyond the
+       call to Mesh::GetGeometricFactors(), e.g. a PA action reading them. */
+   /** Factors with users are not deleted by the memory limit of
+       Mesh::SetGeometricFactorsMemoryLimit(). When the Mesh drops them
+       otherwise, e.g. in Mesh::DeleteGeometricFactors(), they are deleted by
+       the Release() of their last user. */
+   void AddUser() const { num_users++; }
+
+   /// Unregister a user of @a gf added with AddUser(); @a gf may be NULL.
+   static void Release(const GeometricFactors *gf);
+
+   /// Return the number of users registered with AddUser().
+   int GetNumUsers() const { return num_users; }
 
    /// Mapped (physical) coordinates of all quadrature points.
    /** This array uses a column-major layout with dimensions (NQ x SDIM x NE)
@@ -1433,6 +1515,16 @@ public:
        - NQ = number of quadrature points per element, and
        - NE = number of elements in the mesh. */
    Vector detJ;
+
+private:
+   friend class Mesh;
+
+   mutable int num_users;
+   /// False once the Mesh dropped the factors while they had users.
+   bool cached;
+
+   /// Delete the factors, or only mark them as dropped if they have users.
+   void Uncache();
 };
 
 /** @brief Structure for storing face geometric factors: coordinates, Jacobians,
@@ -1458,6 +1550,9 @@ public:
    FaceGeometricFactors(const Mesh *mesh, const IntegrationRule &ir, int flags,
                         FaceType type);
 
+   /// Return the memory used by the stored factors, in bytes.
+   long MemoryUsage() const;
+
    /// Mapped (physical) coordinates of all quadrature points.
    /** This array uses a column-major layout with dimensions (NQ x SDIM x NF)
        where
@@ -66,6 +66,8 @@
 //     mpirun -np 4 pmesh-optimizer -m blade.mesh -o 4 -rs 0 -mid 2 -tid 1 -ni 200 -ls 2 -li 100 -bnd -qt 1 -qo 8 -fd
 //   Blade limited shape:
 //     mpirun -np 4 pmesh-optimizer -m blade.mesh -o 4 -rs 0 -mid 2 -tid 1 -ni 200 -ls 2 -li 100 -bnd -qt 1 -qo 8 -lc 5000
+//   Blade limited shape with partial assembly:
+//     mpirun -np 4 pmesh-optimizer -m blade.mesh -o 4 -rs 0 -mid 2 -tid 1 -ni 200 -ls 3 -li 100 -bnd -qt 1 -qo 8 -lc 5000 -pa
 //   ICF shape and equal size:
 //     mpirun -np 4 pmesh-optimizer -o 3 -rs 0 -mid 9 -tid 2 -ni 200 -ls 2 -li 100 -bnd -qt 1 -qo 8
 //   ICF shape and initial size:
@@ -125,6 +127,7 @@ int main (int argc, char *argv[])
    bool fdscheme         = false;
    int adapt_eval        = 0;
    bool exactaction      = false;
+   bool pa               = false;
 
    // 2. Parse command-line options.
    OptionsParser args(argc, argv);
@@ -183,7 +186,8 @@ int main (int argc, char *argv[])
    args.AddOption(&solver_rtol, "-rtol", "--newton-rel-tolerance",
                   "Relative tolerance for the Newton solver.");
    args.AddOption(&lin_solver, "-ls", "--lin-solver",
-                  "Linear solver: 0 - l1-Jacobi, 1 - CG, 2 - MINRES.");
+                  "Linear solver: 0 - l1-Jacobi, 1 - CG, 2 - MINRES,"
+                  " 3 - MINRES + Jacobi preconditioner.");
    args.AddOption(&max_lin_iter, "-li", "--lin-iter",
                   "Maximum number of iterations in the linear solve.");
    args.AddOption(&move_bnd, "-bnd", "--move-boundary", "-fix-bnd",
@@ -203,6 +207,8 @@ int main (int argc, char *argv[])
    args.AddOption(&exactaction, "-ex", "--exact_action",
                   "-no-ex", "--no-exact-action",
                   "Enable exact action of TMOP_Integrator.");
+   args.AddOption(&pa, "-pa", "--partial-assembly", "-no-pa",
+                  "--no-partial-assembly", "Enable Partial Assembly.");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -703,6 +709,12 @@ int main (int argc, char *argv[])
    }
    else { a.AddDomainIntegrator(he_nlf_integ); }
 
+   if (pa)
+   {
+      a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      a.Setup();
+   }
+
    const double init_energy = a.GetParGridFunctionEnergy(x);
 
    // Visualize the starting mesh and metric values.
@@ -771,8 +783,10 @@ int main (int argc, char *argv[])
 
    // 15. As we use the Newton method to solve the resulting nonlinear system,
    //     here we setup the linear solver for the system's Jacobian.
-   Solver *S = NULL;
+   Solver *S = NULL, *S_prec = NULL;
    const double linsol_rtol = 1e-12;
+   MFEM_VERIFY(!(pa && lin_solver == 0),
+               "l1-Jacobi needs an assembled matrix, use -ls 3 with -pa.");
    if (lin_solver == 0)
    {
       S = new DSmoother(1, 1.0, max_lin_iter);
@@ -793,6 +807,19 @@ int main (int argc, char *argv[])
       minres->SetRelTol(linsol_rtol);
       minres->SetAbsTol(0.0);
       minres->SetPrintLevel(verbosity_level >= 2 ? 3 : -1);
+      if (lin_solver == 3)
+      {
+         // With PA, the diagonal of the gradient is recomputed in each
+         // SetOperator() call of the Newton solver.
+         if (pa) { S_prec = new OperatorJacobiSmoother; }
+         else
+         {
+            HypreSmoother *hs = new HypreSmoother;
+            hs->SetType(HypreSmoother::Jacobi, 1);
+            S_prec = hs;
+         }
+         minres->SetPreconditioner(*S_prec);
+      }
       S = minres;
    }
 
@@ -912,6 +939,7 @@ int main (int argc, char *argv[])
 
    // 20. Free the used memory.
    delete S;
+   delete S_prec;
    delete target_c2;
    delete metric2;
    delete coeff1;
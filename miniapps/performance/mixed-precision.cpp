@@ -0,0 +1,180 @@
+//                MFEM Mixed Precision Partial Assembly Miniapp
+//
+// Compile with: make mixed-precision
+//
+// Sample runs:  mixed-precision
+//               mixed-precision -m ../../data/fichera.mesh -r 3 -o 3
+//               mixed-precision -m ../../data/fichera.mesh -r 2 -o 6
+//               mixed-precision -m ../../data/star.mesh -r 4 -o 4
+//
+// Device sample runs:
+//               mixed-precision -d cuda
+//               mixed-precision -d cpu-simd
+//
+// Description:  This miniapp compares the partially assembled diffusion
+//               operator -div(kappa grad u), with a variable coefficient kappa,
+//               assembled with double precision quadrature data and with single
+//               precision quadrature data, see
+//               BilinearForm::EnablePAMixedPrecision(). In both cases the
+//               action is computed and accumulated in double precision.
+//
+//               The miniapp reports the throughput of the two operator actions
+//               and the relative error of the mixed precision action. It then
+//               solves the corresponding Poisson problem with CG, preconditioned
+//               by a Chebyshev smoother built from either operator, showing
+//               that the mixed precision operator does not degrade the
+//               convergence when it is only used in the preconditioner.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+double kappa_function(const Vector &x)
+{
+   return 1.0 + 0.5*sin(M_PI*x(0))*sin(M_PI*x(1));
+}
+
+// Average time of one action of the operator op, in seconds. Reading the
+// result on the host waits for the completion of the device kernels.
+double TimeMult(const Operator &op, const Vector &x, Vector &y, int nmult)
+{
+   op.Mult(x, y); // warm-up
+   y.HostRead();
+   StopWatch sw;
+   sw.Start();
+   for (int i = 0; i < nmult; i++) { op.Mult(x, y); }
+   y.HostRead();
+   sw.Stop();
+   return sw.RealTime() / nmult;
+}
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/fichera.mesh";
+   int ref_levels = 2;
+   int order = 3;
+   int nmult = 20;
+   int cheb_order = 3;
+   const char *device_config = "cpu";
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of times to refine the mesh uniformly.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&nmult, "-n", "--num-mult",
+                  "Number of operator actions used for the timings.");
+   args.AddOption(&cheb_order, "-co", "--chebyshev-order",
+                  "Order of the Chebyshev smoother.");
+   args.AddOption(&device_config, "-d", "--device",
+                  "Device configuration string, see Device::Configure().");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+
+   // 2. Enable hardware devices such as GPUs, and programming models such as
+   //    CUDA, OCCA, RAJA and OpenMP based on command line options.
+   Device device(device_config);
+   device.Print();
+
+   // 3. Read and refine the mesh, and define the H1 finite element space.
+   Mesh mesh(mesh_file, 1, 1);
+   const int dim = mesh.Dimension();
+   for (int l = 0; l < ref_levels; l++) { mesh.UniformRefinement(); }
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fespace(&mesh, &fec);
+   const int size = fespace.GetTrueVSize();
+   cout << "Number of finite element unknowns: " << size << endl;
+
+   Array<int> ess_tdof_list;
+   if (mesh.bdr_attributes.Size())
+   {
+      Array<int> ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = 1;
+      fespace.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+   }
+
+   // 4. Partially assemble the operator with double and with single precision
+   //    quadrature data. The variable coefficient keeps the quadrature data at
+   //    all quadrature points, also on affine meshes.
+   FunctionCoefficient kappa(kappa_function);
+   BilinearForm a_dp(&fespace), a_mp(&fespace);
+   a_dp.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a_mp.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a_mp.EnablePAMixedPrecision();
+   a_dp.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+   a_mp.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+   a_dp.Assemble();
+   a_mp.Assemble();
+
+   // 5. Compare the throughput and the accuracy of the two actions.
+   GridFunction x(&fespace), y_dp(&fespace), y_mp(&fespace);
+   x.Randomize(1);
+   const double t_dp = TimeMult(a_dp, x, y_dp, nmult);
+   const double t_mp = TimeMult(a_mp, x, y_mp, nmult);
+   const double nrm = sqrt(InnerProduct(y_dp, y_dp));
+   y_mp -= y_dp;
+   const double rel_err = sqrt(InnerProduct(y_mp, y_mp)) / nrm;
+   const int vsize = fespace.GetVSize();
+   cout << "\nOperator action:\n"
+        << "   double precision data: " << 1e3*t_dp << " ms, "
+        << 1e-6*vsize/t_dp << " MDOF/s\n"
+        << "   single precision data: " << 1e3*t_mp << " ms, "
+        << 1e-6*vsize/t_mp << " MDOF/s\n"
+        << "   speedup:               " << t_dp/t_mp << "\n"
+        << "   relative error:        " << rel_err << endl;
+
+   // 6. Solve the Poisson problem with the double precision operator, using
+   //    Chebyshev smoothers built from the double and the mixed precision
+   //    operators as preconditioners.
+   LinearForm b(&fespace);
+   ConstantCoefficient one(1.0);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+
+   OperatorPtr A, A_dp, A_mp;
+   Vector X, B;
+   x = 0.0;
+   a_dp.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+   a_dp.FormSystemMatrix(ess_tdof_list, A_dp);
+   a_mp.FormSystemMatrix(ess_tdof_list, A_mp);
+
+   const char *names[2] = { "double", "single" };
+   BilinearForm *forms[2] = { &a_dp, &a_mp };
+   Operator *ops[2] = { A_dp.Ptr(), A_mp.Ptr() };
+   cout << "\nCG with a Chebyshev smoother of order " << cheb_order << ":\n";
+   for (int k = 0; k < 2; k++)
+   {
+      Vector diag(size);
+      forms[k]->AssembleDiagonal(diag);
+      OperatorChebyshevSmoother smoother(ops[k], diag, ess_tdof_list,
+                                         cheb_order);
+      CGSolver cg;
+      cg.SetRelTol(1e-8);
+      cg.SetMaxIter(1000);
+      cg.SetPrintLevel(0);
+      cg.SetOperator(*A);
+      cg.SetPreconditioner(smoother);
+      X = 0.0;
+      StopWatch sw;
+      sw.Start();
+      cg.Mult(B, X);
+      X.HostRead();
+      sw.Stop();
+      cout << "   " << names[k] << " precision smoother: "
+           << cg.GetNumIterations() << " iterations, " << sw.RealTime()
+           << " s, converged: " << (cg.GetConverged() ? "yes" : "no") << endl;
+   }
+
+   return 0;
+}
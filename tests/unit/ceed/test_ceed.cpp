@@ -185,4 +185,60 @@ TEST_CASE("CEED", "[CEED]")
    test_ceed_operator(mesh, order, coeff_type, pb, assembly);
 } // test case
 
+void test_ceed_interior_penalty(const char* input, int order)
+{
+   std::string section = "order: " + std::to_string(order) + "\n" +
+                         "mesh: " + input;
+   INFO(section);
+   Mesh mesh(input, 1, 1);
+   mesh.EnsureNodes();
+   int dim = mesh.Dimension();
+
+   // The libCEED domain integrator and the face integrators of the IP-DG
+   // operator, all matrix-free
+   L2_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+   ConstantCoefficient coeff(2.0);
+   const double sigma = -1.0, kappa = (order+1)*(order+1);
+
+   BilinearForm k_test(&fes);
+   BilinearForm k_ref(&fes);
+   BilinearForm *forms[2] = { &k_test, &k_ref };
+   for (int i = 0; i < 2; ++i)
+   {
+      forms[i]->AddDomainIntegrator(new DiffusionIntegrator(coeff));
+      forms[i]->AddInteriorFaceIntegrator(
+         new DGDiffusionIntegrator(coeff, sigma, kappa));
+      forms[i]->AddBdrFaceIntegrator(
+         new DGDiffusionIntegrator(coeff, sigma, kappa));
+   }
+   k_ref.Assemble();
+   k_ref.Finalize();
+
+   k_test.SetAssemblyLevel(AssemblyLevel::NONE);
+   k_test.Assemble();
+
+   GridFunction x(&fes), y_ref(&fes), y_test(&fes);
+   x.Randomize(1);
+   k_ref.Mult(x,y_ref);
+   k_test.Mult(x,y_test);
+   y_test -= y_ref;
+   REQUIRE(y_test.Norml2() < 1.e-12*y_ref.Norml2());
+
+   Vector diag_ref(fes.GetVSize()), diag_test(fes.GetVSize());
+   k_ref.SpMat().GetDiag(diag_ref);
+   k_test.AssembleDiagonal(diag_test);
+   diag_test -= diag_ref;
+   REQUIRE(diag_test.Normlinf() < 1.e-12*diag_ref.Normlinf());
+}
+
+TEST_CASE("CEED Interior Penalty", "[CEED]")
+{
+   auto order = GENERATE(1,2,3);
+   auto mesh = GENERATE("../../data/inline-quad.mesh",
+                        "../../data/star-q2.mesh",
+                        "../../data/inline-hex.mesh");
+   test_ceed_interior_penalty(mesh, order);
+} // test case
+
 } // namespace ceed_test
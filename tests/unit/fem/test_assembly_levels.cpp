@@ -147,4 +147,169 @@ TEST_CASE("Assembly Levels", "[AssemblyLevel], [PartialAssembly]")
    }
 } // test case
 
+double dg_coeff_function(const Vector &x)
+{
+   return 1.0 + x(0)*x(0);
+}
+
+BilinearFormIntegrator *InteriorPenaltyIntegrator(Coefficient &q,
+                                                  Coefficient &lambda,
+                                                  Coefficient &mu,
+                                                  bool elasticity, double s)
+{
+   const double kappa = 5.0;
+   if (elasticity)
+   {
+      return new DGElasticityIntegrator(lambda, mu, s, kappa);
+   }
+   return new DGDiffusionIntegrator(q, s, kappa);
+}
+
+void test_interior_penalty(const char *meshname, int order, bool elasticity,
+                           const AssemblyLevel assembly)
+{
+   INFO("mesh=" << meshname << ", order=" << order << ", elasticity="
+        << elasticity << ", assembly=" << int(assembly));
+   Mesh mesh(meshname, 1, 1);
+   mesh.EnsureNodes();
+   int dim = mesh.Dimension();
+
+   L2_FECollection fec(order, dim);
+   FiniteElementSpace fespace(&mesh, &fec, elasticity ? dim : 1);
+
+   // The MF face actions support only constant coefficients, the MF domain
+   // integrators require libCEED and ElasticityIntegrator has no PA
+   const bool mf = (assembly == AssemblyLevel::NONE);
+   FunctionCoefficient f_coeff(dg_coeff_function);
+   ConstantCoefficient c_coeff(2.0), one(1.0);
+   Coefficient &q = mf ? static_cast<Coefficient&>(c_coeff) : f_coeff;
+
+   BilinearForm k_test(&fespace);
+   BilinearForm k_ref(&fespace);
+   BilinearForm k_int_ref(&fespace);
+   if (!mf && !elasticity)
+   {
+      k_ref.AddDomainIntegrator(new DiffusionIntegrator(q));
+      k_test.AddDomainIntegrator(new DiffusionIntegrator(q));
+   }
+   BilinearFormIntegrator *int_test =
+      InteriorPenaltyIntegrator(q, one, q, elasticity, 0.5);
+   k_test.AddInteriorFaceIntegrator(int_test);
+   k_test.AddBdrFaceIntegrator(
+      InteriorPenaltyIntegrator(q, one, q, elasticity, -1.0));
+   k_ref.AddInteriorFaceIntegrator(
+      InteriorPenaltyIntegrator(q, one, q, elasticity, 0.5));
+   k_ref.AddBdrFaceIntegrator(
+      InteriorPenaltyIntegrator(q, one, q, elasticity, -1.0));
+   k_int_ref.AddInteriorFaceIntegrator(
+      InteriorPenaltyIntegrator(q, one, q, elasticity, 0.5));
+
+   k_ref.Assemble();
+   k_ref.Finalize();
+   k_int_ref.Assemble();
+   k_int_ref.Finalize();
+
+   k_test.SetAssemblyLevel(assembly);
+   k_test.Assemble();
+
+   GridFunction x(&fespace), y_ref(&fespace), y_test(&fespace);
+
+   x.Randomize(1);
+
+   k_ref.Mult(x,y_ref);
+   k_test.Mult(x,y_test);
+   y_test -= y_ref;
+   REQUIRE(y_test.Norml2() < 1.e-12*y_ref.Norml2());
+
+   // Diagonal, including the face terms
+   Vector diag_ref(fespace.GetVSize()), diag_test(fespace.GetVSize());
+   k_ref.SpMat().GetDiag(diag_ref);
+   k_test.AssembleDiagonal(diag_test);
+   diag_test -= diag_ref;
+   REQUIRE(diag_test.Normlinf() < 1.e-12*diag_ref.Normlinf());
+
+   // Transpose action of the non-symmetric interior face integrator
+   const Operator *R = fespace.GetElementRestriction(
+                          ElementDofOrdering::LEXICOGRAPHIC);
+   Vector xe(R->Height()), ye(R->Height());
+   R->Mult(x, xe);
+   ye = 0.0;
+   if (mf) { int_test->AddMultTransposeMF(xe, ye); }
+   else { int_test->AddMultTransposePA(xe, ye); }
+   R->MultTranspose(ye, y_test);
+   k_int_ref.MultTranspose(x, y_ref);
+   y_test -= y_ref;
+   REQUIRE(y_test.Norml2() < 1.e-12*y_ref.Norml2());
+}
+
+TEST_CASE("Interior Penalty Assembly Levels",
+          "[AssemblyLevel], [PartialAssembly]")
+{
+   auto assembly = GENERATE(AssemblyLevel::PARTIAL, AssemblyLevel::NONE);
+   auto elasticity = GENERATE(false, true);
+   auto order_2d = GENERATE(1, 2, 3);
+   auto order_3d = GENERATE(1, 2);
+
+   SECTION("2D")
+   {
+      test_interior_penalty("../../data/periodic-square.mesh",
+                            order_2d, elasticity, assembly);
+      test_interior_penalty("../../data/star-q3.mesh",
+                            order_2d, elasticity, assembly);
+   }
+
+   SECTION("3D")
+   {
+      test_interior_penalty("../../data/periodic-cube.mesh",
+                            order_3d, elasticity, assembly);
+      test_interior_penalty("../../data/fichera-q3.mesh",
+                            order_3d, elasticity, assembly);
+   }
+} // test case
+
+void dg_matrix_coeff_function(const Vector &x, DenseMatrix &m)
+{
+   const int dim = x.Size();
+   m.Diag(1.0 + x(0)*x(0), dim);
+   m(0,1) = 0.2*x(1);
+   m(1,0) = 0.1;
+}
+
+TEST_CASE("Interior Penalty Matrix Coefficient",
+          "[AssemblyLevel], [PartialAssembly]")
+{
+   const char *meshname = GENERATE("../../data/star-q3.mesh",
+                                   "../../data/fichera-q3.mesh");
+   const int order = 2;
+   CAPTURE(meshname);
+   Mesh mesh(meshname, 1, 1);
+   const int dim = mesh.Dimension();
+   L2_FECollection fec(order, dim);
+   FiniteElementSpace fespace(&mesh, &fec);
+   MatrixFunctionCoefficient mq(dim, dg_matrix_coeff_function);
+
+   BilinearForm k_test(&fespace), k_ref(&fespace);
+   k_test.AddInteriorFaceIntegrator(new DGDiffusionIntegrator(mq, 0.5, 5.0));
+   k_test.AddBdrFaceIntegrator(new DGDiffusionIntegrator(mq, -1.0, 5.0));
+   k_ref.AddInteriorFaceIntegrator(new DGDiffusionIntegrator(mq, 0.5, 5.0));
+   k_ref.AddBdrFaceIntegrator(new DGDiffusionIntegrator(mq, -1.0, 5.0));
+   k_ref.Assemble();
+   k_ref.Finalize();
+   k_test.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   k_test.Assemble();
+
+   GridFunction x(&fespace), y_ref(&fespace), y_test(&fespace);
+   x.Randomize(1);
+   k_ref.Mult(x, y_ref);
+   k_test.Mult(x, y_test);
+   y_test -= y_ref;
+   REQUIRE(y_test.Norml2() < 1.e-12*y_ref.Norml2());
+
+   Vector diag_ref(fespace.GetVSize()), diag_test(fespace.GetVSize());
+   k_ref.SpMat().GetDiag(diag_ref);
+   k_test.AssembleDiagonal(diag_test);
+   diag_test -= diag_ref;
+   REQUIRE(diag_test.Normlinf() < 1.e-12*diag_ref.Normlinf());
+}
+
 } // namespace pa_kernels
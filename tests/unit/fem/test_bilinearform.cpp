@@ -65,3 +65,283 @@ TEST_CASE("Test order of boundary integrators",
       delete D;
    }
 }
+
+static double coeff_function(const Vector &x)
+{
+   return 1.0 + x(0)*x(0) + 0.5*x(1);
+}
+
+// Add integrators of the given space type to the bilinear form a. The types are
+// 0: scalar H1, 1: vector H1, 2: ND, 3: L2 with DG face integrators.
+static void AddThreadedTestIntegrators(int type, Coefficient &q,
+                                       BilinearForm &a)
+{
+   switch (type)
+   {
+      case 0:
+         a.AddDomainIntegrator(new DiffusionIntegrator(q));
+         a.AddDomainIntegrator(new MassIntegrator);
+         a.AddBoundaryIntegrator(new MassIntegrator(q));
+         break;
+      case 1:
+         a.AddDomainIntegrator(new ElasticityIntegrator(q, q));
+         a.AddBoundaryIntegrator(new VectorMassIntegrator);
+         break;
+      case 2:
+         a.AddDomainIntegrator(new CurlCurlIntegrator(q));
+         a.AddDomainIntegrator(new VectorFEMassIntegrator);
+         break;
+      case 3:
+         a.AddDomainIntegrator(new DiffusionIntegrator(q));
+         a.AddInteriorFaceIntegrator(new DGDiffusionIntegrator(q, -1.0, 2.0));
+         a.AddBdrFaceIntegrator(new DGDiffusionIntegrator(q, -1.0, 2.0));
+         break;
+   }
+}
+
+TEST_CASE("Threaded assembly", "[BilinearForm]")
+{
+   const int type = GENERATE(0, 1, 2, 3);
+   const int dim = GENERATE(2, 3);
+   CAPTURE(type, dim);
+
+   Mesh *mesh = (dim == 2) ? new Mesh(3, 4, Element::QUADRILATERAL, true) :
+                new Mesh(2, 2, 3, Element::HEXAHEDRON, true);
+   FiniteElementCollection *fec;
+   switch (type)
+   {
+      case 0: case 1: fec = new H1_FECollection(2, dim); break;
+      case 2: fec = new ND_FECollection(2, dim); break;
+      default: fec = new L2_FECollection(2, dim); break;
+   }
+   const int vdim = (type == 1) ? dim : 1;
+   FiniteElementSpace fes(mesh, fec, vdim, Ordering::byVDIM);
+   FunctionCoefficient q(coeff_function);
+
+   BilinearForm a_legacy(&fes), a_threaded(&fes);
+   AddThreadedTestIntegrators(type, q, a_legacy);
+   AddThreadedTestIntegrators(type, q, a_threaded);
+   a_threaded.EnableThreadedAssembly();
+   REQUIRE(a_threaded.ThreadedAssemblyIsEnabled());
+   a_legacy.Assemble(0);
+   a_legacy.Finalize(0);
+   a_threaded.Assemble();
+   // The symbolic pass of AllocMat() gives a finalized matrix before
+   // Finalize() is called.
+   REQUIRE(a_threaded.SpMat().Finalized());
+   a_threaded.Finalize();
+
+   const SparseMatrix &A_legacy = a_legacy.SpMat();
+   const SparseMatrix &A_threaded = a_threaded.SpMat();
+   REQUIRE(A_threaded.ColumnsAreSorted());
+   REQUIRE(A_threaded.NumNonZeroElems() >= A_legacy.NumNonZeroElems());
+
+   SparseMatrix *D = Add(1.0, A_legacy, -1.0, A_threaded);
+   REQUIRE(D->MaxNorm() <= 1e-12*A_legacy.MaxNorm());
+   delete D;
+
+   // Assembling again adds the element matrices to the same pattern.
+   a_threaded.Assemble();
+   D = Add(2.0, A_legacy, -1.0, A_threaded);
+   REQUIRE(D->MaxNorm() <= 1e-12*A_legacy.MaxNorm());
+   delete D;
+
+   delete fec;
+   delete mesh;
+}
+
+// Exposes the element coloring of the threaded assembly.
+class ColoringTestForm : public BilinearForm
+{
+public:
+   ColoringTestForm(FiniteElementSpace *f) : BilinearForm(f) { }
+   const Table &Coloring() { return GetElementColoring(); }
+};
+
+TEST_CASE("Threaded assembly coloring", "[BilinearForm]")
+{
+   const int order = GENERATE(1, 3);
+   const bool tri = GENERATE(false, true);
+   CAPTURE(order, tri);
+
+   Mesh mesh(5, 4, tri ? Element::TRIANGLE : Element::QUADRILATERAL, true);
+   H1_FECollection fec(order, 2);
+   FiniteElementSpace fes(&mesh, &fec, 2);
+
+   ColoringTestForm a(&fes);
+   const Table &coloring = a.Coloring();
+   REQUIRE(&a.Coloring() == &coloring);
+   // Neighboring elements need different colors.
+   REQUIRE(coloring.Size() > 1);
+
+   // Each element has exactly one color, and the elements of one color have
+   // no common DOF.
+   Array<int> num_colors(fes.GetNE()), dof_marker(fes.GetNDofs());
+   num_colors = 0;
+   Array<int> dofs;
+   for (int c = 0; c < coloring.Size(); c++)
+   {
+      dof_marker = -1;
+      for (int k = 0; k < coloring.RowSize(c); k++)
+      {
+         const int e = coloring.GetRow(c)[k];
+         num_colors[e]++;
+         fes.GetElementDofs(e, dofs);
+         for (int j = 0; j < dofs.Size(); j++)
+         {
+            REQUIRE(dof_marker[dofs[j]] != c);
+            dof_marker[dofs[j]] = c;
+         }
+      }
+   }
+   for (int e = 0; e < fes.GetNE(); e++) { REQUIRE(num_colors[e] == 1); }
+}
+
+TEST_CASE("Sparsity reuse", "[BilinearForm]")
+{
+   const bool nonconforming = GENERATE(false, true);
+   CAPTURE(nonconforming);
+
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   if (nonconforming)
+   {
+      Array<int> refs;
+      refs.Append(0);
+      refs.Append(5);
+      mesh.GeneralRefinement(refs, 1);
+   }
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient kappa(1.0);
+   BilinearForm a(&fes);
+   a.EnableSparsityReuse();
+   REQUIRE(a.SparsityReuseIsEnabled());
+   a.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+   a.AddDomainIntegrator(new MassIntegrator);
+
+   GridFunction x(&fes);
+   LinearForm b(&fes);
+   const int *I = NULL, *J = NULL, *I_e = NULL;
+   for (int it = 0; it < 3; it++)
+   {
+      kappa.constant = 1.0 + it;
+      x = 1.0;
+      b = 1.0;
+      a.Assemble();
+      OperatorPtr A;
+      Vector X, B;
+      a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+      const SparseMatrix &A_reuse = a.SpMat();
+      if (!nonconforming)
+      {
+         // The pattern of the matrix is kept in the following assemblies.
+         if (it == 0)
+         {
+            I = A_reuse.GetI();
+            J = A_reuse.GetJ();
+            I_e = a.SpMatElim().GetI();
+         }
+         REQUIRE(A_reuse.GetI() == I);
+         REQUIRE(A_reuse.GetJ() == J);
+         REQUIRE(a.SpMatElim().GetI() == I_e);
+      }
+
+      // Reference: a new bilinear form with the same coefficient.
+      BilinearForm a_ref(&fes);
+      a_ref.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+      a_ref.AddDomainIntegrator(new MassIntegrator);
+      a_ref.Assemble();
+      OperatorPtr A_ref;
+      Vector X_ref, B_ref;
+      GridFunction x_ref(&fes);
+      LinearForm b_ref(&fes);
+      x_ref = 1.0;
+      b_ref = 1.0;
+      a_ref.FormLinearSystem(ess_tdof_list, x_ref, b_ref, A_ref, X_ref, B_ref);
+
+      SparseMatrix *D = Add(1.0, A_reuse, -1.0, a_ref.SpMat());
+      REQUIRE(D->MaxNorm() <= 1e-12*a_ref.SpMat().MaxNorm());
+      delete D;
+      D = Add(1.0, a.SpMatElim(), -1.0, a_ref.SpMatElim());
+      REQUIRE(D->MaxNorm() <= 1e-12*a_ref.SpMat().MaxNorm());
+      delete D;
+      B -= B_ref;
+      REQUIRE(B.Normlinf() <= 1e-12*B_ref.Normlinf());
+   }
+}
+
+#ifdef MFEM_USE_MPI
+
+TEST_CASE("Parallel sparsity reuse", "[BilinearForm][Parallel]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+   H1_FECollection fec(2, 2);
+   ParFiniteElementSpace fes(&pmesh, &fec);
+   Array<int> ess_tdof_list, ess_bdr(pmesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient kappa(1.0);
+   ParBilinearForm a(&fes);
+   a.EnableSparsityReuse();
+   a.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+   a.AddDomainIntegrator(new MassIntegrator);
+   a.Assemble();
+
+   ParGridFunction x(&fes);
+   ParLinearForm b(&fes);
+   x = 0.0;
+   b = 1.0;
+   OperatorPtr A1, A2;
+   Vector X1, B1, X2, B2;
+   a.FormLinearSystem(ess_tdof_list, x, b, A1, X1, B1);
+
+   // Without a new Assemble(), e.g. when only the right-hand side changes, the
+   // parallel matrix is not re-formed and the first operator stays valid.
+   b = 2.0;
+   a.FormLinearSystem(ess_tdof_list, x, b, A2, X2, B2);
+   REQUIRE(A2.Ptr() == A1.Ptr());
+
+   CGSolver cg(MPI_COMM_WORLD);
+   cg.SetRelTol(1e-12);
+   cg.SetMaxIter(500);
+   cg.SetOperator(*A1);
+   cg.Mult(B2, X2);
+   REQUIRE(cg.GetConverged());
+   Vector R(X2.Size());
+   A1->Mult(X2, R);
+   R -= B2;
+   REQUIRE(sqrt(InnerProduct(MPI_COMM_WORLD, R, R)) <=
+           1e-10*sqrt(InnerProduct(MPI_COMM_WORLD, B2, B2)));
+
+   // After a new Assemble(), the parallel matrix is re-formed with the new
+   // coefficient.
+   kappa.constant = 2.0;
+   a.Assemble();
+   OperatorPtr A3;
+   Vector X3, B3;
+   a.FormLinearSystem(ess_tdof_list, x, b, A3, X3, B3);
+
+   ParBilinearForm a_ref(&fes);
+   a_ref.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+   a_ref.AddDomainIntegrator(new MassIntegrator);
+   a_ref.Assemble();
+   OperatorPtr A_ref;
+   Vector X_ref, B_ref;
+   a_ref.FormLinearSystem(ess_tdof_list, x, b, A_ref, X_ref, B_ref);
+
+   Vector V(X3.Size()), AV(X3.Size()), AV_ref(X3.Size());
+   V.Randomize(1);
+   A3->Mult(V, AV);
+   A_ref->Mult(V, AV_ref);
+   AV -= AV_ref;
+   REQUIRE(sqrt(InnerProduct(MPI_COMM_WORLD, AV, AV)) <=
+           1e-12*sqrt(InnerProduct(MPI_COMM_WORLD, AV_ref, AV_ref)));
+}
+
+#endif // MFEM_USE_MPI
@@ -0,0 +1,138 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace coefficient_project
+{
+
+double f_func(const Vector &x, double t)
+{
+   double f = 2.0 + x(0)*x(1) + sin(t*x(1));
+   if (x.Size() == 3) { f += x(2)*x(2); }
+   return f;
+}
+
+void fvec_func(const Vector &x, Vector &f)
+{
+   for (int c = 0; c < f.Size(); c++) { f(c) = (c+1.0)*x(0) - x(c)*x(c); }
+}
+
+double transform2(double a, double b) { return a*b + 1.0; }
+
+// Compare the batched projection of a scalar Coefficient with the point-wise
+// evaluation of the base class.
+static void CheckProject(Coefficient &c, QuadratureSpace &qs)
+{
+   QuadratureFunction qf(&qs), qf_ref(&qs);
+   c.Project(qf);
+   c.Coefficient::Project(qf_ref);
+   qf -= qf_ref;
+   REQUIRE(qf.Normlinf() < 1e-12 * std::max(qf_ref.Normlinf(), 1.0));
+}
+
+// Compare the batched projection of a VectorCoefficient with the point-wise
+// evaluation of the base class.
+static void CheckProject(VectorCoefficient &c, QuadratureSpace &qs)
+{
+   QuadratureFunction qf(&qs, c.GetVDim()), qf_ref(&qs, c.GetVDim());
+   c.Project(qf);
+   c.VectorCoefficient::Project(qf_ref);
+   qf -= qf_ref;
+   REQUIRE(qf.Normlinf() < 1e-12 * std::max(qf_ref.Normlinf(), 1.0));
+}
+
+static void test_project(const char *meshname, int order)
+{
+   INFO("mesh=" << meshname << ", order=" << order);
+   Mesh mesh(meshname, 1, 1);
+   const int dim = mesh.Dimension();
+   for (int e = 0; e < mesh.GetNE(); e++) { mesh.SetAttribute(e, 1 + e%3); }
+   mesh.SetAttributes();
+
+   QuadratureSpace qs(&mesh, 2*order + 1);
+
+   FunctionCoefficient f(f_func);
+   f.SetTime(0.5);
+   ConstantCoefficient two(2.0);
+   Vector pw_values(3);
+   pw_values(0) = 1.0; pw_values(1) = -2.0; pw_values(2) = 3.0;
+   PWConstCoefficient pw(pw_values);
+
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+   FiniteElementSpace vfes(&mesh, &fec, dim);
+   GridFunction x(&fes), vx(&vfes);
+   x.ProjectCoefficient(f);
+   VectorFunctionCoefficient fvec(dim, fvec_func);
+   vx.ProjectCoefficient(fvec);
+   GridFunctionCoefficient x_coeff(&x);
+   GridFunctionCoefficient vx_coeff(&vx, dim);
+
+   CheckProject(two, qs);
+   CheckProject(pw, qs);
+   CheckProject(f, qs);
+   CheckProject(x_coeff, qs);
+   CheckProject(vx_coeff, qs);
+
+   SumCoefficient sum(f, x_coeff, 2.0, -1.0);
+   SumCoefficient sum_const(1.5, pw, 2.0, 3.0);
+   ProductCoefficient prod(f, pw);
+   ProductCoefficient prod_const(-2.0, x_coeff);
+   RatioCoefficient ratio(pw, f);
+   RatioCoefficient ratio_const_a(2.0, f);
+   RatioCoefficient ratio_const_b(x_coeff, 4.0);
+   PowerCoefficient power(f, 1.5);
+   TransformedCoefficient transformed(&f, &pw, transform2);
+   CheckProject(sum, qs);
+   CheckProject(sum_const, qs);
+   CheckProject(prod, qs);
+   CheckProject(prod_const, qs);
+   CheckProject(ratio, qs);
+   CheckProject(ratio_const_a, qs);
+   CheckProject(ratio_const_b, qs);
+   CheckProject(power, qs);
+   CheckProject(transformed, qs);
+
+   Vector v(dim);
+   v.Randomize(1);
+   VectorConstantCoefficient vconst(v);
+   VectorFunctionCoefficient fvec_scaled(dim, fvec_func, &pw);
+   VectorGridFunctionCoefficient vx_vcoeff(&vx);
+   CheckProject(vconst, qs);
+   CheckProject(fvec, qs);
+   CheckProject(fvec_scaled, qs);
+   CheckProject(vx_vcoeff, qs);
+}
+
+TEST_CASE("Coefficient Project", "[Coefficient]")
+{
+   const auto order = GENERATE(1, 2, 3);
+
+   SECTION("2D")
+   {
+      test_project("../../data/inline-quad.mesh", order);
+      test_project("../../data/star-q3.mesh", order);
+      test_project("../../data/star-mixed.mesh", order);
+   }
+
+   SECTION("3D")
+   {
+      test_project("../../data/inline-hex.mesh", order);
+      test_project("../../data/fichera-q3.mesh", order);
+      test_project("../../data/fichera-mixed.mesh", order);
+   }
+} // test case
+
+} // namespace coefficient_project
@@ -0,0 +1,151 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace gridfunc_errors
+{
+
+double u_func(const Vector &x)
+{
+   double u = sin(3.0*x(0)) + x(1)*x(1);
+   if (x.Size() == 3) { u += x(0)*x(2); }
+   return u;
+}
+
+void uvec_func(const Vector &x, Vector &u)
+{
+   for (int c = 0; c < u.Size(); c++) { u(c) = (c+1.0)*u_func(x) - x(c); }
+}
+
+double w_func(const Vector &x) { return 1.0 + x(0)*x(0); }
+
+void wvec_func(const Vector &x, Vector &w)
+{
+   for (int c = 0; c < w.Size(); c++) { w(c) = 1.0 + c*x(1); }
+}
+
+void w1vec_func(const Vector &x, Vector &w) { w(0) = 2.0 + x(0)*x(1); }
+
+static bool Close(double a, double b)
+{
+   return std::abs(a - b) <= 1e-12 * std::max(std::abs(b), 1.0);
+}
+
+static bool Close(const Vector &a, const Vector &b)
+{
+   Vector d(a);
+   d -= b;
+   return d.Normlinf() <= 1e-12 * std::max(b.Normlinf(), 1.0);
+}
+
+static void test_errors(const char *meshname, int order)
+{
+   INFO("mesh=" << meshname << ", order=" << order);
+   Mesh mesh(meshname, 1, 1);
+   const int dim = mesh.Dimension();
+   const int NE = mesh.GetNE();
+
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+   FiniteElementSpace vfes(&mesh, &fec, dim);
+   FiniteElementSpace vfes1(&mesh, &fec, 1);
+
+   FunctionCoefficient u(u_func), w(w_func);
+   VectorFunctionCoefficient uvec(dim, uvec_func), wvec(dim, wvec_func);
+   VectorFunctionCoefficient uvec1(1, uvec_func), wvec1(1, w1vec_func);
+   GridFunction x(&fes), vx(&vfes), vx1(&vfes1);
+   x.ProjectCoefficient(u);
+   vx.ProjectCoefficient(uvec);
+   vx1.ProjectCoefficient(uvec1);
+
+   // Copies of the default rules are not recognized by the batched evaluation,
+   // which gives the element-by-element reference results.
+   IntegrationRule ir_copy[Geometry::NumGeom];
+   const IntegrationRule *irs[Geometry::NumGeom], *irs_ref[Geometry::NumGeom];
+   for (int g = 0; g < Geometry::NumGeom; g++)
+   {
+      irs[g] = irs_ref[g] = NULL;
+      if (Geometry::Dimension[g] != dim) { continue; }
+      irs[g] = &IntRules.Get(g, 2*order + 3);
+      ir_copy[g] = *irs[g];
+      irs_ref[g] = &ir_copy[g];
+   }
+
+   Vector err(NE), err_ref(NE), err_one_pass;
+   const double ps[3] = { 1.0, 2.0, infinity() };
+   for (int k = 0; k < 3; k++)
+   {
+      const double p = ps[k];
+      INFO("p=" << p);
+
+      REQUIRE(Close(x.ComputeLpError(p, u, &w),
+                    x.ComputeLpError(p, u, &w, irs_ref)));
+      REQUIRE(Close(x.ComputeLpError(p, u, NULL, irs),
+                    x.ComputeLpError(p, u, NULL, irs_ref)));
+      x.ComputeElementLpErrors(p, u, err, &w);
+      x.ComputeElementLpErrors(p, u, err_ref, &w, irs_ref);
+      REQUIRE(Close(err, err_ref));
+      const double e = x.ComputeLpError(p, u, err_one_pass, &w);
+      REQUIRE(Close(err_one_pass, err_ref));
+      REQUIRE(Close(e, x.ComputeLpError(p, u, &w, irs_ref)));
+
+      REQUIRE(Close(vx.ComputeLpError(p, uvec),
+                    vx.ComputeLpError(p, uvec, NULL, NULL, irs_ref)));
+      REQUIRE(Close(vx.ComputeLpError(p, uvec, &w, &wvec),
+                    vx.ComputeLpError(p, uvec, &w, &wvec, irs_ref)));
+      vx.ComputeElementLpErrors(p, uvec, err);
+      vx.ComputeElementLpErrors(p, uvec, err_ref, NULL, NULL, irs_ref);
+      REQUIRE(Close(err, err_ref));
+      const double ve = vx.ComputeLpError(p, uvec, err_one_pass);
+      REQUIRE(Close(err_one_pass, err_ref));
+      REQUIRE(Close(ve, vx.ComputeLpError(p, uvec, NULL, NULL, irs_ref)));
+
+      // With one vector component, the error is still weighted by v_weight
+      const double e1 = vx1.ComputeLpError(p, uvec1, NULL, &wvec1);
+      REQUIRE(Close(e1, vx1.ComputeLpError(p, uvec1, NULL, &wvec1, irs_ref)));
+      REQUIRE(e1 > 1.5*vx1.ComputeLpError(p, uvec1));
+   }
+
+   REQUIRE(Close(x.ComputeL2Error(u), x.ComputeL2Error(u, irs_ref)));
+   REQUIRE(Close(vx.ComputeL2Error(uvec), vx.ComputeL2Error(uvec, irs_ref)));
+   x.ComputeElementL2Errors(u, err);
+   x.ComputeElementL2Errors(u, err_ref, irs_ref);
+   REQUIRE(Close(err, err_ref));
+
+   // The element-by-element fallback also provides the one-pass version
+   const double e_ref = x.ComputeLpError(2.0, u, err_one_pass, NULL, irs_ref);
+   REQUIRE(Close(err_one_pass, err_ref));
+   REQUIRE(Close(e_ref, x.ComputeL2Error(u)));
+}
+
+TEST_CASE("GridFunction Lp Errors", "[GridFunction]")
+{
+   const auto order = GENERATE(1, 2, 3);
+
+   SECTION("2D")
+   {
+      test_errors("../../data/inline-quad.mesh", order);
+      test_errors("../../data/star-q3.mesh", order);
+      test_errors("../../data/star-mixed.mesh", order);
+   }
+
+   SECTION("3D")
+   {
+      test_errors("../../data/inline-hex.mesh", order);
+      test_errors("../../data/fichera-q3.mesh", order);
+   }
+} // test case
+
+} // namespace gridfunc_errors
@@ -198,4 +198,45 @@ TEST_CASE("Simplex integration rules", "[SimplexRules]")
          }
       }
    }
+
+   SECTION("collapsed triangle and tet rules integrate monomials of degree "
+           "<= order exactly")
+   {
+      for (int order = 0; order <= 12; order++)
+      {
+         const IntegrationRule &tri =
+            IntRules.GetCollapsed(Geometry::TRIANGLE, order);
+         const IntegrationRule &tet =
+            IntRules.GetCollapsed(Geometry::TETRAHEDRON, order);
+         for (int p = 0; p <= order; p++)
+         {
+            for (int l = p; l >= 0; l--)
+            {
+               double integral = 0.0;
+               for (int i = 0; i < tri.GetNPoints(); i++)
+               {
+                  const IntegrationPoint &ip = tri.IntPoint(i);
+                  integral += ip.weight*poly2d(ip, l, p - l);
+               }
+               double exact = 1.0/binom[p][l]/(p + 1)/(p + 2);
+               INFO("order=" << order << ", p=" << p << ", l=" << l);
+               REQUIRE(fabs(1. - integral/exact) < 1e-11);
+
+               for (int m = p - l; m >= 0; m--)
+               {
+                  int n = p - l - m;
+                  integral = 0.0;
+                  for (int i = 0; i < tet.GetNPoints(); i++)
+                  {
+                     const IntegrationPoint &ip = tet.IntPoint(i);
+                     integral += ip.weight*poly3d(ip, l, m, n);
+                  }
+                  exact = 1.0/binom[p][l+m]/binom[l+m][l]/(p+1)/(p+2)/(p+3);
+                  INFO("m=" << m << ", n=" << n);
+                  REQUIRE(fabs(1. - integral/exact) < 1e-11);
+               }
+            }
+         }
+      }
+   }
 }
@@ -0,0 +1,166 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace linearform_ext
+{
+
+double f_func(const Vector &x)
+{
+   double f = 1.0 + x(0)*x(0) + sin(2.0*x(1));
+   if (x.Size() == 3) { f += cos(x(2)); }
+   return f;
+}
+
+void fvec_func(const Vector &x, Vector &f)
+{
+   for (int c = 0; c < f.Size(); c++) { f(c) = (c+1.0)*f_func(x) + x(c); }
+}
+
+// Compare the device assembly of the LinearForm lf against its host assembly.
+static void CompareAssembly(LinearForm &lf)
+{
+   lf.UseFastAssembly(false);
+   lf.Assemble();
+   Vector ref(lf);
+   lf.UseFastAssembly(true);
+   REQUIRE(lf.SupportsDevice());
+   lf.Assemble();
+   lf -= ref;
+   REQUIRE(lf.Normlinf() < 1e-12 * std::max(ref.Normlinf(), 1.0));
+}
+
+static void test_linearform(const char *meshname, int order)
+{
+   INFO("mesh=" << meshname << ", order=" << order);
+   Mesh mesh(meshname, 1, 1);
+   const int dim = mesh.Dimension();
+
+   FunctionCoefficient f(f_func);
+   ConstantCoefficient one(1.0);
+   VectorFunctionCoefficient fvec(dim, fvec_func);
+
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+   FiniteElementSpace vfes(&mesh, &fec, dim, Ordering::byVDIM);
+
+   // DomainLFIntegrator
+   {
+      LinearForm lf(&fes);
+      lf.AddDomainIntegrator(new DomainLFIntegrator(f));
+      lf.AddDomainIntegrator(new DomainLFIntegrator(one));
+      CompareAssembly(lf);
+   }
+
+   // DomainLFIntegrator with a QuadratureFunction
+   {
+      const int ir_order = 2*order;
+      const IntegrationRule &ir =
+         IntRules.Get(mesh.GetElementBaseGeometry(0), ir_order);
+      QuadratureSpace qs(&mesh, ir_order);
+      QuadratureFunction qf(&qs);
+      for (int e = 0; e < mesh.GetNE(); e++)
+      {
+         ElementTransformation &T = *mesh.GetElementTransformation(e);
+         Vector values;
+         qf.GetElementValues(e, values);
+         for (int q = 0; q < ir.GetNPoints(); q++)
+         {
+            T.SetIntPoint(&ir.IntPoint(q));
+            values(q) = f.Eval(T, ir.IntPoint(q));
+         }
+      }
+      QuadratureFunctionCoefficient qf_coeff(qf);
+      LinearForm lf(&fes);
+      lf.AddDomainIntegrator(new DomainLFIntegrator(qf_coeff));
+      CompareAssembly(lf);
+   }
+
+   // VectorDomainLFIntegrator
+   {
+      LinearForm lf(&vfes);
+      lf.AddDomainIntegrator(new VectorDomainLFIntegrator(fvec));
+      CompareAssembly(lf);
+   }
+
+   // BoundaryLFIntegrator, with and without boundary markers
+   {
+      LinearForm lf(&fes);
+      Array<int> bdr_marker(mesh.bdr_attributes.Max());
+      bdr_marker = 0;
+      bdr_marker[0] = 1;
+      lf.AddDomainIntegrator(new DomainLFIntegrator(f));
+      lf.AddBoundaryIntegrator(new BoundaryLFIntegrator(f));
+      lf.AddBoundaryIntegrator(new BoundaryLFIntegrator(one), bdr_marker);
+      CompareAssembly(lf);
+   }
+}
+
+TEST_CASE("LinearForm Device Assembly", "[LinearForm]")
+{
+   const auto order = GENERATE(1, 2, 3);
+
+   SECTION("2D")
+   {
+      test_linearform("../../data/inline-quad.mesh", order);
+      test_linearform("../../data/star-q3.mesh", order);
+   }
+
+   SECTION("3D")
+   {
+      test_linearform("../../data/inline-hex.mesh", order);
+      test_linearform("../../data/fichera-q3.mesh", order);
+   }
+} // test case
+
+TEST_CASE("LinearForm Device Assembly Interior Boundary", "[LinearForm]")
+{
+   // Two quadrilaterals with a boundary element on their shared edge
+   Mesh mesh(2, 6, 2, 7);
+   const double vert[6][2] = { {0,0}, {1,0}, {2,0}, {0,1}, {1,1}, {2,1} };
+   const int quad[2][4] = { {0,1,4,3}, {1,2,5,4} };
+   const int bdr[7][2] = { {0,1}, {1,2}, {2,5}, {5,4}, {4,3}, {3,0}, {1,4} };
+   for (int i = 0; i < 6; i++) { mesh.AddVertex(vert[i]); }
+   for (int i = 0; i < 2; i++) { mesh.AddQuad(quad[i]); }
+   for (int i = 0; i < 7; i++) { mesh.AddBdrSegment(bdr[i], i < 6 ? 1 : 2); }
+   mesh.FinalizeQuadMesh(1, 0, true);
+
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   FunctionCoefficient f(f_func);
+
+   LinearForm lf(&fes), lf_host(&fes);
+   for (LinearForm *form : { &lf, &lf_host })
+   {
+      form->AddDomainIntegrator(new DomainLFIntegrator(f));
+      form->AddBoundaryIntegrator(new BoundaryLFIntegrator(f));
+   }
+   lf.UseFastAssembly(true);
+   REQUIRE_FALSE(lf.SupportsDevice());
+   // Falls back to the host assembly, the check is then cached
+   lf.Assemble();
+   REQUIRE_FALSE(lf.SupportsDevice());
+   lf_host.Assemble();
+   lf -= lf_host;
+   REQUIRE(lf.Normlinf() == MFEM_Approx(0.0));
+
+   // The domain integrators alone are assembled on the device
+   LinearForm lf_dom(&fes);
+   lf_dom.AddDomainIntegrator(new DomainLFIntegrator(f));
+   lf_dom.UseFastAssembly(true);
+   REQUIRE(lf_dom.SupportsDevice());
+}
+
+} // namespace linearform_ext
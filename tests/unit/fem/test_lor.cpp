@@ -0,0 +1,258 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace lor
+{
+
+enum SpaceType { H1, ND, RT, L2 };
+
+static FiniteElementCollection *NewFEColl(SpaceType type, int order, int dim)
+{
+   switch (type)
+   {
+      case H1: return new H1_FECollection(order, dim);
+      case ND: return new ND_FECollection(order, dim);
+      case RT: return new RT_FECollection(order-1, dim);
+      default: return new L2_FECollection(order-1, dim);
+   }
+}
+
+static void AddIntegrators(SpaceType type, BilinearForm &a)
+{
+   switch (type)
+   {
+      case H1:
+         a.AddDomainIntegrator(new DiffusionIntegrator);
+         a.AddDomainIntegrator(new MassIntegrator);
+         break;
+      case ND:
+         a.AddDomainIntegrator(new CurlCurlIntegrator);
+         a.AddDomainIntegrator(new VectorFEMassIntegrator);
+         break;
+      case RT:
+         a.AddDomainIntegrator(new DivDivIntegrator);
+         a.AddDomainIntegrator(new VectorFEMassIntegrator);
+         break;
+      case L2:
+         a.AddDomainIntegrator(new MassIntegrator);
+         break;
+   }
+}
+
+// Number of CG iterations for the high-order system preconditioned with the
+// exact inverse of the LOR system.
+static int TestLOR(SpaceType type, int order, Mesh &mesh)
+{
+   const int dim = mesh.Dimension();
+   FiniteElementCollection *fec = NewFEColl(type, order, dim);
+   FiniteElementSpace fes(&mesh, fec);
+
+   Array<int> ess_tdof_list;
+   if (type == H1)
+   {
+      Array<int> ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+   }
+
+   BilinearForm a(&fes);
+   AddIntegrators(type, a);
+   a.Assemble();
+   OperatorPtr A;
+   a.FormSystemMatrix(ess_tdof_list, A);
+
+   LORDiscretization lor(a, ess_tdof_list);
+   SparseMatrix &A_lor = lor.GetAssembledMatrix();
+   REQUIRE(A_lor.Height() == fes.GetTrueVSize());
+   REQUIRE(lor.GetFESpace().GetTrueVSize() == fes.GetTrueVSize());
+   REQUIRE(lor.HasSameDofNumbering() == (type == H1));
+
+   // The DOF permutation is a bijection
+   const Array<int> &perm = lor.GetDofPermutation();
+   REQUIRE(perm.Size() == fes.GetVSize());
+   Array<int> count(fes.GetVSize());
+   count = 0;
+   for (int i = 0; i < perm.Size(); i++)
+   {
+      count[perm[i] >= 0 ? perm[i] : -1 - perm[i]]++;
+   }
+   REQUIRE(count.Min() == 1);
+   REQUIRE(count.Max() == 1);
+
+   DenseMatrix *A_lor_dense = A_lor.ToDenseMatrix();
+   DenseMatrixInverse A_lor_inv(*A_lor_dense);
+
+   Vector b(fes.GetTrueVSize()), x(fes.GetTrueVSize());
+   b.Randomize(1);
+   b.SetSubVector(ess_tdof_list, 0.0);
+   x = 0.0;
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(500);
+   cg.SetOperator(*A);
+   cg.SetPreconditioner(A_lor_inv);
+   cg.Mult(b, x);
+   REQUIRE(cg.GetConverged());
+
+   delete A_lor_dense;
+   delete fec;
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("LOR Discretization", "[LOR]")
+{
+   const SpaceType type = GENERATE(H1, ND, RT, L2);
+   const int order = GENERATE(1, 2, 3);
+   CAPTURE(type, order);
+
+   Mesh mesh2d(3, 3, Element::QUADRILATERAL, true);
+   mesh2d.EnsureNodes();
+   // Perturb the mesh to have non-affine elements
+   GridFunction &nodes2d = *mesh2d.GetNodes();
+   for (int i = 0; i < nodes2d.Size(); i++)
+   {
+      nodes2d(i) += 0.02*sin(7.0*i);
+   }
+   // With the point-value (Gauss-Legendre) open bases, the LOR ND and RT
+   // operators are not uniformly equivalent in the order, so the bound on the
+   // number of iterations is only checked for the low orders.
+   const bool bounded = (type == H1 || type == L2 || order <= 2);
+   const int it2d = TestLOR(type, order, mesh2d);
+   if (order == 1) { REQUIRE(it2d <= 2); }
+   if (bounded) { REQUIRE(it2d <= 50); }
+
+   if (order <= 2 || type == L2)
+   {
+      Mesh mesh3d(2, 2, 2, Element::HEXAHEDRON, true);
+      const int it3d = TestLOR(type, order, mesh3d);
+      if (order == 1) { REQUIRE(it3d <= 2); }
+      if (bounded) { REQUIRE(it3d <= 50); }
+   }
+}
+
+TEST_CASE("LOR Solver", "[LOR]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   H1_FECollection fec(4, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   BilinearForm a(&fes);
+   a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.Assemble();
+   OperatorPtr A;
+   a.FormSystemMatrix(ess_tdof_list, A);
+
+   LORSolver<GSSmoother> lor_gs(a, ess_tdof_list);
+   REQUIRE(lor_gs.Height() == fes.GetTrueVSize());
+
+   Vector b(fes.GetTrueVSize()), x(fes.GetTrueVSize());
+   b.Randomize(1);
+   b.SetSubVector(ess_tdof_list, 0.0);
+   x = 0.0;
+   GMRESSolver gmres;
+   gmres.SetRelTol(1e-8);
+   gmres.SetMaxIter(500);
+   gmres.SetKDim(100);
+   gmres.SetOperator(*A);
+   gmres.SetPreconditioner(lor_gs);
+   gmres.Mult(b, x);
+   REQUIRE(gmres.GetConverged());
+
+   // The H1 LOR preconditioner is robust in the order: with the exact inverse
+   // of the LOR matrix, the number of CG iterations stays bounded at high
+   // orders. This does not hold for ND and RT, whose LOR operators are not
+   // spectrally equivalent to the high-order ones with the point-value
+   // (Gauss-Legendre) open bases of this tree, see "LOR Discretization".
+   for (int order = 4; order <= 8; order += 4)
+   {
+      CAPTURE(order);
+      Mesh mesh_ho(2, 2, Element::QUADRILATERAL, true);
+      REQUIRE(TestLOR(H1, order, mesh_ho) <= 30);
+   }
+}
+
+#ifdef MFEM_USE_MPI
+
+// Number of CG iterations for the high-order system preconditioned with
+// LORSolver<SolverType> on a 3D parallel mesh.
+template <typename SolverType>
+static int TestParLORSolver(SpaceType type, int order)
+{
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   Mesh serial_mesh(3, 3, 3, Element::HEXAHEDRON, true);
+   ParMesh mesh(MPI_COMM_WORLD, serial_mesh);
+   FiniteElementCollection *fec = NewFEColl(type, order, 3);
+   ParFiniteElementSpace fes(&mesh, fec);
+   Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ParBilinearForm a(&fes);
+   AddIntegrators(type, a);
+   a.Assemble();
+   OperatorPtr A;
+   a.FormSystemMatrix(ess_tdof_list, A);
+
+   LORSolver<SolverType> lor_solver(a, ess_tdof_list);
+   lor_solver.GetSolver().SetPrintLevel(0);
+   REQUIRE(lor_solver.Height() == fes.GetTrueVSize());
+   const ParLORDiscretization &lor =
+      static_cast<const ParLORDiscretization&>(lor_solver.GetLOR());
+   REQUIRE(lor.GetParFESpace().GlobalTrueVSize() == fes.GlobalTrueVSize());
+
+   Vector b(fes.GetTrueVSize()), x(fes.GetTrueVSize());
+   b.Randomize(1 + rank);
+   b.SetSubVector(ess_tdof_list, 0.0);
+   x = 0.0;
+   CGSolver cg(MPI_COMM_WORLD);
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(500);
+   cg.SetOperator(*A);
+   cg.SetPreconditioner(lor_solver);
+   cg.Mult(b, x);
+   REQUIRE(cg.GetConverged());
+
+   delete fec;
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("Parallel LOR Solver", "[LOR][Parallel]")
+{
+   const int order = GENERATE(1, 2);
+   CAPTURE(order);
+
+   SECTION("BoomerAMG")
+   {
+      REQUIRE(TestParLORSolver<HypreBoomerAMG>(H1, order) <= 30);
+   }
+   SECTION("AMS")
+   {
+      REQUIRE(TestParLORSolver<HypreAMS>(ND, order) <= 50);
+   }
+   SECTION("ADS")
+   {
+      REQUIRE(TestParLORSolver<HypreADS>(RT, order) <= 50);
+   }
+}
+
+#endif // MFEM_USE_MPI
+
+} // namespace lor
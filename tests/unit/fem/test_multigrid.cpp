@@ -0,0 +1,142 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace multigrid
+{
+
+// Number of CG iterations for the diffusion problem on the finest space of
+// the multigrid solver mg, preconditioned by mg.
+static int SolveDiffusion(MatrixFreeMultigrid &mg, FiniteElementSpace &fes)
+{
+   GridFunction x(&fes);
+   x = 0.0;
+   LinearForm b(&fes);
+   ConstantCoefficient one(1.0);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+
+   OperatorPtr A;
+   Vector X, B;
+   mg.FormFineLinearSystem(x, b, A, X, B);
+   REQUIRE(A->Height() == fes.GetTrueVSize());
+
+   CGSolver cg;
+   cg.SetRelTol(1e-8);
+   cg.SetMaxIter(200);
+   cg.SetOperator(*A);
+   cg.SetPreconditioner(mg);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+   mg.RecoverFineFEMSolution(X, b, x);
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("Matrix-free p-multigrid", "[Multigrid]")
+{
+   const int dim = GENERATE(2, 3);
+   const int order = GENERATE(2, 4);
+   CAPTURE(dim, order);
+
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(4, 4, Element::QUADRILATERAL, true) :
+                new Mesh(2, 2, 2, Element::HEXAHEDRON, true);
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+   Array<int> ess_bdr(mesh->bdr_attributes.Max());
+   ess_bdr = 1;
+
+   ConstantCoefficient kappa(2.0);
+   auto add_integrators = [&kappa](BilinearForm &a)
+   {
+      a.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+   };
+
+   // Default schedule, halving the order down to 1
+   MatrixFreeMultigrid mg(fes, Array<int>(), ess_bdr, add_integrators);
+   REQUIRE(mg.NumLevels() == ((order == 2) ? 2 : 3));
+   REQUIRE(mg.GetFormAtLevel(0).GetAssemblyLevel() ==
+           AssemblyLevel::LEGACYFULL);
+   REQUIRE(mg.GetFormAtLevel(mg.GetFinestLevelIndex()).GetAssemblyLevel() ==
+           AssemblyLevel::PARTIAL);
+   REQUIRE(SolveDiffusion(mg, fes) <= 20);
+
+   // Explicit schedule with a single coarse level of order 1
+   Array<int> orders(1);
+   orders[0] = 1;
+   MatrixFreeMultigrid mg1(fes, orders, ess_bdr, add_integrators, 3);
+   REQUIRE(mg1.NumLevels() == 2);
+   REQUIRE(SolveDiffusion(mg1, fes) <= 20);
+
+   delete mesh;
+}
+
+TEST_CASE("Matrix-free hp-multigrid", "[Multigrid]")
+{
+   Mesh mesh(2, 2, Element::QUADRILATERAL, true);
+   H1_FECollection fec1(1, 2), fec3(3, 2);
+   FiniteElementSpace coarse_fes(&mesh, &fec1);
+   FiniteElementSpaceHierarchy fespaces(&mesh, &coarse_fes, false, false);
+   fespaces.AddUniformlyRefinedLevel();
+   fespaces.AddUniformlyRefinedLevel();
+   fespaces.AddOrderRefinedLevel(&fec3);
+
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   MatrixFreeMultigrid mg(fespaces, ess_bdr, [](BilinearForm &a)
+   {
+      a.AddDomainIntegrator(new DiffusionIntegrator);
+      a.AddDomainIntegrator(new MassIntegrator);
+   });
+   REQUIRE(mg.NumLevels() == 4);
+   REQUIRE(SolveDiffusion(mg, fespaces.GetFinestFESpace()) <= 20);
+}
+
+TEST_CASE("Matrix-free multigrid re-assembly", "[Multigrid]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   H1_FECollection fec(4, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+
+   ConstantCoefficient kappa(1.0), mass(1.0);
+   MatrixFreeMultigrid mg(fes, Array<int>(), ess_bdr, [&](BilinearForm &a)
+   {
+      a.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+      a.AddDomainIntegrator(new MassIntegrator(mass));
+   });
+   const int fine = mg.GetFinestLevelIndex();
+   auto max_eig = [&mg](int level)
+   {
+      return static_cast<OperatorChebyshevSmoother*>(
+                mg.GetSmootherAtLevel(level))->GetMaxEigEstimate();
+   };
+   const double max_eig0 = max_eig(fine);
+   REQUIRE(SolveDiffusion(mg, fes) <= 20);
+
+   // The eigenvalue estimates are reused by default
+   mass.constant = 1e3;
+   mg.Reassemble();
+   REQUIRE(max_eig(fine) == max_eig0);
+
+   // After invalidation, they are computed for the new operators
+   mg.InvalidateSpectralBounds();
+   mg.Reassemble();
+   REQUIRE(max_eig(fine) != max_eig0);
+   REQUIRE(SolveDiffusion(mg, fes) <= 20);
+}
+
+} // namespace multigrid
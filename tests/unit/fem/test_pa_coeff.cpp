@@ -834,4 +834,240 @@ TEST_CASE("Hcurl/Hdiv mixed pa_coeff",
    }
 }
 
+void perturbedHexFunction(const Vector &x, Vector &p)
+{
+   p = x;
+   p[0] += 0.05 * sin(2.0 * M_PI * x[1]) * sin(M_PI * x[2]);
+   p[1] += 0.05 * sin(2.0 * M_PI * x[2]) * sin(M_PI * x[0]);
+   p[2] += 0.05 * sin(2.0 * M_PI * x[0]) * sin(M_PI * x[1]);
+}
+
+TEST_CASE("Hcurl mixed curl pa_coeff",
+          "[PartialAssembly], [AssembleDiagonal], [CUDA]")
+{
+   dimension = 3;
+   const int ne = 2;
+   Mesh mesh(ne, ne, ne, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+   mesh.SetCurvature(2);
+   mesh.Transform(perturbedHexFunction);
+
+   FunctionCoefficient coeff(&coeffFunction);
+   VectorFunctionCoefficient vcoeff(dimension, &vectorCoeffFunction);
+   MatrixFunctionCoefficient mcoeff(dimension, &asymmetricMatrixCoeffFunction);
+
+   for (int coeffType = 0; coeffType < 3; ++coeffType)
+   {
+      for (int integrator = 0; integrator < 3; ++integrator)
+      {
+         std::cout << "Testing 3D ND mixed curl partial assembly with "
+                   << "coeffType " << coeffType << " and "
+                   << "integrator " << integrator << std::endl;
+
+         for (int order = 1; order < 4; ++order)
+         {
+            ND_FECollection fec(order, dimension);
+            FiniteElementSpace fespace(&mesh, &fec);
+            const FiniteElement *fel = fespace.GetFE(0);
+            const IntegrationRule *intRule = &MassIntegrator::GetRule(*fel, *fel,
+                                                                      *mesh.GetElementTransformation(0));
+
+            BilinearForm assemblyform(&fespace);
+            BilinearForm paform(&fespace);
+            BilinearForm eaform(&fespace);
+            paform.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            eaform.SetAssemblyLevel(AssemblyLevel::ELEMENT);
+
+            BilinearForm *forms[3] = {&assemblyform, &paform, &eaform};
+            for (int f = 0; f < 3; ++f)
+            {
+               BilinearFormIntegrator *integ = nullptr;
+               if (integrator == 0)
+               {
+                  integ = (coeffType == 0) ? new MixedVectorCurlIntegrator(coeff) :
+                          (coeffType == 1) ? new MixedVectorCurlIntegrator(vcoeff) :
+                          new MixedVectorCurlIntegrator(mcoeff);
+               }
+               else if (integrator == 1)
+               {
+                  integ = (coeffType == 0) ? new MixedVectorWeakCurlIntegrator(coeff) :
+                          (coeffType == 1) ? new MixedVectorWeakCurlIntegrator(vcoeff) :
+                          new MixedVectorWeakCurlIntegrator(mcoeff);
+               }
+               else
+               {
+                  integ = (coeffType == 0) ? new MixedCurlCurlIntegrator(coeff) :
+                          (coeffType == 1) ? new MixedCurlCurlIntegrator(vcoeff) :
+                          new MixedCurlCurlIntegrator(mcoeff);
+               }
+               integ->SetIntRule(intRule);
+               forms[f]->AddDomainIntegrator(integ);
+               forms[f]->Assemble();
+            }
+            assemblyform.Finalize();
+
+            const SparseMatrix& A_explicit = assemblyform.SpMat();
+
+            Vector xin(fespace.GetTrueVSize());
+            xin.Randomize();
+            Vector y_mat(xin.Size()), y_pa(xin.Size()), y_ea(xin.Size());
+            A_explicit.Mult(xin, y_mat);
+            paform.Mult(xin, y_pa);
+            eaform.Mult(xin, y_ea);
+
+            y_pa -= y_mat;
+            y_ea -= y_mat;
+            const double pa_error = y_pa.Norml2();
+            const double ea_error = y_ea.Norml2();
+            std::cout << "  order: " << order
+                      << ", pa error norm: " << pa_error
+                      << ", ea error norm: " << ea_error << std::endl;
+            REQUIRE(pa_error < 1.e-12);
+            REQUIRE(ea_error < 1.e-12);
+
+            Vector diag(xin.Size()), pa_diag(xin.Size());
+            A_explicit.GetDiag(diag);
+            paform.AssembleDiagonal(pa_diag);
+            pa_diag -= diag;
+            const double diag_error = pa_diag.Norml2();
+            std::cout << "  order: " << order
+                      << ", diagonal error norm: " << diag_error << std::endl;
+            REQUIRE(diag_error < 1.e-12);
+         }
+      }
+   }
+}
+
+void perturbedFunction(const Vector &x, Vector &p)
+{
+   p = x;
+   p[0] += 0.05 * sin(2.0 * M_PI * x[1]);
+   p[1] += 0.05 * sin(2.0 * M_PI * x[0]);
+}
+
+static BilinearFormIntegrator *NewVectorFEMass(int coeffType,
+                                               Coefficient &q,
+                                               VectorCoefficient &vq,
+                                               MatrixCoefficient &smq,
+                                               MatrixCoefficient &mq)
+{
+   switch (coeffType)
+   {
+      case 0: return new VectorFEMassIntegrator(q);
+      case 1: return new VectorFEMassIntegrator(vq);
+      case 2: return new VectorFEMassIntegrator(smq);
+      default: return new VectorFEMassIntegrator(mq);
+   }
+}
+
+static BilinearFormIntegrator *NewCurlCurl(int coeffType,
+                                           Coefficient &q,
+                                           VectorCoefficient &vq,
+                                           MatrixCoefficient &smq,
+                                           MatrixCoefficient &mq)
+{
+   switch (coeffType)
+   {
+      case 0: return new CurlCurlIntegrator(q);
+      case 1: return new CurlCurlIntegrator(vq);
+      case 2: return new CurlCurlIntegrator(smq);
+      default: return new CurlCurlIntegrator(mq);
+   }
+}
+
+TEST_CASE("Hcurl/Hdiv element assembly", "[PartialAssembly], [CUDA]")
+{
+   for (dimension = 2; dimension < 4; ++dimension)
+   {
+      for (int tensor = 0; tensor < 2; ++tensor)
+      {
+         const Element::Type type = (dimension == 2) ?
+                                    (tensor ? Element::QUADRILATERAL :
+                                     Element::TRIANGLE) :
+                                    (tensor ? Element::HEXAHEDRON :
+                                     Element::TETRAHEDRON);
+         Mesh *mesh = (dimension == 2) ?
+                      new Mesh(2, 2, type, 1, 1.0, 1.0) :
+                      new Mesh(2, 2, 2, type, 1, 1.0, 1.0, 1.0);
+         if (type == Element::TETRAHEDRON) { mesh->ReorientTetMesh(); }
+         mesh->SetCurvature(2);
+         mesh->Transform(perturbedFunction);
+
+         FunctionCoefficient coeff(&coeffFunction);
+         VectorFunctionCoefficient vcoeff(dimension, &vectorCoeffFunction);
+         MatrixFunctionCoefficient smcoeff(dimension,
+                                           &symmetricMatrixCoeffFunction);
+         MatrixFunctionCoefficient mcoeff(dimension,
+                                          &asymmetricMatrixCoeffFunction);
+
+         for (int spaceType = 0; spaceType < 2; ++spaceType)
+         {
+            const bool hcurl = (spaceType == 0);
+            // Only the H(curl) mass and curl-curl integrators on tensor
+            // elements support vector and matrix coefficients
+            const int numIntegrators = (hcurl && tensor) ? 2 : 1;
+            const int numCoeffs = hcurl ? 4 : 1;
+            for (int integrator = 0; integrator < numIntegrators; ++integrator)
+            {
+               for (int coeffType = 0; coeffType < numCoeffs; ++coeffType)
+               {
+                  if (integrator == 1 && dimension == 2 && coeffType > 0)
+                  {
+                     continue; // The 2D curl is a scalar
+                  }
+                  for (int order = 1; order < 4; ++order)
+                  {
+                     CAPTURE(dimension, tensor, spaceType, integrator,
+                             coeffType, order);
+                     FiniteElementCollection *fec = nullptr;
+                     if (hcurl)
+                     {
+                        fec = new ND_FECollection(order, dimension);
+                     }
+                     else
+                     {
+                        fec = new RT_FECollection(order - 1, dimension);
+                     }
+                     FiniteElementSpace fespace(mesh, fec);
+                     const FiniteElement *fel = fespace.GetFE(0);
+                     ElementTransformation *T =
+                        mesh->GetElementTransformation(0);
+                     const IntegrationRule *intRule =
+                        &MassIntegrator::GetRule(*fel, *fel, *T);
+
+                     BilinearForm assemblyform(&fespace);
+                     BilinearForm eaform(&fespace);
+                     eaform.SetAssemblyLevel(AssemblyLevel::ELEMENT);
+                     BilinearForm *forms[2] = {&assemblyform, &eaform};
+                     for (int f = 0; f < 2; ++f)
+                     {
+                        BilinearFormIntegrator *integ =
+                           (integrator == 0) ?
+                           NewVectorFEMass(coeffType, coeff, vcoeff, smcoeff,
+                                           mcoeff) :
+                           NewCurlCurl(coeffType, coeff, vcoeff, smcoeff,
+                                       mcoeff);
+                        integ->SetIntRule(intRule);
+                        forms[f]->AddDomainIntegrator(integ);
+                        forms[f]->Assemble();
+                     }
+                     assemblyform.Finalize();
+
+                     Vector xin(fespace.GetTrueVSize());
+                     xin.Randomize(1);
+                     Vector y_mat(xin.Size()), y_ea(xin.Size());
+                     assemblyform.SpMat().Mult(xin, y_mat);
+                     eaform.Mult(xin, y_ea);
+                     y_ea -= y_mat;
+                     REQUIRE(y_ea.Normlinf() < 1.e-12 * y_mat.Normlinf());
+
+                     delete fec;
+                  }
+               }
+            }
+         }
+         delete mesh;
+      }
+   }
+}
+
 } // namespace pa_coeff
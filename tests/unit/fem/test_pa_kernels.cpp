@@ -268,6 +268,75 @@ TEST_CASE("Nonlinear Convection", "[PartialAssembly], [NonlinearPA]")
    }
 }
 
+void deformation_nd(const Vector &x, Vector &u)
+{
+   u = x;
+   u(0) += 0.1 * x(1) * x(1);
+   u(1) += 0.05 * x(0) * x(1);
+   if (x.Size() == 3) { u(2) -= 0.1 * x(0) * x(2); }
+}
+
+double test_nl_hyperelastic_nd(int dim, HyperelasticModel &model)
+{
+   Mesh *mesh = nullptr;
+
+   if (dim == 2)
+   {
+      mesh = new Mesh(2, 2, Element::QUADRILATERAL, 0, 1.0, 1.0);
+   }
+   if (dim == 3)
+   {
+      mesh = new Mesh(2, 2, 2, Element::HEXAHEDRON, 0, 1.0, 1.0, 1.0);
+   }
+
+   int order = 2;
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec, dim);
+
+   GridFunction x(&fes), v(&fes);
+   GridFunction y_fa(&fes), y_pa(&fes), z_fa(&fes), z_pa(&fes);
+   VectorFunctionCoefficient deformation(dim, deformation_nd);
+   x.ProjectCoefficient(deformation);
+   v.Randomize(3);
+
+   NonlinearForm nlf_fa(&fes);
+   nlf_fa.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+   nlf_fa.Mult(x, y_fa);
+   nlf_fa.GetGradient(x).Mult(v, z_fa);
+
+   NonlinearForm nlf_pa(&fes);
+   nlf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   nlf_pa.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+   nlf_pa.Setup();
+   nlf_pa.Mult(x, y_pa);
+   nlf_pa.GetGradient(x).Mult(v, z_pa);
+
+   y_fa -= y_pa;
+   z_fa -= z_pa;
+   double difference = y_fa.Norml2() + z_fa.Norml2();
+
+   delete mesh;
+
+   return difference;
+}
+
+TEST_CASE("Nonlinear Hyperelastic", "[PartialAssembly], [NonlinearPA]")
+{
+   NeoHookeanModel neo_hookean(1.5, 3.0, 0.9);
+   ConstantCoefficient mu(0.5), K(2.0);
+   NeoHookeanModel neo_hookean_coeffs(mu, K);
+   InverseHarmonicModel inverse_harmonic;
+
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      REQUIRE(test_nl_hyperelastic_nd(dim, neo_hookean) == MFEM_Approx(0.0));
+      REQUIRE(test_nl_hyperelastic_nd(dim, neo_hookean_coeffs) ==
+              MFEM_Approx(0.0));
+      REQUIRE(test_nl_hyperelastic_nd(dim, inverse_harmonic) ==
+              MFEM_Approx(0.0));
+   }
+}
+
 template <typename INTEGRATOR>
 double test_vector_pa_integrator(int dim)
 {
@@ -459,4 +528,716 @@ TEST_CASE("PA Convection", "[PartialAssembly]")
 
 } // test case
 
+double simplex_coeff(const Vector &x)
+{
+   return 1.0 + x(0)*x(0) + 0.5*x(1);
+}
+
+void simplex_vcoeff(const Vector &x, Vector &v)
+{
+   for (int d = 0; d < x.Size(); d++) { v(d) = 1.0 + (d+1)*x(d)*x(d); }
+}
+
+void simplex_mcoeff(const Vector &x, DenseMatrix &m)
+{
+   const int dim = x.Size();
+   m.SetSize(dim);
+   for (int i = 0; i < dim; i++)
+   {
+      for (int j = 0; j < dim; j++)
+      {
+         m(i,j) = (i == j) ? 2.0 + x(i) : 0.1*(i+1)*x(j);
+      }
+   }
+}
+
+// Returns the relative difference between the full and partial assembly of
+// the action and of the diagonal of the integrator 'pb' on a curved simplex
+// mesh: 0 = mass, 1-3 = diffusion with scalar/vector/matrix coefficient,
+// 4 = H(curl) mass, 5 = H(div) mass.
+double test_pa_simplex(int dim, int order, int pb)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(3, 3, Element::TRIANGLE, 0, 1.0, 1.0) :
+                new Mesh(2, 2, 2, Element::TETRAHEDRON, 0, 1.0, 1.0, 1.0);
+   if (dim == 3) { mesh->ReorientTetMesh(); }
+   mesh->SetCurvature(2);
+   GridFunction &nodes = *mesh->GetNodes();
+   for (int i = 0; i < nodes.Size(); i++)
+   {
+      nodes(i) += 0.02 * sin(3.0 * nodes(i));
+   }
+
+   FiniteElementCollection *fec =
+      (pb < 4) ? (FiniteElementCollection*) new H1_FECollection(order, dim) :
+      (pb == 4) ? (FiniteElementCollection*) new ND_FECollection(order, dim) :
+      (FiniteElementCollection*) new RT_FECollection(order-1, dim);
+   FiniteElementSpace fes(mesh, fec);
+
+   FunctionCoefficient q(simplex_coeff);
+   VectorFunctionCoefficient vq(dim, simplex_vcoeff);
+   MatrixFunctionCoefficient mq(dim, simplex_mcoeff);
+
+   BilinearForm blf_fa(&fes), blf_pa(&fes);
+   blf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   BilinearForm *blf[2] = { &blf_fa, &blf_pa };
+   for (int i = 0; i < 2; i++)
+   {
+      switch (pb)
+      {
+         case 0: blf[i]->AddDomainIntegrator(new MassIntegrator(q)); break;
+         case 1: blf[i]->AddDomainIntegrator(new DiffusionIntegrator(q)); break;
+         case 2: blf[i]->AddDomainIntegrator(new DiffusionIntegrator(vq)); break;
+         case 3: blf[i]->AddDomainIntegrator(new DiffusionIntegrator(mq)); break;
+         case 4: blf[i]->AddDomainIntegrator(new VectorFEMassIntegrator(mq));
+            break;
+         case 5: blf[i]->AddDomainIntegrator(new VectorFEMassIntegrator(q));
+            break;
+      }
+      blf[i]->Assemble();
+   }
+   blf_fa.Finalize();
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes), d_fa(&fes), d_pa(&fes);
+   x.Randomize(1);
+   blf_fa.Mult(x, y_fa);
+   blf_pa.Mult(x, y_pa);
+   blf_fa.SpMat().GetDiag(d_fa);
+   blf_pa.AssembleDiagonal(d_pa);
+
+   y_pa -= y_fa;
+   d_pa -= d_fa;
+   const double diff = std::max(y_pa.Normlinf() / y_fa.Normlinf(),
+                                d_pa.Normlinf() / d_fa.Normlinf());
+
+   delete fec;
+   delete mesh;
+   return diff;
+}
+
+TEST_CASE("PA Simplex", "[PartialAssembly]")
+{
+   for (int pb = 0; pb <= 5; pb++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         REQUIRE(test_pa_simplex(2, order, pb) == MFEM_Approx(0.0));
+         REQUIRE(test_pa_simplex(3, order, pb) == MFEM_Approx(0.0));
+      }
+   }
+}
+
+// Returns the relative difference between the full and the partial assembly
+// of the action of problem pb on a Bernstein (positive basis) simplex mesh,
+// using the sum-factorized PA kernels: 0 = mass, 1 = diffusion, 2 = diffusion
+// with a nonsymmetric matrix coefficient, 3-4 = mass/diffusion on affine
+// elements with a constant coefficient. The full assembly uses the same
+// collapsed integration rule.
+double test_pa_collapsed(int dim, int order, int pb, bool collapsed)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(3, 3, Element::TRIANGLE, 0, 1.0, 1.0) :
+                new Mesh(2, 2, 2, Element::TETRAHEDRON, 0, 1.0, 1.0, 1.0);
+   if (dim == 3) { mesh->ReorientTetMesh(); }
+   if (pb < 3)
+   {
+      mesh->SetCurvature(2);
+      GridFunction &nodes = *mesh->GetNodes();
+      for (int i = 0; i < nodes.Size(); i++)
+      {
+         nodes(i) += 0.02 * sin(3.0 * nodes(i));
+      }
+   }
+   H1_FECollection fec(order, dim, BasisType::Positive);
+   FiniteElementSpace fes(mesh, &fec);
+   const FiniteElement &el = *fes.GetFE(0);
+   ElementTransformation &T = *mesh->GetElementTransformation(0);
+   const bool mass = (pb == 0 || pb == 3);
+   const int ir_order = mass ? MassIntegrator::GetRule(el, el, T).GetOrder() :
+                        DiffusionIntegrator::GetRule(el, el).GetOrder();
+   const IntegrationRule &ir =
+      IntRules.GetCollapsed(el.GetGeomType(), ir_order);
+
+   ConstantCoefficient one(2.0);
+   FunctionCoefficient q(simplex_coeff);
+   MatrixFunctionCoefficient mq(dim, simplex_mcoeff);
+
+   BilinearForm blf_fa(&fes), blf_pa(&fes), blf_mp(&fes);
+   blf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   blf_mp.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   blf_mp.EnablePAMixedPrecision();
+   BilinearForm *blf[3] = { &blf_fa, &blf_pa, &blf_mp };
+   for (int i = 0; i < 3; i++)
+   {
+      BilinearFormIntegrator *integ = NULL;
+      switch (pb)
+      {
+         case 0: integ = new MassIntegrator(q); break;
+         case 1: integ = new DiffusionIntegrator(q); break;
+         case 2: integ = new DiffusionIntegrator(mq); break;
+         case 3: integ = new MassIntegrator(one); break;
+         case 4: integ = new DiffusionIntegrator(one); break;
+      }
+      // The collapsed rule selects the sum-factorized kernels
+      if (collapsed) { integ->SetIntRule(&ir); }
+      blf[i]->AddDomainIntegrator(integ);
+      blf[i]->Assemble();
+   }
+   blf_fa.Finalize();
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes), y_mp(&fes);
+   x.Randomize(1);
+   blf_fa.Mult(x, y_fa);
+   blf_pa.Mult(x, y_pa);
+   blf_mp.Mult(x, y_mp);
+
+   // The single precision quadrature data uses the same kernels
+   y_mp -= y_pa;
+   REQUIRE(y_mp.Normlinf() / y_pa.Normlinf() < 1e-6);
+   y_pa -= y_fa;
+   const double diff = y_pa.Normlinf() / y_fa.Normlinf();
+
+   delete mesh;
+   return diff;
+}
+
+TEST_CASE("PA Simplex Collapsed", "[PartialAssembly]")
+{
+   // The collapsed kernels are used from order 3, only with a collapsed rule
+   for (int pb = 0; pb <= 4; pb++)
+   {
+      for (int order = 3; order <= 5; order++)
+      {
+         for (bool collapsed : { true, false })
+         {
+            REQUIRE(test_pa_collapsed(2, order, pb, collapsed) ==
+                    MFEM_Approx(0.0));
+            REQUIRE(test_pa_collapsed(3, order, pb, collapsed) ==
+                    MFEM_Approx(0.0));
+         }
+      }
+   }
+}
+
+void mixed_mcoeff(const Vector &x, Vector &k)
+{
+   const int dim = x.Size();
+   for (int i = 0, ij = 0; i < dim; i++)
+   {
+      for (int j = i; j < dim; j++, ij++)
+      {
+         k(ij) = (i == j) ? 2.0 + x(i) : 0.1*(x(i) + x(j));
+      }
+   }
+}
+
+// Returns the largest relative difference between the full and the partial
+// assembly of the action and of the diagonal of the integrator 'pb' on a mesh
+// with mixed element types: 0 = mass, 1-3 = diffusion with scalar/vector/
+// symmetric matrix coefficient. The mesh is curved if 'curved' is true.
+double test_pa_mixed(const char *mesh_file, int order, int pb, bool curved)
+{
+   Mesh mesh(mesh_file, 1, 1);
+   const int dim = mesh.Dimension();
+   mesh.UniformRefinement();
+   if (curved)
+   {
+      mesh.SetCurvature(2);
+      GridFunction &nodes = *mesh.GetNodes();
+      for (int i = 0; i < nodes.Size(); i++)
+      {
+         nodes(i) += 0.02 * sin(3.0 * nodes(i));
+      }
+   }
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   FunctionCoefficient q(simplex_coeff);
+   VectorFunctionCoefficient vq(dim, simplex_vcoeff);
+   MatrixFunctionCoefficient mq(dim, mixed_mcoeff);
+
+   BilinearForm blf_fa(&fes), blf_pa(&fes);
+   blf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   BilinearForm *blf[2] = { &blf_fa, &blf_pa };
+   for (int i = 0; i < 2; i++)
+   {
+      switch (pb)
+      {
+         case 0: blf[i]->AddDomainIntegrator(new MassIntegrator(q)); break;
+         case 1: blf[i]->AddDomainIntegrator(new DiffusionIntegrator(q)); break;
+         case 2: blf[i]->AddDomainIntegrator(new DiffusionIntegrator(vq)); break;
+         case 3: blf[i]->AddDomainIntegrator(new DiffusionIntegrator(mq)); break;
+      }
+      blf[i]->Assemble();
+   }
+   blf_fa.Finalize();
+   // Without nodes, the Jacobians are computed from the vertices
+   REQUIRE((mesh.GetNodes() != NULL) == curved);
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes), d_fa(&fes), d_pa(&fes);
+   x.Randomize(1);
+   blf_fa.Mult(x, y_fa);
+   blf_pa.Mult(x, y_pa);
+   blf_fa.SpMat().GetDiag(d_fa);
+   blf_pa.AssembleDiagonal(d_pa);
+
+   y_pa -= y_fa;
+   d_pa -= d_fa;
+   return std::max(y_pa.Normlinf() / y_fa.Normlinf(),
+                   d_pa.Normlinf() / d_fa.Normlinf());
+}
+
+TEST_CASE("PA Mixed Elements", "[PartialAssembly]")
+{
+   const char *mesh_files[] = { "../../data/star-mixed.mesh",
+                                "../../data/fichera-mixed.mesh"
+                              };
+   for (const char *mesh_file : mesh_files)
+   {
+      for (int pb = 0; pb <= 3; pb++)
+      {
+         for (int order = 1; order <= 3; order++)
+         {
+            for (bool curved : { false, true })
+            {
+               REQUIRE(test_pa_mixed(mesh_file, order, pb, curved) ==
+                       MFEM_Approx(0.0));
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("PA Mixed Elements Unsupported", "[PartialAssembly]")
+{
+   // Only the mass and diffusion integrators support meshes with mixed
+   // elements, the partial assembly of the other ones must abort.
+   REQUIRE(MassIntegrator().SupportsMixedMeshesPA());
+   REQUIRE(DiffusionIntegrator().SupportsMixedMeshesPA());
+   REQUIRE_FALSE(VectorMassIntegrator().SupportsMixedMeshesPA());
+   REQUIRE_FALSE(VectorDiffusionIntegrator().SupportsMixedMeshesPA());
+   REQUIRE_FALSE(DGDiffusionIntegrator(-1.0, 1.0).SupportsMixedMeshesPA());
+#ifdef MFEM_USE_EXCEPTIONS
+   Mesh mesh("../../data/star-mixed.mesh");
+   H1_FECollection fec(1, mesh.Dimension());
+   FiniteElementSpace fes(&mesh, &fec, mesh.Dimension());
+   BilinearForm blf(&fes);
+   blf.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   blf.AddDomainIntegrator(new VectorMassIntegrator);
+   REQUIRE_THROWS(blf.Assemble());
+#endif
+}
+
+// Returns the relative difference between the full and the partial assembly
+// of the action of MassIntegrator + DiffusionIntegrator, which use the fused
+// PA kernel on quadrilaterals and hexahedra.
+double test_pa_mass_diffusion(int dim, int order, bool matrix_coeff)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(3, 3, Element::QUADRILATERAL, true, 1.0, 1.0) :
+                new Mesh(2, 2, 2, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+
+   FunctionCoefficient q(simplex_coeff);
+   MatrixFunctionCoefficient mq(dim, mixed_mcoeff);
+
+   BilinearForm blf_fa(&fes), blf_pa(&fes);
+   blf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   BilinearForm *blf[2] = { &blf_fa, &blf_pa };
+   DiffusionIntegrator *diff = nullptr;
+   MassIntegrator *mass = nullptr;
+   for (int i = 0; i < 2; i++)
+   {
+      mass = new MassIntegrator(q);
+      diff = matrix_coeff ? new DiffusionIntegrator(mq) :
+             new DiffusionIntegrator(q);
+      blf[i]->AddDomainIntegrator(mass);
+      blf[i]->AddDomainIntegrator(diff);
+      blf[i]->Assemble();
+   }
+   blf_fa.Finalize();
+   REQUIRE(diff->CanFusePA(*mass));
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes);
+   x.Randomize(1);
+   blf_fa.Mult(x, y_fa);
+   blf_pa.Mult(x, y_pa);
+
+   y_pa -= y_fa;
+   const double error = y_pa.Normlinf() / y_fa.Normlinf();
+   delete mesh;
+   return error;
+}
+
+TEST_CASE("PA Mass Diffusion", "[PartialAssembly]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 4; order++)
+      {
+         REQUIRE(test_pa_mass_diffusion(dim, order, false) == MFEM_Approx(0.0));
+         REQUIRE(test_pa_mass_diffusion(dim, order, true) == MFEM_Approx(0.0));
+      }
+   }
+}
+
+double update_coeff(const Vector &x)
+{
+   return 1.0 + x(0)*x(0) + 0.5*x(1);
+}
+
+// Returns the relative difference between the full assembly with the
+// coefficient 'update_coeff' and the partial assembly with another coefficient
+// followed by UpdateCoefficient().
+double test_pa_update_coefficient(int dim, int order, Element::Type type)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(3, 3, type, true, 1.0, 1.0) :
+                new Mesh(2, 2, 2, type, true, 1.0, 1.0, 1.0);
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+
+   FunctionCoefficient q(simplex_coeff), q_new(update_coeff);
+
+   BilinearForm blf_fa(&fes), blf_pa(&fes);
+   blf_fa.AddDomainIntegrator(new MassIntegrator(q_new));
+   blf_fa.AddDomainIntegrator(new DiffusionIntegrator(q_new));
+   blf_fa.Assemble();
+   blf_fa.Finalize();
+
+   MassIntegrator *mass = new MassIntegrator(q);
+   DiffusionIntegrator *diff = new DiffusionIntegrator(q);
+   blf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   blf_pa.AddDomainIntegrator(mass);
+   blf_pa.AddDomainIntegrator(diff);
+   blf_pa.Assemble();
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes);
+   x.Randomize(1);
+   blf_fa.Mult(x, y_fa);
+   // Each update reuses the geometric factors cached by the mesh
+   for (int i = 0; i < 2; i++)
+   {
+      mass->UpdateCoefficient(i == 0 ? q : q_new);
+      diff->UpdateCoefficient(i == 0 ? q : q_new);
+   }
+   blf_pa.Mult(x, y_pa);
+   y_pa -= y_fa;
+   const double error = y_pa.Normlinf() / y_fa.Normlinf();
+   delete mesh;
+   return error;
+}
+
+TEST_CASE("PA Update Coefficient", "[PartialAssembly]")
+{
+   for (int order = 1; order <= 3; order++)
+   {
+      REQUIRE(test_pa_update_coefficient(2, order, Element::QUADRILATERAL)
+              == MFEM_Approx(0.0));
+      REQUIRE(test_pa_update_coefficient(2, order, Element::TRIANGLE)
+              == MFEM_Approx(0.0));
+      REQUIRE(test_pa_update_coefficient(3, order, Element::HEXAHEDRON)
+              == MFEM_Approx(0.0));
+   }
+}
+
+
+void simd_vcoeff(const Vector &x, Vector &v)
+{
+   for (int d = 0; d < x.Size(); d++) { v(d) = (d+1) * (1.0 - x(d)) + x(0); }
+}
+
+// Returns the relative difference between the full and partial assembly of
+// the integrator 'pb' on a perturbed mesh whose number of elements is not a
+// multiple of the SIMD width: 0 = mass, 1-2 = diffusion with scalar/matrix
+// coefficient, 3 = convection. With Device("cpu-simd") this compares against
+// the Backend::CPU_SIMD kernels.
+double test_pa_simd(int dim, int order, int pb)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(5, 3, Element::QUADRILATERAL, true, 1.0, 1.0) :
+                new Mesh(3, 3, 2, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+   mesh->SetCurvature(1);
+   GridFunction &nodes = *mesh->GetNodes();
+   for (int i = 0; i < nodes.Size(); i++)
+   {
+      nodes(i) += 0.03 * sin(5.0 * nodes(i));
+   }
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+
+   FunctionCoefficient q(simplex_coeff);
+   MatrixFunctionCoefficient mq(dim, simplex_mcoeff);
+   VectorFunctionCoefficient vq(dim, simd_vcoeff);
+
+   BilinearForm blf_fa(&fes), blf_pa(&fes);
+   blf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   BilinearForm *blf[2] = { &blf_fa, &blf_pa };
+   for (int i = 0; i < 2; i++)
+   {
+      switch (pb)
+      {
+         case 0: blf[i]->AddDomainIntegrator(new MassIntegrator(q)); break;
+         case 1: blf[i]->AddDomainIntegrator(new DiffusionIntegrator(q)); break;
+         case 2: blf[i]->AddDomainIntegrator(new DiffusionIntegrator(mq)); break;
+         case 3: blf[i]->AddDomainIntegrator(new ConvectionIntegrator(vq));
+            break;
+      }
+      blf[i]->Assemble();
+   }
+   blf_fa.Finalize();
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes);
+   x.Randomize(1);
+   blf_fa.Mult(x, y_fa);
+   blf_pa.Mult(x, y_pa);
+   y_pa -= y_fa;
+   const double error = y_pa.Normlinf() / y_fa.Normlinf();
+   delete mesh;
+   return error;
+}
+
+TEST_CASE("PA SIMD", "[PartialAssembly], [CPU_SIMD]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 4; order++)
+      {
+         for (int pb = 0; pb <= 3; pb++)
+         {
+            REQUIRE(test_pa_simd(dim, order, pb) == MFEM_Approx(0.0));
+         }
+      }
+   }
+}
+
+
+double high_order_field(const Vector &x)
+{
+   double r2 = 0.0;
+   for (int d = 0; d < x.Size(); d++) { r2 += x(d)*x(d); }
+   return r2;
+}
+
+// Checks the partial assembly of the mass (pb = 0) and diffusion (pb = 1)
+// integrators for high orders on the unit square/cube: the energy of the
+// quadratic field |x|^2 is computed exactly, and the diagonal matches the
+// action on unit vectors. Returns the largest relative error.
+double test_pa_high_order(int dim, int order, int pb)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(1, 1, Element::QUADRILATERAL, true, 1.0, 1.0) :
+                new Mesh(1, 1, 1, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+
+   BilinearForm blf(&fes);
+   blf.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   if (pb == 0) { blf.AddDomainIntegrator(new MassIntegrator); }
+   else { blf.AddDomainIntegrator(new DiffusionIntegrator); }
+   blf.Assemble();
+
+   // Exact energies: int |x|^4 and int |2x|^2 over the unit square/cube
+   const double exact = (pb == 0) ?
+                        ((dim == 2) ? 28.0/45.0 : 19.0/15.0) :
+                        4.0*dim/3.0;
+   FunctionCoefficient f(high_order_field);
+   GridFunction u(&fes), y(&fes), diag(&fes), e(&fes);
+   u.ProjectCoefficient(f);
+   blf.Mult(u, y);
+   double error = fabs((u*y) - exact) / exact;
+
+   blf.AssembleDiagonal(diag);
+   for (int i = 0; i < fes.GetVSize(); i += fes.GetVSize()/7)
+   {
+      e = 0.0;
+      e(i) = 1.0;
+      blf.Mult(e, y);
+      error = std::max(error, fabs(y(i) - diag(i)) / fabs(diag(i)));
+   }
+   delete mesh;
+   return error;
+}
+
+TEST_CASE("PA High Order", "[PartialAssembly]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 7; order <= 10; order++)
+      {
+         for (int pb = 0; pb <= 1; pb++)
+         {
+            REQUIRE(test_pa_high_order(dim, order, pb) == MFEM_Approx(0.0));
+         }
+      }
+   }
+}
+
+
+// Affine map with a non-diagonal Jacobian
+void shear_transform(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.5*x(1);
+   if (x.Size() == 3) { y(1) += 0.25*x(2); }
+}
+
+double test_pa_affine(const char *meshname, int order, bool shear)
+{
+   Mesh mesh(meshname, 1, 1);
+   if (shear) { mesh.Transform(shear_transform); }
+   const int dim = mesh.Dimension();
+   const bool tensor = mesh.GetElementBaseGeometry(0) == Geometry::SQUARE ||
+                       mesh.GetElementBaseGeometry(0) == Geometry::CUBE;
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+   ConstantCoefficient two(2.0);
+   FunctionCoefficient f(f1);
+
+   BilinearForm fa(&fes), pa(&fes);
+   fa.AddDomainIntegrator(new MassIntegrator(two));
+   fa.AddDomainIntegrator(new DiffusionIntegrator(two));
+   fa.Assemble();
+   fa.Finalize();
+   pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   MassIntegrator *mass = new MassIntegrator(two);
+   DiffusionIntegrator *diff = new DiffusionIntegrator(two);
+   pa.AddDomainIntegrator(mass);
+   pa.AddDomainIntegrator(diff);
+   pa.Assemble();
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes);
+   Vector diag_fa(fes.GetVSize()), diag_pa(fes.GetVSize());
+   x.Randomize(1);
+   fa.Mult(x, y_fa);
+   pa.Mult(x, y_pa);
+   y_pa -= y_fa;
+   double error = y_pa.Normlinf() / y_fa.Normlinf();
+
+   fa.AssembleDiagonal(diag_fa);
+   pa.AssembleDiagonal(diag_pa);
+   diag_pa -= diag_fa;
+   error = std::max(error, diag_pa.Normlinf() / diag_fa.Normlinf());
+
+   if (tensor)
+   {
+      BilinearForm ea(&fes);
+      ea.SetAssemblyLevel(AssemblyLevel::ELEMENT);
+      ea.AddDomainIntegrator(new MassIntegrator(two));
+      ea.AddDomainIntegrator(new DiffusionIntegrator(two));
+      ea.Assemble();
+      ea.Mult(x, y_pa);
+      y_pa -= y_fa;
+      error = std::max(error, y_pa.Normlinf() / y_fa.Normlinf());
+   }
+
+   // A variable coefficient uses the data at all quadrature points
+   BilinearForm fa_f(&fes);
+   fa_f.AddDomainIntegrator(new MassIntegrator(f));
+   fa_f.AddDomainIntegrator(new DiffusionIntegrator(f));
+   fa_f.Assemble();
+   fa_f.Finalize();
+   fa_f.Mult(x, y_fa);
+   mass->UpdateCoefficient(f);
+   diff->UpdateCoefficient(f);
+   pa.Mult(x, y_pa);
+   y_pa -= y_fa;
+   error = std::max(error, y_pa.Normlinf() / y_fa.Normlinf());
+   return error;
+}
+
+TEST_CASE("PA Affine Elements", "[PartialAssembly]")
+{
+   const auto order = GENERATE(1, 2, 4);
+   const auto shear = GENERATE(false, true);
+   const char *meshes[] = { "../../data/inline-quad.mesh",
+                            "../../data/inline-tri.mesh",
+                            "../../data/inline-hex.mesh",
+                            "../../data/inline-tet.mesh",
+                            "../../data/star-q3.mesh"
+                          };
+   for (const char *meshname : meshes)
+   {
+      INFO("mesh=" << meshname << ", order=" << order << ", shear=" << shear);
+      REQUIRE(test_pa_affine(meshname, order, shear) < 1e-12);
+   }
+}
+
+
+double test_pa_mixed_precision(const char *meshname, int order)
+{
+   Mesh mesh(meshname, 1, 1);
+   const int dim = mesh.Dimension();
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+   // A variable coefficient keeps the data at all quadrature points
+   FunctionCoefficient f(f1);
+   ConstantCoefficient two(2.0);
+
+   BilinearForm pa_dp(&fes), pa_mp(&fes);
+   pa_dp.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   pa_mp.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   pa_mp.EnablePAMixedPrecision();
+   REQUIRE(pa_mp.PAMixedPrecisionIsEnabled());
+   MassIntegrator *mass = new MassIntegrator(f);
+   DiffusionIntegrator *diff = new DiffusionIntegrator(f);
+   pa_dp.AddDomainIntegrator(new MassIntegrator(f));
+   pa_dp.AddDomainIntegrator(new DiffusionIntegrator(f));
+   pa_mp.AddDomainIntegrator(mass);
+   pa_mp.AddDomainIntegrator(diff);
+   pa_dp.Assemble();
+   pa_mp.Assemble();
+
+   GridFunction x(&fes), y_dp(&fes), y_mp(&fes);
+   Vector diag_dp(fes.GetVSize()), diag_mp(fes.GetVSize());
+   x.Randomize(1);
+   pa_dp.Mult(x, y_dp);
+   pa_mp.Mult(x, y_mp);
+   y_mp -= y_dp;
+   double error = y_mp.Normlinf() / y_dp.Normlinf();
+
+   pa_dp.AssembleDiagonal(diag_dp);
+   pa_mp.AssembleDiagonal(diag_mp);
+   diag_mp -= diag_dp;
+   error = std::max(error, diag_mp.Normlinf() / diag_dp.Normlinf());
+
+   // The updated data is also stored in single precision
+   BilinearForm fa(&fes);
+   fa.AddDomainIntegrator(new MassIntegrator(two));
+   fa.AddDomainIntegrator(new DiffusionIntegrator(f));
+   fa.Assemble();
+   fa.Finalize();
+   mass->UpdateCoefficient(two);
+   fa.Mult(x, y_dp);
+   pa_mp.Mult(x, y_mp);
+   y_mp -= y_dp;
+   error = std::max(error, y_mp.Normlinf() / y_dp.Normlinf());
+
+   // Also after going through the double precision data of affine elements
+   mass->UpdateCoefficient(f);
+   pa_dp.Mult(x, y_dp);
+   pa_mp.Mult(x, y_mp);
+   y_mp -= y_dp;
+   return std::max(error, y_mp.Normlinf() / y_dp.Normlinf());
+}
+
+TEST_CASE("PA Mixed Precision", "[PartialAssembly]")
+{
+   const auto order = GENERATE(1, 3);
+   const char *meshes[] = { "../../data/inline-quad.mesh",
+                            "../../data/inline-tri.mesh",
+                            "../../data/star-q3.mesh",
+                            "../../data/inline-hex.mesh",
+                            "../../data/inline-tet.mesh"
+                          };
+   for (const char *meshname : meshes)
+   {
+      INFO("mesh=" << meshname << ", order=" << order);
+      const double error = test_pa_mixed_precision(meshname, order);
+      // Single precision accuracy, without a complete loss of the data
+      REQUIRE(error < 1e-6);
+   }
+}
+
 } // namespace pa_kernels
@@ -0,0 +1,232 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+
+using namespace mfem;
+
+namespace pointlocator
+{
+
+double u_func(const Vector &x)
+{
+   double u = 1.0 + x(0)*x(1) + cos(x(0));
+   if (x.Size() == 3) { u += x(2)*x(2); }
+   return u;
+}
+
+void uvec_func(const Vector &x, Vector &u)
+{
+   for (int c = 0; c < u.Size(); c++) { u(c) = (c+1.0)*x(0) + x(c)*x(c); }
+}
+
+static void test_locator(const char *meshname)
+{
+   INFO("mesh=" << meshname);
+   Mesh mesh(meshname, 1, 1);
+   mesh.ReorientTetMesh();
+   const int dim = mesh.Dimension();
+   const int NE = mesh.GetNE();
+
+   H1_FECollection h1_fec(2, dim);
+   ND_FECollection nd_fec(2, dim);
+   FiniteElementSpace h1_fes(&mesh, &h1_fec);
+   FiniteElementSpace nd_fes(&mesh, &nd_fec);
+   GridFunction u(&h1_fes), v(&nd_fes);
+   FunctionCoefficient u_coeff(u_func);
+   VectorFunctionCoefficient v_coeff(dim, uvec_func);
+   u.ProjectCoefficient(u_coeff);
+   v.ProjectCoefficient(v_coeff);
+
+   // Points inside the elements, and one point outside of the mesh
+   const int npts_el = 3;
+   const int npts = npts_el*NE + 1;
+   DenseMatrix points(dim, npts);
+   Array<int> ref_elems(npts);
+   Array<IntegrationPoint> ref_ips(npts);
+   Vector x;
+   for (int e = 0; e < NE; e++)
+   {
+      const IntegrationRule &ir =
+         IntRules.Get(mesh.GetElementBaseGeometry(e), 4);
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      for (int j = 0; j < npts_el; j++)
+      {
+         const int k = npts_el*e + j;
+         ref_elems[k] = e;
+         ref_ips[k] = ir.IntPoint((7*j + e) % ir.GetNPoints());
+         points.GetColumnReference(k, x);
+         T.Transform(ref_ips[k], x);
+      }
+   }
+   ref_elems[npts-1] = -1;
+   for (int d = 0; d < dim; d++) { points(d,npts-1) = 1e3; }
+
+   PointLocator locator(mesh);
+   Array<int> elems;
+   Array<IntegrationPoint> ips;
+   REQUIRE(locator.FindPoints(points, elems, ips, false) == npts - 1);
+   REQUIRE(elems[npts-1] == -1);
+
+   DenseMatrix u_vals, v_vals;
+   locator.Interpolate(u, elems, ips, u_vals);
+   locator.Interpolate(v, elems, ips, v_vals);
+   REQUIRE(u_vals.Height() == 1);
+   REQUIRE(v_vals.Height() == dim);
+
+   // Compare with the values in the elements used to generate the points
+   Vector v_ref;
+   for (int k = 0; k < npts - 1; k++)
+   {
+      const int e = ref_elems[k];
+      const double u_ref = u.GetValue(e, ref_ips[k]);
+      REQUIRE(std::abs(u_vals(0,k) - u_ref) < 1e-8);
+      // The ND field is discontinuous, so only check points found in the
+      // same element.
+      if (elems[k] != e) { continue; }
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      T.SetIntPoint(&ref_ips[k]);
+      v.GetVectorValue(T, ref_ips[k], v_ref);
+      for (int d = 0; d < dim; d++)
+      {
+         REQUIRE(std::abs(v_vals(d,k) - v_ref(d)) < 1e-8);
+      }
+   }
+
+   // The combined version gives the same result
+   DenseMatrix u_vals2;
+   REQUIRE(locator.Interpolate(points, u, u_vals2, false) == npts - 1);
+   u_vals2 -= u_vals;
+   REQUIRE(u_vals2.MaxMaxNorm() == 0.0);
+
+   // After moving the nodes, the locator has to be updated
+   mesh.EnsureNodes();
+   GridFunction &nodes = *mesh.GetNodes();
+   nodes *= 2.0;
+   locator.Update();
+   DenseMatrix scaled_points(points);
+   scaled_points *= 2.0;
+   REQUIRE(locator.FindPoints(scaled_points, elems, ips, false) == npts - 1);
+}
+
+TEST_CASE("PointLocator", "[PointLocator]")
+{
+   SECTION("2D")
+   {
+      test_locator("../../data/inline-quad.mesh");
+      test_locator("../../data/star-q3.mesh");
+      test_locator("../../data/star-mixed.mesh");
+   }
+
+   SECTION("3D")
+   {
+      test_locator("../../data/inline-hex.mesh");
+      test_locator("../../data/fichera-q3.mesh");
+      test_locator("../../data/inline-tet.mesh");
+   }
+} // test case
+
+#ifdef MFEM_USE_MPI
+
+double lin_func(const Vector &x)
+{
+   double u = 1.0;
+   for (int d = 0; d < x.Size(); d++) { u += (d+1.0)*x(d); }
+   return u;
+}
+
+static void test_par_locator(const char *meshname)
+{
+   INFO("mesh=" << meshname);
+   int rank, nranks;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+   Mesh mesh(meshname, 1, 1);
+   mesh.ReorientTetMesh();
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+   const int dim = pmesh.Dimension();
+   const int NE = pmesh.GetNE();
+
+   H1_FECollection fec(2, dim);
+   ParFiniteElementSpace fes(&pmesh, &fec);
+   ParGridFunction u(&fes);
+   FunctionCoefficient u_coeff(lin_func);
+   u.ProjectCoefficient(u_coeff);
+
+   // Each rank generates points in its own elements, then all ranks search
+   // for all the points, so most of them are owned by other ranks.
+   const int npts_el = 2;
+   Array<double> my_coords(dim*npts_el*NE);
+   Vector x;
+   for (int e = 0; e < NE; e++)
+   {
+      const IntegrationRule &ir =
+         IntRules.Get(pmesh.GetElementBaseGeometry(e), 4);
+      ElementTransformation &T = *pmesh.GetElementTransformation(e);
+      for (int j = 0; j < npts_el; j++)
+      {
+         x.SetDataAndSize(my_coords.GetData() + dim*(npts_el*e + j), dim);
+         T.Transform(ir.IntPoint((5*j + e) % ir.GetNPoints()), x);
+      }
+   }
+   int my_size = my_coords.Size();
+   Array<int> sizes(nranks), offsets(nranks+1);
+   MPI_Allgather(&my_size, 1, MPI_INT, sizes.GetData(), 1, MPI_INT,
+                 MPI_COMM_WORLD);
+   offsets[0] = 0;
+   for (int r = 0; r < nranks; r++) { offsets[r+1] = offsets[r] + sizes[r]; }
+   const int npts = offsets[nranks]/dim;
+   DenseMatrix points(dim, npts);
+   MPI_Allgatherv(my_coords.GetData(), my_size, MPI_DOUBLE, points.Data(),
+                  sizes.GetData(), offsets.GetData(), MPI_DOUBLE,
+                  MPI_COMM_WORLD);
+
+   ParPointLocator locator(pmesh);
+   Array<int> elems;
+   Array<IntegrationPoint> ips;
+   REQUIRE(locator.FindPoints(points, elems, ips, false) == npts);
+
+   // Each point is owned by exactly one rank, and the points generated on this
+   // rank are found, possibly by a rank with a smaller index.
+   Array<int> my_owned(npts), num_owners(npts);
+   for (int k = 0; k < npts; k++)
+   {
+      REQUIRE(elems[k] != -1);
+      my_owned[k] = (elems[k] >= 0) ? 1 : 0;
+   }
+   MPI_Allreduce(my_owned.GetData(), num_owners.GetData(), npts, MPI_INT,
+                 MPI_SUM, MPI_COMM_WORLD);
+   for (int k = 0; k < npts; k++) { REQUIRE(num_owners[k] == 1); }
+
+   // The values at all points are available on all ranks
+   DenseMatrix u_vals;
+   locator.Interpolate(u, elems, ips, u_vals);
+   REQUIRE(u_vals.Width() == npts);
+   Vector p;
+   for (int k = 0; k < npts; k++)
+   {
+      points.GetColumnReference(k, p);
+      REQUIRE(std::abs(u_vals(0,k) - lin_func(p)) < 1e-10);
+   }
+}
+
+TEST_CASE("ParPointLocator", "[PointLocator][Parallel]")
+{
+   test_par_locator("../../data/star-mixed.mesh");
+   test_par_locator("../../data/inline-hex.mesh");
+   test_par_locator("../../data/inline-tet.mesh");
+}
+
+#endif // MFEM_USE_MPI
+
+} // namespace pointlocator
@@ -0,0 +1,131 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "unit_tests.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace tmop_pa
+{
+
+static void perturbation(const Vector &x, Vector &u)
+{
+   u = x;
+   u(0) += 0.05 * sin(M_PI * x(1)) * x(0);
+   u(1) += 0.04 * x(0) * x(1);
+   if (x.Size() == 3) { u(2) -= 0.03 * x(0) * x(2); }
+}
+
+static TMOP_QualityMetric *NewMetric(int id)
+{
+   switch (id)
+   {
+      case 1: return new TMOP_Metric_001;
+      case 2: return new TMOP_Metric_002;
+      case 7: return new TMOP_Metric_007;
+      case 77: return new TMOP_Metric_077;
+      case 302: return new TMOP_Metric_302;
+      case 303: return new TMOP_Metric_303;
+      case 321: return new TMOP_Metric_321;
+   }
+   return NULL;
+}
+
+// Returns the largest relative difference between the full and the partial
+// assembly of the energy, the action, the gradient action and the diagonal of
+// the gradient of a TMOP_Integrator.
+static double test_tmop_pa(int dim, int order, int metric_id, bool limiting)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(3, 3, Element::QUADRILATERAL, 0, 1.0, 1.0) :
+                new Mesh(2, 2, 2, Element::HEXAHEDRON, 0, 1.0, 1.0, 1.0);
+
+   mesh->SetCurvature(order, false, dim, Ordering::byNODES);
+   FiniteElementSpace &fes = *mesh->GetNodes()->FESpace();
+   H1_FECollection fec_s(order, dim);
+   FiniteElementSpace fes_s(mesh, &fec_s);
+
+   GridFunction x0(*mesh->GetNodes()), x(&fes), v(&fes), dist(&fes_s);
+   VectorFunctionCoefficient pert(dim, perturbation);
+   x.ProjectCoefficient(pert);
+   v.Randomize(3);
+   dist = 0.5;
+
+   TMOP_QualityMetric *metric = NewMetric(metric_id);
+   TargetConstructor tc(TargetConstructor::IDEAL_SHAPE_EQUAL_SIZE);
+   tc.SetNodes(x0);
+   ConstantCoefficient coeff1(0.7), lim_coeff(2.0);
+
+   NonlinearForm nlf_fa(&fes), nlf_pa(&fes);
+   nlf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   NonlinearForm *nlf[2] = { &nlf_fa, &nlf_pa };
+   for (int i = 0; i < 2; i++)
+   {
+      TMOP_Integrator *ti = new TMOP_Integrator(metric, &tc);
+      ti->SetCoefficient(coeff1);
+      if (limiting) { ti->EnableLimiting(x0, dist, lim_coeff); }
+      nlf[i]->AddDomainIntegrator(ti);
+   }
+   nlf_pa.Setup();
+
+   Vector y_fa(fes.GetVSize()), y_pa(fes.GetVSize());
+   Vector z_fa(fes.GetVSize()), z_pa(fes.GetVSize());
+   Vector d_fa(fes.GetVSize()), d_pa(fes.GetVSize());
+
+   const double e_fa = nlf_fa.GetGridFunctionEnergy(x);
+   const double e_pa = nlf_pa.GetGridFunctionEnergy(x);
+
+   nlf_fa.Mult(x, y_fa);
+   nlf_pa.Mult(x, y_pa);
+
+   SparseMatrix &grad_fa = dynamic_cast<SparseMatrix&>(nlf_fa.GetGradient(x));
+   grad_fa.Mult(v, z_fa);
+   grad_fa.GetDiag(d_fa);
+   Operator &grad_pa = nlf_pa.GetGradient(x);
+   grad_pa.Mult(v, z_pa);
+   grad_pa.AssembleDiagonal(d_pa);
+
+   double diff = fabs(e_fa - e_pa) / fabs(e_fa);
+   y_pa -= y_fa;
+   diff = std::max(diff, y_pa.Normlinf() / y_fa.Normlinf());
+   z_pa -= z_fa;
+   diff = std::max(diff, z_pa.Normlinf() / z_fa.Normlinf());
+   d_pa -= d_fa;
+   diff = std::max(diff, d_pa.Normlinf() / d_fa.Normlinf());
+
+   delete metric;
+   delete mesh;
+   return diff;
+}
+
+TEST_CASE("TMOP PA", "[TMOP], [PartialAssembly], [NonlinearPA]")
+{
+   const int metrics_2d[] = { 1, 2, 7, 77 };
+   const int metrics_3d[] = { 1, 302, 303, 321 };
+
+   for (int order = 1; order <= 2; order++)
+   {
+      for (int lim = 0; lim <= 1; lim++)
+      {
+         for (int m : metrics_2d)
+         {
+            REQUIRE(test_tmop_pa(2, order, m, lim) == MFEM_Approx(0.0));
+         }
+         for (int m : metrics_3d)
+         {
+            REQUIRE(test_tmop_pa(3, order, m, lim) == MFEM_Approx(0.0));
+         }
+      }
+   }
+}
+
+} // namespace tmop_pa
@@ -63,3 +63,71 @@ TEST_CASE("OperatorChebyshevSmoother", "[Chebyshev symmetry]")
       delete smoother;
    }
 }
+
+TEST_CASE("SpectralBoundsEstimator", "[Chebyshev]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   H1_FECollection fec(3, 2);
+   FiniteElementSpace fespace(&mesh, &fec);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   Array<int> ess_tdof_list;
+   fespace.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   BilinearForm aform(&fespace);
+   aform.AddDomainIntegrator(new DiffusionIntegrator);
+   aform.Assemble();
+   SparseMatrix A;
+   aform.FormSystemMatrix(ess_tdof_list, A);
+   Vector diag;
+   A.GetDiag(diag);
+
+   // Reference largest eigenvalue of D^{-1} A from a converged power method
+   OperatorJacobiSmoother jacobi(diag, ess_tdof_list);
+   ProductOperator jacobi_A(&jacobi, &A, false, false);
+   PowerMethod power;
+   Vector v(A.Height());
+   const double lambda_max = power.EstimateLargestEigenvalue(jacobi_A, v,
+                                                             5000, 1e-15);
+
+   SpectralBoundsEstimator estimator;
+   double est_min, est_max;
+   estimator.Estimate(A, jacobi, est_min, est_max);
+   // The Lanczos estimates are inside the spectrum
+   REQUIRE(est_max <= lambda_max*(1.0 + 1e-10));
+   REQUIRE(est_max >= 0.95*lambda_max);
+   REQUIRE(est_min > 0.0);
+   REQUIRE(est_min < est_max);
+   // Only the estimates with a given diagonal are cached
+   REQUIRE(!estimator.IsCached(A, diag));
+
+   double diag_min, diag_max;
+   estimator.Estimate(A, diag, ess_tdof_list, diag_min, diag_max);
+   REQUIRE(diag_min == est_min);
+   REQUIRE(diag_max == est_max);
+   REQUIRE(estimator.IsCached(A, diag));
+
+   // The smoother uses the cached estimate
+   OperatorChebyshevSmoother smoother(&A, diag, ess_tdof_list, 2, estimator);
+   REQUIRE(smoother.GetMaxEigEstimate() == est_max);
+
+   // The cache is keyed by the operator and the diagonal
+   Vector diag2(diag);
+   diag2 *= 2.0;
+   OperatorChebyshevSmoother smoother2(&A, diag2, ess_tdof_list, 2,
+                                       estimator);
+   REQUIRE(estimator.IsCached(A, diag2));
+   OperatorJacobiSmoother jacobi2(diag2, ess_tdof_list);
+   double est2_min, est2_max;
+   estimator.Estimate(A, jacobi2, est2_min, est2_max);
+   REQUIRE(est2_min < 0.75*est_min);
+   estimator.Estimate(A, diag2, ess_tdof_list, diag_min, diag_max);
+   REQUIRE(diag_min == est2_min);
+   REQUIRE(smoother2.GetMaxEigEstimate() == est2_max);
+   estimator.Invalidate(A, diag);
+   REQUIRE(!estimator.IsCached(A, diag));
+   REQUIRE(estimator.IsCached(A, diag2));
+
+   estimator.Invalidate(A);
+   REQUIRE(!estimator.IsCached(A, diag2));
+}
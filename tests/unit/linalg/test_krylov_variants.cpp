@@ -0,0 +1,310 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "unit_tests.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace krylov_variants
+{
+
+// Assemble the matrix of -div(grad u) + c.grad u + u, with the constant
+// convection velocity c = (conv, conv).
+static SparseMatrix *AssembleMatrix(FiniteElementSpace &fes, double conv)
+{
+   Vector c(fes.GetMesh()->Dimension());
+   c = conv;
+   VectorConstantCoefficient velocity(c);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.AddDomainIntegrator(new MassIntegrator);
+   if (conv != 0.0)
+   {
+      a.AddDomainIntegrator(new ConvectionIntegrator(velocity));
+   }
+   a.Assemble();
+   a.Finalize();
+   return a.LoseMat();
+}
+
+// Relative residual of the solution x of A x = b.
+static double RelativeResidual(const SparseMatrix &A, const Vector &b,
+                               const Vector &x)
+{
+   Vector r(b.Size());
+   A.Mult(x, r);
+   r -= b;
+   return r.Norml2() / b.Norml2();
+}
+
+TEST_CASE("Pipelined and single reduction CG", "[KrylovVariants]")
+{
+   const bool use_prec = GENERATE(false, true);
+   const bool iter_mode = GENERATE(false, true);
+   CAPTURE(use_prec, iter_mode);
+
+   Mesh mesh(8, 8, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   SparseMatrix *A = AssembleMatrix(fes, 0.0);
+   const int n = A->Height();
+   GSSmoother gs(*A);
+
+   Vector b(n), x0(n), x_ref(n);
+   b.Randomize(1);
+   x0.Randomize(2);
+
+   CGSolver cg;
+   PipelinedCGSolver pcg;
+   SingleReductionCGSolver srcg;
+   IterativeSolver *solvers[3] = { &cg, &pcg, &srcg };
+   int iter[3];
+   for (int k = 0; k < 3; k++)
+   {
+      IterativeSolver &solver = *solvers[k];
+      solver.SetRelTol(1e-10);
+      solver.SetMaxIter(1000);
+      if (use_prec) { solver.SetPreconditioner(gs); }
+      solver.SetOperator(*A);
+      solver.iterative_mode = iter_mode;
+      Vector x(x0);
+      solver.Mult(b, x);
+      REQUIRE(solver.GetConverged());
+      REQUIRE(RelativeResidual(*A, b, x) < 1e-8);
+      iter[k] = solver.GetNumIterations();
+      if (k == 0)
+      {
+         x_ref = x;
+      }
+      else
+      {
+         // In exact arithmetic, the variants give the same iterates as CG.
+         x -= x_ref;
+         REQUIRE(x.Normlinf() < 1e-6 * x_ref.Normlinf());
+         REQUIRE(std::abs(iter[k] - iter[0]) <= 2);
+      }
+   }
+
+   // With too few iterations, the variants do not converge
+   pcg.SetMaxIter(iter[1]/2);
+   srcg.SetMaxIter(iter[2]/2);
+   Vector x(x0);
+   pcg.Mult(b, x);
+   REQUIRE(!pcg.GetConverged());
+   REQUIRE(pcg.GetNumIterations() == iter[1]/2);
+   srcg.Mult(b, x);
+   REQUIRE(!srcg.GetConverged());
+   REQUIRE(srcg.GetNumIterations() == iter[2]/2);
+
+   delete A;
+}
+
+TEST_CASE("s-step GMRES", "[KrylovVariants]")
+{
+   const int s = GENERATE(1, 2, 4);
+   const bool use_prec = GENERATE(false, true);
+   const int kdim = GENERATE(10, 50);
+   CAPTURE(s, use_prec, kdim);
+
+   Mesh mesh(8, 8, Element::QUADRILATERAL, true);
+   H1_FECollection fec(1, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   SparseMatrix *A = AssembleMatrix(fes, 5.0);
+   const int n = A->Height();
+   DSmoother jacobi(*A);
+
+   Vector b(n);
+   b.Randomize(1);
+
+   GMRESSolver gmres;
+   SStepGMRESSolver sgmres;
+   sgmres.SetStepSize(s);
+   GMRESSolver *solvers[2] = { &gmres, &sgmres };
+   int iter[2];
+   for (int k = 0; k < 2; k++)
+   {
+      GMRESSolver &solver = *solvers[k];
+      solver.SetRelTol(1e-10);
+      solver.SetMaxIter(1000);
+      solver.SetKDim(kdim);
+      if (use_prec) { solver.SetPreconditioner(jacobi); }
+      solver.SetOperator(*A);
+      Vector x(n);
+      x = 0.0;
+      solver.Mult(b, x);
+      REQUIRE(solver.GetConverged());
+      REQUIRE(RelativeResidual(*A, b, x) < 1e-8);
+      iter[k] = solver.GetNumIterations();
+   }
+   // Up to rounding errors, the residuals are those of GMRES, so the number of
+   // iterations may only differ around the restarts.
+   const int restarts = iter[0] / kdim;
+   REQUIRE(std::abs(iter[1] - iter[0]) <= 2 + 2*restarts);
+
+   delete A;
+}
+
+TEST_CASE("s-step GMRES breakdown", "[KrylovVariants]")
+{
+   // The Krylov space of a diagonal matrix with three distinct values has
+   // dimension three, so GMRES converges in three iterations.
+   const int n = 12;
+   Vector d(n);
+   for (int i = 0; i < n; i++) { d(i) = 1.0 + i%3; }
+   SparseMatrix D(d);
+   Vector b(n), x(n);
+   b.Randomize(1);
+
+   const int s = GENERATE(2, 3, 4, 5);
+   CAPTURE(s);
+   SStepGMRESSolver sgmres;
+   sgmres.SetStepSize(s);
+   sgmres.SetRelTol(1e-12);
+   sgmres.SetMaxIter(20);
+   sgmres.SetOperator(D);
+   x = 0.0;
+   sgmres.Mult(b, x);
+   REQUIRE(sgmres.GetConverged());
+   REQUIRE(sgmres.GetNumIterations() == 3);
+   REQUIRE(RelativeResidual(D, b, x) < 1e-10);
+}
+
+#ifdef MFEM_USE_MPI
+
+// Assemble the parallel version of the matrix of AssembleMatrix().
+static HypreParMatrix *ParAssembleMatrix(ParFiniteElementSpace &fes,
+                                         double conv)
+{
+   Vector c(fes.GetMesh()->Dimension());
+   c = conv;
+   VectorConstantCoefficient velocity(c);
+   ParBilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.AddDomainIntegrator(new MassIntegrator);
+   if (conv != 0.0)
+   {
+      a.AddDomainIntegrator(new ConvectionIntegrator(velocity));
+   }
+   a.Assemble();
+   a.Finalize();
+   return a.ParallelAssemble();
+}
+
+static double ParRelativeResidual(const HypreParMatrix &A, const Vector &b,
+                                  const Vector &x)
+{
+   Vector r(b.Size());
+   A.Mult(x, r);
+   r -= b;
+   return ParNormlp(r, 2.0, MPI_COMM_WORLD) / ParNormlp(b, 2.0, MPI_COMM_WORLD);
+}
+
+TEST_CASE("Parallel pipelined and single reduction CG",
+          "[KrylovVariants][Parallel]")
+{
+   const bool use_prec = GENERATE(false, true);
+   CAPTURE(use_prec);
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   Mesh mesh(8, 8, Element::QUADRILATERAL, true);
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+   H1_FECollection fec(2, 2);
+   ParFiniteElementSpace fes(&pmesh, &fec);
+   HypreParMatrix *A = ParAssembleMatrix(fes, 0.0);
+   HypreSmoother jacobi(*A, HypreSmoother::Jacobi);
+
+   Vector b(A->Height()), x_ref(A->Height());
+   b.Randomize(1 + rank);
+
+   CGSolver cg(MPI_COMM_WORLD);
+   PipelinedCGSolver pcg(MPI_COMM_WORLD);
+   SingleReductionCGSolver srcg(MPI_COMM_WORLD);
+   IterativeSolver *solvers[3] = { &cg, &pcg, &srcg };
+   int iter[3];
+   for (int k = 0; k < 3; k++)
+   {
+      IterativeSolver &solver = *solvers[k];
+      solver.SetRelTol(1e-10);
+      solver.SetMaxIter(1000);
+      if (use_prec) { solver.SetPreconditioner(jacobi); }
+      solver.SetOperator(*A);
+      Vector x(A->Height());
+      x = 0.0;
+      solver.Mult(b, x);
+      REQUIRE(solver.GetConverged());
+      REQUIRE(ParRelativeResidual(*A, b, x) < 1e-8);
+      iter[k] = solver.GetNumIterations();
+      if (k == 0)
+      {
+         x_ref = x;
+      }
+      else
+      {
+         x -= x_ref;
+         REQUIRE(ParNormlp(x, infinity(), MPI_COMM_WORLD) <
+                 1e-6 * ParNormlp(x_ref, infinity(), MPI_COMM_WORLD));
+         REQUIRE(std::abs(iter[k] - iter[0]) <= 2);
+      }
+   }
+
+   delete A;
+}
+
+TEST_CASE("Parallel s-step GMRES", "[KrylovVariants][Parallel]")
+{
+   const int s = GENERATE(2, 4);
+   const bool use_prec = GENERATE(false, true);
+   CAPTURE(s, use_prec);
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   Mesh mesh(8, 8, Element::QUADRILATERAL, true);
+   ParMesh pmesh(MPI_COMM_WORLD, mesh);
+   H1_FECollection fec(1, 2);
+   ParFiniteElementSpace fes(&pmesh, &fec);
+   HypreParMatrix *A = ParAssembleMatrix(fes, 5.0);
+   HypreSmoother jacobi(*A, HypreSmoother::Jacobi);
+
+   Vector b(A->Height());
+   b.Randomize(1 + rank);
+
+   const int kdim = 50;
+   GMRESSolver gmres(MPI_COMM_WORLD);
+   SStepGMRESSolver sgmres(MPI_COMM_WORLD);
+   sgmres.SetStepSize(s);
+   GMRESSolver *solvers[2] = { &gmres, &sgmres };
+   int iter[2];
+   for (int k = 0; k < 2; k++)
+   {
+      GMRESSolver &solver = *solvers[k];
+      solver.SetRelTol(1e-10);
+      solver.SetMaxIter(1000);
+      solver.SetKDim(kdim);
+      if (use_prec) { solver.SetPreconditioner(jacobi); }
+      solver.SetOperator(*A);
+      Vector x(A->Height());
+      x = 0.0;
+      solver.Mult(b, x);
+      REQUIRE(solver.GetConverged());
+      REQUIRE(ParRelativeResidual(*A, b, x) < 1e-8);
+      iter[k] = solver.GetNumIterations();
+   }
+   const int restarts = iter[0] / kdim;
+   REQUIRE(std::abs(iter[1] - iter[0]) <= 2 + 2*restarts);
+
+   delete A;
+}
+
+#endif // MFEM_USE_MPI
+
+} // namespace krylov_variants
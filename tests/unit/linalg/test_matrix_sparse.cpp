@@ -83,4 +83,96 @@ TEST_CASE("SparseMatrixAbsMult", "[SparseMatrixAbsMult]")
    }
 }
 
+static double SpMVError(const SparseMatrix &A, const SparseMatrix &B,
+                        bool transpose)
+{
+   const int n = transpose ? A.Height() : A.Width();
+   const int m = transpose ? A.Width() : A.Height();
+   Vector x(n), y0(m), y1(m);
+   x.Randomize(1);
+   if (transpose)
+   {
+      A.MultTranspose(x, y0);
+      B.MultTranspose(x, y1);
+   }
+   else
+   {
+      A.Mult(x, y0);
+      B.Mult(x, y1);
+   }
+   y1 -= y0;
+   return y1.Normlinf()/y0.Normlinf();
+}
+
+TEST_CASE("SparseMatrixSpMVFormat", "[SparseMatrix]")
+{
+   const int vdim = GENERATE(1, 2, 3);
+   CAPTURE(vdim);
+
+   Mesh *mesh = (vdim == 2) ? new Mesh(6, 6, Element::QUADRILATERAL, true) :
+                new Mesh(3, 3, 3, Element::HEXAHEDRON, true);
+   H1_FECollection fec(2, mesh->Dimension());
+   FiniteElementSpace fes(mesh, &fec, vdim, Ordering::byVDIM);
+   ConstantCoefficient lambda(1.0), mu(1.0);
+   BilinearForm a(&fes);
+   if (vdim == 1)
+   {
+      a.AddDomainIntegrator(new DiffusionIntegrator);
+   }
+   else
+   {
+      // Couples all components, for dense blocks
+      a.AddDomainIntegrator(new ElasticityIntegrator(lambda, mu));
+   }
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+
+   // The block structure of vector spaces ordered by VDIM is detected
+   int block_size;
+   SparseMatrix::SpMVFormat format = A.SelectSpMVFormat(block_size);
+   if (vdim > 1)
+   {
+      REQUIRE(format == SparseMatrix::BSR_FORMAT);
+      REQUIRE(block_size == vdim);
+   }
+   else
+   {
+      REQUIRE(format == SparseMatrix::SELL_FORMAT);
+   }
+
+   SparseMatrix B(A);
+   B.BuildSpMVFormat(SparseMatrix::SELL_FORMAT);
+   REQUIRE(B.GetSpMVFormat() == SparseMatrix::SELL_FORMAT);
+   REQUIRE(SpMVError(A, B, false) < 1e-14);
+   REQUIRE(SpMVError(A, B, true) < 1e-14);
+
+   B.BuildSpMVFormat(SparseMatrix::BSR_FORMAT, vdim);
+   REQUIRE(B.GetSpMVFormat() == SparseMatrix::BSR_FORMAT);
+   REQUIRE(SpMVError(A, B, false) < 1e-14);
+   REQUIRE(SpMVError(A, B, true) < 1e-14);
+
+   // The internal transpose uses the same format
+   B.BuildTranspose();
+   REQUIRE(SpMVError(A, B, true) < 1e-14);
+
+   B.ResetSpMVFormat();
+   REQUIRE(B.GetSpMVFormat() == SparseMatrix::CSR_FORMAT);
+   REQUIRE(SpMVError(A, B, false) == 0.0);
+
+   // Rectangular matrix with a partially filled last slice
+   SparseMatrix R(7, 5);
+   for (int i = 0; i < 7; i++)
+   {
+      for (int j = 0; j <= i % 5; j++) { R.Add(i, j, 1.0 + i + 0.1*j); }
+   }
+   R.Finalize();
+   SparseMatrix R_sell(R);
+   R_sell.BuildSpMVFormat(SparseMatrix::SELL_FORMAT);
+   REQUIRE(SpMVError(R, R_sell, false) < 1e-14);
+   REQUIRE(SpMVError(R, R_sell, true) < 1e-14);
+
+   delete mesh;
+}
+
 } // namespace mfem
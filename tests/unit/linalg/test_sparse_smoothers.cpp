@@ -0,0 +1,222 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "unit_tests.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace sparse_smoothers
+{
+
+// The tridiagonal matrix of the 1D Laplacian with n rows.
+static SparseMatrix *Laplacian1D(int n)
+{
+   SparseMatrix *A = new SparseMatrix(n);
+   for (int i = 0; i < n; i++)
+   {
+      A->Add(i, i, 2.0);
+      if (i > 0) { A->Add(i, i-1, -1.0); }
+      if (i < n-1) { A->Add(i, i+1, -1.0); }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Returns the largest difference of (S x, z) and (x, S^T z) for a few random
+// vectors x and z.
+static double TransposeError(const Solver &S)
+{
+   Vector x(S.Width()), z(S.Height()), Sx(S.Height()), Stz(S.Width());
+   double err = 0.0;
+   for (int seed = 1; seed <= 3; seed++)
+   {
+      x.Randomize(seed);
+      z.Randomize(seed + 10);
+      S.Mult(x, Sx);
+      S.MultTranspose(z, Stz);
+      err = std::max(err, std::abs(InnerProduct(Sx, z) - InnerProduct(x, Stz)));
+   }
+   return err;
+}
+
+// Number of PCG iterations for the system A X = B, with preconditioner S.
+static int PCGIterations(const SparseMatrix &A, Solver &S)
+{
+   Vector B(A.Height()), X(A.Height());
+   B.Randomize(1);
+   X = 0.0;
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(500);
+   cg.SetOperator(A);
+   cg.SetPreconditioner(S);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("Multicolor Gauss-Seidel", "[SparseSmoothers]")
+{
+   SECTION("Coloring")
+   {
+      // Red-black coloring of a tridiagonal matrix
+      SparseMatrix *A = Laplacian1D(10);
+      MulticolorGSSmoother S(*A);
+      REQUIRE(S.GetNumColors() == 2);
+      delete A;
+
+      // A diagonal matrix has a single color
+      Vector d(7);
+      d = 3.0;
+      SparseMatrix D(d);
+      S.SetOperator(D);
+      REQUIRE(S.GetNumColors() == 1);
+   }
+
+   SECTION("Dense matrix")
+   {
+      // With all rows coupled, each row has its own color and the sweeps are
+      // the sequential Gauss-Seidel sweeps.
+      const int n = 6;
+      SparseMatrix A(n);
+      for (int i = 0; i < n; i++)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            A.Add(i, j, (i == j) ? n + 1.0 : 1.0/(1.0 + i + 2*j));
+         }
+      }
+      A.Finalize();
+      const int type = GENERATE(0, 1, 2);
+      CAPTURE(type);
+      MulticolorGSSmoother mc(A, type, 2);
+      GSSmoother gs(A, type, 2);
+      REQUIRE(mc.GetNumColors() == n);
+      Vector x(n), y_mc(n), y_gs(n);
+      x.Randomize(1);
+      mc.Mult(x, y_mc);
+      gs.Mult(x, y_gs);
+      y_mc -= y_gs;
+      REQUIRE(y_mc.Normlinf() == MFEM_Approx(0.0));
+   }
+
+   SECTION("Finite element matrix")
+   {
+      Mesh mesh(6, 6, Element::QUADRILATERAL, true);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator);
+      a.AddDomainIntegrator(new MassIntegrator);
+      a.Assemble();
+      a.Finalize();
+      const SparseMatrix &A = a.SpMat();
+
+      // The symmetric smoother is a symmetric preconditioner, and the forward
+      // and backward smoothers are transposes of each other.
+      MulticolorGSSmoother sym(A), forw(A, 1), ssor(A, 0, 1, 1.5);
+      REQUIRE(sym.GetNumColors() <= 25);
+      REQUIRE(TransposeError(sym) == MFEM_Approx(0.0));
+      REQUIRE(TransposeError(forw) == MFEM_Approx(0.0));
+      REQUIRE(TransposeError(ssor) == MFEM_Approx(0.0));
+
+      GSSmoother gs(A);
+      const int it_gs = PCGIterations(A, gs);
+      REQUIRE(PCGIterations(A, sym) <= 2*it_gs);
+      REQUIRE(PCGIterations(A, ssor) <= 2*it_gs);
+   }
+}
+
+TEST_CASE("Block Gauss-Seidel", "[SparseSmoothers]")
+{
+   const int n = 20;
+   SparseMatrix *A = Laplacian1D(n);
+   Vector x(n), y(n), y_ref(n);
+   x.Randomize(1);
+   const int type = GENERATE(0, 1, 2);
+   CAPTURE(type);
+
+   // A single block gives the sequential Gauss-Seidel sweeps.
+   BlockGSSmoother one_block(*A, type, 2, 1.0, n);
+   GSSmoother gs(*A, type, 2);
+   one_block.Mult(x, y);
+   gs.Mult(x, y_ref);
+   y -= y_ref;
+   REQUIRE(y.Normlinf() == MFEM_Approx(0.0));
+
+   // Blocks of one row give the weighted Jacobi iteration.
+   BlockGSSmoother jacobi(*A, 1, 1, 0.5, 1);
+   jacobi.Mult(x, y);
+   y_ref = x;
+   y_ref *= 0.25;
+   y -= y_ref;
+   REQUIRE(y.Normlinf() == MFEM_Approx(0.0));
+
+   BlockGSSmoother blocks(*A, type, 1, 1.0, 3);
+   REQUIRE(TransposeError(blocks) == MFEM_Approx(0.0));
+   if (type == 0)
+   {
+      REQUIRE(PCGIterations(*A, blocks) < n);
+   }
+   delete A;
+}
+
+TEST_CASE("Sparse smoothers in Multigrid", "[SparseSmoothers][Multigrid]")
+{
+   const int smoother_type = GENERATE(0, 1);
+   CAPTURE(smoother_type);
+
+   Mesh *mesh = new Mesh(4, 4, Element::QUADRILATERAL, true);
+   H1_FECollection fec(1, 2);
+   FiniteElementSpace *coarse_fes = new FiniteElementSpace(mesh, &fec);
+   FiniteElementSpaceHierarchy hierarchy(mesh, coarse_fes, true, true);
+   hierarchy.AddUniformlyRefinedLevel();
+   hierarchy.AddUniformlyRefinedLevel();
+
+   Array<BilinearForm*> forms(hierarchy.GetNumLevels());
+   Multigrid mg(hierarchy);
+   for (int l = 0; l < hierarchy.GetNumLevels(); l++)
+   {
+      forms[l] = new BilinearForm(&hierarchy.GetFESpaceAtLevel(l));
+      forms[l]->AddDomainIntegrator(new DiffusionIntegrator);
+      forms[l]->AddDomainIntegrator(new MassIntegrator);
+      forms[l]->Assemble();
+      forms[l]->Finalize();
+      SparseMatrix &A = forms[l]->SpMat();
+      Solver *smoother;
+      if (l == 0)
+      {
+         CGSolver *cg = new CGSolver;
+         cg->SetRelTol(1e-12);
+         cg->SetMaxIter(500);
+         cg->SetOperator(A);
+         smoother = cg;
+      }
+      else if (smoother_type == 0)
+      {
+         // Forward sweeps for pre-smoothing, backward for post-smoothing
+         smoother = new MulticolorGSSmoother(A, 1);
+      }
+      else
+      {
+         smoother = new BlockGSSmoother(A, 1, 1, 1.0, 16);
+      }
+      mg.AddLevel(&A, smoother, false, true);
+   }
+
+   const SparseMatrix &A = forms.Last()->SpMat();
+   REQUIRE(PCGIterations(A, mg) <= 15);
+
+   for (int l = 0; l < forms.Size(); l++) { delete forms[l]; }
+}
+
+} // namespace sparse_smoothers
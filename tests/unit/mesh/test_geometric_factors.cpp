@@ -0,0 +1,233 @@
+// Copyright (c) 2010-2020, Lawrence Livermore National Security, LLC. Produced
+// at the Lawrence Livermore National Laboratory. All Rights reserved. See files
+// LICENSE and NOTICE for details. LLNL-CODE-806117.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability visit https://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the BSD-3 license. We welcome feedback and contributions, see file
+// CONTRIBUTING.md for details.
+
+#include "mfem.hpp"
+#include "unit_tests.hpp"
+#include "linalg/dtensor.hpp"
+
+using namespace mfem;
+
+namespace geometric_factors
+{
+
+static void test_compressed(const char *meshname, bool affine)
+{
+   INFO("mesh=" << meshname);
+   Mesh mesh(meshname, 1, 1), ref_mesh(meshname, 1, 1);
+   const int dim = mesh.Dimension();
+   const int NE = mesh.GetNE();
+   const IntegrationRule &ir =
+      IntRules.Get(mesh.GetElementBaseGeometry(0), 4);
+   const int NQ = ir.GetNPoints();
+   const int flags = GeometricFactors::JACOBIANS |
+                     GeometricFactors::DETERMINANTS;
+
+   const GeometricFactors *comp =
+      mesh.GetGeometricFactors(ir, flags, GeometricFactorsStorage::Compressed);
+   REQUIRE(comp->compressed == affine);
+   const int NQ_J = affine ? 1 : NQ;
+   REQUIRE(comp->J.Size() == NQ_J*dim*dim*NE);
+   REQUIRE(comp->detJ.Size() == NQ_J*NE);
+
+   // The full factors are expanded from the compressed ones, which already
+   // have the full layout if the mesh is not affine.
+   const GeometricFactors *full = mesh.GetGeometricFactors(ir, flags);
+   REQUIRE(!full->compressed);
+   REQUIRE((full == comp) == !affine);
+   REQUIRE(full->J.Size() == NQ*dim*dim*NE);
+   REQUIRE(full->detJ.Size() == NQ*NE);
+
+   const GeometricFactors *ref = ref_mesh.GetGeometricFactors(ir, flags);
+   const auto J_ref = Reshape(ref->J.HostRead(), NQ, dim*dim, NE);
+   const auto D_ref = Reshape(ref->detJ.HostRead(), NQ, NE);
+   const auto J = Reshape(full->J.HostRead(), NQ, dim*dim, NE);
+   const auto D = Reshape(full->detJ.HostRead(), NQ, NE);
+   const auto Jc = Reshape(comp->J.HostRead(), NQ_J, dim*dim, NE);
+   const auto Dc = Reshape(comp->detJ.HostRead(), NQ_J, NE);
+   for (int e = 0; e < NE; e++)
+   {
+      for (int q = 0; q < NQ; q++)
+      {
+         const int qc = affine ? 0 : q;
+         const double tol = 1e-12*std::abs(D_ref(q,e));
+         REQUIRE(std::abs(D(q,e) - D_ref(q,e)) < tol);
+         REQUIRE(std::abs(Dc(qc,e) - D_ref(q,e)) < tol);
+         for (int i = 0; i < dim*dim; i++)
+         {
+            REQUIRE(std::abs(J(q,i,e) - J_ref(q,i,e)) < 1e-10);
+            REQUIRE(std::abs(Jc(qc,i,e) - J_ref(q,i,e)) < 1e-10);
+         }
+      }
+   }
+
+   // The same object is returned, and extended with the missing factors
+   REQUIRE(mesh.GetGeometricFactors(ir, GeometricFactors::DETERMINANTS,
+                                    GeometricFactorsStorage::Compressed)
+           == comp);
+   const GeometricFactors *comp_x =
+      mesh.GetGeometricFactors(ir, GeometricFactors::COORDINATES,
+                               GeometricFactorsStorage::Compressed);
+   REQUIRE(comp_x == comp);
+   REQUIRE(comp->X.Size() == NQ*dim*NE);
+   REQUIRE(comp->computed_factors == (flags | GeometricFactors::COORDINATES));
+   REQUIRE(mesh.GetGeometricFactorsMemory() ==
+           (affine ? full->MemoryUsage() : 0) + comp->MemoryUsage());
+
+   // Compressed requests reuse existing full factors
+   REQUIRE(ref_mesh.GetGeometricFactors(ir, flags,
+                                        GeometricFactorsStorage::Compressed)
+           == ref);
+}
+
+static void test_pa_compressed(const char *meshname)
+{
+   INFO("mesh=" << meshname);
+   Mesh mesh(meshname, 1, 1);
+   const int dim = mesh.Dimension();
+   H1_FECollection fec(2, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   BilinearForm pa(&fes), fa(&fes);
+   pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   pa.AddDomainIntegrator(new MassIntegrator);
+   pa.AddDomainIntegrator(new DiffusionIntegrator);
+   fa.AddDomainIntegrator(new MassIntegrator);
+   fa.AddDomainIntegrator(new DiffusionIntegrator);
+   pa.Assemble();
+   fa.Assemble();
+   fa.Finalize();
+
+   GridFunction x(&fes), y_pa(&fes), y_fa(&fes);
+   x.Randomize(1);
+   pa.Mult(x, y_pa);
+   fa.Mult(x, y_fa);
+   y_pa -= y_fa;
+   REQUIRE(y_pa.Normlinf() < 1e-12*y_fa.Normlinf());
+}
+
+TEST_CASE("Compressed GeometricFactors", "[GeometricFactors]")
+{
+   test_compressed("../../data/inline-quad.mesh", true);
+   test_compressed("../../data/inline-tri.mesh", true);
+   test_compressed("../../data/star-q3.mesh", false);
+   test_compressed("../../data/inline-hex.mesh", true);
+   test_compressed("../../data/inline-tet.mesh", true);
+   test_compressed("../../data/fichera-q3.mesh", false);
+
+   test_pa_compressed("../../data/inline-quad.mesh");
+   test_pa_compressed("../../data/inline-tri.mesh");
+   test_pa_compressed("../../data/inline-hex.mesh");
+   test_pa_compressed("../../data/inline-tet.mesh");
+}
+
+TEST_CASE("GeometricFactors Memory", "[GeometricFactors]")
+{
+   Mesh mesh("../../data/inline-quad.mesh", 1, 1);
+   const Geometry::Type geom = mesh.GetElementBaseGeometry(0);
+   const int flags = GeometricFactors::COORDINATES;
+   const GeometricFactors *gf2 =
+      mesh.GetGeometricFactors(IntRules.Get(geom, 2), flags);
+   const GeometricFactors *gf4 =
+      mesh.GetGeometricFactors(IntRules.Get(geom, 4), flags);
+   REQUIRE(mesh.GetGeometricFactorsMemory() ==
+           gf2->MemoryUsage() + gf4->MemoryUsage());
+
+   // The cached factors are kept, so the same objects are returned
+   REQUIRE(mesh.GetGeometricFactors(IntRules.Get(geom, 2), flags) == gf2);
+   REQUIRE(mesh.GetGeometricFactors(IntRules.Get(geom, 4), flags) == gf4);
+
+   mesh.DeleteGeometricFactors();
+   REQUIRE(mesh.GetGeometricFactorsMemory() == 0);
+}
+
+TEST_CASE("GeometricFactors Memory Limit", "[GeometricFactors]")
+{
+   Mesh mesh("../../data/inline-quad.mesh", 1, 1);
+   const Geometry::Type geom = mesh.GetElementBaseGeometry(0);
+   const int flags = GeometricFactors::COORDINATES;
+   const GeometricFactors *gf2 =
+      mesh.GetGeometricFactors(IntRules.Get(geom, 2), flags);
+   const GeometricFactors *gf4 =
+      mesh.GetGeometricFactors(IntRules.Get(geom, 4), flags);
+   const long bytes2 = gf2->MemoryUsage();
+   const long bytes4 = gf4->MemoryUsage();
+
+   // Using the first factors makes the second ones the least recently used
+   REQUIRE(mesh.GetGeometricFactors(IntRules.Get(geom, 2), flags) == gf2);
+   mesh.SetGeometricFactorsMemoryLimit(bytes2 + bytes4 - 1);
+   REQUIRE(mesh.GetGeometricFactorsMemory() == bytes2);
+
+   // Factors with users are kept even if they exceed the limit
+   gf2->AddUser();
+   mesh.SetGeometricFactorsMemoryLimit(0);
+   REQUIRE(mesh.GetGeometricFactorsMemory() == bytes2);
+
+   // So are the returned factors, until the next request
+   const GeometricFactors *gf6 =
+      mesh.GetGeometricFactors(IntRules.Get(geom, 6), flags);
+   REQUIRE(mesh.GetGeometricFactorsMemory() == bytes2 + gf6->MemoryUsage());
+   mesh.GetGeometricFactors(IntRules.Get(geom, 4), flags);
+   REQUIRE(mesh.GetGeometricFactorsMemory() == bytes2 + bytes4);
+
+   // The factors dropped by the Mesh stay valid for their users
+   mesh.DeleteGeometricFactors();
+   REQUIRE(mesh.GetGeometricFactorsMemory() == 0);
+   REQUIRE(gf2->GetNumUsers() == 1);
+   REQUIRE(gf2->X.Size() > 0);
+   GeometricFactors::Release(gf2);
+
+   mesh.SetGeometricFactorsMemoryLimit(-1);
+   mesh.GetGeometricFactors(IntRules.Get(geom, 2), flags);
+   mesh.GetGeometricFactors(IntRules.Get(geom, 4), flags);
+   REQUIRE(mesh.GetGeometricFactorsMemory() == bytes2 + bytes4);
+}
+
+TEST_CASE("GeometricFactors Memory Limit PA", "[GeometricFactors]")
+{
+   // The affine PA mass action reads the shared factors, which are kept while
+   // the integrator uses them
+   for (auto meshname : {"../../data/inline-quad.mesh",
+                         "../../data/inline-tet.mesh"
+                        })
+   {
+      INFO("mesh=" << meshname);
+      Mesh mesh(meshname, 1, 1);
+      mesh.SetGeometricFactorsMemoryLimit(0);
+      const int dim = mesh.Dimension();
+      H1_FECollection fec(2, dim);
+      FiniteElementSpace fes(&mesh, &fec);
+      ConstantCoefficient two(2.0);
+
+      BilinearForm pa(&fes), fa(&fes);
+      pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      pa.AddDomainIntegrator(new MassIntegrator(two));
+      fa.AddDomainIntegrator(new MassIntegrator(two));
+      pa.Assemble();
+      fa.Assemble();
+      fa.Finalize();
+      REQUIRE(mesh.GetGeometricFactorsMemory() > 0);
+
+      // Other requests and DeleteGeometricFactors() leave the data in use
+      const Geometry::Type geom = mesh.GetElementBaseGeometry(0);
+      mesh.GetGeometricFactors(IntRules.Get(geom, 1),
+                               GeometricFactors::COORDINATES);
+      mesh.DeleteGeometricFactors();
+
+      GridFunction x(&fes), y_pa(&fes), y_fa(&fes);
+      x.Randomize(1);
+      pa.Mult(x, y_pa);
+      fa.Mult(x, y_fa);
+      y_pa -= y_fa;
+      REQUIRE(y_pa.Normlinf() < 1e-12*y_fa.Normlinf());
+   }
+}
+
+} // namespace geometric_factors